@@ -35,7 +35,8 @@ public:
     RT_CDSORT,
     RT_PETTIS_HANSEN,
     RT_RANDOM,
-    RT_USER
+    RT_USER,
+    RT_HUGEPAGE
   };
 
   explicit ReorderFunctions(const cl::opt<bool> &PrintPass)
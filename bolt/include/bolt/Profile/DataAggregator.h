@@ -132,6 +132,17 @@ private:
   /// and use them later for processing and assigning profile.
   std::unordered_map<Trace, TakenBranchInfo, TraceHash> BranchLBRs;
   std::unordered_map<Trace, FTInfo, TraceHash> FallthroughLBRs;
+
+  /// Branches, fall-throughs and trace statistics aggregated from a subset of
+  /// the LBR samples. The samples are split among several of these, which are
+  /// filled in parallel and then merged into BranchLBRs and FallthroughLBRs.
+  struct LBRAggregate {
+    std::unordered_map<Trace, TakenBranchInfo, TraceHash> BranchLBRs;
+    std::unordered_map<Trace, FTInfo, TraceHash> FallthroughLBRs;
+    uint64_t NumTraces{0};
+    uint64_t NumInvalidTraces{0};
+    uint64_t NumLongRangeTraces{0};
+  };
   std::vector<AggregatedLBREntry> AggregatedLBRs;
   std::unordered_map<uint64_t, uint64_t> BasicSamples;
   std::vector<PerfMemSample> MemSamples;
@@ -325,8 +336,10 @@ private:
   /// Parse a single LBR entry as output by perf script -Fbrstack
   ErrorOr<LBREntry> parseLBREntry();
 
-  /// Parse LBR sample, returns the number of traces.
-  uint64_t parseLBRSample(const PerfBranchSample &Sample, bool NeedsSkylakeFix);
+  /// Aggregate the branches and fall-throughs of an LBR sample into \p Aggr.
+  /// This may be called from several threads for different aggregates.
+  void parseLBRSample(const PerfBranchSample &Sample, bool NeedsSkylakeFix,
+                      LBRAggregate &Aggr) const;
 
   /// Parse and pre-aggregate branch events.
   std::error_code parseBranchEvents();
@@ -10,7 +10,9 @@
 #define BOLT_PROFILE_YAML_PROFILE_READER_H
 
 #include "bolt/Profile/ProfileReaderBase.h"
+#include "bolt/Core/MCPlusBuilder.h"
 #include "bolt/Profile/ProfileYAMLMapping.h"
+#include <mutex>
 #include <unordered_set>
 
 namespace llvm {
@@ -196,6 +198,14 @@ private:
   // (YAML profile and its inline tree mapping to binary).
   DenseMap<BinaryFunction *, std::vector<ProbeMatchSpec>> BFToProbeMatchSpecs;
 
+  /// The functions whose profile didn't match, and whose profile is inferred
+  /// by inferStaleProfiles().
+  DenseMap<BinaryFunction *, const yaml::bolt::BinaryFunctionProfile *>
+      StaleFunctions;
+
+  /// Protects the stale matching stats of BinaryContext during the inference.
+  std::mutex StaleStatsMutex;
+
   /// Populate \p Function profile with the one supplied in YAML format.
   bool parseFunctionProfile(BinaryFunction &Function,
                             const yaml::bolt::BinaryFunctionProfile &YamlBF);
@@ -205,9 +215,15 @@ private:
                       const BinaryFunction &BF);
 
   /// Infer function profile from stale data (collected on older binaries).
+  /// The annotations are created with the allocator \p AllocId, so that the
+  /// profiles of several functions can be inferred at the same time.
   bool inferStaleProfile(BinaryFunction &Function,
                          const yaml::bolt::BinaryFunctionProfile &YamlBF,
-                         const ArrayRef<ProbeMatchSpec> ProbeMatchSpecs);
+                         const ArrayRef<ProbeMatchSpec> ProbeMatchSpecs,
+                         MCPlusBuilder::AllocatorIdTy AllocId = 0);
+
+  /// Infer the profiles of all the StaleFunctions in parallel.
+  void inferStaleProfiles(BinaryContext &BC);
 
   /// Initialize maps for profile matching.
   void buildNameMaps(BinaryContext &BC);
@@ -16,10 +16,15 @@
 #include "bolt/Passes/ReorderAlgorithm.h"
 #include "bolt/Passes/ReorderFunctions.h"
 #include "bolt/Utils/CommandLineOpts.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Support/CommandLine.h"
 #include <atomic>
+#include <cmath>
+#include <fstream>
 #include <mutex>
 #include <numeric>
+#include <sstream>
 #include <vector>
 
 #define DEBUG_TYPE "bolt-opts"
@@ -82,6 +87,21 @@ bool isHotTextMover(const BinaryFunction &Function) {
   return false;
 }
 
+static cl::opt<std::string> BlockLayoutCache(
+    "block-layout-cache",
+    cl::desc("file with the basic block layouts of a previous run, which are "
+             "reused for the functions whose code didn't change and whose "
+             "profile didn't change significantly, and which is then updated "
+             "with the layouts of this run"),
+    cl::value_desc("filename"), cl::cat(BoltOptCategory));
+
+static cl::opt<unsigned> BlockLayoutCacheThreshold(
+    "block-layout-cache-threshold",
+    cl::desc("maximum change, in percent, of the distribution of the block "
+             "execution counts of a function for its cached layout to be "
+             "reused"),
+    cl::init(5), cl::Hidden, cl::cat(BoltOptCategory));
+
 static cl::opt<bool> MinBranchClusters(
     "min-branch-clusters",
     cl::desc("use a modified clustering algorithm geared towards minimizing "
@@ -396,6 +416,130 @@ bool ReorderBasicBlocks::shouldOptimize(const BinaryFunction &BF) const {
   return BinaryFunctionPass::shouldOptimize(BF);
 }
 
+namespace {
+/// The layout of a function computed by a previous run, keyed by the name of
+/// the function in the -block-layout-cache file. The execution counts of the
+/// blocks when the layout was computed are kept to tell whether the profile
+/// changed since.
+struct CachedBlockLayout {
+  /// The hash of the code of the function.
+  uint64_t Hash;
+  /// The execution counts and the positions in the layout of the blocks, in
+  /// the order of their indices.
+  std::vector<uint64_t> Counts;
+  std::vector<unsigned> Order;
+};
+using BlockLayoutCacheTy = StringMap<CachedBlockLayout>;
+
+/// Each line of the cache file holds the name and the hash of a function, its
+/// number of blocks N, N block execution counts and then N block indices.
+void readBlockLayoutCache(BinaryContext &BC, StringRef FileName,
+                          BlockLayoutCacheTy &Cache) {
+  std::ifstream File(FileName.str(), std::ios::in);
+  // There is no cache on the first run.
+  if (!File)
+    return;
+
+  std::string Line;
+  while (std::getline(File, Line)) {
+    std::istringstream LineStream(Line);
+    std::string Name;
+    CachedBlockLayout Layout;
+    size_t NumBlocks = 0;
+    LineStream >> Name >> std::hex >> Layout.Hash >> std::dec >> NumBlocks;
+    Layout.Counts.resize(NumBlocks);
+    Layout.Order.resize(NumBlocks);
+    for (uint64_t &Count : Layout.Counts)
+      LineStream >> Count;
+    for (unsigned &Index : Layout.Order)
+      LineStream >> Index;
+    if (!LineStream || Name.empty()) {
+      BC.errs() << "BOLT-WARNING: ignoring malformed block layout cache "
+                << FileName << '\n';
+      Cache.clear();
+      return;
+    }
+    Cache[Name] = std::move(Layout);
+  }
+}
+
+void writeBlockLayoutCache(BinaryContext &BC, StringRef FileName,
+                           const BlockLayoutCacheTy &Cache) {
+  std::ofstream File(FileName.str(), std::ios::out);
+  if (!File) {
+    BC.errs() << "BOLT-WARNING: block layout cache " << FileName
+              << " cannot be written\n";
+    return;
+  }
+  for (const StringMapEntry<CachedBlockLayout> &Entry : Cache) {
+    const CachedBlockLayout &Layout = Entry.getValue();
+    File << Entry.getKey().str() << ' ' << std::hex << Layout.Hash << std::dec
+         << ' ' << Layout.Counts.size();
+    for (const uint64_t Count : Layout.Counts)
+      File << ' ' << Count;
+    for (const unsigned Index : Layout.Order)
+      File << ' ' << Index;
+    File << '\n';
+  }
+}
+
+/// Return the difference between the distributions of the block execution
+/// counts of \p BF and of \p Layout, from 0 (same) to 1 (disjoint).
+double getProfileDistance(const BinaryFunction &BF,
+                          const CachedBlockLayout &Layout) {
+  const uint64_t OldTotal =
+      std::accumulate(Layout.Counts.begin(), Layout.Counts.end(), uint64_t(0));
+  uint64_t NewTotal = 0;
+  for (const BinaryBasicBlock &BB : BF)
+    NewTotal += BB.getKnownExecutionCount();
+  if (!OldTotal || !NewTotal)
+    return 1.0;
+
+  double Distance = 0.0;
+  for (const BinaryBasicBlock &BB : BF)
+    Distance += std::abs((double)Layout.Counts[BB.getIndex()] / OldTotal -
+                         (double)BB.getKnownExecutionCount() / NewTotal);
+  return Distance / 2;
+}
+
+/// Apply the cached \p Layout to \p BF if it is still valid. Returns whether
+/// the order of the blocks changed, or std::nullopt if the layout wasn't
+/// reused.
+std::optional<bool> applyCachedBlockLayout(BinaryFunction &BF,
+                                           const CachedBlockLayout &Layout) {
+  if (Layout.Order.size() != BF.size() || Layout.Counts.size() != BF.size())
+    return std::nullopt;
+  if (getProfileDistance(BF, Layout) * 100 > opts::BlockLayoutCacheThreshold)
+    return std::nullopt;
+
+  SmallVector<BinaryBasicBlock *, 0> Blocks;
+  for (BinaryBasicBlock &BB : BF)
+    Blocks.push_back(&BB);
+  BinaryFunction::BasicBlockOrderType NewLayout;
+  BitVector Seen(BF.size());
+  for (const unsigned Index : Layout.Order) {
+    if (Index >= Blocks.size() || Seen[Index])
+      return std::nullopt;
+    Seen.set(Index);
+    NewLayout.push_back(Blocks[Index]);
+  }
+  if (NewLayout.front() != &BF.front())
+    return std::nullopt;
+  return BF.getLayout().update(NewLayout);
+}
+
+CachedBlockLayout getBlockLayout(const BinaryFunction &BF, uint64_t Hash) {
+  CachedBlockLayout Layout;
+  Layout.Hash = Hash;
+  Layout.Counts.resize(BF.size());
+  for (const BinaryBasicBlock &BB : BF)
+    Layout.Counts[BB.getIndex()] = BB.getKnownExecutionCount();
+  for (const BinaryBasicBlock *BB : BF.getLayout().blocks())
+    Layout.Order.push_back(BB->getIndex());
+  return Layout;
+}
+} // namespace
+
 Error ReorderBasicBlocks::runOnFunctions(BinaryContext &BC) {
   if (opts::ReorderBlocks == ReorderBasicBlocks::LT_NONE)
     return Error::success();
@@ -404,13 +548,45 @@ Error ReorderBasicBlocks::runOnFunctions(BinaryContext &BC) {
   std::mutex FunctionEditDistanceMutex;
   DenseMap<const BinaryFunction *, uint64_t> FunctionEditDistance;
 
+  // The layouts of the previous run, and the ones of this run. The layouts
+  // which are reused are kept as they were, so that small profile changes
+  // can't add up over runs.
+  const bool UseLayoutCache = !opts::BlockLayoutCache.empty();
+  BlockLayoutCacheTy InputLayoutCache;
+  BlockLayoutCacheTy OutputLayoutCache;
+  std::mutex OutputLayoutCacheMutex;
+  std::atomic_uint64_t ReusedLayoutCount(0);
+  if (UseLayoutCache)
+    readBlockLayoutCache(BC, opts::BlockLayoutCache, InputLayoutCache);
+
   ParallelUtilities::WorkFuncTy WorkFun = [&](BinaryFunction &BF) {
     SmallVector<const BinaryBasicBlock *, 0> OldBlockOrder;
     if (opts::PrintFuncStat > 0)
       llvm::copy(BF.getLayout().blocks(), std::back_inserter(OldBlockOrder));
 
+    std::optional<bool> ReusedLayout;
+    uint64_t Hash = 0;
+    auto CachedIt = InputLayoutCache.end();
+    if (UseLayoutCache && BF.hasValidProfile()) {
+      Hash = BF.computeHash(/*UseDFS=*/true);
+      CachedIt = InputLayoutCache.find(BF.getOneName());
+      if (CachedIt != InputLayoutCache.end() &&
+          CachedIt->getValue().Hash == Hash)
+        ReusedLayout = applyCachedBlockLayout(BF, CachedIt->getValue());
+    }
+
     const bool LayoutChanged =
-        modifyFunctionLayout(BF, opts::ReorderBlocks, opts::MinBranchClusters);
+        ReusedLayout ? *ReusedLayout
+                     : modifyFunctionLayout(BF, opts::ReorderBlocks,
+                                            opts::MinBranchClusters);
+    if (UseLayoutCache && BF.hasValidProfile()) {
+      CachedBlockLayout Layout = ReusedLayout ? CachedIt->getValue()
+                                              : getBlockLayout(BF, Hash);
+      if (ReusedLayout)
+        ReusedLayoutCount.fetch_add(1, std::memory_order_relaxed);
+      std::lock_guard<std::mutex> Lock(OutputLayoutCacheMutex);
+      OutputLayoutCache[BF.getOneName()] = std::move(Layout);
+    }
     if (LayoutChanged) {
       ModifiedFuncCount.fetch_add(1, std::memory_order_relaxed);
       if (opts::PrintFuncStat > 0) {
@@ -440,6 +616,13 @@ Error ReorderBasicBlocks::runOnFunctions(BinaryContext &BC) {
                    100.0 * ModifiedFuncCount.load(std::memory_order_relaxed) /
                        BC.getBinaryFunctions().size());
 
+  if (UseLayoutCache) {
+    BC.outs() << "BOLT-INFO: reused the cached block layout of "
+              << ReusedLayoutCount.load(std::memory_order_relaxed)
+              << " functions\n";
+    writeBlockLayoutCache(BC, opts::BlockLayoutCache, OutputLayoutCache);
+  }
+
   if (opts::PrintFuncStat > 0) {
     raw_ostream &OS = BC.outs();
     // Copy all the values into vector in order to sort them
@@ -1599,6 +1782,24 @@ Error PrintProgramStats::runOnFunctions(BinaryContext &BC) {
         BC.Stats.NumLooseMatchedBlocks, BC.Stats.NumStaleBlocks,
         100.0 * BC.Stats.LooseMatchedSampleCount / BC.Stats.StaleSampleCount,
         BC.Stats.LooseMatchedSampleCount, BC.Stats.StaleSampleCount);
+    const uint64_t NumMatchedBlocks =
+        BC.Stats.NumExactMatchedBlocks +
+        BC.Stats.NumPseudoProbeExactMatchedBlocks +
+        BC.Stats.NumPseudoProbeLooseMatchedBlocks +
+        BC.Stats.NumCallMatchedBlocks + BC.Stats.NumLooseMatchedBlocks;
+    const uint64_t MatchedSampleCount =
+        BC.Stats.ExactMatchedSampleCount +
+        BC.Stats.PseudoProbeExactMatchedSampleCount +
+        BC.Stats.PseudoProbeLooseMatchedSampleCount +
+        BC.Stats.CallMatchedSampleCount + BC.Stats.LooseMatchedSampleCount;
+    BC.outs() << format(
+        "BOLT-INFO: inference recovered %.2f%% of basic blocks"
+        " (%zu out of %zu stale) responsible for %.2f%% samples"
+        " (%zu out of %zu stale)\n",
+        100.0 * NumMatchedBlocks / BC.Stats.NumStaleBlocks, NumMatchedBlocks,
+        uint64_t(BC.Stats.NumStaleBlocks),
+        100.0 * MatchedSampleCount / BC.Stats.StaleSampleCount,
+        MatchedSampleCount, BC.Stats.StaleSampleCount);
   }
 
   if (const uint64_t NumUnusedObjects = BC.getNumUnusedProfiledObjects()) {
@@ -14,11 +14,58 @@
 #include "bolt/Passes/CacheMetrics.h"
 #include "bolt/Core/BinaryBasicBlock.h"
 #include "bolt/Core/BinaryFunction.h"
+#include "llvm/Support/CommandLine.h"
+#include <functional>
+#include <random>
 #include <unordered_map>
 
 using namespace llvm;
 using namespace bolt;
 
+namespace opts {
+
+extern cl::OptionCategory BoltOptCategory;
+extern cl::opt<uint32_t> RandomSeed;
+
+static cl::opt<bool> CacheSim(
+    "cache-sim",
+    cl::desc("with -print-cache-metrics, replay a trace synthesized from the "
+             "profile through a model of the i-cache and the i-TLB"),
+    cl::cat(BoltOptCategory));
+
+static cl::opt<unsigned> CacheSimTraceLength(
+    "cache-sim-trace-length",
+    cl::desc("number of basic block executions to replay with -cache-sim"),
+    cl::init(1000000), cl::cat(BoltOptCategory));
+
+static cl::opt<unsigned>
+    CacheSimLineSize("cache-sim-line-size",
+                     cl::desc("size of the simulated i-cache lines in bytes"),
+                     cl::init(64), cl::cat(BoltOptCategory));
+
+static cl::opt<unsigned>
+    CacheSimLines("cache-sim-lines",
+                  cl::desc("number of lines of the simulated i-cache"),
+                  cl::init(512), cl::cat(BoltOptCategory));
+
+static cl::opt<unsigned>
+    CacheSimAssoc("cache-sim-assoc",
+                  cl::desc("associativity of the simulated i-cache"),
+                  cl::init(8), cl::cat(BoltOptCategory));
+
+static cl::opt<unsigned> CacheSimITLBPageSize(
+    "cache-sim-itlb-page-size",
+    cl::desc("size of the pages of the simulated i-TLB in bytes, e.g. 2097152 "
+             "to model code mapped on huge pages"),
+    cl::init(4096), cl::cat(BoltOptCategory));
+
+static cl::opt<unsigned> CacheSimITLBEntries(
+    "cache-sim-itlb-entries",
+    cl::desc("number of entries of the simulated (fully associative) i-TLB"),
+    cl::init(64), cl::cat(BoltOptCategory));
+
+} // namespace opts
+
 namespace {
 
 /// The following constants are used to estimate the number of i-TLB cache
@@ -210,6 +257,146 @@ double expectedCacheHitRatio(
   return 100.0 * (1.0 - Misses / TotalSamples);
 }
 
+/// A set-associative cache with the LRU replacement policy.
+class LRUCacheModel {
+  unsigned Assoc;
+  /// The tags of every set, from the most to the least recently used.
+  std::vector<std::vector<uint64_t>> Sets;
+
+public:
+  LRUCacheModel(unsigned NumEntries, unsigned Assoc)
+      : Assoc(std::max(1u, std::min(Assoc, NumEntries))),
+        Sets(std::max(1u, NumEntries / this->Assoc)) {}
+
+  /// Access the entry \p Tag and return true if it was present in the cache.
+  bool access(uint64_t Tag) {
+    std::vector<uint64_t> &Set = Sets[Tag % Sets.size()];
+    auto It = llvm::find(Set, Tag);
+    const bool Hit = It != Set.end();
+    if (Hit)
+      Set.erase(It);
+    else if (Set.size() == Assoc)
+      Set.pop_back();
+    Set.insert(Set.begin(), Tag);
+    return Hit;
+  }
+};
+
+struct CacheSimStats {
+  uint64_t LineAccesses = 0;
+  uint64_t LineMisses = 0;
+  uint64_t PageAccesses = 0;
+  uint64_t PageMisses = 0;
+};
+
+/// Replay a trace of basic block executions through the i-cache and i-TLB
+/// models. The trace isn't recorded: it is synthesized by walking the CFGs
+/// at random, following the branches and the calls with the frequencies
+/// found in the profile, so that different layouts of the same binary are
+/// compared on the same trace.
+CacheSimStats
+simulateCaches(const std::vector<BinaryFunction *> &BinaryFunctions,
+               const std::unordered_map<BinaryBasicBlock *, uint64_t> &BBAddr,
+               const std::unordered_map<BinaryBasicBlock *, uint64_t> &BBSize) {
+  CacheSimStats Stats;
+  const uint64_t LineSize = std::max(1u, opts::CacheSimLineSize.getValue());
+  const uint64_t PageSize = std::max(1u, opts::CacheSimITLBPageSize.getValue());
+  LRUCacheModel ICache(opts::CacheSimLines, opts::CacheSimAssoc);
+  LRUCacheModel ITLB(opts::CacheSimITLBEntries, opts::CacheSimITLBEntries);
+
+  // The functions the walks start from, weighted by their execution counts.
+  std::vector<BinaryFunction *> Roots;
+  std::vector<uint64_t> RootCounts;
+  for (BinaryFunction *BF : BinaryFunctions) {
+    if (BF->getLayout().block_empty() || !BF->getKnownExecutionCount())
+      continue;
+    Roots.push_back(BF);
+    RootCounts.push_back(BF->getKnownExecutionCount());
+  }
+  if (Roots.empty())
+    return Stats;
+
+  std::mt19937_64 Rand(opts::RandomSeed);
+  std::discrete_distribution<size_t> RootDist(RootCounts.begin(),
+                                              RootCounts.end());
+  BinaryContext &BC = Roots.front()->getBinaryContext();
+  // Bound the depth of the calls, to stop the walk in recursive functions.
+  constexpr unsigned MaxCallDepth = 32;
+  uint64_t Budget = opts::CacheSimTraceLength;
+
+  auto touch = [&](BinaryBasicBlock *BB) {
+    auto AddrIt = BBAddr.find(BB);
+    auto SizeIt = BBSize.find(BB);
+    assert(AddrIt != BBAddr.end() && SizeIt != BBSize.end());
+    const uint64_t Begin = AddrIt->second;
+    const uint64_t End = Begin + std::max<uint64_t>(SizeIt->second, 1);
+    for (uint64_t Line = Begin / LineSize; Line <= (End - 1) / LineSize;
+         ++Line) {
+      ++Stats.LineAccesses;
+      Stats.LineMisses += !ICache.access(Line);
+    }
+    for (uint64_t Page = Begin / PageSize; Page <= (End - 1) / PageSize;
+         ++Page) {
+      ++Stats.PageAccesses;
+      Stats.PageMisses += !ITLB.access(Page);
+    }
+  };
+
+  std::function<void(BinaryFunction *, unsigned)> walk =
+      [&](BinaryFunction *BF, unsigned Depth) {
+        BinaryBasicBlock *BB = BF->getLayout().block_front();
+        while (BB && Budget) {
+          --Budget;
+          touch(BB);
+
+          // Execute the profiled callees of the block before leaving it.
+          if (Depth < MaxCallDepth) {
+            for (const MCInst &Inst : *BB) {
+              if (!BC.MIB->isCall(Inst))
+                continue;
+              const MCSymbol *Sym = BC.MIB->getTargetSymbol(Inst);
+              BinaryFunction *Callee =
+                  Sym ? BC.getFunctionForSymbol(Sym) : nullptr;
+              if (Callee && Callee->hasProfile() &&
+                  !Callee->getLayout().block_empty()) {
+                walk(Callee, Depth + 1);
+                touch(BB);
+              }
+            }
+          }
+
+          // Pick the next block with the frequencies of the profile. The
+          // function returns from the blocks without profiled successors.
+          uint64_t Total = 0;
+          auto BI = BB->branch_info_begin();
+          for (unsigned I = 0; I < BB->succ_size(); ++I, ++BI)
+            if (BI->Count != BinaryBasicBlock::COUNT_NO_PROFILE)
+              Total += BI->Count;
+          if (!Total)
+            break;
+          uint64_t Pick = std::uniform_int_distribution<uint64_t>(
+              0, Total - 1)(Rand);
+          BinaryBasicBlock *Next = nullptr;
+          BI = BB->branch_info_begin();
+          for (BinaryBasicBlock *Succ : BB->successors()) {
+            const uint64_t Count =
+                BI->Count == BinaryBasicBlock::COUNT_NO_PROFILE ? 0 : BI->Count;
+            ++BI;
+            if (Pick < Count) {
+              Next = Succ;
+              break;
+            }
+            Pick -= Count;
+          }
+          BB = Next;
+        }
+      };
+
+  while (Budget)
+    walk(Roots[RootDist(Rand)], 0);
+  return Stats;
+}
+
 } // namespace
 
 void CacheMetrics::printAll(raw_ostream &OS,
@@ -278,4 +465,23 @@ void CacheMetrics::printAll(raw_ostream &OS,
      << format("%.2lf%% (%zu out of %zu)\n",
                100.0 * Stats.first / std::max<uint64_t>(Stats.second, 1),
                Stats.first, Stats.second);
+
+  if (!opts::CacheSim)
+    return;
+  CacheSimStats SimStats = simulateCaches(BFs, BBAddr, BBSize);
+  OS << format("  Simulated i-cache (%u lines of %u bytes, %u-way): "
+               "%.2lf%% hit ratio (%zu misses out of %zu accesses)\n",
+               opts::CacheSimLines.getValue(),
+               opts::CacheSimLineSize.getValue(),
+               opts::CacheSimAssoc.getValue(),
+               100.0 - 100.0 * SimStats.LineMisses /
+                           std::max<uint64_t>(SimStats.LineAccesses, 1),
+               SimStats.LineMisses, SimStats.LineAccesses);
+  OS << format("  Simulated i-TLB (%u entries of %u bytes): "
+               "%.2lf%% hit ratio (%zu misses out of %zu accesses)\n",
+               opts::CacheSimITLBEntries.getValue(),
+               opts::CacheSimITLBPageSize.getValue(),
+               100.0 - 100.0 * SimStats.PageMisses /
+                           std::max<uint64_t>(SimStats.PageAccesses, 1),
+               SimStats.PageMisses, SimStats.PageAccesses);
 }
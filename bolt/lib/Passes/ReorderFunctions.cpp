@@ -52,7 +52,10 @@ cl::opt<bolt::ReorderFunctions::ReorderType> ReorderFunctions(
                clEnumValN(bolt::ReorderFunctions::RT_RANDOM, "random",
                           "reorder functions randomly"),
                clEnumValN(bolt::ReorderFunctions::RT_USER, "user",
-                          "use function order specified by -function-order")),
+                          "use function order specified by -function-order"),
+               clEnumValN(bolt::ReorderFunctions::RT_HUGEPAGE, "hugepage",
+                          "pack the hottest functions into huge pages, and "
+                          "order them with ext-TSP")),
     cl::ZeroOrMore, cl::cat(BoltOptCategory),
     cl::callback([](const bolt::ReorderFunctions::ReorderType &option) {
       if (option == bolt::ReorderFunctions::RT_HFSORT_PLUS) {
@@ -107,6 +110,17 @@ static cl::opt<bool> CgUseSplitHotSize(
              "call graph functions"),
     cl::init(false), cl::ZeroOrMore, cl::cat(BoltOptCategory));
 
+static cl::opt<unsigned> ReorderFunctionsHugePages(
+    "reorder-functions-huge-pages",
+    cl::desc("number of huge pages filled with the hottest functions by "
+             "-reorder-functions=hugepage"),
+    cl::init(1), cl::cat(BoltOptCategory));
+
+static cl::opt<unsigned> ReorderFunctionsHugePageSize(
+    "reorder-functions-huge-page-size",
+    cl::desc("size of the huge pages for -reorder-functions=hugepage"),
+    cl::init(2 << 20), cl::cat(BoltOptCategory));
+
 } // namespace opts
 
 namespace llvm {
@@ -366,6 +380,64 @@ Error ReorderFunctions::runOnFunctions(BinaryContext &BC) {
     std::vector<CallGraph::NodeId> NodeOrder(Result.begin(), Result.end());
     Clusters.emplace_back(Cluster(NodeOrder, Cg));
   } break;
+  case RT_HUGEPAGE: {
+    // Sort the functions by their density, so that the huge pages cover as
+    // many samples as possible.
+    auto density = [&](NodeId F) {
+      return double(Cg.samples(F)) / std::max<uint64_t>(Cg.size(F), 1);
+    };
+    std::vector<NodeId> SortedNodes;
+    for (NodeId F = 0; F < Cg.numNodes(); ++F)
+      if (Cg.samples(F) > 0)
+        SortedNodes.push_back(F);
+    llvm::stable_sort(SortedNodes, [&](NodeId A, NodeId B) {
+      return density(A) > density(B);
+    });
+
+    // Fill the huge pages with the densest functions.
+    const uint64_t Budget = uint64_t(opts::ReorderFunctionsHugePages) *
+                            opts::ReorderFunctionsHugePageSize;
+    uint64_t PackedSize = 0;
+    size_t NumPacked = 0;
+    while (NumPacked < SortedNodes.size() &&
+           PackedSize + Cg.size(SortedNodes[NumPacked]) <= Budget)
+      PackedSize += Cg.size(SortedNodes[NumPacked++]);
+
+    // Order the packed functions with ext-TSP, which keeps the densest one
+    // first. The calls are the edges of the graph.
+    DenseMap<NodeId, uint64_t> PackedIndex;
+    std::vector<uint64_t> FuncSizes;
+    std::vector<uint64_t> FuncCounts;
+    for (size_t I = 0; I < NumPacked; ++I) {
+      PackedIndex[SortedNodes[I]] = I;
+      FuncSizes.push_back(std::max<uint64_t>(Cg.size(SortedNodes[I]), 1));
+      FuncCounts.push_back(Cg.samples(SortedNodes[I]));
+    }
+    std::vector<codelayout::EdgeCount> CallCounts;
+    for (size_t I = 0; I < NumPacked; ++I) {
+      for (NodeId Succ : Cg.successors(SortedNodes[I])) {
+        auto It = PackedIndex.find(Succ);
+        if (It == PackedIndex.end() || It->second == I)
+          continue;
+        const Arc &Arc = *Cg.findArc(SortedNodes[I], Succ);
+        CallCounts.push_back({I, It->second, uint64_t(Arc.weight())});
+      }
+    }
+
+    std::vector<CallGraph::NodeId> NodeOrder;
+    if (NumPacked > 0)
+      for (uint64_t I :
+           codelayout::computeExtTspLayout(FuncSizes, FuncCounts, CallCounts))
+        NodeOrder.push_back(SortedNodes[I]);
+    // The functions which don't fit follow in the order of their density.
+    NodeOrder.insert(NodeOrder.end(), SortedNodes.begin() + NumPacked,
+                     SortedNodes.end());
+    if (opts::Verbosity > 0)
+      BC.outs() << "BOLT-INFO: packed " << NumPacked << " hot functions ("
+                << PackedSize << " bytes) into "
+                << opts::ReorderFunctionsHugePages << " huge pages\n";
+    Clusters.emplace_back(Cluster(NodeOrder, Cg));
+  } break;
   case RT_PETTIS_HANSEN:
     Clusters = pettisAndHansen(Cg);
     break;
@@ -14,6 +14,7 @@
 #include "bolt/Profile/DataAggregator.h"
 #include "bolt/Core/BinaryContext.h"
 #include "bolt/Core/BinaryFunction.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Passes/BinaryPasses.h"
 #include "bolt/Profile/BoltAddressTranslation.h"
 #include "bolt/Profile/Heatmap.h"
@@ -30,6 +31,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Regex.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -1469,9 +1471,9 @@ std::error_code DataAggregator::printLBRHeatMap() {
   return std::error_code();
 }
 
-uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
-                                        bool NeedsSkylakeFix) {
-  uint64_t NumTraces{0};
+void DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
+                                    bool NeedsSkylakeFix,
+                                    LBRAggregate &Aggr) const {
   // LBRs are stored in reverse execution order. NextPC refers to the next
   // recorded executed PC.
   uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
@@ -1493,7 +1495,7 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
       const BinaryFunction *TraceBF =
           getBinaryFunctionContainingAddress(TraceFrom);
       if (TraceBF && TraceBF->containsAddress(TraceTo)) {
-        FTInfo &Info = FallthroughLBRs[Trace(TraceFrom, TraceTo)];
+        FTInfo &Info = Aggr.FallthroughLBRs[Trace(TraceFrom, TraceTo)];
         if (TraceBF->containsAddress(LBR.From))
           ++Info.InternCount;
         else
@@ -1507,7 +1509,7 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
                    << formatv(" @ {0:x}", TraceFrom - TraceBF->getAddress())
                    << formatv(" and ending @ {0:x}\n", TraceTo);
           });
-          ++NumInvalidTraces;
+          ++Aggr.NumInvalidTraces;
         } else {
           LLVM_DEBUG({
             dbgs() << "Out of range trace starting in "
@@ -1519,10 +1521,10 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
                    << formatv(" @ {0:x}\n",
                               TraceTo - (ToFunc ? ToFunc->getAddress() : 0));
           });
-          ++NumLongRangeTraces;
+          ++Aggr.NumLongRangeTraces;
         }
       }
-      ++NumTraces;
+      ++Aggr.NumTraces;
     }
     NextPC = LBR.From;
 
@@ -1530,11 +1532,10 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
     uint64_t To = getBinaryFunctionContainingAddress(LBR.To) ? LBR.To : 0;
     if (!From && !To)
       continue;
-    TakenBranchInfo &Info = BranchLBRs[Trace(From, To)];
+    TakenBranchInfo &Info = Aggr.BranchLBRs[Trace(From, To)];
     ++Info.TakenCount;
     Info.MispredCount += LBR.Mispred;
   }
-  return NumTraces;
 }
 
 std::error_code DataAggregator::parseBranchEvents() {
@@ -1549,6 +1550,48 @@ std::error_code DataAggregator::parseBranchEvents() {
   uint64_t NumTraces = 0;
   bool NeedsSkylakeFix = false;
 
+  // The samples are parsed on this thread, and aggregated in batches by the
+  // thread pool while the next batch is parsed. This keeps the memory used
+  // bounded, however large the profile is. Each task of a batch aggregates
+  // into its own LBRAggregate, and these are merged once all the samples are
+  // parsed.
+  constexpr size_t BatchSize = 1 << 15;
+  ThreadPoolInterface *Pool =
+      opts::NoThreads ? nullptr : &ParallelUtilities::getThreadPool();
+  std::vector<LBRAggregate> Aggregates(Pool ? Pool->getMaxConcurrency() : 1);
+  std::vector<PerfBranchSample> Batch, AggregatedBatch;
+  Batch.reserve(BatchSize);
+  // Declared after the containers, so that the pending tasks are waited for
+  // before these get destroyed on early returns.
+  std::optional<ThreadPoolTaskGroup> Group;
+  if (Pool)
+    Group.emplace(*Pool);
+  // The index in Batch of the first sample which needs the Skylake fix.
+  size_t FirstFixedSample = SIZE_MAX;
+
+  auto aggregateBatch = [&]() {
+    // Wait until the previous batch is aggregated, so that its samples and
+    // the aggregates can be reused.
+    if (Group)
+      Group->wait();
+    std::swap(Batch, AggregatedBatch);
+    Batch.clear();
+    const size_t FixStart = FirstFixedSample;
+    FirstFixedSample = NeedsSkylakeFix ? 0 : SIZE_MAX;
+
+    const size_t Size = AggregatedBatch.size();
+    for (size_t I = 0, E = Aggregates.size(); I < E; ++I) {
+      auto aggregateSlice = [&, FixStart, I, E, Size] {
+        for (size_t J = Size * I / E, End = Size * (I + 1) / E; J < End; ++J)
+          parseLBRSample(AggregatedBatch[J], J >= FixStart, Aggregates[I]);
+      };
+      if (Group)
+        Group->async(aggregateSlice);
+      else
+        aggregateSlice();
+    }
+  };
+
   while (hasData() && NumTotalSamples < opts::MaxSamples) {
     ++NumTotalSamples;
 
@@ -1573,9 +1616,31 @@ std::error_code DataAggregator::parseBranchEvents() {
     if (BAT && Sample.LBR.size() == 32 && !NeedsSkylakeFix) {
       errs() << "PERF2BOLT-WARNING: using Intel Skylake bug workaround\n";
       NeedsSkylakeFix = true;
+      FirstFixedSample = Batch.size();
     }
 
-    NumTraces += parseLBRSample(Sample, NeedsSkylakeFix);
+    Batch.push_back(std::move(Sample));
+    if (Batch.size() == BatchSize)
+      aggregateBatch();
+  }
+  aggregateBatch();
+  if (Group)
+    Group->wait();
+
+  for (LBRAggregate &Aggr : Aggregates) {
+    for (const auto &[Trace, Info] : Aggr.BranchLBRs) {
+      TakenBranchInfo &Total = BranchLBRs[Trace];
+      Total.TakenCount += Info.TakenCount;
+      Total.MispredCount += Info.MispredCount;
+    }
+    for (const auto &[Trace, Info] : Aggr.FallthroughLBRs) {
+      FTInfo &Total = FallthroughLBRs[Trace];
+      Total.InternCount += Info.InternCount;
+      Total.ExternCount += Info.ExternCount;
+    }
+    NumTraces += Aggr.NumTraces;
+    NumInvalidTraces += Aggr.NumInvalidTraces;
+    NumLongRangeTraces += Aggr.NumLongRangeTraces;
   }
 
   for (const Trace &Trace : llvm::make_first_range(BranchLBRs))
@@ -26,6 +26,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "bolt/Core/HashUtilities.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Profile/YAMLProfileReader.h"
 #include "llvm/ADT/Bitfields.h"
 #include "llvm/ADT/Hashing.h"
@@ -552,6 +553,31 @@ createFlowFunction(const BinaryFunction::BasicBlockOrderType &BlockOrder) {
   return Func;
 }
 
+/// Add the stale matching stats of a function to the binary-wide ones.
+void addMatchingStats(BinaryContext::BinaryStats &Stats,
+                      const BinaryContext::BinaryStats &FuncStats) {
+  Stats.NumStaleBlocks += FuncStats.NumStaleBlocks;
+  Stats.NumExactMatchedBlocks += FuncStats.NumExactMatchedBlocks;
+  Stats.NumLooseMatchedBlocks += FuncStats.NumLooseMatchedBlocks;
+  Stats.NumPseudoProbeExactMatchedBlocks +=
+      FuncStats.NumPseudoProbeExactMatchedBlocks;
+  Stats.NumPseudoProbeLooseMatchedBlocks +=
+      FuncStats.NumPseudoProbeLooseMatchedBlocks;
+  Stats.NumCallMatchedBlocks += FuncStats.NumCallMatchedBlocks;
+  Stats.StaleSampleCount += FuncStats.StaleSampleCount;
+  Stats.ExactMatchedSampleCount += FuncStats.ExactMatchedSampleCount;
+  Stats.LooseMatchedSampleCount += FuncStats.LooseMatchedSampleCount;
+  Stats.PseudoProbeExactMatchedSampleCount +=
+      FuncStats.PseudoProbeExactMatchedSampleCount;
+  Stats.PseudoProbeLooseMatchedSampleCount +=
+      FuncStats.PseudoProbeLooseMatchedSampleCount;
+  Stats.CallMatchedSampleCount += FuncStats.CallMatchedSampleCount;
+  Stats.NumStaleFuncsWithEqualBlockCount +=
+      FuncStats.NumStaleFuncsWithEqualBlockCount;
+  Stats.NumStaleBlocksWithEqualIcount +=
+      FuncStats.NumStaleBlocksWithEqualIcount;
+}
+
 /// Assign initial block/jump weights based on the stale profile data. The goal
 /// is to extract as much information from the stale profile as possible. Here
 /// we assume that each basic block is specified via a hash value computed from
@@ -567,7 +593,8 @@ size_t matchWeights(
     const yaml::bolt::BinaryFunctionProfile &YamlBF, FlowFunction &Func,
     HashFunction HashFunction, YAMLProfileReader::ProfileLookupMap &IdToYamlBF,
     const BinaryFunction &BF,
-    const ArrayRef<YAMLProfileReader::ProbeMatchSpec> ProbeMatchSpecs) {
+    const ArrayRef<YAMLProfileReader::ProbeMatchSpec> ProbeMatchSpecs,
+    BinaryContext::BinaryStats &Stats) {
 
   assert(Func.Blocks.size() == BlockOrder.size() + 2);
 
@@ -639,8 +666,8 @@ size_t matchWeights(
   // Match blocks from the profile to the blocks in CFG by strict hash.
   for (const yaml::bolt::BinaryBasicBlockProfile &YamlBB : YamlBF.Blocks) {
     // Update matching stats.
-    ++BC.Stats.NumStaleBlocks;
-    BC.Stats.StaleSampleCount += YamlBB.ExecCount;
+    ++Stats.NumStaleBlocks;
+    Stats.StaleSampleCount += YamlBB.ExecCount;
 
     assert(YamlBB.Hash != 0 && "empty hash of BinaryBasicBlockProfile");
     BlendedBlockHash YamlHash(YamlBB.Hash);
@@ -702,28 +729,28 @@ size_t matchWeights(
       // Update matching stats accounting for the matched block.
       switch (Method) {
       case StaleMatcher::MATCH_EXACT:
-        ++BC.Stats.NumExactMatchedBlocks;
-        BC.Stats.ExactMatchedSampleCount += ExecCount;
+        ++Stats.NumExactMatchedBlocks;
+        Stats.ExactMatchedSampleCount += ExecCount;
         LLVM_DEBUG(dbgs() << "  exact match\n");
         break;
       case StaleMatcher::MATCH_PROBE_EXACT:
-        ++BC.Stats.NumPseudoProbeExactMatchedBlocks;
-        BC.Stats.PseudoProbeExactMatchedSampleCount += ExecCount;
+        ++Stats.NumPseudoProbeExactMatchedBlocks;
+        Stats.PseudoProbeExactMatchedSampleCount += ExecCount;
         LLVM_DEBUG(dbgs() << "  exact pseudo probe match\n");
         break;
       case StaleMatcher::MATCH_PROBE_LOOSE:
-        ++BC.Stats.NumPseudoProbeLooseMatchedBlocks;
-        BC.Stats.PseudoProbeLooseMatchedSampleCount += ExecCount;
+        ++Stats.NumPseudoProbeLooseMatchedBlocks;
+        Stats.PseudoProbeLooseMatchedSampleCount += ExecCount;
         LLVM_DEBUG(dbgs() << "  loose pseudo probe match\n");
         break;
       case StaleMatcher::MATCH_CALL:
-        ++BC.Stats.NumCallMatchedBlocks;
-        BC.Stats.CallMatchedSampleCount += ExecCount;
+        ++Stats.NumCallMatchedBlocks;
+        Stats.CallMatchedSampleCount += ExecCount;
         LLVM_DEBUG(dbgs() << "  call match\n");
         break;
       case StaleMatcher::MATCH_OPCODE:
-        ++BC.Stats.NumLooseMatchedBlocks;
-        BC.Stats.LooseMatchedSampleCount += ExecCount;
+        ++Stats.NumLooseMatchedBlocks;
+        Stats.LooseMatchedSampleCount += ExecCount;
         LLVM_DEBUG(dbgs() << "  loose match\n");
         break;
       case StaleMatcher::NO_MATCH:
@@ -901,7 +928,7 @@ void applyInference(FlowFunction &Func) {
 /// the binary function.
 void assignProfile(BinaryFunction &BF,
                    const BinaryFunction::BasicBlockOrderType &BlockOrder,
-                   FlowFunction &Func) {
+                   FlowFunction &Func, MCPlusBuilder::AllocatorIdTy AllocId) {
   BinaryContext &BC = BF.getBinaryContext();
 
   assert(Func.Blocks.size() == BlockOrder.size() + 2);
@@ -949,7 +976,7 @@ void assignProfile(BinaryFunction &BF,
       // Do not add zero-count annotations
       if (Count == 0)
         return;
-      BC.MIB->addAnnotation(Instr, Name, Count);
+      BC.MIB->addAnnotation(Instr, Name, Count, AllocId);
     };
 
     for (MCInst &Instr : *BB) {
@@ -963,7 +990,7 @@ void assignProfile(BinaryFunction &BF,
 
       if (BC.MIB->isIndirectCall(Instr) || BC.MIB->isIndirectBranch(Instr)) {
         auto &ICSP = BC.MIB->getOrCreateAnnotationAs<IndirectCallSiteProfile>(
-            Instr, "CallProfile");
+            Instr, "CallProfile", AllocId);
         if (!ICSP.empty()) {
           // Try to evenly distribute the counts among the call sites
           const uint64_t TotalCount = Block.Flow;
@@ -998,10 +1025,8 @@ void assignProfile(BinaryFunction &BF,
 
 bool YAMLProfileReader::inferStaleProfile(
     BinaryFunction &BF, const yaml::bolt::BinaryFunctionProfile &YamlBF,
-    const ArrayRef<ProbeMatchSpec> ProbeMatchSpecs) {
-
-  NamedRegionTimer T("inferStaleProfile", "stale profile inference", "rewrite",
-                     "Rewrite passes", opts::TimeRewrite);
+    const ArrayRef<ProbeMatchSpec> ProbeMatchSpecs,
+    MCPlusBuilder::AllocatorIdTy AllocId) {
 
   if (!BF.hasCFG())
     return false;
@@ -1021,9 +1046,15 @@ bool YAMLProfileReader::inferStaleProfile(
   FlowFunction Func = createFlowFunction(BlockOrder);
 
   // Match as many block/jump counts from the stale profile as possible
-  size_t MatchedBlocks =
-      matchWeights(BF.getBinaryContext(), BlockOrder, YamlBF, Func,
-                   YamlBP.Header.HashFunction, IdToYamLBF, BF, ProbeMatchSpecs);
+  BinaryContext &BC = BF.getBinaryContext();
+  BinaryContext::BinaryStats Stats;
+  size_t MatchedBlocks = matchWeights(BC, BlockOrder, YamlBF, Func,
+                                      YamlBP.Header.HashFunction, IdToYamLBF,
+                                      BF, ProbeMatchSpecs, Stats);
+  {
+    std::lock_guard<std::mutex> Lock(StaleStatsMutex);
+    addMatchingStats(BC.Stats, Stats);
+  }
 
   // Adjust the flow function by marking unreachable blocks Unlikely so that
   // they don't get any counts assigned.
@@ -1037,7 +1068,7 @@ bool YAMLProfileReader::inferStaleProfile(
   applyInference(Func);
 
   // Collect inferred counts and update function annotations.
-  assignProfile(BF, BlockOrder, Func);
+  assignProfile(BF, BlockOrder, Func, AllocId);
 
   // As of now, we always mark the binary function having "correct" profile.
   // In the future, we may discard the results for instances with poor inference
@@ -1045,5 +1076,33 @@ bool YAMLProfileReader::inferStaleProfile(
   return true;
 }
 
+void YAMLProfileReader::inferStaleProfiles(BinaryContext &BC) {
+  if (StaleFunctions.empty())
+    return;
+
+  NamedRegionTimer T("inferStaleProfile", "stale profile inference", "rewrite",
+                     "Rewrite passes", opts::TimeRewrite);
+
+  // Every function only reads the profile and its own CFG, so the inference
+  // runs on all of them at the same time.
+  ParallelUtilities::WorkFuncWithAllocTy WorkFun =
+      [&](BinaryFunction &BF, MCPlusBuilder::AllocatorIdTy AllocId) {
+        const yaml::bolt::BinaryFunctionProfile &YamlBF =
+            *StaleFunctions.lookup(&BF);
+        ArrayRef<ProbeMatchSpec> ProbeMatchSpecs;
+        auto BFIt = BFToProbeMatchSpecs.find(&BF);
+        if (BFIt != BFToProbeMatchSpecs.end())
+          ProbeMatchSpecs = BFIt->second;
+        if (inferStaleProfile(BF, YamlBF, ProbeMatchSpecs, AllocId))
+          BF.markProfiled(YamlBP.Header.Flags);
+      };
+  ParallelUtilities::PredicateTy SkipFunc = [&](const BinaryFunction &BF) {
+    return !StaleFunctions.count(const_cast<BinaryFunction *>(&BF));
+  };
+  ParallelUtilities::runOnEachFunctionWithUniqueAllocId(
+      BC, ParallelUtilities::SchedulingPolicy::SP_BB_QUADRATIC, WorkFun,
+      SkipFunc, "inferStaleProfiles");
+}
+
 } // end namespace bolt
 } // end namespace llvm
@@ -354,11 +354,10 @@ bool YAMLProfileReader::parseFunctionProfile(
 
     if (!opts::InferStaleProfile)
       return false;
-    ArrayRef<ProbeMatchSpec> ProbeMatchSpecs;
-    auto BFIt = BFToProbeMatchSpecs.find(&BF);
-    if (BFIt != BFToProbeMatchSpecs.end())
-      ProbeMatchSpecs = BFIt->second;
-    ProfileMatched = inferStaleProfile(BF, YamlBF, ProbeMatchSpecs);
+    // The profile is inferred later, in parallel with the other stale
+    // functions.
+    StaleFunctions[&BF] = &YamlBF;
+    return false;
   }
   if (ProfileMatched)
     BF.markProfiled(YamlBP.Header.Flags);
@@ -873,6 +872,7 @@ Error YAMLProfileReader::readProfile(BinaryContext &BC) {
     else
       ++NumUnused;
   }
+  inferStaleProfiles(BC);
 
   BC.setNumUnusedProfiledObjects(NumUnused);
 
@@ -4027,7 +4027,17 @@ void RewriteInstance::updateOutputValues(const BOLTLinker &Linker) {
   if (std::optional<AddressMap> Map = AddressMap::parse(*BC))
     BC->setIOAddressMap(std::move(*Map));
 
-  for (BinaryFunction *Function : BC->getAllBinaryFunctions())
+  // The output values of each function only depend on the linker symbols and
+  // on the address map, which are read-only by now, so the functions can be
+  // updated in parallel.
+  ParallelUtilities::WorkFuncTy WorkFun = [&](BinaryFunction &BF) {
+    BF.updateOutputValues(Linker);
+  };
+  ParallelUtilities::runOnEachFunction(
+      *BC, ParallelUtilities::SchedulingPolicy::SP_BB_LINEAR, WorkFun,
+      /*SkipPredicate=*/nullptr, "updateOutputValues");
+
+  for (BinaryFunction *Function : BC->getInjectedBinaryFunctions())
     Function->updateOutputValues(Linker);
 }
 
@@ -38,10 +38,12 @@ import argparse
 import asyncio
 from dataclasses import dataclass
 import glob
+import hashlib
 import json
 import multiprocessing
 import os
 import re
+import shlex
 import shutil
 import subprocess
 import sys
@@ -49,7 +51,7 @@ import tempfile
 import time
 import traceback
 from types import ModuleType
-from typing import Any, Awaitable, Callable, List, Optional, TypeVar
+from typing import Any, Awaitable, Callable, Dict, List, Optional, TypeVar
 
 
 yaml: Optional[ModuleType] = None
@@ -209,6 +211,98 @@ def apply_fixes(
     subprocess.call(invocation)
 
 
+def get_preprocessor_invocation(
+    entry: Dict[str, Any], extra_arg: List[str], extra_arg_before: List[str]
+) -> List[str]:
+    """Gets a command line that preprocesses the file of a compile command,
+    keeping the comments, macro definitions and #include directives."""
+    if "arguments" in entry:
+        command = list(entry["arguments"])
+    else:
+        command = shlex.split(entry["command"])
+    invocation = [command[0]] + extra_arg_before
+    skip_next = False
+    for arg in command[1:]:
+        if skip_next:
+            skip_next = False
+        elif arg in ("-o", "-MF", "-MT", "-MQ"):
+            skip_next = True
+        elif arg in ("-c", "-M", "-MM", "-MD", "-MMD", "-MG", "-MP"):
+            pass
+        elif arg.startswith(("-MF", "-MT", "-MQ")) or (
+            arg.startswith("-o") and len(arg) > 2
+        ):
+            pass
+        else:
+            invocation.append(arg)
+    invocation += extra_arg
+    invocation += ["-E", "-C", "-dD", "-dI", "-o", "-"]
+    return invocation
+
+
+async def get_cache_key(
+    args: argparse.Namespace,
+    invocation: List[str],
+    entry: Dict[str, Any],
+    clang_tidy_binary: str,
+) -> Optional[str]:
+    """
+    Returns a key covering everything the results of the clang-tidy
+    invocation depend on, or None if it can't be computed: the clang-tidy
+    binary, the invocation, the configuration in effect for the file and the
+    preprocessed file.
+    """
+    hasher = hashlib.sha256()
+    binary = shutil.which(clang_tidy_binary) or clang_tidy_binary
+    stat = os.stat(binary)
+    hasher.update(f"{binary} {stat.st_size} {stat.st_mtime_ns}\n".encode())
+    hasher.update(json.dumps(invocation).encode())
+    hasher.update(json.dumps(entry, sort_keys=True).encode())
+
+    for command, cwd in (
+        (invocation[:-1] + ["--dump-config", invocation[-1]], None),
+        (
+            get_preprocessor_invocation(
+                entry, args.extra_arg, args.extra_arg_before
+            ),
+            entry["directory"],
+        ),
+    ):
+        try:
+            process = await asyncio.create_subprocess_exec(
+                *command,
+                cwd=cwd,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.DEVNULL,
+            )
+            stdout, _ = await process.communicate()
+        except OSError:
+            return None
+        if process.returncode != 0:
+            return None
+        hasher.update(stdout)
+    return hasher.hexdigest()
+
+
+def read_json(path: str) -> Any:
+    """Reads a file written by write_json, or returns None."""
+    try:
+        with open(path) as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+
+
+def write_json(path: str, value: Any) -> None:
+    """Writes a file in the cache directory."""
+    # Write to a temporary file first, so that concurrent runs never see a
+    # partial file.
+    (handle, name) = tempfile.mkstemp(suffix=".tmp", dir=os.path.dirname(path))
+    with os.fdopen(handle, "w") as f:
+        json.dump(value, f)
+    os.replace(name, path)
+
+
 # FIXME Python 3.12: This can be simplified out with run_with_semaphore[T](...).
 T = TypeVar("T")
 
@@ -231,6 +325,7 @@ class ClangTidyResult:
     stdout: str
     stderr: str
     elapsed: float
+    cached: bool = False
 
 
 async def run_tidy(
@@ -239,9 +334,12 @@ async def run_tidy(
     clang_tidy_binary: str,
     tmpdir: str,
     build_path: str,
+    entry: Dict[str, Any],
 ) -> ClangTidyResult:
     """
-    Runs clang-tidy on a single file and returns the result.
+    Runs clang-tidy on a single file and returns the result. With a cache
+    directory, the results of a previous run are returned instead if nothing
+    they depend on changed.
     """
     invocation = get_tidy_invocation(
         name,
@@ -264,6 +362,22 @@ async def run_tidy(
         args.allow_no_checks,
     )
 
+    # Fixes aren't cached, so don't use the cache when they're needed.
+    key = None
+    if args.cache_dir is not None and tmpdir is None:
+        key = await get_cache_key(args, invocation, entry, clang_tidy_binary)
+        cached = read_json(os.path.join(args.cache_dir, key + ".json")) if key else None
+        if cached is not None:
+            return ClangTidyResult(
+                name,
+                invocation,
+                cached["returncode"],
+                cached["stdout"],
+                cached["stderr"],
+                0.0,
+                cached=True,
+            )
+
     try:
         process = await asyncio.create_subprocess_exec(
             *invocation, stdout=subprocess.PIPE, stderr=subprocess.PIPE
@@ -277,7 +391,7 @@ async def run_tidy(
         raise
 
     assert process.returncode is not None
-    return ClangTidyResult(
+    result = ClangTidyResult(
         name,
         invocation,
         process.returncode,
@@ -285,6 +399,17 @@ async def run_tidy(
         stderr.decode("UTF-8"),
         end - start,
     )
+    # Results of crashed runs are not worth keeping.
+    if key is not None and result.returncode >= 0:
+        write_json(
+            os.path.join(args.cache_dir, key + ".json"),
+            {
+                "returncode": result.returncode,
+                "stdout": result.stdout,
+                "stderr": result.stderr,
+            },
+        )
+    return result
 
 
 async def main() -> None:
@@ -446,6 +571,16 @@ async def main() -> None:
         action="store_true",
         help="Allow empty enabled checks.",
     )
+    parser.add_argument(
+        "-cache-dir",
+        default=None,
+        help="Directory in which the results of clang-tidy are cached, so "
+        "that the files are only checked again when they, the headers they "
+        "include, their compile commands, the configuration or clang-tidy "
+        "change. The time each file took to check is also kept there, and the "
+        "slowest files are started first. The results are not cached when "
+        "fixes are exported or applied.",
+    )
     args = parser.parse_args()
 
     db_path = "compile_commands.json"
@@ -522,7 +657,11 @@ async def main() -> None:
     # Load the database and extract all files.
     with open(os.path.join(build_path, db_path)) as f:
         database = json.load(f)
-    files = {os.path.abspath(os.path.join(e["directory"], e["file"])) for e in database}
+    entries: Dict[str, Dict[str, Any]] = {}
+    for e in database:
+        path = os.path.abspath(os.path.join(e["directory"], e["file"]))
+        entries.setdefault(path, e)
+    files = set(entries)
     number_files_in_database = len(files)
 
     # Filter source files from compilation database.
@@ -554,6 +693,17 @@ async def main() -> None:
         "in compilation database ...",
     )
 
+    # Start the files which were the slowest to check in the previous runs
+    # first, and the ones which were never checked before them, so that the
+    # slowest file doesn't end up running alone at the end.
+    timings: Dict[str, float] = {}
+    timings_path = None
+    if args.cache_dir is not None:
+        os.makedirs(args.cache_dir, exist_ok=True)
+        timings_path = os.path.join(args.cache_dir, "timings.json")
+        timings = read_json(timings_path) or {}
+    ordered_files = sorted(files, key=lambda f: -timings.get(f, float("inf")))
+
     returncode = 0
     semaphore = asyncio.Semaphore(max_task)
     tasks = [
@@ -566,9 +716,10 @@ async def main() -> None:
                 clang_tidy_binary,
                 export_fixes_dir,
                 build_path,
+                entries[f],
             )
         )
-        for f in files
+        for f in ordered_files
     ]
 
     try:
@@ -579,7 +730,11 @@ async def main() -> None:
                 if result.returncode < 0:
                     result.stderr += f"{result.filename}: terminated by signal {-result.returncode}\n"
             progress = f"[{i + 1: >{len(f'{len(files)}')}}/{len(files)}]"
-            runtime = f"[{result.elapsed:.1f}s]"
+            if result.cached:
+                runtime = "[cached]"
+            else:
+                runtime = f"[{result.elapsed:.1f}s]"
+                timings[result.filename] = result.elapsed
             print(f"{progress}{runtime} {' '.join(result.invocation)}")
             if result.stdout:
                 print(result.stdout, end=("" if result.stderr else "\n"))
@@ -594,6 +749,9 @@ async def main() -> None:
             shutil.rmtree(export_fixes_dir)
         return
 
+    if timings_path is not None:
+        write_json(timings_path, timings)
+
     if combine_fixes:
         print(f"Writing fixes to {args.export_fixes} ...")
         try:
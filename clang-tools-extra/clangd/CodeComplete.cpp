@@ -220,6 +220,7 @@ struct CompletionCandidate {
   const Symbol *IndexResult = nullptr;
   const RawIdentifier *IdentifierResult = nullptr;
   llvm::SmallVector<SymbolInclude, 1> RankedIncludeHeaders;
+  float NameMatch = 0; // The fuzzy match score of Name.
 
   // Returns a token identifying the overload set this is part of.
   // 0 indicates it's not part of any overload set.
@@ -1939,13 +1940,21 @@ private:
       C.IdentifierResult = IdentifierResult;
       if (C.IndexResult) {
         C.Name = IndexResult->Name;
-        C.RankedIncludeHeaders = getRankedIncludes(*C.IndexResult);
       } else if (C.SemaResult) {
         C.Name = Recorder->getName(*SemaResult);
       } else {
         assert(IdentifierResult);
         C.Name = IdentifierResult->Name;
       }
+      // Drop the candidates that don't match the filter before computing the
+      // headers and overload sets, which is much more expensive. Overloads
+      // share the name, so this drops the same bundles as scoring would.
+      if (auto FuzzyScore = fuzzyScore(C))
+        C.NameMatch = *FuzzyScore;
+      else
+        return;
+      if (C.IndexResult)
+        C.RankedIncludeHeaders = getRankedIncludes(*C.IndexResult);
       if (auto OverloadSet = C.overloadSet(
               Opts, FileName, Inserter ? &*Inserter : nullptr, CCContextKind)) {
         auto Ret = BundleLookup.try_emplace(OverloadSet, Bundles.size());
@@ -2050,10 +2059,7 @@ private:
     Relevance.MainFileSignals = Opts.MainFileSignals;
 
     auto &First = Bundle.front();
-    if (auto FuzzyScore = fuzzyScore(First))
-      Relevance.NameMatch = *FuzzyScore;
-    else
-      return;
+    Relevance.NameMatch = First.NameMatch;
     SymbolOrigin Origin = SymbolOrigin::Unknown;
     bool FromIndex = false;
     for (const auto &Candidate : Bundle) {
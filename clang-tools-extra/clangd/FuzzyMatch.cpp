@@ -185,16 +185,17 @@ bool FuzzyMatcher::init(llvm::StringRef NewWord) {
   std::copy(NewWord.begin(), NewWord.begin() + WordN, Word);
   if (PatN == 0)
     return true;
-  for (int I = 0; I < WordN; ++I)
-    LowWord[I] = lower(Word[I]);
 
-  // Cheap subsequence check.
+  // Cheap subsequence check. Most words are rejected here, so it runs before
+  // the word is lowercased.
   for (int W = 0, P = 0; P != PatN; ++W) {
     if (W == WordN)
       return false;
-    if (LowWord[W] == LowPat[P])
+    if (lower(Word[W]) == LowPat[P])
       ++P;
   }
+  for (int I = 0; I < WordN; ++I)
+    LowWord[I] = lower(Word[I]);
 
   // FIXME: some words are hard to tokenize algorithmically.
   // e.g. vsprintf is V S Print F, and should match [pri] but not [int].
@@ -34,6 +34,7 @@
 #include "clang/Tooling/Inclusions/StandardLibrary.h"
 #include "clang/Tooling/Syntax/Tokens.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/GenericUniformityImpl.h"
 #include "llvm/ADT/STLExtras.h"
@@ -374,6 +375,8 @@ computeIncludeCleanerFindings(ParsedAST &AST, bool AnalyzeAngledIncludes) {
                                               .getHeaderSearchInfo()
                                               .getModuleMap()
                                               .getBuiltinDir();
+  // The unsatisfied references to a symbol all need the same spelling.
+  llvm::DenseMap<include_cleaner::Header, std::string> Spellings;
   include_cleaner::walkUsed(
       AST.getLocalTopLevelDecls(), /*MacroRefs=*/Macros,
       &AST.getPragmaIncludes(), AST.getPreprocessor(),
@@ -406,11 +409,13 @@ computeIncludeCleanerFindings(ParsedAST &AST, bool AnalyzeAngledIncludes) {
         // physical foo.h, but can have a spelling that refers to it.
         // We postpone this check because spelling a header for every usage is
         // expensive.
-        std::string Spelling = include_cleaner::spellHeader(
-            {Providers.front(), AST.getPreprocessor().getHeaderSearchInfo(),
-             MainFile});
-        for (auto *Inc :
-             ConvertedIncludes.match(include_cleaner::Header{Spelling})) {
+        auto [SpellingIt, Inserted] = Spellings.try_emplace(Providers.front());
+        if (Inserted)
+          SpellingIt->second = include_cleaner::spellHeader(
+              {Providers.front(), AST.getPreprocessor().getHeaderSearchInfo(),
+               MainFile});
+        for (auto *Inc : ConvertedIncludes.match(
+                 include_cleaner::Header{SpellingIt->second})) {
           Satisfied = true;
           auto HeaderID =
               AST.getIncludeStructure().getID(&Inc->Resolved->getFileEntry());
@@ -9,11 +9,14 @@
 #include "ModulesBuilder.h"
 #include "Compiler.h"
 #include "support/Logger.h"
+#include "support/Threading.h"
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/InMemoryModuleCache.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/Threading.h"
+#include <optional>
 #include <queue>
 
 namespace clang {
@@ -359,21 +362,25 @@ void ModuleFileCache::remove(StringRef ModuleName) {
 
 /// Collect the directly and indirectly required module names for \param
 /// ModuleName in topological order. The \param ModuleName is guaranteed to
-/// be the last element in \param ModuleNames.
-llvm::SmallVector<StringRef> getAllRequiredModules(ProjectModules &MDB,
-                                                   StringRef ModuleName) {
+/// be the last element in \param ModuleNames. The modules directly required
+/// by every one of them are stored into \param RequiredModules, which owns
+/// the returned names.
+llvm::SmallVector<StringRef> getAllRequiredModules(
+    ProjectModules &MDB, StringRef ModuleName,
+    llvm::StringMap<std::vector<std::string>> &RequiredModules) {
   llvm::SmallVector<llvm::StringRef> ModuleNames;
-  llvm::StringSet<> ModuleNamesSet;
 
   auto VisitDeps = [&](StringRef ModuleName, auto Visitor) -> void {
-    ModuleNamesSet.insert(ModuleName);
+    auto [It, Inserted] = RequiredModules.try_emplace(ModuleName);
+    if (!Inserted)
+      return;
+    It->second =
+        MDB.getRequiredModules(MDB.getSourceForModuleName(ModuleName));
 
-    for (StringRef RequiredModuleName :
-         MDB.getRequiredModules(MDB.getSourceForModuleName(ModuleName)))
-      if (ModuleNamesSet.insert(RequiredModuleName).second)
-        Visitor(RequiredModuleName, Visitor);
+    for (StringRef RequiredModuleName : It->second)
+      Visitor(RequiredModuleName, Visitor);
 
-    ModuleNames.push_back(ModuleName);
+    ModuleNames.push_back(It->first());
   };
   VisitDeps(ModuleName, VisitDeps);
 
@@ -384,7 +391,10 @@ llvm::SmallVector<StringRef> getAllRequiredModules(ProjectModules &MDB,
 
 class ModulesBuilder::ModulesBuilderImpl {
 public:
-  ModulesBuilderImpl(const GlobalCompilationDatabase &CDB) : Cache(CDB) {}
+  ModulesBuilderImpl(const GlobalCompilationDatabase &CDB)
+      : Cache(CDB),
+        Barrier(llvm::heavyweight_hardware_concurrency()
+                    .compute_thread_count()) {}
 
   const GlobalCompilationDatabase &getCDB() const { return Cache.getCDB(); }
 
@@ -395,6 +405,9 @@ public:
 
 private:
   ModuleFileCache Cache;
+  // Limits the number of module files built at the same time, across all the
+  // source files.
+  Semaphore Barrier;
 };
 
 llvm::Error ModulesBuilder::ModulesBuilderImpl::getOrBuildModuleFile(
@@ -416,31 +429,85 @@ llvm::Error ModulesBuilder::ModulesBuilderImpl::getOrBuildModuleFile(
         llvm::formatv("Don't get the module unit for module {0}", ModuleName));
 
   // Get Required modules in topological order.
-  auto ReqModuleNames = getAllRequiredModules(MDB, ModuleName);
-  for (llvm::StringRef ReqModuleName : ReqModuleNames) {
-    if (BuiltModuleFiles.isModuleUnitBuilt(ModuleName))
-      continue;
-
-    if (auto Cached = Cache.getModule(ReqModuleName)) {
-      if (IsModuleFileUpToDate(Cached->getModuleFilePath(), BuiltModuleFiles,
-                               TFS.view(std::nullopt))) {
-        log("Reusing module {0} from {1}", ModuleName,
-            Cached->getModuleFilePath());
-        BuiltModuleFiles.addModuleFile(std::move(Cached));
+  llvm::StringMap<std::vector<std::string>> RequiredModules;
+  llvm::SmallVector<StringRef> Pending;
+  for (StringRef ReqModuleName :
+       getAllRequiredModules(MDB, ModuleName, RequiredModules))
+    if (!BuiltModuleFiles.isModuleUnitBuilt(ReqModuleName))
+      Pending.push_back(ReqModuleName);
+
+  // The modules whose required modules are all available don't depend on
+  // each other, so every round builds them in parallel.
+  while (!Pending.empty()) {
+    llvm::SmallVector<StringRef> ToBuild;
+    llvm::SmallVector<StringRef> Blocked;
+    for (StringRef ReqModuleName : Pending) {
+      if (!llvm::all_of(RequiredModules.find(ReqModuleName)->second,
+                        [&](StringRef Required) {
+                          return BuiltModuleFiles.isModuleUnitBuilt(Required);
+                        })) {
+        Blocked.push_back(ReqModuleName);
         continue;
       }
-      Cache.remove(ReqModuleName);
+
+      if (auto Cached = Cache.getModule(ReqModuleName)) {
+        if (IsModuleFileUpToDate(Cached->getModuleFilePath(), BuiltModuleFiles,
+                                 TFS.view(std::nullopt))) {
+          log("Reusing module {0} from {1}", ReqModuleName,
+              Cached->getModuleFilePath());
+          BuiltModuleFiles.addModuleFile(std::move(Cached));
+          continue;
+        }
+        Cache.remove(ReqModuleName);
+      }
+      ToBuild.push_back(ReqModuleName);
+    }
+    if (ToBuild.empty() && Blocked.size() == Pending.size())
+      return llvm::createStringError(
+          llvm::formatv("Cyclic dependency on module {0}", Blocked.front()));
+
+    // ProjectModules isn't threadsafe, so find the sources beforehand.
+    std::vector<std::string> Sources;
+    for (StringRef ReqModuleName : ToBuild)
+      Sources.push_back(MDB.getSourceForModuleName(ReqModuleName).str());
+
+    std::vector<std::optional<llvm::Expected<ModuleFile>>> Results(
+        ToBuild.size());
+    {
+      // The module files of this round are added when all of them are built.
+      const ReusablePrerequisiteModules &AvailableModuleFiles =
+          BuiltModuleFiles;
+      auto Build = [&](size_t I) {
+        std::lock_guard<Semaphore> Lock(Barrier);
+        Results[I].emplace(buildModuleFile(ToBuild[I], Sources[I], getCDB(),
+                                           TFS, AvailableModuleFiles));
+      };
+      if (ToBuild.size() == 1) {
+        Build(0);
+      } else {
+        AsyncTaskRunner Tasks;
+        for (size_t I = 0; I < ToBuild.size(); ++I)
+          Tasks.runAsync("build:" + ToBuild[I], [&Build, I] { Build(I); });
+      }
     }
 
-    llvm::Expected<ModuleFile> MF = buildModuleFile(
-        ModuleName, ModuleUnitFileName, getCDB(), TFS, BuiltModuleFiles);
-    if (llvm::Error Err = MF.takeError())
+    llvm::Error Err = llvm::Error::success();
+    for (std::optional<llvm::Expected<ModuleFile>> &MF : Results) {
+      if (!*MF) {
+        Err = llvm::joinErrors(std::move(Err), MF->takeError());
+        continue;
+      }
+      log("Built module {0} to {1}", (*MF)->getModuleName(),
+          (*MF)->getModuleFilePath());
+      auto BuiltModuleFile =
+          std::make_shared<const ModuleFile>(std::move(**MF));
+      Cache.add(BuiltModuleFile->getModuleName(), BuiltModuleFile);
+      BuiltModuleFiles.addModuleFile(std::move(BuiltModuleFile));
+    }
+    if (Err)
       return Err;
 
-    log("Built module {0} to {1}", ModuleName, MF->getModuleFilePath());
-    auto BuiltModuleFile = std::make_shared<const ModuleFile>(std::move(*MF));
-    Cache.add(ModuleName, BuiltModuleFile);
-    BuiltModuleFiles.addModuleFile(std::move(BuiltModuleFile));
+    Pending = std::move(Blocked);
   }
 
   return llvm::Error::success();
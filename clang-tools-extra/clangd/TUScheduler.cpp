@@ -152,33 +152,45 @@ class TUScheduler::ASTCache {
 public:
   using Key = const ASTWorker *;
 
-  ASTCache(unsigned MaxRetainedASTs) : MaxRetainedASTs(MaxRetainedASTs) {}
+  ASTCache(const ASTRetentionPolicy &Policy)
+      : MaxRetainedASTs(Policy.MaxRetainedASTs),
+        MaxRetainedBytes(Policy.MaxRetainedBytes) {}
 
   /// Returns result of getUsedBytes() for the AST cached by \p K.
   /// If no AST is cached, 0 is returned.
   std::size_t getUsedBytes(Key K) {
     std::lock_guard<std::mutex> Lock(Mut);
     auto It = findByKey(K);
-    if (It == LRU.end() || !It->second)
+    if (It == LRU.end())
       return 0;
-    return It->second->getUsedBytes();
+    return It->Bytes;
   }
 
-  /// Store the value in the pool, possibly removing the last used AST.
+  /// Store the value in the pool, possibly removing the least recently used
+  /// ASTs.
   /// The value should not be in the pool when this function is called.
   void put(Key K, std::unique_ptr<ParsedAST> V) {
+    // Computing the size walks the allocators, do it outside the lock.
+    std::size_t Bytes = V ? V->getUsedBytes() : 0;
     std::unique_lock<std::mutex> Lock(Mut);
     assert(findByKey(K) == LRU.end());
 
-    LRU.insert(LRU.begin(), {K, std::move(V)});
-    if (LRU.size() <= MaxRetainedASTs)
-      return;
-    // We're past the limit, remove the last element.
-    std::unique_ptr<ParsedAST> ForCleanup = std::move(LRU.back().second);
-    LRU.pop_back();
-    // Run the expensive destructor outside the lock.
+    LRU.insert(LRU.begin(), {K, std::move(V), Bytes});
+    UsedBytes += Bytes;
+    // The most recently used AST is kept even if it's over the byte budget on
+    // its own, so that the requests for its file don't need to rebuild it.
+    std::vector<std::unique_ptr<ParsedAST>> ForCleanup;
+    while (LRU.size() > MaxRetainedASTs ||
+           (LRU.size() > 1 && MaxRetainedBytes &&
+            UsedBytes > MaxRetainedBytes)) {
+      // We're past the limit, remove the last element.
+      UsedBytes -= LRU.back().Bytes;
+      ForCleanup.push_back(std::move(LRU.back().AST));
+      LRU.pop_back();
+    }
+    // Run the expensive destructors outside the lock.
     Lock.unlock();
-    ForCleanup.reset();
+    ForCleanup.clear();
   }
 
   /// Returns the cached value for \p K, or std::nullopt if the value is not in
@@ -197,7 +209,8 @@ public:
     }
     if (AccessMetric)
       AccessMetric->record(1, "hit");
-    std::unique_ptr<ParsedAST> V = std::move(Existing->second);
+    std::unique_ptr<ParsedAST> V = std::move(Existing->AST);
+    UsedBytes -= Existing->Bytes;
     LRU.erase(Existing);
     // GCC 4.8 fails to compile `return V;`, as it tries to call the copy
     // constructor of unique_ptr, so we call the move ctor explicitly to avoid
@@ -206,17 +219,25 @@ public:
   }
 
 private:
-  using KVPair = std::pair<Key, std::unique_ptr<ParsedAST>>;
+  struct Entry {
+    Key K;
+    std::unique_ptr<ParsedAST> AST;
+    /// The result of getUsedBytes() for AST, computed once when it's cached.
+    std::size_t Bytes;
+  };
 
-  std::vector<KVPair>::iterator findByKey(Key K) {
-    return llvm::find_if(LRU, [K](const KVPair &P) { return P.first == K; });
+  std::vector<Entry>::iterator findByKey(Key K) {
+    return llvm::find_if(LRU, [K](const Entry &E) { return E.K == K; });
   }
 
   std::mutex Mut;
   unsigned MaxRetainedASTs;
+  std::size_t MaxRetainedBytes;
   /// Items sorted in LRU order, i.e. first item is the most recently accessed
   /// one.
-  std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
+  std::vector<Entry> LRU; /* GUARDED_BY(Mut) */
+  /// The sum of the sizes of the ASTs in LRU.
+  std::size_t UsedBytes = 0; /* GUARDED_BY(Mut) */
 };
 
 /// A map from header files to an opened "proxy" file that includes them.
@@ -1636,7 +1657,7 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
                           : std::make_unique<ParsingCallbacks>()),
       Barrier(Opts.AsyncThreadsCount), QuickRunBarrier(Opts.AsyncThreadsCount),
       IdleASTs(
-          std::make_unique<ASTCache>(Opts.RetentionPolicy.MaxRetainedASTs)),
+          std::make_unique<ASTCache>(Opts.RetentionPolicy)),
       HeaderIncluders(std::make_unique<HeaderIncluderCache>()) {
   // Avoid null checks everywhere.
   if (!Opts.ContextProvider) {
@@ -64,6 +64,10 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// If not zero, the least recently used idle ASTs are also evicted while
+  /// the total of their getUsedBytes() exceeds this. The most recently used
+  /// AST is retained even if it exceeds this on its own.
+  size_t MaxRetainedBytes = 0;
 };
 
 /// Clangd may wait after an update to see if another one comes along.
@@ -77,17 +77,6 @@ llvm::SmallString<128> getAbsolutePath(const tooling::CompileCommand &Cmd) {
   return AbsolutePath;
 }
 
-bool shardIsStale(const LoadedShard &LS, llvm::vfs::FileSystem *FS) {
-  auto Buf = FS->getBufferForFile(LS.AbsolutePath);
-  if (!Buf) {
-    vlog("Background-index: Couldn't read {0} to validate stored index: {1}",
-         LS.AbsolutePath, Buf.getError().message());
-    // There is no point in indexing an unreadable file.
-    return false;
-  }
-  return digest(Buf->get()->getBuffer()) != LS.Digest;
-}
-
 } // namespace
 
 BackgroundIndex::BackgroundIndex(
@@ -366,8 +355,9 @@ BackgroundIndex::loadProject(std::vector<std::string> MainFiles) {
     });
   Rebuilder.startLoading();
   // Load shards for all of the mainfiles.
+  auto FS = TFS.view(/*CWD=*/std::nullopt);
   const std::vector<LoadedShard> Result =
-      loadIndexShards(MainFiles, IndexStorageFactory, CDB);
+      loadIndexShards(MainFiles, IndexStorageFactory, CDB, *FS);
   size_t LoadedShards = 0;
   {
     // Update in-memory state.
@@ -399,12 +389,11 @@ BackgroundIndex::loadProject(std::vector<std::string> MainFiles) {
   Rebuilder.loadedShard(LoadedShards);
   Rebuilder.doneLoading();
 
-  auto FS = TFS.view(/*CWD=*/std::nullopt);
   llvm::DenseSet<PathRef> TUsToIndex;
   // We'll accept data from stale shards, but ensure the files get reindexed
   // soon.
   for (auto &LS : Result) {
-    if (!shardIsStale(LS, FS.get()))
+    if (!LS.Stale)
       continue;
     PathRef TUForFile = LS.DependentTU;
     assert(!TUForFile.empty() && "File without a TU!");
@@ -52,6 +52,15 @@ public:
   virtual std::unique_ptr<IndexFileIn>
   loadShard(llvm::StringRef ShardIdentifier) const = 0;
 
+  // Tries to load the shard that was stored for the given identifier when its
+  // source file had the contents with \p Digest, e.g. before a switch to
+  // another branch. Storages don't need to keep such older versions.
+  virtual std::unique_ptr<IndexFileIn>
+  loadShardVersion(llvm::StringRef ShardIdentifier,
+                   const FileDigest &Digest) const {
+    return nullptr;
+  }
+
   // The factory provides storage for each File.
   // It keeps ownership of the storage instances, and should manage caching
   // itself. Factory must be threadsafe and never returns nullptr.
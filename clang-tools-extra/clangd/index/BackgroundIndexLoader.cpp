@@ -25,8 +25,9 @@ namespace {
 /// inverse dependency mapping.
 class BackgroundIndexLoader {
 public:
-  BackgroundIndexLoader(BackgroundIndexStorage::Factory &IndexStorageFactory)
-      : IndexStorageFactory(IndexStorageFactory) {}
+  BackgroundIndexLoader(BackgroundIndexStorage::Factory &IndexStorageFactory,
+                        llvm::vfs::FileSystem &FS)
+      : IndexStorageFactory(IndexStorageFactory), FS(FS) {}
   /// Load the shards for \p MainFile and all of its dependencies.
   void load(PathRef MainFile);
 
@@ -44,8 +45,35 @@ private:
   llvm::StringMap<LoadedShard> LoadedShards;
 
   BackgroundIndexStorage::Factory &IndexStorageFactory;
+  llvm::vfs::FileSystem &FS;
 };
 
+/// Fills in the metadata of \p LS from its shard, and returns the
+/// dependencies of the shard.
+std::vector<Path> readShardMetadata(LoadedShard &LS) {
+  std::vector<Path> Edges;
+  for (const auto &It : *LS.Shard->Sources) {
+    auto AbsPath = URI::resolve(It.getKey(), LS.AbsolutePath);
+    if (!AbsPath) {
+      elog("Failed to resolve URI: {0}", AbsPath.takeError());
+      continue;
+    }
+    // A shard contains only edges for non main-file sources.
+    if (*AbsPath != LS.AbsolutePath) {
+      Edges.push_back(*AbsPath);
+      continue;
+    }
+
+    // Fill in shard metadata.
+    const IncludeGraphNode &IGN = It.getValue();
+    LS.Digest = IGN.Digest;
+    LS.CountReferences = IGN.Flags & IncludeGraphNode::SourceFlag::IsTU;
+    LS.HadErrors = IGN.Flags & IncludeGraphNode::SourceFlag::HadErrors;
+  }
+  assert(LS.Digest != FileDigest{{0}} && "Digest is empty?");
+  return Edges;
+}
+
 std::pair<const LoadedShard &, std::vector<Path>>
 BackgroundIndexLoader::loadShard(PathRef StartSourceFile, PathRef DependentTU) {
   auto It = LoadedShards.try_emplace(StartSourceFile);
@@ -65,25 +93,28 @@ BackgroundIndexLoader::loadShard(PathRef StartSourceFile, PathRef DependentTU) {
   }
 
   LS.Shard = std::move(Shard);
-  for (const auto &It : *LS.Shard->Sources) {
-    auto AbsPath = URI::resolve(It.getKey(), StartSourceFile);
-    if (!AbsPath) {
-      elog("Failed to resolve URI: {0}", AbsPath.takeError());
-      continue;
-    }
-    // A shard contains only edges for non main-file sources.
-    if (*AbsPath != StartSourceFile) {
-      Edges.push_back(*AbsPath);
-      continue;
-    }
+  Edges = readShardMetadata(LS);
 
-    // Fill in shard metadata.
-    const IncludeGraphNode &IGN = It.getValue();
-    LS.Digest = IGN.Digest;
-    LS.CountReferences = IGN.Flags & IncludeGraphNode::SourceFlag::IsTU;
-    LS.HadErrors = IGN.Flags & IncludeGraphNode::SourceFlag::HadErrors;
+  auto Buf = FS.getBufferForFile(LS.AbsolutePath);
+  if (!Buf) {
+    vlog("Background-index: Couldn't read {0} to validate stored index: {1}",
+         LS.AbsolutePath, Buf.getError().message());
+    // There is no point in indexing an unreadable file.
+    return {LS, Edges};
   }
-  assert(LS.Digest != FileDigest{{0}} && "Digest is empty?");
+  FileDigest CurrentDigest = digest(Buf->get()->getBuffer());
+  if (CurrentDigest == LS.Digest)
+    return {LS, Edges};
+
+  // The file changed since it was indexed, but it may have had these contents
+  // before, e.g. when switching back to a branch.
+  auto Version = Storage->loadShardVersion(StartSourceFile, CurrentDigest);
+  if (Version && Version->Sources) {
+    vlog("Reusing the shard of an earlier version of {0}", StartSourceFile);
+    LS.Shard = std::move(Version);
+    Edges = readShardMetadata(LS);
+  }
+  LS.Stale = LS.Digest != CurrentDigest;
   return {LS, Edges};
 }
 
@@ -119,8 +150,9 @@ std::vector<LoadedShard> BackgroundIndexLoader::takeResult() && {
 std::vector<LoadedShard>
 loadIndexShards(llvm::ArrayRef<Path> MainFiles,
                 BackgroundIndexStorage::Factory &IndexStorageFactory,
-                const GlobalCompilationDatabase &CDB) {
-  BackgroundIndexLoader Loader(IndexStorageFactory);
+                const GlobalCompilationDatabase &CDB,
+                llvm::vfs::FileSystem &FS) {
+  BackgroundIndexLoader Loader(IndexStorageFactory, FS);
   for (llvm::StringRef MainFile : MainFiles) {
     assert(llvm::sys::path::is_absolute(MainFile));
     Loader.load(MainFile);
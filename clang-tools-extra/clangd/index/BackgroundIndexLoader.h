@@ -12,6 +12,7 @@
 #include "index/Background.h"
 #include "support/Path.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/VirtualFileSystem.h"
 #include <memory>
 #include <vector>
 
@@ -30,6 +31,8 @@ struct LoadedShard {
   bool CountReferences = false;
   /// Whether the indexing action producing that shard had errors.
   bool HadErrors = false;
+  /// Whether the source file has changed since the shard was produced.
+  bool Stale = false;
   /// Path to a TU that is depending on this shard.
   Path DependentTU;
   /// Will be nullptr when index storage couldn't provide a valid shard for
@@ -37,11 +40,14 @@ struct LoadedShard {
   std::unique_ptr<IndexFileIn> Shard;
 };
 
-/// Loads all shards for the TU \p MainFile from \p Storage.
+/// Loads all shards for the TU \p MainFile from \p Storage. The shards are
+/// validated against the source files read from \p FS, and the stored
+/// versions matching the current contents are preferred.
 std::vector<LoadedShard>
 loadIndexShards(llvm::ArrayRef<Path> MainFiles,
                 BackgroundIndexStorage::Factory &IndexStorageFactory,
-                const GlobalCompilationDatabase &CDB);
+                const GlobalCompilationDatabase &CDB,
+                llvm::vfs::FileSystem &FS);
 
 } // namespace clangd
 } // namespace clang
@@ -7,9 +7,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "GlobalCompilationDatabase.h"
+#include "URI.h"
 #include "index/Background.h"
 #include "support/Logger.h"
 #include "support/Path.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
@@ -19,6 +21,8 @@
 #include "llvm/Support/raw_ostream.h"
 #include <functional>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace clang {
 namespace clangd {
@@ -33,6 +37,60 @@ std::string getShardPathFromFilePath(llvm::StringRef ShardRoot,
   return std::string(ShardRootSS);
 }
 
+// Older versions of the shards are kept as hard links to the shard files, in
+// one directory per source file, so that they can be listed cheaply.
+std::string getShardVersionsDir(llvm::StringRef ShardRoot,
+                                llvm::StringRef FilePath) {
+  llvm::SmallString<128> VersionsDir(ShardRoot);
+  llvm::sys::path::append(VersionsDir, "versions",
+                          llvm::sys::path::filename(FilePath) + "." +
+                              llvm::toHex(digest(FilePath)));
+  return std::string(VersionsDir);
+}
+
+std::string getShardVersionPath(llvm::StringRef VersionsDir,
+                                const FileDigest &Digest) {
+  llvm::SmallString<128> VersionPath(VersionsDir);
+  llvm::sys::path::append(VersionPath, llvm::toHex(Digest) + ".idx");
+  return std::string(VersionPath);
+}
+
+// The number of versions kept for every source file. The least recently
+// stored ones are dropped first.
+constexpr size_t MaxShardVersions = 8;
+
+// Returns the digest of the contents of \p FilePath that \p Shard was
+// built from, if it's known.
+std::optional<FileDigest> getShardDigest(llvm::StringRef FilePath,
+                                         const IndexFileOut &Shard) {
+  if (!Shard.Sources)
+    return std::nullopt;
+  for (const auto &It : *Shard.Sources) {
+    auto AbsPath = URI::resolve(It.getKey(), FilePath);
+    if (!AbsPath) {
+      llvm::consumeError(AbsPath.takeError());
+      continue;
+    }
+    if (*AbsPath == FilePath)
+      return It.getValue().Digest;
+  }
+  return std::nullopt;
+}
+
+std::unique_ptr<IndexFileIn> readShard(llvm::StringRef ShardPath,
+                                       llvm::StringRef ShardIdentifier) {
+  auto Buffer = llvm::MemoryBuffer::getFile(ShardPath);
+  if (!Buffer)
+    return nullptr;
+  if (auto I =
+          readIndexFile(Buffer->get()->getBuffer(), SymbolOrigin::Background))
+    return std::make_unique<IndexFileIn>(std::move(*I));
+  else
+    elog("Error while reading shard {0}: {1}", ShardIdentifier,
+         I.takeError());
+  return nullptr;
+}
+
 // Uses disk as a storage for index shards.
 class DiskBackedIndexStorage : public BackgroundIndexStorage {
   std::string DiskShardRoot;
@@ -50,27 +108,69 @@ public:
 
   std::unique_ptr<IndexFileIn>
   loadShard(llvm::StringRef ShardIdentifier) const override {
-    const std::string ShardPath =
-        getShardPathFromFilePath(DiskShardRoot, ShardIdentifier);
-    auto Buffer = llvm::MemoryBuffer::getFile(ShardPath);
-    if (!Buffer)
-      return nullptr;
-    if (auto I =
-            readIndexFile(Buffer->get()->getBuffer(), SymbolOrigin::Background))
-      return std::make_unique<IndexFileIn>(std::move(*I));
-    else
-      elog("Error while reading shard {0}: {1}", ShardIdentifier,
-           I.takeError());
-    return nullptr;
+    return readShard(getShardPathFromFilePath(DiskShardRoot, ShardIdentifier),
+                     ShardIdentifier);
+  }
+
+  std::unique_ptr<IndexFileIn>
+  loadShardVersion(llvm::StringRef ShardIdentifier,
+                   const FileDigest &Digest) const override {
+    return readShard(
+        getShardVersionPath(
+            getShardVersionsDir(DiskShardRoot, ShardIdentifier), Digest),
+        ShardIdentifier);
   }
 
   llvm::Error storeShard(llvm::StringRef ShardIdentifier,
                          IndexFileOut Shard) const override {
     auto ShardPath = getShardPathFromFilePath(DiskShardRoot, ShardIdentifier);
-    return llvm::writeToOutput(ShardPath, [&Shard](llvm::raw_ostream &OS) {
-      OS << Shard;
-      return llvm::Error::success();
-    });
+    if (auto Err =
+            llvm::writeToOutput(ShardPath, [&Shard](llvm::raw_ostream &OS) {
+              OS << Shard;
+              return llvm::Error::success();
+            }))
+      return Err;
+    if (auto Digest = getShardDigest(ShardIdentifier, Shard))
+      storeShardVersion(ShardIdentifier, ShardPath, *Digest);
+    return llvm::Error::success();
+  }
+
+private:
+  // Keeps the shard at \p ShardPath as the version for \p Digest. Shards are
+  // replaced rather than overwritten, so the link keeps this version alive
+  // after the shard for the file gets stored again.
+  void storeShardVersion(llvm::StringRef ShardIdentifier,
+                         llvm::StringRef ShardPath,
+                         const FileDigest &Digest) const {
+    std::string VersionsDir =
+        getShardVersionsDir(DiskShardRoot, ShardIdentifier);
+    if (std::error_code EC = llvm::sys::fs::create_directories(VersionsDir)) {
+      vlog("Failed to create directory {0} for shard versions: {1}",
+           VersionsDir, EC.message());
+      return;
+    }
+    std::string VersionPath = getShardVersionPath(VersionsDir, Digest);
+    llvm::sys::fs::remove(VersionPath);
+    if (std::error_code EC =
+            llvm::sys::fs::create_hard_link(ShardPath, VersionPath)) {
+      vlog("Failed to keep shard version for {0}: {1}", ShardIdentifier,
+           EC.message());
+      return;
+    }
+
+    std::vector<std::pair<llvm::sys::TimePoint<>, std::string>> Versions;
+    std::error_code EC;
+    for (llvm::sys::fs::directory_iterator It(VersionsDir, EC), End;
+         It != End && !EC; It.increment(EC)) {
+      llvm::sys::fs::file_status Status;
+      if (!llvm::sys::fs::status(It->path(), Status))
+        Versions.emplace_back(Status.getLastModificationTime(), It->path());
+    }
+    if (Versions.size() <= MaxShardVersions)
+      return;
+    llvm::sort(Versions);
+    for (size_t I = 0, E = Versions.size() - MaxShardVersions; I < E; ++I)
+      llvm::sys::fs::remove(Versions[I].second);
   }
 };
 
@@ -98,12 +98,25 @@ private:
   }
 
   /// Advances CurrentChunk to the chunk which might contain ID.
+  ///
+  /// Within an intersection, the targets are usually close to the cursor, so
+  /// the chunks are probed at exponentially growing distances first, and the
+  /// binary search is only applied to the range found this way. This keeps
+  /// the cost logarithmic in the distance skipped rather than in the size of
+  /// the remaining list.
   void advanceToChunk(DocID ID) {
     if ((CurrentChunk != Chunks.end() - 1) &&
         ((CurrentChunk + 1)->Head <= ID)) {
-      CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
+      auto Low = CurrentChunk + 1;
+      size_t Step = 1;
+      while (static_cast<size_t>(Chunks.end() - Low) > Step &&
+             Low[Step].Head <= ID) {
+        Low += Step;
+        Step *= 2;
+      }
+      auto High = Low + std::min<size_t>(Step, Chunks.end() - Low);
+      CurrentChunk = std::partition_point(
+          Low, High, [&](const Chunk &C) { return C.Head <= ID; });
       --CurrentChunk;
       DecompressedChunk = CurrentChunk->decompress();
       CurrentID = DecompressedChunk.begin();
@@ -14,14 +14,21 @@
 #include "index/Index.h"
 #include "marshalling/Marshalling.h"
 #include "support/Logger.h"
+#include "support/Threading.h"
 #include "support/Trace.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
 
 #include <atomic>
 #include <chrono>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 namespace clang {
 namespace clangd {
@@ -58,18 +65,30 @@ class IndexClient : public clangd::SymbolIndex {
       remote::v1::SymbolIndex::Stub::*)(grpc::ClientContext *,
                                         const RequestT &);
 
-  template <typename RequestT, typename ReplyT, typename ClangdRequestT,
-            typename CallbackT>
-  bool streamRPC(ClangdRequestT Request,
-                 StreamingCall<RequestT, ReplyT> RPCCall,
-                 CallbackT Callback) const {
+  /// The replies to a request. Identical requests that are sent while this
+  /// one is in flight wait for it and replay its results.
+  struct CachedReply {
+    /// The serialized stream results, in order.
+    std::vector<std::string> Results;
+    size_t Bytes = 0;
+    bool HasMore = true;
+    /// Whether the call succeeded and all the results are recorded.
+    bool Complete = false;
+    std::chrono::steady_clock::time_point Time;
+    /// Notified when the call finished.
+    Notification Done;
+  };
+
+  template <typename RequestT, typename ReplyT, typename CallbackT>
+  bool callRPC(const RequestT &RPCRequest,
+               StreamingCall<RequestT, ReplyT> RPCCall, CallbackT Callback,
+               CachedReply *Record, std::string &IndexVersion) const {
     updateConnectionStatus();
     // We initialize to true because stream might be broken before we see the
     // final message. In such a case there are actually more results on the
     // stream, but we couldn't get to them.
     bool HasMore = true;
     trace::Span Tracer(RequestT::descriptor()->name());
-    const auto RPCRequest = ProtobufMarshaller->toProtobuf(Request);
     SPAN_ATTACH(Tracer, "Request", RPCRequest.DebugString());
     grpc::ClientContext Context;
     Context.AddMetadata("version", versionString());
@@ -85,11 +104,23 @@ class IndexClient : public clangd::SymbolIndex {
     ReplyT Reply;
     unsigned Successful = 0;
     unsigned FailedToParse = 0;
+    bool Recorded = Record != nullptr;
     while (Reader->Read(&Reply)) {
       if (!Reply.has_stream_result()) {
         HasMore = Reply.final_result().has_more();
         continue;
       }
+      if (Recorded) {
+        std::string Result = Reply.stream_result().SerializeAsString();
+        // Replies that are too large aren't worth keeping.
+        if (Record->Bytes + Result.size() > MaxCachedReplyBytes) {
+          Record->Results.clear();
+          Recorded = false;
+        } else {
+          Record->Bytes += Result.size();
+          Record->Results.push_back(std::move(Result));
+        }
+      }
       auto Response = ProtobufMarshaller->fromProtobuf(Reply.stream_result());
       if (!Response) {
         elog("Received invalid {0}: {1}. Reason: {2}",
@@ -106,10 +137,120 @@ class IndexClient : public clangd::SymbolIndex {
                       .count();
     vlog("Remote index [{0}]: {1} => {2} results in {3}ms.", ServerAddress,
          RequestT::descriptor()->name(), Successful, Millis);
-    SPAN_ATTACH(Tracer, "Status", Reader->Finish().ok());
+    bool Ok = Reader->Finish().ok();
+    SPAN_ATTACH(Tracer, "Status", Ok);
     SPAN_ATTACH(Tracer, "Successful", Successful);
     SPAN_ATTACH(Tracer, "Failed to parse", FailedToParse);
     updateConnectionStatus();
+
+    // Servers that don't report the version of their index aren't cached.
+    const auto &Metadata = Context.GetServerInitialMetadata();
+    auto Version = Metadata.find("index-version");
+    if (Version != Metadata.end())
+      IndexVersion.assign(Version->second.data(), Version->second.size());
+    if (Record) {
+      Record->HasMore = HasMore;
+      Record->Complete = Ok && Recorded && !IndexVersion.empty();
+    }
+    return HasMore;
+  }
+
+  /// Pass the results recorded in \p Reply to \p Callback.
+  template <typename ReplyT, typename CallbackT>
+  bool replay(const CachedReply &Reply, CallbackT Callback) const {
+    using StreamResultT = std::decay_t<decltype(ReplyT().stream_result())>;
+    for (const std::string &Result : Reply.Results) {
+      StreamResultT Message;
+      if (!Message.ParseFromString(Result))
+        continue;
+      auto Response = ProtobufMarshaller->fromProtobuf(Message);
+      if (!Response) {
+        llvm::consumeError(Response.takeError());
+        continue;
+      }
+      Callback(*Response);
+    }
+    return Reply.HasMore;
+  }
+
+  template <typename RequestT, typename ReplyT, typename ClangdRequestT,
+            typename CallbackT>
+  bool streamRPC(ClangdRequestT Request,
+                 StreamingCall<RequestT, ReplyT> RPCCall,
+                 CallbackT Callback) const {
+    const auto RPCRequest = ProtobufMarshaller->toProtobuf(Request);
+    std::string Key(RequestT::descriptor()->name());
+    Key += '\0';
+    Key += RPCRequest.SerializeAsString();
+
+    std::shared_ptr<CachedReply> Reply;
+    bool Cached = false;
+    bool InFlight = false;
+    {
+      std::lock_guard<std::mutex> Lock(CacheMutex);
+      auto It = CacheIndex.find(Key);
+      if (It != CacheIndex.end()) {
+        if (std::chrono::steady_clock::now() - It->second->second->Time <
+            CachedReplyLifetime) {
+          // Move the entry to the front, as the most recently used.
+          Cache.splice(Cache.begin(), Cache, It->second);
+          Reply = It->second->second;
+          Cached = true;
+        } else {
+          CacheBytes -= It->second->second->Bytes;
+          Cache.erase(It->second);
+          CacheIndex.erase(It);
+        }
+      }
+      if (!Reply) {
+        auto [Pending, Inserted] = InFlightReplies.try_emplace(Key);
+        if (Inserted)
+          Pending->second = std::make_shared<CachedReply>();
+        else
+          InFlight = true;
+        Reply = Pending->second;
+      }
+    }
+
+    if (Cached)
+      return replay<ReplyT>(*Reply, Callback);
+    if (InFlight) {
+      Reply->Done.wait();
+      if (Reply->Complete)
+        return replay<ReplyT>(*Reply, Callback);
+      // The identical request failed or its results weren't kept, so send our
+      // own.
+      std::string IndexVersion;
+      return callRPC(RPCRequest, RPCCall, Callback, /*Record=*/nullptr,
+                     IndexVersion);
+    }
+
+    std::string IndexVersion;
+    bool HasMore =
+        callRPC(RPCRequest, RPCCall, Callback, Reply.get(), IndexVersion);
+    {
+      std::lock_guard<std::mutex> Lock(CacheMutex);
+      InFlightReplies.erase(Key);
+      if (Reply->Complete) {
+        // Replies from an older index are stale.
+        if (IndexVersion != CachedIndexVersion) {
+          Cache.clear();
+          CacheIndex.clear();
+          CacheBytes = 0;
+          CachedIndexVersion = IndexVersion;
+        }
+        Reply->Time = std::chrono::steady_clock::now();
+        Cache.emplace_front(Key, Reply);
+        CacheIndex[Key] = Cache.begin();
+        CacheBytes += Reply->Bytes;
+        while (CacheBytes > MaxCacheBytes) {
+          CacheBytes -= Cache.back().second->Bytes;
+          CacheIndex.erase(Cache.back().first);
+          Cache.pop_back();
+        }
+      }
+    }
+    Reply->Done.notify();
     return HasMore;
   }
 
@@ -185,6 +326,21 @@ private:
   std::unique_ptr<Marshaller> ProtobufMarshaller;
   // Each request will be terminated if it takes too long.
   std::chrono::milliseconds DeadlineWaitingTime;
+
+  // Recent replies, keyed by the serialized request, most recently used
+  // first. They're dropped when the server reports a new index version, and
+  // expire after a while in case no request reaches the server.
+  static constexpr size_t MaxCacheBytes = 32 * 1024 * 1024;
+  static constexpr size_t MaxCachedReplyBytes = 4 * 1024 * 1024;
+  static constexpr std::chrono::minutes CachedReplyLifetime{5};
+  mutable std::mutex CacheMutex;
+  mutable std::list<std::pair<std::string, std::shared_ptr<CachedReply>>>
+      Cache;
+  mutable llvm::StringMap<decltype(Cache)::iterator> CacheIndex;
+  mutable size_t CacheBytes = 0;
+  mutable std::string CachedIndexVersion;
+  // The requests being sent, which identical requests wait for.
+  mutable llvm::StringMap<std::shared_ptr<CachedReply>> InFlightReplies;
 };
 
 } // namespace
@@ -32,6 +32,7 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/VirtualFileSystem.h"
 
+#include <atomic>
 #include <chrono>
 #include <grpc++/grpc++.h>
 #include <grpc++/health_check_service_interface.h>
@@ -113,6 +114,16 @@ llvm::cl::opt<size_t> LimitResults(
 
 static Key<grpc::ServerContext *> CurrentRequest;
 
+// Identifies the index being served, so that clients can tell when the replies
+// they cached become stale. This is the modification time of the index file.
+static std::atomic<int64_t> IndexVersion;
+
+void setIndexVersion(llvm::sys::TimePoint<> ModificationTime) {
+  IndexVersion = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     ModificationTime.time_since_epoch())
+                     .count();
+}
+
 class RemoteIndexServer final : public v1::SymbolIndex::Service {
 public:
   RemoteIndexServer(clangd::SymbolIndex &Index, llvm::StringRef IndexRoot)
@@ -132,6 +143,7 @@ private:
                       grpc::ServerWriter<LookupReply> *Reply) override {
     auto StartTime = stopwatch::now();
     WithContextValue WithRequestContext(CurrentRequest, Context);
+    Context->AddInitialMetadata("index-version", std::to_string(IndexVersion));
     logRequest(*Request);
     trace::Span Tracer("LookupRequest");
     auto Req = ProtobufMarshaller->fromProtobuf(Request);
@@ -177,6 +189,7 @@ private:
                          grpc::ServerWriter<FuzzyFindReply> *Reply) override {
     auto StartTime = stopwatch::now();
     WithContextValue WithRequestContext(CurrentRequest, Context);
+    Context->AddInitialMetadata("index-version", std::to_string(IndexVersion));
     logRequest(*Request);
     trace::Span Tracer("FuzzyFindRequest");
     auto Req = ProtobufMarshaller->fromProtobuf(Request);
@@ -220,6 +233,7 @@ private:
                     grpc::ServerWriter<RefsReply> *Reply) override {
     auto StartTime = stopwatch::now();
     WithContextValue WithRequestContext(CurrentRequest, Context);
+    Context->AddInitialMetadata("index-version", std::to_string(IndexVersion));
     logRequest(*Request);
     trace::Span Tracer("RefsRequest");
     auto Req = ProtobufMarshaller->fromProtobuf(Request);
@@ -264,6 +278,7 @@ private:
                 grpc::ServerWriter<ContainedRefsReply> *Reply) override {
     auto StartTime = stopwatch::now();
     WithContextValue WithRequestContext(CurrentRequest, Context);
+    Context->AddInitialMetadata("index-version", std::to_string(IndexVersion));
     logRequest(*Request);
     trace::Span Tracer("ContainedRefsRequest");
     auto Req = ProtobufMarshaller->fromProtobuf(Request);
@@ -310,6 +325,7 @@ private:
                          grpc::ServerWriter<RelationsReply> *Reply) override {
     auto StartTime = stopwatch::now();
     WithContextValue WithRequestContext(CurrentRequest, Context);
+    Context->AddInitialMetadata("index-version", std::to_string(IndexVersion));
     logRequest(*Request);
     trace::Span Tracer("RelationsRequest");
     auto Req = ProtobufMarshaller->fromProtobuf(Request);
@@ -450,6 +466,7 @@ void hotReload(clangd::SwapIndex &Index, llvm::StringRef IndexPath,
     return;
   }
   Index.reset(std::move(NewIndex));
+  setIndexVersion(Status->getLastModificationTime());
   Monitor.updateIndex(Status->getLastModificationTime());
   log("New index version loaded. Last modification time: {0}, size: {1} bytes.",
       Status->getLastModificationTime(), Status->getSize());
@@ -589,6 +606,7 @@ int main(int argc, char *argv[]) {
   }
   clang::clangd::SwapIndex Index(std::move(SymIndex));
 
+  setIndexVersion(Status->getLastModificationTime());
   Monitor Monitor(Status->getLastModificationTime());
 
   std::thread HotReloadThread([&Index, &Status, &FS, &Monitor]() {
@@ -19,11 +19,16 @@
 #include "index/Symbol.h"
 #include "index/SymbolCollector.h"
 #include "support/Logger.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Tooling/ArgumentsAdjusters.h"
 #include "clang/Tooling/Execution.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/xxhash.h"
+#include <string>
 #include <utility>
 
 namespace clang {
@@ -48,6 +53,40 @@ static llvm::cl::list<std::string> QueryDriverGlobs{
     llvm::cl::CommaSeparated,
 };
 
+enum class HeaderDedupKind { Path, Configuration };
+
+static llvm::cl::opt<HeaderDedupKind> HeaderDedup(
+    "header-dedup",
+    llvm::cl::desc("When to index a header that was already indexed"),
+    llvm::cl::values(
+        clEnumValN(HeaderDedupKind::Path, "path",
+                   "index every header once, in the first translation unit"),
+        clEnumValN(HeaderDedupKind::Configuration, "configuration",
+                   "index every header once per target, language standard, "
+                   "predefined macros and forced includes of the translation "
+                   "units, so that code under other macro conditions is "
+                   "indexed")),
+    llvm::cl::init(HeaderDedupKind::Path));
+
+/// Returns a key identifying the configuration of \p CI that affects how a
+/// header is preprocessed.
+static std::string getConfigurationKey(const CompilerInvocation &CI) {
+  std::string Config = CI.getTargetOpts().Triple;
+  Config += '\0';
+  Config += std::to_string(static_cast<unsigned>(CI.getLangOpts().LangStd));
+  for (const auto &[Macro, IsUndef] : CI.getPreprocessorOpts().Macros) {
+    Config += '\0';
+    Config += IsUndef ? 'U' : 'D';
+    Config += Macro;
+  }
+  for (const std::string &Include : CI.getPreprocessorOpts().Includes) {
+    Config += '\0';
+    Config += 'I';
+    Config += Include;
+  }
+  return llvm::utohexstr(llvm::xxh3_64bits(Config));
+}
+
 class IndexActionFactory : public tooling::FrontendActionFactory {
 public:
   IndexActionFactory(IndexFileIn &Result) : Result(Result) {}
@@ -55,13 +94,18 @@ public:
   std::unique_ptr<FrontendAction> create() override {
     SymbolCollector::Options Opts;
     Opts.CountReferences = true;
-    Opts.FileFilter = [&](const SourceManager &SM, FileID FID) {
+    Opts.FileFilter = [&, Config = CurrentConfiguration](
+                          const SourceManager &SM, FileID FID) {
       const auto F = SM.getFileEntryRefForID(FID);
       if (!F)
         return false; // Skip invalid files.
       auto AbsPath = getCanonicalPath(*F, SM.getFileManager());
       if (!AbsPath)
         return false; // Skip files without absolute path.
+      if (!Config.empty()) {
+        AbsPath->push_back('\0');
+        *AbsPath += Config;
+      }
       std::lock_guard<std::mutex> Lock(FilesMu);
       return Files.insert(*AbsPath).second; // Skip already processed files.
     };
@@ -99,6 +143,12 @@ public:
                      std::shared_ptr<PCHContainerOperations> PCHContainerOps,
                      DiagnosticConsumer *DiagConsumer) override {
     disableUnsupportedOptions(*Invocation);
+    // The base class moves the invocation into the compiler instance before
+    // it calls create() on this thread, so the configuration is passed on
+    // through CurrentConfiguration.
+    CurrentConfiguration = HeaderDedup == HeaderDedupKind::Configuration
+                               ? getConfigurationKey(*Invocation)
+                               : std::string();
     return tooling::FrontendActionFactory::runInvocation(
         std::move(Invocation), Files, std::move(PCHContainerOps), DiagConsumer);
   }
@@ -112,6 +162,10 @@ public:
   }
 
 private:
+  /// The configuration key of the translation unit being indexed on this
+  /// thread, if headers are indexed once per configuration.
+  static thread_local std::string CurrentConfiguration;
+
   IndexFileIn &Result;
   std::mutex FilesMu;
   llvm::StringSet<> Files;
@@ -123,6 +177,8 @@ private:
   RelationSlab::Builder Relations;
 };
 
+thread_local std::string IndexActionFactory::CurrentConfiguration;
+
 } // namespace
 } // namespace clangd
 } // namespace clang
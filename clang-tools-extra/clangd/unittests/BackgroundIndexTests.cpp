@@ -4,6 +4,7 @@
 #include "SyncAPI.h"
 #include "TestFS.h"
 #include "TestTU.h"
+#include "URI.h"
 #include "index/Background.h"
 #include "index/BackgroundRebuild.h"
 #include "index/MemIndex.h"
@@ -63,9 +64,32 @@ public:
     std::lock_guard<std::mutex> Lock(StorageMu);
     AccessedPaths.insert(ShardIdentifier);
     Storage[ShardIdentifier] = llvm::to_string(Shard);
+    ++StoredShards;
+    if (KeepVersions && Shard.Sources) {
+      auto It = Shard.Sources->find(URI::create(ShardIdentifier).toString());
+      if (It != Shard.Sources->end())
+        Versions[(ShardIdentifier + llvm::toHex(It->second.Digest)).str()] =
+            Storage[ShardIdentifier];
+    }
     return llvm::Error::success();
   }
   std::unique_ptr<IndexFileIn>
+  loadShardVersion(llvm::StringRef ShardIdentifier,
+                   const FileDigest &Digest) const override {
+    std::lock_guard<std::mutex> Lock(StorageMu);
+    auto It = Versions.find((ShardIdentifier + llvm::toHex(Digest)).str());
+    if (It == Versions.end())
+      return nullptr;
+    auto IndexFile = readIndexFile(It->second, SymbolOrigin::Background);
+    if (!IndexFile) {
+      ADD_FAILURE() << "Error while reading " << ShardIdentifier << ':'
+                    << IndexFile.takeError();
+      return nullptr;
+    }
+    ++VersionHits;
+    return std::make_unique<IndexFileIn>(std::move(*IndexFile));
+  }
+  std::unique_ptr<IndexFileIn>
   loadShard(llvm::StringRef ShardIdentifier) const override {
     std::lock_guard<std::mutex> Lock(StorageMu);
     AccessedPaths.insert(ShardIdentifier);
@@ -84,6 +108,10 @@ public:
   }
 
   mutable llvm::StringSet<> AccessedPaths;
+  bool KeepVersions = false;
+  mutable llvm::StringMap<std::string> Versions;
+  mutable size_t StoredShards = 0;
+  mutable size_t VersionHits = 0;
 };
 
 class BackgroundIndexTest : public ::testing::Test {
@@ -455,6 +483,46 @@ TEST_F(BackgroundIndexTest, ShardStorageLoad) {
               Contains(AllOf(named("f_b"), declared(), defined())));
 }
 
+TEST_F(BackgroundIndexTest, ShardStorageReusesVersions) {
+  MockFS FS;
+  std::string OldHeader = "void common();\n";
+  FS.Files[testPath("root/A.h")] = OldHeader;
+  FS.Files[testPath("root/A.cc")] =
+      "#include \"A.h\"\nvoid g() { (void)common; }";
+
+  llvm::StringMap<std::string> Storage;
+  size_t CacheHits = 0;
+  MemoryShardStorage MSS(Storage, CacheHits);
+  MSS.KeepVersions = true;
+
+  tooling::CompileCommand Cmd;
+  Cmd.Filename = testPath("root/A.cc");
+  Cmd.Directory = testPath("root");
+  Cmd.CommandLine = {"clang++", testPath("root/A.cc")};
+  auto RunIndex = [&] {
+    OverlayCDB CDB(/*Base=*/nullptr);
+    BackgroundIndex Idx(FS, CDB, [&](llvm::StringRef) { return &MSS; },
+                        /*Opts=*/{});
+    CDB.setCompileCommand(testPath("root/A.cc"), Cmd);
+    ASSERT_TRUE(Idx.blockUntilIdleForTest());
+  };
+  RunIndex();
+
+  // Switch to another version of the header, which needs to be indexed.
+  FS.Files[testPath("root/A.h")] = "void common();\nclass A_CCnew {};\n";
+  RunIndex();
+  EXPECT_EQ(MSS.VersionHits, 0U);
+  EXPECT_THAT(*MSS.loadShard(testPath("root/A.h"))->Symbols,
+              Contains(named("A_CCnew")));
+
+  // Switching back reuses the shard of the first version.
+  FS.Files[testPath("root/A.h")] = OldHeader;
+  size_t StoredShards = MSS.StoredShards;
+  RunIndex();
+  EXPECT_EQ(MSS.VersionHits, 1U);
+  EXPECT_EQ(MSS.StoredShards, StoredShards);
+}
+
 TEST_F(BackgroundIndexTest, ShardStorageEmptyFile) {
   MockFS FS;
   FS.Files[testPath("root/A.h")] = R"cpp(
@@ -65,6 +65,24 @@ TEST(DexIterators, DocumentIterator) {
   EXPECT_TRUE(DocIterator->reachedEnd());
 }
 
+TEST(DexIterators, DocumentIteratorManyChunks) {
+  // Gaps of 1000 take two bytes each, so the list spans many chunks.
+  std::vector<DocID> Docs;
+  for (DocID I = 0; I < 2000; ++I)
+    Docs.push_back(I * 1000);
+  const PostingList L(Docs);
+  auto DocIterator = L.iterator();
+
+  for (DocID Target : {0U, 1U, 14000U, 14001U, 15000U, 64999U, 1000000U,
+                       1000001U, 1999000U}) {
+    DocIterator->advanceTo(Target);
+    ASSERT_FALSE(DocIterator->reachedEnd());
+    EXPECT_EQ(DocIterator->peek(), (Target + 999) / 1000 * 1000);
+  }
+  DocIterator->advanceTo(1999001);
+  EXPECT_TRUE(DocIterator->reachedEnd());
+}
+
 TEST(DexIterators, AndTwoLists) {
   Corpus C{10000};
   const PostingList L0({0, 5, 7, 10, 42, 320, 9000});
@@ -252,6 +252,57 @@ export module N:Part;
   }
 }
 
+TEST_F(PrerequisiteModulesTests, DiamondDepTest) {
+  MockDirectoryCompilationDatabase CDB(TestDir, FS);
+
+  CDB.addFile("A.cppm", R"cpp(
+export module A;
+export int a() { return 1; }
+  )cpp");
+
+  CDB.addFile("B.cppm", R"cpp(
+export module B;
+import A;
+export int b() { return a(); }
+  )cpp");
+
+  CDB.addFile("C.cppm", R"cpp(
+export module C;
+import A;
+export int c() { return a(); }
+  )cpp");
+
+  CDB.addFile("D.cppm", R"cpp(
+export module D;
+export import B;
+export import C;
+  )cpp");
+
+  CDB.addFile("Use.cpp", R"cpp(
+import D;
+int use() { return b() + c(); }
+  )cpp");
+
+  ModulesBuilder Builder(CDB);
+
+  // B and C are built in the same round, after A and before D.
+  auto UseInfo =
+      Builder.buildPrerequisiteModulesFor(getFullPath("Use.cpp"), FS);
+  ASSERT_TRUE(UseInfo);
+
+  HeaderSearchOptions HSOpts;
+  UseInfo->adjustHeaderSearchOptions(HSOpts);
+  EXPECT_TRUE(HSOpts.PrebuiltModuleFiles.count("A"));
+  EXPECT_TRUE(HSOpts.PrebuiltModuleFiles.count("B"));
+  EXPECT_TRUE(HSOpts.PrebuiltModuleFiles.count("C"));
+  EXPECT_TRUE(HSOpts.PrebuiltModuleFiles.count("D"));
+
+  ParseInputs UseInput = getInputs("Use.cpp", CDB);
+  std::unique_ptr<CompilerInvocation> Invocation =
+      buildCompilerInvocation(UseInput, DiagConsumer);
+  EXPECT_TRUE(UseInfo->canReuse(*Invocation, FS.view(TestDir)));
+}
+
 TEST_F(PrerequisiteModulesTests, ReusabilityTest) {
   MockDirectoryCompilationDatabase CDB(TestDir, FS);
 
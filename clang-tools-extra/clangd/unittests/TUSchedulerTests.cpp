@@ -643,6 +643,26 @@ TEST_F(TUSchedulerTests, EvictedAST) {
               UnorderedElementsAre(Foo, AnyOf(Bar, Baz)));
 }
 
+TEST_F(TUSchedulerTests, EvictedASTByBytes) {
+  auto Opts = optsForTest();
+  Opts.AsyncThreadsCount = 1;
+  Opts.RetentionPolicy.MaxRetainedASTs = 10;
+  // Every AST is over the budget on its own.
+  Opts.RetentionPolicy.MaxRetainedBytes = 1;
+  TUScheduler S(CDB, Opts);
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  S.update(Foo, getInputs(Foo, "int x=1;"), WantDiagnostics::Yes);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(60)));
+  ASSERT_THAT(S.getFilesWithCachedAST(), ElementsAre(Foo));
+
+  // Only the most recently used AST is retained.
+  S.update(Bar, getInputs(Bar, "int x=2;"), WantDiagnostics::Yes);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(60)));
+  ASSERT_THAT(S.getFilesWithCachedAST(), ElementsAre(Bar));
+}
+
 // We send "empty" changes to TUScheduler when we think some external event
 // *might* have invalidated current state (e.g. a header was edited).
 // Verify that this doesn't evict our cache entries.
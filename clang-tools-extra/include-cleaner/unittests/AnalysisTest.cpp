@@ -167,6 +167,38 @@ TEST_F(WalkUsedTest, MultipleProviders) {
                     UnorderedElementsAre(HeaderFile1, HeaderFile2, MainFile))));
 }
 
+TEST_F(WalkUsedTest, RepeatedReferences) {
+  llvm::Annotations Code(R"cpp(
+  #include "header.h"
+  void bar() {
+    $foo1^foo();
+    $foo2^foo();
+    std::$vector1^vector *$v1^v1;
+    std::$vector2^vector *$v2^v2;
+  }
+  )cpp");
+  Inputs.Code = Code.code();
+  Inputs.ExtraFiles["header.h"] = guard(R"cpp(
+  void foo();
+  namespace std { class vector {}; }
+  )cpp");
+
+  TestAST AST(Inputs);
+  auto &SM = AST.sourceManager();
+  auto HeaderFile = Header(*AST.fileManager().getOptionalFileRef("header.h"));
+  auto MainFile = Header(*SM.getFileEntryRefForID(SM.getMainFileID()));
+  auto VectorSTL = Header(*tooling::stdlib::Header::named("<vector>"));
+  EXPECT_THAT(
+      offsetToProviders(AST),
+      UnorderedElementsAre(
+          Pair(Code.point("foo1"), UnorderedElementsAre(HeaderFile)),
+          Pair(Code.point("foo2"), UnorderedElementsAre(HeaderFile)),
+          Pair(Code.point("vector1"), UnorderedElementsAre(VectorSTL)),
+          Pair(Code.point("vector2"), UnorderedElementsAre(VectorSTL)),
+          Pair(Code.point("v1"), UnorderedElementsAre(MainFile)),
+          Pair(Code.point("v2"), UnorderedElementsAre(MainFile))));
+}
+
 TEST_F(WalkUsedTest, MacroRefs) {
   llvm::Annotations Code(R"cpp(
     #include "hdr.h"
@@ -352,6 +352,16 @@ public:
   virtual std::optional<clang::TraversalKind> TraversalKind() const {
     return std::nullopt;
   }
+
+  /// Returns true if the nodes this matcher matches must have one of a set of
+  /// names whenever their name is an identifier, and adds these names to
+  /// \p Names. Returns false if the matcher doesn't restrict the names.
+  ///
+  /// This allows a MatchFinder to skip the matcher on the named declarations
+  /// that it can't match.
+  virtual bool getIdentifierNames(std::vector<StringRef> &Names) const {
+    return false;
+  }
 };
 
 /// Generic interface for matchers on an AST node of type T.
@@ -535,6 +545,13 @@ public:
   ///
   /// Most matchers will not have a traversal kind set, instead relying on the
   /// surrounding context. For those, \c std::nullopt is returned.
+  /// Returns true if the nodes this matcher matches must have one of a set of
+  /// names whenever their name is an identifier, and adds these names to
+  /// \p Names.
+  bool getIdentifierNames(std::vector<StringRef> &Names) const {
+    return Implementation->getIdentifierNames(Names);
+  }
+
   std::optional<clang::TraversalKind> getTraversalKind() const {
     return Implementation->TraversalKind();
   }
@@ -945,6 +962,8 @@ class HasNameMatcher : public SingleNodeMatcherInterface<NamedDecl> {
 
   bool matchesNode(const NamedDecl &Node) const override;
 
+  bool getIdentifierNames(std::vector<StringRef> &Names) const override;
+
 private:
   /// Unqualified match routine.
   ///
@@ -21,7 +21,9 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include <memory>
 #include <optional>
 
 namespace clang {
@@ -99,6 +101,48 @@ parseCrossTUIndex(StringRef IndexPath);
 
 std::string createCrossTUIndexString(const llvm::StringMap<std::string> &Index);
 
+/// Returns the index \p Index in the binary format read by CrossTUBinaryIndex.
+std::string createCrossTUBinaryIndex(const llvm::StringMap<std::string> &Index);
+
+/// An index file in the binary format, which can be searched without being
+/// parsed, so that large indices are only paged in as they are used.
+///
+/// The format is the following, with little-endian 32-bit integers:
+/// - the magic "CTUI", the version, the number of entries and the number of
+///   paths;
+/// - the entries sorted by lookup name, each being the offset and the size of
+///   the lookup name and the index of the path;
+/// - the paths, each being an offset and a size;
+/// - the strings, to which the offsets refer.
+class CrossTUBinaryIndex {
+public:
+  /// Returns whether \p Contents is an index in the binary format.
+  static bool isBinaryIndex(StringRef Contents);
+
+  /// Checks the header and the tables of the index in \p Buffer, which was
+  /// read from \p IndexPath.
+  static llvm::Expected<CrossTUBinaryIndex>
+  create(std::unique_ptr<llvm::MemoryBuffer> Buffer, StringRef IndexPath);
+
+  /// Returns the path of the file which defines \p LookupName, if any.
+  std::optional<StringRef> lookup(StringRef LookupName) const;
+
+  /// Returns the number of entries.
+  unsigned size() const { return NumEntries; }
+
+private:
+  CrossTUBinaryIndex(std::unique_ptr<llvm::MemoryBuffer> Buffer,
+                     unsigned NumEntries, unsigned NumPaths)
+      : Buffer(std::move(Buffer)), NumEntries(NumEntries), NumPaths(NumPaths) {}
+
+  StringRef getString(unsigned Offset, unsigned Size) const;
+  StringRef getName(unsigned Entry) const;
+
+  std::unique_ptr<llvm::MemoryBuffer> Buffer;
+  unsigned NumEntries;
+  unsigned NumPaths;
+};
+
 using InvocationListTy = llvm::StringMap<llvm::SmallVector<std::string, 32>>;
 /// Parse the YAML formatted invocation list file content \p FileContent.
 /// The format is expected to be a mapping from absolute source file
@@ -335,6 +379,12 @@ private:
     using IndexMapTy = BaseMapTy<std::string>;
     IndexMapTy NameFileMap;
 
+    /// The index, if it's in the binary format. NameFileMap is unused then.
+    std::optional<CrossTUBinaryIndex> BinaryIndex;
+
+    /// Returns the path of the file which defines \p FunctionName, if any.
+    std::optional<StringRef> lookupFileForFunction(StringRef FunctionName);
+
     /// Loads the AST based on the identifier found in the index.
     ASTLoader Loader;
 
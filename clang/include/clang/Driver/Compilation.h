@@ -132,6 +132,21 @@ class Compilation {
   /// Whether to keep temporary files regardless of -save-temps.
   bool ForceKeepTempFiles = false;
 
+  /// The maximum number of jobs to run at the same time.
+  unsigned ParallelJobs = 1;
+
+  /// PrintCommand - Print the command if requested by -v or by
+  /// CC_PRINT_OPTIONS.
+  ///
+  /// \return Whether the command could be printed.
+  bool PrintCommand(const Command &C) const;
+
+  /// ExecuteJobsInParallel - Execute the jobs, running up to ParallelJobs of
+  /// the jobs whose inputs are ready at the same time.
+  void ExecuteJobsInParallel(
+      const JobList &Jobs,
+      SmallVectorImpl<std::pair<int, const Command *>> &FailingCommands) const;
+
 public:
   Compilation(const Driver &D, const ToolChain &DefaultToolChain,
               llvm::opt::InputArgList *Args,
@@ -236,6 +251,9 @@ public:
     PostCallback = CB;
   }
 
+  /// Set the maximum number of jobs ExecuteJobs() may run at the same time.
+  void setParallelJobs(unsigned N) { ParallelJobs = N; }
+
   /// Returns the sysroot path.
   StringRef getSysRoot() const;
 
@@ -315,6 +333,10 @@ public:
 
   /// ExecuteJob - Execute a single job.
   ///
+  /// The jobs are executed one after the other, unless setParallelJobs() was
+  /// given more than one job, in which case up to that many jobs whose inputs
+  /// are ready run at the same time, out of process.
+  ///
   /// \param FailingCommands - For non-zero results, this will be a vector of
   /// failing commands and their associated result code.
   /// \param LogOnly - When true, only tries to log the command, not actually
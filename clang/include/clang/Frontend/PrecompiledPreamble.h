@@ -20,6 +20,7 @@
 #include "llvm/Support/MD5.h"
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <system_error>
 #include <type_traits>
 
@@ -132,6 +133,29 @@ public:
                         IntrusiveRefCntPtr<llvm::vfs::FileSystem> &VFS,
                         llvm::MemoryBuffer *MainFileBuffer) const;
 
+  /// Publish this preamble into the store in the directory \p StorePath, so
+  /// that other processes can load it with LoadFromStore() instead of building
+  /// it again. \p Invocation must be the one the preamble was built with.
+  ///
+  /// The store is content-addressed: entries are keyed by the compiler
+  /// version, the options, the preamble bytes and the state of the files used
+  /// by the preamble. Entries are written to a temporary file and renamed, so
+  /// that other processes never see partial entries. The store isn't pruned.
+  std::error_code Publish(const CompilerInvocation &Invocation,
+                          StringRef StorePath) const;
+
+  /// Look up the store in the directory \p StorePath for a preamble built with
+  /// \p Invocation that CanReuse() accepts for the new contents of the main
+  /// file. The returned preamble is stored in memory.
+  ///
+  /// Only the PCH is stored, so clients which use information collected by
+  /// PreambleCallbacks while building the preamble need to keep it themselves.
+  static std::optional<PrecompiledPreamble>
+  LoadFromStore(const CompilerInvocation &Invocation,
+                const llvm::MemoryBufferRef &MainFileBuffer,
+                PreambleBounds Bounds, llvm::vfs::FileSystem &VFS,
+                StringRef StorePath);
+
 private:
   PrecompiledPreamble(std::unique_ptr<PCHStorage> Storage,
                       std::vector<char> PreambleBytes,
@@ -174,6 +198,12 @@ private:
                          IntrusiveRefCntPtr<llvm::vfs::FileSystem> &VFS,
                          llvm::MemoryBuffer *MainFileBuffer) const;
 
+  /// Returns the directory of the store in \p StorePath that holds the
+  /// entries for \p Invocation and \p PreambleBytes.
+  static void getStoreKeyDirectory(const CompilerInvocation &Invocation,
+                                   StringRef PreambleBytes, StringRef StorePath,
+                                   SmallVectorImpl<char> &KeyDir);
+
   /// Sets up the PreprocessorOptions and changes VFS, so that PCH stored in \p
   /// Storage is accessible to clang. This method is an implementation detail of
   /// AddImplicitPreamble.
@@ -81,6 +81,13 @@ private:
 class IncrementalAction;
 class InProcessPrintingASTConsumer;
 
+/// Configuration of the execution engine of the Interpreter.
+struct JITConfig {
+  /// Compile the functions of the incremental inputs the first time they are
+  /// called, instead of when the inputs are executed.
+  bool LazyCompile = false;
+};
+
 /// Provides top-level interfaces for incremental compilation and execution.
 class Interpreter {
   friend class Value;
@@ -112,11 +119,15 @@ class Interpreter {
   /// Compiler instance performing the incremental compilation.
   std::unique_ptr<CompilerInstance> CI;
 
+  /// Configuration of the execution engine.
+  JITConfig Config;
+
 protected:
   // Derived classes can use an extended interface of the Interpreter.
   Interpreter(std::unique_ptr<CompilerInstance> Instance, llvm::Error &Err,
               std::unique_ptr<llvm::orc::LLJITBuilder> JITBuilder = nullptr,
-              std::unique_ptr<clang::ASTConsumer> Consumer = nullptr);
+              std::unique_ptr<clang::ASTConsumer> Consumer = nullptr,
+              JITConfig Config = {});
 
   // Create the internal IncrementalExecutor, or re-create it after calling
   // ResetExecutor().
@@ -129,7 +140,7 @@ protected:
 public:
   virtual ~Interpreter();
   static llvm::Expected<std::unique_ptr<Interpreter>>
-  create(std::unique_ptr<CompilerInstance> CI);
+  create(std::unique_ptr<CompilerInstance> CI, JITConfig Config = {});
   static llvm::Expected<std::unique_ptr<Interpreter>>
   createWithCUDA(std::unique_ptr<CompilerInstance> CI,
                  std::unique_ptr<CompilerInstance> DCI);
@@ -18,6 +18,8 @@
 #include "llvm/Support/VirtualFileSystem.h"
 #include <mutex>
 #include <optional>
+#include <string>
+#include <vector>
 
 namespace clang {
 namespace tooling {
@@ -150,6 +152,10 @@ using CachedRealPath = llvm::ErrorOr<std::string>;
 ///
 /// It is sharded based on the hash of the key to reduce the lock contention for
 /// the worker threads.
+///
+/// The scanned directives can also be kept in a directory on disk, so that
+/// they're reused across runs. The entries are keyed by the hash of the file
+/// contents and the version of clang, so they never need to be invalidated.
 class DependencyScanningFilesystemSharedCache {
 public:
   struct CacheShard {
@@ -175,6 +181,12 @@ public:
     /// The backing storage for cached real paths.
     llvm::SpecificBumpPtrAllocator<CachedRealPath> RealPathStorage;
 
+    /// Whether to record the filenames that are added to the cache.
+    bool TrackNewFilenames = false;
+
+    /// The filenames added to the cache since they were last taken.
+    std::vector<std::string> NewFilenames;
+
     /// Returns entry associated with the filename or nullptr if none is found.
     const CachedFileSystemEntry *findEntryByFilename(StringRef Filename) const;
 
@@ -220,9 +232,56 @@ public:
   CacheShard &getShardForFilename(StringRef Filename) const;
   CacheShard &getShardForUID(llvm::sys::fs::UniqueID UID) const;
 
+  /// Drops the entries of \p Filename, so that the file is stat-ed, read and
+  /// scanned again the next time it's accessed. This may be called while
+  /// workers use the cache, but they keep using the entries that are in their
+  /// local caches. Other filenames of the same file, such as symlinks, keep
+  /// their entries. The memory of the entries is only released with the cache.
+  void invalidateEntriesForFilename(StringRef Filename);
+
+  /// Drops all the entries, as \c invalidateEntriesForFilename does.
+  void invalidateAllEntries();
+
+  /// Record the filenames that are added to the cache, so that clients can
+  /// watch them for changes.
+  void setTrackNewFilenames(bool Track);
+
+  /// Returns the filenames added to the cache since the previous call, if
+  /// they're tracked.
+  std::vector<std::string> takeNewFilenames();
+
+  /// Keep the scanned directives in the directory \p Path, which is created
+  /// if needed. The directory may be shared by concurrent runs.
+  void setDirectivesCachePath(StringRef Path);
+
+  /// Reads the directives of a file with the given \p Contents from the
+  /// directives cache into \p Tokens and \p Directives. Returns false if
+  /// there is no valid cache entry for the contents.
+  bool readCachedDirectives(
+      StringRef Contents,
+      SmallVectorImpl<dependency_directives_scan::Token> &Tokens,
+      SmallVectorImpl<dependency_directives_scan::Directive> &Directives) const;
+
+  /// Writes the directives scanned from a file with the given \p Contents
+  /// to the directives cache, if there is one. Failures are ignored, as the
+  /// cache is only an optimization.
+  void writeCachedDirectives(
+      StringRef Contents, ArrayRef<dependency_directives_scan::Token> Tokens,
+      ArrayRef<dependency_directives_scan::Directive> Directives) const;
+
 private:
+  /// Returns the path of the directives cache entry for \p Contents.
+  void getDirectivesCacheEntryPath(StringRef Contents,
+                                   SmallVectorImpl<char> &Path) const;
+
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
+
+  /// The directory of the directives cache, or empty if there is none.
+  std::string DirectivesCachePath;
+  /// The hash of the clang version and of the entry format, which is part of
+  /// the key of every directives cache entry.
+  uint64_t DirectivesCacheVersionHash = 0;
 };
 
 /// This class is a local cache, that caches the 'stat' and 'open' calls to the
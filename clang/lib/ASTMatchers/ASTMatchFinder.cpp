@@ -1038,9 +1038,7 @@ private:
 
   void matchWithFilter(const DynTypedNode &DynNode) {
     auto Kind = DynNode.getNodeKind();
-    auto it = MatcherFiltersMap.find(Kind);
-    const auto &Filter =
-        it != MatcherFiltersMap.end() ? it->second : getFilterForKind(Kind);
+    const auto &Filter = getFilter(DynNode, Kind);
 
     if (Filter.empty())
       return;
@@ -1069,11 +1067,45 @@ private:
     }
   }
 
-  const std::vector<unsigned short> &getFilterForKind(ASTNodeKind Kind) {
-    auto &Filter = MatcherFiltersMap[Kind];
+  /// Returns the filtered list of the matchers that may match \p DynNode.
+  const std::vector<unsigned short> &getFilter(const DynTypedNode &DynNode,
+                                               ASTNodeKind Kind) {
+    if (!MatcherNames)
+      computeMatcherNames();
+    // Named declarations are also dispatched on their identifier, as long as
+    // some matchers restrict it.
+    const auto *ND = NamedMatcherFiltersMap.empty()
+                         ? nullptr
+                         : DynNode.get<NamedDecl>();
+    if (const IdentifierInfo *II = ND ? ND->getIdentifier() : nullptr) {
+      auto NameIt = NamedMatcherFiltersMap.find(II->getName());
+      auto &FiltersMap = NameIt != NamedMatcherFiltersMap.end()
+                             ? NameIt->second
+                             : UnnamedMatcherFiltersMap;
+      auto It = FiltersMap.find(Kind);
+      return It != FiltersMap.end()
+                 ? It->second
+                 : getFilterForKind(FiltersMap, Kind, II->getName());
+    }
+    auto It = MatcherFiltersMap.find(Kind);
+    return It != MatcherFiltersMap.end()
+               ? It->second
+               : getFilterForKind(MatcherFiltersMap, Kind, std::nullopt);
+  }
+
+  /// Computes the filter of \p Kind into \p FiltersMap. If \p Name is set,
+  /// the matchers whose identifier names don't include it are left out.
+  const std::vector<unsigned short> &
+  getFilterForKind(llvm::DenseMap<ASTNodeKind, std::vector<unsigned short>>
+                       &FiltersMap,
+                   ASTNodeKind Kind, std::optional<StringRef> Name) {
+    auto &Filter = FiltersMap[Kind];
     auto &Matchers = this->Matchers->DeclOrStmt;
     assert((Matchers.size() < USHRT_MAX) && "Too many matchers.");
     for (unsigned I = 0, E = Matchers.size(); I != E; ++I) {
+      const std::vector<StringRef> &Names = (*MatcherNames)[I];
+      if (Name && !Names.empty() && !llvm::is_contained(Names, *Name))
+        continue;
       if (Matchers[I].first.canMatchNodesOfKind(Kind)) {
         Filter.push_back(I);
       }
@@ -1081,6 +1113,20 @@ private:
     return Filter;
   }
 
+  void computeMatcherNames() {
+    auto &Matchers = this->Matchers->DeclOrStmt;
+    MatcherNames.emplace(Matchers.size());
+    for (unsigned I = 0, E = Matchers.size(); I != E; ++I) {
+      std::vector<StringRef> &Names = (*MatcherNames)[I];
+      if (!Matchers[I].first.getIdentifierNames(Names)) {
+        Names.clear();
+        continue;
+      }
+      for (StringRef Name : Names)
+        NamedMatcherFiltersMap.try_emplace(Name);
+    }
+  }
+
   /// @{
   /// Overloads to pair the different node types to their matchers.
   void matchDispatch(const Decl *Node) {
@@ -1329,6 +1375,21 @@ private:
   /// We precalculate a list of matchers that pass the toplevel restrict check.
   llvm::DenseMap<ASTNodeKind, std::vector<unsigned short>> MatcherFiltersMap;
 
+  /// For each \c Decl and \c Stmt matcher, the identifiers one of which the
+  /// names of the nodes it matches must be, if their name is an identifier.
+  /// Empty if the matcher doesn't restrict the names.
+  ///
+  /// Many matchers select declarations by name, e.g. with \c hasName(). Named
+  /// declarations whose name is an identifier use the filters below, which
+  /// also leave out the matchers that restrict the name to other identifiers.
+  std::optional<std::vector<std::vector<StringRef>>> MatcherNames;
+  /// The filters for the identifiers restricted by some matchers.
+  llvm::StringMap<llvm::DenseMap<ASTNodeKind, std::vector<unsigned short>>>
+      NamedMatcherFiltersMap;
+  /// The filters for the other identifiers.
+  llvm::DenseMap<ASTNodeKind, std::vector<unsigned short>>
+      UnnamedMatcherFiltersMap;
+
   const MatchFinder::MatchFinderOptions &Options;
   ASTContext *ActiveASTContext;
 
@@ -124,6 +124,26 @@ public:
     return Func(DynNode, Finder, Builder, InnerMatchers);
   }
 
+  bool getIdentifierNames(std::vector<StringRef> &Names) const override {
+    // All of the inner matchers must match the node, so any of their
+    // restrictions applies.
+    if (Func == allOfVariadicOperator)
+      return llvm::any_of(InnerMatchers, [&](const DynTypedMatcher &M) {
+        return M.getIdentifierNames(Names);
+      });
+    // One of the inner matchers must match the node, so each of them must
+    // restrict the names.
+    if (Func == anyOfVariadicOperator || Func == eachOfVariadicOperator) {
+      std::vector<StringRef> InnerNames;
+      for (const DynTypedMatcher &M : InnerMatchers)
+        if (!M.getIdentifierNames(InnerNames))
+          return false;
+      llvm::append_range(Names, InnerNames);
+      return true;
+    }
+    return false;
+  }
+
 private:
   std::vector<DynTypedMatcher> InnerMatchers;
 };
@@ -145,6 +165,10 @@ public:
     return InnerMatcher->TraversalKind();
   }
 
+  bool getIdentifierNames(std::vector<StringRef> &Names) const override {
+    return InnerMatcher->getIdentifierNames(Names);
+  }
+
 private:
   const std::string ID;
   const IntrusiveRefCntPtr<DynMatcherInterface> InnerMatcher;
@@ -181,6 +205,10 @@ public:
     return TK;
   }
 
+  bool getIdentifierNames(std::vector<StringRef> &Names) const override {
+    return InnerMatcher->getIdentifierNames(Names);
+  }
+
 private:
   clang::TraversalKind TK;
   IntrusiveRefCntPtr<DynMatcherInterface> InnerMatcher;
@@ -677,6 +705,16 @@ bool HasNameMatcher::matchesNodeFullSlow(const NamedDecl &Node) const {
   return false;
 }
 
+bool HasNameMatcher::getIdentifierNames(std::vector<StringRef> &Names) const {
+  // Both the unqualified and the full matches compare the last component of
+  // each pattern to the name of the node itself.
+  for (StringRef Name : this->Names) {
+    size_t Pos = Name.rfind("::");
+    Names.push_back(Pos == StringRef::npos ? Name : Name.drop_front(Pos + 2));
+  }
+  return true;
+}
+
 bool HasNameMatcher::matchesNode(const NamedDecl &Node) const {
   assert(matchesNodeFullFast(Node) == matchesNodeFullSlow(Node));
   if (UseUnqualifiedMatch) {
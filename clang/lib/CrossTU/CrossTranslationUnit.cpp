@@ -21,6 +21,7 @@
 #include "clang/Index/USRGeneration.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Option/ArgList.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Path.h"
@@ -220,6 +221,130 @@ createCrossTUIndexString(const llvm::StringMap<std::string> &Index) {
   return Result.str();
 }
 
+static constexpr StringLiteral BinaryIndexMagic = "CTUI";
+static constexpr uint32_t BinaryIndexVersion = 1;
+static constexpr size_t BinaryIndexHeaderSize = 16;
+static constexpr size_t BinaryIndexEntrySize = 12;
+static constexpr size_t BinaryIndexPathSize = 8;
+
+std::string
+createCrossTUBinaryIndex(const llvm::StringMap<std::string> &Index) {
+  std::vector<const llvm::StringMapEntry<std::string> *> Entries;
+  for (const auto &E : Index)
+    Entries.push_back(&E);
+  llvm::sort(Entries, [](const auto *LHS, const auto *RHS) {
+    return LHS->getKey() < RHS->getKey();
+  });
+
+  // Every path is stored once, as many definitions share their file.
+  std::string Strings;
+  llvm::StringMap<uint32_t> PathIndices;
+  std::vector<std::pair<uint32_t, uint32_t>> Paths;
+  std::vector<uint32_t> EntryPaths;
+  for (const auto *E : Entries) {
+    auto [It, Inserted] = PathIndices.try_emplace(E->getValue(), Paths.size());
+    if (Inserted) {
+      Paths.emplace_back(Strings.size(), E->getValue().size());
+      Strings += E->getValue();
+    }
+    EntryPaths.push_back(It->second);
+  }
+
+  std::string Result;
+  llvm::raw_string_ostream OS(Result);
+  llvm::support::endian::Writer W(OS, llvm::endianness::little);
+  OS << BinaryIndexMagic;
+  W.write<uint32_t>(BinaryIndexVersion);
+  W.write<uint32_t>(Entries.size());
+  W.write<uint32_t>(Paths.size());
+  for (size_t I = 0, E = Entries.size(); I != E; ++I) {
+    W.write<uint32_t>(Strings.size());
+    W.write<uint32_t>(Entries[I]->getKey().size());
+    W.write<uint32_t>(EntryPaths[I]);
+    Strings += Entries[I]->getKey();
+  }
+  for (const auto &[Offset, Size] : Paths) {
+    W.write<uint32_t>(Offset);
+    W.write<uint32_t>(Size);
+  }
+  OS << Strings;
+  return Result;
+}
+
+bool CrossTUBinaryIndex::isBinaryIndex(StringRef Contents) {
+  return Contents.starts_with(BinaryIndexMagic);
+}
+
+llvm::Expected<CrossTUBinaryIndex>
+CrossTUBinaryIndex::create(std::unique_ptr<llvm::MemoryBuffer> Buffer,
+                           StringRef IndexPath) {
+  using namespace llvm::support;
+  StringRef Contents = Buffer->getBuffer();
+  auto InvalidFormat = [&]() {
+    return llvm::make_error<IndexError>(index_error_code::invalid_index_format,
+                                        IndexPath.str());
+  };
+  if (Contents.size() < BinaryIndexHeaderSize || !isBinaryIndex(Contents))
+    return InvalidFormat();
+
+  const char *Header = Contents.data() + BinaryIndexMagic.size();
+  if (endian::read32le(Header) != BinaryIndexVersion)
+    return InvalidFormat();
+  uint64_t NumEntries = endian::read32le(Header + 4);
+  uint64_t NumPaths = endian::read32le(Header + 8);
+  if (BinaryIndexHeaderSize + NumEntries * BinaryIndexEntrySize +
+          NumPaths * BinaryIndexPathSize >
+      Contents.size())
+    return InvalidFormat();
+  return CrossTUBinaryIndex(std::move(Buffer), NumEntries, NumPaths);
+}
+
+StringRef CrossTUBinaryIndex::getString(unsigned Offset, unsigned Size) const {
+  StringRef Strings = Buffer->getBuffer().drop_front(
+      BinaryIndexHeaderSize + NumEntries * BinaryIndexEntrySize +
+      NumPaths * BinaryIndexPathSize);
+  // An entry which is out of bounds is treated as empty rather than trusted.
+  if (uint64_t(Offset) + Size > Strings.size())
+    return StringRef();
+  return Strings.substr(Offset, Size);
+}
+
+StringRef CrossTUBinaryIndex::getName(unsigned Entry) const {
+  const char *P = Buffer->getBufferStart() + BinaryIndexHeaderSize +
+                  Entry * BinaryIndexEntrySize;
+  return getString(llvm::support::endian::read32le(P),
+                   llvm::support::endian::read32le(P + 4));
+}
+
+std::optional<StringRef>
+CrossTUBinaryIndex::lookup(StringRef LookupName) const {
+  using namespace llvm::support;
+  unsigned Low = 0, High = NumEntries;
+  while (Low < High) {
+    unsigned Mid = Low + (High - Low) / 2;
+    int Cmp = getName(Mid).compare(LookupName);
+    if (Cmp < 0) {
+      Low = Mid + 1;
+      continue;
+    }
+    if (Cmp > 0) {
+      High = Mid;
+      continue;
+    }
+
+    uint32_t Path = endian::read32le(Buffer->getBufferStart() +
+                                     BinaryIndexHeaderSize +
+                                     Mid * BinaryIndexEntrySize + 8);
+    if (Path >= NumPaths)
+      return std::nullopt;
+    const char *P = Buffer->getBufferStart() + BinaryIndexHeaderSize +
+                    NumEntries * BinaryIndexEntrySize +
+                    Path * BinaryIndexPathSize;
+    return getString(endian::read32le(P), endian::read32le(P + 4));
+  }
+  return std::nullopt;
+}
+
 bool shouldImport(const VarDecl *VD, const ASTContext &ACtx) {
   CanQualType CT = ACtx.getCanonicalType(VD->getType());
   return CT.isConstQualified() && VD->getType().isTrivialType(ACtx);
@@ -453,7 +578,8 @@ CrossTranslationUnitContext::ASTUnitStorage::getASTUnitForFunction(
       return std::move(IndexLoadError);
 
     // Check if there is an entry in the index for the function.
-    if (!NameFileMap.count(FunctionName)) {
+    std::optional<StringRef> FileName = lookupFileForFunction(FunctionName);
+    if (!FileName) {
       ++NumNotInOtherTU;
       return llvm::make_error<IndexError>(index_error_code::missing_definition);
     }
@@ -461,7 +587,7 @@ CrossTranslationUnitContext::ASTUnitStorage::getASTUnitForFunction(
     // Search in the index for the filename where the definition of FunctionName
     // resides.
     if (llvm::Expected<ASTUnit *> FoundForFile =
-            getASTUnitForFile(NameFileMap[FunctionName], DisplayCTUProgress)) {
+            getASTUnitForFile(*FileName, DisplayCTUProgress)) {
 
       // Update the cache.
       NameASTUnitMap[FunctionName] = *FoundForFile;
@@ -481,13 +607,24 @@ CrossTranslationUnitContext::ASTUnitStorage::getFileForFunction(
     StringRef FunctionName, StringRef CrossTUDir, StringRef IndexName) {
   if (llvm::Error IndexLoadError = ensureCTUIndexLoaded(CrossTUDir, IndexName))
     return std::move(IndexLoadError);
-  return NameFileMap[FunctionName];
+  return lookupFileForFunction(FunctionName).value_or(StringRef()).str();
+}
+
+std::optional<StringRef>
+CrossTranslationUnitContext::ASTUnitStorage::lookupFileForFunction(
+    StringRef FunctionName) {
+  if (BinaryIndex)
+    return BinaryIndex->lookup(FunctionName);
+  auto It = NameFileMap.find(FunctionName);
+  if (It == NameFileMap.end())
+    return std::nullopt;
+  return StringRef(It->second);
 }
 
 llvm::Error CrossTranslationUnitContext::ASTUnitStorage::ensureCTUIndexLoaded(
     StringRef CrossTUDir, StringRef IndexName) {
   // Dont initialize if the map is filled.
-  if (!NameFileMap.empty())
+  if (!NameFileMap.empty() || BinaryIndex)
     return llvm::Error::success();
 
   // Get the absolute path to the index file.
@@ -497,6 +634,19 @@ llvm::Error CrossTranslationUnitContext::ASTUnitStorage::ensureCTUIndexLoaded(
   else
     llvm::sys::path::append(IndexFile, IndexName);
 
+  // Binary indices are mapped and searched in place.
+  if (llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+          llvm::MemoryBuffer::getFile(IndexFile, /*IsText=*/false,
+                                      /*RequiresNullTerminator=*/false);
+      Buffer && CrossTUBinaryIndex::isBinaryIndex((*Buffer)->getBuffer())) {
+    llvm::Expected<CrossTUBinaryIndex> Index =
+        CrossTUBinaryIndex::create(std::move(*Buffer), IndexFile);
+    if (!Index)
+      return Index.takeError();
+    BinaryIndex.emplace(std::move(*Index));
+    return llvm::Error::success();
+  }
+
   if (auto IndexMapping = parseCrossTUIndex(IndexFile)) {
     // Initialize member map.
     NameFileMap = *IndexMapping;
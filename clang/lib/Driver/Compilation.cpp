@@ -14,13 +14,24 @@
 #include "clang/Driver/Options.h"
 #include "clang/Driver/ToolChain.h"
 #include "clang/Driver/Util.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Option/OptSpecifier.h"
 #include "llvm/Option/Option.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Triple.h"
 #include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -157,9 +168,7 @@ bool Compilation::CleanupFileMap(const ArgStringMap &Files,
   return Success;
 }
 
-int Compilation::ExecuteCommand(const Command &C,
-                                const Command *&FailingCommand,
-                                bool LogOnly) const {
+bool Compilation::PrintCommand(const Command &C) const {
   if ((getDriver().CCPrintOptions ||
        getArgs().hasArg(options::OPT_v)) && !getDriver().CCGenDiagnostics) {
     raw_ostream *OS = &llvm::errs();
@@ -176,8 +185,7 @@ int Compilation::ExecuteCommand(const Command &C,
       if (EC) {
         getDriver().Diag(diag::err_drv_cc_print_options_failure)
             << EC.message();
-        FailingCommand = &C;
-        return 1;
+        return false;
       }
       OS = OwnedStream.get();
     }
@@ -187,6 +195,16 @@ int Compilation::ExecuteCommand(const Command &C,
 
     C.Print(*OS, "\n", /*Quote=*/getDriver().CCPrintOptions);
   }
+  return true;
+}
+
+int Compilation::ExecuteCommand(const Command &C,
+                                const Command *&FailingCommand,
+                                bool LogOnly) const {
+  if (!PrintCommand(C)) {
+    FailingCommand = &C;
+    return 1;
+  }
 
   if (LogOnly)
     return 0;
@@ -236,9 +254,167 @@ static bool InputsOk(const Command &C,
   return !ActionFailed(&C.getSource(), FailingCommands);
 }
 
+/// Copy the contents of the file \p Path, to which the output of a job was
+/// redirected, to \p OS and remove the file.
+static void replayJobOutput(StringRef Path, raw_ostream &OS) {
+  if (Path.empty())
+    return;
+  if (llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+          llvm::MemoryBuffer::getFile(Path)) {
+    OS << (*Buffer)->getBuffer();
+    OS.flush();
+  }
+  llvm::sys::fs::remove(Path);
+}
+
+void Compilation::ExecuteJobsInParallel(
+    const JobList &Jobs, FailingCommandList &FailingCommands) const {
+  SmallVector<const Command *, 16> Commands;
+  llvm::DenseMap<const Action *, SmallVector<unsigned, 1>> JobsBySource;
+  for (const auto &Job : Jobs) {
+    JobsBySource[&Job.getSource()].push_back(Commands.size());
+    Commands.push_back(&Job);
+  }
+
+  // A job depends on the jobs whose sources are inputs of its own source,
+  // looking through the actions which don't have jobs of their own, as these
+  // are performed by the job itself (e.g. the integrated assembler). Jobs
+  // which share their source are kept in order.
+  std::vector<SmallVector<unsigned, 4>> Users(Commands.size());
+  std::vector<unsigned> NumPendingInputs(Commands.size(), 0);
+  for (unsigned I = 0, E = Commands.size(); I != E; ++I) {
+    const Action *Source = &Commands[I]->getSource();
+    llvm::SmallSetVector<unsigned, 4> Inputs;
+    llvm::SmallPtrSet<const Action *, 16> Visited;
+    SmallVector<const Action *, 16> Worklist = {Source};
+    while (!Worklist.empty()) {
+      const Action *A = Worklist.pop_back_val();
+      if (!Visited.insert(A).second)
+        continue;
+      auto It = JobsBySource.find(A);
+      if (It != JobsBySource.end()) {
+        for (unsigned J : It->second)
+          if (J < I)
+            Inputs.insert(J);
+        if (A != Source)
+          continue;
+      }
+      Worklist.append(A->input_begin(), A->input_end());
+    }
+    for (unsigned J : Inputs)
+      Users[J].push_back(I);
+    NumPendingInputs[I] = Inputs.size();
+  }
+
+  // The output of the jobs is redirected to temporary files, unless the
+  // output of the whole compilation is redirected, and copied to our own
+  // once the job is done, so that the output of different jobs isn't
+  // interleaved.
+  struct JobResult {
+    int Res = 0;
+    bool ExecutionFailed = false;
+    std::string Error;
+    SmallString<128> StdoutPath;
+    SmallString<128> StderrPath;
+  };
+  std::vector<JobResult> Results(Commands.size());
+  bool CaptureOutput = Redirects.empty();
+
+  std::deque<unsigned> Ready;
+  for (unsigned I = 0, E = Commands.size(); I != E; ++I)
+    if (!NumPendingInputs[I])
+      Ready.push_back(I);
+  auto MarkDone = [&](unsigned I) {
+    for (unsigned User : Users[I])
+      if (!--NumPendingInputs[User])
+        Ready.push_back(User);
+  };
+
+  std::mutex FinishedLock;
+  std::condition_variable FinishedCV;
+  std::vector<unsigned> Finished;
+  unsigned NumRunning = 0;
+
+  // Only the jobs themselves run on the pool. Everything that touches the
+  // driver (diagnostics, callbacks, the list of failing commands) is done on
+  // this thread.
+  llvm::DefaultThreadPool Pool(llvm::hardware_concurrency(ParallelJobs));
+  for (;;) {
+    while (!Ready.empty() && NumRunning < ParallelJobs) {
+      unsigned I = Ready.front();
+      Ready.pop_front();
+      const Command &C = *Commands[I];
+      if (!InputsOk(C, FailingCommands)) {
+        MarkDone(I);
+        continue;
+      }
+      if (!PrintCommand(C)) {
+        FailingCommands.push_back(std::make_pair(1, &C));
+        MarkDone(I);
+        continue;
+      }
+
+      JobResult &Result = Results[I];
+      std::vector<std::optional<StringRef>> JobRedirects(Redirects.begin(),
+                                                         Redirects.end());
+      if (CaptureOutput &&
+          !llvm::sys::fs::createTemporaryFile("clang-job", "out",
+                                              Result.StdoutPath) &&
+          !llvm::sys::fs::createTemporaryFile("clang-job", "err",
+                                              Result.StderrPath))
+        JobRedirects = {std::nullopt, StringRef(Result.StdoutPath),
+                        StringRef(Result.StderrPath)};
+
+      ++NumRunning;
+      Pool.async([&, I, JobRedirects = std::move(JobRedirects)]() {
+        JobResult &Result = Results[I];
+        Result.Res = Commands[I]->Execute(JobRedirects, &Result.Error,
+                                          &Result.ExecutionFailed);
+        std::lock_guard<std::mutex> LockGuard(FinishedLock);
+        Finished.push_back(I);
+        FinishedCV.notify_one();
+      });
+    }
+    if (!NumRunning)
+      break;
+
+    std::vector<unsigned> Done;
+    {
+      std::unique_lock<std::mutex> LockGuard(FinishedLock);
+      FinishedCV.wait(LockGuard, [&]() { return !Finished.empty(); });
+      std::swap(Done, Finished);
+    }
+    for (unsigned I : Done) {
+      --NumRunning;
+      const Command &C = *Commands[I];
+      JobResult &Result = Results[I];
+      replayJobOutput(Result.StdoutPath, llvm::outs());
+      replayJobOutput(Result.StderrPath, llvm::errs());
+      if (PostCallback)
+        PostCallback(C, Result.Res);
+      if (!Result.Error.empty()) {
+        assert(Result.Res && "Error string set with 0 result code!");
+        getDriver().Diag(diag::err_drv_command_failure) << Result.Error;
+      }
+      if (Result.Res)
+        FailingCommands.push_back(
+            std::make_pair(Result.ExecutionFailed ? 1 : Result.Res, &C));
+      MarkDone(I);
+    }
+  }
+  Pool.wait();
+}
+
 void Compilation::ExecuteJobs(const JobList &Jobs,
                               FailingCommandList &FailingCommands,
                               bool LogOnly) const {
+  // Jobs executed in this process, and the input filenames printed by the cl
+  // driver, need the jobs to run one at a time.
+  if (ParallelJobs > 1 && Jobs.size() > 1 && !LogOnly &&
+      !TheDriver.IsCLMode() && llvm::llvm_is_multithreaded() &&
+      llvm::none_of(Jobs, [](const Command &C) { return C.InProcess; }))
+    return ExecuteJobsInParallel(Jobs, FailingCommands);
+
   // According to UNIX standard, driver need to continue compiling all the
   // inputs on the command line even one of them failed.
   // In all but CLMode, execute all the jobs unless the necessary inputs for the
@@ -5061,6 +5061,15 @@ void Driver::BuildJobs(Compilation &C) const {
                        /*TargetDeviceOffloadKind*/ Action::OFK_None);
   }
 
+  if (const Arg *A = C.getArgs().getLastArg(options::OPT_parallel_jobs_EQ)) {
+    unsigned N;
+    if (StringRef(A->getValue()).getAsInteger(10, N) || !N)
+      Diag(clang::diag::err_drv_invalid_int_value)
+          << A->getAsString(C.getArgs()) << A->getValue();
+    else
+      C.setParallelJobs(N);
+  }
+
   // If we have more than one job, then disable integrated-cc1 for now. Do this
   // also when we need to report process execution statistics.
   if (C.getJobs().size() > 1 || CCPrintProcessStats)
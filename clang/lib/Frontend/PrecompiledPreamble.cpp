@@ -13,6 +13,7 @@
 #include "clang/Frontend/PrecompiledPreamble.h"
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/LangStandard.h"
+#include "clang/Basic/Version.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/CompilerInvocation.h"
 #include "clang/Frontend/FrontendActions.h"
@@ -23,10 +24,14 @@
 #include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Serialization/ASTWriter.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Config/llvm-config.h"
+#include "llvm/Support/BinaryByteStream.h"
+#include "llvm/Support/BinaryStreamReader.h"
 #include "llvm/Support/CrashRecoveryContext.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Path.h"
@@ -760,6 +765,227 @@ PrecompiledPreamble::PreambleFileHash::createForMemoryBuffer(
   return Result;
 }
 
+/// The version of the format of the preamble store entries.
+static constexpr uint32_t PreambleStoreVersion = 1;
+static constexpr char PreambleStoreMagic[4] = {'C', 'P', 'R', 'E'};
+
+void PrecompiledPreamble::getStoreKeyDirectory(
+    const CompilerInvocation &Invocation, StringRef PreambleBytes,
+    StringRef StorePath, SmallVectorImpl<char> &KeyDir) {
+  // Reset the options that are set up to use a preamble, so that they don't
+  // affect the key.
+  CompilerInvocation CI(Invocation);
+  CI.getFrontendOpts().OutputFile.clear();
+  CI.getPreprocessorOpts().ImplicitPCHInclude.clear();
+  CI.getPreprocessorOpts().PrecompiledPreambleBytes = {0, false};
+
+  llvm::MD5 Hash;
+  Hash.update(getClangFullRepositoryVersion());
+  Hash.update(std::to_string(PreambleStoreVersion));
+  CI.generateCC1CommandLine([&](const Twine &Arg) {
+    SmallString<128> Buffer;
+    Hash.update(Arg.toStringRef(Buffer));
+    Hash.update(StringRef("", 1));
+  });
+  Hash.update(PreambleBytes);
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+
+  KeyDir.assign(StorePath.begin(), StorePath.end());
+  llvm::sys::path::append(KeyDir, Result.digest());
+}
+
+std::error_code
+PrecompiledPreamble::Publish(const CompilerInvocation &Invocation,
+                             StringRef StorePath) const {
+  std::unique_ptr<llvm::MemoryBuffer> PCHFile;
+  StringRef PCH;
+  if (Storage->getKind() == PCHStorage::Kind::InMemory) {
+    PCH = Storage->memoryContents();
+  } else {
+    auto MaybePCHFile = llvm::MemoryBuffer::getFile(
+        Storage->filePath(), /*IsText=*/false,
+        /*RequiresNullTerminator=*/false);
+    if (!MaybePCHFile)
+      return MaybePCHFile.getError();
+    PCHFile = std::move(*MaybePCHFile);
+    PCH = PCHFile->getBuffer();
+  }
+
+  // Write everything CanReuse() checks. The files are sorted, so that the
+  // same state of the files always gives the same entry.
+  SmallString<0> Metadata;
+  llvm::raw_svector_ostream OS(Metadata);
+  llvm::support::endian::Writer LE(OS, llvm::endianness::little);
+  auto WriteString = [&](StringRef S) {
+    LE.write<uint32_t>(S.size());
+    OS << S;
+  };
+  OS.write(PreambleStoreMagic, sizeof(PreambleStoreMagic));
+  LE.write<uint32_t>(PreambleStoreVersion);
+  LE.write<uint8_t>(PreambleEndsAtStartOfLine);
+  WriteString(getContents());
+
+  std::vector<StringRef> Files;
+  for (const auto &F : FilesInPreamble)
+    Files.push_back(F.getKey());
+  llvm::sort(Files);
+  LE.write<uint32_t>(Files.size());
+  for (StringRef File : Files) {
+    const PreambleFileHash &FileHash = FilesInPreamble.find(File)->second;
+    WriteString(File);
+    LE.write<int64_t>(FileHash.Size);
+    LE.write<int64_t>(FileHash.ModTime);
+    OS.write(reinterpret_cast<const char *>(FileHash.MD5.data()),
+             FileHash.MD5.size());
+  }
+
+  std::vector<StringRef> Missing;
+  for (const auto &F : MissingFiles)
+    Missing.push_back(F.getKey());
+  llvm::sort(Missing);
+  LE.write<uint32_t>(Missing.size());
+  for (StringRef File : Missing)
+    WriteString(File);
+  LE.write<uint64_t>(PCH.size());
+
+  SmallString<256> EntryPath;
+  getStoreKeyDirectory(Invocation, getContents(), StorePath, EntryPath);
+  if (std::error_code EC = llvm::sys::fs::create_directories(EntryPath))
+    return EC;
+  SmallString<256> TempPath(EntryPath);
+  llvm::sys::path::append(TempPath, "%%%%%%%%.tmp");
+  llvm::MD5::MD5Result EntryHash =
+      llvm::MD5::hash(llvm::arrayRefFromStringRef(Metadata));
+  llvm::sys::path::append(EntryPath, EntryHash.digest() + ".pch");
+
+  auto Temp = llvm::sys::fs::TempFile::create(TempPath);
+  if (!Temp)
+    return llvm::errorToErrorCode(Temp.takeError());
+  llvm::raw_fd_ostream TempOS(Temp->FD, /*shouldClose=*/false);
+  TempOS << Metadata << PCH;
+  TempOS.flush();
+  if (std::error_code EC = TempOS.error()) {
+    TempOS.clear_error();
+    llvm::consumeError(Temp->discard());
+    return EC;
+  }
+  return llvm::errorToErrorCode(Temp->keep(EntryPath));
+}
+
+std::optional<PrecompiledPreamble> PrecompiledPreamble::LoadFromStore(
+    const CompilerInvocation &Invocation,
+    const llvm::MemoryBufferRef &MainFileBuffer, PreambleBounds Bounds,
+    llvm::vfs::FileSystem &VFS, StringRef StorePath) {
+  assert(
+      Bounds.Size <= MainFileBuffer.getBufferSize() &&
+      "Buffer is too large. Bounds were calculated from a different buffer?");
+  StringRef PreambleContents =
+      MainFileBuffer.getBuffer().take_front(Bounds.Size);
+  SmallString<256> KeyDir;
+  getStoreKeyDirectory(Invocation, PreambleContents, StorePath, KeyDir);
+
+  // There is an entry for every state of the files that the preamble was
+  // built with, so find one that is still valid.
+  std::error_code EC;
+  for (llvm::sys::fs::directory_iterator It(KeyDir, EC), End;
+       !EC && It != End; It.increment(EC)) {
+    if (llvm::sys::path::extension(It->path()) != ".pch")
+      continue;
+    auto Entry = llvm::MemoryBuffer::getFile(It->path(), /*IsText=*/false,
+                                             /*RequiresNullTerminator=*/false);
+    if (!Entry)
+      continue;
+
+    bool EndsAtStartOfLine = false;
+    StringRef Bytes, PCH;
+    llvm::StringMap<PreambleFileHash> Files;
+    llvm::StringSet<> Missing;
+    auto ReadEntry = [&]() -> llvm::Error {
+      llvm::BinaryByteStream Stream((*Entry)->getBuffer(),
+                                    llvm::endianness::little);
+      llvm::BinaryStreamReader Reader(Stream);
+      StringRef Magic;
+      uint32_t Version, NumFiles, NumMissing;
+      uint8_t EndsAtStartOfLineByte;
+      uint64_t PCHSize;
+      auto ReadString = [&](StringRef &S) -> llvm::Error {
+        uint32_t Size;
+        if (llvm::Error Err = Reader.readInteger(Size))
+          return Err;
+        return Reader.readFixedString(S, Size);
+      };
+
+      if (llvm::Error Err =
+              Reader.readFixedString(Magic, sizeof(PreambleStoreMagic)))
+        return Err;
+      if (llvm::Error Err = Reader.readInteger(Version))
+        return Err;
+      if (Magic != StringRef(PreambleStoreMagic, sizeof(PreambleStoreMagic)) ||
+          Version != PreambleStoreVersion)
+        return llvm::createStringError("unknown preamble store entry format");
+      if (llvm::Error Err = Reader.readInteger(EndsAtStartOfLineByte))
+        return Err;
+      EndsAtStartOfLine = EndsAtStartOfLineByte;
+      if (llvm::Error Err = ReadString(Bytes))
+        return Err;
+
+      if (llvm::Error Err = Reader.readInteger(NumFiles))
+        return Err;
+      for (uint32_t I = 0; I != NumFiles; ++I) {
+        StringRef Name;
+        PreambleFileHash FileHash;
+        int64_t Size, ModTime;
+        ArrayRef<uint8_t> MD5;
+        if (llvm::Error Err = ReadString(Name))
+          return Err;
+        if (llvm::Error Err = Reader.readInteger(Size))
+          return Err;
+        if (llvm::Error Err = Reader.readInteger(ModTime))
+          return Err;
+        if (llvm::Error Err = Reader.readBytes(MD5, FileHash.MD5.size()))
+          return Err;
+        FileHash.Size = Size;
+        FileHash.ModTime = ModTime;
+        std::copy(MD5.begin(), MD5.end(), FileHash.MD5.begin());
+        Files[Name] = FileHash;
+      }
+
+      if (llvm::Error Err = Reader.readInteger(NumMissing))
+        return Err;
+      for (uint32_t I = 0; I != NumMissing; ++I) {
+        StringRef Name;
+        if (llvm::Error Err = ReadString(Name))
+          return Err;
+        Missing.insert(Name);
+      }
+
+      if (llvm::Error Err = Reader.readInteger(PCHSize))
+        return Err;
+      if (PCHSize != Reader.bytesRemaining())
+        return llvm::createStringError("truncated preamble store entry");
+      return Reader.readFixedString(PCH, PCHSize);
+    };
+    if (llvm::Error Err = ReadEntry()) {
+      llvm::consumeError(std::move(Err));
+      continue;
+    }
+
+    // Check the entry before copying its PCH.
+    auto Buffer = std::make_shared<PCHBuffer>();
+    PrecompiledPreamble Preamble(PCHStorage::inMemory(Buffer),
+                                 std::vector<char>(Bytes.begin(), Bytes.end()),
+                                 EndsAtStartOfLine, std::move(Files),
+                                 std::move(Missing));
+    if (!Preamble.CanReuse(Invocation, MainFileBuffer, Bounds, VFS))
+      continue;
+    Buffer->Data.assign(PCH.begin(), PCH.end());
+    Buffer->IsComplete = true;
+    return Preamble;
+  }
+  return std::nullopt;
+}
+
 void PrecompiledPreamble::configurePreamble(
     PreambleBounds Bounds, CompilerInvocation &CI,
     IntrusiveRefCntPtr<llvm::vfs::FileSystem> &VFS,
@@ -14,8 +14,10 @@
 
 #include "clang/Basic/TargetInfo.h"
 #include "clang/Basic/TargetOptions.h"
+#include "clang/Interpreter/Interpreter.h"
 #include "clang/Interpreter/PartialTranslationUnit.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/Debugging/DebuggerSupport.h"
 #include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
@@ -55,11 +57,24 @@ IncrementalExecutor::createDefaultJITBuilder(
 
 IncrementalExecutor::IncrementalExecutor(llvm::orc::ThreadSafeContext &TSC,
                                          llvm::orc::LLJITBuilder &JITBuilder,
+                                         const JITConfig &Config,
                                          llvm::Error &Err)
     : TSCtx(TSC) {
   using namespace llvm::orc;
   llvm::ErrorAsOutParameter EAO(&Err);
 
+  if (Config.LazyCompile) {
+    // Build the lazy engine with everything the client configured.
+    LLLazyJITBuilder LazyBuilder;
+    static_cast<LLJITBuilderState &>(LazyBuilder) = std::move(JITBuilder);
+    if (auto JitOrErr = LazyBuilder.create()) {
+      LazyJit = JitOrErr->get();
+      Jit = std::move(*JitOrErr);
+    } else
+      Err = JitOrErr.takeError();
+    return;
+  }
+
   if (auto JitOrErr = JITBuilder.create())
     Jit = std::move(*JitOrErr);
   else {
@@ -75,7 +90,22 @@ llvm::Error IncrementalExecutor::addModule(PartialTranslationUnit &PTU) {
       Jit->getMainJITDylib().createResourceTracker();
   ResourceTrackers[&PTU] = RT;
 
-  return Jit->addIRModule(RT, {std::move(PTU.TheModule), TSCtx});
+  if (!LazyJit)
+    return Jit->addIRModule(RT, {std::move(PTU.TheModule), TSCtx});
+
+  // The function bodies are split out of the module and compiled the first
+  // time they are called, through the stubs of the compile-on-demand layer.
+  llvm::Module &M = *PTU.TheModule;
+  if (M.getDataLayout().isDefault())
+    M.setDataLayout(Jit->getDataLayout());
+  else if (M.getDataLayout() != Jit->getDataLayout())
+    return llvm::make_error<llvm::StringError>(
+        "Added modules have incompatible data layouts: " +
+            M.getDataLayout().getStringRepresentation() + " (module) vs " +
+            Jit->getDataLayout().getStringRepresentation() + " (jit)",
+        llvm::inconvertibleErrorCode());
+  return LazyJit->getCompileOnDemandLayer().add(
+      RT, {std::move(PTU.TheModule), TSCtx});
 }
 
 llvm::Error IncrementalExecutor::removeModule(PartialTranslationUnit &PTU) {
@@ -26,18 +26,22 @@ namespace orc {
 class JITTargetMachineBuilder;
 class LLJIT;
 class LLJITBuilder;
+class LLLazyJIT;
 class ThreadSafeContext;
 } // namespace orc
 } // namespace llvm
 
 namespace clang {
 
+struct JITConfig;
 struct PartialTranslationUnit;
 class TargetInfo;
 
 class IncrementalExecutor {
   using CtorDtorIterator = llvm::orc::CtorDtorIterator;
   std::unique_ptr<llvm::orc::LLJIT> Jit;
+  /// The same engine as Jit if the functions are compiled lazily, or null.
+  llvm::orc::LLLazyJIT *LazyJit = nullptr;
   llvm::orc::ThreadSafeContext &TSCtx;
 
   llvm::DenseMap<const PartialTranslationUnit *, llvm::orc::ResourceTrackerSP>
@@ -50,7 +54,8 @@ public:
   enum SymbolNameKind { IRName, LinkerName };
 
   IncrementalExecutor(llvm::orc::ThreadSafeContext &TSC,
-                      llvm::orc::LLJITBuilder &JITBuilder, llvm::Error &Err);
+                      llvm::orc::LLJITBuilder &JITBuilder,
+                      const JITConfig &Config, llvm::Error &Err);
   virtual ~IncrementalExecutor();
 
   virtual llvm::Error addModule(PartialTranslationUnit &PTU);
@@ -7,9 +7,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "clang/Basic/TokenKinds.h"
+#include "clang/Basic/Version.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/Threading.h"
+#include "llvm/Support/xxhash.h"
 #include <optional>
 
 using namespace clang;
@@ -62,15 +69,22 @@ bool DependencyScanningWorkerFilesystem::ensureDirectiveTokensArePopulated(
     return true;
 
   SmallVector<dependency_directives_scan::Directive, 64> Directives;
-  // Scan the file for preprocessor directives that might affect the
+  StringRef Source = Contents->Original->getBuffer();
+  // Reuse the directives scanned by an earlier run if possible. Otherwise,
+  // scan the file for preprocessor directives that might affect the
   // dependencies.
-  if (scanSourceForDependencyDirectives(Contents->Original->getBuffer(),
-                                        Contents->DepDirectiveTokens,
+  if (!SharedCache.readCachedDirectives(Source, Contents->DepDirectiveTokens,
                                         Directives)) {
-    Contents->DepDirectiveTokens.clear();
-    // FIXME: Propagate the diagnostic if desired by the client.
-    Contents->DepDirectives.store(new std::optional<DependencyDirectivesTy>());
-    return false;
+    if (scanSourceForDependencyDirectives(Source, Contents->DepDirectiveTokens,
+                                          Directives)) {
+      Contents->DepDirectiveTokens.clear();
+      // FIXME: Propagate the diagnostic if desired by the client.
+      Contents->DepDirectives.store(
+          new std::optional<DependencyDirectivesTy>());
+      return false;
+    }
+    SharedCache.writeCachedDirectives(Source, Contents->DepDirectiveTokens,
+                                      Directives);
   }
 
   // This function performed double-checked locking using `DepDirectives`.
@@ -108,6 +122,214 @@ DependencyScanningFilesystemSharedCache::getShardForUID(
   return CacheShards[Hash % NumShards];
 }
 
+void DependencyScanningFilesystemSharedCache::invalidateEntriesForFilename(
+    StringRef Filename) {
+  const CachedFileSystemEntry *Entry = nullptr;
+  {
+    CacheShard &Shard = getShardForFilename(Filename);
+    std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+    auto It = Shard.CacheByFilename.find(Filename);
+    if (It == Shard.CacheByFilename.end())
+      return;
+    Entry = It->getValue().first;
+    Shard.CacheByFilename.erase(It);
+  }
+
+  // Files modified in place keep their unique ID, so drop the entry for it
+  // too.
+  if (!Entry || Entry->isError())
+    return;
+  CacheShard &Shard = getShardForUID(Entry->getUniqueID());
+  std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+  auto It = Shard.EntriesByUID.find(Entry->getUniqueID());
+  if (It != Shard.EntriesByUID.end() && It->getSecond() == Entry)
+    Shard.EntriesByUID.erase(It);
+}
+
+void DependencyScanningFilesystemSharedCache::invalidateAllEntries() {
+  for (unsigned I = 0; I != NumShards; ++I) {
+    CacheShard &Shard = CacheShards[I];
+    std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+    Shard.CacheByFilename.clear();
+    Shard.EntriesByUID.clear();
+  }
+}
+
+void DependencyScanningFilesystemSharedCache::setTrackNewFilenames(
+    bool Track) {
+  for (unsigned I = 0; I != NumShards; ++I) {
+    CacheShard &Shard = CacheShards[I];
+    std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+    Shard.TrackNewFilenames = Track;
+    if (!Track)
+      Shard.NewFilenames.clear();
+  }
+}
+
+std::vector<std::string>
+DependencyScanningFilesystemSharedCache::takeNewFilenames() {
+  std::vector<std::string> Filenames;
+  for (unsigned I = 0; I != NumShards; ++I) {
+    CacheShard &Shard = CacheShards[I];
+    std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+    if (Filenames.empty())
+      Filenames = std::move(Shard.NewFilenames);
+    else
+      llvm::append_range(Filenames, Shard.NewFilenames);
+    Shard.NewFilenames.clear();
+  }
+  return Filenames;
+}
+
+/// The version of the format of the directives cache entries, which must be
+/// bumped whenever the format or the output of the scanner changes.
+static constexpr uint32_t DirectivesCacheFormatVersion = 1;
+static constexpr char DirectivesCacheMagic[4] = {'D', 'D', 'C', 'E'};
+
+void DependencyScanningFilesystemSharedCache::setDirectivesCachePath(
+    StringRef Path) {
+  DirectivesCachePath = Path.str();
+  if (Path.empty())
+    return;
+  // If the directory can't be created, writing the entries fails and every
+  // file is scanned as if there was no cache.
+  llvm::sys::fs::create_directories(Path);
+  std::string Version = getClangFullRepositoryVersion();
+  Version += '/';
+  Version += std::to_string(DirectivesCacheFormatVersion);
+  DirectivesCacheVersionHash = llvm::xxh3_64bits(Version);
+}
+
+void DependencyScanningFilesystemSharedCache::getDirectivesCacheEntryPath(
+    StringRef Contents, SmallVectorImpl<char> &Path) const {
+  llvm::XXH128_hash_t Hash =
+      llvm::xxh3_128bits(llvm::arrayRefFromStringRef(Contents));
+  SmallString<64> Name;
+  // The prefix lets llvm::pruneCache() manage the directory.
+  llvm::raw_svector_ostream(Name)
+      << "llvmcache-" << llvm::format_hex_no_prefix(Hash.high64, 16)
+      << llvm::format_hex_no_prefix(Hash.low64, 16)
+      << llvm::format_hex_no_prefix(DirectivesCacheVersionHash, 16);
+  Path.assign(DirectivesCachePath.begin(), DirectivesCachePath.end());
+  llvm::sys::path::append(Path, Name);
+}
+
+bool DependencyScanningFilesystemSharedCache::readCachedDirectives(
+    StringRef Contents,
+    SmallVectorImpl<dependency_directives_scan::Token> &Tokens,
+    SmallVectorImpl<dependency_directives_scan::Directive> &Directives) const {
+  using namespace llvm::support;
+  constexpr llvm::endianness Little = llvm::endianness::little;
+
+  if (DirectivesCachePath.empty())
+    return false;
+  SmallString<256> EntryPath;
+  getDirectivesCacheEntryPath(Contents, EntryPath);
+  auto MaybeBuffer = llvm::MemoryBuffer::getFile(
+      EntryPath, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!MaybeBuffer)
+    return false;
+
+  // The entries may have been written by a process that crashed, so check
+  // that everything is in bounds.
+  StringRef Data = (*MaybeBuffer)->getBuffer();
+  constexpr size_t HeaderSize = sizeof(DirectivesCacheMagic) + 16;
+  constexpr size_t TokenSize = 12;
+  constexpr size_t DirectiveSize = 9;
+  if (Data.size() < HeaderSize ||
+      !Data.starts_with(StringRef(DirectivesCacheMagic,
+                                  sizeof(DirectivesCacheMagic))))
+    return false;
+  const char *Ptr = Data.data() + sizeof(DirectivesCacheMagic);
+  uint64_t SourceSize = endian::readNext<uint64_t, Little>(Ptr);
+  uint32_t NumTokens = endian::readNext<uint32_t, Little>(Ptr);
+  uint32_t NumDirectives =
+      endian::readNext<uint32_t, Little>(Ptr);
+  if (SourceSize != Contents.size() ||
+      Data.size() != HeaderSize + uint64_t(NumTokens) * TokenSize +
+                         uint64_t(NumDirectives) * DirectiveSize)
+    return false;
+
+  Tokens.reserve(NumTokens);
+  for (uint32_t I = 0; I != NumTokens; ++I) {
+    uint32_t Offset = endian::readNext<uint32_t, Little>(Ptr);
+    uint32_t Length = endian::readNext<uint32_t, Little>(Ptr);
+    uint16_t Kind = endian::readNext<uint16_t, Little>(Ptr);
+    uint16_t Flags = endian::readNext<uint16_t, Little>(Ptr);
+    if (uint64_t(Offset) + Length > Contents.size() ||
+        Kind >= tok::NUM_TOKENS) {
+      Tokens.clear();
+      return false;
+    }
+    Tokens.emplace_back(Offset, Length, tok::TokenKind(Kind), Flags);
+  }
+
+  Directives.reserve(NumDirectives);
+  for (uint32_t I = 0; I != NumDirectives; ++I) {
+    uint8_t Kind = endian::readNext<uint8_t, Little>(Ptr);
+    uint32_t Begin = endian::readNext<uint32_t, Little>(Ptr);
+    uint32_t Count = endian::readNext<uint32_t, Little>(Ptr);
+    if (uint64_t(Begin) + Count > NumTokens ||
+        Kind > dependency_directives_scan::pp_eof) {
+      Tokens.clear();
+      Directives.clear();
+      return false;
+    }
+    Directives.emplace_back(dependency_directives_scan::DirectiveKind(Kind),
+                            ArrayRef(Tokens).slice(Begin, Count));
+  }
+  return true;
+}
+
+void DependencyScanningFilesystemSharedCache::writeCachedDirectives(
+    StringRef Contents, ArrayRef<dependency_directives_scan::Token> Tokens,
+    ArrayRef<dependency_directives_scan::Directive> Directives) const {
+  if (DirectivesCachePath.empty())
+    return;
+
+  SmallString<0> Data;
+  llvm::raw_svector_ostream OS(Data);
+  llvm::support::endian::Writer LE(OS, llvm::endianness::little);
+  OS.write(DirectivesCacheMagic, sizeof(DirectivesCacheMagic));
+  LE.write<uint64_t>(Contents.size());
+  LE.write<uint32_t>(Tokens.size());
+  LE.write<uint32_t>(Directives.size());
+  for (const dependency_directives_scan::Token &Tok : Tokens) {
+    LE.write<uint32_t>(Tok.Offset);
+    LE.write<uint32_t>(Tok.Length);
+    LE.write<uint16_t>(Tok.Kind);
+    LE.write<uint16_t>(Tok.Flags);
+  }
+  for (const dependency_directives_scan::Directive &D : Directives) {
+    // The tokens of every directive are a range of the token list.
+    uint32_t Begin = D.Tokens.empty() ? 0 : D.Tokens.data() - Tokens.data();
+    assert(Begin + D.Tokens.size() <= Tokens.size() &&
+           "directive tokens outside of the token list");
+    LE.write<uint8_t>(D.Kind);
+    LE.write<uint32_t>(Begin);
+    LE.write<uint32_t>(D.Tokens.size());
+  }
+
+  // Write a temporary file and rename it, so that concurrent runs never see
+  // partial entries.
+  SmallString<256> EntryPath;
+  getDirectivesCacheEntryPath(Contents, EntryPath);
+  auto Temp = llvm::sys::fs::TempFile::create(EntryPath + ".tmp-%%%%%%");
+  if (!Temp) {
+    llvm::consumeError(Temp.takeError());
+    return;
+  }
+  llvm::raw_fd_ostream TempOS(Temp->FD, /*shouldClose=*/false);
+  TempOS << Data;
+  TempOS.flush();
+  if (TempOS.has_error()) {
+    TempOS.clear_error();
+    llvm::consumeError(Temp->discard());
+    return;
+  }
+  llvm::consumeError(Temp->keep(EntryPath));
+}
+
 const CachedFileSystemEntry *
 DependencyScanningFilesystemSharedCache::CacheShard::findEntryByFilename(
     StringRef Filename) const {
@@ -131,6 +353,8 @@ DependencyScanningFilesystemSharedCache::CacheShard::
                                  llvm::ErrorOr<llvm::vfs::Status> Stat) {
   std::lock_guard<std::mutex> LockGuard(CacheLock);
   auto [It, Inserted] = CacheByFilename.insert({Filename, {nullptr, nullptr}});
+  if (Inserted && TrackNewFilenames)
+    NewFilenames.push_back(Filename.str());
   auto &[CachedEntry, CachedRealPath] = It->getValue();
   if (!CachedEntry) {
     // The entry is not present in the shared cache. Either the cache doesn't
@@ -166,6 +390,8 @@ DependencyScanningFilesystemSharedCache::CacheShard::
                                 const CachedFileSystemEntry &Entry) {
   std::lock_guard<std::mutex> LockGuard(CacheLock);
   auto [It, Inserted] = CacheByFilename.insert({Filename, {&Entry, nullptr}});
+  if (Inserted && TrackNewFilenames)
+    NewFilenames.push_back(Filename.str());
   auto &[CachedEntry, CachedRealPath] = It->getValue();
   if (!Inserted || !CachedEntry)
     CachedEntry = &Entry;
@@ -186,7 +412,10 @@ const CachedRealPath &DependencyScanningFilesystemSharedCache::CacheShard::
                                     llvm::ErrorOr<llvm::StringRef> RealPath) {
   std::lock_guard<std::mutex> LockGuard(CacheLock);
 
-  const CachedRealPath *&StoredRealPath = CacheByFilename[Filename].second;
+  auto [It, Inserted] = CacheByFilename.insert({Filename, {nullptr, nullptr}});
+  if (Inserted && TrackNewFilenames)
+    NewFilenames.push_back(Filename.str());
+  const CachedRealPath *&StoredRealPath = It->getValue().second;
   if (!StoredRealPath) {
     auto OwnedRealPath = [&]() -> CachedRealPath {
       if (!RealPath)
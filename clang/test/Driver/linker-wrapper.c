@@ -41,6 +41,12 @@ __attribute__((visibility("protected"), used)) int x;
 
 // AMDGPU-LINK: clang{{.*}} -o {{.*}}.img --target=amdgcn-amd-amdhsa -mcpu=gfx908 -O2 -flto -Wl,--no-undefined {{.*}}.o {{.*}}.o
 
+// RUN: clang-linker-wrapper --host-triple=x86_64-unknown-linux-gnu --dry-run \
+// RUN:   --device-lto-partitions=8 --linker-path=/usr/bin/ld %t.o -o a.out 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=AMDGPU-LTO-PARTITIONS
+
+// AMDGPU-LTO-PARTITIONS: clang{{.*}} -o {{.*}}.img --target=amdgcn-amd-amdhsa -mcpu=gfx908 -O2 -flto -Wl,--no-undefined -Wl,--plugin-opt=lto-partitions=8 {{.*}}.o {{.*}}.o
+
 // RUN: clang-offload-packager -o %t.out \
 // RUN:   --image=file=%t.amdgpu.bc,kind=openmp,triple=amdgcn-amd-amdhsa,arch=gfx1030 \
 // RUN:   --image=file=%t.amdgpu.bc,kind=openmp,triple=amdgcn-amd-amdhsa,arch=gfx1030
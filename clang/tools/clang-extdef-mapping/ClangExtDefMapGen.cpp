@@ -22,6 +22,7 @@
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
 #include <optional>
@@ -36,6 +37,12 @@ using namespace clang::tooling;
 static cl::OptionCategory
     ClangExtDefMapGenCategory("clang-extdefmapgen options");
 
+static cl::opt<std::string> BinaryIndexFrom(
+    "binary-index-from",
+    cl::desc("Write the merged textual index <file> in the binary format to "
+             "the standard output, instead of mapping the inputs"),
+    cl::value_desc("file"), cl::cat(ClangExtDefMapGenCategory));
+
 class MapExtDefNamesConsumer : public ASTConsumer {
 public:
   MapExtDefNamesConsumer(ASTContext &Context,
@@ -217,6 +224,18 @@ int main(int argc, const char **argv) {
   }
   CommonOptionsParser &OptionsParser = ExpectedParser.get();
 
+  if (!BinaryIndexFrom.empty()) {
+    llvm::Expected<llvm::StringMap<std::string>> Index =
+        parseCrossTUIndex(BinaryIndexFrom);
+    if (!Index) {
+      llvm::errs() << toString(Index.takeError()) << "\n";
+      return 1;
+    }
+    sys::ChangeStdoutToBinary();
+    llvm::outs() << createCrossTUBinaryIndex(*Index);
+    return 0;
+  }
+
   llvm::InitializeAllTargetInfos();
   llvm::InitializeAllTargetMCs();
   llvm::InitializeAllAsmParsers();
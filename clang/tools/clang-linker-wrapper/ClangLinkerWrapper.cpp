@@ -507,6 +507,14 @@ Expected<StringRef> clang(ArrayRef<StringRef> InputFiles, const ArgList &Args) {
   if (!Triple.isNVPTX())
     CmdArgs.push_back("-Wl,--no-undefined");
 
+  // Let the device linker split the module and code generate the partitions
+  // in parallel. The AMDGPU backend partitions the module by kernel and
+  // duplicates the functions that are shared between the partitions.
+  if (Triple.isAMDGPU() || Triple.isNVPTX())
+    if (const opt::Arg *Arg = Args.getLastArg(OPT_device_lto_partitions_EQ))
+      CmdArgs.push_back(Args.MakeArgString(
+          "-Wl,--plugin-opt=lto-partitions=" + StringRef(Arg->getValue())));
+
   for (StringRef InputFile : InputFiles)
     CmdArgs.push_back(InputFile);
 
@@ -1409,6 +1417,14 @@ int main(int Argc, char **Argv) {
     parallel::strategy = hardware_concurrency(Threads);
   }
 
+  if (auto *Arg = Args.getLastArg(OPT_device_lto_partitions_EQ)) {
+    unsigned Partitions = 0;
+    if (!llvm::to_integer(Arg->getValue(), Partitions) || Partitions == 0)
+      reportError(createStringError("%s: expected a positive integer, got '%s'",
+                                    Arg->getSpelling().data(),
+                                    Arg->getValue()));
+  }
+
   if (Args.hasArg(OPT_wrapper_time_trace_eq)) {
     unsigned Granularity;
     Args.getLastArgValue(OPT_wrapper_time_trace_granularity, "500")
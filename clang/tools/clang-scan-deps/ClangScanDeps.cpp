@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "ScanDepsServer.h"
 #include "clang/Driver/Compilation.h"
 #include "clang/Driver/Driver.h"
 #include "clang/Frontend/CompilerInstance.h"
@@ -18,6 +19,7 @@
 #include "clang/Tooling/Tooling.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/Twine.h"
+#include "llvm/Support/CachePruning.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/Format.h"
@@ -83,6 +85,9 @@ static ScanningOutputFormat Format = ScanningOutputFormat::Make;
 static ScanningOptimizations OptimizeArgs;
 static std::string ModuleFilesDir;
 static bool EagerLoadModules;
+static std::string DirectivesCachePath;
+static std::string ServerSocketPath;
+static llvm::CachePruningPolicy DirectivesCachePolicy;
 static unsigned NumThreads = 0;
 static std::string CompilationDB;
 static std::string ModuleName;
@@ -186,6 +191,23 @@ static void ParseArgs(int argc, char **argv) {
 
   EagerLoadModules = Args.hasArg(OPT_eager_load_pcm);
 
+  if (const llvm::opt::Arg *A = Args.getLastArg(OPT_directives_cache_path_EQ))
+    DirectivesCachePath = A->getValue();
+
+  if (const llvm::opt::Arg *A =
+          Args.getLastArg(OPT_directives_cache_policy_EQ)) {
+    auto Policy = llvm::parseCachePruningPolicy(A->getValue());
+    if (!Policy) {
+      llvm::errs() << ToolName << ": for the --directives-cache-policy option: "
+                   << llvm::toString(Policy.takeError()) << "\n";
+      std::exit(1);
+    }
+    DirectivesCachePolicy = *Policy;
+  }
+
+  if (const llvm::opt::Arg *A = Args.getLastArg(OPT_server_EQ))
+    ServerSocketPath = A->getValue();
+
   if (const llvm::opt::Arg *A = Args.getLastArg(OPT_j)) {
     StringRef S{A->getValue()};
     if (!llvm::to_integer(S, NumThreads, 0)) {
@@ -731,6 +753,11 @@ static std::unique_ptr<tooling::CompilationDatabase>
 getCompilationDatabase(int argc, char **argv, std::string &ErrorMessage) {
   ParseArgs(argc, argv);
 
+  // In server mode, the compilation commands come from the clients.
+  if (!ServerSocketPath.empty() && CommandLine.empty() && CompilationDB.empty())
+    return std::make_unique<tooling::FixedCompilationDatabase>(
+        ".", std::vector<std::string>());
+
   if (!(CommandLine.empty() ^ CompilationDB.empty())) {
     llvm::errs() << "The compilation command line must be provided either via "
                     "'-compilation-database' or after '--'.";
@@ -838,7 +865,7 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
           std::move(Compilations));
   ResourceDirectoryCache ResourceDirCache;
 
-  AdjustingCompilations->appendArgumentsAdjuster(
+  tooling::ArgumentsAdjuster ResourceDirAdjuster =
       [&ResourceDirCache](const tooling::CommandLineArguments &Args,
                           StringRef FileName) {
         std::string LastO;
@@ -900,7 +927,8 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
         }
         AdjustedArgs.insert(AdjustedArgs.end(), FlagsEnd, Args.end());
         return AdjustedArgs;
-      });
+      };
+  AdjustingCompilations->appendArgumentsAdjuster(ResourceDirAdjuster);
 
   SharedStream Errs(llvm::errs());
 
@@ -1048,6 +1076,18 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
 
   DependencyScanningService Service(ScanMode, Format, OptimizeArgs,
                                     EagerLoadModules, /*TraceVFS=*/Verbose);
+  if (!DirectivesCachePath.empty())
+    Service.getSharedCache().setDirectivesCachePath(DirectivesCachePath);
+
+  if (!ServerSocketPath.empty()) {
+    if (Format != ScanningOutputFormat::Make) {
+      llvm::errs() << "clang-scan-deps: --server only supports the make "
+                      "format\n";
+      return 1;
+    }
+    return runScanDepsServer(Service, ResourceDirAdjuster, ServerSocketPath,
+                             NumThreads);
+  }
 
   llvm::Timer T;
   T.startTimer();
@@ -1071,6 +1111,9 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
 
   T.stopTimer();
 
+  if (!DirectivesCachePath.empty())
+    llvm::pruneCache(DirectivesCachePath, DirectivesCachePolicy);
+
   if (Verbose)
     llvm::errs() << "\n*** Virtual File System Stats:\n"
                  << NumStatusCalls << " status() calls\n"
@@ -0,0 +1,297 @@
+//===- ScanDepsServer.cpp - clang-scan-deps server mode -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "ScanDepsServer.h"
+#include "clang/DirectoryWatcher/DirectoryWatcher.h"
+#include "clang/Tooling/DependencyScanning/DependencyScanningTool.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/raw_socket_stream.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace clang;
+using namespace tooling;
+using namespace dependencies;
+
+namespace {
+
+class ScanDepsServer {
+public:
+  ScanDepsServer(DependencyScanningService &Service,
+                 ArgumentsAdjuster Adjuster)
+      : Service(Service), Adjuster(std::move(Adjuster)) {
+    Service.getSharedCache().setTrackNewFilenames(true);
+  }
+
+  /// Answer the requests read from \p Conn until it's closed.
+  void handleConnection(llvm::raw_socket_stream &Conn);
+
+private:
+  /// A tool whose worker was created at some generation of the cache.
+  struct ToolInfo {
+    std::unique_ptr<DependencyScanningTool> Tool;
+    uint64_t Generation;
+  };
+
+  /// Returns the response to the request \p Line.
+  std::string handleRequest(StringRef Line);
+
+  /// Returns an idle tool that is up to date with the cache, or a new one.
+  ToolInfo acquireTool();
+  void releaseTool(ToolInfo Tool);
+
+  /// Drop the cache entries of the files changed in \p Dir.
+  void handleEvents(StringRef Dir, ArrayRef<DirectoryWatcher::Event> Events,
+                    bool IsInitial);
+
+  /// Watch the directories of the files added to the cache since the
+  /// previous call.
+  void watchNewDirectories();
+
+  DependencyScanningService &Service;
+  ArgumentsAdjuster Adjuster;
+
+  /// Bumped whenever cache entries are dropped. The workers created earlier
+  /// aren't reused, as their local caches may still hold the dropped entries.
+  std::atomic<uint64_t> Generation = 0;
+
+  /// Whether some directory couldn't be watched. If so, all the cache entries
+  /// are dropped before every request, and only the directives cache, if
+  /// any, is reused.
+  std::atomic<bool> HasUnwatchedDirectories = false;
+
+  std::mutex ToolsLock;
+  std::vector<ToolInfo> IdleTools;
+
+  std::mutex WatchersLock;
+  /// The watchers of the directories, or null for directories that couldn't
+  /// be watched.
+  llvm::StringMap<std::unique_ptr<DirectoryWatcher>> Watchers;
+
+  /// The directories whose watchers got invalidated, and which need to be
+  /// watched again. Watchers can't be destroyed from their own callbacks.
+  std::mutex InvalidatedLock;
+  std::vector<std::string> InvalidatedDirectories;
+};
+
+} // end anonymous namespace
+
+static std::string getErrorResponse(StringRef Message) {
+  llvm::json::Object Response{{"error", Message}};
+  return llvm::formatv("{0}", llvm::json::Value(std::move(Response)));
+}
+
+void ScanDepsServer::handleConnection(llvm::raw_socket_stream &Conn) {
+  std::string Buffer;
+  char Chunk[4096];
+  for (;;) {
+    ssize_t Read = Conn.read(Chunk, sizeof(Chunk));
+    if (Read <= 0)
+      return;
+    Buffer.append(Chunk, Read);
+
+    size_t Begin = 0;
+    for (size_t End = Buffer.find('\n'); End != std::string::npos;
+         End = Buffer.find('\n', Begin)) {
+      StringRef Line = StringRef(Buffer).slice(Begin, End);
+      Begin = End + 1;
+      if (Line.trim().empty())
+        continue;
+      Conn << handleRequest(Line) << '\n';
+      Conn.flush();
+      if (Conn.has_error()) {
+        Conn.clear_error();
+        return;
+      }
+    }
+    Buffer.erase(0, Begin);
+  }
+}
+
+std::string ScanDepsServer::handleRequest(StringRef Line) {
+  llvm::Expected<llvm::json::Value> Request = llvm::json::parse(Line);
+  if (!Request)
+    return getErrorResponse(llvm::toString(Request.takeError()));
+
+  std::string Directory;
+  std::vector<std::string> Arguments;
+  llvm::json::Path::Root Root;
+  llvm::json::ObjectMapper O(*Request, Root);
+  if (!O || !O.map("directory", Directory) ||
+      !O.map("arguments", Arguments) || Arguments.empty())
+    return getErrorResponse(
+        "expected an object with a 'directory' and 'arguments'");
+
+  if (HasUnwatchedDirectories) {
+    Service.getSharedCache().invalidateAllEntries();
+    ++Generation;
+  }
+
+  ToolInfo Info = acquireTool();
+  llvm::Expected<std::string> Deps = Info.Tool->getDependencyFile(
+      Adjuster(Arguments, /*Filename=*/""), Directory);
+  releaseTool(std::move(Info));
+  watchNewDirectories();
+
+  if (!Deps)
+    return getErrorResponse(llvm::toString(Deps.takeError()));
+  llvm::json::Object Response{{"dependencies", std::move(*Deps)}};
+  return llvm::formatv("{0}", llvm::json::Value(std::move(Response)));
+}
+
+ScanDepsServer::ToolInfo ScanDepsServer::acquireTool() {
+  uint64_t CurrentGeneration = Generation;
+  {
+    std::lock_guard<std::mutex> LockGuard(ToolsLock);
+    while (!IdleTools.empty()) {
+      ToolInfo Info = std::move(IdleTools.back());
+      IdleTools.pop_back();
+      if (Info.Generation == CurrentGeneration)
+        return Info;
+    }
+  }
+  return {std::make_unique<DependencyScanningTool>(Service),
+          CurrentGeneration};
+}
+
+void ScanDepsServer::releaseTool(ToolInfo Info) {
+  if (Info.Generation != Generation)
+    return;
+  std::lock_guard<std::mutex> LockGuard(ToolsLock);
+  IdleTools.push_back(std::move(Info));
+}
+
+void ScanDepsServer::handleEvents(StringRef Dir,
+                                  ArrayRef<DirectoryWatcher::Event> Events,
+                                  bool IsInitial) {
+  // The initial events list the files that were already there.
+  if (IsInitial)
+    return;
+
+  DependencyScanningFilesystemSharedCache &Cache = Service.getSharedCache();
+  for (const DirectoryWatcher::Event &Event : Events) {
+    switch (Event.Kind) {
+    case DirectoryWatcher::Event::EventKind::Removed:
+    case DirectoryWatcher::Event::EventKind::Modified: {
+      SmallString<256> Path(Dir);
+      llvm::sys::path::append(Path, Event.Filename);
+      // A new directory may contain files that are cached as missing.
+      if (llvm::sys::fs::is_directory(Path))
+        Cache.invalidateAllEntries();
+      else
+        Cache.invalidateEntriesForFilename(Path);
+      break;
+    }
+    case DirectoryWatcher::Event::EventKind::WatchedDirRemoved:
+    case DirectoryWatcher::Event::EventKind::WatcherGotInvalidated: {
+      // Events may have been lost, so nothing in the cache can be trusted.
+      Cache.invalidateAllEntries();
+      std::lock_guard<std::mutex> LockGuard(InvalidatedLock);
+      InvalidatedDirectories.push_back(Dir.str());
+      break;
+    }
+    }
+  }
+  ++Generation;
+}
+
+void ScanDepsServer::watchNewDirectories() {
+  DependencyScanningFilesystemSharedCache &Cache = Service.getSharedCache();
+  std::vector<std::string> Invalidated;
+  {
+    std::lock_guard<std::mutex> LockGuard(InvalidatedLock);
+    std::swap(Invalidated, InvalidatedDirectories);
+  }
+
+  std::lock_guard<std::mutex> LockGuard(WatchersLock);
+  for (const std::string &Dir : Invalidated)
+    Watchers.erase(Dir);
+
+  bool InvalidatedEntries = false;
+  llvm::StringSet<> NewlyWatched;
+  for (const std::string &Filename : Cache.takeNewFilenames()) {
+    // Watch the closest existing directory, so that the creation of missing
+    // directories is noticed.
+    StringRef Dir = llvm::sys::path::parent_path(Filename);
+    while (!Dir.empty() && !llvm::sys::fs::is_directory(Dir))
+      Dir = llvm::sys::path::parent_path(Dir);
+    if (Dir.empty())
+      continue;
+
+    auto [It, Inserted] = Watchers.try_emplace(Dir);
+    if (Inserted) {
+      auto Watcher = DirectoryWatcher::create(
+          Dir,
+          [this, Dir = Dir.str()](ArrayRef<DirectoryWatcher::Event> Events,
+                                  bool IsInitial) {
+            handleEvents(Dir, Events, IsInitial);
+          },
+          /*WaitForInitialSync=*/false);
+      if (Watcher) {
+        It->second = std::move(*Watcher);
+        NewlyWatched.insert(Dir);
+      } else {
+        if (!HasUnwatchedDirectories.exchange(true))
+          llvm::errs() << "clang-scan-deps: warning: cannot watch '" << Dir
+                       << "', the cache won't be reused across requests: "
+                       << llvm::toString(Watcher.takeError()) << "\n";
+        else
+          llvm::consumeError(Watcher.takeError());
+      }
+    }
+
+    // The file may have changed after it was read and before its directory
+    // got watched, so read it again the next time.
+    if (NewlyWatched.contains(llvm::sys::path::parent_path(Filename))) {
+      Cache.invalidateEntriesForFilename(Filename);
+      InvalidatedEntries = true;
+    }
+  }
+  if (InvalidatedEntries)
+    ++Generation;
+}
+
+int clang::tooling::dependencies::runScanDepsServer(
+    DependencyScanningService &Service, ArgumentsAdjuster Adjuster,
+    StringRef SocketPath, unsigned NumThreads) {
+  llvm::Expected<llvm::ListeningSocket> Socket =
+      llvm::ListeningSocket::createUnix(SocketPath);
+  if (!Socket) {
+    llvm::errs() << "clang-scan-deps: cannot listen on '" << SocketPath
+                 << "': " << llvm::toString(Socket.takeError()) << "\n";
+    return 1;
+  }
+
+  ScanDepsServer Server(Service, std::move(Adjuster));
+  // Every connection is served by one of the threads of the pool.
+  llvm::DefaultThreadPool Pool(llvm::hardware_concurrency(NumThreads));
+  for (;;) {
+    llvm::Expected<std::unique_ptr<llvm::raw_socket_stream>> Conn =
+        Socket->accept();
+    if (!Conn) {
+      llvm::errs() << "clang-scan-deps: cannot accept connection: "
+                   << llvm::toString(Conn.takeError()) << "\n";
+      break;
+    }
+    std::shared_ptr<llvm::raw_socket_stream> SharedConn = std::move(*Conn);
+    Pool.async(
+        [&Server, SharedConn]() { Server.handleConnection(*SharedConn); });
+  }
+  Pool.wait();
+  return 1;
+}
@@ -0,0 +1,52 @@
+//===- ScanDepsServer.h - clang-scan-deps server mode -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// In server mode, clang-scan-deps keeps running and scans the translation
+// units requested by clients over a UNIX domain socket, so that the caches of
+// the scanning service stay warm between builds.
+//
+// Every request is a JSON object on a single line, with the working directory
+// of the compilation and its command line:
+//
+//   {"directory": "/build", "arguments": ["clang", "-c", "/src/foo.c"]}
+//
+// The server answers every request with a JSON object on a single line, with
+// either the dependencies in the Makefile format or an error message:
+//
+//   {"dependencies": "foo.o: /src/foo.c /src/foo.h\n"}
+//   {"error": "..."}
+//
+// A connection may carry any number of requests, which are answered in order.
+// The directories of the files in the filesystem cache of the service are
+// watched, and the cache entries of files that change are dropped.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_CLANG_SCAN_DEPS_SCANDEPSSERVER_H
+#define LLVM_CLANG_TOOLS_CLANG_SCAN_DEPS_SCANDEPSSERVER_H
+
+#include "clang/Tooling/ArgumentsAdjusters.h"
+#include "clang/Tooling/DependencyScanning/DependencyScanningService.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace clang {
+namespace tooling {
+namespace dependencies {
+
+/// Serve the requests of clients on the socket at \p SocketPath with
+/// \p NumThreads workers, until the server fails. The command lines of the
+/// requests are passed through \p Adjuster. Returns the exit code.
+int runScanDepsServer(DependencyScanningService &Service,
+                      ArgumentsAdjuster Adjuster, StringRef SocketPath,
+                      unsigned NumThreads);
+
+} // end namespace dependencies
+} // end namespace tooling
+} // end namespace clang
+
+#endif // LLVM_CLANG_TOOLS_CLANG_SCAN_DEPS_SCANDEPSSERVER_H
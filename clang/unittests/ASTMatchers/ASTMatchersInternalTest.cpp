@@ -297,6 +297,42 @@ TEST(DynTypedMatcherTest, ConstructWithTraversalKindOverridesNestedTK) {
               llvm::ValueIs(TK_IgnoreUnlessSpelledInSource));
 }
 
+TEST(DynTypedMatcherTest, IdentifierNames) {
+  std::vector<StringRef> Names;
+  EXPECT_FALSE(DynTypedMatcher(functionDecl()).getIdentifierNames(Names));
+  EXPECT_FALSE(
+      DynTypedMatcher(functionDecl(unless(hasName("a")))).getIdentifierNames(
+          Names));
+  EXPECT_FALSE(DynTypedMatcher(functionDecl(anyOf(hasName("a"), isInline())))
+                   .getIdentifierNames(Names));
+  EXPECT_TRUE(Names.empty());
+
+  DynTypedMatcher M =
+      functionDecl(isInline(), hasAnyName("a", "::ns::b")).bind("x");
+  EXPECT_TRUE(M.getIdentifierNames(Names));
+  EXPECT_THAT(Names, testing::ElementsAre("a", "b"));
+
+  Names.clear();
+  EXPECT_TRUE(DynTypedMatcher(namedDecl(anyOf(hasName("a"), hasName("S::c"))))
+                  .getIdentifierNames(Names));
+  EXPECT_THAT(Names, testing::ElementsAre("a", "c"));
+}
+
+TEST(MatchFinder, DispatchesOnIdentifierNames) {
+  const char *Code = R"cpp(
+    void a();
+    namespace ns { void b(); }
+    struct S { void a(); int operator+(int); };
+  )cpp";
+  EXPECT_TRUE(matches(Code, functionDecl(hasName("ns::b"))));
+  EXPECT_TRUE(matches(Code, cxxMethodDecl(hasName("a"))));
+  EXPECT_TRUE(matches(Code, cxxMethodDecl(hasName("operator+"))));
+  EXPECT_TRUE(notMatches(Code, functionDecl(hasName("c"))));
+  EXPECT_TRUE(matchAndVerifyResultTrue(
+      Code, functionDecl(hasAnyName("a", "::ns::b")).bind("f"),
+      std::make_unique<VerifyIdIsBoundTo<FunctionDecl>>("f", 3)));
+}
+
 TEST(IsInlineMatcher, IsInline) {
   EXPECT_TRUE(matches("void g(); inline void f();",
                       functionDecl(isInline(), hasName("f"))));
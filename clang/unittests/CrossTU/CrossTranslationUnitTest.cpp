@@ -178,6 +178,35 @@ TEST(CrossTranslationUnit, IndexFormatCanBeParsed) {
     EXPECT_TRUE(Index.count(E.getKey()));
 }
 
+TEST(CrossTranslationUnit, BinaryIndexCanBeSearched) {
+  llvm::StringMap<std::string> Index;
+  Index["a"] = "/b/f1";
+  Index["c"] = "/d/f2";
+  Index["e"] = "/b/f1";
+  std::string IndexBinary = createCrossTUBinaryIndex(Index);
+  EXPECT_TRUE(CrossTUBinaryIndex::isBinaryIndex(IndexBinary));
+
+  llvm::Expected<CrossTUBinaryIndex> BinaryIndex = CrossTUBinaryIndex::create(
+      llvm::MemoryBuffer::getMemBuffer(IndexBinary, "index",
+                                       /*RequiresNullTerminator=*/false),
+      "index");
+  ASSERT_TRUE((bool)BinaryIndex);
+  EXPECT_EQ(BinaryIndex->size(), 3u);
+  for (const auto &E : Index)
+    EXPECT_EQ(BinaryIndex->lookup(E.getKey()), StringRef(E.getValue()));
+  EXPECT_FALSE(BinaryIndex->lookup("b"));
+  EXPECT_FALSE(BinaryIndex->lookup(""));
+
+  // Truncated indices are rejected.
+  llvm::Expected<CrossTUBinaryIndex> Truncated = CrossTUBinaryIndex::create(
+      llvm::MemoryBuffer::getMemBuffer(StringRef(IndexBinary).take_front(20),
+                                       "index",
+                                       /*RequiresNullTerminator=*/false),
+      "index");
+  EXPECT_FALSE((bool)Truncated);
+  llvm::consumeError(Truncated.takeError());
+}
+
 TEST(CrossTranslationUnit, EmptyInvocationListIsNotValid) {
   auto Input = "";
 
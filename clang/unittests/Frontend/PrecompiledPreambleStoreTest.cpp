@@ -0,0 +1,122 @@
+//===- unittests/Frontend/PrecompiledPreambleStoreTest.cpp ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Frontend/PrecompiledPreamble.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace clang;
+
+namespace {
+
+class PrecompiledPreambleStoreTest : public ::testing::Test {
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("preamble-store", TestDir));
+    StoreDir = TestDir;
+    sys::path::append(StoreDir, "store");
+  }
+
+  void TearDown() override { sys::fs::remove_directories(TestDir); }
+
+public:
+  SmallString<256> TestDir;
+  SmallString<256> StoreDir;
+
+  std::string addFile(StringRef Path, StringRef Contents) {
+    SmallString<256> AbsPath(TestDir);
+    sys::path::append(AbsPath, Path);
+    std::error_code EC;
+    raw_fd_ostream OS(AbsPath, EC);
+    EXPECT_FALSE(EC);
+    OS << Contents;
+    return std::string(AbsPath);
+  }
+
+  std::shared_ptr<CompilerInvocation> createInvocation(StringRef MainFile) {
+    IntrusiveRefCntPtr<vfs::FileSystem> VFS = vfs::createPhysicalFileSystem();
+    CreateInvocationOptions CIOpts;
+    CIOpts.Diags =
+        CompilerInstance::createDiagnostics(*VFS, new DiagnosticOptions());
+    CIOpts.VFS = VFS;
+    std::string MainFileStr = MainFile.str();
+    const char *Args[] = {"clang", "-xc++", MainFileStr.c_str()};
+    return clang::createInvocation(Args, std::move(CIOpts));
+  }
+
+  std::unique_ptr<MemoryBuffer> getFile(StringRef Path) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer =
+        MemoryBuffer::getFile(Path, /*IsText=*/true);
+    EXPECT_TRUE(Buffer);
+    return Buffer ? std::move(*Buffer) : nullptr;
+  }
+};
+
+TEST_F(PrecompiledPreambleStoreTest, PublishAndLoad) {
+  std::string Header = addFile("foo.h", "int foo();\n");
+  std::string MainFile =
+      addFile("main.cpp", "#include \"foo.h\"\nint main() { return foo(); }\n");
+
+  std::shared_ptr<CompilerInvocation> Invocation = createInvocation(MainFile);
+  ASSERT_TRUE(Invocation);
+  std::unique_ptr<MemoryBuffer> Buffer = getFile(MainFile);
+  ASSERT_TRUE(Buffer);
+
+  IntrusiveRefCntPtr<vfs::FileSystem> VFS = vfs::createPhysicalFileSystem();
+  IntrusiveRefCntPtr<DiagnosticsEngine> Diags =
+      CompilerInstance::createDiagnostics(*VFS, new DiagnosticOptions());
+  PreambleBounds Bounds =
+      ComputePreambleBounds(Invocation->getLangOpts(), *Buffer, 0);
+  PreambleCallbacks Callbacks;
+  ErrorOr<PrecompiledPreamble> Built = PrecompiledPreamble::Build(
+      *Invocation, Buffer.get(), Bounds, *Diags, VFS,
+      std::make_shared<PCHContainerOperations>(),
+      /*StoreInMemory=*/false, /*StoragePath=*/TestDir, Callbacks);
+  ASSERT_TRUE(Built);
+
+  // Nothing was published yet.
+  EXPECT_FALSE(PrecompiledPreamble::LoadFromStore(*Invocation, *Buffer, Bounds,
+                                                  *VFS, StoreDir));
+
+  ASSERT_FALSE(Built->Publish(*Invocation, StoreDir));
+  std::optional<PrecompiledPreamble> Loaded =
+      PrecompiledPreamble::LoadFromStore(*Invocation, *Buffer, Bounds, *VFS,
+                                         StoreDir);
+  ASSERT_TRUE(Loaded);
+  EXPECT_EQ(Loaded->getSize(), Built->getSize());
+  EXPECT_TRUE(Loaded->CanReuse(*Invocation, *Buffer, Bounds, *VFS));
+
+  // The main file after the preamble doesn't matter.
+  std::unique_ptr<MemoryBuffer> EditedBuffer = MemoryBuffer::getMemBufferCopy(
+      "#include \"foo.h\"\nint main() { return foo() + 1; }\n", MainFile);
+  PreambleBounds EditedBounds =
+      ComputePreambleBounds(Invocation->getLangOpts(), *EditedBuffer, 0);
+  EXPECT_TRUE(PrecompiledPreamble::LoadFromStore(*Invocation, *EditedBuffer,
+                                                 EditedBounds, *VFS, StoreDir));
+
+  // Other options don't share the entries.
+  std::shared_ptr<CompilerInvocation> OtherInvocation =
+      createInvocation(MainFile);
+  ASSERT_TRUE(OtherInvocation);
+  OtherInvocation->getPreprocessorOpts().addMacroDef("BAR=1");
+  EXPECT_FALSE(PrecompiledPreamble::LoadFromStore(*OtherInvocation, *Buffer,
+                                                  Bounds, *VFS, StoreDir));
+
+  // Neither do the preambles that include a file which changed.
+  addFile("foo.h", "int foo();\nint bar();\n");
+  EXPECT_FALSE(PrecompiledPreamble::LoadFromStore(*Invocation, *Buffer, Bounds,
+                                                  *VFS, StoreDir));
+}
+
+} // namespace
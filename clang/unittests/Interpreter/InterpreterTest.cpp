@@ -41,7 +41,8 @@ class InterpreterTest : public InterpreterTestBase {
 using Args = std::vector<const char *>;
 static std::unique_ptr<Interpreter>
 createInterpreter(const Args &ExtraArgs = {},
-                  DiagnosticConsumer *Client = nullptr) {
+                  DiagnosticConsumer *Client = nullptr,
+                  JITConfig Config = {}) {
   Args ClangArgs = {"-Xclang", "-emit-llvm-only"};
   ClangArgs.insert(ClangArgs.end(), ExtraArgs.begin(), ExtraArgs.end());
   auto CB = clang::IncrementalCompilerBuilder();
@@ -49,7 +50,7 @@ createInterpreter(const Args &ExtraArgs = {},
   auto CI = cantFail(CB.CreateCpp());
   if (Client)
     CI->getDiagnostics().setClient(Client, /*ShouldOwnClient=*/false);
-  return cantFail(clang::Interpreter::create(std::move(CI)));
+  return cantFail(clang::Interpreter::create(std::move(CI), Config));
 }
 
 static size_t DeclsSize(TranslationUnitDecl *PTUDecl) {
@@ -381,6 +382,22 @@ TEST_F(InterpreterTest, Value) {
   EXPECT_TRUE(V9.isManuallyAlloc());
 }
 
+TEST_F(InterpreterTest, LazyCompile) {
+  JITConfig Config;
+  Config.LazyCompile = true;
+  std::unique_ptr<Interpreter> Interp =
+      createInterpreter({}, /*Client=*/nullptr, Config);
+
+  llvm::cantFail(Interp->ParseAndExecute("int f() { return 42; }"));
+  llvm::cantFail(Interp->ParseAndExecute("int g() { return f() + 1; }"));
+  llvm::cantFail(Interp->ParseAndExecute("int x = g();"));
+
+  Value V;
+  llvm::cantFail(Interp->ParseAndExecute("x", &V));
+  EXPECT_TRUE(V.isValid());
+  EXPECT_EQ(V.getInt(), 43);
+}
+
 TEST_F(InterpreterTest, TranslationUnit_CanonicalDecl) {
   std::vector<const char *> Args;
   std::unique_ptr<Interpreter> Interp = createInterpreter(Args);
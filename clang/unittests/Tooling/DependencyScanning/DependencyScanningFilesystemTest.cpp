@@ -9,6 +9,7 @@
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
 #include "gtest/gtest.h"
 
 using namespace clang::tooling::dependencies;
@@ -178,3 +179,82 @@ TEST(DependencyScanningFilesystem, CacheStatFailures) {
   DepFS.exists("/cache/a.pcm");
   EXPECT_EQ(InstrumentingFS->NumStatusCalls, 5u);
 }
+
+TEST(DependencyScanningFilesystem, DirectivesCache) {
+  llvm::unittest::TempDir CacheDir("directives-cache", /*Unique=*/true);
+  llvm::StringRef Source = "#include \"a.h\"\n#define X 1\nint x;\n";
+
+  auto InMemoryFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  InMemoryFS->setCurrentWorkingDirectory("/");
+  InMemoryFS->addFile("/foo.c", 0, llvm::MemoryBuffer::getMemBuffer(Source));
+
+  std::vector<std::pair<unsigned, unsigned>> Scanned;
+  {
+    DependencyScanningFilesystemSharedCache SharedCache;
+    SharedCache.setDirectivesCachePath(CacheDir.path());
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, InMemoryFS);
+    auto Entry = DepFS.getOrCreateFileSystemEntry("/foo.c");
+    ASSERT_TRUE(Entry);
+    ASSERT_TRUE(DepFS.ensureDirectiveTokensArePopulated(*Entry));
+    for (const auto &D : *Entry->getDirectiveTokens())
+      Scanned.emplace_back(D.Kind, D.Tokens.size());
+  }
+
+  // A new cache reads the directives written by the previous one.
+  DependencyScanningFilesystemSharedCache SharedCache;
+  SharedCache.setDirectivesCachePath(CacheDir.path());
+  llvm::SmallVector<clang::dependency_directives_scan::Token> Tokens;
+  llvm::SmallVector<clang::dependency_directives_scan::Directive> Directives;
+  ASSERT_TRUE(SharedCache.readCachedDirectives(Source, Tokens, Directives));
+  std::vector<std::pair<unsigned, unsigned>> Cached;
+  for (const auto &D : Directives)
+    Cached.emplace_back(D.Kind, D.Tokens.size());
+  EXPECT_EQ(Scanned, Cached);
+
+  // Different contents don't hit the entry.
+  Tokens.clear();
+  Directives.clear();
+  EXPECT_FALSE(SharedCache.readCachedDirectives("#define Y 2\n", Tokens,
+                                                Directives));
+}
+
+TEST(DependencyScanningFilesystem, InvalidateEntries) {
+  auto InMemoryFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  InMemoryFS->setCurrentWorkingDirectory("/");
+  InMemoryFS->addFile("/foo.h", 0, llvm::MemoryBuffer::getMemBuffer(""));
+  InMemoryFS->addFile("/bar.h", 0, llvm::MemoryBuffer::getMemBuffer(""));
+
+  auto InstrumentingFS =
+      llvm::makeIntrusiveRefCnt<llvm::vfs::TracingFileSystem>(InMemoryFS);
+
+  DependencyScanningFilesystemSharedCache SharedCache;
+  SharedCache.setTrackNewFilenames(true);
+  {
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, InstrumentingFS);
+    DepFS.status("/foo.h");
+    DepFS.status("/bar.h");
+    EXPECT_EQ(InstrumentingFS->NumStatusCalls, 2u);
+  }
+  std::vector<std::string> NewFilenames = SharedCache.takeNewFilenames();
+  llvm::sort(NewFilenames);
+  EXPECT_EQ(NewFilenames, (std::vector<std::string>{"/bar.h", "/foo.h"}));
+  EXPECT_TRUE(SharedCache.takeNewFilenames().empty());
+
+  SharedCache.invalidateEntriesForFilename("/foo.h");
+  {
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, InstrumentingFS);
+    DepFS.status("/foo.h");
+    EXPECT_EQ(InstrumentingFS->NumStatusCalls, 3u);
+    DepFS.status("/bar.h");
+    EXPECT_EQ(InstrumentingFS->NumStatusCalls, 3u); // Still cached.
+  }
+  EXPECT_EQ(SharedCache.takeNewFilenames(),
+            std::vector<std::string>{"/foo.h"});
+
+  SharedCache.invalidateAllEntries();
+  {
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, InstrumentingFS);
+    DepFS.status("/bar.h");
+    EXPECT_EQ(InstrumentingFS->NumStatusCalls, 4u);
+  }
+}
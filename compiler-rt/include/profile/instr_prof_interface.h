@@ -15,10 +15,17 @@
 #ifndef COMPILER_RT_INSTR_PROFILING
 #define COMPILER_RT_INSTR_PROFILING
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* The type of the sink of the profile snapshots, see
+ * __llvm_profile_set_snapshot_sink. */
+typedef int (*__llvm_profile_snapshot_sink)(const char *Data, size_t Size,
+                                            void *Ctx);
+
 #ifdef __LLVM_INSTR_PROFILE_GENERATE
 // Profile file reset and dump interfaces.
 // When `-fprofile[-instr]-generate`/`-fcs-profile-generate` is in effect,
@@ -76,12 +83,56 @@ int __llvm_profile_dump(void);
 // Interface to dump the current process' order file to disk.
 int __llvm_orderfile_dump(void);
 
+/*!
+ * \brief Set the sink which receives the profile snapshots.
+ *
+ * \c Sink is called by \ref __llvm_profile_snapshot with the snapshot, which
+ * is a raw profile holding the counts accumulated since the previous
+ * snapshot, and with \c Ctx. It returns 0 on success.
+ */
+void __llvm_profile_set_snapshot_sink(__llvm_profile_snapshot_sink Sink,
+                                      void *Ctx);
+
+/*!
+ * \brief Send the profile snapshots to the UNIX domain socket at \c Path.
+ *
+ * For every snapshot, a new connection is made, on which the size of the
+ * snapshot is sent as a 64-bit integer in host byte order followed by the
+ * snapshot itself. Returns 0 on success, or -1 if sockets aren't supported.
+ */
+int __llvm_profile_set_snapshot_socket(const char *Path);
+
+/*!
+ * \brief Take a profile snapshot and pass it to the snapshot sink.
+ *
+ * The snapshots of a process can be merged with llvm-profdata to get the
+ * profile of the process up to the last snapshot. This doesn't change the
+ * profile written at exit, which holds all the counts of the process, so a
+ * process whose snapshots are collected shouldn't also write a profile file.
+ * Returns 0 on success, or -1 if there is no sink or a concurrent snapshot
+ * is being taken.
+ */
+int __llvm_profile_snapshot(void);
+
+/*!
+ * \brief Start a thread which takes a profile snapshot every
+ * \c IntervalSeconds seconds.
+ *
+ * The snapshot sink must be set first. Returns 0 on success, or -1 if the
+ * thread is already running or can't be started.
+ */
+int __llvm_profile_start_snapshots(unsigned IntervalSeconds);
+
 #else
 
 #define __llvm_profile_set_filename(Name)
 #define __llvm_profile_reset_counters()
 #define __llvm_profile_dump() (0)
 #define __llvm_orderfile_dump() (0)
+#define __llvm_profile_set_snapshot_sink(Sink, Ctx)
+#define __llvm_profile_set_snapshot_socket(Path) (-1)
+#define __llvm_profile_snapshot() (-1)
+#define __llvm_profile_start_snapshots(IntervalSeconds) (-1)
 
 #endif
 
@@ -352,6 +352,40 @@ void __xray_log_remove_buffer_iterator();
 XRayLogFlushStatus __xray_log_process_buffers(void (*Processor)(const char *,
                                                                 XRayBuffer));
 
+/// Registers a streamer function, which hands the buffers the logging
+/// implementation has completed so far to |Processor| (along with |Mode|)
+/// while logging continues, then reuses them. The streamer returns the number
+/// of buffers it handed out, and must hand out each buffer at most once.
+void __xray_log_set_buffer_streamer(
+    size_t (*Streamer)(const char *Mode,
+                       void (*Processor)(const char *, XRayBuffer)));
+
+/// Removes the currently registered buffer streamer function.
+void __xray_log_remove_buffer_streamer();
+
+/// Invokes the provided handler on the data the logging implementation has
+/// completed since the previous call, without finalizing it. Unlike
+/// `__xray_log_process_buffers(...)`, this may be called periodically while
+/// the program is being traced, e.g. to drain the buffers to a file or socket
+/// so that a long-running trace needs a bounded amount of memory. Data handed
+/// to |Processor| is not part of the log flushed afterwards. The XRayBuffers
+/// of a call are meant to be appended to the data of the previous calls.
+///
+/// The same requirements as for `__xray_log_process_buffers(...)` apply to the
+/// callback function, which must also not call back into XRay. The buffers of
+/// the threads that are still writing to them are only handed out once they
+/// have been released. This function must not be called concurrently with
+/// itself, nor with the initialization or flushing of the implementation.
+///
+/// Implementations MUST register a streamer function through
+/// `__xray_log_set_buffer_streamer(...)` to support this.
+///
+/// Returns XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING if there is no installed
+/// implementation or streamer, XRayLogFlushStatus::XRAY_LOG_FLUSHED otherwise.
+///
+XRayLogFlushStatus __xray_log_stream_buffers(void (*Processor)(const char *,
+                                                               XRayBuffer));
+
 } // extern "C"
 
 #endif // XRAY_XRAY_LOG_INTERFACE_H
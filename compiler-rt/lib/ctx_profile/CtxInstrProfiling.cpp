@@ -27,6 +27,22 @@ __sanitizer::SpinMutex AllContextsMutex;
 SANITIZER_GUARDED_BY(AllContextsMutex)
 __sanitizer::Vector<ContextRoot *> AllContextRoots;
 
+// The number of context trees collected for each root, see
+// __llvm_ctx_profile_set_trees_per_root.
+uint32_t TreesPerRoot = 1;
+
+// The trees of a root besides the one in the root itself. They are
+// ContextRoots too, so collecting into any of them works the same way.
+struct ExtraTreeList {
+  ContextRoot *Trees = nullptr;
+  uint32_t Size = 0;
+};
+
+// Only looked up by a thread entering a root whose own tree is taken.
+__sanitizer::SpinMutex ExtraTreesMutex;
+SANITIZER_GUARDED_BY(ExtraTreesMutex)
+__sanitizer::DenseMap<ContextRoot *, ExtraTreeList> ExtraTrees;
+
 // utility to taint a pointer by setting the LSB. There is an assumption
 // throughout that the addresses of contexts are even (really, they should be
 // align(8), but "even"-ness is the minimum assumption)
@@ -111,6 +127,14 @@ void resetContextNode(ContextNode &Node) {
 
 void onContextEnter(ContextNode &Node) { ++Node.counters()[0]; }
 
+ExtraTreeList getExtraTrees(ContextRoot *Root) {
+  __sanitizer::GenericScopedLock<__sanitizer::SpinMutex> Lock(
+      &ExtraTreesMutex);
+  if (auto *It = ExtraTrees.find(Root))
+    return It->second;
+  return ExtraTreeList();
+}
+
 } // namespace
 
 // the scratch buffer - what we give when we can't produce a real context (the
@@ -160,19 +184,19 @@ void Arena::freeArenaList(Arena *&A) {
 }
 
 // If this is the first time we hit a callsite with this (Guid) particular
-// callee, we need to allocate.
-ContextNode *getCallsiteSlow(GUID Guid, ContextNode **InsertionPoint,
-                             uint32_t NumCounters, uint32_t NumCallsites) {
+// callee, we need to allocate, in the arenas of the context tree \p Tree.
+ContextNode *getCallsiteSlow(ContextRoot *Tree, GUID Guid,
+                             ContextNode **InsertionPoint, uint32_t NumCounters,
+                             uint32_t NumCallsites) {
   auto AllocSize = ContextNode::getAllocSize(NumCounters, NumCallsites);
-  auto *Mem = __llvm_ctx_profile_current_context_root->CurrentMem;
+  auto *Mem = Tree->CurrentMem;
   char *AllocPlace = Mem->tryBumpAllocate(AllocSize);
   if (!AllocPlace) {
     // if we failed to allocate on the current arena, allocate a new arena,
-    // and place it on __llvm_ctx_profile_current_context_root->CurrentMem so we
-    // find it from now on for other cases when we need to getCallsiteSlow.
-    // Note that allocateNewArena will link the allocated memory in the list of
-    // Arenas.
-    __llvm_ctx_profile_current_context_root->CurrentMem = Mem =
+    // and place it on Tree->CurrentMem so we find it from now on for other
+    // cases when we need to getCallsiteSlow. Note that allocateNewArena will
+    // link the allocated memory in the list of Arenas.
+    Tree->CurrentMem = Mem =
         Mem->allocateNewArena(getArenaAllocSize(AllocSize), Mem);
     AllocPlace = Mem->tryBumpAllocate(AllocSize);
   }
@@ -223,8 +247,9 @@ ContextNode *__llvm_ctx_profile_get_context(void *Callee, GUID Guid,
     Callsite = Callsite->next();
   }
   auto *Ret = Callsite ? Callsite
-                       : getCallsiteSlow(Guid, CallsiteContext, NumCounters,
-                                         NumCallsites);
+                       : getCallsiteSlow(
+                             __llvm_ctx_profile_current_context_root, Guid,
+                             CallsiteContext, NumCounters, NumCallsites);
   if (Ret->callsites_size() != NumCallsites ||
       Ret->counters_size() != NumCounters)
     __sanitizer::Printf("[ctxprof] Returned ctx differs from what's asked: "
@@ -236,8 +261,19 @@ ContextNode *__llvm_ctx_profile_get_context(void *Callee, GUID Guid,
   return Ret;
 }
 
-// This should be called once for a Root. Allocate the first arena, set up the
-// first context.
+// Allocate the first arena of a context tree and set up its first context.
+void setupTree(ContextRoot *Tree, GUID Guid, uint32_t NumCounters,
+               uint32_t NumCallsites) {
+  const auto Needed = ContextNode::getAllocSize(NumCounters, NumCallsites);
+  auto *M = Arena::allocateNewArena(getArenaAllocSize(Needed));
+  Tree->FirstMemBlock = M;
+  Tree->CurrentMem = M;
+  Tree->FirstNode = allocContextNode(M->tryBumpAllocate(Needed), Guid,
+                                     NumCounters, NumCallsites);
+}
+
+// This should be called once for a Root. Set up its own tree, and make room
+// for its other trees, which are set up when first taken.
 void setupContext(ContextRoot *Root, GUID Guid, uint32_t NumCounters,
                   uint32_t NumCallsites) {
   __sanitizer::GenericScopedLock<__sanitizer::SpinMutex> Lock(
@@ -245,13 +281,60 @@ void setupContext(ContextRoot *Root, GUID Guid, uint32_t NumCounters,
   // Re-check - we got here without having had taken a lock.
   if (Root->FirstMemBlock)
     return;
-  const auto Needed = ContextNode::getAllocSize(NumCounters, NumCallsites);
-  auto *M = Arena::allocateNewArena(getArenaAllocSize(Needed));
-  Root->FirstMemBlock = M;
-  Root->CurrentMem = M;
-  Root->FirstNode = allocContextNode(M->tryBumpAllocate(Needed), Guid,
-                                     NumCounters, NumCallsites);
+  setupTree(Root, Guid, NumCounters, NumCallsites);
   AllContextRoots.PushBack(Root);
+
+  if (TreesPerRoot <= 1)
+    return;
+  ExtraTreeList List;
+  List.Size = TreesPerRoot - 1;
+  List.Trees = reinterpret_cast<ContextRoot *>(
+      __sanitizer::InternalAlloc(List.Size * sizeof(ContextRoot)));
+  __sanitizer::internal_memset(List.Trees, 0, List.Size * sizeof(ContextRoot));
+  __sanitizer::GenericScopedLock<__sanitizer::SpinMutex> TreesLock(
+      &ExtraTreesMutex);
+  ExtraTrees.insert({Root, List});
+}
+
+// Take one of the other trees of Root, if any is free. Each tree has arenas of
+// its own, so the threads collecting into the trees of a root don't share
+// anything until the trees are merged by __llvm_ctx_profile_fetch.
+ContextRoot *tryTakeExtraTree(ContextRoot *Root, GUID Guid,
+                              uint32_t NumCounters, uint32_t NumCallsites)
+    SANITIZER_NO_THREAD_SAFETY_ANALYSIS {
+  if (TreesPerRoot <= 1)
+    return nullptr;
+  const ExtraTreeList List = getExtraTrees(Root);
+  for (uint32_t I = 0; I < List.Size; ++I) {
+    auto *Tree = &List.Trees[I];
+    if (!Tree->Taken.TryLock())
+      continue;
+    if (!Tree->FirstMemBlock)
+      setupTree(Tree, Guid, NumCounters, NumCallsites);
+    return Tree;
+  }
+  return nullptr;
+}
+
+// Add the counters of From to those of To, allocating the subcontexts which To
+// doesn't have yet in the arenas of ToTree.
+void mergeContextNode(ContextNode &To, const ContextNode &From,
+                      ContextRoot *ToTree) {
+  if (To.counters_size() != From.counters_size() ||
+      To.callsites_size() != From.callsites_size())
+    return;
+  for (uint32_t I = 0; I < From.counters_size(); ++I)
+    To.counters()[I] += From.counters()[I];
+  for (uint32_t I = 0; I < From.callsites_size(); ++I)
+    for (auto *Sub = From.subContexts()[I]; Sub; Sub = Sub->next()) {
+      auto *Target = To.subContexts()[I];
+      while (Target && Target->guid() != Sub->guid())
+        Target = Target->next();
+      if (!Target)
+        Target = getCallsiteSlow(ToTree, Sub->guid(), &To.subContexts()[I],
+                                 Sub->counters_size(), Sub->callsites_size());
+      mergeContextNode(*Target, *Sub, ToTree);
+    }
 }
 
 ContextNode *__llvm_ctx_profile_start_context(
@@ -260,24 +343,32 @@ ContextNode *__llvm_ctx_profile_start_context(
   if (!Root->FirstMemBlock) {
     setupContext(Root, Guid, Counters, Callsites);
   }
-  if (Root->Taken.TryLock()) {
-    __llvm_ctx_profile_current_context_root = Root;
-    onContextEnter(*Root->FirstNode);
-    return Root->FirstNode;
+  ContextRoot *Tree = Root;
+  if (!Root->Taken.TryLock())
+    Tree = tryTakeExtraTree(Root, Guid, Counters, Callsites);
+  if (Tree) {
+    __llvm_ctx_profile_current_context_root = Tree;
+    onContextEnter(*Tree->FirstNode);
+    return Tree->FirstNode;
   }
-  // If this thread couldn't take the lock, return scratch context.
+  // If this thread couldn't take any tree, return scratch context.
   __llvm_ctx_profile_current_context_root = nullptr;
   return TheScratchContext;
 }
 
 void __llvm_ctx_profile_release_context(ContextRoot *Root)
     SANITIZER_NO_THREAD_SAFETY_ANALYSIS {
-  if (__llvm_ctx_profile_current_context_root) {
+  // The thread may have collected into another tree than Root's own.
+  if (auto *Tree = __llvm_ctx_profile_current_context_root) {
     __llvm_ctx_profile_current_context_root = nullptr;
-    Root->Taken.Unlock();
+    Tree->Taken.Unlock();
   }
 }
 
+void __llvm_ctx_profile_set_trees_per_root(uint32_t N) {
+  TreesPerRoot = N ? N : 1;
+}
+
 void __llvm_ctx_profile_start_collection() {
   size_t NumMemUnits = 0;
   __sanitizer::GenericScopedLock<__sanitizer::SpinMutex> Lock(
@@ -290,6 +381,15 @@ void __llvm_ctx_profile_start_collection() {
       ++NumMemUnits;
 
     resetContextNode(*Root->FirstNode);
+
+    const ExtraTreeList List = getExtraTrees(Root);
+    for (uint32_t J = 0; J < List.Size; ++J) {
+      auto *Tree = &List.Trees[J];
+      __sanitizer::GenericScopedLock<__sanitizer::StaticSpinMutex> TreeLock(
+          &Tree->Taken);
+      if (Tree->FirstNode)
+        resetContextNode(*Tree->FirstNode);
+    }
   }
   __sanitizer::Printf("[ctxprof] Initial NumMemUnits: %zu \n", NumMemUnits);
 }
@@ -304,6 +404,18 @@ bool __llvm_ctx_profile_fetch(void *Data,
     auto *Root = AllContextRoots[I];
     __sanitizer::GenericScopedLock<__sanitizer::StaticSpinMutex> TakenLock(
         &Root->Taken);
+    // Fold the other trees of the root into its own tree. Their counters are
+    // reset, so that they are only added once.
+    const ExtraTreeList List = getExtraTrees(Root);
+    for (uint32_t J = 0; J < List.Size; ++J) {
+      auto *Tree = &List.Trees[J];
+      __sanitizer::GenericScopedLock<__sanitizer::StaticSpinMutex> TreeLock(
+          &Tree->Taken);
+      if (!Tree->FirstNode)
+        continue;
+      mergeContextNode(*Root->FirstNode, *Tree->FirstNode, Root);
+      resetContextNode(*Tree->FirstNode);
+    }
     if (!validate(Root)) {
       __sanitizer::Printf("[ctxprof] Contextual Profile is %s\n", "invalid");
       return false;
@@ -317,11 +429,22 @@ bool __llvm_ctx_profile_fetch(void *Data,
 void __llvm_ctx_profile_free() {
   __sanitizer::GenericScopedLock<__sanitizer::SpinMutex> Lock(
       &AllContextsMutex);
-  for (int I = 0, E = AllContextRoots.Size(); I < E; ++I)
-    for (auto *A = AllContextRoots[I]->FirstMemBlock; A;) {
+  for (int I = 0, E = AllContextRoots.Size(); I < E; ++I) {
+    auto *Root = AllContextRoots[I];
+    const ExtraTreeList List = getExtraTrees(Root);
+    for (uint32_t J = 0; J < List.Size; ++J)
+      if (List.Trees[J].FirstMemBlock)
+        Arena::freeArenaList(List.Trees[J].FirstMemBlock);
+    if (List.Trees)
+      __sanitizer::InternalFree(List.Trees);
+    for (auto *A = Root->FirstMemBlock; A;) {
       auto *C = A;
       A = A->next();
       __sanitizer::InternalFree(C);
     }
+  }
   AllContextRoots.Reset();
+  __sanitizer::GenericScopedLock<__sanitizer::SpinMutex> TreesLock(
+      &ExtraTreesMutex);
+  ExtraTrees.clear();
 }
@@ -97,14 +97,14 @@ struct ContextRoot {
   // subcontexts, and is captured by tainting the pointer value (pointer to the
   // memory treated as context), but right now, we drop that info.
   //
-  // We could consider relaxing the requirement of more than one thread
-  // entering by holding a few context trees per entrypoint and then aggregating
-  // them (as explained above) at the end of the profile collection - it's a
-  // tradeoff between collection time and memory use: higher precision can be
-  // obtained with either less concurrent collections but more collection time,
-  // or with more concurrent collections (==more memory) and less collection
-  // time. Note that concurrent collection does happen for different
-  // entrypoints, regardless.
+  // More than one thread may collect for the same entrypoint by holding a few
+  // context trees per entrypoint (see __llvm_ctx_profile_set_trees_per_root),
+  // which are aggregated (as explained above) when the profile is fetched -
+  // it's a tradeoff between collection time and memory use: higher precision
+  // can be obtained with either less concurrent collections but more
+  // collection time, or with more concurrent collections (==more memory) and
+  // less collection time. Note that concurrent collection does happen for
+  // different entrypoints, regardless.
   ::__sanitizer::StaticSpinMutex Taken;
 
   // If (unlikely) StaticSpinMutex internals change, we need to modify the LLVM
@@ -163,6 +163,12 @@ void __llvm_ctx_profile_start_collection();
 /// Completely free allocated memory.
 void __llvm_ctx_profile_free();
 
+/// Collect up to N context trees for each root, so that up to N threads can
+/// enter the same root at a time without getting a scratch context. The trees
+/// of a root are merged when the profile is fetched. This must be called
+/// before any root is entered. The default is 1.
+void __llvm_ctx_profile_set_trees_per_root(uint32_t N);
+
 /// Used to obtain the profile. The Writer is called for each root ContextNode,
 /// with the ContextRoot::Taken taken. The Writer is responsible for traversing
 /// the structure underneath.
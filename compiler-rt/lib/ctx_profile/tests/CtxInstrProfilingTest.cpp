@@ -170,6 +170,53 @@ TEST_F(ContextTest, ConcurrentRootCollection) {
   EXPECT_EQ(Executions, 2);
 }
 
+TEST_F(ContextTest, ConcurrentRootCollectionWithTrees) {
+  __llvm_ctx_profile_set_trees_per_root(2);
+  std::atomic<int> NonScratch = 0;
+  int FakeCalleeAddress = 0;
+
+  __sanitizer::Semaphore GotCtx;
+  __sanitizer::Semaphore Done;
+  auto Entrypoint = [&]() {
+    auto *Ctx = __llvm_ctx_profile_start_context(&Root, 1, 10, 4);
+    NonScratch += !isScratch(Ctx);
+    __llvm_ctx_profile_expected_callee[0] = &FakeCalleeAddress;
+    __llvm_ctx_profile_callsite[0] = &Ctx->subContexts()[2];
+    __llvm_ctx_profile_get_context(&FakeCalleeAddress, 2, 3, 1);
+    // Keep both trees taken until both threads entered the root.
+    GotCtx.Post();
+    Done.Wait();
+    __llvm_ctx_profile_release_context(&Root);
+  };
+  std::thread T1(Entrypoint);
+  std::thread T2(Entrypoint);
+  GotCtx.Wait();
+  GotCtx.Wait();
+  Done.Post(2);
+  T1.join();
+  T2.join();
+  EXPECT_EQ(NonScratch, 2);
+
+  // The second tree is merged into the root's own tree.
+  uint64_t Entries = 0, SubEntries = 0;
+  struct Counts {
+    uint64_t &Entries;
+    uint64_t &SubEntries;
+  } C{Entries, SubEntries};
+  EXPECT_TRUE(__llvm_ctx_profile_fetch(
+      &C, [](void *Data, const ContextNode &Node) -> bool {
+        auto &C = *reinterpret_cast<Counts *>(Data);
+        C.Entries = Node.counters()[0];
+        EXPECT_NE(Node.subContexts()[2], nullptr);
+        EXPECT_EQ(Node.subContexts()[2]->next(), nullptr);
+        C.SubEntries = Node.subContexts()[2]->counters()[0];
+        return true;
+      }));
+  EXPECT_EQ(Entries, 2U);
+  EXPECT_EQ(SubEntries, 2U);
+  __llvm_ctx_profile_set_trees_per_root(1);
+}
+
 TEST_F(ContextTest, Dump) {
   auto *Ctx = __llvm_ctx_profile_start_context(&Root, 1, 10, 4);
   int FakeCalleeAddress = 0;
@@ -767,6 +767,8 @@ int FuzzerDriver(int *argc, char ***argv, UserCallback Callback) {
     Options.FeaturesDir = Flags.features_dir;
     ValidateDirectoryExists(Options.FeaturesDir, Flags.create_missing_dirs);
   }
+  if (Flags.shared_features_file)
+    Options.SharedFeaturesFile = Flags.shared_features_file;
   if (Flags.mutation_graph_file)
     Options.MutationGraphFile = Flags.mutation_graph_file;
   if (Flags.collect_data_flow)
@@ -874,6 +876,7 @@ int FuzzerDriver(int *argc, char ***argv, UserCallback Callback) {
   }
 
   Options.ForkCorpusGroups = Flags.fork_corpus_groups;
+  Options.ForkSharedFeatures = Flags.fork_shared_features;
   if (Flags.fork)
     FuzzWithFork(F->GetMD().GetRand(), Options, Args, *Inputs, Flags.fork);
 
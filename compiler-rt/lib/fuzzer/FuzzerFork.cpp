@@ -29,6 +29,27 @@
 
 namespace fuzzer {
 
+bool SharedFeatureSet::Map(const std::string &Path) {
+  Unmap();
+  Words = static_cast<std::atomic<uint64_t> *>(
+      MapSharedFile(Path, kSizeInBytes));
+  return IsMapped();
+}
+
+void SharedFeatureSet::Unmap() {
+  if (!IsMapped())
+    return;
+  UnmapSharedFile(Words, kSizeInBytes);
+  Words = nullptr;
+}
+
+bool SharedFeatureSet::InsertOne(uint32_t Feature) {
+  Feature %= kNumFeatures;
+  uint64_t Mask = 1ULL << (Feature % 64);
+  return !(Words[Feature / 64].fetch_or(Mask, std::memory_order_relaxed) &
+           Mask);
+}
+
 struct Stats {
   size_t number_of_executed_units = 0;
   size_t peak_rss_mb = 0;
@@ -96,6 +117,8 @@ struct GlobalEnv {
   std::set<std::string> FilesWithDFT;
   std::vector<std::string> Files;
   std::vector<std::size_t> FilesSizes;
+  std::string SharedFeaturesPath;
+  SharedFeatureSet SharedFeatures;
   Random *Rand;
   std::chrono::system_clock::time_point ProcessStartTime;
   int Verbosity = 0;
@@ -129,6 +152,8 @@ struct GlobalEnv {
     Cmd.addFlag("print_funcs", "0");  // no need to spend time symbolizing.
     Cmd.addFlag("max_total_time", std::to_string(std::min((size_t)300, JobId)));
     Cmd.addFlag("stop_file", StopFile());
+    if (SharedFeatures.IsMapped())
+      Cmd.addFlag("shared_features_file", SharedFeaturesPath);
     if (!DataFlowBinary.empty()) {
       Cmd.addFlag("data_flow_trace", DFTDir);
       if (!Cmd.hasFlag("focus_function"))
@@ -251,6 +276,7 @@ struct GlobalEnv {
       }
     }
     Features.insert(NewFeatures.begin(), NewFeatures.end());
+    SharedFeatures.Insert(NewFeatures);
     Cov.insert(NewCov.begin(), NewCov.end());
     for (auto Idx : NewCov)
       if (auto *TE = TPC.PCTableEntryByIdx(Idx))
@@ -358,6 +384,15 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
       Env.FilesSizes.push_back(FileSize(path));
   }
 
+  if (Options.ForkSharedFeatures) {
+    Env.SharedFeaturesPath = DirPlusFile(Env.TempDir, "features.shm");
+    if (Env.SharedFeatures.Map(Env.SharedFeaturesPath))
+      Env.SharedFeatures.Insert(Env.Features);
+    else
+      Printf("WARNING: -fork_shared_features: failed to map %s\n",
+             Env.SharedFeaturesPath.c_str());
+  }
+
   Printf("INFO: -fork=%d: %zd seed inputs, starting to fuzz in %s\n", NumJobs,
          Env.Files.size(), Env.TempDir.c_str());
 
@@ -483,6 +518,7 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
 
   // The workers have terminated. Don't try to remove the directory before they
   // terminate to avoid a race condition preventing cleanup on Windows.
+  Env.SharedFeatures.Unmap();
   RmDirRecursive(Env.TempDir);
 
   // Use the exit code from the last child process.
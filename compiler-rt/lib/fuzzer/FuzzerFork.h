@@ -13,9 +13,48 @@
 #include "FuzzerOptions.h"
 #include "FuzzerRandom.h"
 
+#include <atomic>
 #include <string>
 
 namespace fuzzer {
+
+// The set of features found by the jobs of -fork, shared by the parent and the
+// jobs through a memory-mapped file. It lets a job know at once whether
+// another job already found a feature, instead of after the next merge.
+class SharedFeatureSet {
+ public:
+  // Same as InputCorpus::kFeatureSetSize.
+  static const size_t kNumFeatures = 1 << 21;
+  static const size_t kSizeInBytes = kNumFeatures / 8;
+
+  SharedFeatureSet() = default;
+  SharedFeatureSet(const SharedFeatureSet &) = delete;
+  SharedFeatureSet &operator=(const SharedFeatureSet &) = delete;
+  ~SharedFeatureSet() { Unmap(); }
+
+  // Maps the set stored in Path, creating it if needed. Returns false if the
+  // file can't be mapped, in which case the set stays empty and unmapped.
+  bool Map(const std::string &Path);
+  void Unmap();
+  bool IsMapped() const { return Words != nullptr; }
+
+  // Adds Features to the set. Returns true if one of them wasn't in it yet,
+  // or if the set isn't mapped.
+  template <class Container> bool Insert(const Container &Features) {
+    if (!IsMapped())
+      return true;
+    bool FoundNew = false;
+    for (uint32_t Ft : Features)
+      FoundNew |= InsertOne(Ft);
+    return FoundNew;
+  }
+
+ private:
+  bool InsertOne(uint32_t Feature);
+
+  std::atomic<uint64_t> *Words = nullptr;
+};
+
 void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
                   const std::vector<std::string> &Args,
                   const std::vector<std::string> &CorpusDirs, int NumJobs);
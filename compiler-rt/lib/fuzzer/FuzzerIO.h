@@ -111,6 +111,12 @@ intptr_t GetHandleFromFd(int fd);
 void MkDir(const std::string &Path);
 void RmDir(const std::string &Path);
 
+// Maps the first Size bytes of the file at Path in memory, creating the file
+// or extending it with zeros if needed. The processes mapping the same file
+// share the memory. Returns nullptr on failure.
+void *MapSharedFile(const std::string &Path, size_t Size);
+void UnmapSharedFile(void *Mem, size_t Size);
+
 const std::string &getDevNull();
 
 }  // namespace fuzzer
@@ -15,9 +15,11 @@
 #include <cstdarg>
 #include <cstdio>
 #include <dirent.h>
+#include <fcntl.h>
 #include <fstream>
 #include <iterator>
 #include <libgen.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -131,6 +133,25 @@ intptr_t GetHandleFromFd(int fd) {
   return static_cast<intptr_t>(fd);
 }
 
+void *MapSharedFile(const std::string &Path, size_t Size) {
+  int Fd = open(Path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (Fd < 0)
+    return nullptr;
+  void *Mem = nullptr;
+  struct stat St;
+  // Only extend the file: another process may have mapped it already.
+  if (!fstat(Fd, &St) &&
+      (static_cast<size_t>(St.st_size) >= Size || !ftruncate(Fd, Size))) {
+    Mem = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+    if (Mem == MAP_FAILED)
+      Mem = nullptr;
+  }
+  close(Fd);
+  return Mem;
+}
+
+void UnmapSharedFile(void *Mem, size_t Size) { munmap(Mem, Size); }
+
 std::string DirName(const std::string &FileName) {
   char *Tmp = new char[FileName.size() + 1];
   memcpy(Tmp, FileName.c_str(), FileName.size() + 1);
@@ -238,6 +238,28 @@ intptr_t GetHandleFromFd(int fd) {
   return _get_osfhandle(fd);
 }
 
+void *MapSharedFile(const std::string &Path, size_t Size) {
+  HANDLE File = CreateFileA(Path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (File == INVALID_HANDLE_VALUE)
+    return nullptr;
+  // The mapping extends the file if it is smaller than Size.
+  uint64_t Size64 = Size;
+  HANDLE Mapping =
+      CreateFileMappingA(File, NULL, PAGE_READWRITE,
+                         static_cast<DWORD>(Size64 >> 32),
+                         static_cast<DWORD>(Size64), NULL);
+  CloseHandle(File);
+  if (!Mapping)
+    return nullptr;
+  void *Mem = MapViewOfFile(Mapping, FILE_MAP_ALL_ACCESS, 0, 0, Size);
+  CloseHandle(Mapping);
+  return Mem;
+}
+
+void UnmapSharedFile(void *Mem, size_t Size) { UnmapViewOfFile(Mem); }
+
 bool IsSeparator(char C) {
   return C == '\\' || C == '/';
 }
@@ -14,6 +14,7 @@
 #include "FuzzerDataFlowTrace.h"
 #include "FuzzerDefs.h"
 #include "FuzzerExtFunctions.h"
+#include "FuzzerFork.h"
 #include "FuzzerInterface.h"
 #include "FuzzerOptions.h"
 #include "FuzzerSHA1.h"
@@ -135,6 +136,7 @@ private:
   MutationDispatcher &MD;
   FuzzingOptions Options;
   DataFlowTrace DFT;
+  SharedFeatureSet SharedFeatures;
 
   system_clock::time_point ProcessStartTime = system_clock::now();
   system_clock::time_point UnitStartTime, UnitStopTime;
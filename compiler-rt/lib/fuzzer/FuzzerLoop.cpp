@@ -153,6 +153,9 @@ Fuzzer::Fuzzer(UserCallback CB, InputCorpus &Corpus, MutationDispatcher &MD,
     TPC.PrintModuleInfo();
   if (!Options.OutputCorpus.empty() && Options.ReloadIntervalSec)
     EpochOfLastReadOfOutputCorpus = GetEpoch(Options.OutputCorpus);
+  if (!Options.SharedFeaturesFile.empty() &&
+      !SharedFeatures.Map(Options.SharedFeaturesFile))
+    Printf("WARNING: failed to map %s\n", Options.SharedFeaturesFile.c_str());
   MaxInputLen = MaxMutationLen = Options.MaxLen;
   TmpMaxMutationLen = 0;  // Will be set once we load the corpus.
   AllocateCurrentUnitData();
@@ -539,8 +542,11 @@ bool Fuzzer::RunOne(const uint8_t *Data, size_t Size, bool MayDeleteFile,
         Corpus.AddToCorpus({Data, Data + Size}, NumNewFeatures, MayDeleteFile,
                            TPC.ObservedFocusFunction(), ForceAddToCorpus,
                            TimeOfUnit, UniqFeatureSetTmp, DFT, II);
-    WriteFeatureSetToFile(Options.FeaturesDir, Sha1ToString(NewII->Sha1),
-                          NewII->UniqFeatureSet);
+    // With -fork_shared_features, the parent only needs to merge this input if
+    // no other job found all of its features first.
+    if (SharedFeatures.Insert(NewII->UniqFeatureSet))
+      WriteFeatureSetToFile(Options.FeaturesDir, Sha1ToString(NewII->Sha1),
+                            NewII->UniqFeatureSet);
     WriteEdgeToMutationGraphFile(Options.MutationGraphFile, NewII, II,
                                  MD.MutationSequence());
     return true;
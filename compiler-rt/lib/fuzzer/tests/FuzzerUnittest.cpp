@@ -1073,6 +1073,29 @@ TEST(Merger, SetCoverMerge) {
 
 #undef TRACED_EQ
 
+TEST(SharedFeatureSet, Insert) {
+  std::string Path = TempPath("SharedFeatureSet", ".shm");
+  {
+    // Two mappings of the same file behave like two processes sharing it.
+    SharedFeatureSet A, B;
+    ASSERT_TRUE(A.Map(Path));
+    ASSERT_TRUE(B.Map(Path));
+    EXPECT_TRUE(A.Insert(std::vector<uint32_t>({1, 2})));
+    EXPECT_FALSE(A.Insert(std::vector<uint32_t>({2})));
+    EXPECT_FALSE(B.Insert(std::vector<uint32_t>({1, 2})));
+    EXPECT_TRUE(B.Insert(std::vector<uint32_t>({2, 3})));
+    EXPECT_FALSE(A.Insert(std::set<uint32_t>({3})));
+    // Features are indexed like in the corpus.
+    EXPECT_FALSE(
+        A.Insert(std::vector<uint32_t>({SharedFeatureSet::kNumFeatures + 1})));
+
+    // An unmapped set doesn't filter anything.
+    SharedFeatureSet C;
+    EXPECT_TRUE(C.Insert(std::vector<uint32_t>({1})));
+  }
+  RemoveFile(Path);
+}
+
 TEST(DFT, BlockCoverage) {
   BlockCoverage Cov;
   // Assuming C0 has 5 instrumented blocks,
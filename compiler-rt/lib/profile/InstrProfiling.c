@@ -49,21 +49,7 @@ COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_version(void) {
   return INSTR_PROF_RAW_VERSION_VAR;
 }
 
-COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
-  if (__llvm_profile_get_version() & VARIANT_MASK_TEMPORAL_PROF)
-    __llvm_profile_global_timestamp = 1;
-
-  char *I = __llvm_profile_begin_counters();
-  char *E = __llvm_profile_end_counters();
-
-  char ResetValue =
-      (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) ? 0xFF : 0;
-  memset(I, ResetValue, E - I);
-
-  I = __llvm_profile_begin_bitmap();
-  E = __llvm_profile_end_bitmap();
-  memset(I, 0x0, E - I);
-
+COMPILER_RT_VISIBILITY void lprofResetValueCounters(void) {
   const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
   const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
   const __llvm_profile_data *DI;
@@ -87,5 +73,23 @@ COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
       }
     }
   }
+}
+
+COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
+  if (__llvm_profile_get_version() & VARIANT_MASK_TEMPORAL_PROF)
+    __llvm_profile_global_timestamp = 1;
+
+  char *I = __llvm_profile_begin_counters();
+  char *E = __llvm_profile_end_counters();
+
+  char ResetValue =
+      (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) ? 0xFF : 0;
+  memset(I, ResetValue, E - I);
+
+  I = __llvm_profile_begin_bitmap();
+  E = __llvm_profile_end_bitmap();
+  memset(I, 0x0, E - I);
+
+  lprofResetValueCounters();
   lprofSetProfileDumped(0);
 }
@@ -169,6 +169,10 @@ void lprofMergeValueProfData(struct ValueProfData *SrcValueProfData,
 
 VPDataReaderType *lprofGetVPDataReader(void);
 
+/* Reset the counts of the value profile data, as done by
+ * __llvm_profile_reset_counters. */
+void lprofResetValueCounters(void);
+
 /* Internal interface used by test to reset the max number of 
  * tracked values per value site to be \p MaxVals.
  */
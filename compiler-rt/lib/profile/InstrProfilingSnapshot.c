@@ -0,0 +1,286 @@
+/*===- InstrProfilingSnapshot.c - Stream profile snapshots to a sink ------===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+\*===----------------------------------------------------------------------===*/
+
+/* A snapshot is a raw profile whose counters hold the counts accumulated
+ * since the previous snapshot, so that the snapshots of a process can be
+ * merged with llvm-profdata as if they were the profiles of separate runs.
+ * The counters are never reset: the live counters are read once into a
+ * scratch buffer, which is then turned into deltas against the values seen by
+ * the previous snapshot. Instrumented threads are not paused while a
+ * snapshot is taken. Value profile counts are written as they are and then
+ * reset, as \c __llvm_profile_reset_counters does. */
+
+#if !defined(__Fuchsia__)
+
+#include <stdlib.h>
+#include <string.h>
+#if !defined(_WIN32)
+#include <errno.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+#include "InstrProfilingPort.h"
+
+static __llvm_profile_snapshot_sink SnapshotSink = NULL;
+static void *SnapshotSinkCtx = NULL;
+
+/* Non-null while a snapshot is being taken. This is a pointer, as the
+ * COMPILER_RT_BOOL_CMPXCHG fallbacks only work on pointers. */
+static void *SnapshotInProgress = NULL;
+
+/* The counter values seen by the previous snapshot, and the buffer into which
+ * the deltas are computed. Both are allocated with the first snapshot. */
+static uint64_t *PrevCounters = NULL;
+static char *ScratchCounters = NULL;
+
+/* The serialized snapshot. */
+typedef struct SnapshotBuffer {
+  char *Data;
+  size_t Size;
+  size_t Capacity;
+} SnapshotBuffer;
+
+static SnapshotBuffer Snapshot = {NULL, 0, 0};
+
+typedef struct SnapshotWriterCtx {
+  const char *CountersBegin;
+  const char *Scratch;
+} SnapshotWriterCtx;
+
+/* Append the IO vectors to the snapshot buffer, writing the scratch counters
+ * in place of the live ones. */
+static uint32_t snapshotWriter(ProfDataWriter *This, ProfDataIOVec *IOVecs,
+                               uint32_t NumIOVecs) {
+  SnapshotWriterCtx *Ctx = (SnapshotWriterCtx *)This->WriterCtx;
+  uint32_t I;
+  for (I = 0; I < NumIOVecs; I++) {
+    size_t Length = IOVecs[I].ElmSize * IOVecs[I].NumElm;
+    const void *Data = IOVecs[I].Data;
+    if (Data && Data == Ctx->CountersBegin)
+      Data = Ctx->Scratch;
+    if (Snapshot.Size + Length > Snapshot.Capacity) {
+      size_t NewCapacity = Snapshot.Capacity ? Snapshot.Capacity : 4096;
+      char *NewData;
+      while (NewCapacity < Snapshot.Size + Length)
+        NewCapacity *= 2;
+      NewData = (char *)realloc(Snapshot.Data, NewCapacity);
+      if (!NewData)
+        return 1;
+      Snapshot.Data = NewData;
+      Snapshot.Capacity = NewCapacity;
+    }
+    if (Data)
+      memcpy(Snapshot.Data + Snapshot.Size, Data, Length);
+    else
+      memset(Snapshot.Data + Snapshot.Size, 0, Length);
+    Snapshot.Size += Length;
+  }
+  return 0;
+}
+
+/* Read the live counters into the scratch buffer and turn them into deltas
+ * against the previous snapshot. Return -1 if the buffers can't be
+ * allocated. */
+static int computeCounterDeltas(const char *CountersBegin,
+                                const char *CountersEnd) {
+  size_t Size = CountersEnd - CountersBegin;
+  uint64_t NumCounters, I;
+  if (!ScratchCounters) {
+    ScratchCounters = (char *)malloc(Size ? Size : 1);
+    if (!ScratchCounters)
+      return -1;
+  }
+
+  /* Single byte coverage counters only record whether code was reached, which
+   * merging already handles, so they are written as they are. */
+  if (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) {
+    memcpy(ScratchCounters, CountersBegin, Size);
+    return 0;
+  }
+
+  NumCounters = Size / sizeof(uint64_t);
+  if (!PrevCounters) {
+    PrevCounters = (uint64_t *)calloc(NumCounters ? NumCounters : 1,
+                                      sizeof(uint64_t));
+    if (!PrevCounters)
+      return -1;
+  }
+  for (I = 0; I < NumCounters; ++I) {
+    uint64_t Value = ((const volatile uint64_t *)CountersBegin)[I];
+    /* The counters went down if they were reset since the previous
+     * snapshot. */
+    ((uint64_t *)ScratchCounters)[I] =
+        Value >= PrevCounters[I] ? Value - PrevCounters[I] : Value;
+    PrevCounters[I] = Value;
+  }
+  return 0;
+}
+
+COMPILER_RT_VISIBILITY
+void __llvm_profile_set_snapshot_sink(__llvm_profile_snapshot_sink Sink,
+                                      void *Ctx) {
+  SnapshotSink = Sink;
+  SnapshotSinkCtx = Ctx;
+}
+
+COMPILER_RT_VISIBILITY
+int __llvm_profile_snapshot(void) {
+  const char *CountersBegin = __llvm_profile_begin_counters();
+  const char *CountersEnd = __llvm_profile_end_counters();
+  SnapshotWriterCtx Ctx;
+  ProfDataWriter Writer;
+  int RetVal;
+
+  if (!SnapshotSink) {
+    PROF_ERR("%s\n", "no profile snapshot sink is set");
+    return -1;
+  }
+  /* Snapshots may be requested by the periodic thread and by the program at
+   * the same time; only take one at a time. */
+  if (!COMPILER_RT_BOOL_CMPXCHG(&SnapshotInProgress, NULL, (void *)1))
+    return -1;
+
+  RetVal = computeCounterDeltas(CountersBegin, CountersEnd);
+  if (RetVal == 0) {
+    Ctx.CountersBegin = CountersBegin;
+    Ctx.Scratch = ScratchCounters;
+    Writer.Write = snapshotWriter;
+    Writer.WriterCtx = &Ctx;
+    Snapshot.Size = 0;
+    RetVal = lprofWriteData(&Writer, lprofGetVPDataReader(), 0);
+    lprofResetValueCounters();
+  }
+  if (RetVal == 0)
+    RetVal = SnapshotSink(Snapshot.Data, Snapshot.Size, SnapshotSinkCtx);
+  else
+    PROF_ERR("%s\n", "failed to write profile snapshot");
+
+  COMPILER_RT_BOOL_CMPXCHG(&SnapshotInProgress, (void *)1, NULL);
+  return RetVal;
+}
+
+#if !defined(_WIN32)
+
+static struct sockaddr_un SnapshotSocketAddr;
+
+static int writeAll(int FD, const char *Data, size_t Size) {
+  while (Size) {
+#ifdef MSG_NOSIGNAL
+    ssize_t Written = send(FD, Data, Size, MSG_NOSIGNAL);
+#else
+    ssize_t Written = write(FD, Data, Size);
+#endif
+    if (Written < 0) {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    Data += Written;
+    Size -= Written;
+  }
+  return 0;
+}
+
+/* Send the snapshot, preceded by its size as a 64-bit integer in host byte
+ * order, over a new connection, so that the collector may be restarted
+ * between snapshots. */
+static int socketSink(const char *Data, size_t Size, void *Ctx) {
+  uint64_t Length = Size;
+  int RetVal = -1;
+  int FD = socket(AF_UNIX, SOCK_STREAM, 0);
+  (void)Ctx;
+  if (FD < 0)
+    return -1;
+#ifdef SO_NOSIGPIPE
+  {
+    int One = 1;
+    setsockopt(FD, SOL_SOCKET, SO_NOSIGPIPE, &One, sizeof(One));
+  }
+#endif
+  if (connect(FD, (struct sockaddr *)&SnapshotSocketAddr,
+              sizeof(SnapshotSocketAddr)) == 0 &&
+      writeAll(FD, (const char *)&Length, sizeof(Length)) == 0 &&
+      writeAll(FD, Data, Size) == 0)
+    RetVal = 0;
+  else
+    PROF_WARN("unable to send profile snapshot to %s: %s\n",
+              SnapshotSocketAddr.sun_path, strerror(errno));
+  close(FD);
+  return RetVal;
+}
+
+COMPILER_RT_VISIBILITY
+int __llvm_profile_set_snapshot_socket(const char *Path) {
+  size_t Length = strlen(Path);
+  if (Length >= sizeof(SnapshotSocketAddr.sun_path)) {
+    PROF_ERR("profile snapshot socket path is too long: %s\n", Path);
+    return -1;
+  }
+  memset(&SnapshotSocketAddr, 0, sizeof(SnapshotSocketAddr));
+  SnapshotSocketAddr.sun_family = AF_UNIX;
+  memcpy(SnapshotSocketAddr.sun_path, Path, Length);
+  __llvm_profile_set_snapshot_sink(socketSink, NULL);
+  return 0;
+}
+
+static void *SnapshotThreadStarted = NULL;
+
+static void *snapshotThread(void *Arg) {
+  unsigned IntervalSeconds = (unsigned)(uintptr_t)Arg;
+  for (;;) {
+    unsigned Left = IntervalSeconds;
+    while (Left)
+      Left = sleep(Left);
+    __llvm_profile_snapshot();
+  }
+  return NULL;
+}
+
+COMPILER_RT_VISIBILITY
+int __llvm_profile_start_snapshots(unsigned IntervalSeconds) {
+  pthread_t Thread;
+  pthread_attr_t Attr;
+  int RetVal;
+  if (!IntervalSeconds || !SnapshotSink)
+    return -1;
+  if (!COMPILER_RT_BOOL_CMPXCHG(&SnapshotThreadStarted, NULL, (void *)1))
+    return -1;
+  pthread_attr_init(&Attr);
+  pthread_attr_setdetachstate(&Attr, PTHREAD_CREATE_DETACHED);
+  RetVal = pthread_create(&Thread, &Attr, snapshotThread,
+                          (void *)(uintptr_t)IntervalSeconds);
+  pthread_attr_destroy(&Attr);
+  if (RetVal) {
+    SnapshotThreadStarted = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+#else
+
+COMPILER_RT_VISIBILITY
+int __llvm_profile_set_snapshot_socket(const char *Path) {
+  (void)Path;
+  return -1;
+}
+
+COMPILER_RT_VISIBILITY
+int __llvm_profile_start_snapshots(unsigned IntervalSeconds) {
+  (void)IntervalSeconds;
+  return -1;
+}
+
+#endif
+
+#endif
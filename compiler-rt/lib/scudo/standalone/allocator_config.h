@@ -18,6 +18,7 @@
 #include "secondary.h"
 #include "size_class_map.h"
 #include "tsd_exclusive.h"
+#include "tsd_percpu.h"
 #include "tsd_shared.h"
 
 // To import a custom configuration, define `SCUDO_USE_CUSTOM_CONFIG` and
@@ -182,6 +182,11 @@ public:
     const s32 ReleaseToOsIntervalMs = getFlags()->release_to_os_interval_ms;
     Primary.init(ReleaseToOsIntervalMs);
     Secondary.init(&Stats, ReleaseToOsIntervalMs);
+    if (getFlags()->background_release && ReleaseToOsIntervalMs >= 0) {
+      Primary.Options.set(OptionBit::BackgroundRelease);
+      BackgroundReleaseBaseIntervalMs =
+          Max(static_cast<u32>(ReleaseToOsIntervalMs), 1U);
+    }
     Quarantine.init(
         static_cast<uptr>(getFlags()->quarantine_size_kb << 10),
         static_cast<uptr>(getFlags()->thread_local_quarantine_size_kb << 10));
@@ -248,6 +253,7 @@ public:
   }
 
   void unmapTestOnly() {
+    stopBackgroundRelease();
     unmapRingBuffer();
     TSDRegistry.unmapTestOnly(this);
     Primary.unmapTestOnly();
@@ -974,6 +980,23 @@ private:
   TSDRegistryT TSDRegistry;
   pthread_once_t PostInitNonce = PTHREAD_ONCE_INIT;
 
+  // The state of the background release thread. Note that the thread doesn't
+  // survive a fork, so child processes of a process using it don't release
+  // memory until they call releaseToOS().
+  enum : u8 {
+    BackgroundReleaseNotStarted = 0,
+    BackgroundReleaseStarting,
+    BackgroundReleaseRunning,
+    BackgroundReleaseFailed,
+  };
+  atomic_u8 BackgroundReleaseState = {};
+  atomic_u8 BackgroundReleaseStop = {};
+  pthread_t BackgroundReleaseThread = {};
+  u32 BackgroundReleaseBaseIntervalMs = 0;
+  atomic_u32 BackgroundReleaseIntervalMs = {};
+  atomic_uptr BackgroundReleasePasses = {};
+  atomic_uptr BackgroundReleasedBytes = {};
+
 #ifdef GWP_ASAN_HOOKS
   gwp_asan::GuardedPoolAllocator GuardedAlloc;
   uptr GuardedAllocSlotSize = 0;
@@ -1286,9 +1309,15 @@ private:
         // implies that we may have the chance to release some pages as well.
         // Note that in order not to block other thread's accessing the TSD,
         // release the TSD first then try the page release.
-        if (CacheDrained)
-          Primary.tryReleaseToOS(ClassId, ReleaseToOS::Normal);
+        if (CacheDrained) {
+          if (UNLIKELY(Options.get(OptionBit::BackgroundRelease)))
+            startBackgroundReleaseMaybe();
+          else
+            Primary.tryReleaseToOS(ClassId, ReleaseToOS::Normal);
+        }
       } else {
+        if (UNLIKELY(Options.get(OptionBit::BackgroundRelease)))
+          startBackgroundReleaseMaybe();
         Secondary.deallocate(Options, BlockBegin);
       }
     } else {
@@ -1637,9 +1666,92 @@ private:
     Secondary.getStats(Str);
     Quarantine.getStats(Str);
     TSDRegistry.getStats(Str);
+    if (Primary.Options.load().get(OptionBit::BackgroundRelease))
+      Str->append("Stats: BackgroundRelease: %zu passes; released %zuK; "
+                  "IntervalMs = %u\n",
+                  atomic_load_relaxed(&BackgroundReleasePasses),
+                  atomic_load_relaxed(&BackgroundReleasedBytes) >> 10,
+                  atomic_load_relaxed(&BackgroundReleaseIntervalMs));
     return Str->length();
   }
 
+  // The background release thread is started on the first deallocation that
+  // could have released memory, rather than from init(), as creating a thread
+  // may allocate.
+  ALWAYS_INLINE void startBackgroundReleaseMaybe() {
+    if (LIKELY(atomic_load_relaxed(&BackgroundReleaseState) !=
+               BackgroundReleaseNotStarted))
+      return;
+    startBackgroundRelease();
+  }
+
+  NOINLINE void startBackgroundRelease() {
+    u8 Expected = BackgroundReleaseNotStarted;
+    if (!atomic_compare_exchange_strong(&BackgroundReleaseState, &Expected,
+                                        BackgroundReleaseStarting,
+                                        memory_order_acquire))
+      return;
+    atomic_store_relaxed(&BackgroundReleaseIntervalMs,
+                         BackgroundReleaseBaseIntervalMs);
+    if (pthread_create(&BackgroundReleaseThread, nullptr,
+                       backgroundReleaseThread, this) != 0) {
+      // Fall back to releasing memory on the deallocation paths.
+      Primary.Options.clear(OptionBit::BackgroundRelease);
+      atomic_store(&BackgroundReleaseState, BackgroundReleaseFailed,
+                   memory_order_release);
+      return;
+    }
+    atomic_store(&BackgroundReleaseState, BackgroundReleaseRunning,
+                 memory_order_release);
+  }
+
+  static void *backgroundReleaseThread(void *Arg) {
+    reinterpret_cast<ThisT *>(Arg)->runBackgroundRelease();
+    return nullptr;
+  }
+
+  void runBackgroundRelease() {
+    // The interval adapts to the rate at which memory gets freed: it halves
+    // after a pass which released memory, and doubles after a pass which
+    // didn't, within [Base / 8, Base * 4]. Regions are still released at most
+    // once per release interval unless enough memory was freed in them, which
+    // the primary checks itself.
+    const u32 BaseMs = BackgroundReleaseBaseIntervalMs;
+    const u32 MinMs = Max(BaseMs / 8, 1U);
+    const u32 MaxMs = Min(BaseMs, UINT32_MAX / 4) * 4;
+    u32 IntervalMs = BaseMs;
+    // Sleep in slices of at most this long, to notice stopBackgroundRelease().
+    constexpr u32 SliceMs = 100U;
+    while (!atomic_load_relaxed(&BackgroundReleaseStop)) {
+      for (u32 SleptMs = 0;
+           SleptMs < IntervalMs && !atomic_load_relaxed(&BackgroundReleaseStop);
+           SleptMs += SliceMs)
+        sleepForMilliseconds(Min(SliceMs, IntervalMs - SleptMs));
+      if (atomic_load_relaxed(&BackgroundReleaseStop))
+        break;
+
+      const uptr Released = Primary.releaseToOS(ReleaseToOS::Normal);
+      Secondary.releaseExpired();
+
+      atomic_fetch_add(&BackgroundReleasePasses, 1U, memory_order_relaxed);
+      atomic_fetch_add(&BackgroundReleasedBytes, Released,
+                       memory_order_relaxed);
+      IntervalMs =
+          Released ? Max(IntervalMs / 2, MinMs) : Min(IntervalMs * 2, MaxMs);
+      atomic_store_relaxed(&BackgroundReleaseIntervalMs, IntervalMs);
+    }
+  }
+
+  void stopBackgroundRelease() {
+    if (atomic_load(&BackgroundReleaseState, memory_order_acquire) ==
+        BackgroundReleaseRunning) {
+      atomic_store_relaxed(&BackgroundReleaseStop, 1U);
+      CHECK_EQ(pthread_join(BackgroundReleaseThread, nullptr), 0);
+    }
+    atomic_store_relaxed(&BackgroundReleaseStop, 0U);
+    atomic_store_relaxed(&BackgroundReleaseState, BackgroundReleaseNotStarted);
+  }
+
   static typename AllocationRingBuffer::Entry *
   getRingBufferEntry(AllocationRingBuffer *RB, uptr N) {
     char *RBEntryStart =
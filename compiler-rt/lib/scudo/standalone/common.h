@@ -170,6 +170,12 @@ inline uptr getPageSizeLogCached() {
 // Returns 0 if the number of CPUs could not be determined.
 u32 getNumberOfCPUs();
 
+// Returns the index of the CPU the calling thread is running on, or
+// UnknownCPU if it could not be determined. The thread may have migrated to
+// another CPU by the time this returns.
+constexpr u32 UnknownCPU = ~0U;
+u32 getCurrentCPU();
+
 const char *getEnv(const char *Name);
 
 u64 getMonotonicTime();
@@ -179,6 +185,8 @@ u64 getMonotonicTimeFast();
 
 u32 getThreadID();
 
+void sleepForMilliseconds(u32 Ms);
+
 // Our randomness gathering function is limited to 256 bytes to ensure we get
 // as many bytes as requested, and avoid interruptions (on Linux).
 constexpr uptr MaxRandomLength = 256U;
@@ -215,6 +215,12 @@ u64 getMonotonicTimeFast() { return _zx_clock_get_monotonic(); }
 
 u32 getNumberOfCPUs() { return _zx_system_get_num_cpus(); }
 
+u32 getCurrentCPU() { return UnknownCPU; }
+
+void sleepForMilliseconds(u32 Ms) {
+  _zx_nanosleep(_zx_deadline_after(ZX_MSEC(Ms)));
+}
+
 u32 getThreadID() { return 0; }
 
 bool getRandom(void *Buffer, uptr Length, UNUSED bool Blocking) {
@@ -170,6 +170,36 @@ u32 getNumberOfCPUs() {
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+// The restartable sequence area registered by the C library for the thread,
+// whose cpu_id field is kept up to date by the kernel. glibc exports its
+// offset from the thread pointer since 2.35.
+extern "C" WEAK const ptrdiff_t __rseq_offset;
+extern "C" WEAK const unsigned int __rseq_size;
+
+u32 getCurrentCPU() {
+#if defined(__x86_64__) || defined(__aarch64__)
+  if (&__rseq_offset && &__rseq_size && __rseq_size != 0) {
+    // The cpu_id field follows the cpu_id_start one, and is negative while
+    // the registration is pending or if it failed.
+    const s32 *RseqArea = reinterpret_cast<const s32 *>(
+        reinterpret_cast<const char *>(__builtin_thread_pointer()) +
+        __rseq_offset);
+    const s32 CPU = __atomic_load_n(&RseqArea[1], __ATOMIC_RELAXED);
+    if (CPU >= 0)
+      return static_cast<u32>(CPU);
+  }
+#endif
+  const int CPU = sched_getcpu();
+  return CPU < 0 ? UnknownCPU : static_cast<u32>(CPU);
+}
+
+void sleepForMilliseconds(u32 Ms) {
+  timespec TS = {static_cast<time_t>(Ms / 1000),
+                 static_cast<long>(Ms % 1000) * 1000000};
+  while (nanosleep(&TS, &TS) != 0 && errno == EINTR) {
+  }
+}
+
 u32 getThreadID() {
 #if SCUDO_ANDROID
   return static_cast<u32>(gettid());
@@ -25,6 +25,7 @@ enum class OptionBit {
   UseOddEvenTags,
   UseMemoryTagging,
   AddLargeAllocationSlack,
+  BackgroundRelease,
 };
 
 struct Options {
@@ -119,6 +119,7 @@ public:
   void disable() {}
   void enable() {}
   void releaseToOS() {}
+  void releaseExpired() {}
   void disableMemoryTagging() {}
   void unmapTestOnly() {}
   bool setOption(Option O, UNUSED sptr Value) {
@@ -342,7 +343,9 @@ public:
     for (MemMapT &EvictMemMap : EvictionMemMaps)
       unmapCallBack(EvictMemMap);
 
-    if (Interval >= 0) {
+    // With background release, the expired entries are released by
+    // releaseExpired().
+    if (Interval >= 0 && !Options.get(OptionBit::BackgroundRelease)) {
       // TODO: Add ReleaseToOS logic to LRU algorithm
       releaseOlderThan(Time - static_cast<u64>(Interval) * 1000000);
     }
@@ -490,6 +493,15 @@ public:
 
   void releaseToOS() { releaseOlderThan(UINT64_MAX); }
 
+  // Release the entries that have been in the cache for longer than the
+  // release interval.
+  void releaseExpired() {
+    const s32 Interval = atomic_load_relaxed(&ReleaseToOsIntervalMs);
+    const u64 Time = getMonotonicTimeFast();
+    if (Interval >= 0 && Time > static_cast<u64>(Interval) * 1000000)
+      releaseOlderThan(Time - static_cast<u64>(Interval) * 1000000);
+  }
+
   void disableMemoryTagging() EXCLUDES(Mutex) {
     ScopedLock L(Mutex);
     for (u32 I = 0; I != Config::getQuarantineSize(); ++I) {
@@ -645,6 +657,8 @@ public:
 
   void releaseToOS() { Cache.releaseToOS(); }
 
+  void releaseExpired() { Cache.releaseExpired(); }
+
   void disableMemoryTagging() { Cache.disableMemoryTagging(); }
 
   void unmapTestOnly() { Cache.unmapTestOnly(); }
@@ -9,6 +9,7 @@
 #include "tests/scudo_unit_test.h"
 
 #include "tsd_exclusive.h"
+#include "tsd_percpu.h"
 #include "tsd_shared.h"
 
 #include <stdlib.h>
@@ -72,6 +73,11 @@ struct ExclusiveCaches {
   using TSDRegistryT = scudo::TSDRegistryExT<Allocator>;
 };
 
+struct PerCPUCaches {
+  template <class Allocator>
+  using TSDRegistryT = scudo::TSDRegistryPerCPUT<Allocator, 16U>;
+};
+
 TEST(ScudoTSDTest, TSDRegistryInit) {
   using AllocatorT = MockAllocator<OneCache>;
   auto Deleter = [](AllocatorT *A) {
@@ -117,6 +123,7 @@ static void testRegistry() NO_THREAD_SAFETY_ANALYSIS {
 TEST(ScudoTSDTest, TSDRegistryBasic) {
   testRegistry<MockAllocator<OneCache>>();
   testRegistry<MockAllocator<SharedCaches>>();
+  testRegistry<MockAllocator<PerCPUCaches>>();
 #if !SCUDO_FUCHSIA
   testRegistry<MockAllocator<ExclusiveCaches>>();
 #endif
@@ -178,6 +185,7 @@ template <class AllocatorT> static void testRegistryThreaded() {
 TEST(ScudoTSDTest, TSDRegistryThreaded) {
   testRegistryThreaded<MockAllocator<OneCache>>();
   testRegistryThreaded<MockAllocator<SharedCaches>>();
+  testRegistryThreaded<MockAllocator<PerCPUCaches>>();
 #if !SCUDO_FUCHSIA
   testRegistryThreaded<MockAllocator<ExclusiveCaches>>();
 #endif
@@ -249,3 +257,52 @@ TEST(ScudoTSDTest, TSDRegistryTSDsCount) {
   // We should get 16 distinct TSDs back.
   EXPECT_EQ(Pointers.size(), 16U);
 }
+
+static void stressPerCPURegistry(MockAllocator<PerCPUCaches> *Allocator) {
+  std::set<void *> Set;
+  auto Registry = Allocator->getTSDRegistry();
+  {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    while (!Ready)
+      Cv.wait(Lock);
+  }
+  Registry->initThreadMaybe(Allocator, /*MinimalInit=*/false);
+  for (scudo::uptr I = 0; I < 4096U; I++) {
+    typename MockAllocator<PerCPUCaches>::TSDRegistryT::ScopedTSD TSD(
+        *Registry);
+    Set.insert(reinterpret_cast<void *>(&*TSD));
+  }
+  {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    Pointers.insert(Set.begin(), Set.end());
+  }
+}
+
+TEST(ScudoTSDTest, TSDRegistryPerCPUCount) {
+  Ready = false;
+  Pointers.clear();
+  using AllocatorT = MockAllocator<PerCPUCaches>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  // However many threads there are, they only use the TSDs of the CPUs they
+  // run on.
+  std::thread Threads[32];
+  for (scudo::uptr I = 0; I < ARRAY_SIZE(Threads); I++)
+    Threads[I] = std::thread(stressPerCPURegistry, Allocator.get());
+  {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    Ready = true;
+    Cv.notify_all();
+  }
+  for (auto &T : Threads)
+    T.join();
+  const scudo::u32 NumberOfCPUs = scudo::getNumberOfCPUs();
+  EXPECT_LE(Pointers.size(), NumberOfCPUs == 0
+                                 ? 16U
+                                 : std::min<scudo::u32>(NumberOfCPUs, 16U));
+  Pointers.clear();
+}
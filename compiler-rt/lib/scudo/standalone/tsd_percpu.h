@@ -0,0 +1,200 @@
+//===-- tsd_percpu.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SCUDO_TSD_PERCPU_H_
+#define SCUDO_TSD_PERCPU_H_
+
+#include "tsd.h"
+
+#include "string_utils.h"
+
+#if SCUDO_HAS_PLATFORM_TLS_SLOT
+// See tsd_shared.h.
+#include "scudo_platform_tls_slot.h"
+#endif
+
+namespace scudo {
+
+// A registry with one TSD per CPU. Contrary to the shared registry, threads
+// are not associated with a TSD: every operation uses the TSD of the CPU the
+// thread runs on, as given by getCurrentCPU(). On Linux that is read from the
+// restartable sequence area registered by the C library, which is as cheap as
+// a thread-local access.
+//
+// The memory held in the caches is thus bounded by the number of CPUs rather
+// than by the number of threads, and the lock of a TSD is only contended if
+// its thread was preempted or migrated while holding it. Threads fall back to
+// a TSD assigned in a round-robin fashion if the CPU can't be determined.
+template <class Allocator, u32 TSDsArraySize> struct TSDRegistryPerCPUT {
+  using ThisT = TSDRegistryPerCPUT<Allocator, TSDsArraySize>;
+
+  struct ScopedTSD {
+    ALWAYS_INLINE ScopedTSD(ThisT &TSDRegistry) {
+      CurrentTSD = TSDRegistry.getTSDAndLock();
+      DCHECK_NE(CurrentTSD, nullptr);
+    }
+
+    ~ScopedTSD() { CurrentTSD->unlock(); }
+
+    TSD<Allocator> &operator*() { return *CurrentTSD; }
+
+    TSD<Allocator> *operator->() {
+      CurrentTSD->assertLocked(/*BypassCheck=*/false);
+      return CurrentTSD;
+    }
+
+  private:
+    TSD<Allocator> *CurrentTSD;
+  };
+
+  void init(Allocator *Instance) REQUIRES(Mutex) {
+    DCHECK(!Initialized);
+    Instance->init();
+    for (u32 I = 0; I < TSDsArraySize; I++)
+      TSDs[I].init(Instance);
+    const u32 NumberOfCPUs = getNumberOfCPUs();
+    atomic_store_relaxed(&NumberOfTSDs,
+                         (NumberOfCPUs == 0)
+                             ? TSDsArraySize
+                             : Min(NumberOfCPUs, TSDsArraySize));
+    Initialized = true;
+  }
+
+  void initOnceMaybe(Allocator *Instance) EXCLUDES(Mutex) {
+    ScopedLock L(Mutex);
+    if (LIKELY(Initialized))
+      return;
+    init(Instance); // Sets Initialized.
+  }
+
+  void unmapTestOnly(Allocator *Instance) EXCLUDES(Mutex) {
+    for (u32 I = 0; I < TSDsArraySize; I++) {
+      TSDs[I].commitBack(Instance);
+      TSDs[I] = {};
+    }
+    *getTlsPtr() = 0;
+    ScopedLock L(Mutex);
+    Initialized = false;
+  }
+
+  void drainCaches(Allocator *Instance) {
+    const u32 N = atomic_load_relaxed(&NumberOfTSDs);
+    for (uptr I = 0; I < N; ++I) {
+      TSDs[I].lock();
+      Instance->drainCache(&TSDs[I]);
+      TSDs[I].unlock();
+    }
+  }
+
+  ALWAYS_INLINE void initThreadMaybe(Allocator *Instance,
+                                     UNUSED bool MinimalInit) {
+    if (LIKELY(*getTlsPtr() & InitializedBit))
+      return;
+    initThread(Instance);
+  }
+
+  void disable() NO_THREAD_SAFETY_ANALYSIS {
+    Mutex.lock();
+    for (u32 I = 0; I < TSDsArraySize; I++)
+      TSDs[I].lock();
+  }
+
+  void enable() NO_THREAD_SAFETY_ANALYSIS {
+    for (s32 I = static_cast<s32>(TSDsArraySize - 1); I >= 0; I--)
+      TSDs[I].unlock();
+    Mutex.unlock();
+  }
+
+  bool setOption(Option O, sptr Value) {
+    if (O == Option::MaxTSDsCount)
+      return setNumberOfTSDs(static_cast<u32>(Value));
+    if (O == Option::ThreadDisableMemInit)
+      setDisableMemInit(Value);
+    // Not supported by the TSD Registry, but not an error either.
+    return true;
+  }
+
+  bool getDisableMemInit() const { return *getTlsPtr() & DisableMemInitBit; }
+
+  void getStats(ScopedString *Str) {
+    const u32 N = atomic_load_relaxed(&NumberOfTSDs);
+    Str->append("Stats: PerCPUTSDs: %u available; total %u\n", N,
+                TSDsArraySize);
+    for (uptr I = 0; I < N; ++I) {
+      TSDs[I].lock();
+      // See TSDRegistrySharedT::getStats().
+      TSDs[I].assertLocked(/*BypassCheck=*/true);
+      Str->append("  PerCPU TSD[%zu]:\n", I);
+      TSDs[I].getCache().getStats(Str);
+      TSDs[I].unlock();
+    }
+  }
+
+private:
+  // The thread-local word holds the DisableMemInit option, whether the thread
+  // was initialized, and the index of the TSD used when the CPU is unknown.
+  static constexpr uptr DisableMemInitBit = 1U << 0;
+  static constexpr uptr InitializedBit = 1U << 1;
+  static constexpr uptr FallbackIndexShift = 2U;
+
+  ALWAYS_INLINE TSD<Allocator> *getTSDAndLock() NO_THREAD_SAFETY_ANALYSIS {
+    const u32 N = atomic_load_relaxed(&NumberOfTSDs);
+    DCHECK_NE(N, 0U);
+    u32 Index = getCurrentCPU();
+    if (UNLIKELY(Index == UnknownCPU))
+      Index = static_cast<u32>(*getTlsPtr() >> FallbackIndexShift);
+    // The modulo also covers CPUs with an index above the number of CPUs the
+    // process may run on.
+    TSD<Allocator> *TSD = &TSDs[Index % N];
+    // The lock is normally free: it is only held by another thread if that
+    // thread got preempted or migrated while using the TSD of this CPU.
+    TSD->lock();
+    return TSD;
+  }
+
+  ALWAYS_INLINE uptr *getTlsPtr() const {
+#if SCUDO_HAS_PLATFORM_TLS_SLOT
+    return reinterpret_cast<uptr *>(getPlatformAllocatorTlsSlot());
+#else
+    static thread_local uptr ThreadState;
+    return &ThreadState;
+#endif
+  }
+
+  bool setNumberOfTSDs(u32 N) {
+    // TSDs can't be removed, as another thread may be using them.
+    if (N < atomic_load_relaxed(&NumberOfTSDs))
+      return false;
+    atomic_store_relaxed(&NumberOfTSDs, Min(N, TSDsArraySize));
+    return true;
+  }
+
+  void setDisableMemInit(bool B) {
+    *getTlsPtr() &= ~DisableMemInitBit;
+    *getTlsPtr() |= B ? DisableMemInitBit : 0;
+  }
+
+  NOINLINE void initThread(Allocator *Instance) {
+    initOnceMaybe(Instance);
+    const u32 Index = atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
+    *getTlsPtr() = (*getTlsPtr() & DisableMemInitBit) | InitializedBit |
+                   (static_cast<uptr>(Index % TSDsArraySize)
+                    << FallbackIndexShift);
+    Instance->callPostInitCallback();
+  }
+
+  atomic_u32 CurrentIndex = {};
+  atomic_u32 NumberOfTSDs = {};
+  bool Initialized GUARDED_BY(Mutex) = false;
+  HybridMutex Mutex;
+  TSD<Allocator> TSDs[TSDsArraySize];
+};
+
+} // namespace scudo
+
+#endif // SCUDO_TSD_PERCPU_H_
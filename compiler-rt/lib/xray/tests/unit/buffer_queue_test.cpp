@@ -120,6 +120,43 @@ TEST(BufferQueueTest, Apply) {
   ASSERT_EQ(Count, 10);
 }
 
+TEST(BufferQueueTest, ConsumeBuffers) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 10, Success);
+  ASSERT_TRUE(Success);
+  BufferQueue::Buffer B;
+  for (uint64_t I = 1; I <= 3; ++I) {
+    ASSERT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::Ok);
+    atomic_store(B.Extents, I, memory_order_release);
+    ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+  }
+
+  // A buffer which is still being written to isn't consumed.
+  BufferQueue::Buffer Live;
+  ASSERT_EQ(Buffers.getBuffer(Live), BufferQueue::ErrorCode::Ok);
+  atomic_store(Live.Extents, 4, memory_order_release);
+
+  uint64_t Expected = 1;
+  ASSERT_EQ(Buffers.consumeBuffers([&](const BufferQueue::Buffer &B) {
+    EXPECT_EQ(atomic_load(B.Extents, memory_order_acquire), Expected++);
+  }),
+            3u);
+  ASSERT_EQ(Buffers.consumeBuffers([](const BufferQueue::Buffer &) {}), 0u);
+
+  ASSERT_EQ(Buffers.releaseBuffer(Live), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.consumeBuffers([&](const BufferQueue::Buffer &B) {
+    EXPECT_EQ(atomic_load(B.Extents, memory_order_acquire), 4u);
+  }),
+            1u);
+
+  // The consumed buffers can be handed out again, empty.
+  for (int I = 0; I < 10; ++I) {
+    ASSERT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::Ok);
+    EXPECT_EQ(atomic_load(B.Extents, memory_order_acquire), 0u);
+    ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+  }
+}
+
 TEST(BufferQueueTest, GenerationalSupport) {
   bool Success = false;
   BufferQueue Buffers(kSize, 10, Success);
@@ -215,6 +215,56 @@ BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
   return ErrorCode::Ok;
 }
 
+bool BufferQueue::acquireOldest(Buffer &Buf, bool &HasData) {
+  if (atomic_load(&Finalizing, memory_order_acquire))
+    return false;
+
+  BufferRep *B = nullptr;
+  {
+    SpinMutexLock Guard(&Mutex);
+    if (LiveBuffers == BufferCount)
+      return false;
+    B = Next++;
+    if (Next == (Buffers + BufferCount))
+      Next = Buffers;
+    ++LiveBuffers;
+  }
+
+  // Like getBuffer(...), we hold a reference to the backing stores until the
+  // buffer is put back into the queue.
+  incRefCount(BackingStore);
+  incRefCount(ExtentsBackingStore);
+  Buf = B->Buff;
+  Buf.Generation = generation();
+  HasData = B->Used;
+  B->Used = false;
+  return true;
+}
+
+void BufferQueue::releaseConsumed(Buffer &Buf) {
+  BufferRep *B = nullptr;
+  {
+    SpinMutexLock Guard(&Mutex);
+    // If the queue was re-initialized in the meantime, the buffer is dropped
+    // as it would be by releaseBuffer(...).
+    if (Buf.Generation == generation() && LiveBuffers != 0) {
+      --LiveBuffers;
+      B = First++;
+      if (First == (Buffers + BufferCount))
+        First = Buffers;
+    }
+  }
+
+  if (B != nullptr) {
+    atomic_store(Buf.Extents, 0, memory_order_release);
+    B->Buff = Buf;
+    B->Used = false;
+  }
+  decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
+  decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
+  Buf = {};
+}
+
 BufferQueue::ErrorCode BufferQueue::finalize() {
   if (atomic_exchange(&Finalizing, 1, memory_order_acq_rel))
     return ErrorCode::QueueFinalizing;
@@ -166,6 +166,14 @@ private:
   /// Releases references to the buffers backed by the current buffer queue.
   void cleanupBuffers();
 
+  /// Takes the oldest buffer off the queue on behalf of consumeBuffers(...),
+  /// and sets |HasData| if it was released with records in it. Returns false
+  /// if there is no buffer to take, or if the queue is finalizing.
+  bool acquireOldest(Buffer &Buf, bool &HasData);
+
+  /// Puts a buffer taken by acquireOldest(...) back into the queue, emptied.
+  void releaseConsumed(Buffer &Buf);
+
 public:
   enum class ErrorCode : unsigned {
     Ok,
@@ -258,6 +266,37 @@ public:
       Fn(*I);
   }
 
+  /// Applies the provided function F to each Buffer released to the queue
+  /// before the call, oldest first, then gives the Buffer back to the queue
+  /// empty so that it can be reused.
+  ///
+  /// Unlike apply(...), this may be called while other threads get and
+  /// release buffers: each Buffer is taken off the queue while F runs on it,
+  /// so that it can't be handed out and overwritten in the meantime. F must
+  /// not call back into the queue.
+  ///
+  /// Returns the number of buffers F was applied to.
+  template <class F> size_t consumeBuffers(F Fn) XRAY_NEVER_INSTRUMENT {
+    size_t Remaining = 0;
+    {
+      SpinMutexLock G(&Mutex);
+      Remaining = BufferCount - LiveBuffers;
+    }
+    size_t Consumed = 0;
+    for (; Remaining > 0; --Remaining) {
+      Buffer Buf;
+      bool HasData = false;
+      if (!acquireOldest(Buf, HasData))
+        break;
+      if (HasData) {
+        Fn(static_cast<const Buffer &>(Buf));
+        ++Consumed;
+      }
+      releaseConsumed(Buf);
+    }
+    return Consumed;
+  }
+
   using const_iterator = Iterator<const Buffer>;
   using iterator = Iterator<Buffer>;
 
@@ -272,6 +272,48 @@ XRayBuffer fdrIterator(const XRayBuffer B) {
   return Result;
 }
 
+// Whether the file header was handed out by fdrStreamer(...) since the last
+// initialization.
+static atomic_uint8_t StreamedHeader{0};
+
+// This is the implementation registered through
+// __xray_log_set_buffer_streamer(...). The first call after initialization
+// also hands out the file header, so that the data handed out during a session
+// forms a complete FDR log. The buffers are emptied and given back to the
+// queue once processed, which is what bounds the memory of a long trace.
+size_t fdrStreamer(const char *Mode,
+                   void (*Processor)(const char *, XRayBuffer)) {
+  if (atomic_load(&LoggingStatus, memory_order_acquire) !=
+          XRayLogInitStatus::XRAY_LOG_INITIALIZED ||
+      BQ == nullptr)
+    return 0;
+
+  if (atomic_exchange(&StreamedHeader, 1, memory_order_acq_rel) == 0) {
+    XRayFileHeader Header = fdrCommonHeaderInfo();
+    Header.FdrData = FdrAdditionalHeaderData{BQ->ConfiguredBufferSize()};
+    (*Processor)(Mode, XRayBuffer{&Header, sizeof(Header)});
+  }
+
+  return BQ->consumeBuffers([&](const BufferQueue::Buffer &B) {
+    // See fdrIterator(...) for why we need the fence.
+    atomic_thread_fence(memory_order_acquire);
+    auto BufferExtents = atomic_load(B.Extents, memory_order_acquire);
+    DCHECK(BufferExtents <= B.Size);
+    if (BufferExtents == 0)
+      return;
+
+    // As when flushing to a file, the records of the buffer are preceded by
+    // its extents.
+    MetadataRecord ExtentsRecord;
+    ExtentsRecord.Type = uint8_t(RecordType::Metadata);
+    ExtentsRecord.RecordKind =
+        uint8_t(MetadataRecord::RecordKinds::BufferExtents);
+    internal_memcpy(ExtentsRecord.Data, &BufferExtents, sizeof(BufferExtents));
+    (*Processor)(Mode, XRayBuffer{&ExtentsRecord, sizeof(ExtentsRecord)});
+    (*Processor)(Mode, XRayBuffer{B.Data, BufferExtents});
+  });
+}
+
 // Must finalize before flushing.
 XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   if (atomic_load(&LoggingStatus, memory_order_acquire) !=
@@ -302,6 +344,7 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   // At this point, we're going to uninstall the iterator implementation, before
   // we decide to do anything further with the global buffer queue.
   __xray_log_remove_buffer_iterator();
+  __xray_log_remove_buffer_streamer();
 
   // Once flushed, we should set the global status of the logging implementation
   // to "uninitialized" to allow for FDR-logging multiple runs.
@@ -710,8 +753,10 @@ XRayLogInitStatus fdrLoggingInit(size_t, size_t, void *Options,
   __xray_set_customevent_handler(fdrLoggingHandleCustomEvent);
   __xray_set_typedevent_handler(fdrLoggingHandleTypedEvent);
 
-  // Install the buffer iterator implementation.
+  // Install the buffer iterator and streamer implementations.
   __xray_log_set_buffer_iterator(fdrIterator);
+  atomic_store(&StreamedHeader, 0, memory_order_release);
+  __xray_log_set_buffer_streamer(fdrStreamer);
 
   atomic_store(&LoggingStatus, XRayLogInitStatus::XRAY_LOG_INITIALIZED,
                memory_order_release);
@@ -32,6 +32,10 @@ XRayBuffer NullBufferIterator(XRayBuffer) XRAY_NEVER_INSTRUMENT {
 atomic_uintptr_t XRayBufferIterator{
     reinterpret_cast<uintptr_t>(&NullBufferIterator)};
 
+// This is the global function responsible for streaming the completed
+// buffers, if the current implementation supports it.
+atomic_uintptr_t XRayBufferStreamer{0};
+
 // We use a linked list of Mode to XRayLogImpl mappings. This is a linked list
 // when it should be a map because we're avoiding having to depend on C++
 // standard library data structures at this level of the implementation.
@@ -60,6 +64,17 @@ void __xray_log_remove_buffer_iterator() XRAY_NEVER_INSTRUMENT {
   __xray_log_set_buffer_iterator(&NullBufferIterator);
 }
 
+void __xray_log_set_buffer_streamer(
+    size_t (*Streamer)(const char *, void (*)(const char *, XRayBuffer)))
+    XRAY_NEVER_INSTRUMENT {
+  atomic_store(&__xray::XRayBufferStreamer,
+               reinterpret_cast<uintptr_t>(Streamer), memory_order_release);
+}
+
+void __xray_log_remove_buffer_streamer() XRAY_NEVER_INSTRUMENT {
+  __xray_log_set_buffer_streamer(nullptr);
+}
+
 XRayLogRegisterStatus
 __xray_log_register_mode(const char *Mode,
                          XRayLogImpl Impl) XRAY_NEVER_INSTRUMENT {
@@ -207,3 +222,18 @@ XRayLogFlushStatus __xray_log_process_buffers(
   }
   return XRayLogFlushStatus::XRAY_LOG_FLUSHED;
 }
+
+XRayLogFlushStatus __xray_log_stream_buffers(
+    void (*Processor)(const char *, XRayBuffer)) XRAY_NEVER_INSTRUMENT {
+  if (!GlobalXRayImpl)
+    return XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING;
+  auto Streamer =
+      reinterpret_cast<size_t (*)(const char *,
+                                  void (*)(const char *, XRayBuffer))>(
+          atomic_load(&XRayBufferStreamer, memory_order_acquire));
+  if (Streamer == nullptr)
+    return XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING;
+  auto Mode = CurrentMode ? CurrentMode->Mode : nullptr;
+  (*Streamer)(Mode, Processor);
+  return XRayLogFlushStatus::XRAY_LOG_FLUSHED;
+}
@@ -34,12 +34,19 @@
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/CommandLine.h"
 
 namespace hlfir {
 #define GEN_PASS_DEF_BUFFERIZEHLFIR
 #include "flang/Optimizer/HLFIR/Passes.h.inc"
 } // namespace hlfir
 
+static llvm::cl::opt<bool> remarkTemporaries(
+    "flang-remark-hlfir-temporaries",
+    llvm::cl::desc("Emit a remark for every array temporary that HLFIR "
+                   "bufferization has to create"),
+    llvm::cl::init(false));
+
 namespace {
 
 /// Helper to create tuple from a bufferized expr storage and clean up
@@ -166,6 +173,8 @@ createArrayTemp(mlir::Location loc, fir::FirOpBuilder &builder,
 static mlir::Value copyInTempAndPackage(mlir::Location loc,
                                         fir::FirOpBuilder &builder,
                                         hlfir::Entity source) {
+  if (remarkTemporaries && source.isArray())
+    mlir::emitRemark(loc, "creating a temporary copy of an array variable");
   auto [temp, cleanup] = hlfir::createTempFromMold(loc, builder, source);
   builder.create<hlfir::AssignOp>(loc, source, temp, temp.isAllocatable(),
                                   /*keep_lhs_length_if_realloc=*/false,
@@ -783,6 +792,11 @@ struct ElementalOpConversion
     if (adaptor.getMold())
       mold = getBufferizedExprStorage(adaptor.getMold());
     auto extents = hlfir::getIndexExtents(loc, builder, shape);
+    // The elementals that could be evaluated in place were already rewritten
+    // by the optimized bufferization.
+    if (remarkTemporaries)
+      mlir::emitRemark(loc, "creating an array temporary for an elemental "
+                            "expression");
     auto [temp, cleanup] =
         createArrayTemp(loc, builder, elemental.getType(), shape, extents,
                         adaptor.getTypeparams(), mold);
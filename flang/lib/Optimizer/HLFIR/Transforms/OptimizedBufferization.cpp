@@ -73,9 +73,10 @@ namespace {
 /// In these cases, it is safe to turn the elemental into a do loop and modify
 /// elements of %array in place without creating an extra temporary for the
 /// elemental. We must check that there are no reads from the array at indexes
-/// which might conflict with the assignment or any writes. For now we will keep
-/// that strict and say that all reads must be at the elemental index (it is
-/// probably safe to read from higher indices if lowering to an ordered loop).
+/// which might conflict with the assignment or any writes. Reads must be at
+/// the elemental index, or at an element that is only written by a later
+/// iteration of the loop nest (e.g. a(i+1) in a(i) = a(i) + a(i+1)). In the
+/// latter case the loop nest must be ordered.
 class ElementalAssignBufferization
     : public mlir::OpRewritePattern<hlfir::ElementalOp> {
 private:
@@ -83,6 +84,9 @@ private:
     mlir::Value array;
     hlfir::AssignOp assign;
     hlfir::DestroyOp destroy;
+    // Some reads of the array are ahead of the assigned element, so the
+    // elements must be assigned in column-major order.
+    bool mustBeOrdered = false;
   };
   /// determines if the transformation can be applied to this elemental
   static std::optional<MatchInfo> findMatch(hlfir::ElementalOp elemental);
@@ -173,7 +177,13 @@ public:
     DefinitelyDisjoint,
     // Slices may be either disjoint or identical,
     // i.e. there is definitely no partial overlap.
-    EitherIdenticalOrDisjoint
+    EitherIdenticalOrDisjoint,
+    // Slices partially overlap, and every element of the second
+    // slice is after the element of the first slice with the same
+    // indices, in column-major order. An element-wise copy from
+    // the second slice into the first one, done in column-major
+    // order, reads each element before it is overwritten.
+    ForwardOverlap
   };
 
   // Analyzes two hlfir.designate results and returns the overlap kind.
@@ -294,6 +304,21 @@ private:
     return false;
   }
 
+  // Given two array sections <lb1, ub1, stride1> and
+  // <lb2, ub2, stride2>, return true only if both have
+  // a unit stride and lb1 is known to be less than lb2,
+  // i.e. the element k of the second section is the element
+  // k+C of the first section, for some positive C.
+  //
+  // For example:
+  //   X:Y and (X+C):Z
+  static bool isForwardSection(const SectionDesc &desc1,
+                               const SectionDesc &desc2) {
+    if (desc1.stride || desc2.stride)
+      return false;
+    return isLess(desc1.lb, desc2.lb);
+  }
+
   // Return true, if v1 is known to be less than v2.
   static bool isLess(mlir::Value v1, mlir::Value v2);
 };
@@ -336,6 +361,7 @@ ArraySectionAnalyzer::analyze(mlir::Value ref1, mlir::Value ref2) {
   auto des2It = des2.getIndices().begin();
   bool identicalTriplets = true;
   bool identicalIndices = true;
+  bool forwardTriplets = false;
   for (auto [isTriplet1, isTriplet2] :
        llvm::zip(des1.getIsTriplet(), des2.getIsTriplet())) {
     SectionDesc desc1 = readSectionDesc(des1It, isTriplet1);
@@ -351,6 +377,16 @@ ArraySectionAnalyzer::analyze(mlir::Value ref1, mlir::Value ref2) {
       return SlicesOverlapKind::DefinitelyDisjoint;
 
     if (!areIdenticalSections(desc1, desc2)) {
+      // For example:
+      //   hlfir.designate %6#0 (%c1:%c7999:%c1, %0)
+      //   hlfir.designate %6#0 (%c2:%c8000:%c1, %0)
+      //
+      // The second slice is shifted forward along the first
+      // dimension.
+      if (isTriplet1 && isTriplet2 && isForwardSection(desc1, desc2)) {
+        forwardTriplets = true;
+        continue;
+      }
       if (isTriplet1 || isTriplet2) {
         // For example:
         //   hlfir.designate %6#0 (%c2:%c7999:%c1, %c1:%c120:%c1, %0)
@@ -377,6 +413,16 @@ ArraySectionAnalyzer::analyze(mlir::Value ref1, mlir::Value ref2) {
   }
 
   if (identicalTriplets) {
+    // Every shift is forward, so the shift of the whole slice
+    // is forward in column-major order.
+    if (forwardTriplets) {
+      if (identicalIndices)
+        return SlicesOverlapKind::ForwardOverlap;
+      LLVM_DEBUG(llvm::dbgs() << "Shifted sections with different indices:\n"
+                              << des1 << "and:\n"
+                              << des2 << "\n");
+      return SlicesOverlapKind::Unknown;
+    }
     if (identicalIndices)
       return SlicesOverlapKind::DefinitelyIdentical;
     else
@@ -430,6 +476,42 @@ bool ArraySectionAnalyzer::isLess(mlir::Value v1, mlir::Value v2) {
   return false;
 }
 
+/// Return true if \p indices designate, at each iteration of an ordered loop
+/// nest over \p loopIndices, an element that is only reached by a later
+/// iteration. They must be of the form loopIndices[k] + C[k] with constant
+/// C[k], and the last non-zero C[k] must be positive since the outermost loop
+/// iterates over the last dimension.
+static bool areForwardIndices(mlir::ValueRange indices,
+                              mlir::ValueRange loopIndices) {
+  if (indices.size() != loopIndices.size())
+    return false;
+  auto getOffset = [](mlir::Value index,
+                      mlir::Value loopIndex) -> std::optional<int64_t> {
+    if (index == loopIndex)
+      return 0;
+    if (auto addi = index.getDefiningOp<mlir::arith::AddIOp>()) {
+      if (addi.getLhs() == loopIndex)
+        return fir::getIntIfConstant(addi.getRhs());
+      if (addi.getRhs() == loopIndex)
+        return fir::getIntIfConstant(addi.getLhs());
+    }
+    if (auto subi = index.getDefiningOp<mlir::arith::SubIOp>())
+      if (subi.getLhs() == loopIndex)
+        if (auto offset = fir::getIntIfConstant(subi.getRhs()))
+          return -*offset;
+    return std::nullopt;
+  };
+  std::optional<int64_t> lastNonZero;
+  for (auto [index, loopIndex] : llvm::zip(indices, loopIndices)) {
+    std::optional<int64_t> offset = getOffset(index, loopIndex);
+    if (!offset)
+      return false;
+    if (*offset != 0)
+      lastNonZero = offset;
+  }
+  return lastNonZero && *lastNonZero > 0;
+}
+
 std::optional<ElementalAssignBufferization::MatchInfo>
 ElementalAssignBufferization::findMatch(hlfir::ElementalOp elemental) {
   mlir::Operation::user_range users = elemental->getUsers();
@@ -561,8 +643,25 @@ ElementalAssignBufferization::findMatch(hlfir::ElementalOp elemental) {
         auto elementalIndices = elemental.getIndices();
         if (indices.size() == elementalIndices.size() &&
             std::equal(indices.begin(), indices.end(), elementalIndices.begin(),
-                       elementalIndices.end()))
+                       elementalIndices.end())) {
+          // The read slice is ahead of the array, so is any element read at
+          // the elemental indices.
+          if (overlap ==
+              ArraySectionAnalyzer::SlicesOverlapKind::ForwardOverlap)
+            match.mustBeOrdered = true;
           continue;
+        }
+
+        // Reads ahead of the assigned element see the original values if the
+        // loop nest is ordered. The designator indices are the one-based
+        // indices of the loop nest only if the lower bounds are all one.
+        if (overlap ==
+                ArraySectionAnalyzer::SlicesOverlapKind::DefinitelyIdentical &&
+            !hlfir::Entity{match.array}.mayHaveNonDefaultLowerBounds() &&
+            areForwardIndices(indices, elementalIndices)) {
+          match.mustBeOrdered = true;
+          continue;
+        }
 
         LLVM_DEBUG(llvm::dbgs() << "possible read conflict: " << designate
                                 << " at " << elemental.getLoc() << "\n");
@@ -615,8 +714,9 @@ llvm::LogicalResult ElementalAssignBufferization::matchAndRewrite(
 
   // Generate a loop nest looping around the hlfir.elemental shape and clone
   // hlfir.elemental region inside the inner loop
+  bool isUnordered = !elemental.isOrdered() && !match->mustBeOrdered;
   hlfir::LoopNest loopNest =
-      hlfir::genLoopNest(loc, builder, extents, !elemental.isOrdered(),
+      hlfir::genLoopNest(loc, builder, extents, isUnordered,
                          flangomp::shouldUseWorkshareLowering(elemental));
   builder.setInsertionPointToStart(loopNest.body);
   auto yield = hlfir::inlineElementalOp(loc, builder, elemental,
@@ -768,14 +868,23 @@ llvm::LogicalResult VariableAssignBufferization::matchAndRewrite(
 
   fir::AliasAnalysis aliasAnalysis;
   mlir::AliasResult aliasRes = aliasAnalysis.alias(lhs, rhs);
-  // TODO: use areIdenticalOrDisjointSlices() to check if
-  // we can still do the expansion.
+  // If the alias analysis cannot tell, the LHS and RHS may still be designators
+  // of the same array whose relation is known. Identical or disjoint slices can
+  // be assigned in any order. A slice shifted forward can be assigned in the
+  // order of the array elements, e.g. a(1:n-1) = a(2:n).
+  bool isUnordered = true;
   if (!aliasRes.isNo()) {
-    LLVM_DEBUG(llvm::dbgs() << "VariableAssignBufferization:\n"
-                            << "\tLHS: " << lhs << "\n"
-                            << "\tRHS: " << rhs << "\n"
-                            << "\tALIAS: " << aliasRes << "\n");
-    return rewriter.notifyMatchFailure(assign, "RHS/LHS may alias");
+    using OverlapKind = ArraySectionAnalyzer::SlicesOverlapKind;
+    OverlapKind overlap = ArraySectionAnalyzer::analyze(lhs, rhs);
+    if (overlap == OverlapKind::ForwardOverlap) {
+      isUnordered = false;
+    } else if (overlap == OverlapKind::Unknown) {
+      LLVM_DEBUG(llvm::dbgs() << "VariableAssignBufferization:\n"
+                              << "\tLHS: " << lhs << "\n"
+                              << "\tRHS: " << rhs << "\n"
+                              << "\tALIAS: " << aliasRes << "\n");
+      return rewriter.notifyMatchFailure(assign, "RHS/LHS may alias");
+    }
   }
 
   mlir::Location loc = assign->getLoc();
@@ -787,7 +896,7 @@ llvm::LogicalResult VariableAssignBufferization::matchAndRewrite(
   llvm::SmallVector<mlir::Value> extents =
       hlfir::getIndexExtents(loc, builder, shape);
   hlfir::LoopNest loopNest =
-      hlfir::genLoopNest(loc, builder, extents, /*isUnordered=*/true,
+      hlfir::genLoopNest(loc, builder, extents, isUnordered,
                          flangomp::shouldUseWorkshareLowering(assign));
   builder.setInsertionPointToStart(loopNest.body);
   auto rhsArrayElement =
@@ -17,6 +17,7 @@
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <cstring>
@@ -43,6 +44,12 @@ static cl::opt<std::string>
     SizeDistributionName("size-distribution-name",
                          cl::desc("The name of the distribution to use"));
 
+static cl::opt<std::string> SizeDistributionFile(
+    "size-distribution-file",
+    cl::desc("A file holding a histogram of sizes captured at runtime, one "
+             "'<size>,<count>' pair per line"),
+    cl::value_desc("filename"));
+
 static cl::opt<bool> SweepMode(
     "sweep-mode",
     cl::desc(
@@ -261,16 +268,36 @@ void main() {
                        Twine(" must be a power of two or zero"));
 
   const bool HasDistributionName = !SizeDistributionName.empty();
-  if (SweepMode && HasDistributionName)
+  const bool HasDistributionFile = !SizeDistributionFile.empty();
+  if (SweepMode + HasDistributionName + HasDistributionFile > 1)
     report_fatal_error("Select only one of `--" + Twine(SweepMode.ArgStr) +
-                       "` or `--" + Twine(SizeDistributionName.ArgStr) + "`");
+                       "`, `--" + Twine(SizeDistributionName.ArgStr) +
+                       "` or `--" + Twine(SizeDistributionFile.ArgStr) + "`");
 
   std::unique_ptr<MemfunctionBenchmarkBase> Benchmark;
-  if (SweepMode)
+  // Backs the distribution read from SizeDistributionFile.
+  std::vector<double> Probabilities;
+  if (SweepMode) {
     Benchmark.reset(new MemfunctionBenchmarkSweep());
-  else
+  } else if (HasDistributionFile) {
+    auto BufferOrErr = MemoryBuffer::getFile(SizeDistributionFile);
+    if (!BufferOrErr)
+      report_fatal_error(Twine("Could not open file: ")
+                             .concat(BufferOrErr.getError().message())
+                             .concat(", ")
+                             .concat(SizeDistributionFile));
+    auto ProbabilitiesOrErr = parseSizeHistogram((*BufferOrErr)->getBuffer());
+    if (!ProbabilitiesOrErr)
+      report_fatal_error(Twine(SizeDistributionFile)
+                             .concat(": ")
+                             .concat(toString(ProbabilitiesOrErr.takeError())));
+    Probabilities = std::move(*ProbabilitiesOrErr);
+    Benchmark.reset(new MemfunctionBenchmarkDistribution(
+        {sys::path::stem(SizeDistributionFile), Probabilities}));
+  } else {
     Benchmark.reset(new MemfunctionBenchmarkDistribution(getDistributionOrDie(
         BenchmarkSetup::getDistributions(), SizeDistributionName)));
+  }
   writeStudy(Benchmark->run());
 }
 
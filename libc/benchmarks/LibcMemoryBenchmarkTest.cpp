@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "LibcMemoryBenchmark.h"
+#include "MemorySizeDistributions.h"
 #include "llvm/Support/Alignment.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -14,6 +15,7 @@
 
 using testing::AllOf;
 using testing::AnyOf;
+using testing::DoubleEq;
 using testing::ElementsAre;
 using testing::Ge;
 using testing::Gt;
@@ -102,6 +104,33 @@ TEST(MismatchOffsetDistribution, MismatchAt2) {
   }
 }
 
+TEST(SizeHistogram, Parse) {
+  auto ProbabilitiesOrErr = parseSizeHistogram("# size,count\n"
+                                               "3,1\n"
+                                               "\n"
+                                               "0, 2\n"
+                                               "1,1\n");
+  ASSERT_TRUE(static_cast<bool>(ProbabilitiesOrErr));
+  EXPECT_THAT(*ProbabilitiesOrErr, ElementsAre(DoubleEq(0.5), DoubleEq(0.25),
+                                               DoubleEq(0), DoubleEq(0.25)));
+}
+
+static bool isInvalidHistogram(StringRef Histogram) {
+  auto ProbabilitiesOrErr = parseSizeHistogram(Histogram);
+  if (ProbabilitiesOrErr)
+    return false;
+  consumeError(ProbabilitiesOrErr.takeError());
+  return true;
+}
+
+TEST(SizeHistogram, Invalid) {
+  EXPECT_TRUE(isInvalidHistogram("1;2\n"));
+  EXPECT_TRUE(isInvalidHistogram("-1,2\n"));
+  EXPECT_TRUE(isInvalidHistogram("1,2,3\n"));
+  // No observation.
+  EXPECT_TRUE(isInvalidHistogram("# size,count\n1,0\n"));
+}
+
 } // namespace
 } // namespace libc_benchmarks
 } // namespace llvm
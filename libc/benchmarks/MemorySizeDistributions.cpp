@@ -1,8 +1,12 @@
 #include "MemorySizeDistributions.h"
 
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+#include <tuple>
+
 namespace llvm {
 namespace libc_benchmarks {
 
@@ -198,5 +202,46 @@ getDistributionOrDie(ArrayRef<MemorySizeDistribution> Distributions,
   report_fatal_error(Message);
 }
 
+Expected<std::vector<double>> parseSizeHistogram(StringRef Histogram) {
+  // Large sizes are accepted, but the benchmark buffers must be able to hold
+  // them.
+  static constexpr uint64_t MaxSize = 1ULL << 30;
+  SmallVector<std::pair<uint64_t, uint64_t>, 0> Entries;
+  uint64_t MaxSeenSize = 0;
+  uint64_t Total = 0;
+  size_t LineNumber = 0;
+  while (!Histogram.empty()) {
+    StringRef Line;
+    std::tie(Line, Histogram) = Histogram.split('\n');
+    ++LineNumber;
+    Line = Line.trim();
+    if (Line.empty() || Line.starts_with("#"))
+      continue;
+    auto [SizeStr, CountStr] = Line.split(',');
+    uint64_t Size, Count;
+    if (SizeStr.trim().getAsInteger(10, Size) ||
+        CountStr.trim().getAsInteger(10, Count))
+      return createStringError(inconvertibleErrorCode(),
+                               "line %zu: expected '<size>,<count>'",
+                               LineNumber);
+    if (Size > MaxSize)
+      return createStringError(inconvertibleErrorCode(),
+                               "line %zu: size is larger than %llu bytes",
+                               LineNumber,
+                               static_cast<unsigned long long>(MaxSize));
+    Entries.emplace_back(Size, Count);
+    MaxSeenSize = std::max(MaxSeenSize, Size);
+    Total += Count;
+  }
+  if (Total == 0)
+    return createStringError(inconvertibleErrorCode(),
+                             "the histogram holds no observation");
+
+  std::vector<double> Probabilities(MaxSeenSize + 1);
+  for (const auto &[Size, Count] : Entries)
+    Probabilities[Size] += static_cast<double>(Count) / Total;
+  return Probabilities;
+}
+
 } // namespace libc_benchmarks
 } // namespace llvm
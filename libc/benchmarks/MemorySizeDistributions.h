@@ -18,6 +18,9 @@
 
 #include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/StringRef.h>
+#include <llvm/Support/Error.h>
+
+#include <vector>
 
 namespace llvm {
 namespace libc_benchmarks {
@@ -47,6 +50,12 @@ MemorySizeDistribution
 getDistributionOrDie(ArrayRef<MemorySizeDistribution> Distributions,
                      StringRef Name);
 
+/// Parses a histogram of sizes captured at runtime, e.g. from a production
+/// profile. Each line holds a size and the number of times it was observed,
+/// separated by a comma. Empty lines and lines starting with '#' are ignored.
+/// Returns the size indexed array of probabilities.
+Expected<std::vector<double>> parseSizeHistogram(StringRef Histogram);
+
 } // namespace libc_benchmarks
 } // namespace llvm
 
@@ -10,13 +10,21 @@
 #include "src/__support/macros/config.h"
 #include "src/string/memory_utils/inline_memcmp.h"
 
+#ifdef LIBC_COPT_MEMORY_FUNCTIONS_X86_RUNTIME_DISPATCH
+#include "src/string/memory_utils/x86_64/runtime_dispatch.h"
+#endif
+
 #include <stddef.h> // size_t
 
 namespace LIBC_NAMESPACE_DECL {
 
 LLVM_LIBC_FUNCTION(int, memcmp,
                    (const void *lhs, const void *rhs, size_t count)) {
+#ifdef LIBC_COPT_MEMORY_FUNCTIONS_X86_RUNTIME_DISPATCH
+  return x86::dispatched_memcmp(lhs, rhs, count);
+#else
   return inline_memcmp(lhs, rhs, count);
+#endif
 }
 
 } // namespace LIBC_NAMESPACE_DECL
@@ -11,12 +11,20 @@
 #include "src/__support/macros/config.h"
 #include "src/string/memory_utils/inline_memcpy.h"
 
+#ifdef LIBC_COPT_MEMORY_FUNCTIONS_X86_RUNTIME_DISPATCH
+#include "src/string/memory_utils/x86_64/runtime_dispatch.h"
+#endif
+
 namespace LIBC_NAMESPACE_DECL {
 
 LLVM_LIBC_FUNCTION(void *, memcpy,
                    (void *__restrict dst, const void *__restrict src,
                     size_t size)) {
+#ifdef LIBC_COPT_MEMORY_FUNCTIONS_X86_RUNTIME_DISPATCH
+  x86::dispatched_memcpy(dst, src, size);
+#else
   inline_memcpy(dst, src, size);
+#endif
   return dst;
 }
 
@@ -60,6 +60,14 @@ struct Memcpy {
   }
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// Memset repstosb implementation
+struct Memset {
+  LIBC_INLINE static void repstosb(void *dst, uint8_t value, size_t count) {
+    asm volatile("rep stosb" : "+D"(dst), "+c"(count) : "a"(value) : "memory");
+  }
+};
+
 } // namespace x86
 } // namespace LIBC_NAMESPACE_DECL
 
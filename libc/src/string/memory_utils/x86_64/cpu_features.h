@@ -0,0 +1,126 @@
+//===-- Runtime detection of x86 features for memory functions --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file queries the features of the running CPU that are relevant to the
+// runtime dispatched memory functions. It is self-contained so that it can run
+// before anything else has been initialized, and it must not call any memory
+// function itself.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_LIBC_SRC_STRING_MEMORY_UTILS_X86_64_CPU_FEATURES_H
+#define LLVM_LIBC_SRC_STRING_MEMORY_UTILS_X86_64_CPU_FEATURES_H
+
+#include "src/__support/macros/attributes.h" // LIBC_INLINE
+#include "src/__support/macros/config.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t, uint64_t
+
+namespace LIBC_NAMESPACE_DECL {
+namespace x86 {
+
+struct CpuFeatures {
+  bool avx2 = false;
+  bool bmi2 = false;
+  bool avx512f = false;
+  bool avx512bw = false;
+  // Enhanced REP MOVSB/STOSB.
+  bool erms = false;
+  // The size of the last level cache that a single thread can expect to use,
+  // or zero if it can't be determined.
+  size_t llc_size_per_thread = 0;
+};
+
+struct CpuidRegs {
+  uint32_t eax, ebx, ecx, edx;
+};
+
+LIBC_INLINE CpuidRegs cpuid(uint32_t leaf, uint32_t subleaf = 0) {
+  CpuidRegs regs;
+  asm volatile("cpuid"
+               : "=a"(regs.eax), "=b"(regs.ebx), "=c"(regs.ecx), "=d"(regs.edx)
+               : "a"(leaf), "c"(subleaf));
+  return regs;
+}
+
+// Returns the state components that the OS saves on context switches.
+LIBC_INLINE uint64_t xgetbv0() {
+  uint32_t eax, edx;
+  asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+
+LIBC_INLINE bool has_bit(uint32_t reg, unsigned bit) {
+  return (reg >> bit) & 1;
+}
+
+// Walks the deterministic cache parameters (leaf 4 on Intel, 0x8000001D on
+// AMD, both share the same layout) and returns the share of the last level
+// cache of a single thread.
+LIBC_INLINE size_t get_llc_size_per_thread(uint32_t leaf) {
+  size_t llc_size = 0;
+  for (uint32_t subleaf = 0; subleaf < 16; ++subleaf) {
+    const CpuidRegs regs = cpuid(leaf, subleaf);
+    const uint32_t type = regs.eax & 0x1f;
+    if (type == 0) // No more caches.
+      break;
+    if (type == 2) // Instruction cache.
+      continue;
+    const size_t ways = (regs.ebx >> 22) + 1;
+    const size_t partitions = ((regs.ebx >> 12) & 0x3ff) + 1;
+    const size_t line_size = (regs.ebx & 0xfff) + 1;
+    const size_t sets = static_cast<size_t>(regs.ecx) + 1;
+    const size_t sharing_threads = ((regs.eax >> 14) & 0xfff) + 1;
+    // Caches are listed from the innermost level outwards.
+    llc_size = ways * partitions * line_size * sets / sharing_threads;
+  }
+  return llc_size;
+}
+
+LIBC_INLINE CpuFeatures detect_cpu_features() {
+  CpuFeatures features;
+  const CpuidRegs leaf0 = cpuid(0);
+  const uint32_t max_leaf = leaf0.eax;
+  if (max_leaf < 1)
+    return features;
+
+  const CpuidRegs leaf1 = cpuid(1);
+  const bool osxsave = has_bit(leaf1.ecx, 27);
+  const uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+  // The OS must save the XMM and YMM registers, and for AVX-512 also the
+  // opmask and upper ZMM registers.
+  const bool os_avx = (xcr0 & 0x6) == 0x6;
+  const bool os_avx512 = (xcr0 & 0xe6) == 0xe6;
+
+  if (max_leaf >= 7) {
+    const CpuidRegs leaf7 = cpuid(7, 0);
+    features.avx2 = os_avx && has_bit(leaf7.ebx, 5);
+    features.bmi2 = has_bit(leaf7.ebx, 8);
+    features.erms = has_bit(leaf7.ebx, 9);
+    features.avx512f = os_avx512 && has_bit(leaf7.ebx, 16);
+    features.avx512bw = features.avx512f && has_bit(leaf7.ebx, 30);
+  }
+
+  // "AuthenticAMD" and "HygonGenuine" report their caches in leaf 0x8000001D.
+  const bool is_amd = (leaf0.ebx == 0x68747541 && leaf0.edx == 0x69746e65 &&
+                       leaf0.ecx == 0x444d4163) ||
+                      (leaf0.ebx == 0x6f677948 && leaf0.edx == 0x6e65476e &&
+                       leaf0.ecx == 0x656e6975);
+  if (is_amd) {
+    if (cpuid(0x80000000).eax >= 0x8000001D)
+      features.llc_size_per_thread = get_llc_size_per_thread(0x8000001D);
+  } else if (max_leaf >= 4) {
+    features.llc_size_per_thread = get_llc_size_per_thread(4);
+  }
+  return features;
+}
+
+} // namespace x86
+} // namespace LIBC_NAMESPACE_DECL
+
+#endif // LLVM_LIBC_SRC_STRING_MEMORY_UTILS_X86_64_CPU_FEATURES_H
@@ -0,0 +1,116 @@
+//===-- ISA specific variants of the dispatched memory functions ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is compiled once per ISA level, with the matching -march flag and
+// LIBC_COPT_X86_DISPATCH_VARIANT set to the suffix of the functions it
+// defines, e.g. 'avx2' for memcpy_avx2 (see runtime_dispatch.h).
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/macros/config.h"
+#include "src/__support/macros/optimization.h" // LIBC_LIKELY
+#include "src/string/memory_utils/inline_memcmp.h"
+#include "src/string/memory_utils/inline_memcpy.h"
+#include "src/string/memory_utils/inline_memset.h"
+#include "src/string/memory_utils/op_x86.h"
+#include "src/string/memory_utils/utils.h"
+#include "src/string/memory_utils/x86_64/runtime_dispatch.h"
+
+#include <immintrin.h>
+
+#ifndef LIBC_COPT_X86_DISPATCH_VARIANT
+#error "LIBC_COPT_X86_DISPATCH_VARIANT must be set to the ISA level"
+#endif
+
+#define LIBC_X86_DISPATCH_CONCAT_IMPL(A, B) A##_##B
+#define LIBC_X86_DISPATCH_CONCAT(A, B) LIBC_X86_DISPATCH_CONCAT_IMPL(A, B)
+#define LIBC_X86_DISPATCH_NAME(FN)                                             \
+  LIBC_X86_DISPATCH_CONCAT(FN, LIBC_COPT_X86_DISPATCH_VARIANT)
+
+namespace LIBC_NAMESPACE_DECL {
+namespace x86 {
+namespace dispatch {
+
+// Streaming stores write whole cache lines, so the destination is aligned and
+// the bulk of the buffer is processed one cache line at a time. The 16-byte
+// forms are used at every ISA level: these loops are bound by the memory
+// bandwidth, not by the width of the stores.
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+[[gnu::noinline]] static void copy_non_temporal(Ptr dst, CPtr src,
+                                                size_t count) {
+  const size_t head = distance_to_align_up<CACHE_LINE_SIZE>(dst);
+  inline_memcpy(dst, src, head);
+  dst += head;
+  src += head;
+  count -= head;
+  for (; count >= CACHE_LINE_SIZE; count -= CACHE_LINE_SIZE) {
+    const __m128i *s = reinterpret_cast<const __m128i *>(src);
+    __m128i *d = reinterpret_cast<__m128i *>(dst);
+    const __m128i v0 = _mm_loadu_si128(s + 0);
+    const __m128i v1 = _mm_loadu_si128(s + 1);
+    const __m128i v2 = _mm_loadu_si128(s + 2);
+    const __m128i v3 = _mm_loadu_si128(s + 3);
+    _mm_stream_si128(d + 0, v0);
+    _mm_stream_si128(d + 1, v1);
+    _mm_stream_si128(d + 2, v2);
+    _mm_stream_si128(d + 3, v3);
+    dst += CACHE_LINE_SIZE;
+    src += CACHE_LINE_SIZE;
+  }
+  // Streaming stores are weakly ordered, make them visible before returning.
+  _mm_sfence();
+  inline_memcpy(dst, src, count);
+}
+
+[[gnu::noinline]] static void set_non_temporal(Ptr dst, uint8_t value,
+                                               size_t count) {
+  const size_t head = distance_to_align_up<CACHE_LINE_SIZE>(dst);
+  inline_memset(dst, value, head);
+  dst += head;
+  count -= head;
+  const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+  for (; count >= CACHE_LINE_SIZE; count -= CACHE_LINE_SIZE) {
+    __m128i *d = reinterpret_cast<__m128i *>(dst);
+    _mm_stream_si128(d + 0, v);
+    _mm_stream_si128(d + 1, v);
+    _mm_stream_si128(d + 2, v);
+    _mm_stream_si128(d + 3, v);
+    dst += CACHE_LINE_SIZE;
+  }
+  _mm_sfence();
+  inline_memset(dst, value, count);
+}
+
+void LIBC_X86_DISPATCH_NAME(memcpy)(Ptr dst, CPtr src, size_t count) {
+  if (LIBC_LIKELY(count < MIN_STRING_OP_SIZE))
+    return inline_memcpy(dst, src, count);
+  if (count >= thresholds.non_temporal.load(cpp::MemoryOrder::RELAXED))
+    return copy_non_temporal(dst, src, count);
+  if (count >= thresholds.repmovsb.load(cpp::MemoryOrder::RELAXED))
+    return Memcpy::repmovsb(dst, src, count);
+  return inline_memcpy(dst, src, count);
+}
+
+void LIBC_X86_DISPATCH_NAME(memset)(Ptr dst, uint8_t value, size_t count) {
+  if (LIBC_LIKELY(count < MIN_STRING_OP_SIZE))
+    return inline_memset(dst, value, count);
+  if (count >= thresholds.non_temporal.load(cpp::MemoryOrder::RELAXED))
+    return set_non_temporal(dst, value, count);
+  if (count >= thresholds.repstosb.load(cpp::MemoryOrder::RELAXED))
+    return Memset::repstosb(dst, value, count);
+  return inline_memset(dst, value, count);
+}
+
+int LIBC_X86_DISPATCH_NAME(memcmp)(CPtr p1, CPtr p2, size_t count) {
+  return inline_memcmp(p1, p2, count);
+}
+
+} // namespace dispatch
+} // namespace x86
+} // namespace LIBC_NAMESPACE_DECL
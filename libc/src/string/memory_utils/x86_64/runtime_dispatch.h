@@ -0,0 +1,168 @@
+//===-- Runtime dispatch of x86 memory functions ----------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// When LIBC_COPT_MEMORY_FUNCTIONS_X86_RUNTIME_DISPATCH is set, the memcpy,
+// memset and memcmp entrypoints are built for baseline x86-64 and forward to
+// one of several variants compiled for higher ISA levels (see
+// dispatch_variant.cpp). The variant is chosen on the first call from the
+// features of the running CPU.
+//
+// IFUNC would avoid the indirect call, but the IRELATIVE relocations it relies
+// on are not processed by the startup code of the full build. Instead each
+// function starts out pointing to a resolver that selects the implementation,
+// publishes it and then forwards the call. Concurrent first calls resolve to
+// the same values, so the race between them is benign.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_LIBC_SRC_STRING_MEMORY_UTILS_X86_64_RUNTIME_DISPATCH_H
+#define LLVM_LIBC_SRC_STRING_MEMORY_UTILS_X86_64_RUNTIME_DISPATCH_H
+
+#include "src/__support/CPP/algorithm.h" // max
+#include "src/__support/CPP/atomic.h"
+#include "src/__support/macros/attributes.h" // LIBC_INLINE
+#include "src/__support/macros/config.h"
+#include "src/string/memory_utils/utils.h" // Ptr, CPtr
+#include "src/string/memory_utils/x86_64/cpu_features.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uint8_t, SIZE_MAX
+
+namespace LIBC_NAMESPACE_DECL {
+namespace x86 {
+namespace dispatch {
+
+using MemcpyFn = void (*)(Ptr, CPtr, size_t);
+using MemsetFn = void (*)(Ptr, uint8_t, size_t);
+using MemcmpFn = int (*)(CPtr, CPtr, size_t);
+
+// Defined in dispatch_variant.cpp, once per ISA level.
+void memcpy_sse2(Ptr dst, CPtr src, size_t count);
+void memcpy_avx2(Ptr dst, CPtr src, size_t count);
+void memcpy_avx512(Ptr dst, CPtr src, size_t count);
+void memset_sse2(Ptr dst, uint8_t value, size_t count);
+void memset_avx2(Ptr dst, uint8_t value, size_t count);
+void memset_avx512(Ptr dst, uint8_t value, size_t count);
+int memcmp_sse2(CPtr p1, CPtr p2, size_t count);
+int memcmp_avx2(CPtr p1, CPtr p2, size_t count);
+int memcmp_avx512(CPtr p1, CPtr p2, size_t count);
+
+// Sizes below this are always handled by the vectorized implementation, so
+// that the variants only read the thresholds below for large operations.
+LIBC_INLINE_VAR constexpr size_t MIN_STRING_OP_SIZE = 2048;
+
+// The size class boundaries of the running CPU, set by resolve(). A threshold
+// of SIZE_MAX disables the corresponding strategy.
+struct Thresholds {
+  // From this size on, memcpy uses 'rep movsb'. ERMS makes it faster than
+  // vector loops for large copies, the crossover point growing with the
+  // vector width.
+  cpp::Atomic<size_t> repmovsb{SIZE_MAX};
+  // From this size on, memset uses 'rep stosb'.
+  cpp::Atomic<size_t> repstosb{SIZE_MAX};
+  // From this size on, memcpy and memset bypass the caches with non-temporal
+  // stores. The destination would not fit in the cache anyway and would only
+  // evict the working set of the program.
+  cpp::Atomic<size_t> non_temporal{SIZE_MAX};
+};
+
+LIBC_INLINE_VAR Thresholds thresholds;
+
+LIBC_INLINE void resolve();
+
+LIBC_INLINE void memcpy_resolve(Ptr dst, CPtr src, size_t count);
+LIBC_INLINE void memset_resolve(Ptr dst, uint8_t value, size_t count);
+LIBC_INLINE int memcmp_resolve(CPtr p1, CPtr p2, size_t count);
+
+LIBC_INLINE_VAR cpp::Atomic<MemcpyFn> memcpy_impl{&memcpy_resolve};
+LIBC_INLINE_VAR cpp::Atomic<MemsetFn> memset_impl{&memset_resolve};
+LIBC_INLINE_VAR cpp::Atomic<MemcmpFn> memcmp_impl{&memcmp_resolve};
+
+LIBC_INLINE void resolve() {
+  const CpuFeatures features = detect_cpu_features();
+  // Checking AVX512BW (resp. AVX2 and BMI2) is enough for the CPUs that
+  // exist to also support the rest of -march=skylake-avx512 (resp. haswell).
+  enum class Level { SSE2, AVX2, AVX512 };
+  const Level level = features.avx512bw                 ? Level::AVX512
+                      : features.avx2 && features.bmi2 ? Level::AVX2
+                                                       : Level::SSE2;
+  size_t vector_size = 16;
+  if (level == Level::AVX2)
+    vector_size = 32;
+  else if (level == Level::AVX512)
+    vector_size = 64;
+
+  if (features.erms) {
+    thresholds.repmovsb.store(MIN_STRING_OP_SIZE * (vector_size / 16),
+                              cpp::MemoryOrder::RELAXED);
+    thresholds.repstosb.store(MIN_STRING_OP_SIZE, cpp::MemoryOrder::RELAXED);
+  }
+  // Leave some of the cache to the rest of the program.
+  if (features.llc_size_per_thread)
+    thresholds.non_temporal.store(
+        cpp::max(features.llc_size_per_thread / 4 * 3, MIN_STRING_OP_SIZE),
+        cpp::MemoryOrder::RELAXED);
+
+  // The release stores make the thresholds visible to the threads that call
+  // through the new pointers.
+  switch (level) {
+  case Level::AVX512:
+    memcpy_impl.store(&memcpy_avx512, cpp::MemoryOrder::RELEASE);
+    memset_impl.store(&memset_avx512, cpp::MemoryOrder::RELEASE);
+    memcmp_impl.store(&memcmp_avx512, cpp::MemoryOrder::RELEASE);
+    break;
+  case Level::AVX2:
+    memcpy_impl.store(&memcpy_avx2, cpp::MemoryOrder::RELEASE);
+    memset_impl.store(&memset_avx2, cpp::MemoryOrder::RELEASE);
+    memcmp_impl.store(&memcmp_avx2, cpp::MemoryOrder::RELEASE);
+    break;
+  case Level::SSE2:
+    memcpy_impl.store(&memcpy_sse2, cpp::MemoryOrder::RELEASE);
+    memset_impl.store(&memset_sse2, cpp::MemoryOrder::RELEASE);
+    memcmp_impl.store(&memcmp_sse2, cpp::MemoryOrder::RELEASE);
+    break;
+  }
+}
+
+LIBC_INLINE void memcpy_resolve(Ptr dst, CPtr src, size_t count) {
+  resolve();
+  memcpy_impl.load(cpp::MemoryOrder::ACQUIRE)(dst, src, count);
+}
+
+LIBC_INLINE void memset_resolve(Ptr dst, uint8_t value, size_t count) {
+  resolve();
+  memset_impl.load(cpp::MemoryOrder::ACQUIRE)(dst, value, count);
+}
+
+LIBC_INLINE int memcmp_resolve(CPtr p1, CPtr p2, size_t count) {
+  resolve();
+  return memcmp_impl.load(cpp::MemoryOrder::ACQUIRE)(p1, p2, count);
+}
+
+} // namespace dispatch
+
+LIBC_INLINE void dispatched_memcpy(void *__restrict dst,
+                                   const void *__restrict src, size_t count) {
+  dispatch::memcpy_impl.load(cpp::MemoryOrder::ACQUIRE)(
+      reinterpret_cast<Ptr>(dst), reinterpret_cast<CPtr>(src), count);
+}
+
+LIBC_INLINE void dispatched_memset(void *dst, uint8_t value, size_t count) {
+  dispatch::memset_impl.load(cpp::MemoryOrder::ACQUIRE)(
+      reinterpret_cast<Ptr>(dst), value, count);
+}
+
+LIBC_INLINE int dispatched_memcmp(const void *p1, const void *p2,
+                                  size_t count) {
+  return dispatch::memcmp_impl.load(cpp::MemoryOrder::ACQUIRE)(
+      reinterpret_cast<CPtr>(p1), reinterpret_cast<CPtr>(p2), count);
+}
+
+} // namespace x86
+} // namespace LIBC_NAMESPACE_DECL
+
+#endif // LLVM_LIBC_SRC_STRING_MEMORY_UTILS_X86_64_RUNTIME_DISPATCH_H
@@ -11,10 +11,18 @@
 #include "src/__support/macros/config.h"
 #include "src/string/memory_utils/inline_memset.h"
 
+#ifdef LIBC_COPT_MEMORY_FUNCTIONS_X86_RUNTIME_DISPATCH
+#include "src/string/memory_utils/x86_64/runtime_dispatch.h"
+#endif
+
 namespace LIBC_NAMESPACE_DECL {
 
 LLVM_LIBC_FUNCTION(void *, memset, (void *dst, int value, size_t count)) {
+#ifdef LIBC_COPT_MEMORY_FUNCTIONS_X86_RUNTIME_DISPATCH
+  x86::dispatched_memset(dst, static_cast<uint8_t>(value), count);
+#else
   inline_memset(dst, static_cast<uint8_t>(value), count);
+#endif
   return dst;
 }
 
@@ -36,6 +36,20 @@ TEST(LlvmLibcMemcpyTest, SizeSweep) {
   }
 }
 
+// Large sizes may be handled by 'rep movsb' or non-temporal stores.
+TEST(LlvmLibcMemcpyTest, LargeSizes) {
+  static constexpr size_t kMaxSize = 16 << 20;
+  static constexpr size_t kSizes[] = {2048, 4097, 65536, 1 << 20, kMaxSize};
+  Buffer SrcBuffer(kMaxSize, Aligned::NO);
+  Buffer DstBuffer(kMaxSize, Aligned::NO);
+  Randomize(SrcBuffer.span());
+  for (size_t size : kSizes) {
+    auto src = SrcBuffer.span().subspan(0, size);
+    auto dst = DstBuffer.span().subspan(0, size);
+    ASSERT_TRUE(CheckMemcpy<Adaptor>(dst, src, size));
+  }
+}
+
 #if !defined(LIBC_FULL_BUILD) && defined(LIBC_TARGET_OS_IS_LINUX)
 
 TEST(LlvmLibcMemcpyTest, CheckAccess) {
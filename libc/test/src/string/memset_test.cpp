@@ -33,6 +33,18 @@ TEST(LlvmLibcMemsetTest, SizeSweep) {
   }
 }
 
+// Large sizes may be handled by 'rep stosb' or non-temporal stores.
+TEST(LlvmLibcMemsetTest, LargeSizes) {
+  static constexpr size_t kMaxSize = 16 << 20;
+  static constexpr size_t kSizes[] = {2048, 4097, 65536, 1 << 20, kMaxSize};
+  Buffer DstBuffer(kMaxSize, Aligned::NO);
+  for (size_t size : kSizes) {
+    const char value = size % 10;
+    auto dst = DstBuffer.span().subspan(0, size);
+    ASSERT_TRUE((CheckMemset<Adaptor>(dst, value, size)));
+  }
+}
+
 #if !defined(LIBC_FULL_BUILD) && defined(LIBC_TARGET_OS_IS_LINUX)
 
 TEST(LlvmLibcMemsetTest, CheckAccess) {
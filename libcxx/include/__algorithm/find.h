@@ -12,19 +12,25 @@
 
 #include <__algorithm/find_segment_if.h>
 #include <__algorithm/min.h>
+#include <__algorithm/simd_utils.h>
 #include <__algorithm/unwrap_iter.h>
+#include <__bit/bit_cast.h>
 #include <__bit/countr.h>
 #include <__bit/invert_if.h>
 #include <__config>
 #include <__functional/identity.h>
 #include <__fwd/bit_reference.h>
+#include <__iterator/aliasing_iterator.h>
+#include <__iterator/iterator_traits.h>
 #include <__iterator/segmented_iterator.h>
 #include <__string/constexpr_c_functions.h>
 #include <__type_traits/enable_if.h>
 #include <__type_traits/invoke.h>
+#include <__type_traits/is_constant_evaluated.h>
 #include <__type_traits/is_equality_comparable.h>
 #include <__type_traits/is_integral.h>
 #include <__type_traits/is_signed.h>
+#include <__type_traits/is_volatile.h>
 #include <__utility/move.h>
 #include <limits>
 
@@ -78,6 +84,84 @@ _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX14 _Tp* __find(_Tp* __first, _T
 }
 #endif // _LIBCPP_HAS_WIDE_CHARACTERS
 
+#if _LIBCPP_VECTORIZE_ALGORITHMS
+template <class _Iter>
+[[__nodiscard__]] _LIBCPP_HIDE_FROM_ABI _Iter
+__find_vectorized(_Iter __first, _Iter __last, __iter_value_type<_Iter> __value) {
+  using __value_type              = __iter_value_type<_Iter>;
+  constexpr size_t __unroll_count = 4;
+  constexpr size_t __vec_size     = __native_vector_size<__value_type>;
+  using __vec                     = __simd_vector<__value_type, __vec_size>;
+
+  auto __orig_first = __first;
+  while (static_cast<size_t>(__last - __first) >= __unroll_count * __vec_size) {
+    __vec __vals[__unroll_count];
+
+    for (size_t __i = 0; __i != __unroll_count; ++__i)
+      __vals[__i] = std::__load_vector<__vec>(__first + __i * __vec_size);
+
+    for (size_t __i = 0; __i != __unroll_count; ++__i) {
+      if (auto __cmp_res = __vals[__i] == __value; std::__any_of(__cmp_res))
+        return __first + (__i * __vec_size + std::__find_first_set(__cmp_res));
+    }
+
+    __first += __unroll_count * __vec_size;
+  }
+
+  // check the remaining 0-3 vectors
+  while (static_cast<size_t>(__last - __first) >= __vec_size) {
+    if (auto __cmp_res = std::__load_vector<__vec>(__first) == __value; std::__any_of(__cmp_res))
+      return __first + std::__find_first_set(__cmp_res);
+    __first += __vec_size;
+  }
+
+  if (__last - __first == 0)
+    return __first;
+
+  // Check if we can load elements in front of the current pointer. If that's the case load a vector at
+  // (last - vector_size) to check the remaining elements. If there is no match, __find_first_set returns the vector
+  // size, i.e. we return __last.
+  if (static_cast<size_t>(__first - __orig_first) >= __vec_size) {
+    __first = __last - __vec_size;
+    return __first + std::__find_first_set(std::__load_vector<__vec>(__first) == __value);
+  } // else loop over the elements individually
+
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      break;
+  return __first;
+}
+
+#  if _LIBCPP_HAS_WIDE_CHARACTERS
+template <class _Tp>
+inline constexpr bool __find_uses_wmemchr_v =
+    sizeof(_Tp) == sizeof(wchar_t) && _LIBCPP_ALIGNOF(_Tp) >= _LIBCPP_ALIGNOF(wchar_t);
+#  else
+template <class _Tp>
+inline constexpr bool __find_uses_wmemchr_v = false;
+#  endif
+
+// The types which aren't handled by memchr or wmemchr above are compared as integers of the same size.
+template <class _Tp,
+          class _Up,
+          class _Proj,
+          __enable_if_t<__is_identity<_Proj>::value && __libcpp_is_trivially_equality_comparable<_Tp, _Up>::value &&
+                            !is_volatile<_Tp>::value && __can_map_to_integer_v<_Tp> && sizeof(_Tp) != 1 &&
+                            !__find_uses_wmemchr_v<_Tp>,
+                        int> = 0>
+_LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX14 _Tp* __find(_Tp* __first, _Tp* __last, const _Up& __value, _Proj&) {
+  if (__libcpp_is_constant_evaluated()) {
+    for (; __first != __last; ++__first)
+      if (*__first == __value)
+        break;
+    return __first;
+  }
+  using __int_type = __get_as_integer_type_t<_Tp>;
+  using _Iter      = __aliasing_iterator<_Tp*, __int_type>;
+  return std::__find_vectorized(_Iter(__first), _Iter(__last), std::__bit_cast<__int_type>(__value)).__base();
+}
+#endif // _LIBCPP_VECTORIZE_ALGORITHMS
+
 // TODO: This should also be possible to get right with different signedness
 // cast integral types to allow vectorization
 template <class _Tp,
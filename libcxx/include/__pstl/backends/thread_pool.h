@@ -0,0 +1,333 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___PSTL_BACKENDS_THREAD_POOL_H
+#define _LIBCPP___PSTL_BACKENDS_THREAD_POOL_H
+
+#include <__algorithm/inplace_merge.h>
+#include <__algorithm/lower_bound.h>
+#include <__algorithm/max.h>
+#include <__algorithm/min.h>
+#include <__algorithm/upper_bound.h>
+#include <__config>
+#include <__cstddef/ptrdiff_t.h>
+#include <__cstddef/size_t.h>
+#include <__iterator/iterator_traits.h>
+#include <__memory/allocator.h>
+#include <__memory/construct_at.h>
+#include <__memory/unique_ptr.h>
+#include <__new/exceptions.h>
+#include <__pstl/backend_fwd.h>
+#include <__pstl/cpu_algos/any_of.h>
+#include <__pstl/cpu_algos/cpu_traits.h>
+#include <__pstl/cpu_algos/fill.h>
+#include <__pstl/cpu_algos/find_if.h>
+#include <__pstl/cpu_algos/for_each.h>
+#include <__pstl/cpu_algos/merge.h>
+#include <__pstl/cpu_algos/stable_sort.h>
+#include <__pstl/cpu_algos/transform.h>
+#include <__pstl/cpu_algos/transform_reduce.h>
+#include <__utility/empty.h>
+#include <__utility/move.h>
+#include <__utility/pair.h>
+#include <optional>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#  pragma GCC system_header
+#endif
+
+_LIBCPP_PUSH_MACROS
+#include <__undef_macros>
+
+#if _LIBCPP_STD_VER >= 17
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+namespace __pstl {
+
+namespace __thread_pool {
+// Runs __func(__context, __chunk) for each chunk in [0, __chunk_count) on the thread pool of the library, and returns
+// once all the chunks have run. The calling thread runs chunks too, so this can be called from a chunk to get nested
+// parallelism.
+_LIBCPP_EXPORTED_FROM_ABI void
+__parallel_apply(size_t __chunk_count, void* __context, void (*__func)(void* __context, size_t __chunk)) noexcept;
+
+template <class _Func>
+_LIBCPP_HIDE_FROM_ABI void __parallel_apply(size_t __chunk_count, _Func __func) noexcept {
+  __thread_pool::__parallel_apply(__chunk_count, &__func, [](void* __context, size_t __chunk) {
+    (*static_cast<_Func*>(__context))(__chunk);
+  });
+}
+
+struct __chunk_partitions {
+  ptrdiff_t __chunk_count_; // includes the first chunk
+  ptrdiff_t __chunk_size_;
+  ptrdiff_t __first_chunk_size_;
+
+  _LIBCPP_HIDE_FROM_ABI ptrdiff_t __chunk_begin(size_t __chunk) const noexcept {
+    return __chunk == 0 ? 0 : __chunk * __chunk_size_ + (__first_chunk_size_ - __chunk_size_);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI ptrdiff_t __chunk_end(size_t __chunk) const noexcept {
+    return __chunk_begin(__chunk) + (__chunk == 0 ? __first_chunk_size_ : __chunk_size_);
+  }
+};
+
+// Splits __size elements into chunks, based on the number of threads in the pool.
+[[__gnu__::__const__]] _LIBCPP_EXPORTED_FROM_ABI __chunk_partitions __partition_chunks(ptrdiff_t __size) noexcept;
+
+template <class _RandomAccessIterator, class _Functor>
+_LIBCPP_HIDE_FROM_ABI optional<__empty>
+__parallel_for(__chunk_partitions __partitions, _RandomAccessIterator __first, _Functor __func) {
+  __thread_pool::__parallel_apply(__partitions.__chunk_count_, [&](size_t __chunk) {
+    __func(__first + __partitions.__chunk_begin(__chunk), __first + __partitions.__chunk_end(__chunk));
+  });
+  return __empty{};
+}
+
+template <class _Tp>
+_LIBCPP_HIDE_FROM_ABI _Tp* __try_allocate(size_t __n) noexcept {
+#  if _LIBCPP_HAS_EXCEPTIONS
+  try {
+#  endif
+    return std::allocator<_Tp>().allocate(__n);
+#  if _LIBCPP_HAS_EXCEPTIONS
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+#  endif
+}
+} // namespace __thread_pool
+
+template <>
+struct __cpu_traits<__thread_pool_backend_tag> {
+  template <class _RandomAccessIterator, class _Functor>
+  _LIBCPP_HIDE_FROM_ABI static optional<__empty>
+  __for_each(_RandomAccessIterator __first, _RandomAccessIterator __last, _Functor __func) {
+    return __thread_pool::__parallel_for(
+        __thread_pool::__partition_chunks(__last - __first), std::move(__first), std::move(__func));
+  }
+
+  template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _RandomAccessIteratorOut>
+  struct __merge_range {
+    _LIBCPP_HIDE_FROM_ABI __merge_range(_RandomAccessIterator1 __mid1, _RandomAccessIterator2 __mid2, _RandomAccessIteratorOut __result)
+        : __mid1_(__mid1), __mid2_(__mid2), __result_(__result) {}
+
+    _RandomAccessIterator1 __mid1_;
+    _RandomAccessIterator2 __mid2_;
+    _RandomAccessIteratorOut __result_;
+  };
+
+  template <typename _RandomAccessIterator1,
+            typename _RandomAccessIterator2,
+            typename _RandomAccessIterator3,
+            typename _Compare,
+            typename _LeafMerge>
+  _LIBCPP_HIDE_FROM_ABI static optional<__empty>
+  __merge(_RandomAccessIterator1 __first1,
+          _RandomAccessIterator1 __last1,
+          _RandomAccessIterator2 __first2,
+          _RandomAccessIterator2 __last2,
+          _RandomAccessIterator3 __result,
+          _Compare __comp,
+          _LeafMerge __leaf_merge) noexcept {
+    __thread_pool::__chunk_partitions __partitions =
+        __thread_pool::__partition_chunks(std::max<ptrdiff_t>(__last1 - __first1, __last2 - __first2));
+
+    if (__partitions.__chunk_count_ == 1) {
+      __leaf_merge(__first1, __last1, __first2, __last2, __result, __comp);
+      return __empty{};
+    }
+
+    using __merge_range_t = __merge_range<_RandomAccessIterator1, _RandomAccessIterator2, _RandomAccessIterator3>;
+    auto const __n_ranges = __partitions.__chunk_count_ + 1;
+
+    auto __destroy = [=](__merge_range_t* __ptr) {
+      std::destroy_n(__ptr, __n_ranges);
+      std::allocator<__merge_range_t>().deallocate(__ptr, __n_ranges);
+    };
+    unique_ptr<__merge_range_t[], decltype(__destroy)> __ranges(
+        __thread_pool::__try_allocate<__merge_range_t>(__n_ranges), __destroy);
+    if (!__ranges)
+      return nullopt;
+
+    // Split the merge at the boundaries of the chunks of the larger range. The elements of the two ranges which are
+    // equivalent to the last element of a chunk stay in the order std::merge would give them.
+    __merge_range_t* __r = __ranges.get();
+    std::__construct_at(__r++, __first1, __first2, __result);
+
+    bool __iterate_first_range = __last1 - __first1 > __last2 - __first2;
+
+    auto __compute_chunk = [&](size_t __chunk_size) -> __merge_range_t {
+      auto [__mid1, __mid2] = [&] {
+        if (__iterate_first_range) {
+          auto __m1 = __first1 + __chunk_size;
+          auto __m2 = std::lower_bound(__first2, __last2, __m1[-1], __comp);
+          return std::make_pair(__m1, __m2);
+        } else {
+          auto __m2 = __first2 + __chunk_size;
+          auto __m1 = std::upper_bound(__first1, __last1, __m2[-1], __comp);
+          return std::make_pair(__m1, __m2);
+        }
+      }();
+
+      __result += (__mid1 - __first1) + (__mid2 - __first2);
+      __first1 = __mid1;
+      __first2 = __mid2;
+      return {std::move(__mid1), std::move(__mid2), __result};
+    };
+
+    // handle first chunk
+    std::__construct_at(__r++, __compute_chunk(__partitions.__first_chunk_size_));
+
+    // handle 2 -> N - 1 chunks
+    for (ptrdiff_t __i = 0; __i != __partitions.__chunk_count_ - 2; ++__i)
+      std::__construct_at(__r++, __compute_chunk(__partitions.__chunk_size_));
+
+    // handle last chunk
+    std::__construct_at(__r, __last1, __last2, __result);
+
+    __thread_pool::__parallel_apply(__partitions.__chunk_count_, [&](size_t __index) {
+      auto __first_iters = __ranges[__index];
+      auto __last_iters  = __ranges[__index + 1];
+      __leaf_merge(
+          __first_iters.__mid1_,
+          __last_iters.__mid1_,
+          __first_iters.__mid2_,
+          __last_iters.__mid2_,
+          __first_iters.__result_,
+          __comp);
+    });
+
+    return __empty{};
+  }
+
+  template <class _RandomAccessIterator, class _Transform, class _Value, class _Combiner, class _Reduction>
+  _LIBCPP_HIDE_FROM_ABI static optional<_Value> __transform_reduce(
+      _RandomAccessIterator __first,
+      _RandomAccessIterator __last,
+      _Transform __transform,
+      _Value __init,
+      _Combiner __combiner,
+      _Reduction __reduction) {
+    if (__first == __last)
+      return __init;
+
+    auto __partitions = __thread_pool::__partition_chunks(__last - __first);
+
+    auto __destroy = [__count = __partitions.__chunk_count_](_Value* __ptr) {
+      std::destroy_n(__ptr, __count);
+      std::allocator<_Value>().deallocate(__ptr, __count);
+    };
+    unique_ptr<_Value[], decltype(__destroy)> __values(
+        __thread_pool::__try_allocate<_Value>(__partitions.__chunk_count_), __destroy);
+    if (!__values)
+      return nullopt;
+
+    // Each chunk is reduced from its own first elements, since there is no identity element to start from.
+    __thread_pool::__parallel_apply(__partitions.__chunk_count_, [&](size_t __chunk) {
+      auto __chunk_first = __first + __partitions.__chunk_begin(__chunk);
+      auto __chunk_last  = __first + __partitions.__chunk_end(__chunk);
+      if (__chunk_last - __chunk_first == 1) {
+        std::__construct_at(__values.get() + __chunk, __transform(__chunk_first));
+      } else {
+        std::__construct_at(
+            __values.get() + __chunk,
+            __reduction(__chunk_first + 2,
+                        __chunk_last,
+                        __combiner(__transform(__chunk_first), __transform(__chunk_first + 1))));
+      }
+    });
+
+    for (ptrdiff_t __i = 0; __i != __partitions.__chunk_count_; ++__i)
+      __init = __combiner(std::move(__init), std::move(__values[__i]));
+    return __init;
+  }
+
+  template <class _RandomAccessIterator, class _Comp, class _LeafSort>
+  _LIBCPP_HIDE_FROM_ABI static optional<__empty>
+  __stable_sort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Comp __comp, _LeafSort __leaf_sort) {
+    auto __partitions    = __thread_pool::__partition_chunks(__last - __first);
+    size_t __chunk_count = __partitions.__chunk_count_;
+
+    __thread_pool::__parallel_apply(__chunk_count, [&](size_t __chunk) {
+      __leaf_sort(__first + __partitions.__chunk_begin(__chunk), __first + __partitions.__chunk_end(__chunk), __comp);
+    });
+
+    // Merge the sorted runs pairwise, doubling their length until a single run is left. std::inplace_merge falls back
+    // to a slower algorithm if it can't allocate its buffer, so this can't fail.
+    for (size_t __run_length = 1; __run_length < __chunk_count; __run_length *= 2) {
+      size_t __merge_count = (__chunk_count + __run_length - 1) / (2 * __run_length);
+      __thread_pool::__parallel_apply(__merge_count, [&](size_t __merge) {
+        size_t __begin = 2 * __merge * __run_length;
+        size_t __mid   = __begin + __run_length;
+        size_t __end   = std::min(__mid + __run_length, __chunk_count);
+        std::inplace_merge(__first + __partitions.__chunk_begin(__begin),
+                           __first + __partitions.__chunk_begin(__mid),
+                           __first + __partitions.__chunk_end(__end - 1),
+                           __comp);
+      });
+    }
+
+    return __empty{};
+  }
+
+  _LIBCPP_HIDE_FROM_ABI static void __cancel_execution() {}
+
+  static constexpr size_t __lane_size = 64;
+};
+
+// Mandatory implementations of the computational basis
+template <class _ExecutionPolicy>
+struct __find_if<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_find_if<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __for_each<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_for_each<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __merge<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_merge<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __stable_sort<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_stable_sort<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __transform<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_transform<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __transform_binary<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_transform_binary<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __transform_reduce<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_transform_reduce<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __transform_reduce_binary<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_transform_reduce_binary<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+// Not mandatory, but better optimized
+template <class _ExecutionPolicy>
+struct __any_of<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_any_of<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __fill<__thread_pool_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_fill<__thread_pool_backend_tag, _ExecutionPolicy> {};
+
+} // namespace __pstl
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP_STD_VER >= 17
+
+_LIBCPP_POP_MACROS
+
+#endif // _LIBCPP___PSTL_BACKENDS_THREAD_POOL_H
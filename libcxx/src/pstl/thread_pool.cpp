@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <__config>
+#include <__pstl/backends/thread_pool.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace __pstl::__thread_pool {
+namespace {
+
+// A call to __parallel_apply. It lives on the stack of the submitting thread, which doesn't return before all its
+// chunks completed.
+struct __apply_job {
+  void* __context_;
+  void (*__func_)(void*, size_t);
+  size_t __chunk_count_;
+  atomic<size_t> __next_chunk_{0};
+  atomic<size_t> __done_chunks_{0};
+};
+
+struct __job_queue {
+  mutex __mutex_;
+  deque<__apply_job*> __jobs_;
+};
+
+// The threads of the pool run the chunks of the jobs in their own queue, newest first, and otherwise steal the chunks
+// of the oldest jobs of the other queues. Threads outside of the pool submit their jobs to the first queue.
+//
+// A job is only accessed under the lock of its queue until a chunk of it was claimed, which keeps it alive until that
+// chunk is marked as done. This lets the submitter remove the job from its queue and return as soon as all the chunks
+// are done.
+class __pool {
+public:
+  __pool() {
+    unsigned __hardware_threads = std::thread::hardware_concurrency();
+    size_t __worker_count       = __hardware_threads > 1 ? __hardware_threads - 1 : 0;
+    __queues_                   = std::make_unique<__job_queue[]>(__worker_count + 1);
+    for (size_t __i = 0; __i != __worker_count; ++__i) {
+#if _LIBCPP_HAS_EXCEPTIONS
+      try {
+#endif
+        std::thread([this, __index = __i + 1] { __work(__index); }).detach();
+#if _LIBCPP_HAS_EXCEPTIONS
+      } catch (...) {
+        // Work with the threads which could be created: the submitters run the chunks nobody else picked up.
+        break;
+      }
+#endif
+      __queue_count_.store(__i + 2, memory_order_relaxed);
+    }
+  }
+
+  void __apply(size_t __chunk_count, void* __context, void (*__func)(void*, size_t)) {
+    __apply_job __job{__context, __func, __chunk_count};
+    __job_queue& __queue = __queues_[__worker_index_];
+    {
+      lock_guard<mutex> __lock(__queue.__mutex_);
+      __queue.__jobs_.push_back(&__job);
+    }
+    __epoch_.fetch_add(1, memory_order_release);
+    __epoch_.notify_all();
+
+    // The job can't be removed from under us, so its chunks can be claimed without the lock.
+    for (size_t __chunk; (__chunk = __job.__next_chunk_.fetch_add(1, memory_order_relaxed)) < __chunk_count;)
+      __run(__job, __chunk);
+
+    {
+      lock_guard<mutex> __lock(__queue.__mutex_);
+      auto __it = std::find(__queue.__jobs_.begin(), __queue.__jobs_.end(), &__job);
+      if (__it != __queue.__jobs_.end())
+        __queue.__jobs_.erase(__it);
+    }
+
+    // Help with the other jobs while the chunks picked up by other threads complete.
+    while (__job.__done_chunks_.load(memory_order_acquire) != __chunk_count) {
+      if (__run_one())
+        continue;
+      unsigned __completions = __completions_.load(memory_order_acquire);
+      if (__job.__done_chunks_.load(memory_order_acquire) == __chunk_count)
+        break;
+      __completions_.wait(__completions, memory_order_acquire);
+    }
+  }
+
+private:
+  [[noreturn]] void __work(size_t __index) {
+    __worker_index_ = __index;
+    for (;;) {
+      unsigned __epoch = __epoch_.load(memory_order_acquire);
+      if (!__run_one())
+        __epoch_.wait(__epoch, memory_order_acquire);
+    }
+  }
+
+  // Run a chunk of a job of the queue of this thread, or steal one from another queue.
+  bool __run_one() {
+    size_t __count = __queue_count_.load(memory_order_relaxed);
+    for (size_t __i = 0; __i != __count; ++__i) {
+      size_t __index = (__worker_index_ + __i) % __count;
+      if (__run_one_from(__queues_[__index], /*__newest=*/__i == 0))
+        return true;
+    }
+    return false;
+  }
+
+  bool __run_one_from(__job_queue& __queue, bool __newest) {
+    unique_lock<mutex> __lock(__queue.__mutex_);
+    while (!__queue.__jobs_.empty()) {
+      __apply_job* __job = __newest ? __queue.__jobs_.back() : __queue.__jobs_.front();
+      size_t __chunk     = __job->__next_chunk_.fetch_add(1, memory_order_relaxed);
+      if (__chunk < __job->__chunk_count_) {
+        __lock.unlock();
+        __run(*__job, __chunk);
+        return true;
+      }
+      // All the chunks of this job were claimed already.
+      if (__newest)
+        __queue.__jobs_.pop_back();
+      else
+        __queue.__jobs_.pop_front();
+    }
+    return false;
+  }
+
+  void __run(__apply_job& __job, size_t __chunk) {
+    __job.__func_(__job.__context_, __chunk);
+    // The job may be gone as soon as its last chunk is marked as done.
+    if (__job.__done_chunks_.fetch_add(1, memory_order_acq_rel) + 1 == __job.__chunk_count_) {
+      __completions_.fetch_add(1, memory_order_release);
+      __completions_.notify_all();
+    }
+  }
+
+  static thread_local size_t __worker_index_;
+
+  unique_ptr<__job_queue[]> __queues_;
+  // The number of queues in use, which only grows while the threads are created.
+  atomic<size_t> __queue_count_{1};
+  atomic<unsigned> __epoch_{0};
+  atomic<unsigned> __completions_{0};
+};
+
+thread_local size_t __pool::__worker_index_ = 0;
+
+__pool& __get_pool() {
+  // The pool is leaked, as its threads run until the end of the program.
+  static __pool* __instance = new __pool;
+  return *__instance;
+}
+
+} // namespace
+
+void __parallel_apply(size_t __chunk_count, void* __context, void (*__func)(void* __context, size_t __chunk)) noexcept {
+  if (__chunk_count == 1) {
+    __func(__context, 0);
+    return;
+  }
+  if (__chunk_count != 0)
+    __get_pool().__apply(__chunk_count, __context, __func);
+}
+
+__chunk_partitions __partition_chunks(ptrdiff_t __element_count) noexcept {
+  __chunk_partitions __partitions;
+  ptrdiff_t __thread_count        = std::max(1u, std::thread::hardware_concurrency());
+  __partitions.__chunk_count_      = std::max<ptrdiff_t>(1, __element_count / 256);
+  // A few chunks per thread give the threads some work to steal, without making the chunks too small.
+  __partitions.__chunk_count_      = std::min(__partitions.__chunk_count_, 4 * __thread_count);
+  __partitions.__chunk_size_       = __element_count / __partitions.__chunk_count_;
+  __partitions.__first_chunk_size_ = __element_count - (__partitions.__chunk_count_ - 1) * __partitions.__chunk_size_;
+  return __partitions;
+}
+
+} // namespace __pstl::__thread_pool
+
+_LIBCPP_END_NAMESPACE_STD
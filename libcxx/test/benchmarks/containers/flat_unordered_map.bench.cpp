@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// Compare the node-based std::unordered_map with the open-addressing std::__flat_unordered_map extension.
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "../GenerateInput.h"
+
+namespace {
+
+template <class Map>
+void BM_InsertRandom(benchmark::State& st) {
+  using Key = typename Map::key_type;
+  auto keys = getRandomIntegerInputs<Key>(st.range(0));
+  for (auto _ : st) {
+    Map m;
+    for (const auto& k : keys)
+      m.emplace(k, k);
+    benchmark::DoNotOptimize(m);
+  }
+}
+
+template <class Map>
+void BM_InsertReserved(benchmark::State& st) {
+  using Key = typename Map::key_type;
+  auto keys = getRandomIntegerInputs<Key>(st.range(0));
+  for (auto _ : st) {
+    Map m;
+    m.reserve(keys.size());
+    for (const auto& k : keys)
+      m.emplace(k, k);
+    benchmark::DoNotOptimize(m);
+  }
+}
+
+template <class Map>
+void BM_FindHit(benchmark::State& st) {
+  using Key = typename Map::key_type;
+  auto keys = getRandomIntegerInputs<Key>(st.range(0));
+  Map m;
+  for (const auto& k : keys)
+    m.emplace(k, k);
+  for (auto _ : st) {
+    for (const auto& k : keys)
+      benchmark::DoNotOptimize(m.find(k));
+  }
+}
+
+template <class Map>
+void BM_FindMiss(benchmark::State& st) {
+  using Key   = typename Map::key_type;
+  auto keys   = getRandomIntegerInputs<Key>(st.range(0));
+  auto misses = getRandomIntegerInputs<Key>(st.range(0));
+  Map m;
+  for (const auto& k : keys)
+    m.emplace(k, k);
+  for (const auto& k : keys)
+    m.erase(k + 1);
+  for (auto& k : misses)
+    k = m.count(k) ? k + 1 : k;
+  for (auto _ : st) {
+    for (const auto& k : misses)
+      benchmark::DoNotOptimize(m.find(k));
+  }
+}
+
+template <class Map>
+void BM_EraseInsert(benchmark::State& st) {
+  using Key = typename Map::key_type;
+  auto keys = getRandomIntegerInputs<Key>(st.range(0));
+  Map m;
+  for (const auto& k : keys)
+    m.emplace(k, k);
+  for (auto _ : st) {
+    for (const auto& k : keys) {
+      m.erase(k);
+      m.emplace(k, k);
+    }
+    benchmark::DoNotOptimize(m);
+  }
+}
+
+template <class Map>
+void BM_Iterate(benchmark::State& st) {
+  using Key = typename Map::key_type;
+  auto keys = getRandomIntegerInputs<Key>(st.range(0));
+  Map m;
+  for (const auto& k : keys)
+    m.emplace(k, k);
+  for (auto _ : st) {
+    Key sum = 0;
+    for (const auto& [k, v] : m)
+      sum += v;
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+template <class Map>
+void BM_FindHitString(benchmark::State& st) {
+  auto keys = getRandomStringInputsWithLength(st.range(0), 16);
+  Map m;
+  for (const auto& k : keys)
+    m.emplace(k, 0);
+  for (auto _ : st) {
+    for (const auto& k : keys)
+      benchmark::DoNotOptimize(m.find(k));
+  }
+}
+
+using UnorderedMap    = std::unordered_map<uint64_t, uint64_t>;
+using FlatMap         = std::__flat_unordered_map<uint64_t, uint64_t>;
+using UnorderedMapStr = std::unordered_map<std::string, int>;
+using FlatMapStr      = std::__flat_unordered_map<std::string, int>;
+
+#define BENCH_MAPS(bm, node_map, flat_map)                                                                             \
+  BENCHMARK(bm<node_map>)->Name(#bm "/unordered_map")->Range(8, 1 << 20);                                             \
+  BENCHMARK(bm<flat_map>)->Name(#bm "/__flat_unordered_map")->Range(8, 1 << 20)
+
+BENCH_MAPS(BM_InsertRandom, UnorderedMap, FlatMap);
+BENCH_MAPS(BM_InsertReserved, UnorderedMap, FlatMap);
+BENCH_MAPS(BM_FindHit, UnorderedMap, FlatMap);
+BENCH_MAPS(BM_FindMiss, UnorderedMap, FlatMap);
+BENCH_MAPS(BM_EraseInsert, UnorderedMap, FlatMap);
+BENCH_MAPS(BM_Iterate, UnorderedMap, FlatMap);
+BENCH_MAPS(BM_FindHitString, UnorderedMapStr, FlatMapStr);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,221 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// <unordered_map>
+
+// Test the __flat_unordered_map extension.
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "test_macros.h"
+
+// All the keys collide, so that the lookups probe many groups.
+struct CollidingHash {
+  std::size_t operator()(int) const { return 0; }
+};
+
+struct TransparentHash {
+  using is_transparent = void;
+  std::size_t operator()(const std::string& s) const { return std::hash<std::string>()(s); }
+  std::size_t operator()(const char* s) const { return std::hash<std::string>()(s); }
+};
+
+struct TransparentEqual {
+  using is_transparent = void;
+  template <class T, class U>
+  bool operator()(const T& lhs, const U& rhs) const {
+    return std::string(lhs) == std::string(rhs);
+  }
+};
+
+template <class Hash>
+void test_insert_find_erase(int n) {
+  std::__flat_unordered_map<int, int, Hash> m;
+  assert(m.empty());
+  assert(m.find(0) == m.end());
+  assert(m.begin() == m.end());
+
+  for (int i = 0; i < n; ++i) {
+    auto [it, inserted] = m.insert({i, 2 * i});
+    assert(inserted);
+    assert(it->first == i && it->second == 2 * i);
+  }
+  assert(m.size() == static_cast<std::size_t>(n));
+  assert(m.load_factor() <= m.max_load_factor());
+
+  for (int i = 0; i < n; ++i) {
+    assert(m.contains(i));
+    assert(m.at(i) == 2 * i);
+    assert(!m.insert({i, 0}).second);
+  }
+  assert(!m.contains(n));
+  assert(m.count(-1) == 0);
+
+  std::size_t visited = 0;
+  for (const auto& [k, v] : m) {
+    assert(v == 2 * k);
+    ++visited;
+  }
+  assert(visited == m.size());
+
+  // Erase the odd keys, then make sure the lookups still go past the erased slots.
+  for (int i = 1; i < n; i += 2)
+    assert(m.erase(i) == 1);
+  assert(m.erase(1) == 0);
+  assert(m.size() == static_cast<std::size_t>((n + 1) / 2));
+  for (int i = 0; i < n; ++i)
+    assert(m.contains(i) == (i % 2 == 0));
+
+  // Reuse the erased slots.
+  for (int i = 1; i < n; i += 2)
+    m[i] = 2 * i;
+  for (int i = 0; i < n; ++i)
+    assert(m[i] == 2 * i);
+  assert(m.size() == static_cast<std::size_t>(n));
+
+  m.clear();
+  assert(m.empty());
+  assert(m.begin() == m.end());
+  assert(!m.contains(0));
+}
+
+void test_churn() {
+  // Inserting and erasing keeps creating deleted slots, which the table must reclaim without growing forever.
+  std::__flat_unordered_map<int, int> m;
+  for (int i = 0; i < 100000; ++i) {
+    m.emplace(i, i);
+    if (i >= 10)
+      assert(m.erase(i - 10) == 1);
+  }
+  assert(m.size() == 10);
+  assert(m.bucket_count() <= 64);
+  for (int i = 100000 - 10; i < 100000; ++i)
+    assert(m.at(i) == i);
+}
+
+void test_iterators() {
+  std::__flat_unordered_map<int, int> m{{1, 1}, {2, 2}, {3, 3}, {4, 4}};
+  std::__flat_unordered_map<int, int>::const_iterator cit = m.begin();
+  assert(cit == m.cbegin());
+
+  // erase(iterator) returns the next element, and erase(first, last) returns last.
+  int sum = 0;
+  for (auto it = m.begin(); it != m.end();) {
+    sum += it->first;
+    it = it->first % 2 == 0 ? m.erase(it) : std::next(it);
+  }
+  assert(sum == 10);
+  assert(m.size() == 2);
+  assert(m.erase(m.begin(), m.end()) == m.end());
+  assert(m.empty());
+
+  auto [first, last] = m.equal_range(1);
+  assert(first == last);
+}
+
+void test_strings() {
+  std::__flat_unordered_map<std::string, std::string, TransparentHash, TransparentEqual> m;
+  for (int i = 0; i < 1000; ++i)
+    m.try_emplace(std::to_string(i), std::string(100, static_cast<char>('a' + i % 26)));
+  assert(m.size() == 1000);
+  assert(m.find("42") != m.end());
+  assert(m.find("42")->second == std::string(100, 'a' + 42 % 26));
+  assert(m.contains("999"));
+  assert(!m.contains("1000"));
+
+  auto [it, inserted] = m.insert_or_assign("7", "seven");
+  assert(!inserted && it->second == "seven");
+  assert(m.insert_or_assign("seven", "7").second);
+  assert(m["seven"] == "7");
+}
+
+void test_copy_and_move() {
+  std::__flat_unordered_map<int, std::string> m;
+  for (int i = 0; i < 100; ++i)
+    m.emplace(i, std::to_string(i));
+  m.erase(50);
+
+  std::__flat_unordered_map<int, std::string> copy = m;
+  assert(copy == m);
+  assert(copy.size() == 99);
+  assert(!copy.contains(50));
+  copy[50] = "50";
+  assert(copy != m);
+
+  std::__flat_unordered_map<int, std::string> moved = std::move(copy);
+  assert(moved.size() == 100);
+  assert(moved.at(50) == "50");
+
+  m = moved;
+  assert(m == moved);
+  moved = std::move(m);
+  assert(moved.size() == 100);
+
+  swap(m, moved);
+  assert(m.size() == 100);
+  assert(moved.empty());
+}
+
+void test_move_only() {
+  std::__flat_unordered_map<int, std::unique_ptr<int>> m;
+  for (int i = 0; i < 100; ++i)
+    m.try_emplace(i, std::make_unique<int>(i));
+  for (int i = 0; i < 100; ++i)
+    assert(*m.at(i) == i);
+}
+
+void test_rehash() {
+  std::__flat_unordered_map<int, int> m;
+  m.reserve(1000);
+  std::size_t buckets = m.bucket_count();
+  assert(buckets * m.max_load_factor() >= 1000);
+  for (int i = 0; i < 1000; ++i)
+    m[i] = i;
+  assert(m.bucket_count() == buckets);
+
+  m.rehash(0);
+  assert(m.bucket_count() == buckets);
+  for (int i = 0; i < 990; ++i)
+    m.erase(i);
+  m.rehash(0);
+  assert(m.bucket_count() < buckets);
+  for (int i = 990; i < 1000; ++i)
+    assert(m.at(i) == i);
+}
+
+void test_exceptions() {
+#ifndef TEST_HAS_NO_EXCEPTIONS
+  std::__flat_unordered_map<int, int> m;
+  try {
+    (void)m.at(1);
+    assert(false);
+  } catch (const std::out_of_range&) {
+  }
+#endif
+}
+
+int main(int, char**) {
+  test_insert_find_erase<std::hash<int>>(1000);
+  test_insert_find_erase<CollidingHash>(200);
+  test_churn();
+  test_iterators();
+  test_strings();
+  test_copy_and_move();
+  test_move_only();
+  test_rehash();
+  test_exceptions();
+
+  return 0;
+}
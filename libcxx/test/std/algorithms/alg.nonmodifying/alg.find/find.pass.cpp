@@ -121,6 +121,20 @@ struct TestTypes {
   }
 };
 
+// Covers all the lengths handled differently by the vectorized implementation.
+template <class T>
+void test_lengths() {
+  for (int size = 0; size != 300; ++size) {
+    std::vector<T> data(size, T(1));
+    assert(std::find(data.begin(), data.end(), T(2)) == data.end());
+    for (int i = 0; i != size; ++i) {
+      data[i] = T(2);
+      assert(std::find(data.begin(), data.end(), T(2)) == data.begin() + i);
+      data[i] = T(1);
+    }
+  }
+}
+
 void test_deque() {
   { // empty deque
     std::deque<int> data;
@@ -232,6 +246,10 @@ TEST_CONSTEXPR_CXX20 bool test() {
 
 int main(int, char**) {
   test_deque();
+  test_lengths<short>();
+  test_lengths<int>();
+  test_lengths<long long>();
+  test_lengths<unsigned long long>();
   test();
 #if TEST_STD_VER >= 20
   static_assert(test());
@@ -55,6 +55,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FormatAdapters.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include "llvm/Support/TimeProfiler.h"
@@ -72,6 +73,19 @@ using llvm::pdb::StringTableFixup;
 namespace {
 class DebugSHandler;
 
+/// Global symbol records found while analyzing the symbol subsections of an
+/// object file. They are relocated and remapped already, and are added to the
+/// globals stream after the analysis so that it can run in parallel.
+struct PendingGlobalSymbols {
+  /// The concatenated records.
+  std::vector<uint8_t> storage;
+  /// Pairs of the offset of a record in storage and the offset of the record
+  /// in the module symbol stream.
+  std::vector<std::pair<uint32_t, uint32_t>> records;
+  /// The number of module symbol records.
+  uint64_t numModuleSymbols = 0;
+};
+
 class PDBLinker {
   friend DebugSHandler;
 
@@ -106,10 +120,21 @@ public:
 
   /// Link CodeView from a single object file into the target (output) PDB.
   /// When a precompiled headers object is linked, its TPI map might be provided
-  /// externally.
-  void addDebug(TpiSource *source);
-
-  void addDebugSymbols(TpiSource *source);
+  /// externally. If dsh is non-null, it holds the result of analyzing the
+  /// .debug$S sections of the object file.
+  void addDebug(TpiSource *source,
+                std::unique_ptr<DebugSHandler> dsh = nullptr);
+
+  /// Add the symbols of an object file to the PDB. If dsh is non-null, the
+  /// .debug$S sections of the file have already been analyzed with it.
+  void addDebugSymbols(TpiSource *source,
+                       std::unique_ptr<DebugSHandler> dsh = nullptr);
+
+  /// Analyze the .debug$S sections of the object files of the given sources
+  /// in parallel. Returns a handler for each source, or null for the sources
+  /// whose symbols should not be added.
+  std::vector<std::unique_ptr<DebugSHandler>>
+  analyzeDebugSInParallel(ArrayRef<TpiSource *> sources);
 
   // Analyze the symbol records to separate module symbols from global symbols,
   // find string references, and calculate how large the symbol stream will be
@@ -118,8 +143,13 @@ public:
                                uint32_t &moduleSymOffset,
                                uint32_t &nextRelocIndex,
                                std::vector<StringTableFixup> &stringTableFixups,
+                               PendingGlobalSymbols &globals,
                                BinaryStreamRef symData);
 
+  // Add the global symbol records collected by analyzeSymbolSubsection to the
+  // globals stream.
+  void addPendingGlobalSymbols(ObjFile &file, PendingGlobalSymbols &globals);
+
   // Write all module symbols from all live debug symbol subsections of the
   // given object file into the given stream writer.
   Error writeAllModuleSymbolRecords(ObjFile *file, BinaryStreamWriter &writer);
@@ -182,6 +212,10 @@ struct UnrelocatedFpoData {
 /// The size of the magic bytes at the beginning of a symbol section or stream.
 enum : uint32_t { kSymbolStreamMagicSize = 4 };
 
+/// The maximum total size of the debug sections of the object files whose
+/// symbols are analyzed in parallel at once.
+static constexpr uint64_t maxDebugSBatchBytes = 256 * 1024 * 1024;
+
 class DebugSHandler {
   COFFLinkerContext &ctx;
   PDBLinker &linker;
@@ -212,6 +246,9 @@ class DebugSHandler {
   /// applied to the symbols during PDB writing.
   std::vector<StringTableFixup> stringTableFixups;
 
+  /// Global symbol records to be added to the globals stream by finish().
+  PendingGlobalSymbols globals;
+
   /// Sum of the size of all module symbol records across all .debug$S sections.
   /// Includes record realignment and the size of the symbol stream magic
   /// prefix.
@@ -492,9 +529,8 @@ static bool symbolGoesInGlobalsStream(const CVSymbol &sym,
 }
 
 static void addGlobalSymbol(pdb::GSIStreamBuilder &builder, uint16_t modIndex,
-                            unsigned symOffset,
-                            std::vector<uint8_t> &symStorage) {
-  CVSymbol sym{ArrayRef(symStorage)};
+                            unsigned symOffset, ArrayRef<uint8_t> symStorage) {
+  CVSymbol sym{symStorage};
   switch (sym.kind()) {
   case SymbolKind::S_CONSTANT:
   case SymbolKind::S_UDT:
@@ -585,12 +621,11 @@ void PDBLinker::writeSymbolRecord(SectionChunk *debugChunk,
 void PDBLinker::analyzeSymbolSubsection(
     SectionChunk *debugChunk, uint32_t &moduleSymOffset,
     uint32_t &nextRelocIndex, std::vector<StringTableFixup> &stringTableFixups,
-    BinaryStreamRef symData) {
+    PendingGlobalSymbols &globals, BinaryStreamRef symData) {
   ObjFile *file = debugChunk->file;
   uint32_t moduleSymStart = moduleSymOffset;
 
   uint32_t scopeLevel = 0;
-  std::vector<uint8_t> storage;
   ArrayRef<uint8_t> sectionContents = debugChunk->getContents();
 
   ArrayRef<uint8_t> symsBuffer;
@@ -613,13 +648,10 @@ void PDBLinker::analyzeSymbolSubsection(
         // Copy global records. Some global records (mainly procedures)
         // reference the current offset into the module stream.
         if (symbolGoesInGlobalsStream(sym, scopeLevel)) {
-          storage.clear();
+          globals.records.emplace_back(globals.storage.size(),
+                                       moduleSymOffset);
           writeSymbolRecord(debugChunk, sectionContents, sym, alignedSize,
-                            nextRelocIndex, storage);
-          addGlobalSymbol(builder.getGsiBuilder(),
-                          file->moduleDBI->getModuleIndex(), moduleSymOffset,
-                          storage);
-          ++globalSymbols;
+                            nextRelocIndex, globals.storage);
         }
 
         // Update the module stream offset and record any string table index
@@ -628,7 +660,7 @@ void PDBLinker::analyzeSymbolSubsection(
         if (symbolGoesInModuleStream(sym, scopeLevel)) {
           recordStringTableReferences(sym, moduleSymOffset, stringTableFixups);
           moduleSymOffset += alignedSize;
-          ++moduleSymbols;
+          ++globals.numModuleSymbols;
         }
 
         return Error::success();
@@ -644,6 +676,22 @@ void PDBLinker::analyzeSymbolSubsection(
   }
 }
 
+void PDBLinker::addPendingGlobalSymbols(ObjFile &file,
+                                        PendingGlobalSymbols &globals) {
+  ArrayRef<uint8_t> storage = globals.storage;
+  uint16_t modIndex = file.moduleDBI->getModuleIndex();
+  for (size_t i = 0, e = globals.records.size(); i != e; ++i) {
+    uint32_t begin = globals.records[i].first;
+    uint32_t end = i + 1 == e ? storage.size() : globals.records[i + 1].first;
+    addGlobalSymbol(builder.getGsiBuilder(), modIndex,
+                    globals.records[i].second,
+                    storage.slice(begin, end - begin));
+  }
+  globalSymbols += globals.records.size();
+  moduleSymbols += globals.numModuleSymbols;
+  globals = {};
+}
+
 Error PDBLinker::writeAllModuleSymbolRecords(ObjFile *file,
                                              BinaryStreamWriter &writer) {
   ExitOnError exitOnErr;
@@ -798,7 +846,7 @@ void DebugSHandler::handleDebugS(SectionChunk *debugChunk) {
     case DebugSubsectionKind::Symbols:
       linker.analyzeSymbolSubsection(debugChunk, moduleStreamSize,
                                      nextRelocIndex, stringTableFixups,
-                                     ss.getRecordData());
+                                     globals, ss.getRecordData());
       break;
 
     case DebugSubsectionKind::CrossScopeImports:
@@ -924,6 +972,8 @@ getFileName(const DebugStringTableSubsectionRef &strings,
 void DebugSHandler::finish() {
   pdb::DbiStreamBuilder &dbiBuilder = linker.builder.getDbiBuilder();
 
+  linker.addPendingGlobalSymbols(file, globals);
+
   // If we found any symbol records for the module symbol stream, defer them.
   if (moduleStreamSize > kSymbolStreamMagicSize)
     file.moduleDBI->addUnmergedSymbols(&file, moduleStreamSize -
@@ -1027,7 +1077,8 @@ static ArrayRef<uint8_t> relocateDebugChunk(SectionChunk &debugChunk) {
   return ArrayRef(buffer, debugChunk.getSize());
 }
 
-void PDBLinker::addDebugSymbols(TpiSource *source) {
+void PDBLinker::addDebugSymbols(TpiSource *source,
+                                std::unique_ptr<DebugSHandler> dsh) {
   // If this TpiSource doesn't have an object file, it must be from a type
   // server PDB. Type server PDBs do not contain symbols, so stop here.
   if (!source->file)
@@ -1037,7 +1088,9 @@ void PDBLinker::addDebugSymbols(TpiSource *source) {
   ScopedTimer t(ctx.symbolMergingTimer);
   ExitOnError exitOnErr;
   pdb::DbiStreamBuilder &dbiBuilder = builder.getDbiBuilder();
-  DebugSHandler dsh(ctx, *this, *source->file);
+  bool analyzed = dsh != nullptr;
+  if (!analyzed)
+    dsh = std::make_unique<DebugSHandler>(ctx, *this, *source->file);
   // Now do all live .debug$S and .debug$F sections.
   for (SectionChunk *debugChunk : source->file->getDebugChunks()) {
     if (!debugChunk->live || debugChunk->getSize() == 0)
@@ -1049,7 +1102,8 @@ void PDBLinker::addDebugSymbols(TpiSource *source) {
       continue;
 
     if (isDebugS) {
-      dsh.handleDebugS(debugChunk);
+      if (!analyzed)
+        dsh->handleDebugS(debugChunk);
     } else if (isDebugF) {
       // Handle old FPO data .debug$F sections. These are relatively rare.
       ArrayRef<uint8_t> relocatedDebugContents =
@@ -1068,7 +1122,30 @@ void PDBLinker::addDebugSymbols(TpiSource *source) {
   }
 
   // Do any post-processing now that all .debug$S sections have been processed.
-  dsh.finish();
+  dsh->finish();
+}
+
+std::vector<std::unique_ptr<DebugSHandler>>
+PDBLinker::analyzeDebugSInParallel(ArrayRef<TpiSource *> sources) {
+  std::vector<std::unique_ptr<DebugSHandler>> handlers(sources.size());
+  for (size_t i = 0, e = sources.size(); i != e; ++i) {
+    // addDebug ignores the symbols of sources whose types failed to merge.
+    TpiSource *source = sources[i];
+    if (source->file && !source->typeMergingError)
+      handlers[i] = std::make_unique<DebugSHandler>(ctx, *this, *source->file);
+  }
+
+  // Analyzing the .debug$S sections of an object file only modifies the state
+  // of its handler and its module descriptor.
+  parallelFor(0, sources.size(), [&](size_t i) {
+    if (!handlers[i])
+      return;
+    for (SectionChunk *debugChunk : sources[i]->file->getDebugChunks())
+      if (debugChunk->live && debugChunk->getSize() != 0 &&
+          debugChunk->getSectionName() == ".debug$S")
+        handlers[i]->handleDebugS(debugChunk);
+  });
+  return handlers;
 }
 
 // Add a module descriptor for every object file. We need to put an absolute
@@ -1102,7 +1179,8 @@ void PDBLinker::createModuleDBI(ObjFile *file) {
   }
 }
 
-void PDBLinker::addDebug(TpiSource *source) {
+void PDBLinker::addDebug(TpiSource *source,
+                         std::unique_ptr<DebugSHandler> dsh) {
   // Before we can process symbol substreams from .debug$S, we need to process
   // type information, file checksums, and the string table. Add type info to
   // the PDB first, so that we can get the map from object file type and item
@@ -1127,7 +1205,7 @@ void PDBLinker::addDebug(TpiSource *source) {
     return;
   }
 
-  addDebugSymbols(source);
+  addDebugSymbols(source, std::move(dsh));
 }
 
 static pdb::BulkPublic createPublic(COFFLinkerContext &ctx, Defined *def) {
@@ -1170,15 +1248,42 @@ void PDBLinker::addObjectsToPDB() {
       tMerger.mergeTypesWithGHash();
 
     // Merge dependencies and then regular objects.
-    {
-      llvm::TimeTraceScope timeScope("Merge debug info (dependencies)");
-      for (TpiSource *source : tMerger.dependencySources)
-        addDebug(source);
-    }
-    {
-      llvm::TimeTraceScope timeScope("Merge debug info (objects)");
-      for (TpiSource *source : tMerger.objectSources)
-        addDebug(source);
+    if (ctx.config.debugGHashes) {
+      // Types have already been merged, so the symbol records of different
+      // object files can be relocated and remapped in parallel. The results
+      // are added to the PDB in the same order as below. Work in batches to
+      // bound the memory held by the pending results.
+      llvm::TimeTraceScope timeScope("Merge debug info (GHASH)");
+      ArrayRef<TpiSource *> sources = ctx.tpiSourceList;
+      while (!sources.empty()) {
+        size_t n = 0;
+        uint64_t batchBytes = 0;
+        for (; n != sources.size() && batchBytes < maxDebugSBatchBytes; ++n)
+          if (ObjFile *file = sources[n]->file)
+            for (SectionChunk *debugChunk : file->getDebugChunks())
+              if (debugChunk->live)
+                batchBytes += debugChunk->getSize();
+
+        std::vector<std::unique_ptr<DebugSHandler>> handlers;
+        {
+          ScopedTimer t(ctx.symbolMergingTimer);
+          handlers = analyzeDebugSInParallel(sources.take_front(n));
+        }
+        for (size_t i = 0; i != n; ++i)
+          addDebug(sources[i], std::move(handlers[i]));
+        sources = sources.drop_front(n);
+      }
+    } else {
+      {
+        llvm::TimeTraceScope timeScope("Merge debug info (dependencies)");
+        for (TpiSource *source : tMerger.dependencySources)
+          addDebug(source);
+      }
+      {
+        llvm::TimeTraceScope timeScope("Merge debug info (objects)");
+        for (TpiSource *source : tMerger.objectSources)
+          addDebug(source);
+      }
     }
 
     builder.getStringTableBuilder().setStrings(pdbStrTab);
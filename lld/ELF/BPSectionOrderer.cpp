@@ -0,0 +1,165 @@
+//===- BPSectionOrderer.cpp -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "BPSectionOrderer.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "Relocations.h"
+#include "Symbols.h"
+#include "lld/Common/BPSectionOrdererBase.h"
+#include "llvm/ADT/DenseMap.h"
+
+using namespace llvm;
+using namespace llvm::ELF;
+using namespace lld;
+using namespace lld::elf;
+
+namespace {
+class BPSymbolELF : public BPSymbol {
+  const Defined *sym;
+
+public:
+  explicit BPSymbolELF(const Defined *s) : sym(s) {}
+
+  StringRef getName() const override { return sym->getName(); }
+
+  std::optional<uint64_t> getValue() const override { return sym->value; }
+
+  std::optional<uint64_t> getSize() const override { return sym->size; }
+};
+
+class BPSectionELF : public BPSectionBase {
+  const InputSection *isec;
+  SmallVector<const Defined *, 0> symbols;
+
+public:
+  explicit BPSectionELF(const InputSection *sec) : isec(sec) {}
+
+  void addSymbol(const Defined *sym) { symbols.push_back(sym); }
+
+  const void *getSection() const override { return isec; }
+
+  uint64_t getSize() const override { return isec->getSize(); }
+
+  bool isCodeSection() const override { return isec->flags & SHF_EXECINSTR; }
+
+  bool hasValidData() const override { return !isec->content().empty(); }
+
+  SmallVector<std::unique_ptr<BPSymbol>> getSymbols() const override {
+    SmallVector<std::unique_ptr<BPSymbol>> ret;
+    for (const Defined *d : symbols)
+      ret.emplace_back(std::make_unique<BPSymbolELF>(d));
+    return ret;
+  }
+
+  // ELF symbol names are not decorated.
+  std::optional<StringRef>
+  getResolvedLinkageName(StringRef name) const override {
+    return {};
+  }
+
+  void getSectionHashes(SmallVectorImpl<uint64_t> &hashes,
+                        const DenseMap<const void *, uint64_t> &sectionToIdx)
+      const override {
+    constexpr unsigned windowSize = 4;
+
+    // Calculate content hashes. The bytes covered by relocations are
+    // included as they are in the input, which is usually zero for RELA.
+    ArrayRef<uint8_t> data = isec->content();
+    for (size_t i = 0; i < data.size(); i++)
+      hashes.push_back(xxHash64(data.drop_front(i).take_front(windowSize)));
+
+    // Calculate relocation hashes, as relocations referencing the same target
+    // tend to compress well when placed close to each other.
+    for (const Relocation &r : isec->relocs()) {
+      if (!r.sym || r.offset >= data.size())
+        continue;
+      uint64_t relocHash = getRelocHash(r, sectionToIdx);
+      uint64_t start = r.offset < windowSize ? 0 : r.offset - windowSize + 1;
+      for (uint64_t i = start; i < r.offset + windowSize; i++)
+        hashes.push_back(
+            xxHash64(data.drop_front(i).take_front(windowSize)) + relocHash);
+    }
+
+    llvm::sort(hashes);
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+  }
+
+private:
+  static uint64_t
+  getRelocHash(const Relocation &r,
+               const DenseMap<const void *, uint64_t> &sectionToIdx) {
+    std::string kind = ("Type " + Twine(r.type)).str();
+    if (auto *d = dyn_cast<Defined>(r.sym)) {
+      if (auto *sec = dyn_cast_or_null<InputSection>(d->section)) {
+        auto it = sectionToIdx.find(sec);
+        return BPSectionBase::getRelocHash(
+            kind + " Section",
+            it == sectionToIdx.end() ? 0 : it->second, d->value, r.addend);
+      }
+    }
+    return BPSectionBase::getRelocHash(
+        (kind + " Symbol " + r.sym->getName()).str(), 0, 0, r.addend);
+  }
+};
+} // namespace
+
+DenseMap<const InputSectionBase *, int>
+elf::runBalancedPartitioning(Ctx &ctx) {
+  SmallVector<std::unique_ptr<BPSectionBase>> sections;
+  DenseMap<const InputSection *, BPSectionELF *> secToBP;
+  for (ELFFileBase *file : ctx.objectFiles) {
+    for (InputSectionBase *s : file->getSections()) {
+      auto *isec = dyn_cast_or_null<InputSection>(s);
+      if (!isec || !isec->isLive() || !(isec->flags & SHF_ALLOC) ||
+          isec->type != SHT_PROGBITS || isec->content().empty())
+        continue;
+      auto bp = std::make_unique<BPSectionELF>(isec);
+      secToBP[isec] = bp.get();
+      sections.push_back(std::move(bp));
+    }
+  }
+
+  // Attach the symbols defined relative to each section. Skip section symbols,
+  // which are not referenced by profiles.
+  auto addSym = [&](Symbol *sym) {
+    auto *d = dyn_cast<Defined>(sym);
+    if (!d || d->isSection() || d->getName().empty())
+      return;
+    if (auto *isec = dyn_cast_or_null<InputSection>(d->section))
+      if (BPSectionELF *bp = secToBP.lookup(isec))
+        bp->addSymbol(d);
+  };
+  for (ELFFileBase *file : ctx.objectFiles) {
+    for (Symbol *sym : file->getLocalSymbols())
+      addSym(sym);
+    for (Symbol *sym : file->getGlobalSymbols())
+      if (sym->file == file)
+        addSym(sym);
+  }
+
+  size_t highestAvailablePriority = sections.size();
+  auto reorderedSections = BPSectionBase::reorderSectionsByBalancedPartitioning(
+      highestAvailablePriority,
+      ctx.arg.bpStartupFunctionSort ? ctx.arg.irpgoProfilePath : "",
+      ctx.arg.bpFunctionOrderForCompression,
+      ctx.arg.bpDataOrderForCompression,
+      ctx.arg.bpCompressionSortStartupFunctions,
+      ctx.arg.bpVerboseSectionOrderer, sections);
+
+  // The base class assigns decreasing priorities starting from
+  // highestAvailablePriority, so the first ordered section has the largest
+  // one. Negate them so that ordered sections come first, in order.
+  DenseMap<const InputSectionBase *, int> result;
+  for (const auto &[sec, priority] : reorderedSections)
+    result.try_emplace(
+        static_cast<const InputSectionBase *>(sec->getSection()),
+        -int(priority) - 1);
+  return result;
+}
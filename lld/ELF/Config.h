@@ -29,6 +29,7 @@
 #include "llvm/Support/GlobPattern.h"
 #include "llvm/Support/TarWriter.h"
 #include <atomic>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -61,6 +62,7 @@ class GotPltSection;
 class GotSection;
 class IBTPltSection;
 class IgotPltSection;
+class IncrementalLink;
 class InputSection;
 class IpltSection;
 class MipsGotSection;
@@ -182,6 +184,10 @@ public:
   bool isInGroup;
   std::unique_ptr<InputFile> armCmseImpLib;
   SmallVector<std::pair<StringRef, unsigned>, 0> archiveFiles;
+  // Input files that createFiles loads in the background, keyed by path.
+  // readFile takes them from here instead of opening them again.
+  llvm::StringMap<std::future<llvm::ErrorOr<std::unique_ptr<MemoryBuffer>>>>
+      prefetchedFiles;
 };
 
 // This struct contains the global configuration for the linker.
@@ -191,6 +197,7 @@ public:
 struct Config {
   uint8_t osabi = 0;
   uint32_t andFeatures = 0;
+  llvm::CachePruningPolicy mergeCachePolicy;
   llvm::CachePruningPolicy thinLTOCachePolicy;
   llvm::SetVector<llvm::CachedHashString> dependencyFiles; // for --dependency-file
   llvm::StringMap<uint64_t> sectionStartMap;
@@ -209,6 +216,7 @@ struct Config {
   llvm::StringRef ltoObjPath;
   llvm::StringRef ltoSampleProfile;
   llvm::StringRef mapFile;
+  llvm::StringRef mergeCacheDir;
   llvm::StringRef outputFile;
   llvm::StringRef optRemarksFilename;
   std::optional<uint64_t> optRemarksHotnessThreshold = 0;
@@ -220,7 +228,9 @@ struct Config {
   llvm::StringRef printSymbolOrder;
   llvm::StringRef soName;
   llvm::StringRef sysroot;
+  llvm::StringRef thinLTOBackendStatsFile;
   llvm::StringRef thinLTOCacheDir;
+  llvm::StringRef thinLTORemoteCacheDir;
   llvm::StringRef thinLTOIndexOnlyArg;
   llvm::StringRef whyExtract;
   llvm::StringRef cmseInputLib;
@@ -264,6 +274,12 @@ struct Config {
   bool armBe8 = false;
   BsymbolicKind bsymbolic = BsymbolicKind::None;
   CGProfileSortKind callGraphProfileSort;
+  llvm::StringRef irpgoProfilePath;
+  bool bpStartupFunctionSort = false;
+  bool bpCompressionSortStartupFunctions = false;
+  bool bpFunctionOrderForCompression = false;
+  bool bpDataOrderForCompression = false;
+  bool bpVerboseSectionOrderer = false;
   bool checkSections;
   bool checkDynamicRelocs;
   std::optional<llvm::DebugCompressionType> compressDebugSections;
@@ -295,10 +311,12 @@ struct Config {
   bool hasDynSymTab;
   bool ignoreDataAddressEquality;
   bool ignoreFunctionAddressEquality;
+  bool incremental;
   bool ltoCSProfileGenerate;
   bool ltoPGOWarnMismatch;
   bool ltoDebugPassManager;
   bool ltoEmitAsm;
+  bool ltoPartitionCostModel;
   bool ltoUniqueBasicBlockSectionNames;
   bool ltoValidateAllVtablesHaveTypeInfos;
   bool ltoWholeProgramVisibility;
@@ -332,11 +350,13 @@ struct Config {
   llvm::SmallVector<std::pair<llvm::GlobPattern, uint32_t>, 0> shuffleSections;
   bool singleRoRx;
   bool shared;
+  bool streamOutput;
   bool symbolic;
   bool isStatic = false;
   bool sysvHash = false;
   bool target1Rel;
   bool trace;
+  bool thinLTOCacheOptimizedIR;
   bool thinLTOEmitImportsFiles;
   bool thinLTOEmitIndexFiles;
   bool thinLTOIndexOnly;
@@ -405,6 +425,7 @@ struct Config {
   llvm::CodeGenOptLevel ltoCgo;
   unsigned optimize;
   StringRef thinLTOJobs;
+  uint64_t thinLTOMemoryBudget = 0;
   unsigned timeTraceGranularity;
   int32_t splitStackAdjustSize;
   StringRef packageMetadata;
@@ -560,6 +581,8 @@ struct Ctx : CommonLinkerContext {
   LinkerDriver driver;
   LinkerScript *script;
   std::unique_ptr<TargetInfo> target;
+  // Non-null if --incremental is specified.
+  std::unique_ptr<IncrementalLink> incremental;
 
   // These variables are initialized by Writer and should not be used before
   // Writer is initialized.
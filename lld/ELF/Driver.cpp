@@ -25,6 +25,7 @@
 #include "Driver.h"
 #include "Config.h"
 #include "ICF.h"
+#include "Incremental.h"
 #include "InputFiles.h"
 #include "InputSection.h"
 #include "LTO.h"
@@ -61,6 +62,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/GlobPattern.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/MemoryBufferPrefetcher.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TarWriter.h"
@@ -351,6 +353,10 @@ static void initLLVM() {
 // Some command line options or some combinations of them are not allowed.
 // This function checks for such errors.
 static void checkOptions(Ctx &ctx) {
+  if (!ctx.arg.thinLTORemoteCacheDir.empty() && ctx.arg.thinLTOCacheDir.empty())
+    ErrAlways(ctx) << "--thinlto-remote-cache-dir may not be used without "
+                      "--thinlto-cache-dir";
+
   // The MIPS ABI as of 2016 does not support the GNU-style symbol lookup
   // table which is a relatively new feature.
   if (ctx.arg.emachine == EM_MIPS && ctx.arg.gnuHash)
@@ -425,6 +431,18 @@ static void checkOptions(Ctx &ctx) {
       ErrAlways(ctx) << "-r and --debug-names may not be used together";
     if (!ctx.arg.zSectionHeader)
       ErrAlways(ctx) << "-r and -z nosectionheader may not be used together";
+    if (ctx.arg.incremental)
+      ErrAlways(ctx) << "-r and --incremental may not be used together";
+  }
+
+  if (ctx.arg.incremental) {
+    if (ctx.arg.emitRelocs)
+      ErrAlways(ctx)
+          << "--emit-relocs and --incremental may not be used together";
+    if (ctx.arg.emachine != EM_386 && ctx.arg.emachine != EM_X86_64 &&
+        ctx.arg.emachine != EM_AARCH64 && ctx.arg.emachine != EM_ARM)
+      ErrAlways(ctx)
+          << "--incremental is only supported on AArch64, ARM and X86 targets";
   }
 
   if (ctx.arg.executeOnly) {
@@ -662,6 +680,9 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
     if (errCount(ctx))
       return;
 
+    if (ctx.arg.incremental)
+      ctx.incremental = std::make_unique<IncrementalLink>(ctx, args);
+
     invokeELFT(link, args);
   }
 
@@ -1255,6 +1276,28 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
       ctx.arg.bsymbolic = BsymbolicKind::All;
   }
   ctx.arg.callGraphProfileSort = getCGProfileSortKind(ctx, args);
+  ctx.arg.irpgoProfilePath = args.getLastArgValue(OPT_irpgo_profile);
+  if (auto *arg = args.getLastArg(OPT_bp_startup_sort)) {
+    StringRef s = arg->getValue();
+    if (s == "function")
+      ctx.arg.bpStartupFunctionSort = true;
+    else if (s != "none")
+      ErrAlways(ctx) << arg->getSpelling() << ": expected [none|function]";
+  }
+  ctx.arg.bpCompressionSortStartupFunctions =
+      args.hasFlag(OPT_bp_compression_sort_startup_functions,
+                   OPT_no_bp_compression_sort_startup_functions, false);
+  if (auto *arg = args.getLastArg(OPT_bp_compression_sort)) {
+    StringRef s = arg->getValue();
+    if (s == "function" || s == "both")
+      ctx.arg.bpFunctionOrderForCompression = true;
+    if (s == "data" || s == "both")
+      ctx.arg.bpDataOrderForCompression = true;
+    if (s != "none" && s != "function" && s != "data" && s != "both")
+      ErrAlways(ctx) << arg->getSpelling()
+                     << ": expected [none|function|data|both]";
+  }
+  ctx.arg.bpVerboseSectionOrderer = args.hasArg(OPT_verbose_bp_section_orderer);
   ctx.arg.checkSections =
       args.hasFlag(OPT_check_sections, OPT_no_check_sections, true);
   ctx.arg.chroot = args.getLastArgValue(OPT_chroot);
@@ -1310,6 +1353,8 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
       args.hasArg(OPT_ignore_data_address_equality);
   ctx.arg.ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
+  ctx.arg.incremental =
+      args.hasFlag(OPT_incremental, OPT_no_incremental, false);
   ctx.arg.init = args.getLastArgValue(OPT_init, "_init");
   ctx.arg.ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
   ctx.arg.ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
@@ -1336,6 +1381,9 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
     ErrAlways(ctx) << "invalid codegen optimization level for LTO: " << ltoCgo;
   ctx.arg.ltoObjPath = args.getLastArgValue(OPT_lto_obj_path_eq);
   ctx.arg.ltoPartitions = args::getInteger(args, OPT_lto_partitions, 1);
+  ctx.arg.ltoPartitionCostModel =
+      args.hasFlag(OPT_lto_partition_cost_model,
+                   OPT_no_lto_partition_cost_model, false);
   ctx.arg.ltoSampleProfile = args.getLastArgValue(OPT_lto_sample_profile);
   ctx.arg.ltoBBAddrMap =
       args.hasFlag(OPT_lto_basic_block_address_map,
@@ -1349,6 +1397,10 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
   ctx.arg.mipsGotSize = args::getInteger(args, OPT_mips_got_size, 0xfff0);
   ctx.arg.mergeArmExidx =
       args.hasFlag(OPT_merge_exidx_entries, OPT_no_merge_exidx_entries, true);
+  ctx.arg.mergeCacheDir = args.getLastArgValue(OPT_merge_cache_dir);
+  ctx.arg.mergeCachePolicy = CHECK(
+      parseCachePruningPolicy(args.getLastArgValue(OPT_merge_cache_policy)),
+      "--merge-cache-policy: invalid cache policy");
   ctx.arg.mmapOutputFile =
       args.hasFlag(OPT_mmap_output_file, OPT_no_mmap_output_file, true);
   ctx.arg.nmagic = args.hasFlag(OPT_nmagic, OPT_no_nmagic, false);
@@ -1421,13 +1473,21 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
   ctx.arg.zSectionHeader =
       getZFlag(args, "sectionheader", "nosectionheader", true);
   ctx.arg.strip = getStrip(ctx, args); // needs zSectionHeader
+  ctx.arg.streamOutput =
+      args.hasFlag(OPT_stream_output, OPT_no_stream_output, false);
   ctx.arg.sysroot = args.getLastArgValue(OPT_sysroot);
   ctx.arg.target1Rel = args.hasFlag(OPT_target1_rel, OPT_target1_abs, false);
   ctx.arg.target2 = getTarget2(ctx, args);
+  ctx.arg.thinLTOBackendStatsFile =
+      args.getLastArgValue(OPT_thinlto_backend_stats_eq);
   ctx.arg.thinLTOCacheDir = args.getLastArgValue(OPT_thinlto_cache_dir);
+  ctx.arg.thinLTOCacheOptimizedIR =
+      args.hasArg(OPT_thinlto_cache_optimized_ir);
   ctx.arg.thinLTOCachePolicy = CHECK(
       parseCachePruningPolicy(args.getLastArgValue(OPT_thinlto_cache_policy)),
       "--thinlto-cache-policy: invalid cache policy");
+  ctx.arg.thinLTORemoteCacheDir =
+      args.getLastArgValue(OPT_thinlto_remote_cache_dir);
   ctx.arg.thinLTOEmitImportsFiles = args.hasArg(OPT_thinlto_emit_imports_files);
   ctx.arg.thinLTOEmitIndexFiles = args.hasArg(OPT_thinlto_emit_index_files) ||
                                   args.hasArg(OPT_thinlto_index_only) ||
@@ -1680,6 +1740,15 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
   }
   if (auto *arg = args.getLastArg(OPT_thinlto_jobs_eq))
     ctx.arg.thinLTOJobs = arg->getValue();
+  if (auto *arg = args.getLastArg(OPT_thinlto_memory_budget_eq)) {
+    uint64_t mib = 0;
+    if (!llvm::to_integer(arg->getValue(), mib, 10) || mib > (UINT64_MAX >> 20))
+      ErrAlways(ctx) << arg->getSpelling()
+                     << ": expected a size in MiB, but got '" << arg->getValue()
+                     << "'";
+    else
+      ctx.arg.thinLTOMemoryBudget = mib << 20;
+  }
   ctx.arg.threadCount = parallel::strategy.compute_thread_count();
 
   if (ctx.arg.ltoPartitions == 0)
@@ -1742,6 +1811,22 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
         getPackDynRelocs(ctx, args);
   }
 
+  if (ctx.arg.bpStartupFunctionSort && ctx.arg.irpgoProfilePath.empty())
+    ErrAlways(ctx) << "--bp-startup-sort=function must be used with "
+                      "--irpgo-profile";
+  if (ctx.arg.bpCompressionSortStartupFunctions &&
+      !ctx.arg.bpStartupFunctionSort)
+    ErrAlways(ctx) << "--bp-compression-sort-startup-functions must be used "
+                      "with --bp-startup-sort=function";
+  if (ctx.arg.bpStartupFunctionSort || ctx.arg.bpFunctionOrderForCompression ||
+      ctx.arg.bpDataOrderForCompression) {
+    if (args.hasArg(OPT_call_graph_ordering_file))
+      ErrAlways(ctx) << "--bp-startup-sort and --bp-compression-sort may not "
+                        "be used together with --call-graph-ordering-file";
+    // Balanced partitioning supersedes the call graph profile sort.
+    ctx.arg.callGraphProfileSort = CGProfileSortKind::None;
+  }
+
   if (auto *arg = args.getLastArg(OPT_symbol_ordering_file)){
     if (args.hasArg(OPT_call_graph_ordering_file))
       ErrAlways(ctx) << "--symbol-ordering-file and --call-graph-order-file "
@@ -1923,6 +2008,23 @@ void LinkerDriver::createFiles(opt::InputArgList &args) {
   nextGroupId = 0;
   isInGroup = false;
   bool hasInput = false, hasScript = false;
+
+  // Opening the input files one after the other is latency bound on cold
+  // caches and network file systems. Start loading the files named on the
+  // command line in the background, so that addFile mostly finds them in
+  // memory. Files found by -l and linker scripts are still loaded on demand.
+  std::optional<MemoryBufferPrefetcher> prefetcher;
+  if (ctx.arg.threadCount > 1 && ctx.arg.chroot.empty() &&
+      ctx.arg.remapInputs.empty() && ctx.arg.remapInputsWildcards.empty()) {
+    prefetcher.emplace();
+    for (auto *arg : args.filtered(OPT_INPUT)) {
+      auto [it, inserted] = prefetchedFiles.try_emplace(arg->getValue());
+      if (inserted)
+        it->second = prefetcher->prefetch(arg->getValue(), /*IsText=*/false,
+                                          /*RequiresNullTerminator=*/false);
+    }
+  }
+
   for (auto *arg : args) {
     switch (arg->getOption().getID()) {
     case OPT_library:
@@ -2035,6 +2137,7 @@ void LinkerDriver::createFiles(opt::InputArgList &args) {
     readLinkerScript(ctx, *defaultScript);
   if (files.empty() && !hasInput && errCount(ctx) == 0)
     ErrAlways(ctx) << "no input files";
+  prefetchedFiles.clear();
 }
 
 // If -m <machine_type> was not given, infer it from object files.
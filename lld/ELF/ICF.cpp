@@ -33,10 +33,11 @@
 // terminates are considered identical. Here are details:
 //
 // 1. First, we partition sections using their hash values as keys. Hash
-//    values contain section types, section contents and numbers of
+//    values contain section flags, section contents and offsets and types of
 //    relocations. During this step, relocation targets are not taken into
 //    account. We just put sections that apparently differ into different
-//    equivalence classes.
+//    equivalence classes. Sections that end up alone in their classes are
+//    final and are not visited again.
 //
 // 2. Next, for each equivalence class, we visit sections to compare
 //    relocation targets. Relocation targets are considered equivalent if
@@ -114,8 +115,13 @@ private:
   bool equalsConstant(const InputSection *a, const InputSection *b);
   bool equalsVariable(const InputSection *a, const InputSection *b);
 
+  template <class RelTy>
+  uint64_t hashConstantRelocs(uint64_t hash, Relocs<RelTy> rels);
+
   size_t findBoundary(size_t begin, size_t end);
 
+  void dropUniqueSections();
+
   void forEachClassRange(size_t begin, size_t end,
                          llvm::function_ref<void(size_t, size_t)> fn);
 
@@ -385,6 +391,21 @@ bool ICF<ELFT>::equalsVariable(const InputSection *a, const InputSection *b) {
              : variableEq(a, ra.relas, b, rb.relas);
 }
 
+// Mix the parts of relocations that equalsConstant requires to be identical
+// into the initial hash of a section, so that the first partition is close to
+// the one computed by equalsConstant.
+template <class ELFT>
+template <class RelTy>
+uint64_t ICF<ELFT>::hashConstantRelocs(uint64_t hash, Relocs<RelTy> rels) {
+  for (const RelTy &rel : rels) {
+    uint64_t v[] = {hash, uint64_t(rel.r_offset),
+                    uint64_t(rel.getType(ctx.arg.isMips64EL))};
+    hash = xxh3_64bits(ArrayRef<uint8_t>(reinterpret_cast<uint8_t *>(v),
+                                         sizeof(v)));
+  }
+  return hash;
+}
+
 template <class ELFT> size_t ICF<ELFT>::findBoundary(size_t begin, size_t end) {
   uint32_t eqClass = sections[begin]->eqClass[current];
   for (size_t i = begin + 1; i < end; ++i)
@@ -443,6 +464,31 @@ void ICF<ELFT>::forEachClass(llvm::function_ref<void(size_t, size_t)> fn) {
   ++cnt;
 }
 
+// Sections that are alone in their equivalence classes after comparing the
+// constant parts cannot be folded, and their classes never change. Usually
+// most sections are such ones, so remove them to let the iterations comparing
+// relocation targets only visit classes that may still be split.
+template <class ELFT> void ICF<ELFT>::dropUniqueSections() {
+  size_t numSections = sections.size(), j = 0;
+  for (size_t begin = 0, end; begin != numSections; begin = end) {
+    uint32_t eqClass = sections[begin]->eqClass[next];
+    for (end = begin + 1;
+         end != numSections && sections[end]->eqClass[next] == eqClass; ++end)
+      ;
+    // The dropped sections are still read as relocation targets, so their
+    // class IDs must be valid in both slots.
+    if (end - begin == 1) {
+      sections[begin]->eqClass[0] = sections[begin]->eqClass[1] = eqClass;
+      continue;
+    }
+    for (size_t i = begin; i != end; ++i)
+      sections[j++] = sections[i];
+  }
+  Log(ctx) << "ICF: " << j << " of " << numSections
+           << " sections remain after comparing section contents";
+  sections.resize(j);
+}
+
 // Combine the hashes of the sections referenced by the given section into its
 // hash.
 template <class RelTy>
@@ -487,10 +533,19 @@ template <class ELFT> void ICF<ELFT>::run() {
     }
   }
 
-  // Initially, we use hash values to partition sections.
+  // Initially, we use hash values to partition sections. The hash covers
+  // everything compared by equalsConstant except relocation targets.
   parallelForEach(sections, [&](InputSection *s) {
+    uint64_t hash = xxh3_64bits(s->content()) ^ s->flags;
+    const RelsOrRelas<ELFT> rels = s->template relsOrRelas<ELFT>();
+    if (rels.areRelocsCrel())
+      hash = hashConstantRelocs(hash, rels.crels);
+    else if (rels.areRelocsRel())
+      hash = hashConstantRelocs(hash, rels.rels);
+    else
+      hash = hashConstantRelocs(hash, rels.relas);
     // Set MSB to 1 to avoid collisions with unique IDs.
-    s->eqClass[0] = xxh3_64bits(s->content()) | (1U << 31);
+    s->eqClass[0] = hash | (1U << 31);
   });
 
   // Perform 2 rounds of relocation hash propagation. 2 is an empirical value to
@@ -522,6 +577,11 @@ template <class ELFT> void ICF<ELFT>::run() {
     segregate(begin, end, eqClassBase, true);
   });
 
+  // IDs of the classes created from now on are derived from indices into the
+  // smaller vector. Move them past the IDs kept by the dropped sections.
+  eqClassBase += sections.size();
+  dropUniqueSections();
+
   // Split groups by comparing relocations until convergence is obtained.
   do {
     repeat = false;
@@ -0,0 +1,298 @@
+//===- Incremental.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements --incremental.
+//
+// Relinking a large program after a small change spends most of its time
+// applying relocations to sections whose contents end up being identical to
+// the previous output. When --incremental is given, we write a state file
+// <output>.incremental after each successful link. It contains
+//
+//  - a hash of the command line,
+//  - a hash of everything that an input section's relocated contents may
+//    depend on besides the object file it comes from: the addresses and sizes
+//    of output sections and synthetic sections, the TLS segment, and the
+//    value and GOT/PLT indexes of every global symbol, and
+//  - for each object file, a hash of its contents and a hash of the
+//    addresses assigned to its sections, section pieces and local symbols,
+//    along with the resolved targets of its SHF_ALLOC relocations.
+//
+// On the next link, the layout is computed as usual. If the command line and
+// the global layout hash match and the previous output has not been touched,
+// the relocated contents of every object file whose two hashes match are
+// copied from the previous output instead of being written again. Synthetic
+// sections are always regenerated. If anything does not match, every section
+// is written as in a regular link.
+//
+// The placement of input sections is not constrained in any way, so a change
+// that alters the size of a section or the address of a global symbol falls
+// back to a full write. Reserving padding in output sections to absorb such
+// changes is left for future work.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Incremental.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "LinkerScript.h"
+#include "OutputSections.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include "SyntheticSections.h"
+#include "llvm/Option/ArgList.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace llvm::ELF;
+using namespace llvm::support::endian;
+using namespace lld;
+using namespace lld::elf;
+
+// "LLDINCR" followed by the format version.
+static constexpr uint64_t stateMagic = 0x0152434e49444c4cULL;
+
+// The state file header: magic, options hash, layout hash, output size,
+// output file ID, output modification time and the number of files.
+static constexpr size_t numHeaderWords = 7;
+
+static uint64_t hashWords(ArrayRef<uint64_t> v) {
+  return xxh3_64bits(ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(v.data()), v.size() * sizeof(v[0])));
+}
+
+// Returns the address of sym, or 0 if it does not have one.
+static uint64_t getStableVA(Ctx &ctx, const Symbol &sym, int64_t addend) {
+  auto *d = dyn_cast<Defined>(&sym);
+  if (!d)
+    return 0;
+  if (d->section &&
+      (d->section == &InputSection::discarded || !d->section->isLive()))
+    return 0;
+  if (d->isTls() && (!ctx.tlsPhdr || !ctx.tlsPhdr->firstSec))
+    return 0;
+  return d->getVA(ctx, addend);
+}
+
+static void addSymbol(Ctx &ctx, SmallVectorImpl<uint64_t> &v,
+                      const Symbol &sym) {
+  const SymbolAux &aux = ctx.symAux[sym.auxIdx];
+  v.push_back(uint64_t(sym.kind()) | uint64_t(sym.binding) << 8 |
+              uint64_t(sym.type) << 12 | uint64_t(sym.stOther) << 16 |
+              uint64_t(sym.isPreemptible) << 24 |
+              uint64_t(sym.gotInIgot) << 25);
+  v.push_back(sym.flags.load(std::memory_order_relaxed));
+  v.push_back(getStableVA(ctx, sym, 0));
+  v.push_back(aux.gotIdx | uint64_t(aux.pltIdx) << 32);
+  v.push_back(aux.tlsDescIdx | uint64_t(aux.tlsGdIdx) << 32);
+  if (sym.isDefined() || sym.isShared())
+    v.push_back(sym.getSize());
+}
+
+static void addSection(Ctx &ctx, SmallVectorImpl<uint64_t> &v,
+                       const InputSectionBase *sec) {
+  if (!sec || sec == &InputSection::discarded || !sec->isLive()) {
+    v.push_back(0);
+    return;
+  }
+
+  if (auto *ms = dyn_cast<MergeInputSection>(sec)) {
+    v.push_back(ms->getParent() ? ms->getParent()->getVA() : 0);
+    for (const SectionPiece &piece : ms->pieces)
+      v.push_back(piece.live ? piece.outputOff : -1);
+    return;
+  }
+  if (auto *eh = dyn_cast<EhInputSection>(sec)) {
+    for (const EhSectionPiece &piece : eh->cies)
+      v.push_back(piece.outputOff);
+    for (const EhSectionPiece &piece : eh->fdes)
+      v.push_back(piece.outputOff);
+    return;
+  }
+
+  auto *isec = dyn_cast<InputSection>(sec);
+  if (!isec) {
+    v.push_back(0);
+    return;
+  }
+  v.push_back(isec->getVA());
+  v.push_back(isec->getSize());
+  v.push_back(isec->repl == isec);
+
+  // Non-SHF_ALLOC sections are relocated directly from the input relocations,
+  // whose targets are covered by the section and symbol addresses. For
+  // SHF_ALLOC sections, relocations may have been redirected to thunks or
+  // relaxed, so we hash the scanned relocations.
+  if (isec->flags & SHF_ALLOC)
+    for (const Relocation &r : isec->relocs())
+      v.append({r.offset, uint64_t(r.expr) | uint64_t(r.type) << 32,
+                uint64_t(r.addend),
+                r.sym ? getStableVA(ctx, *r.sym, r.addend) : 0});
+}
+
+IncrementalLink::IncrementalLink(Ctx &ctx, opt::InputArgList &args)
+    : ctx(ctx) {
+  std::string cmdline;
+  for (const opt::Arg *arg : args) {
+    cmdline += arg->getAsString(args);
+    cmdline += '\0';
+  }
+  optionsHash = xxh3_64bits(cmdline);
+}
+
+void IncrementalLink::computeSignatures(uint64_t fileSize) {
+  SmallVector<uint64_t, 0> v;
+  v.append({optionsHash, fileSize});
+
+  SmallVector<InputSection *, 0> storage;
+  for (OutputSection *osec : ctx.outputSections) {
+    v.append({xxh3_64bits(osec->name), osec->addr, osec->offset, osec->size,
+              osec->type, osec->flags});
+    for (InputSection *isec : getInputSections(*osec, storage))
+      if (isa<SyntheticSection>(isec))
+        v.append({isec->outSecOff, isec->getSize()});
+  }
+  if (ctx.tlsPhdr)
+    v.append({ctx.tlsPhdr->p_vaddr, ctx.tlsPhdr->p_memsz,
+              ctx.tlsPhdr->p_align});
+  for (Symbol *sym : ctx.symtab->getSymbols())
+    addSymbol(ctx, v, *sym);
+  layoutHash = hashWords(v);
+
+  files.resize(ctx.objectFiles.size());
+  parallelFor(0, ctx.objectFiles.size(), [&](size_t i) {
+    ELFFileBase *file = ctx.objectFiles[i];
+    SmallVector<uint64_t, 0> v;
+    for (InputSectionBase *sec : file->getSections())
+      addSection(ctx, v, sec);
+    for (Symbol *sym : file->getLocalSymbols())
+      addSymbol(ctx, v, *sym);
+    uint64_t id = hashWords(
+        {xxh3_64bits(file->archiveName), xxh3_64bits(file->getName())});
+    files[i] = {id, {xxh3_64bits(file->mb.getBuffer()), hashWords(v)}};
+  });
+}
+
+bool IncrementalLink::loadPreviousState() {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr =
+      MemoryBuffer::getFile(statePath, /*IsText=*/false,
+                            /*RequiresNullTerminator=*/false);
+  if (!mbOrErr) {
+    Log(ctx) << "--incremental: no previous state, writing all sections";
+    return false;
+  }
+
+  StringRef buf = (*mbOrErr)->getBuffer();
+  auto word = [&](size_t i) { return read64le(buf.data() + i * 8); };
+  if (buf.size() < numHeaderWords * 8 || word(0) != stateMagic ||
+      buf.size() != (numHeaderWords + word(6) * 3) * 8) {
+    Log(ctx) << "--incremental: " << statePath
+             << " is malformed, writing all sections";
+    return false;
+  }
+  if (word(1) != optionsHash) {
+    Log(ctx) << "--incremental: command line changed, writing all sections";
+    return false;
+  }
+  if (word(2) != layoutHash) {
+    Log(ctx) << "--incremental: layout changed, writing all sections";
+    return false;
+  }
+
+  // The previous output must be exactly what the previous link produced.
+  sys::fs::file_status st;
+  if (sys::fs::status(ctx.arg.outputFile, st) || st.getSize() != word(3) ||
+      st.getUniqueID().getFile() != word(4) ||
+      uint64_t(st.getLastModificationTime().time_since_epoch().count()) !=
+          word(5)) {
+    Log(ctx) << "--incremental: " << ctx.arg.outputFile
+             << " has been modified, writing all sections";
+    return false;
+  }
+
+  // Map the previous output before the Writer unlinks it. The mapping stays
+  // valid while we write the new output.
+  ErrorOr<std::unique_ptr<MemoryBuffer>> outOrErr =
+      MemoryBuffer::getFile(ctx.arg.outputFile, /*IsText=*/false,
+                            /*RequiresNullTerminator=*/false);
+  if (!outOrErr || (*outOrErr)->getBufferSize() != word(3))
+    return false;
+  prevOutput = std::move(*outOrErr);
+
+  for (size_t i = 0, e = word(6); i != e; ++i) {
+    size_t base = numHeaderWords + i * 3;
+    prevFiles[word(base)] = {word(base + 1), word(base + 2)};
+  }
+  return true;
+}
+
+void IncrementalLink::prepare(uint64_t fileSize) {
+  llvm::TimeTraceScope timeScope("Incremental link");
+  // The output file name may have been set by a linker script.
+  statePath = (ctx.arg.outputFile + ".incremental").str();
+  computeSignatures(fileSize);
+  if (!loadPreviousState())
+    return;
+
+  for (size_t i = 0, e = files.size(); i != e; ++i) {
+    auto it = prevFiles.find(files[i].first);
+    if (it != prevFiles.end() &&
+        it->second.contentHash == files[i].second.contentHash &&
+        it->second.layoutHash == files[i].second.layoutHash)
+      reusableFiles.insert(ctx.objectFiles[i]);
+  }
+  Log(ctx) << "--incremental: reusing the contents of " << reusableFiles.size()
+           << " of " << files.size() << " object files";
+  if (reusableFiles.empty())
+    prevOutput.reset();
+}
+
+bool IncrementalLink::copyPreviousContents(const InputSection &isec,
+                                           uint8_t *loc) const {
+  if (!prevOutput || !reusableFiles.count(isec.file))
+    return false;
+  memcpy(loc, prevOutput->getBufferStart() + (loc - ctx.bufferStart),
+         isec.getSize());
+  return true;
+}
+
+void IncrementalLink::saveState() {
+  prevOutput.reset();
+
+  sys::fs::file_status st;
+  std::error_code ec = sys::fs::status(ctx.arg.outputFile, st);
+  if (ec) {
+    Warn(ctx) << "--incremental: cannot stat " << ctx.arg.outputFile << ": "
+              << ec.message();
+    return;
+  }
+  raw_fd_ostream os(statePath, ec, sys::fs::OF_None);
+  if (ec) {
+    Warn(ctx) << "--incremental: cannot open " << statePath << ": "
+              << ec.message();
+    return;
+  }
+
+  support::endian::Writer w(os, llvm::endianness::little);
+  w.write<uint64_t>(stateMagic);
+  w.write<uint64_t>(optionsHash);
+  w.write<uint64_t>(layoutHash);
+  w.write<uint64_t>(st.getSize());
+  w.write<uint64_t>(st.getUniqueID().getFile());
+  w.write<uint64_t>(st.getLastModificationTime().time_since_epoch().count());
+  w.write<uint64_t>(files.size());
+  for (const auto &[id, state] : files) {
+    w.write<uint64_t>(id);
+    w.write<uint64_t>(state.contentHash);
+    w.write<uint64_t>(state.layoutHash);
+  }
+}
@@ -0,0 +1,69 @@
+//===- Incremental.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_ELF_INCREMENTAL_H
+#define LLD_ELF_INCREMENTAL_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <memory>
+
+namespace llvm::opt {
+class InputArgList;
+}
+
+namespace lld::elf {
+struct Ctx;
+class InputFile;
+class InputSection;
+
+// Implements --incremental. After a successful link, a state file recording a
+// signature of the output layout and of every input object file is written
+// next to the output. When the next link arrives at the same layout, the
+// contents of input sections whose object files are unchanged are copied
+// from the previous output instead of being relocated again.
+class IncrementalLink {
+public:
+  IncrementalLink(Ctx &ctx, llvm::opt::InputArgList &args);
+
+  // Compare the final layout against the state file of the previous link and
+  // map the previous output if it can be reused. Must be called after all
+  // addresses and file offsets have been assigned and before the output file
+  // is opened.
+  void prepare(uint64_t fileSize);
+
+  // If the contents of isec can be taken from the previous output, copy them
+  // to loc, which points into the output buffer, and return true.
+  bool copyPreviousContents(const InputSection &isec, uint8_t *loc) const;
+
+  // Write the state file for the output that has just been committed.
+  void saveState();
+
+private:
+  struct FileState {
+    uint64_t contentHash;
+    uint64_t layoutHash;
+  };
+
+  void computeSignatures(uint64_t fileSize);
+  bool loadPreviousState();
+
+  Ctx &ctx;
+  std::string statePath;
+  uint64_t optionsHash = 0;
+  uint64_t layoutHash = 0;
+  llvm::SmallVector<std::pair<uint64_t, FileState>, 0> files;
+  llvm::DenseMap<uint64_t, FileState> prevFiles;
+  llvm::DenseSet<const InputFile *> reusableFiles;
+  std::unique_ptr<llvm::MemoryBuffer> prevOutput;
+};
+} // namespace lld::elf
+
+#endif
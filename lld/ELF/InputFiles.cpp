@@ -26,6 +26,7 @@
 #include "llvm/Support/ARMBuildAttributes.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/RISCVAttributeParser.h"
 #include "llvm/Support/TimeProfiler.h"
@@ -251,8 +252,15 @@ std::optional<MemoryBufferRef> elf::readFile(Ctx &ctx, StringRef path) {
   Log(ctx) << path;
   ctx.arg.dependencyFiles.insert(llvm::CachedHashString(path));
 
-  auto mbOrErr = MemoryBuffer::getFile(path, /*IsText=*/false,
-                                       /*RequiresNullTerminator=*/false);
+  auto mbOrErr = [&]() -> ErrorOr<std::unique_ptr<MemoryBuffer>> {
+    auto pf = ctx.driver.prefetchedFiles.find(path);
+    if (pf == ctx.driver.prefetchedFiles.end())
+      return MemoryBuffer::getFile(path, /*IsText=*/false,
+                                   /*RequiresNullTerminator=*/false);
+    ErrorOr<std::unique_ptr<MemoryBuffer>> mb = pf->second.get();
+    ctx.driver.prefetchedFiles.erase(pf);
+    return mb;
+  }();
   if (auto ec = mbOrErr.getError()) {
     ErrAlways(ctx) << "cannot open " << path << ": " << ec.message();
     return std::nullopt;
@@ -345,10 +353,39 @@ extern template void ObjFile<ELF32BE>::importCmseSymbols();
 extern template void ObjFile<ELF64LE>::importCmseSymbols();
 extern template void ObjFile<ELF64BE>::importCmseSymbols();
 
+// Symbol resolution is order dependent because it may extract archive members,
+// so it has to be done serially. However, with many input files, a large
+// portion of the time is spent looking up names in the symbol table. Intern
+// the global symbol names of relocatable object files using multiple threads
+// beforehand. ObjFile::initializeSymbols skips symbols that have been filled.
+template <class ELFT>
+static void
+preinsertSymbols(Ctx &ctx,
+                 const SmallVector<std::unique_ptr<InputFile>, 0> &files) {
+  SmallVector<ObjFile<ELFT> *, 0> objs;
+  for (const std::unique_ptr<InputFile> &file : files)
+    if (file->kind() == InputFile::ObjKind && !file->lazy &&
+        file->ekind == ctx.arg.ekind)
+      objs.push_back(cast<ObjFile<ELFT>>(file.get()));
+  if (ctx.arg.threadCount == 1 || objs.size() < 2)
+    return;
+
+  llvm::TimeTraceScope timeScope("Preinsert symbols");
+  SmallVector<SmallVector<CachedHashStringRef, 0>, 0> names(objs.size());
+  SmallVector<MutableArrayRef<Symbol *>, 0> syms(objs.size());
+  parallelFor(0, objs.size(), [&](size_t i) {
+    names[i] = objs[i]->getNamesToPreinsert();
+    syms[i] = objs[i]->getMutableGlobalSymbols();
+  });
+  ctx.symtab->insertParallel(names, syms);
+}
+
 template <class ELFT>
 static void
 doParseFiles(Ctx &ctx,
              const SmallVector<std::unique_ptr<InputFile>, 0> &files) {
+  preinsertSymbols<ELFT>(ctx, files);
+
   // Add all files to the symbol table. This will add almost all symbols that we
   // need to the symbol table. This process might add files to the link due to
   // addDependentLibrary.
@@ -1084,6 +1121,29 @@ InputSectionBase *ObjFile<ELFT>::createInputSection(uint32_t idx,
   return makeThreadLocal<InputSection>(*this, sec, name);
 }
 
+template <class ELFT>
+SmallVector<CachedHashStringRef, 0> ObjFile<ELFT>::getNamesToPreinsert() {
+  ArrayRef<Elf_Sym> eSyms = this->getELFSyms<ELFT>();
+  if (!symbols)
+    symbols = std::make_unique<Symbol *[]>(numSymbols);
+
+  SmallVector<CachedHashStringRef, 0> names;
+  names.reserve(eSyms.size() - firstGlobal);
+  for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i) {
+    // Leave invalid names to initializeSymbols, which reports errors, and
+    // names containing '@', whose handling depends on the insertion order.
+    uint32_t nameOff = eSyms[i].st_name;
+    StringRef name;
+    if (nameOff < stringTable.size())
+      name = stringTable.data() + nameOff;
+    if (symbols[i] || name.empty() || name.contains('@'))
+      names.emplace_back(StringRef(), 0);
+    else
+      names.emplace_back(name);
+  }
+  return names;
+}
+
 // Initialize symbols. symbols is a parallel array to the corresponding ELF
 // symbol table.
 template <class ELFT>
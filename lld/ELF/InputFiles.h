@@ -14,6 +14,7 @@
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/LLVM.h"
 #include "lld/Common/Reproduce.h"
+#include "llvm/ADT/CachedHashString.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/BinaryFormat/Magic.h"
 #include "llvm/Object/ELF.h"
@@ -263,6 +264,12 @@ public:
   void parse(bool ignoreComdats = false);
   void parseLazy();
 
+  // Allocates the symbol array and returns the names of global symbols to be
+  // inserted by SymbolTable::insertParallel before parse() is called. Names
+  // that must be inserted by parse(), such as versioned names, are returned as
+  // empty strings.
+  SmallVector<llvm::CachedHashStringRef, 0> getNamesToPreinsert();
+
   StringRef getShtGroupSignature(ArrayRef<Elf_Shdr> sections,
                                  const Elf_Shdr &sec);
 
@@ -139,16 +139,22 @@ static lto::Config createConfig(Ctx &ctx) {
   c.AllVtablesHaveTypeInfos = ctx.ltoAllVtablesHaveTypeInfos;
   c.AlwaysEmitRegularLTOObj = !ctx.arg.ltoObjPath.empty();
   c.KeepSymbolNameCopies = false;
+  // Input buffers are kept until the end of the link.
+  c.ReferenceBitcodeMDStrings = true;
 
   for (const llvm::StringRef &name : ctx.arg.thinLTOModulesToCompile)
     c.ThinLTOModulesToCompile.emplace_back(name);
 
   c.TimeTraceEnabled = ctx.arg.timeTraceEnabled;
   c.TimeTraceGranularity = ctx.arg.timeTraceGranularity;
+  c.ThinLTOMemoryBudget = ctx.arg.thinLTOMemoryBudget;
+  c.ThinLTOCacheOptimizedIR = ctx.arg.thinLTOCacheOptimizedIR;
+  c.ThinLTOBackendStatsFile = std::string(ctx.arg.thinLTOBackendStatsFile);
 
   c.CSIRProfile = std::string(ctx.arg.ltoCSProfileFile);
   c.RunCSIRInstr = ctx.arg.ltoCSProfileGenerate;
   c.PGOWarnMismatch = ctx.arg.ltoPGOWarnMismatch;
+  c.CostBasedCodeGenSplit = ctx.arg.ltoPartitionCostModel;
 
   if (ctx.arg.emitLLVM) {
     c.PreCodeGenModuleHook = [&ctx](size_t task, const Module &m) {
@@ -318,14 +324,21 @@ SmallVector<std::unique_ptr<InputFile>, 0> BitcodeCompiler::compile() {
   // The --thinlto-cache-dir option specifies the path to a directory in which
   // to cache native object files for ThinLTO incremental builds. If a path was
   // specified, configure LTO to use it as the cache directory.
+  // With --thinlto-remote-cache-dir, objects missing from the local cache are
+  // looked up in a directory shared between machines before being compiled.
   FileCache cache;
-  if (!ctx.arg.thinLTOCacheDir.empty())
-    cache = check(localCache("ThinLTO", "Thin", ctx.arg.thinLTOCacheDir,
-                             [&](size_t task, const Twine &moduleName,
-                                 std::unique_ptr<MemoryBuffer> mb) {
-                               files[task] = std::move(mb);
-                               filenames[task] = moduleName.str();
-                             }));
+  auto addBuffer = [&](size_t task, const Twine &moduleName,
+                       std::unique_ptr<MemoryBuffer> mb) {
+    files[task] = std::move(mb);
+    filenames[task] = moduleName.str();
+  };
+  if (!ctx.arg.thinLTORemoteCacheDir.empty())
+    cache = check(remoteBackedCache(
+        "ThinLTO", "Thin", ctx.arg.thinLTOCacheDir,
+        createDirectoryCacheStore(ctx.arg.thinLTORemoteCacheDir), addBuffer));
+  else if (!ctx.arg.thinLTOCacheDir.empty())
+    cache = check(
+        localCache("ThinLTO", "Thin", ctx.arg.thinLTOCacheDir, addBuffer));
 
   if (!ctx.bitcodeFiles.empty())
     checkError(ctx.e, ltoObj->run(
@@ -8,6 +8,7 @@
 
 #include "OutputSections.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "InputFiles.h"
 #include "LinkerScript.h"
 #include "Symbols.h"
@@ -542,15 +543,20 @@ void OutputSection::writeTo(Ctx &ctx, uint8_t *buf, parallel::TaskGroup &tg) {
     size_t numSections = sections.size();
     for (size_t i = begin; i != end; ++i) {
       InputSection *isec = sections[i];
+      bool reused = false;
       if (auto *s = dyn_cast<SyntheticSection>(isec))
         s->writeTo(buf + isec->outSecOff);
+      else if (ctx.incremental && ctx.incremental->copyPreviousContents(
+                                      *isec, buf + isec->outSecOff))
+        reused = true;
       else
         isec->writeTo<ELFT>(ctx, buf + isec->outSecOff);
 
       // When in Arm BE8 mode, the linker has to convert the big-endian
-      // instructions to little-endian, leaving the data big-endian.
+      // instructions to little-endian, leaving the data big-endian. Contents
+      // copied from the previous output have already been converted.
       if (ctx.arg.emachine == EM_ARM && !ctx.arg.isLE && ctx.arg.armBe8 &&
-          (flags & SHF_EXECINSTR))
+          (flags & SHF_EXECINSTR) && !reused)
         convertArmInstructionstoBE8(ctx, isec, buf + isec->outSecOff);
 
       // Fill gaps between sections.
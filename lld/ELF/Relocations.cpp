@@ -1506,8 +1506,10 @@ void RelocationScanner::scanOne(typename Relocs<RelTy>::const_iterator &i) {
     // Record the TOC entry (.toc + addend) as not relaxable. See the comment in
     // InputSectionBase::relocateAlloc().
     if (type == R_PPC64_TOC16_LO && sym.isSection() && isa<Defined>(sym) &&
-        cast<Defined>(sym).section->name == ".toc")
+        cast<Defined>(sym).section->name == ".toc") {
+      std::lock_guard<std::mutex> lock(ctx.relocMutex);
       ctx.ppc64noTocRelax.insert({&sym, addend});
+    }
 
     if ((type == R_PPC64_TLSGD && expr == R_TLSDESC_CALL) ||
         (type == R_PPC64_TLSLD && expr == R_TLSLD_HINT)) {
@@ -1601,7 +1603,10 @@ void RelocationScanner::scan(Relocs<RelTy> rels) {
   // Not all relocations end up in Sec->Relocations, but a lot do.
   sec->relocations.reserve(rels.size());
 
-  if (ctx.arg.emachine == EM_PPC64)
+  // .eh_frame is scanned by a separate task and never contains TLS
+  // relocations. Skip it so that we don't read ppc64DisableTLSRelax while
+  // another thread may be setting it.
+  if (ctx.arg.emachine == EM_PPC64 && !isa<EhInputSection>(sec))
     checkPPC64TLSRelax<RelTy>(*sec, rels);
 
   // For EhInputSection, OffsetGetter expects the relocations to be sorted by
@@ -1646,56 +1651,101 @@ void RelocationScanner::scanSection(InputSectionBase &s, bool isEH) {
     scan<ELFT>(rels.relas);
 }
 
+// Sort the dynamic relocations added by a parallel scan into the order of a
+// serial scan, which visits the relocations of object files in command line
+// order followed by .eh_frame and .ARM.exidx. A task scans either one object
+// file or all .eh_frame and .ARM.exidx sections, and the relocations added by
+// a task are contiguous within a thread, so a stable sort by task suffices.
+static void sortScannedRels(Ctx &ctx,
+                            ArrayRef<std::pair<size_t, size_t>> relocsBegin) {
+  DenseMap<const InputFile *, uint32_t> fileRank;
+  for (auto [i, f] : llvm::enumerate(ctx.objectFiles))
+    fileRank[f] = i;
+  const uint32_t ehRank = ctx.objectFiles.size();
+  auto rank = [&](const InputSectionBase *sec) {
+    if (isa<EhInputSection>(sec) ||
+        (sec->type == SHT_ARM_EXIDX && ctx.arg.emachine == EM_ARM))
+      return ehRank;
+    return fileRank.lookup(sec->file);
+  };
+
+  for (auto [part, begin] : llvm::zip(ctx.partitions, relocsBegin)) {
+    if (part.relaDyn)
+      part.relaDyn->sortScannedRels(begin.first, rank);
+    if (part.relrAuthDyn)
+      std::stable_sort(part.relrAuthDyn->relocs.begin() + begin.second,
+                       part.relrAuthDyn->relocs.end(),
+                       [&](const RelativeReloc &a, const RelativeReloc &b) {
+                         return rank(a.inputSec) < rank(b.inputSec);
+                       });
+  }
+}
+
 template <class ELFT> void elf::scanRelocations(Ctx &ctx) {
   // Scan all relocations. Each relocation goes through a series of tests to
   // determine if it needs special treatment, such as creating GOT, PLT,
   // copy relocations, etc. Note that relocations for non-alloc sections are
   // directly processed by InputSection::relocateNonAlloc.
 
-  // Deterministic parallellism needs sorting relocations which is unsuitable
-  // for -z nocombreloc. MIPS and PPC64 use global states which are not suitable
-  // for parallelism.
-  bool serial = !ctx.arg.zCombreloc || ctx.arg.emachine == EM_MIPS ||
-                ctx.arg.emachine == EM_PPC64;
-  parallel::TaskGroup tg;
-  auto outerFn = [&]() {
-    for (ELFFileBase *f : ctx.objectFiles) {
-      auto fn = [f, &ctx]() {
+  // MIPS builds its GOT while scanning relocations, and the result depends on
+  // the order in which relocations are visited, so it is scanned serially.
+  bool serial = ctx.arg.emachine == EM_MIPS;
+
+  // -z combreloc sorts dynamic relocations, so their order does not depend on
+  // the order in which they are added. Otherwise, record where the relocations
+  // added by this scan start so that the serial order can be restored.
+  bool sortRels = !serial && !ctx.arg.zCombreloc;
+  SmallVector<std::pair<size_t, size_t>, 0> relocsBegin;
+  if (sortRels)
+    for (Partition &part : ctx.partitions)
+      relocsBegin.emplace_back(
+          part.relaDyn ? part.relaDyn->relocs.size() : 0,
+          part.relrAuthDyn ? part.relrAuthDyn->relocs.size() : 0);
+
+  {
+    parallel::TaskGroup tg;
+    auto outerFn = [&]() {
+      for (ELFFileBase *f : ctx.objectFiles) {
+        auto fn = [f, &ctx]() {
+          RelocationScanner scanner(ctx);
+          for (InputSectionBase *s : f->getSections()) {
+            if (s && s->kind() == SectionBase::Regular && s->isLive() &&
+                (s->flags & SHF_ALLOC) &&
+                !(s->type == SHT_ARM_EXIDX && ctx.arg.emachine == EM_ARM))
+              scanner.template scanSection<ELFT>(*s);
+          }
+        };
+        if (serial)
+          fn();
+        else
+          tg.spawn(fn);
+      }
+      auto scanEH = [&] {
         RelocationScanner scanner(ctx);
-        for (InputSectionBase *s : f->getSections()) {
-          if (s && s->kind() == SectionBase::Regular && s->isLive() &&
-              (s->flags & SHF_ALLOC) &&
-              !(s->type == SHT_ARM_EXIDX && ctx.arg.emachine == EM_ARM))
-            scanner.template scanSection<ELFT>(*s);
+        for (Partition &part : ctx.partitions) {
+          for (EhInputSection *sec : part.ehFrame->sections)
+            scanner.template scanSection<ELFT>(*sec, /*isEH=*/true);
+          if (part.armExidx && part.armExidx->isLive())
+            for (InputSection *sec : part.armExidx->exidxSections)
+              if (sec->isLive())
+                scanner.template scanSection<ELFT>(*sec);
         }
       };
       if (serial)
-        fn();
+        scanEH();
       else
-        tg.spawn(fn);
-    }
-    auto scanEH = [&] {
-      RelocationScanner scanner(ctx);
-      for (Partition &part : ctx.partitions) {
-        for (EhInputSection *sec : part.ehFrame->sections)
-          scanner.template scanSection<ELFT>(*sec, /*isEH=*/true);
-        if (part.armExidx && part.armExidx->isLive())
-          for (InputSection *sec : part.armExidx->exidxSections)
-            if (sec->isLive())
-              scanner.template scanSection<ELFT>(*sec);
-      }
+        tg.spawn(scanEH);
     };
+    // If `serial` is true, call `spawn` to ensure that `scanner` runs in a
+    // thread with valid getThreadIndex().
     if (serial)
-      scanEH();
+      tg.spawn(outerFn);
     else
-      tg.spawn(scanEH);
-  };
-  // If `serial` is true, call `spawn` to ensure that `scanner` runs in a thread
-  // with valid getThreadIndex().
-  if (serial)
-    tg.spawn(outerFn);
-  else
-    outerFn();
+      outerFn();
+  }
+
+  if (sortRels)
+    sortScannedRels(ctx, relocsBegin);
 }
 
 RelocationBaseSection &elf::getIRelativeSection(Ctx &ctx) {
@@ -22,6 +22,7 @@
 #include "lld/Common/Strings.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Demangle/Demangle.h"
+#include "llvm/Support/Parallel.h"
 
 using namespace llvm;
 using namespace llvm::object;
@@ -83,6 +84,13 @@ Symbol *SymbolTable::insert(StringRef name) {
     return sym;
   }
 
+  Symbol *sym = addNewSymbol(name);
+  if (pos != StringRef::npos)
+    sym->hasVersionSuffix = true;
+  return sym;
+}
+
+Symbol *SymbolTable::addNewSymbol(StringRef name) {
   Symbol *sym = reinterpret_cast<Symbol *>(make<SymbolUnion>());
   symVector.push_back(sym);
 
@@ -91,11 +99,70 @@ Symbol *SymbolTable::insert(StringRef name) {
   sym->setName(name);
   sym->partition = 1;
   sym->versionId = VER_NDX_GLOBAL;
-  if (pos != StringRef::npos)
-    sym->hasVersionSuffix = true;
   return sym;
 }
 
+void SymbolTable::insertParallel(
+    ArrayRef<SmallVector<CachedHashStringRef, 0>> names,
+    ArrayRef<MutableArrayRef<Symbol *>> syms) {
+  struct Entry {
+    CachedHashStringRef name;
+    // The position of the first occurrence: file index << 32 | name index.
+    uint64_t firstUse;
+    Symbol *sym;
+  };
+
+  // Find unique names. Shard them by hash's high bits so that each thread owns
+  // a disjoint set of names and no locking is needed.
+  constexpr size_t numShards = 32;
+  const size_t concurrency =
+      llvm::bit_floor(std::min<size_t>(ctx.arg.threadCount, numShards));
+  const size_t shift = 32 - llvm::countr_zero(numShards);
+  auto map = std::make_unique<DenseMap<CachedHashStringRef, uint32_t>[]>(
+      numShards);
+  auto entries = std::make_unique<SmallVector<Entry, 0>[]>(numShards);
+  parallelFor(0, concurrency, [&](size_t threadId) {
+    for (size_t i = 0, e = names.size(); i != e; ++i) {
+      for (auto [j, name] : llvm::enumerate(names[i])) {
+        if (name.size() == 0)
+          continue;
+        size_t shardId = name.hash() >> shift;
+        if ((shardId & (concurrency - 1)) != threadId)
+          continue;
+        if (map[shardId].try_emplace(name, entries[shardId].size()).second)
+          entries[shardId].push_back({name, uint64_t(i) << 32 | j, nullptr});
+      }
+    }
+  });
+
+  // Add new symbols in the order of their first occurrences to keep the
+  // order of symVector the same as that of a serial link. This part is serial,
+  // but it only visits each unique name once.
+  SmallVector<Entry *, 0> order;
+  for (MutableArrayRef<Entry> v : MutableArrayRef(entries.get(), numShards))
+    for (Entry &ent : v)
+      order.push_back(&ent);
+  parallelSort(order, [](const Entry *a, const Entry *b) {
+    return a->firstUse < b->firstUse;
+  });
+  symMap.reserve(symMap.size() + order.size());
+  symVector.reserve(symVector.size() + order.size());
+  for (Entry *ent : order) {
+    auto [it, inserted] = symMap.try_emplace(ent->name, symVector.size());
+    ent->sym = inserted ? addNewSymbol(ent->name.val()) : symVector[it->second];
+  }
+
+  // The maps are now read-only. Fill in the symbols of each file.
+  parallelFor(0, names.size(), [&](size_t i) {
+    for (auto [j, name] : llvm::enumerate(names[i])) {
+      if (name.size() == 0)
+        continue;
+      size_t shardId = name.hash() >> shift;
+      syms[i][j] = entries[shardId][map[shardId].find(name)->second].sym;
+    }
+  });
+}
+
 // This variant of addSymbol is used by BinaryFile::parse to check duplicate
 // symbol errors.
 Symbol *SymbolTable::addAndCheckDuplicate(Ctx &ctx, const Defined &newSym) {
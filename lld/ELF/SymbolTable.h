@@ -12,6 +12,7 @@
 #include "Symbols.h"
 #include "llvm/ADT/CachedHashString.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/FlatHashMap.h"
 #include "llvm/Support/Compiler.h"
 
 namespace lld::elf {
@@ -45,6 +46,14 @@ public:
 
   Symbol *insert(StringRef name);
 
+  // Insert the global symbol names of multiple input files using multiple
+  // threads. names[i] holds the names of the i-th file in the order the files
+  // are going to be parsed, and the resulting symbols are written to syms[i].
+  // The symbols are added to the table in the same order as if the names were
+  // inserted one by one. Empty names are skipped.
+  void insertParallel(ArrayRef<SmallVector<llvm::CachedHashStringRef, 0>> names,
+                      ArrayRef<MutableArrayRef<Symbol *>> syms);
+
   template <typename T> Symbol *addSymbol(const T &newSym) {
     Symbol *sym = insert(newSym.getName());
     sym->resolve(ctx, newSym);
@@ -82,6 +91,7 @@ public:
   llvm::StringMap<bool> inCMSEOutImpLib;
 
 private:
+  Symbol *addNewSymbol(StringRef name);
   SmallVector<Symbol *, 0> findByVersion(SymbolVersion ver);
   SmallVector<Symbol *, 0> findAllByVersion(SymbolVersion ver,
                                             bool includeNonDefault);
@@ -97,7 +107,7 @@ private:
   // Global symbols and a map from symbol name to the index. The order is not
   // defined. We can use an arbitrary order, but it has to be deterministic even
   // when cross linking.
-  llvm::DenseMap<llvm::CachedHashStringRef, int> symMap;
+  llvm::FlatHashMap<llvm::CachedHashStringRef, int> symMap;
   SmallVector<Symbol *, 0> symVector;
 
   // A map from demangled symbol names to their symbol objects.
@@ -37,11 +37,14 @@
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/DebugInfo/DWARF/DWARFAcceleratorTable.h"
 #include "llvm/DebugInfo/DWARF/DWARFDebugPubTable.h"
+#include "llvm/Support/Caching.h"
 #include "llvm/Support/DJB.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/xxhash.h"
 #include <cinttypes>
 #include <cstdlib>
 
@@ -1701,6 +1704,24 @@ void RelocationBaseSection::mergeRels() {
   relocsVec.clear();
 }
 
+void RelocationBaseSection::sortScannedRels(
+    size_t begin, function_ref<uint32_t(const InputSectionBase *)> rank) {
+  auto less = [&](const DynamicReloc &a, const DynamicReloc &b) {
+    return rank(a.inputSec) < rank(b.inputSec);
+  };
+  std::stable_sort(relocs.begin() + begin, relocs.end(), less);
+
+  // Each scanning task appends to the vector of the thread it runs on, so the
+  // relocations of a task are contiguous and in order. Concatenate and sort.
+  SmallVector<DynamicReloc, 0> sharded;
+  for (SmallVector<DynamicReloc, 0> &v : relocsVec) {
+    llvm::append_range(sharded, v);
+    v.clear();
+  }
+  llvm::stable_sort(sharded, less);
+  relocsVec[0] = std::move(sharded);
+}
+
 void RelocationBaseSection::partitionRels() {
   if (!combreloc)
     return;
@@ -4011,17 +4032,112 @@ void MergeNoTailSection::finalizeContents() {
   });
 }
 
+// Sections smaller than this are split directly, because reading a cache
+// entry would not be faster than splitting them.
+static constexpr size_t minCachedMergeSectionSize = 16384;
+
+// A cache entry is an array of (inputOff, hash) pairs of little-endian 32-bit
+// integers. Returns false if the entry cannot be used for sec.
+static bool readCachedPieces(Ctx &ctx, MergeInputSection &sec,
+                             StringRef entry) {
+  size_t size = sec.contentMaybeDecompress().size();
+  size_t numPieces = entry.size() / 8;
+  if (numPieces == 0 || entry.size() % 8 != 0)
+    return false;
+
+  const bool live = !(sec.flags & SHF_ALLOC) || !ctx.arg.gcSections;
+  sec.pieces.resize_for_overwrite(numPieces);
+  auto *p = reinterpret_cast<const uint8_t *>(entry.data());
+  for (size_t i = 0; i != numPieces; ++i, p += 8) {
+    uint32_t off = read32le(p);
+    // The offsets must be strictly increasing and start at 0 so that getData
+    // stays within the section.
+    if (off >= size || (i == 0 ? off != 0 : off <= sec.pieces[i - 1].inputOff)) {
+      sec.pieces.clear();
+      return false;
+    }
+    sec.pieces[i] = {off, read32le(p + 4), live};
+  }
+  return true;
+}
+
+// With --merge-cache-dir, split large SHF_MERGE|SHF_STRINGS sections using
+// pieces cached by a previous link, keyed by the section contents. Cache misses
+// are split as usual and then added to the cache.
+static void splitSectionsWithCache(Ctx &ctx) {
+  SmallVector<MergeInputSection *, 0> sections;
+  for (ELFFileBase *file : ctx.objectFiles)
+    for (InputSectionBase *sec : file->getSections())
+      if (auto *s = dyn_cast_or_null<MergeInputSection>(sec))
+        if ((s->flags & SHF_STRINGS) &&
+            s->contentMaybeDecompress().size() >= minCachedMergeSectionSize)
+          sections.push_back(s);
+  if (sections.empty())
+    return;
+
+  SmallVector<std::unique_ptr<MemoryBuffer>, 0> entries(sections.size());
+  FileCache cache = check(localCache(
+      "merge", "Merge", ctx.arg.mergeCacheDir,
+      [&](size_t task, const Twine &, std::unique_ptr<MemoryBuffer> mb) {
+        entries[task] = std::move(mb);
+      }));
+
+  parallelFor(0, sections.size(), [&](size_t i) {
+    MergeInputSection &sec = *sections[i];
+    XXH128_hash_t h = xxh3_128bits(sec.contentMaybeDecompress());
+    std::string key = ("v1-" + Twine(sec.entsize) + "-" +
+                       utohexstr(h.high64, /*LowerCase=*/true, 16) +
+                       utohexstr(h.low64, /*LowerCase=*/true, 16))
+                          .str();
+    Expected<AddStreamFn> addStream = cache(i, key, sec.file->getName());
+    if (!addStream) {
+      Warn(ctx) << "--merge-cache-dir: " << addStream.takeError();
+      return;
+    }
+    if (!*addStream) {
+      if (readCachedPieces(ctx, sec, entries[i]->getBuffer()))
+        return;
+      Log(ctx) << "--merge-cache-dir: ignoring invalid cache entry " << key;
+    }
+
+    sec.splitIntoPieces();
+    if (!*addStream)
+      return;
+    Expected<std::unique_ptr<CachedFileStream>> os =
+        (*addStream)(i, sec.file->getName());
+    if (!os) {
+      Warn(ctx) << "--merge-cache-dir: " << os.takeError();
+      return;
+    }
+    // SectionPiece stores the hash shifted right by one. Store it shifted back
+    // so that the SectionPiece constructor restores the same value.
+    endian::Writer w(*(*os)->OS, llvm::endianness::little);
+    for (const SectionPiece &piece : sec.pieces) {
+      w.write<uint32_t>(piece.inputOff);
+      w.write<uint32_t>(uint32_t(piece.hash) << 1);
+    }
+  });
+  entries.clear();
+
+  pruneCache(ctx.arg.mergeCacheDir, ctx.arg.mergeCachePolicy);
+}
+
 template <class ELFT> void elf::splitSections(Ctx &ctx) {
   llvm::TimeTraceScope timeScope("Split sections");
+  if (!ctx.arg.mergeCacheDir.empty())
+    splitSectionsWithCache(ctx);
+
   // splitIntoPieces needs to be called on each MergeInputSection
   // before calling finalizeContents().
   parallelForEach(ctx.objectFiles, [](ELFFileBase *file) {
     for (InputSectionBase *sec : file->getSections()) {
       if (!sec)
         continue;
-      if (auto *s = dyn_cast<MergeInputSection>(sec))
-        s->splitIntoPieces();
-      else if (auto *eh = dyn_cast<EhInputSection>(sec))
+      if (auto *s = dyn_cast<MergeInputSection>(sec)) {
+        // The section may have been split by splitSectionsWithCache.
+        if (s->pieces.empty())
+          s->splitIntoPieces();
+      } else if (auto *eh = dyn_cast<EhInputSection>(sec))
         eh->split<ELFT>();
     }
   });
@@ -553,6 +553,11 @@ public:
   size_t getSize() const override { return relocs.size() * this->entsize; }
   size_t getRelativeRelocCount() const { return numRelativeRelocs; }
   void mergeRels();
+  // Stably sort relocs[begin:] and the relocations in relocsVec by the rank of
+  // their input sections. Used after parallel relocation scanning to restore
+  // the order of a serial scan.
+  void sortScannedRels(
+      size_t begin, llvm::function_ref<uint32_t(const InputSectionBase *)> rank);
   void partitionRels();
   void finalizeContents() override;
 
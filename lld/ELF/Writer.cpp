@@ -9,8 +9,10 @@
 #include "Writer.h"
 #include "AArch64ErrataFix.h"
 #include "ARMErrataFix.h"
+#include "BPSectionOrderer.h"
 #include "CallGraphSort.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "InputFiles.h"
 #include "LinkerScript.h"
 #include "MapFile.h"
@@ -361,7 +363,10 @@ template <class ELFT> void Writer<ELFT>::run() {
 
   {
     llvm::TimeTraceScope timeScope("Write output file");
-    // Write the result down to a file.
+    // Write the result down to a file. With --incremental, compare the layout
+    // with the previous link first, as openFile() removes the previous output.
+    if (ctx.incremental)
+      ctx.incremental->prepare(fileSize);
     openFile();
     if (errCount(ctx))
       return;
@@ -384,6 +389,8 @@ template <class ELFT> void Writer<ELFT>::run() {
     if (auto e = buffer->commit())
       Err(ctx) << "failed to write output '" << buffer->getPath()
                << "': " << std::move(e);
+    else if (ctx.incremental)
+      ctx.incremental->saveState();
 
     if (!ctx.arg.cmseOutputLib.empty())
       writeARMCmseImportLib<ELFT>(ctx);
@@ -1080,13 +1087,18 @@ static void maybeShuffle(Ctx &ctx,
   }
 }
 
-// Builds section order for handling --symbol-ordering-file.
+// Builds section order for handling --symbol-ordering-file and balanced
+// partitioning.
 static DenseMap<const InputSectionBase *, int> buildSectionOrder(Ctx &ctx) {
   DenseMap<const InputSectionBase *, int> sectionOrder;
   // Use the rarely used option --call-graph-ordering-file to sort sections.
   if (!ctx.arg.callGraphProfile.empty())
     return computeCallGraphProfileOrder(ctx);
 
+  if (ctx.arg.bpStartupFunctionSort || ctx.arg.bpFunctionOrderForCompression ||
+      ctx.arg.bpDataOrderForCompression)
+    sectionOrder = runBalancedPartitioning(ctx);
+
   if (ctx.arg.symbolOrderingFile.empty())
     return sectionOrder;
 
@@ -1097,9 +1109,11 @@ static DenseMap<const InputSectionBase *, int> buildSectionOrder(Ctx &ctx) {
 
   // Build a map from symbols to their priorities. Symbols that didn't
   // appear in the symbol ordering file have the lowest priority 0.
-  // All explicitly mentioned symbols have negative (higher) priorities.
+  // All explicitly mentioned symbols have negative (higher) priorities, which
+  // are lower than those assigned by balanced partitioning.
   DenseMap<CachedHashStringRef, SymbolOrderEntry> symbolOrder;
-  int priority = -ctx.arg.symbolOrderingFile.size();
+  int priority =
+      -int(sectionOrder.size() + ctx.arg.symbolOrderingFile.size());
   for (StringRef s : ctx.arg.symbolOrderingFile)
     symbolOrder.insert({CachedHashStringRef(s), {priority++, false}});
 
@@ -2927,7 +2941,29 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
       if (isStaticRelSecType(sec->type))
         sec->writeTo<ELFT>(ctx, ctx.bufferStart + sec->offset, tg);
   }
-  {
+  if (ctx.arg.streamOutput) {
+    // The contents of SHF_ALLOC sections are final once written, except for
+    // .note.gnu.build-id which is backfilled later. Write them first and let
+    // the OS write their pages back while non-SHF_ALLOC sections, such as
+    // .symtab, .strtab and .debug_*, are being written. This reduces the peak
+    // resident memory for large outputs.
+    {
+      parallel::TaskGroup tg;
+      for (OutputSection *sec : ctx.outputSections)
+        if (!isStaticRelSecType(sec->type) && (sec->flags & SHF_ALLOC))
+          sec->writeTo<ELFT>(ctx, ctx.bufferStart + sec->offset, tg);
+    }
+    for (OutputSection *sec : ctx.outputSections)
+      if (!isStaticRelSecType(sec->type) && (sec->flags & SHF_ALLOC) &&
+          sec->type != SHT_NOBITS)
+        buffer->releaseRange(sec->offset, sec->size);
+    {
+      parallel::TaskGroup tg;
+      for (OutputSection *sec : ctx.outputSections)
+        if (!isStaticRelSecType(sec->type) && !(sec->flags & SHF_ALLOC))
+          sec->writeTo<ELFT>(ctx, ctx.bufferStart + sec->offset, tg);
+    }
+  } else {
     parallel::TaskGroup tg;
     for (OutputSection *sec : ctx.outputSections)
       if (!isStaticRelSecType(sec->type))
@@ -41,6 +41,7 @@
 #include "lld/Common/Memory.h"
 #include "llvm/BinaryFormat/MachO.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/Parallel.h"
 #include <optional>
 
 using namespace llvm;
@@ -189,17 +190,40 @@ void TrieNode::writeTo(uint8_t *buf) const {
   }
 }
 
+namespace {
+// A subtree whose construction has been deferred so that it can be built
+// concurrently with the others. Its nodes and the edges it adds to its parent
+// are later spliced in at the positions where the serial algorithm would have
+// created them, so the output does not depend on the number of threads.
+struct DeferredSubtree {
+  MutableArrayRef<const Symbol *> vec;
+  TrieNode *node;
+  size_t lastPos;
+  size_t pos;
+  size_t nodeIdx;
+  size_t edgeIdx;
+  std::vector<TrieNode *> nodes;
+  std::vector<Edge> edges;
+};
+
+struct TrieSorter {
+  void sortAndBuild(MutableArrayRef<const Symbol *> vec, TrieNode *node,
+                    std::vector<Edge> *edges, std::vector<TrieNode *> &nodes,
+                    size_t lastPos, size_t pos);
+
+  uint64_t imageBase;
+  // If non-null, subtrees containing at most `grain` symbols are not built
+  // but appended to this vector.
+  std::vector<DeferredSubtree> *deferred = nullptr;
+  size_t grain = 0;
+};
+} // namespace
+
 TrieBuilder::~TrieBuilder() {
   for (TrieNode *node : nodes)
     delete node;
 }
 
-TrieNode *TrieBuilder::makeNode() {
-  auto *node = new TrieNode();
-  nodes.emplace_back(node);
-  return node;
-}
-
 static int charAt(const Symbol *sym, size_t pos) {
   StringRef str = sym->getName();
   if (pos >= str.size())
@@ -214,16 +238,26 @@ static int charAt(const Symbol *sym, size_t pos) {
 //
 // node:    The most recently created node along this path in the trie (i.e.
 //          the furthest from the root.)
+// edges:   Where to add the outgoing edges of node.
+// nodes:   Where to add the newly created nodes.
 // lastPos: The prefix length of the most recently created node, i.e. the number
 //          of characters along its path from the root.
 // pos:     The string index we are currently sorting on. Note that each symbol
 //          S contained in vec has the same prefix S[0...pos).
-void TrieBuilder::sortAndBuild(MutableArrayRef<const Symbol *> vec,
-                               TrieNode *node, size_t lastPos, size_t pos) {
+void TrieSorter::sortAndBuild(MutableArrayRef<const Symbol *> vec,
+                              TrieNode *node, std::vector<Edge> *edges,
+                              std::vector<TrieNode *> &nodes, size_t lastPos,
+                              size_t pos) {
 tailcall:
   if (vec.empty())
     return;
 
+  if (deferred && vec.size() <= grain) {
+    deferred->push_back(
+        {vec, node, lastPos, pos, nodes.size(), edges->size(), {}, {}});
+    return;
+  }
+
   // Partition items so that items in [0, i) are less than the pivot,
   // [i, j) are the same as the pivot, and [j, vec.size()) are greater than
   // the pivot.
@@ -244,22 +278,23 @@ tailcall:
   bool isTerminal = pivot == -1;
   bool prefixesDiverge = i != 0 || j != vec.size();
   if (lastPos != pos && (isTerminal || prefixesDiverge)) {
-    TrieNode *newNode = makeNode();
-    node->edges.emplace_back(pivotSymbol->getName().slice(lastPos, pos),
-                             newNode);
+    TrieNode *newNode = new TrieNode();
+    nodes.push_back(newNode);
+    edges->emplace_back(pivotSymbol->getName().slice(lastPos, pos), newNode);
     node = newNode;
+    edges = &newNode->edges;
     lastPos = pos;
   }
 
-  sortAndBuild(vec.slice(0, i), node, lastPos, pos);
-  sortAndBuild(vec.slice(j), node, lastPos, pos);
+  sortAndBuild(vec.slice(0, i), node, edges, nodes, lastPos, pos);
+  sortAndBuild(vec.slice(j), node, edges, nodes, lastPos, pos);
 
   if (isTerminal) {
     assert(j - i == 1); // no duplicate symbols
     node->info = ExportInfo(*pivotSymbol, imageBase);
   } else {
     // This is the tail-call-optimized version of the following:
-    // sortAndBuild(vec.slice(i, j - i), node, lastPos, pos + 1);
+    // sortAndBuild(vec.slice(i, j - i), node, edges, nodes, lastPos, pos + 1);
     vec = vec.slice(i, j - i);
     ++pos;
     goto tailcall;
@@ -270,8 +305,41 @@ size_t TrieBuilder::build() {
   if (exported.empty())
     return 0;
 
-  TrieNode *root = makeNode();
-  sortAndBuild(exported, root, 0, 0);
+  TrieNode *root = new TrieNode();
+  nodes.push_back(root);
+
+  // With many exported symbols, first split the symbols into subtrees, then
+  // build the subtrees in parallel.
+  TrieSorter sorter{imageBase};
+  std::vector<DeferredSubtree> deferred;
+  if (parallel::strategy.ThreadsRequested != 1 && exported.size() > 4096) {
+    sorter.deferred = &deferred;
+    sorter.grain = std::max<size_t>(exported.size() / 256, 1024);
+  }
+  sorter.sortAndBuild(exported, root, &root->edges, nodes, 0, 0);
+
+  if (!deferred.empty()) {
+    sorter.deferred = nullptr;
+    parallelForEach(deferred, [&](DeferredSubtree &d) {
+      sorter.sortAndBuild(d.vec, d.node, &d.edges, d.nodes, d.lastPos, d.pos);
+    });
+
+    std::vector<TrieNode *> allNodes;
+    size_t prev = 0;
+    for (DeferredSubtree &d : deferred) {
+      allNodes.insert(allNodes.end(), nodes.begin() + prev,
+                      nodes.begin() + d.nodeIdx);
+      append_range(allNodes, d.nodes);
+      prev = d.nodeIdx;
+    }
+    allNodes.insert(allNodes.end(), nodes.begin() + prev, nodes.end());
+    nodes = std::move(allNodes);
+
+    // Insert in reverse order so that the recorded indices stay valid.
+    for (DeferredSubtree &d : llvm::reverse(deferred))
+      d.node->edges.insert(d.node->edges.begin() + d.edgeIdx, d.edges.begin(),
+                           d.edges.end());
+  }
 
   // Assign each node in the vector an offset in the trie stream, iterating
   // until all uleb128 sizes have stabilized.
@@ -29,10 +29,6 @@ public:
   void writeTo(uint8_t *buf) const;
 
 private:
-  TrieNode *makeNode();
-  void sortAndBuild(llvm::MutableArrayRef<const Symbol *> vec, TrieNode *node,
-                    size_t lastPos, size_t pos);
-
   uint64_t imageBase = 0;
   std::vector<const Symbol *> exported;
   std::vector<TrieNode *> nodes;
@@ -13,7 +13,7 @@
 
 #include "lld/Common/LLVM.h"
 #include "llvm/ADT/CachedHashString.h"
-#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/FlatHashMap.h"
 #include "llvm/Object/Archive.h"
 
 namespace lld::macho {
@@ -66,7 +66,7 @@ public:
 
 private:
   std::pair<Symbol *, bool> insert(StringRef name, const InputFile *);
-  llvm::DenseMap<llvm::CachedHashStringRef, int> symMap;
+  llvm::FlatHashMap<llvm::CachedHashStringRef, int> symMap;
   std::vector<Symbol *> symVector;
 };
 
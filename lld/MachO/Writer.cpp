@@ -1139,13 +1139,17 @@ void Writer::finalizeAddresses() {
 
 void Writer::finalizeLinkEditSegment() {
   TimeTraceScope timeScope("Finalize __LINKEDIT segment");
-  // Fill __LINKEDIT contents.
-  std::array<LinkEditSection *, 10> linkEditSections{
+  // Fill __LINKEDIT contents. The export trie is usually the largest of them
+  // and is built using all threads, so build it before the others, which are
+  // then finalized concurrently.
+  if (in.exports)
+    in.exports->finalizeContents();
+  std::array<LinkEditSection *, 9> linkEditSections{
       in.rebase,         in.binding,
       in.weakBinding,    in.lazyBinding,
-      in.exports,        in.chainedFixups,
-      symtabSection,     indirectSymtabSection,
-      dataInCodeSection, functionStartsSection,
+      in.chainedFixups,  symtabSection,
+      dataInCodeSection, indirectSymtabSection,
+      functionStartsSection,
   };
 
   parallelForEach(linkEditSections.begin(), linkEditSections.end(),
@@ -51,10 +51,16 @@ void CodeSection::finalizeContents() {
   writeUleb128(os, functions.size(), "function count");
   bodySize = codeSectionHeader.size();
 
-  for (InputFunction *func : functions) {
+  // Computing the size of a function with compressed relocations needs to
+  // decode its relocations, so do it in parallel. The widths of the compressed
+  // relocations do not depend on the offsets of functions.
+  parallelForEach(functions, [&](InputFunction *func) {
     func->outputSec = this;
-    func->outSecOff = bodySize;
     func->calculateSize();
+  });
+
+  for (InputFunction *func : functions) {
+    func->outSecOff = bodySize;
     // All functions should have a non-empty body at this point
     assert(func->getSize());
     bodySize += func->getSize();
@@ -78,8 +84,8 @@ void CodeSection::writeTo(uint8_t *buf) {
   memcpy(buf, codeSectionHeader.data(), codeSectionHeader.size());
 
   // Write code section bodies
-  for (const InputChunk *chunk : functions)
-    chunk->writeTo(buf);
+  parallelForEach(functions,
+                  [&](const InputChunk *chunk) { chunk->writeTo(buf); });
 }
 
 uint32_t CodeSection::getNumRelocations() const {
@@ -224,10 +224,17 @@ void Writer::writeHeader() {
 
 void Writer::writeSections() {
   uint8_t *buf = buffer->getBufferStart();
+  // The code section is usually the largest one. It writes its functions in
+  // parallel, which only works outside of another parallel loop, so write it
+  // after the others.
   parallelForEach(outputSections, [buf](OutputSection *s) {
     assert(s->isNeeded());
-    s->writeTo(buf);
+    if (!isa<CodeSection>(s))
+      s->writeTo(buf);
   });
+  for (OutputSection *s : outputSections)
+    if (isa<CodeSection>(s))
+      s->writeTo(buf);
 }
 
 // Computes a hash value of Data using a given hash function.
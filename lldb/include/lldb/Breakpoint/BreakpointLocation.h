@@ -14,6 +14,7 @@
 #include <optional>
 
 #include "lldb/Breakpoint/BreakpointOptions.h"
+#include "lldb/Breakpoint/SimpleCondition.h"
 #include "lldb/Breakpoint/StoppointHitCounter.h"
 #include "lldb/Core/Address.h"
 #include "lldb/Symbol/LineEntry.h"
@@ -397,6 +398,12 @@ private:
                                 /// multiple processes.
   size_t m_condition_hash; ///< For testing whether the condition source code
                            ///changed.
+  std::unique_ptr<SimpleCondition>
+      m_simple_condition_up; ///< The condition, if it can be evaluated without
+                             /// the expression parser.
+  std::optional<size_t> m_simple_condition_hash; ///< The hash of the condition
+                                                 /// m_simple_condition_up was
+                                                 /// parsed from.
   lldb::break_id_t m_loc_id; ///< Breakpoint location ID.
   StoppointHitCounter m_hit_counter; ///< Number of times this breakpoint
                                      /// location has been hit.
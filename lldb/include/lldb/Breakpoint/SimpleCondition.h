@@ -0,0 +1,54 @@
+//===-- SimpleCondition.h ---------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLDB_BREAKPOINT_SIMPLECONDITION_H
+#define LLDB_BREAKPOINT_SIMPLECONDITION_H
+
+#include "lldb/lldb-private.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <memory>
+#include <optional>
+
+namespace lldb_private {
+
+/// \class SimpleCondition SimpleCondition.h "lldb/Breakpoint/SimpleCondition.h"
+/// A C family breakpoint condition which only compares variables and integer
+/// constants, e.g. "i == 5 && (p->count > 10 || !done)".
+///
+/// These conditions are parsed once, and then evaluated directly against the
+/// variables of the stopped frame, like "frame variable" does. This is much
+/// cheaper than going through the expression parser on every hit.
+///
+/// The variable paths are the ones "frame variable" understands: member
+/// accesses, array subscripts with a constant index and the implicit members
+/// of "this". The comparisons follow the usual arithmetic conversions of C.
+class SimpleCondition {
+public:
+  /// Parse \a text, or return nullptr if it isn't a simple condition.
+  static std::unique_ptr<SimpleCondition> Parse(llvm::StringRef text);
+
+  ~SimpleCondition();
+
+  /// Evaluate the condition in \a frame. Return std::nullopt if it can't be
+  /// evaluated the way the expression parser would, e.g. because a variable
+  /// is missing or isn't an integer or a pointer. The caller should then use
+  /// the expression parser instead.
+  std::optional<bool> Evaluate(StackFrame &frame) const;
+
+  struct Node;
+
+private:
+  SimpleCondition(std::unique_ptr<Node> root);
+
+  std::unique_ptr<Node> m_root;
+};
+
+} // namespace lldb_private
+
+#endif // LLDB_BREAKPOINT_SIMPLECONDITION_H
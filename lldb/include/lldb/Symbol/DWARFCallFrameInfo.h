@@ -128,6 +128,21 @@ private:
 
   void GetFDEIndex();
 
+  /// Read the binary search table of the .eh_frame_hdr section, if there is
+  /// one describing this eh_frame. Returns true if the table can be used.
+  bool GetEHFrameHdrTable();
+
+  /// Find the first FDE which contains or follows \p start_addr with the
+  /// .eh_frame_hdr table, and return it if it intersects the range which
+  /// starts there. This avoids indexing the whole section, which is slow for
+  /// large binaries of which only a few functions get unwound.
+  std::optional<FDEEntryMap::Entry>
+  FindFDEInEHFrameHdr(lldb::addr_t start_addr, lldb::addr_t size);
+
+  /// Decode the address range of the FDE at \p fde_offset, parsing its CIE
+  /// if it wasn't seen yet.
+  std::optional<FDEEntryMap::Entry> ParseFDEEntry(dw_offset_t fde_offset);
+
   bool FDEToUnwindPlan(dw_offset_t offset, Address startaddr,
                        UnwindPlan &unwind_plan);
 
@@ -156,6 +171,14 @@ private:
   bool m_fde_index_initialized = false; // only scan the section for FDEs once
   std::mutex m_fde_index_mutex; // and isolate the thread that does it
 
+  // The sorted (initial location, FDE address) table of .eh_frame_hdr.
+  DataExtractor m_eh_frame_hdr_data;
+  lldb::addr_t m_eh_frame_hdr_addr = LLDB_INVALID_ADDRESS;
+  lldb::offset_t m_eh_frame_hdr_table_offset = 0;
+  uint32_t m_eh_frame_hdr_fde_count = 0;
+  bool m_eh_frame_hdr_valid = false;
+  std::once_flag m_eh_frame_hdr_once;
+
   Type m_type;
 
   CIESP
@@ -15,6 +15,7 @@
 #include "lldb/lldb-private.h"
 #include <map>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 namespace lldb_private {
@@ -342,10 +343,23 @@ private:
   void SymbolIndicesToSymbolContextList(std::vector<uint32_t> &symbol_indexes,
                                         SymbolContextList &sc_list);
 
+  /// The parts of a mangled function name that go into the name indexes.
+  struct MangledNameParts {
+    ConstString base_name;
+    ConstString decl_context;
+    bool is_ctor_or_dtor = false;
+  };
+
+  /// Parse the mangled name of \a symbol if it is a function name that goes
+  /// into the base name and method indexes. The base name is empty if the
+  /// name parsed but should not be indexed.
+  static std::optional<MangledNameParts>
+  ParseMangledName(Symbol &symbol, RichManglingContext &rmc);
+
   void RegisterMangledNameEntry(
       uint32_t value, std::set<const char *> &class_contexts,
       std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-      RichManglingContext &rmc);
+      const MangledNameParts &parts);
 
   void RegisterBacklogEntry(const NameToIndexMap::Entry &entry,
                             const char *decl_context,
@@ -11,6 +11,7 @@
 
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/lldb-private.h"
+#include <list>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -27,10 +28,19 @@ public:
 
   void Clear(bool clear_invalid_ranges = false);
 
+  /// Drop the cached memory which may have changed while the process ran.
+  /// This is everything unless the "memory-cache-keep-read-only" setting is
+  /// on, in which case the lines read from read-only sections are kept.
+  void ClearVolatileData();
+
   void Flush(lldb::addr_t addr, size_t size);
 
   size_t Read(lldb::addr_t addr, void *dst, size_t dst_len, Status &error);
 
+  /// Read the parts of \a ranges which aren't cached yet with a single call
+  /// to Process::ReadMemoryRangesFromInferior, and cache them.
+  void Prefetch(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges);
+
   uint32_t GetMemoryCacheLineSize() const { return m_L2_cache_line_byte_size; }
 
   void AddInvalidRange(lldb::addr_t base_addr, lldb::addr_t byte_size);
@@ -45,6 +55,16 @@ public:
 
 protected:
   typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
+  struct L2CacheLine {
+    lldb::DataBufferSP data_sp;
+    /// The position of the line in m_L2_lru.
+    std::list<lldb::addr_t>::iterator lru_pos;
+    /// The read-only section the line was read from and the load address of
+    /// that section at the time, if the line can be kept across stops.
+    lldb::SectionWP section_wp;
+    lldb::addr_t section_load_addr = LLDB_INVALID_ADDRESS;
+  };
+  typedef std::map<lldb::addr_t, L2CacheLine> L2BlockMap;
   typedef RangeVector<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
   typedef Range<lldb::addr_t, lldb::addr_t> AddrRange;
   // Classes that inherit from MemoryCache can see and modify these
@@ -52,17 +72,43 @@ protected:
   BlockMap m_L1_cache; // A first level memory cache whose chunk sizes vary that
                        // will be used only if the memory read fits entirely in
                        // a chunk
-  BlockMap m_L2_cache; // A memory cache of fixed size chinks
-                       // (m_L2_cache_line_byte_size bytes in size each)
+  L2BlockMap m_L2_cache; // A memory cache of fixed size chinks
+                         // (m_L2_cache_line_byte_size bytes in size each)
+  std::list<lldb::addr_t> m_L2_lru; // The addresses of the L2 cache lines,
+                                    // most recently used first
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  uint64_t m_L2_max_lines = 0;
+  uint64_t m_max_read_ahead_lines = 1;
+  bool m_keep_read_only_lines = false;
+  // The number of lines read by the next L2 cache miss, if it follows the
+  // previous one.
+  uint64_t m_read_ahead_lines = 1;
+  lldb::addr_t m_next_sequential_line = LLDB_INVALID_ADDRESS;
 
 private:
   MemoryCache(const MemoryCache &) = delete;
   const MemoryCache &operator=(const MemoryCache &) = delete;
 
   lldb::DataBufferSP GetL2CacheLine(lldb::addr_t addr, Status &error);
+
+  void UpdateSettings();
+
+  /// Cache \a data_sp as the L2 cache line at \a line_base_addr, making it the
+  /// most recently used one, and evict the least recently used lines if there
+  /// are too many.
+  void InsertL2CacheLine(lldb::addr_t line_base_addr,
+                         const lldb::DataBufferSP &data_sp);
+
+  L2BlockMap::iterator EraseL2CacheLine(L2BlockMap::iterator pos);
+
+  /// Record the read-only section which contains all of \a line, if any.
+  void FindReadOnlySection(lldb::addr_t line_base_addr, L2CacheLine &line);
+
+  /// Return true if \a line was read from a read-only section which is still
+  /// loaded at the same address.
+  bool IsReadOnlySectionStillLoaded(const L2CacheLine &line);
 };
 
     
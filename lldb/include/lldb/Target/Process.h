@@ -84,6 +84,9 @@ public:
 
   bool GetDisableMemoryCache() const;
   uint64_t GetMemoryCacheLineSize() const;
+  uint64_t GetMemoryCacheMaxLines() const;
+  uint64_t GetMemoryCacheReadAhead() const;
+  bool GetMemoryCacheKeepReadOnly() const;
   Args GetExtraStartupCommands() const;
   void SetExtraStartupCommands(const Args &args);
   FileSpec GetPythonOSPluginPath() const;
@@ -1577,6 +1580,33 @@ public:
   size_t ReadMemoryFromInferior(lldb::addr_t vm_addr, void *buf, size_t size,
                                 Status &error);
 
+  /// Read several ranges of memory from a process at once.
+  ///
+  /// This bypasses caching like ReadMemoryFromInferior, but lets the process
+  /// plugin read all the ranges with as few round trips as it can.
+  ///
+  /// \param[in] ranges
+  ///     The ranges of virtual load addresses to read.
+  ///
+  /// \param[out] buf
+  ///     A byte buffer large enough for all of \a ranges. The bytes of
+  ///     each range are stored right after the bytes of the previous one.
+  ///
+  /// \return
+  ///     The number of bytes that were actually read for each range, which
+  ///     is less than its size if only part of it could be read.
+  std::vector<size_t> ReadMemoryRangesFromInferior(
+      llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges, uint8_t *buf);
+
+  /// Bring the memory of \a ranges into the memory cache.
+  ///
+  /// Clients about to read many small, scattered pieces of memory, like the
+  /// unwinder or data formatters walking a data structure, can call this so
+  /// that the ReadMemory calls that follow are served from the cache rather
+  /// than each needing a round trip to the process. Does nothing if the
+  /// memory cache is disabled.
+  void PrefetchMemory(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges);
+
   /// Read a NULL terminated C string from memory
   ///
   /// This function will read a cache page at a time until the NULL
@@ -2791,6 +2821,17 @@ protected:
   virtual size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                               Status &error) = 0;
 
+  /// Actually do the reading of several ranges of memory from a process.
+  ///
+  /// The default implementation reads each range with DoReadMemory.
+  /// Subclasses which can read several ranges in one round trip should
+  /// override this function. Addresses were already fixed by the ABI.
+  ///
+  /// \see ReadMemoryRangesFromInferior
+  virtual std::vector<size_t>
+  DoReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                     uint8_t *buf);
+
   virtual void DoFindInMemory(lldb::addr_t start_addr, lldb::addr_t end_addr,
                               const uint8_t *buf, size_t size,
                               AddressRanges &matches, size_t alignment,
@@ -99,6 +99,10 @@ public:
 
   void SetPreloadSymbols(bool b);
 
+  bool GetParallelModuleLoad() const;
+
+  void SetParallelModuleLoad(bool b);
+
   bool GetDisableASLR() const;
 
   void SetDisableASLR(bool b);
@@ -175,6 +179,8 @@ public:
 
   bool GetEnableNotifyAboutFixIts() const;
 
+  bool GetFastBreakpointConditions() const;
+
   FileSpec GetSaveJITObjectsDir() const;
 
   bool GetEnableSyntheticValue() const;
@@ -17,6 +17,7 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/TypeSystem.h"
+#include "lldb/Target/Language.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
@@ -239,6 +240,26 @@ bool BreakpointLocation::ConditionSaysStop(ExecutionContext &exe_ctx,
 
   error.Clear();
 
+  // Conditions which only compare variables and constants are evaluated
+  // without the expression parser, which is much cheaper. They still go
+  // through it whenever they can't be evaluated directly.
+  if (m_simple_condition_hash != condition_hash) {
+    m_simple_condition_up.reset();
+    CompileUnit *comp_unit = m_address.CalculateSymbolContextCompileUnit();
+    if (comp_unit && Language::LanguageIsCFamily(comp_unit->GetLanguage()))
+      m_simple_condition_up = SimpleCondition::Parse(condition_text);
+    m_simple_condition_hash = condition_hash;
+  }
+  StackFrame *frame = exe_ctx.GetFramePtr();
+  if (m_simple_condition_up && frame &&
+      GetTarget().GetFastBreakpointConditions()) {
+    if (std::optional<bool> result = m_simple_condition_up->Evaluate(*frame)) {
+      LLDB_LOGF(log, "Simple condition evaluated, result is %s.",
+                *result ? "true" : "false");
+      return *result;
+    }
+  }
+
   DiagnosticManager diagnostics;
 
   if (condition_hash != m_condition_hash || !m_user_expression_sp ||
@@ -0,0 +1,505 @@
+//===-- SimpleCondition.cpp -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Breakpoint/SimpleCondition.h"
+#include "lldb/Symbol/CompilerType.h"
+#include "lldb/Target/StackFrame.h"
+#include "lldb/Utility/Status.h"
+#include "lldb/ValueObject/ValueObject.h"
+#include "llvm/ADT/APSInt.h"
+#include "llvm/ADT/StringExtras.h"
+
+#include <string>
+
+using namespace lldb;
+using namespace lldb_private;
+
+struct SimpleCondition::Node {
+  enum class Kind { Constant, Variable, Not, And, Or, Compare };
+  enum class CompareOp { EQ, NE, LT, LE, GT, GE };
+
+  Kind kind;
+  /// The value of a constant, with the type C gives to it.
+  llvm::APSInt constant;
+  /// Whether the constant is nullptr.
+  bool is_nullptr = false;
+  /// The path of a variable, as "frame variable" expects it.
+  std::string path;
+  CompareOp op = CompareOp::EQ;
+  std::unique_ptr<Node> lhs;
+  std::unique_ptr<Node> rhs;
+
+  Node(Kind kind) : kind(kind) {}
+};
+
+typedef SimpleCondition::Node Node;
+
+namespace {
+/// A recursive descent parser for:
+///
+///   condition  := and ('||' and)*
+///   and        := comparison ('&&' comparison)*
+///   comparison := unary (('=='|'!='|'<'|'<='|'>'|'>=') unary)?
+///   unary      := '!' unary | '(' condition ')' | '-'? literal | path
+///   path       := identifier ('.' identifier | '->' identifier |
+///                             '[' decimal ']')*
+///
+/// Anything else, and in particular anything with side effects, is rejected.
+class Parser {
+public:
+  Parser(llvm::StringRef text) : m_text(text) {}
+
+  std::unique_ptr<Node> ParseCondition() {
+    std::unique_ptr<Node> node = ParseOr();
+    SkipSpaces();
+    if (!m_text.empty())
+      return nullptr;
+    return node;
+  }
+
+private:
+  void SkipSpaces() { m_text = m_text.ltrim(); }
+
+  bool Consume(llvm::StringRef token) {
+    SkipSpaces();
+    return m_text.consume_front(token);
+  }
+
+  static std::unique_ptr<Node> MakeBinary(Node::Kind kind,
+                                          std::unique_ptr<Node> lhs,
+                                          std::unique_ptr<Node> rhs) {
+    auto node = std::make_unique<Node>(kind);
+    node->lhs = std::move(lhs);
+    node->rhs = std::move(rhs);
+    return node;
+  }
+
+  std::unique_ptr<Node> ParseOr() {
+    std::unique_ptr<Node> node = ParseAnd();
+    while (node && Consume("||")) {
+      std::unique_ptr<Node> rhs = ParseAnd();
+      if (!rhs)
+        return nullptr;
+      node = MakeBinary(Node::Kind::Or, std::move(node), std::move(rhs));
+    }
+    return node;
+  }
+
+  std::unique_ptr<Node> ParseAnd() {
+    std::unique_ptr<Node> node = ParseComparison();
+    while (node && Consume("&&")) {
+      std::unique_ptr<Node> rhs = ParseComparison();
+      if (!rhs)
+        return nullptr;
+      node = MakeBinary(Node::Kind::And, std::move(node), std::move(rhs));
+    }
+    return node;
+  }
+
+  std::unique_ptr<Node> ParseComparison() {
+    std::unique_ptr<Node> node = ParseUnary();
+    if (!node)
+      return nullptr;
+
+    Node::CompareOp op;
+    if (Consume("=="))
+      op = Node::CompareOp::EQ;
+    else if (Consume("!="))
+      op = Node::CompareOp::NE;
+    else if (Consume("<="))
+      op = Node::CompareOp::LE;
+    else if (Consume(">="))
+      op = Node::CompareOp::GE;
+    else if (Consume("<"))
+      op = Node::CompareOp::LT;
+    else if (Consume(">"))
+      op = Node::CompareOp::GT;
+    else
+      return node;
+
+    std::unique_ptr<Node> rhs = ParseUnary();
+    if (!rhs)
+      return nullptr;
+    node = MakeBinary(Node::Kind::Compare, std::move(node), std::move(rhs));
+    node->op = op;
+    return node;
+  }
+
+  std::unique_ptr<Node> ParseUnary() {
+    if (Consume("!")) {
+      std::unique_ptr<Node> operand = ParseUnary();
+      if (!operand)
+        return nullptr;
+      auto node = std::make_unique<Node>(Node::Kind::Not);
+      node->lhs = std::move(operand);
+      return node;
+    }
+    if (Consume("(")) {
+      std::unique_ptr<Node> node = ParseOr();
+      if (!node || !Consume(")"))
+        return nullptr;
+      return node;
+    }
+    if (Consume("-")) {
+      std::unique_ptr<Node> node = ParseLiteral();
+      if (!node || node->is_nullptr)
+        return nullptr;
+      node->constant = -node->constant;
+      return node;
+    }
+    SkipSpaces();
+    if (m_text.empty())
+      return nullptr;
+    if (llvm::isDigit(m_text.front()) || m_text.front() == '\'')
+      return ParseLiteral();
+    return ParsePath();
+  }
+
+  static llvm::APSInt MakeInt(bool value) {
+    return llvm::APSInt(llvm::APInt(32, value), /*isUnsigned=*/false);
+  }
+
+  /// Give \a value the type of an integer literal, assuming an LP64 or LLP64
+  /// model where long long is 64 bits wide.
+  static llvm::APSInt MakeLiteral(const llvm::APInt &value, bool is_decimal,
+                                  bool is_unsigned, bool is_long) {
+    const unsigned active_bits = value.getActiveBits();
+    unsigned width = 64;
+    bool is_signed = false;
+    if (!is_long && !is_unsigned && active_bits < 32)
+      width = 32, is_signed = true;
+    else if (!is_long && (is_unsigned || !is_decimal) && active_bits <= 32)
+      width = 32;
+    else if (!is_unsigned && active_bits < 64)
+      is_signed = true;
+    return llvm::APSInt(value.zextOrTrunc(width), !is_signed);
+  }
+
+  std::unique_ptr<Node> ParseLiteral() {
+    SkipSpaces();
+    auto node = std::make_unique<Node>(Node::Kind::Constant);
+    if (m_text.consume_front("'")) {
+      if (m_text.empty())
+        return nullptr;
+      char c = m_text.front();
+      m_text = m_text.drop_front();
+      if (c == '\\') {
+        if (m_text.empty())
+          return nullptr;
+        switch (m_text.front()) {
+        case 'n':
+          c = '\n';
+          break;
+        case 't':
+          c = '\t';
+          break;
+        case 'r':
+          c = '\r';
+          break;
+        case '0':
+          c = '\0';
+          break;
+        case '\\':
+        case '\'':
+        case '"':
+          c = m_text.front();
+          break;
+        default:
+          return nullptr;
+        }
+        m_text = m_text.drop_front();
+      } else if (c < 0x20 || c > 0x7e || c == '\'') {
+        return nullptr;
+      }
+      if (!m_text.consume_front("'"))
+        return nullptr;
+      node->constant = llvm::APSInt(llvm::APInt(32, c), /*isUnsigned=*/false);
+      return node;
+    }
+
+    llvm::StringRef token = m_text.take_while(llvm::isAlnum);
+    m_text = m_text.drop_front(token.size());
+    llvm::StringRef digits = token.rtrim("uUlL");
+    llvm::StringRef suffix = token.drop_front(digits.size());
+    const size_t num_unsigned = suffix.count('u') + suffix.count('U');
+    const size_t num_long = suffix.size() - num_unsigned;
+    if (num_unsigned > 1 || num_long > 2)
+      return nullptr;
+
+    unsigned radix = 10;
+    if (digits.consume_front_insensitive("0x"))
+      radix = 16;
+    else if (digits.size() > 1 && digits.front() == '0')
+      radix = 8;
+    llvm::APInt value;
+    if (digits.empty() || digits.getAsInteger(radix, value) ||
+        value.getActiveBits() > 64)
+      return nullptr;
+    node->constant =
+        MakeLiteral(value, radix == 10, num_unsigned != 0, num_long != 0);
+    return node;
+  }
+
+  static bool IsIdentifierStart(char c) {
+    return llvm::isAlpha(c) || c == '_' || c == '$';
+  }
+
+  static bool IsIdentifierChar(char c) {
+    return llvm::isAlnum(c) || c == '_' || c == '$';
+  }
+
+  bool ConsumeIdentifier(std::string &path) {
+    SkipSpaces();
+    if (m_text.empty() || !IsIdentifierStart(m_text.front()))
+      return false;
+    llvm::StringRef identifier = m_text.take_while(IsIdentifierChar);
+    m_text = m_text.drop_front(identifier.size());
+    path += identifier;
+    return true;
+  }
+
+  std::unique_ptr<Node> ParsePath() {
+    std::string path;
+    if (!ConsumeIdentifier(path))
+      return nullptr;
+
+    if (path == "true" || path == "false" || path == "nullptr") {
+      auto node = std::make_unique<Node>(Node::Kind::Constant);
+      node->constant = MakeInt(path == "true");
+      node->is_nullptr = path == "nullptr";
+      return node;
+    }
+
+    for (;;) {
+      if (Consume("->")) {
+        path += "->";
+      } else if (Consume(".")) {
+        path += ".";
+      } else if (Consume("[")) {
+        SkipSpaces();
+        llvm::StringRef index = m_text.take_while(llvm::isDigit);
+        m_text = m_text.drop_front(index.size());
+        if (index.empty() || !Consume("]"))
+          return nullptr;
+        path += "[";
+        path += index;
+        path += "]";
+        continue;
+      } else {
+        break;
+      }
+      if (!ConsumeIdentifier(path))
+        return nullptr;
+    }
+
+    auto node = std::make_unique<Node>(Node::Kind::Variable);
+    node->path = std::move(path);
+    return node;
+  }
+
+  llvm::StringRef m_text;
+};
+
+/// The value of an operand of a comparison.
+struct Operand {
+  llvm::APSInt value;
+  bool is_pointer = false;
+  /// Whether this is a null pointer constant, i.e. a literal zero.
+  bool is_null_pointer_constant = false;
+};
+} // namespace
+
+static std::optional<bool> EvaluateTruth(const Node &node, StackFrame &frame);
+
+static std::optional<Operand> ReadVariable(llvm::StringRef path,
+                                           StackFrame &frame) {
+  const uint32_t options =
+      StackFrame::eExpressionPathOptionCheckPtrVsMember |
+      StackFrame::eExpressionPathOptionsNoSyntheticChildren |
+      StackFrame::eExpressionPathOptionsAllowDirectIVarAccess |
+      StackFrame::eExpressionPathOptionsInspectAnonymousUnions;
+  VariableSP var_sp;
+  Status error;
+  ValueObjectSP valobj_sp = frame.GetValueForVariableExpressionPath(
+      path, eNoDynamicValues, options, var_sp, error);
+  if (!valobj_sp || error.Fail())
+    return std::nullopt;
+
+  CompilerType type = valobj_sp->GetCompilerType().GetCanonicalType();
+  if (type.IsReferenceType()) {
+    valobj_sp = valobj_sp->Dereference(error);
+    if (!valobj_sp || error.Fail())
+      return std::nullopt;
+    type = valobj_sp->GetCompilerType().GetCanonicalType();
+  }
+
+  // Bit-fields narrower than int are promoted to int even when they are
+  // unsigned, so leave them to the expression parser.
+  if (valobj_sp->IsBitfield())
+    return std::nullopt;
+
+  bool is_signed = false;
+  const bool is_pointer = type.IsPointerType();
+  if (!is_pointer && (!type.IsIntegerOrEnumerationType(is_signed) ||
+                      type.IsScopedEnumerationType()))
+    return std::nullopt;
+  std::optional<uint64_t> byte_size = type.GetByteSize(&frame);
+  if (!byte_size || *byte_size == 0 || *byte_size > 8)
+    return std::nullopt;
+
+  bool success = false;
+  const uint64_t raw_value =
+      is_signed ? valobj_sp->GetValueAsSigned(0, &success)
+                : valobj_sp->GetValueAsUnsigned(0, &success);
+  if (!success)
+    return std::nullopt;
+
+  Operand operand;
+  operand.value =
+      llvm::APSInt(llvm::APInt(64, raw_value).zextOrTrunc(*byte_size * 8),
+                   !is_signed);
+  operand.is_pointer = is_pointer;
+  return operand;
+}
+
+static std::optional<Operand> EvaluateOperand(const Node &node,
+                                              StackFrame &frame) {
+  switch (node.kind) {
+  case Node::Kind::Constant: {
+    Operand operand;
+    operand.value = node.constant;
+    operand.is_pointer = node.is_nullptr;
+    operand.is_null_pointer_constant = node.constant.isZero();
+    return operand;
+  }
+  case Node::Kind::Variable:
+    return ReadVariable(node.path, frame);
+  default: {
+    std::optional<bool> truth = EvaluateTruth(node, frame);
+    if (!truth)
+      return std::nullopt;
+    Operand operand;
+    operand.value = llvm::APSInt(llvm::APInt(32, *truth), false);
+    return operand;
+  }
+  }
+}
+
+/// Apply the integer promotions and the usual arithmetic conversions of C to
+/// \a lhs and \a rhs, so that they have the same width and signedness.
+static void ConvertOperands(llvm::APSInt &lhs, llvm::APSInt &rhs) {
+  for (llvm::APSInt *value : {&lhs, &rhs}) {
+    if (value->getBitWidth() < 32) {
+      *value = value->extend(32);
+      value->setIsSigned(true);
+    }
+  }
+
+  if (lhs.isSigned() == rhs.isSigned()) {
+    const unsigned width = std::max(lhs.getBitWidth(), rhs.getBitWidth());
+    lhs = lhs.extOrTrunc(width);
+    rhs = rhs.extOrTrunc(width);
+    return;
+  }
+
+  llvm::APSInt &unsigned_value = lhs.isUnsigned() ? lhs : rhs;
+  llvm::APSInt &signed_value = lhs.isUnsigned() ? rhs : lhs;
+  if (unsigned_value.getBitWidth() >= signed_value.getBitWidth()) {
+    signed_value = signed_value.extOrTrunc(unsigned_value.getBitWidth());
+    signed_value.setIsUnsigned(true);
+  } else {
+    unsigned_value = unsigned_value.extOrTrunc(signed_value.getBitWidth());
+    unsigned_value.setIsSigned(true);
+  }
+}
+
+static std::optional<bool> EvaluateComparison(const Node &node,
+                                              StackFrame &frame) {
+  std::optional<Operand> lhs = EvaluateOperand(*node.lhs, frame);
+  if (!lhs)
+    return std::nullopt;
+  std::optional<Operand> rhs = EvaluateOperand(*node.rhs, frame);
+  if (!rhs)
+    return std::nullopt;
+
+  if (lhs->is_pointer || rhs->is_pointer) {
+    // Pointers can only be compared with pointers and null pointer constants.
+    if ((!lhs->is_pointer && !lhs->is_null_pointer_constant) ||
+        (!rhs->is_pointer && !rhs->is_null_pointer_constant))
+      return std::nullopt;
+    lhs->value = llvm::APSInt(lhs->value.zextOrTrunc(64), true);
+    rhs->value = llvm::APSInt(rhs->value.zextOrTrunc(64), true);
+  } else {
+    ConvertOperands(lhs->value, rhs->value);
+  }
+
+  const llvm::APSInt &l = lhs->value;
+  const llvm::APSInt &r = rhs->value;
+  switch (node.op) {
+  case Node::CompareOp::EQ:
+    return l == r;
+  case Node::CompareOp::NE:
+    return l != r;
+  case Node::CompareOp::LT:
+    return l < r;
+  case Node::CompareOp::LE:
+    return l <= r;
+  case Node::CompareOp::GT:
+    return l > r;
+  case Node::CompareOp::GE:
+    return l >= r;
+  }
+  llvm_unreachable("unknown comparison");
+}
+
+static std::optional<bool> EvaluateTruth(const Node &node, StackFrame &frame) {
+  switch (node.kind) {
+  case Node::Kind::Not: {
+    std::optional<bool> operand = EvaluateTruth(*node.lhs, frame);
+    if (!operand)
+      return std::nullopt;
+    return !*operand;
+  }
+  case Node::Kind::And:
+  case Node::Kind::Or: {
+    std::optional<bool> lhs = EvaluateTruth(*node.lhs, frame);
+    if (!lhs)
+      return std::nullopt;
+    // Like in C, the right hand side is only evaluated when it matters.
+    if (*lhs == (node.kind == Node::Kind::Or))
+      return *lhs;
+    return EvaluateTruth(*node.rhs, frame);
+  }
+  case Node::Kind::Compare:
+    return EvaluateComparison(node, frame);
+  case Node::Kind::Constant:
+  case Node::Kind::Variable: {
+    std::optional<Operand> operand = EvaluateOperand(node, frame);
+    if (!operand)
+      return std::nullopt;
+    return !operand->value.isZero();
+  }
+  }
+  llvm_unreachable("unknown node kind");
+}
+
+SimpleCondition::SimpleCondition(std::unique_ptr<Node> root)
+    : m_root(std::move(root)) {}
+
+SimpleCondition::~SimpleCondition() = default;
+
+std::unique_ptr<SimpleCondition> SimpleCondition::Parse(llvm::StringRef text) {
+  std::unique_ptr<Node> root = Parser(text).ParseCondition();
+  if (!root)
+    return nullptr;
+  return std::unique_ptr<SimpleCondition>(new SimpleCondition(std::move(root)));
+}
+
+std::optional<bool> SimpleCondition::Evaluate(StackFrame &frame) const {
+  return EvaluateTruth(*m_root, frame);
+}
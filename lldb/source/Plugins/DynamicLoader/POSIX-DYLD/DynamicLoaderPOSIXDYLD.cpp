@@ -10,6 +10,7 @@
 #include "DynamicLoaderPOSIXDYLD.h"
 
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/PluginManager.h"
@@ -26,6 +27,8 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/ProcessInfo.h"
 
+#include "llvm/Support/ThreadPool.h"
+
 #include <memory>
 #include <optional>
 
@@ -188,12 +191,18 @@ void DynamicLoaderPOSIXDYLD::UpdateLoadedSections(ModuleSP module,
                                                   addr_t link_map_addr,
                                                   addr_t base_addr,
                                                   bool base_addr_is_offset) {
-  m_loaded_modules[module] = link_map_addr;
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    m_loaded_modules[module] = link_map_addr;
+  }
   UpdateLoadedSectionsCommon(module, base_addr, base_addr_is_offset);
 }
 
 void DynamicLoaderPOSIXDYLD::UnloadSections(const ModuleSP module) {
-  m_loaded_modules.erase(module);
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    m_loaded_modules.erase(module);
+  }
 
   UnloadSectionsCommon(module);
 }
@@ -401,7 +410,10 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
   // The rendezvous class doesn't enumerate the main module, so track that
   // ourselves here.
   ModuleSP executable = GetTargetExecutable();
-  m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+  }
 
   DYLDRendezvous::iterator I;
   DYLDRendezvous::iterator E;
@@ -423,6 +435,7 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
       E = m_rendezvous.end();
       m_initial_modules_added = true;
     }
+    std::vector<const DYLDRendezvous::SOEntry *> entries;
     for (; I != E; ++I) {
       // Don't load a duplicate copy of ld.so if we have already loaded it
       // earlier in LoadInterpreterModule. If we instead loaded then unloaded it
@@ -431,9 +444,10 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
       if ((m_interpreter_module.lock() != nullptr) &&
           (I->base_addr == m_interpreter_base))
         continue;
+      entries.push_back(&*I);
+    }
 
-      ModuleSP module_sp =
-          LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
+    for (ModuleSP &module_sp : LoadModulesAtAddresses(entries)) {
       if (!module_sp.get())
         continue;
 
@@ -619,6 +633,31 @@ ModuleSP DynamicLoaderPOSIXDYLD::LoadModuleAtAddress(const FileSpec &file,
   return nullptr;
 }
 
+std::vector<ModuleSP> DynamicLoaderPOSIXDYLD::LoadModulesAtAddresses(
+    llvm::ArrayRef<const DYLDRendezvous::SOEntry *> entries) {
+  std::vector<ModuleSP> modules(entries.size());
+  auto load_module = [&](size_t i) {
+    modules[i] = LoadModuleAtAddress(entries[i]->file_spec,
+                                     entries[i]->link_addr,
+                                     entries[i]->base_addr, true);
+  };
+
+  if (!m_process->GetTarget().GetParallelModuleLoad()) {
+    for (size_t i = 0; i < entries.size(); ++i)
+      load_module(i);
+    return modules;
+  }
+
+  // Parsing the object files, and preloading their symbols if the target
+  // asks for it, is done by each task. With hundreds of shared libraries, as
+  // in a core file of a large server, this dominates the loading time.
+  llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+  for (size_t i = 0; i < entries.size(); ++i)
+    task_group.async(load_module, i);
+  task_group.wait();
+  return modules;
+}
+
 void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   DYLDRendezvous::iterator I;
   DYLDRendezvous::iterator E;
@@ -638,27 +677,33 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   // The rendezvous class doesn't enumerate the main module, so track that
   // ourselves here.
   ModuleSP executable = GetTargetExecutable();
-  m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+  }
 
   std::vector<FileSpec> module_names;
-  for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I)
+  std::vector<const DYLDRendezvous::SOEntry *> entries;
+  for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
     module_names.push_back(I->file_spec);
+    entries.push_back(&*I);
+  }
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
 
-  for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
-    ModuleSP module_sp =
-        LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
-    if (module_sp.get()) {
+  std::vector<ModuleSP> modules = LoadModulesAtAddresses(entries);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (modules[i].get()) {
       LLDB_LOG(log, "LoadAllCurrentModules loading module: {0}",
-               I->file_spec.GetFilename());
-      module_list.Append(module_sp);
+               entries[i]->file_spec.GetFilename());
+      module_list.Append(modules[i]);
     } else {
       Log *log = GetLog(LLDBLog::DynamicLoader);
       LLDB_LOGF(
           log,
           "DynamicLoaderPOSIXDYLD::%s failed loading module %s at 0x%" PRIx64,
-          __FUNCTION__, I->file_spec.GetPath().c_str(), I->base_addr);
+          __FUNCTION__, entries[i]->file_spec.GetPath().c_str(),
+          entries[i]->base_addr);
     }
   }
 
@@ -730,15 +775,20 @@ DynamicLoaderPOSIXDYLD::GetThreadLocalData(const lldb::ModuleSP module_sp,
                                            const lldb::ThreadSP thread,
                                            lldb::addr_t tls_file_addr) {
   Log *log = GetLog(LLDBLog::DynamicLoader);
-  auto it = m_loaded_modules.find(module_sp);
-  if (it == m_loaded_modules.end()) {
-    LLDB_LOGF(
-        log, "GetThreadLocalData error: module(%s) not found in loaded modules",
-        module_sp->GetObjectName().AsCString());
-    return LLDB_INVALID_ADDRESS;
+  addr_t link_map;
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    auto it = m_loaded_modules.find(module_sp);
+    if (it == m_loaded_modules.end()) {
+      LLDB_LOGF(
+          log,
+          "GetThreadLocalData error: module(%s) not found in loaded modules",
+          module_sp->GetObjectName().AsCString());
+      return LLDB_INVALID_ADDRESS;
+    }
+    link_map = it->second;
   }
 
-  addr_t link_map = it->second;
   if (link_map == LLDB_INVALID_ADDRESS || link_map == 0) {
     LLDB_LOGF(log,
               "GetThreadLocalData error: invalid link map address=0x%" PRIx64,
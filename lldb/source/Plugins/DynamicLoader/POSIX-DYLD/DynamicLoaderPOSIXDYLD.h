@@ -11,6 +11,8 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "DYLDRendezvous.h"
 #include "Plugins/Process/Utility/AuxVector.h"
@@ -96,6 +98,9 @@ protected:
   /// Loaded module list. (link map for each module)
   std::map<lldb::ModuleWP, lldb::addr_t, std::owner_less<lldb::ModuleWP>>
       m_loaded_modules;
+  /// Guards m_loaded_modules, which is updated while loading the modules in
+  /// parallel.
+  std::mutex m_loaded_modules_mutex;
 
   /// Returns true if the process is for a core file.
   bool IsCoreFile() const;
@@ -152,6 +157,12 @@ protected:
   /// of all dependent modules.
   virtual void LoadAllCurrentModules();
 
+  /// Loads the modules of the given rendezvous entries, in parallel if the
+  /// target.parallel-module-load setting is on. The modules are returned in
+  /// the order of the entries, with null for the ones that couldn't be loaded.
+  std::vector<lldb::ModuleSP> LoadModulesAtAddresses(
+      llvm::ArrayRef<const DYLDRendezvous::SOEntry *> entries);
+
   void LoadVDSO();
 
   // Loading an interpreter module (if present) assuming m_interpreter_base
@@ -10,6 +10,7 @@
 #include "Plugins/TypeSystem/Clang/TypeSystemClang.h"
 
 #include "clang/AST/Decl.h"
+#include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclObjC.h"
 #include "clang/Basic/Module.h"
 #include <optional>
@@ -60,6 +61,17 @@ bool ClangExternalASTSourceCallbacks::FindExternalVisibleDeclsByName(
       if (omd->getDeclName() == Name)
         decls.push_back(omd);
   }
+  // The members of C++ classes with this name may not have been parsed yet.
+  if (auto *record_decl = llvm::dyn_cast<clang::CXXRecordDecl>(DC)) {
+    if (Name.isIdentifier() &&
+        m_ast.ParseLazyMembers(const_cast<clang::CXXRecordDecl *>(record_decl),
+                               Name.getAsIdentifierInfo()->getName())) {
+      for (clang::Decl *decl : record_decl->noload_decls())
+        if (auto *named_decl = llvm::dyn_cast<clang::NamedDecl>(decl))
+          if (named_decl->getDeclName() == Name)
+            decls.push_back(named_decl);
+    }
+  }
   return !SetExternalVisibleDeclsForName(DC, Name, decls).empty();
 }
 
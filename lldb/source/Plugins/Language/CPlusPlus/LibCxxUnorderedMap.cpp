@@ -21,6 +21,8 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
 
+#include <optional>
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
@@ -49,12 +51,21 @@ private:
   CompilerType GetElementType(CompilerType node_type);
   llvm::Expected<size_t> CalculateNumChildrenImpl(ValueObject &table);
 
+  /// Find the offsets of `__value_` and `__next_` in the nodes, by looking at
+  /// the first one.
+  bool ComputeNodeLayout();
+
   CompilerType m_element_type;
   CompilerType m_node_type;
   ValueObject *m_tree = nullptr;
   size_t m_num_elements = 0;
-  ValueObject *m_next_element = nullptr;
-  std::vector<std::pair<ValueObject *, uint64_t>> m_elements_cache;
+  /// The nodes are walked by only reading their `__next_` pointers, so that
+  /// getting a child doesn't create values for all the nodes before it.
+  std::optional<uint64_t> m_value_offset;
+  uint64_t m_next_offset = 0;
+  lldb::addr_t m_next_node = LLDB_INVALID_ADDRESS;
+  /// The addresses of the values of the nodes walked so far.
+  std::vector<lldb::addr_t> m_elements_cache;
 };
 
 class LibCxxUnorderedMapIteratorSyntheticFrontEnd
@@ -145,6 +156,68 @@ CompilerType lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
   return node_sp->GetCompilerType().GetTypeTemplateArgument(0).GetPointeeType();
 }
 
+bool lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
+    ComputeNodeLayout() {
+  Status error;
+  ValueObjectSP node_sp = m_tree->Dereference(error);
+  if (!node_sp || error.Fail())
+    return false;
+
+  ValueObjectSP value_sp = node_sp->GetChildMemberWithName("__value_");
+  if (!value_sp) {
+    if (!m_element_type) {
+      m_node_type = GetNodeType();
+      if (!m_node_type)
+        return false;
+
+      m_element_type = GetElementType(m_node_type);
+    }
+    node_sp = m_tree->Cast(m_node_type.GetPointerType())->Dereference(error);
+    if (!node_sp || error.Fail())
+      return false;
+
+    value_sp = node_sp->GetChildMemberWithName("__value_");
+    if (!value_sp) {
+      // clang-format off
+      // Since D101206 (ba79fb2e1f), libc++ wraps the `__value_` in an
+      // anonymous union.
+      // Child 0: __hash_node_base base class
+      // Child 1: __hash_
+      // Child 2: anonymous union
+      // clang-format on
+      auto anon_union_sp = node_sp->GetChildAtIndex(2);
+      if (!anon_union_sp)
+        return false;
+
+      value_sp = anon_union_sp->GetChildMemberWithName("__value_");
+      if (!value_sp)
+        return false;
+    }
+  } else if (!m_element_type) {
+    m_element_type = GetElementType(node_sp->GetCompilerType());
+  }
+
+  ValueObjectSP next_sp = node_sp->GetChildMemberWithName("__next_");
+  if (!next_sp)
+    return false;
+
+  AddressType node_address_type = eAddressTypeInvalid;
+  AddressType value_address_type = eAddressTypeInvalid;
+  AddressType next_address_type = eAddressTypeInvalid;
+  const addr_t node_addr = node_sp->GetAddressOf(true, &node_address_type);
+  const addr_t value_addr = value_sp->GetAddressOf(true, &value_address_type);
+  const addr_t next_addr = next_sp->GetAddressOf(true, &next_address_type);
+  if (node_address_type != eAddressTypeLoad ||
+      value_address_type != eAddressTypeLoad ||
+      next_address_type != eAddressTypeLoad || value_addr < node_addr ||
+      next_addr < node_addr)
+    return false;
+
+  m_value_offset = value_addr - node_addr;
+  m_next_offset = next_addr - node_addr;
+  return true;
+}
+
 lldb::ValueObjectSP lldb_private::formatters::
     LibcxxStdUnorderedMapSyntheticFrontEnd::GetChildAtIndex(uint32_t idx) {
   if (idx >= CalculateNumChildrenIgnoringErrors())
@@ -152,74 +225,33 @@ lldb::ValueObjectSP lldb_private::formatters::
   if (m_tree == nullptr)
     return lldb::ValueObjectSP();
 
+  ProcessSP process_sp = m_backend.GetProcessSP();
+  if (!process_sp)
+    return lldb::ValueObjectSP();
+
   while (idx >= m_elements_cache.size()) {
-    if (m_next_element == nullptr)
+    if (m_next_node == 0 || m_next_node == LLDB_INVALID_ADDRESS)
       return lldb::ValueObjectSP();
 
-    Status error;
-    ValueObjectSP node_sp = m_next_element->Dereference(error);
-    if (!node_sp || error.Fail())
+    if (!m_value_offset && !ComputeNodeLayout())
       return lldb::ValueObjectSP();
 
-    ValueObjectSP value_sp = node_sp->GetChildMemberWithName("__value_");
-    ValueObjectSP hash_sp = node_sp->GetChildMemberWithName("__hash_");
-    if (!hash_sp || !value_sp) {
-      if (!m_element_type) {
-        m_node_type = GetNodeType();
-        if (!m_node_type)
-          return nullptr;
-
-        m_element_type = GetElementType(m_node_type);
-      }
-      node_sp = m_next_element->Cast(m_node_type.GetPointerType())
-              ->Dereference(error);
-      if (!node_sp || error.Fail())
-          return nullptr;
-
-      hash_sp = node_sp->GetChildMemberWithName("__hash_");
-      if (!hash_sp)
-        return nullptr;
-
-      value_sp = node_sp->GetChildMemberWithName("__value_");
-      if (!value_sp) {
-        // clang-format off
-        // Since D101206 (ba79fb2e1f), libc++ wraps the `__value_` in an
-        // anonymous union.
-        // Child 0: __hash_node_base base class
-        // Child 1: __hash_
-        // Child 2: anonymous union
-        // clang-format on
-        auto anon_union_sp = node_sp->GetChildAtIndex(2);
-        if (!anon_union_sp)
-          return nullptr;
-
-        value_sp = anon_union_sp->GetChildMemberWithName("__value_");
-        if (!value_sp)
-          return nullptr;
-      }
-    }
-    m_elements_cache.push_back(
-        {value_sp.get(), hash_sp->GetValueAsUnsigned(0)});
-    m_next_element = node_sp->GetChildMemberWithName("__next_").get();
-    if (!m_next_element || m_next_element->GetValueAsUnsigned(0) == 0)
-      m_next_element = nullptr;
+    m_elements_cache.push_back(m_next_node + *m_value_offset);
+    Status error;
+    m_next_node =
+        process_sp->ReadPointerFromMemory(m_next_node + m_next_offset, error);
+    if (error.Fail())
+      m_next_node = LLDB_INVALID_ADDRESS;
   }
 
-  std::pair<ValueObject *, uint64_t> val_hash = m_elements_cache[idx];
-  if (!val_hash.first)
-    return lldb::ValueObjectSP();
   StreamString stream;
   stream.Printf("[%" PRIu64 "]", (uint64_t)idx);
-  DataExtractor data;
-  Status error;
-  val_hash.first->GetData(data, error);
-  if (error.Fail())
-    return lldb::ValueObjectSP();
   const bool thread_and_frame_only_if_stopped = true;
-  ExecutionContext exe_ctx = val_hash.first->GetExecutionContextRef().Lock(
+  ExecutionContext exe_ctx = m_backend.GetExecutionContextRef().Lock(
       thread_and_frame_only_if_stopped);
-  return CreateValueObjectFromData(stream.GetString(), data, exe_ctx,
-                                   m_element_type);
+  return CreateValueObjectFromAddress(stream.GetString(),
+                                      m_elements_cache[idx], exe_ctx,
+                                      m_element_type);
 }
 
 llvm::Expected<size_t>
@@ -268,7 +300,7 @@ static ValueObjectSP GetTreePointer(ValueObject &table) {
 lldb::ChildCacheState
 lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::Update() {
   m_num_elements = 0;
-  m_next_element = nullptr;
+  m_next_node = LLDB_INVALID_ADDRESS;
   m_elements_cache.clear();
   ValueObjectSP table_sp = m_backend.GetChildMemberWithName("__table_");
   if (!table_sp)
@@ -289,7 +321,7 @@ lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::Update() {
   }
 
   if (m_num_elements > 0)
-    m_next_element = m_tree;
+    m_next_node = m_tree->GetValueAsUnsigned(LLDB_INVALID_ADDRESS);
 
   return lldb::ChildCacheState::eRefetch;
 }
@@ -194,6 +194,25 @@ GDBRemoteClientBase::SendPacketAndWaitForResponse(
   return SendPacketAndWaitForResponseNoLock(payload, response);
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::SendPacketsAndWaitForResponses(
+    llvm::ArrayRef<std::string> payloads,
+    std::vector<StringExtractorGDBRemote> &responses,
+    std::chrono::seconds interrupt_timeout) {
+  responses.clear();
+  Lock lock(*this, interrupt_timeout);
+  if (!lock) {
+    if (Log *log = GetLog(GDBRLog::Process))
+      LLDB_LOGF(log,
+                "GDBRemoteClientBase::%s failed to get mutex, not sending "
+                "%zu packets",
+                __FUNCTION__, payloads.size());
+    return PacketResult::ErrorSendFailed;
+  }
+
+  return SendPacketsAndWaitForResponsesNoLock(payloads, responses);
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteClientBase::ReadPacketWithOutputSupport(
     StringExtractorGDBRemote &response, Timeout<std::micro> timeout,
@@ -263,6 +282,50 @@ GDBRemoteClientBase::SendPacketAndWaitForResponseNoLock(
   return packet_result;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::SendPacketsAndWaitForResponsesNoLock(
+    llvm::ArrayRef<std::string> payloads,
+    std::vector<StringExtractorGDBRemote> &responses) {
+  responses.clear();
+  responses.resize(payloads.size());
+
+  // With acks, every packet has to be acknowledged before the next one is
+  // sent, so there is nothing to overlap.
+  if (!GetPacketPipeliningEnabled()) {
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      PacketResult packet_result =
+          SendPacketAndWaitForResponseNoLock(payloads[i], responses[i]);
+      if (packet_result != PacketResult::Success) {
+        responses.resize(i);
+        return packet_result;
+      }
+    }
+    return PacketResult::Success;
+  }
+
+  size_t num_sent = 0;
+  PacketResult packet_result = PacketResult::Success;
+  for (; num_sent < payloads.size(); ++num_sent) {
+    packet_result = SendPacketNoLock(payloads[num_sent]);
+    if (packet_result != PacketResult::Success)
+      break;
+  }
+
+  // Read the responses to all the packets that were sent, even if some other
+  // packet couldn't be, so that they aren't taken for the responses to the
+  // next packets.
+  for (size_t i = 0; i < num_sent; ++i) {
+    PacketResult read_result =
+        ReadPacket(responses[i], GetPacketTimeout(), true);
+    if (read_result != PacketResult::Success) {
+      responses.resize(i);
+      return read_result;
+    }
+  }
+  responses.resize(num_sent);
+  return packet_result;
+}
+
 bool GDBRemoteClientBase::ShouldStop(const UnixSignals &signals,
                                      StringExtractorGDBRemote &response) {
   std::lock_guard<std::mutex> lock(m_mutex);
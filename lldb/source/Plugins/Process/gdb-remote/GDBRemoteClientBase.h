@@ -11,6 +11,7 @@
 
 #include "GDBRemoteCommunication.h"
 
+#include <atomic>
 #include <condition_variable>
 
 namespace lldb_private {
@@ -58,6 +59,28 @@ public:
       llvm::StringRef payload, StringExtractorGDBRemote &response,
       std::chrono::seconds interrupt_timeout = std::chrono::seconds(0));
 
+  /// Send all of \p payloads and store their responses, in order, into
+  /// \p responses.
+  ///
+  /// If packet pipelining is enabled and the connection doesn't use acks, all
+  /// the packets are sent before the first response is read, so that their
+  /// round trips overlap. Otherwise they are sent one at a time. If a packet
+  /// fails, \p responses only holds the responses of the packets before it.
+  PacketResult SendPacketsAndWaitForResponses(
+      llvm::ArrayRef<std::string> payloads,
+      std::vector<StringExtractorGDBRemote> &responses,
+      std::chrono::seconds interrupt_timeout = std::chrono::seconds(0));
+
+  void SetPacketPipeliningEnabled(bool enabled) {
+    m_pipeline_packets = enabled;
+  }
+
+  /// Return true if SendPacketsAndWaitForResponses can send several packets
+  /// before reading their responses.
+  bool GetPacketPipeliningEnabled() {
+    return m_pipeline_packets && !GetSendAcks();
+  }
+
   PacketResult ReadPacketWithOutputSupport(
       StringExtractorGDBRemote &response, Timeout<std::micro> timeout,
       bool sync_on_timeout,
@@ -101,6 +124,10 @@ protected:
   SendPacketAndWaitForResponseNoLock(llvm::StringRef payload,
                                      StringExtractorGDBRemote &response);
 
+  PacketResult SendPacketsAndWaitForResponsesNoLock(
+      llvm::ArrayRef<std::string> payloads,
+      std::vector<StringExtractorGDBRemote> &responses);
+
   virtual void OnRunPacketSent(bool first);
 
 private:
@@ -148,6 +175,10 @@ private:
   /// now they just use a simple mutex.
   std::recursive_mutex m_async_mutex;
 
+  /// Whether SendPacketsAndWaitForResponses may have several packets in
+  /// flight.
+  std::atomic<bool> m_pipeline_packets = false;
+
   bool ShouldStop(const UnixSignals &signals,
                   StringExtractorGDBRemote &response);
 
@@ -346,6 +346,7 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
   m_supports_qEcho = eLazyBoolNo;
   m_supports_QPassSignals = eLazyBoolNo;
   m_supports_memory_tagging = eLazyBoolNo;
+  m_supports_multi_mem_read = eLazyBoolNo;
   m_supports_qSaveCore = eLazyBoolNo;
   m_uses_native_signals = eLazyBoolNo;
 
@@ -397,6 +398,8 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
         m_supports_multiprocess = eLazyBoolYes;
       else if (x == "memory-tagging+")
         m_supports_memory_tagging = eLazyBoolYes;
+      else if (x == "MultiMemRead+")
+        m_supports_multi_mem_read = eLazyBoolYes;
       else if (x == "qSaveCore+")
         m_supports_qSaveCore = eLazyBoolYes;
       else if (x == "native-signals+")
@@ -653,6 +656,12 @@ bool GDBRemoteCommunicationClient::GetMemoryTaggingSupported() {
   return m_supports_memory_tagging == eLazyBoolYes;
 }
 
+bool GDBRemoteCommunicationClient::GetMultiMemReadSupported() {
+  if (m_supports_multi_mem_read == eLazyBoolCalculate)
+    GetRemoteQSupported();
+  return m_supports_multi_mem_read == eLazyBoolYes;
+}
+
 DataBufferSP GDBRemoteCommunicationClient::ReadMemoryTags(lldb::addr_t addr,
                                                           size_t len,
                                                           int32_t type) {
@@ -3530,6 +3539,46 @@ DataBufferSP GDBRemoteCommunicationClient::ReadRegister(lldb::tid_t tid,
   return buffer_sp;
 }
 
+std::vector<DataBufferSP>
+GDBRemoteCommunicationClient::ReadRegisters(lldb::tid_t tid,
+                                           llvm::ArrayRef<uint32_t> reg_nums) {
+  std::vector<DataBufferSP> buffers(reg_nums.size());
+  Lock lock(*this);
+  if (!lock) {
+    if (Log *log = GetLog(GDBRLog::Process | GDBRLog::Packets))
+      LLDB_LOGF(log,
+                "GDBRemoteCommunicationClient::%s: Didn't get sequence mutex "
+                "for p packets.",
+                __FUNCTION__);
+    return buffers;
+  }
+
+  const bool thread_suffix_supported = GetThreadSuffixSupported();
+  if (!thread_suffix_supported && !SetCurrentThread(tid))
+    return buffers;
+
+  std::vector<std::string> payloads;
+  for (uint32_t reg : reg_nums) {
+    StreamString payload;
+    payload.Printf("p%x", reg);
+    if (thread_suffix_supported)
+      payload.Printf(";thread:%4.4" PRIx64 ";", tid);
+    payloads.push_back(payload.GetString().str());
+  }
+
+  std::vector<StringExtractorGDBRemote> responses;
+  SendPacketsAndWaitForResponsesNoLock(payloads, responses);
+  for (size_t i = 0; i < responses.size(); ++i) {
+    if (!responses[i].IsNormalResponse())
+      continue;
+    WritableDataBufferSP buffer_sp(
+        new DataBufferHeap(responses[i].GetStringRef().size() / 2, 0));
+    responses[i].GetHexBytes(buffer_sp->GetData(), '\xcc');
+    buffers[i] = buffer_sp;
+  }
+  return buffers;
+}
+
 DataBufferSP GDBRemoteCommunicationClient::ReadAllRegisters(lldb::tid_t tid) {
   StreamString payload;
   payload.PutChar('g');
@@ -399,6 +399,14 @@ public:
       uint32_t
           reg_num); // Must be the eRegisterKindProcessPlugin register number
 
+  /// Read the registers \p reg_nums, which are eRegisterKindProcessPlugin
+  /// register numbers, with pipelined 'p' packets if pipelining is enabled.
+  ///
+  /// \return The value of each register, or null for the registers that
+  ///     couldn't be read.
+  std::vector<lldb::DataBufferSP>
+  ReadRegisters(lldb::tid_t tid, llvm::ArrayRef<uint32_t> reg_nums);
+
   lldb::DataBufferSP ReadAllRegisters(lldb::tid_t tid);
 
   bool
@@ -432,6 +440,10 @@ public:
 
   bool GetMemoryTaggingSupported();
 
+  /// Return true if the server can read several ranges of memory with a
+  /// single MultiMemRead packet.
+  bool GetMultiMemReadSupported();
+
   bool UsesNativeSignals();
 
   lldb::DataBufferSP ReadMemoryTags(lldb::addr_t addr, size_t len,
@@ -559,6 +571,7 @@ protected:
   LazyBool m_supports_error_string_reply = eLazyBoolCalculate;
   LazyBool m_supports_multiprocess = eLazyBoolCalculate;
   LazyBool m_supports_memory_tagging = eLazyBoolCalculate;
+  LazyBool m_supports_multi_mem_read = eLazyBoolCalculate;
   LazyBool m_supports_qSaveCore = eLazyBoolCalculate;
   LazyBool m_uses_native_signals = eLazyBoolCalculate;
 
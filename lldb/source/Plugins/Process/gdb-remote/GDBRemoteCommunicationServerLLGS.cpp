@@ -94,6 +94,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_M,
                                 &GDBRemoteCommunicationServerLLGS::Handle_M);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_MultiMemRead,
+      &GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType__M,
                                 &GDBRemoteCommunicationServerLLGS::Handle__M);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType__m,
@@ -2547,6 +2550,66 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(
   return SendPacketNoLock(response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead(
+    StringExtractorGDBRemote &packet) {
+  Log *log = GetLog(LLDBLog::Process);
+
+  if (!m_current_process ||
+      (m_current_process->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    LLDB_LOGF(
+        log,
+        "GDBRemoteCommunicationServerLLGS::%s failed, no process available",
+        __FUNCTION__);
+    return SendErrorResponse(0x15);
+  }
+
+  // The packet is "MultiMemRead:ranges:<addr>,<length>[,<addr>,<length>]*;".
+  llvm::StringRef ranges_str = packet.GetStringRef();
+  if (!ranges_str.consume_front("MultiMemRead:ranges:") ||
+      !ranges_str.consume_back(";"))
+    return SendIllFormedResponse(packet, "Invalid MultiMemRead packet");
+
+  llvm::SmallVector<llvm::StringRef, 16> values;
+  ranges_str.split(values, ',');
+  if (values.size() % 2 != 0)
+    return SendIllFormedResponse(packet, "Odd number of MultiMemRead values");
+
+  // Reply with the number of bytes read for each range, followed by the
+  // bytes of all the ranges. Ranges that can't be read are reported as
+  // empty, rather than failing the whole packet.
+  StreamGDBRemote lengths;
+  std::string data;
+  for (size_t i = 0; i < values.size(); i += 2) {
+    lldb::addr_t read_addr;
+    uint64_t byte_count;
+    if (values[i].getAsInteger(16, read_addr) ||
+        values[i + 1].getAsInteger(16, byte_count))
+      return SendIllFormedResponse(packet, "Invalid MultiMemRead range");
+
+    std::string buf(byte_count, '\0');
+    size_t bytes_read = 0;
+    if (byte_count > 0) {
+      Status error = m_current_process->ReadMemoryWithoutTrap(
+          read_addr, &buf[0], byte_count, bytes_read);
+      LLDB_LOG(log,
+               "ReadMemoryWithoutTrap({0}) read {1} of {2} requested bytes "
+               "(error: {3})",
+               read_addr, bytes_read, byte_count, error);
+    }
+    if (i > 0)
+      lengths.PutChar(',');
+    lengths.Printf("%" PRIx64, (uint64_t)bytes_read);
+    data.append(buf.data(), bytes_read);
+  }
+
+  StreamGDBRemote response;
+  response.PutCString(lengths.GetString());
+  response.PutChar(';');
+  response.PutEscapedBytes(data.data(), data.size());
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle__M(StringExtractorGDBRemote &packet) {
   Log *log = GetLog(LLDBLog::Process);
@@ -4213,6 +4276,7 @@ std::vector<std::string> GDBRemoteCommunicationServerLLGS::HandleFeatures(
                             "QListThreadsInStopReply+",
                             "qXfer:features:read+",
                             "QNonStop+",
+                            "MultiMemRead+",
                         });
 
   // report server-only features
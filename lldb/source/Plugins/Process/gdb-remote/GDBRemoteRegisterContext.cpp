@@ -546,6 +546,27 @@ bool GDBRemoteRegisterContext::ReadAllRegisterValues(
     // individually and store them as binary data in a buffer.
     const RegisterInfo *reg_info;
 
+    // Fetch the registers that aren't valid yet all at once, so that the
+    // packets can be pipelined.
+    if (gdb_comm.GetPacketPipeliningEnabled()) {
+      std::vector<uint32_t> lldb_regs;
+      std::vector<uint32_t> remote_regs;
+      for (uint32_t i = 0; (reg_info = GetRegisterInfoAtIndex(i)) != nullptr;
+           i++) {
+        if (reg_info->value_regs || GetRegisterIsValid(i))
+          continue;
+        lldb_regs.push_back(reg_info->kinds[eRegisterKindLLDB]);
+        remote_regs.push_back(reg_info->kinds[eRegisterKindProcessPlugin]);
+      }
+      std::vector<DataBufferSP> buffers =
+          gdb_comm.ReadRegisters(m_thread.GetProtocolID(), remote_regs);
+      for (size_t i = 0; i < buffers.size(); ++i)
+        if (buffers[i])
+          PrivateSetRegisterValue(
+              lldb_regs[i], llvm::ArrayRef<uint8_t>(buffers[i]->GetBytes(),
+                                                    buffers[i]->GetByteSize()));
+    }
+
     for (uint32_t i = 0; (reg_info = GetRegisterInfoAtIndex(i)) != nullptr;
          i++) {
       if (reg_info
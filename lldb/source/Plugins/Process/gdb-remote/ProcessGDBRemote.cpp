@@ -167,6 +167,12 @@ public:
     const uint32_t idx = ePropertyUseGPacketForReading;
     return GetPropertyAtIndexAs<bool>(idx, true);
   }
+
+  bool GetPacketPipelining() const {
+    const uint32_t idx = ePropertyPacketPipelining;
+    return GetPropertyAtIndexAs<bool>(
+        idx, g_processgdbremote_properties[idx].default_uint_value != 0);
+  }
 };
 
 } // namespace
@@ -293,6 +299,8 @@ ProcessGDBRemote::ProcessGDBRemote(lldb::TargetSP target_sp,
 
   m_use_g_packet_for_reading =
       GetGlobalPluginProperties().GetUseGPacketForReading();
+  m_gdb_comm.SetPacketPipeliningEnabled(
+      GetGlobalPluginProperties().GetPacketPipelining());
 }
 
 // Destructor
@@ -2607,6 +2615,27 @@ void ProcessGDBRemote::WillPublicStop() {
 }
 
 // Process Memory
+/// Copy the memory in the response to an 'x' or 'm' packet into \p buf.
+static size_t GetMemoryReadResponseBytes(StringExtractorGDBRemote &response,
+                                         bool binary_memory_read, void *buf,
+                                         size_t size) {
+  if (binary_memory_read) {
+    // The lower level GDBRemoteCommunication packet receive layer has
+    // already de-quoted any 0x7d character escaping that was present in
+    // the packet
+    size_t data_received_size = response.GetBytesLeft();
+    if (data_received_size > size) {
+      // Don't write past the end of BUF if the remote debug server gave us
+      // too much data for some reason.
+      data_received_size = size;
+    }
+    memcpy(buf, response.GetStringRef().data(), data_received_size);
+    return data_received_size;
+  }
+  return response.GetHexBytes(
+      llvm::MutableArrayRef<uint8_t>((uint8_t *)buf, size), '\xdd');
+}
+
 size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
                                       Status &error) {
   GetMaxMemorySize();
@@ -2634,23 +2663,8 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
       GDBRemoteCommunication::PacketResult::Success) {
     if (response.IsNormalResponse()) {
       error.Clear();
-      if (binary_memory_read) {
-        // The lower level GDBRemoteCommunication packet receive layer has
-        // already de-quoted any 0x7d character escaping that was present in
-        // the packet
-
-        size_t data_received_size = response.GetBytesLeft();
-        if (data_received_size > size) {
-          // Don't write past the end of BUF if the remote debug server gave us
-          // too much data for some reason.
-          data_received_size = size;
-        }
-        memcpy(buf, response.GetStringRef().data(), data_received_size);
-        return data_received_size;
-      } else {
-        return response.GetHexBytes(
-            llvm::MutableArrayRef<uint8_t>((uint8_t *)buf, size), '\xdd');
-      }
+      return GetMemoryReadResponseBytes(response, binary_memory_read, buf,
+                                        size);
     } else if (response.IsErrorResponse())
       error = Status::FromErrorStringWithFormat(
           "memory read failed for 0x%" PRIx64, addr);
@@ -2672,6 +2686,123 @@ bool ProcessGDBRemote::SupportsMemoryTagging() {
   return m_gdb_comm.GetMemoryTaggingSupported();
 }
 
+std::vector<size_t> ProcessGDBRemote::DoReadMemoryRanges(
+    llvm::ArrayRef<Range<addr_t, size_t>> ranges, uint8_t *buf) {
+  const bool multi_mem_read = m_gdb_comm.GetMultiMemReadSupported();
+  if (!multi_mem_read && !m_gdb_comm.GetPacketPipeliningEnabled())
+    return Process::DoReadMemoryRanges(ranges, buf);
+
+  GetMaxMemorySize();
+  const bool binary_memory_read =
+      multi_mem_read || m_gdb_comm.GetxPacketSupported();
+  // M and m packets take 2 bytes for 1 byte of memory
+  const size_t max_memory_size =
+      binary_memory_read ? m_max_memory_size : m_max_memory_size / 2;
+
+  // Split the ranges into chunks which fit in a response.
+  struct Chunk {
+    addr_t addr;
+    size_t size;
+    uint8_t *buf;
+    size_t range_idx;
+  };
+  std::vector<Chunk> chunks;
+  uint8_t *range_buf = buf;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const size_t size = ranges[i].GetByteSize();
+    for (size_t offset = 0; offset < size; offset += max_memory_size)
+      chunks.push_back({ranges[i].GetRangeBase() + offset,
+                        std::min(max_memory_size, size - offset),
+                        range_buf + offset, i});
+    range_buf += size;
+  }
+
+  // With MultiMemRead, every packet reads as many chunks as fit in one
+  // response. Otherwise, every chunk is read with its own packet, and the
+  // packets are pipelined.
+  std::vector<std::string> payloads;
+  std::vector<std::pair<size_t, size_t>> packet_chunks;
+  for (size_t begin = 0; begin < chunks.size();) {
+    StreamString packet;
+    size_t end = begin;
+    if (multi_mem_read) {
+      packet.PutCString("MultiMemRead:ranges:");
+      size_t packet_size = 0;
+      for (; end < chunks.size(); ++end) {
+        if (end > begin && packet_size + chunks[end].size > max_memory_size)
+          break;
+        if (end > begin)
+          packet.PutChar(',');
+        packet.Printf("%" PRIx64 ",%" PRIx64, (uint64_t)chunks[end].addr,
+                      (uint64_t)chunks[end].size);
+        packet_size += chunks[end].size;
+      }
+      packet.PutChar(';');
+    } else {
+      packet.Printf("%c%" PRIx64 ",%" PRIx64, binary_memory_read ? 'x' : 'm',
+                    (uint64_t)chunks[begin].addr, (uint64_t)chunks[begin].size);
+      end = begin + 1;
+    }
+    payloads.push_back(packet.GetString().str());
+    packet_chunks.emplace_back(begin, end);
+    begin = end;
+  }
+
+  std::vector<StringExtractorGDBRemote> responses;
+  m_gdb_comm.SendPacketsAndWaitForResponses(payloads, responses,
+                                            GetInterruptTimeout());
+
+  // A range was read up to the first chunk which wasn't read completely.
+  std::vector<size_t> bytes_read(ranges.size(), 0);
+  std::vector<bool> range_done(ranges.size(), false);
+  auto add_chunk_bytes = [&](const Chunk &chunk, size_t chunk_bytes_read) {
+    if (range_done[chunk.range_idx])
+      return;
+    bytes_read[chunk.range_idx] += chunk_bytes_read;
+    if (chunk_bytes_read < chunk.size)
+      range_done[chunk.range_idx] = true;
+  };
+  for (size_t i = 0; i < packet_chunks.size(); ++i) {
+    auto [begin, end] = packet_chunks[i];
+    if (i >= responses.size() || !responses[i].IsNormalResponse()) {
+      for (size_t c = begin; c < end; ++c)
+        add_chunk_bytes(chunks[c], 0);
+      continue;
+    }
+
+    StringExtractorGDBRemote &response = responses[i];
+    if (!multi_mem_read) {
+      add_chunk_bytes(chunks[begin],
+                      GetMemoryReadResponseBytes(response, binary_memory_read,
+                                                 chunks[begin].buf,
+                                                 chunks[begin].size));
+      continue;
+    }
+
+    // The response is "<length>[,<length>]*;<data>", with the data of all the
+    // chunks one after the other.
+    std::vector<size_t> lengths;
+    bool valid = true;
+    for (size_t c = begin; c < end && valid; ++c) {
+      lengths.push_back(std::min<uint64_t>(
+          response.GetHexMaxU64(/*little_endian=*/false, 0), chunks[c].size));
+      valid = response.GetChar() == (c + 1 == end ? ';' : ',');
+    }
+    llvm::StringRef data = response.GetStringRef().substr(
+        response.GetFilePos());
+    for (size_t c = begin; c < end; ++c) {
+      size_t length = 0;
+      if (valid && c - begin < lengths.size()) {
+        length = std::min(lengths[c - begin], data.size());
+        memcpy(chunks[c].buf, data.data(), length);
+        data = data.drop_front(length);
+      }
+      add_chunk_bytes(chunks[c], length);
+    }
+  }
+  return bytes_read;
+}
+
 llvm::Expected<std::vector<uint8_t>>
 ProcessGDBRemote::DoReadMemoryTags(lldb::addr_t addr, size_t len,
                                    int32_t type) {
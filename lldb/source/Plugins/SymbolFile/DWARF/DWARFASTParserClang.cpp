@@ -45,6 +45,7 @@
 #include "clang/AST/Type.h"
 #include "clang/Basic/Specifiers.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/DebugInfo/DWARF/DWARFAddressRange.h"
 #include "llvm/DebugInfo/DWARF/DWARFTypePrinter.h"
 #include "llvm/Demangle/Demangle.h"
@@ -2051,6 +2052,35 @@ bool DWARFASTParserClang::ParseTemplateParameterInfos(
          template_param_infos.hasParameterPack();
 }
 
+/// Return the name under which Clang looks up the member \p die.
+static llvm::StringRef GetMemberLookupName(const DWARFDIE &die) {
+  return llvm::StringRef(die.GetName()).take_until(
+      [](char c) { return c == '<'; });
+}
+
+/// Return true if \p die, a member function or nested type of the class
+/// named \p class_name, can be parsed when it is looked up rather than when
+/// the class is completed.
+static bool IsLazyMember(const DWARFDIE &die, llvm::StringRef class_name) {
+  llvm::StringRef name = GetMemberLookupName(die);
+  if (name.empty())
+    return false;
+  switch (die.Tag()) {
+  case DW_TAG_subprogram:
+    // Clang checks the special members and the virtual functions, which decide
+    // on the properties of the class, without looking them up by name.
+    return die.GetAttributeValueAsUnsigned(DW_AT_virtuality, 0) == 0 &&
+           die.GetAttributeValueAsUnsigned(DW_AT_artificial, 0) == 0 &&
+           name != class_name && !name.starts_with("~") &&
+           !name.starts_with("operator");
+  case DW_TAG_enumeration_type:
+    // The enumerators of unscoped enums are looked up in the class.
+    return false;
+  default:
+    return true;
+  }
+}
+
 bool DWARFASTParserClang::CompleteRecordType(const DWARFDIE &die,
                                              const CompilerType &clang_type) {
   const dw_tag_t tag = die.Tag();
@@ -2086,6 +2116,39 @@ bool DWARFASTParserClang::CompleteRecordType(const DWARFDIE &die,
                     contained_type_dies, delayed_properties,
                     default_accessibility, layout_info);
 
+  // Leave out the member functions and nested types that can be parsed when
+  // they are looked up. All the members with a name that has to be parsed now
+  // are parsed too, as Clang only asks for the names it didn't find.
+  llvm::StringMap<std::vector<DWARFDIE>> lazy_members;
+  if (SymbolFileDWARF::GetLazyClassMembers() &&
+      !TypeSystemClang::IsObjCObjectOrInterfaceType(clang_type)) {
+    llvm::StringRef class_name = GetMemberLookupName(die);
+    llvm::StringSet<> eager_names;
+    auto split_lazy_members = [&](std::vector<DWARFDIE> &member_dies) {
+      llvm::erase_if(member_dies, [&](const DWARFDIE &member_die) {
+        if (!IsLazyMember(member_die, class_name)) {
+          eager_names.insert(GetMemberLookupName(member_die));
+          return false;
+        }
+        lazy_members[GetMemberLookupName(member_die)].push_back(member_die);
+        return true;
+      });
+    };
+    split_lazy_members(member_function_dies);
+    split_lazy_members(contained_type_dies);
+
+    for (const auto &eager_name : eager_names) {
+      auto it = lazy_members.find(eager_name.getKey());
+      if (it == lazy_members.end())
+        continue;
+      for (const DWARFDIE &member_die : it->second)
+        (member_die.Tag() == DW_TAG_subprogram ? member_function_dies
+                                               : contained_type_dies)
+            .push_back(member_die);
+      lazy_members.erase(it);
+    }
+  }
+
   // Now parse any methods if there were any...
   for (const DWARFDIE &die : member_function_dies)
     dwarf->ResolveType(die);
@@ -2148,9 +2211,48 @@ bool DWARFASTParserClang::CompleteRecordType(const DWARFDIE &die,
   for (const DWARFDIE &die : contained_type_dies)
     dwarf->ResolveType(die);
 
+  if (record_decl && !lazy_members.empty()) {
+    // Have Clang ask for the names of the members that were left out.
+    record_decl->setHasExternalVisibleStorage(true);
+    m_lazy_members[record_decl] = std::move(lazy_members);
+  }
+
   return (bool)clang_type;
 }
 
+bool DWARFASTParserClang::ParseLazyMembers(
+    clang::CXXRecordDecl *record_decl, std::optional<llvm::StringRef> name) {
+  SymbolFile *sym_file = m_ast.GetSymbolFile();
+  if (!sym_file)
+    return false;
+  std::lock_guard<std::recursive_mutex> guard(sym_file->GetModuleMutex());
+
+  auto it = m_lazy_members.find(record_decl);
+  if (it == m_lazy_members.end())
+    return false;
+
+  // Take the DIEs out of the map first, as parsing them may look up more
+  // names in the record.
+  std::vector<DWARFDIE> member_dies;
+  if (name) {
+    auto name_it = it->second.find(*name);
+    if (name_it == it->second.end())
+      return false;
+    member_dies = std::move(name_it->second);
+    it->second.erase(name_it);
+  } else {
+    for (auto &entry : it->second)
+      llvm::append_range(member_dies, entry.second);
+    it->second.clear();
+  }
+  if (it->second.empty())
+    m_lazy_members.erase(it);
+
+  for (const DWARFDIE &member_die : member_dies)
+    member_die.ResolveType();
+  return !member_dies.empty();
+}
+
 bool DWARFASTParserClang::CompleteEnumType(const DWARFDIE &die,
                                            lldb_private::Type *type,
                                            const CompilerType &clang_type) {
@@ -2213,6 +2315,8 @@ void DWARFASTParserClang::EnsureAllDIEsInDeclContextHaveBeenParsed(
     lldb_private::CompilerDeclContext decl_context) {
   auto opaque_decl_ctx =
       (clang::DeclContext *)decl_context.GetOpaqueDeclContext();
+  if (auto *record_decl = llvm::dyn_cast<clang::CXXRecordDecl>(opaque_decl_ctx))
+    ParseLazyMembers(record_decl);
   for (auto it = m_decl_ctx_to_die.find(opaque_decl_ctx);
        it != m_decl_ctx_to_die.end() && it->first == opaque_decl_ctx;
        it = m_decl_ctx_to_die.erase(it))
@@ -14,6 +14,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 
 #include "DWARFASTParser.h"
 #include "DWARFDIE.h"
@@ -80,6 +81,15 @@ public:
 
   lldb_private::ClangASTImporter &GetClangASTImporter();
 
+  /// Parse the member functions and nested types which were left out when
+  /// \p record_decl was completed, see the "lazy-class-members" setting.
+  ///
+  /// \param name If set, only the members with this name are parsed.
+  ///
+  /// \return True if any member was parsed.
+  bool ParseLazyMembers(clang::CXXRecordDecl *record_decl,
+                        std::optional<llvm::StringRef> name = std::nullopt);
+
   /// Extracts an value for a given Clang integer type from a DWARFFormValue.
   ///
   /// \param int_type The Clang type that defines the bit size and signedness
@@ -138,6 +148,11 @@ protected:
   DIEToDeclContextMap m_die_to_decl_ctx;
   DeclContextToDIEMap m_decl_ctx_to_die;
   DIEToModuleMap m_die_to_module;
+  /// The DIEs of the members left out of the completed records, by name.
+  llvm::DenseMap<
+      const clang::CXXRecordDecl *,
+      llvm::StringMap<std::vector<lldb_private::plugin::dwarf::DWARFDIE>>>
+      m_lazy_members;
   std::unique_ptr<lldb_private::ClangASTImporter> m_clang_ast_importer_up;
   /// @}
 
@@ -693,12 +693,15 @@ void ManualDWARFIndex::IndexSet::Encode(DataEncoder &encoder) const {
 
 bool ManualDWARFIndex::Decode(const DataExtractor &data,
                               lldb::offset_t *offset_ptr,
-                              bool &signature_mismatch) {
+                              bool &signature_mismatch,
+                              bool match_uuid_only) {
   signature_mismatch = false;
   CacheSignature signature;
   if (!signature.Decode(data, offset_ptr))
     return false;
-  if (CacheSignature(m_dwarf->GetObjectFile()) != signature) {
+  CacheSignature expected(m_dwarf->GetObjectFile());
+  if (match_uuid_only ? expected.m_uuid != signature.m_uuid
+                      : expected != signature) {
     signature_mismatch = true;
     return false;
   }
@@ -752,32 +755,69 @@ std::string ManualDWARFIndex::GetCacheKey() {
   return key;
 }
 
+std::string ManualDWARFIndex::GetSharedCacheKey() {
+  ObjectFile *objfile = m_dwarf->GetObjectFile();
+  UUID uuid = objfile->GetUUID();
+  if (!uuid.IsValid())
+    return {};
+  // The main executable and its separate debug file share their UUID, so the
+  // type and strata of the object file are still part of the key.
+  std::string key;
+  llvm::raw_string_ostream strm(key);
+  strm << uuid.GetAsString("") << "-" << (uint32_t)objfile->GetType() << "-"
+       << (uint32_t)objfile->GetStrata() << "-dwarf-index-"
+       << (IsPartial() ? "partial" : "full");
+  return key;
+}
+
 bool ManualDWARFIndex::LoadFromCache() {
-  DataFileCache *cache = Module::GetIndexCache();
-  if (!cache)
-    return false;
   ObjectFile *objfile = m_dwarf->GetObjectFile();
   if (!objfile)
     return false;
-  std::unique_ptr<llvm::MemoryBuffer> mem_buffer_up =
-      cache->GetCachedData(GetCacheKey());
-  if (!mem_buffer_up)
+
+  auto load = [&](DataFileCache &cache, llvm::StringRef key,
+                  bool match_uuid_only) {
+    std::unique_ptr<llvm::MemoryBuffer> mem_buffer_up =
+        cache.GetCachedData(key);
+    if (!mem_buffer_up)
+      return false;
+    DataExtractor data(mem_buffer_up->getBufferStart(),
+                       mem_buffer_up->getBufferSize(),
+                       endian::InlHostByteOrder(),
+                       objfile->GetAddressByteSize());
+    bool signature_mismatch = false;
+    lldb::offset_t offset = 0;
+    const bool result =
+        Decode(data, &offset, signature_mismatch, match_uuid_only);
+    if (signature_mismatch)
+      cache.RemoveCacheFile(key);
+    return result;
+  };
+
+  if (DataFileCache *cache = Module::GetIndexCache())
+    if (load(*cache, GetCacheKey(), /*match_uuid_only=*/false))
+      return true;
+
+  DataFileCache *shared_cache = SymbolFileDWARF::GetSharedIndexCache();
+  if (!shared_cache)
     return false;
-  DataExtractor data(mem_buffer_up->getBufferStart(),
-                     mem_buffer_up->getBufferSize(),
-                     endian::InlHostByteOrder(),
-                     objfile->GetAddressByteSize());
-  bool signature_mismatch = false;
-  lldb::offset_t offset = 0;
-  const bool result = Decode(data, &offset, signature_mismatch);
-  if (signature_mismatch)
-    cache->RemoveCacheFile(GetCacheKey());
-  return result;
+  std::string shared_key = GetSharedCacheKey();
+  if (shared_key.empty() ||
+      !load(*shared_cache, shared_key, /*match_uuid_only=*/true))
+    return false;
+  // Keep a local copy, which is validated with the modification times.
+  if (DataFileCache *cache = Module::GetIndexCache()) {
+    DataEncoder file(endian::InlHostByteOrder(), objfile->GetAddressByteSize());
+    if (Encode(file))
+      cache->SetCachedData(GetCacheKey(), file.GetData());
+  }
+  return true;
 }
 
 void ManualDWARFIndex::SaveToCache() {
   DataFileCache *cache = Module::GetIndexCache();
-  if (!cache)
+  DataFileCache *shared_cache = SymbolFileDWARF::GetSharedIndexCache();
+  if (!cache && !shared_cache)
     return; // Caching is not enabled.
   ObjectFile *objfile = m_dwarf->GetObjectFile();
   if (!objfile)
@@ -785,8 +825,13 @@ void ManualDWARFIndex::SaveToCache() {
   DataEncoder file(endian::InlHostByteOrder(), objfile->GetAddressByteSize());
   // Encode will return false if the object file doesn't have anything to make
   // a signature from.
-  if (Encode(file)) {
-    if (cache->SetCachedData(GetCacheKey(), file.GetData()))
-      m_dwarf->SetDebugInfoIndexWasSavedToCache();
+  if (!Encode(file))
+    return;
+  if (cache && cache->SetCachedData(GetCacheKey(), file.GetData()))
+    m_dwarf->SetDebugInfoIndexWasSavedToCache();
+  if (shared_cache) {
+    std::string shared_key = GetSharedCacheKey();
+    if (!shared_key.empty())
+      shared_cache->SetCachedData(shared_key, file.GetData());
   }
 }
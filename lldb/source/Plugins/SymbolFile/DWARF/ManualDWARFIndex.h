@@ -97,8 +97,12 @@ private:
   ///   All strings in cache files are put into string tables for efficiency
   ///   and cache file size reduction. Strings are stored as uint32_t string
   ///   table offsets in the cache data.
+  ///
+  /// \param match_uuid_only
+  ///   If true, only the UUID of the signature needs to match, as for the
+  ///   entries of the shared index cache.
   bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
-              bool &signature_mismatch);
+              bool &signature_mismatch, bool match_uuid_only = false);
 
   /// Encode this object into a data encoder object.
   ///
@@ -132,6 +136,15 @@ private:
   ///   cache.
   std::string GetCacheKey();
 
+  /// Get the key of this index in the shared index cache.
+  ///
+  /// Unlike GetCacheKey(), this key doesn't depend on the path of the object
+  /// file, so that indexes can be shared by all the copies of a binary.
+  ///
+  /// \return
+  ///   The key, or an empty string if the object file has no UUID.
+  std::string GetSharedCacheKey();
+
   /// Save the symbol table data out into a cache.
   ///
   /// The symbol table will only be saved to a cache file if caching is enabled.
@@ -155,7 +168,8 @@ private:
   /// time when the debugger starts up. The index cache file for the symbol
   /// table has the modification time set to the same time as the main module.
   /// If the cache file exists and the modification times match, we will load
-  /// the symbol table from the serlized cache file.
+  /// the symbol table from the serlized cache file. Indexes missing from the
+  /// index cache are then looked up in the shared index cache, if any.
   ///
   /// \return
   ///   True if the symbol table was successfully loaded from the index cache,
@@ -17,6 +17,7 @@
 #include "llvm/Support/FormatAdapters.h"
 #include "llvm/Support/Threading.h"
 
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
@@ -131,6 +132,14 @@ public:
   bool IgnoreFileIndexes() const {
     return GetPropertyAtIndexAs<bool>(ePropertyIgnoreIndexes, false);
   }
+
+  bool LazyClassMembers() const {
+    return GetPropertyAtIndexAs<bool>(ePropertyLazyClassMembers, false);
+  }
+
+  FileSpec GetSharedIndexCachePath() const {
+    return GetPropertyAtIndexAs<FileSpec>(ePropertySharedIndexCachePath, {});
+  }
 };
 
 } // namespace
@@ -145,6 +154,31 @@ static PluginProperties &GetGlobalPluginProperties() {
   return g_settings;
 }
 
+bool SymbolFileDWARF::GetLazyClassMembers() {
+  return GetGlobalPluginProperties().LazyClassMembers();
+}
+
+DataFileCache *SymbolFileDWARF::GetSharedIndexCache() {
+  static std::mutex g_mutex;
+  static std::string g_path;
+  static std::unique_ptr<DataFileCache> g_cache_up;
+
+  std::lock_guard<std::mutex> guard(g_mutex);
+  std::string path =
+      GetGlobalPluginProperties().GetSharedIndexCachePath().GetPath();
+  if (path.empty()) {
+    g_cache_up.reset();
+  } else if (!g_cache_up || path != g_path) {
+    // The entries of a shared cache may be produced by other machines, so
+    // they are never pruned from here.
+    llvm::CachePruningPolicy policy;
+    policy.Interval = std::nullopt;
+    g_cache_up = std::make_unique<DataFileCache>(path, policy);
+  }
+  g_path = std::move(path);
+  return g_cache_up.get();
+}
+
 static const llvm::DWARFDebugLine::LineTable *
 ParseLLVMLineTable(DWARFContext &context, llvm::DWARFDebugLine &line,
                    dw_offset_t line_offset, dw_offset_t unit_offset) {
@@ -94,6 +94,15 @@ public:
 
   static llvm::StringRef GetPluginDescriptionStatic();
 
+  /// Return true if the member functions and nested types of C++ classes
+  /// should only be parsed when they are looked up.
+  static bool GetLazyClassMembers();
+
+  /// Return the cache set by the "shared-index-cache-path" setting, or null if
+  /// it isn't set. Unlike the LLDB index cache, its entries are only keyed by
+  /// the UUID of the object files, so they can be created on other machines.
+  static DataFileCache *GetSharedIndexCache();
+
   static SymbolFile *CreateInstance(lldb::ObjectFileSP objfile_sp);
 
   // Constructors and Destructors
@@ -2431,15 +2431,21 @@ bool TypeSystemClang::GetCompleteDecl(clang::ASTContext *ast,
     return false;
 
   if (clang::TagDecl *tag_decl = llvm::dyn_cast<clang::TagDecl>(decl)) {
-    if (tag_decl->isCompleteDefinition())
-      return true;
+    if (!tag_decl->isCompleteDefinition()) {
+      if (!tag_decl->hasExternalLexicalStorage())
+        return false;
 
-    if (!tag_decl->hasExternalLexicalStorage())
-      return false;
+      ast_source->CompleteType(tag_decl);
 
-    ast_source->CompleteType(tag_decl);
+      if (tag_decl->getTypeForDecl()->isIncompleteType())
+        return false;
+    }
 
-    return !tag_decl->getTypeForDecl()->isIncompleteType();
+    // The definition is about to be copied, which needs all of its members.
+    if (auto *record_decl = llvm::dyn_cast<clang::CXXRecordDecl>(tag_decl))
+      if (TypeSystemClang *ts = GetASTContext(ast))
+        ts->ParseLazyMembers(record_decl);
+    return true;
   } else if (clang::ObjCInterfaceDecl *objc_interface_decl =
                  llvm::dyn_cast<clang::ObjCInterfaceDecl>(decl)) {
     if (objc_interface_decl->getDefinition())
@@ -4400,9 +4406,11 @@ TypeSystemClang::GetNumMemberFunctions(lldb::opaque_compiler_type_t type) {
         assert(record_decl);
         const clang::CXXRecordDecl *cxx_record_decl =
             llvm::dyn_cast<clang::CXXRecordDecl>(record_decl);
-        if (cxx_record_decl)
+        if (cxx_record_decl) {
+          ParseLazyMembers(const_cast<clang::CXXRecordDecl *>(cxx_record_decl));
           num_functions = std::distance(cxx_record_decl->method_begin(),
                                         cxx_record_decl->method_end());
+        }
       }
       break;
 
@@ -4465,6 +4473,7 @@ TypeSystemClang::GetMemberFunctionAtIndex(lldb::opaque_compiler_type_t type,
         const clang::CXXRecordDecl *cxx_record_decl =
             llvm::dyn_cast<clang::CXXRecordDecl>(record_decl);
         if (cxx_record_decl) {
+          ParseLazyMembers(const_cast<clang::CXXRecordDecl *>(cxx_record_decl));
           auto method_iter = cxx_record_decl->method_begin();
           auto method_end = cxx_record_decl->method_end();
           if (idx <
@@ -9059,6 +9068,13 @@ void TypeSystemClang::CompleteObjCInterfaceDecl(
   }
 }
 
+bool TypeSystemClang::ParseLazyMembers(clang::CXXRecordDecl *decl,
+                                       std::optional<llvm::StringRef> name) {
+  if (!m_dwarf_ast_parser_up)
+    return false;
+  return m_dwarf_ast_parser_up->ParseLazyMembers(decl, name);
+}
+
 DWARFASTParser *TypeSystemClang::GetDWARFParser() {
   if (!m_dwarf_ast_parser_up)
     m_dwarf_ast_parser_up = std::make_unique<DWARFASTParserClang>(*this);
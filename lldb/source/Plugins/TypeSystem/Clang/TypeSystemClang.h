@@ -529,6 +529,14 @@ public:
 
   void CompleteObjCInterfaceDecl(clang::ObjCInterfaceDecl *);
 
+  /// Parse the members of the completed \p decl which the symbol file only
+  /// parses when they are looked up. If \p name is set, only the members with
+  /// this name are parsed.
+  ///
+  /// \return True if any member was parsed.
+  bool ParseLazyMembers(clang::CXXRecordDecl *decl,
+                        std::optional<llvm::StringRef> name = std::nullopt);
+
   bool LayoutRecordType(
       const clang::RecordDecl *record_decl, uint64_t &size, uint64_t &alignment,
       llvm::DenseMap<const clang::FieldDecl *, uint64_t> &field_offsets,
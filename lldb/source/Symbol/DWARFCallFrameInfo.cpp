@@ -184,9 +184,16 @@ bool DWARFCallFrameInfo::GetAddressRange(Address addr, AddressRange &range) {
 
   if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
     return false;
-  GetFDEIndex();
-  FDEEntryMap::Entry *fde_entry =
-      m_fde_index.FindEntryThatContains(addr.GetFileAddress());
+  const addr_t file_addr = addr.GetFileAddress();
+  std::optional<FDEEntryMap::Entry> fde_entry;
+  if (!m_fde_index_initialized && GetEHFrameHdrTable()) {
+    fde_entry = FindFDEInEHFrameHdr(file_addr, 1);
+  } else {
+    GetFDEIndex();
+    if (const FDEEntryMap::Entry *entry =
+            m_fde_index.FindEntryThatContains(file_addr))
+      fde_entry = *entry;
+  }
   if (!fde_entry)
     return false;
 
@@ -200,9 +207,14 @@ DWARFCallFrameInfo::GetFirstFDEEntryInRange(const AddressRange &range) {
   if (!m_section_sp || m_section_sp->IsEncrypted())
     return std::nullopt;
 
+  addr_t start_file_addr = range.GetBaseAddress().GetFileAddress();
+  // Unless the section was indexed already, a binary search in .eh_frame_hdr
+  // is much cheaper than scanning all the FDEs.
+  if (!m_fde_index_initialized && GetEHFrameHdrTable())
+    return FindFDEInEHFrameHdr(start_file_addr, range.GetByteSize());
+
   GetFDEIndex();
 
-  addr_t start_file_addr = range.GetBaseAddress().GetFileAddress();
   const FDEEntryMap::Entry *fde =
       m_fde_index.FindEntryThatContainsOrFollows(start_file_addr);
   if (fde && fde->DoesIntersect(
@@ -467,15 +479,19 @@ void DWARFCallFrameInfo::GetFDEIndex() {
     // variable cie_offset should be equal to cie_id for debug_frame.
     // FDE entries with cie_id == 0 shouldn't be ignored for it.
     if ((cie_id == 0 && m_type == EH) || cie_id == UINT32_MAX || len == 0) {
-      auto cie_sp = ParseCIE(current_entry);
-      if (!cie_sp) {
-        // Cannot parse, the reason is already logged
-        m_fde_index.Clear();
-        m_fde_index_initialized = true;
-        return;
-      }
+      // The CIE may have been parsed already by an .eh_frame_hdr lookup, and
+      // be in use by another thread.
+      if (!m_cie_map.count(current_entry)) {
+        auto cie_sp = ParseCIE(current_entry);
+        if (!cie_sp) {
+          // Cannot parse, the reason is already logged
+          m_fde_index.Clear();
+          m_fde_index_initialized = true;
+          return;
+        }
 
-      m_cie_map[current_entry] = std::move(cie_sp);
+        m_cie_map[current_entry] = std::move(cie_sp);
+      }
       offset = next_entry;
       continue;
     }
@@ -522,6 +538,148 @@ void DWARFCallFrameInfo::GetFDEIndex() {
   m_fde_index_initialized = true;
 }
 
+bool DWARFCallFrameInfo::GetEHFrameHdrTable() {
+  if (m_type != EH || !m_section_sp || m_section_sp->IsEncrypted())
+    return false;
+
+  std::call_once(m_eh_frame_hdr_once, [this] {
+    SectionList *section_list = m_objfile.GetSectionList();
+    if (!section_list)
+      return;
+    SectionSP hdr_sp =
+        section_list->FindSectionByName(ConstString(".eh_frame_hdr"));
+    if (!hdr_sp || hdr_sp->IsEncrypted() ||
+        !m_objfile.ReadSectionData(hdr_sp.get(), m_eh_frame_hdr_data))
+      return;
+
+    // The header is made of the version, the encodings of the eh_frame
+    // pointer, of the FDE count and of the table entries, and then of the
+    // eh_frame pointer and of the FDE count themselves.
+    const addr_t hdr_addr = hdr_sp->GetFileAddress();
+    lldb::offset_t offset = 0;
+    if (!m_eh_frame_hdr_data.ValidOffsetForDataOfSize(offset, 4))
+      return;
+    const uint8_t version = m_eh_frame_hdr_data.GetU8(&offset);
+    const uint8_t eh_frame_ptr_enc = m_eh_frame_hdr_data.GetU8(&offset);
+    const uint8_t fde_count_enc = m_eh_frame_hdr_data.GetU8(&offset);
+    const uint8_t table_enc = m_eh_frame_hdr_data.GetU8(&offset);
+    // Only the table entries made of two 4-byte offsets from the start of the
+    // section, which are the ones linkers emit, can be binary searched.
+    if (version != 1 || eh_frame_ptr_enc == DW_EH_PE_omit ||
+        fde_count_enc == DW_EH_PE_omit ||
+        table_enc != (DW_EH_PE_datarel | DW_EH_PE_sdata4))
+      return;
+
+    const addr_t eh_frame_addr =
+        GetGNUEHPointer(m_eh_frame_hdr_data, &offset, eh_frame_ptr_enc,
+                        hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+    const uint64_t fde_count =
+        GetGNUEHPointer(m_eh_frame_hdr_data, &offset, fde_count_enc, hdr_addr,
+                        LLDB_INVALID_ADDRESS, hdr_addr);
+    // Don't trust a table which describes another section, or which doesn't
+    // fit in its own.
+    if (eh_frame_addr != m_section_sp->GetFileAddress() ||
+        fde_count > UINT32_MAX ||
+        !m_eh_frame_hdr_data.ValidOffsetForDataOfSize(offset, fde_count * 8))
+      return;
+
+    m_eh_frame_hdr_addr = hdr_addr;
+    m_eh_frame_hdr_table_offset = offset;
+    m_eh_frame_hdr_fde_count = fde_count;
+    m_eh_frame_hdr_valid = true;
+  });
+  return m_eh_frame_hdr_valid;
+}
+
+std::optional<DWARFCallFrameInfo::FDEEntryMap::Entry>
+DWARFCallFrameInfo::FindFDEInEHFrameHdr(addr_t start_addr, addr_t size) {
+  auto get_table_entry = [this](uint32_t idx, addr_t &initial_loc,
+                                addr_t &fde_addr) {
+    lldb::offset_t offset = m_eh_frame_hdr_table_offset + idx * 8ull;
+    initial_loc =
+        m_eh_frame_hdr_addr + (int32_t)m_eh_frame_hdr_data.GetU32(&offset);
+    fde_addr =
+        m_eh_frame_hdr_addr + (int32_t)m_eh_frame_hdr_data.GetU32(&offset);
+  };
+
+  // Find the first entry which starts after start_addr.
+  uint32_t lo = 0;
+  uint32_t hi = m_eh_frame_hdr_fde_count;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    addr_t initial_loc, fde_addr;
+    get_table_entry(mid, initial_loc, fde_addr);
+    if (initial_loc <= start_addr)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  // Either the previous entry contains start_addr, or the range intersects
+  // the next one.
+  const FDEEntryMap::Range range(start_addr, size);
+  const addr_t eh_frame_addr = m_section_sp->GetFileAddress();
+  for (uint32_t idx = lo > 0 ? lo - 1 : 0;
+       idx <= lo && idx < m_eh_frame_hdr_fde_count; ++idx) {
+    addr_t initial_loc, fde_addr;
+    get_table_entry(idx, initial_loc, fde_addr);
+    if (fde_addr < eh_frame_addr)
+      return std::nullopt;
+    std::optional<FDEEntryMap::Entry> fde =
+        ParseFDEEntry(fde_addr - eh_frame_addr);
+    if (fde && fde->DoesIntersect(range))
+      return fde;
+  }
+  return std::nullopt;
+}
+
+std::optional<DWARFCallFrameInfo::FDEEntryMap::Entry>
+DWARFCallFrameInfo::ParseFDEEntry(dw_offset_t fde_offset) {
+  std::lock_guard<std::mutex> guard(m_fde_index_mutex);
+
+  if (!m_cfi_data_initialized)
+    GetCFIData();
+
+  lldb::offset_t offset = fde_offset;
+  if (!m_cfi_data.ValidOffsetForDataOfSize(offset, 8))
+    return std::nullopt;
+  dw_offset_t cie_id, cie_offset;
+  uint32_t len = m_cfi_data.GetU32(&offset);
+  if (len == UINT32_MAX) {
+    len = m_cfi_data.GetU64(&offset);
+    cie_id = m_cfi_data.GetU64(&offset);
+    cie_offset = fde_offset + 12 - cie_id;
+  } else {
+    cie_id = m_cfi_data.GetU32(&offset);
+    cie_offset = fde_offset + 4 - cie_id;
+  }
+  // The table should only point to FDEs.
+  if (len == 0 || cie_id == 0 || cie_offset > m_cfi_data.GetByteSize())
+    return std::nullopt;
+
+  CIESP &cie_sp = m_cie_map[cie_offset];
+  if (!cie_sp)
+    cie_sp = ParseCIE(cie_offset);
+  if (!cie_sp) {
+    m_cie_map.erase(cie_offset);
+    return std::nullopt;
+  }
+
+  const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
+  lldb::addr_t addr =
+      GetGNUEHPointer(m_cfi_data, &offset, cie_sp->ptr_encoding, pc_rel_addr,
+                      LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS);
+  if (ArchSpec arch = m_objfile.GetArchitecture()) {
+    if (arch.GetTriple().getArch() == llvm::Triple::arm ||
+        arch.GetTriple().getArch() == llvm::Triple::thumb)
+      addr &= ~1ull;
+  }
+  lldb::addr_t length = GetGNUEHPointer(
+      m_cfi_data, &offset, cie_sp->ptr_encoding & DW_EH_PE_MASK_ENCODING,
+      pc_rel_addr, LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS);
+  return FDEEntryMap::Entry(addr, length, fde_offset);
+}
+
 bool DWARFCallFrameInfo::FDEToUnwindPlan(dw_offset_t dwarf_offset,
                                          Address startaddr,
                                          UnwindPlan &unwind_plan) {
@@ -6,10 +6,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <map>
+#include <optional>
 #include <set>
 
 #include "lldb/Core/DataFileCache.h"
+#include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/RichManglingContext.h"
 #include "lldb/Core/Section.h"
@@ -27,6 +30,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DJB.h"
+#include "llvm/Support/ThreadPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -278,6 +282,28 @@ static bool lldb_skip_name(llvm::StringRef mangled,
   llvm_unreachable("unknown scheme!");
 }
 
+std::optional<Symtab::MangledNameParts>
+Symtab::ParseMangledName(Symbol &symbol, RichManglingContext &rmc) {
+  Mangled &mangled = symbol.GetMangled();
+  if (!mangled.GetMangledName())
+    return std::nullopt;
+  const SymbolType type = symbol.GetType();
+  if (type != eSymbolTypeCode && type != eSymbolTypeResolver)
+    return std::nullopt;
+  if (!mangled.GetRichManglingInfo(rmc, lldb_skip_name))
+    return std::nullopt;
+
+  // Only register functions that have a base name.
+  MangledNameParts parts;
+  llvm::StringRef base_name = rmc.ParseFunctionBaseName();
+  if (base_name.empty())
+    return parts;
+  parts.base_name = ConstString(base_name);
+  parts.decl_context = ConstString(rmc.ParseFunctionDeclContextName());
+  parts.is_ctor_or_dtor = rmc.IsCtorOrDtor();
+  return parts;
+}
+
 void Symtab::InitNameIndexes() {
   // Protected function, no need to lock mutex...
   if (!m_name_indexes_computed) {
@@ -309,6 +335,39 @@ void Symtab::InitNameIndexes() {
     std::vector<std::pair<NameToIndexMap::Entry, const char *>> backlog;
     backlog.reserve(num_symbols / 2);
 
+    // Demangling is the most expensive part of the indexing. Large symbol
+    // tables demangle their names in parallel first, which only touches each
+    // symbol, and the indexes are then built from the results.
+    std::vector<std::optional<MangledNameParts>> mangled_parts;
+    const size_t num_threads = Debugger::GetThreadPool().getMaxConcurrency();
+    if (num_threads > 1 && num_symbols >= 16384) {
+      mangled_parts.resize(num_symbols);
+      const size_t chunk_size = 4096;
+      std::atomic<size_t> next_chunk = 0;
+      auto demangle_chunks = [&]() {
+        RichManglingContext rmc;
+        size_t begin;
+        while ((begin = next_chunk.fetch_add(
+                    chunk_size, std::memory_order_relaxed)) < num_symbols) {
+          const size_t end = std::min(begin + chunk_size, num_symbols);
+          for (size_t value = begin; value < end; ++value) {
+            Symbol &symbol = m_symbols[value];
+            if (symbol.IsTrampoline() ||
+                symbol.IsSyntheticWithAutoGeneratedName())
+              continue;
+            mangled_parts[value] = ParseMangledName(symbol, rmc);
+            // The demangled name is cached by the symbol.
+            if (!mangled_parts[value])
+              symbol.GetMangled().GetDemangledName();
+          }
+        }
+      };
+      llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+      for (size_t i = 0; i < num_threads; ++i)
+        task_group.async(demangle_chunks);
+      task_group.wait();
+    }
+
     // Instantiation of the demangler is expensive, so better use a single one
     // for all entries during batch processing.
     RichManglingContext rmc;
@@ -338,12 +397,12 @@ void Symtab::InitNameIndexes() {
           name_to_index.Append(stripped, value);
         }
 
-        const SymbolType type = symbol->GetType();
-        if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
-          if (mangled.GetRichManglingInfo(rmc, lldb_skip_name)) {
-            RegisterMangledNameEntry(value, class_contexts, backlog, rmc);
-            continue;
-          }
+        std::optional<MangledNameParts> parts =
+            mangled_parts.empty() ? ParseMangledName(*symbol, rmc)
+                                  : std::move(mangled_parts[value]);
+        if (parts) {
+          RegisterMangledNameEntry(value, class_contexts, backlog, *parts);
+          continue;
         }
       }
 
@@ -395,18 +454,16 @@ void Symtab::InitNameIndexes() {
 void Symtab::RegisterMangledNameEntry(
     uint32_t value, std::set<const char *> &class_contexts,
     std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-    RichManglingContext &rmc) {
+    const MangledNameParts &parts) {
   // Only register functions that have a base name.
-  llvm::StringRef base_name = rmc.ParseFunctionBaseName();
-  if (base_name.empty())
+  if (parts.base_name.IsEmpty())
     return;
 
   // The base name will be our entry's name.
-  NameToIndexMap::Entry entry(ConstString(base_name), value);
-  llvm::StringRef decl_context = rmc.ParseFunctionDeclContextName();
+  NameToIndexMap::Entry entry(parts.base_name, value);
 
   // Register functions with no context.
-  if (decl_context.empty()) {
+  if (parts.decl_context.IsEmpty()) {
     // This has to be a basename
     auto &basename_to_index =
         GetNameToSymbolIndexMap(lldb::eFunctionNameTypeBase);
@@ -420,14 +477,14 @@ void Symtab::RegisterMangledNameEntry(
 
   // Make sure we have a pool-string pointer and see if we already know the
   // context name.
-  const char *decl_context_ccstr = ConstString(decl_context).GetCString();
+  const char *decl_context_ccstr = parts.decl_context.GetCString();
   auto it = class_contexts.find(decl_context_ccstr);
 
   auto &method_to_index =
       GetNameToSymbolIndexMap(lldb::eFunctionNameTypeMethod);
   // Register constructors and destructors. They are methods and create
   // declaration contexts.
-  if (rmc.IsCtorOrDtor()) {
+  if (parts.is_ctor_or_dtor) {
     method_to_index.Append(entry);
     if (it == class_contexts.end())
       class_contexts.insert(it, decl_context_ccstr);
@@ -7,15 +7,20 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Target/Memory.h"
+#include "lldb/Core/Section.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
 #include "lldb/Utility/DataBufferHeap.h"
 #include "lldb/Utility/LLDBLog.h"
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/State.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <memory>
+#include <set>
+#include <vector>
 
 using namespace lldb;
 using namespace lldb_private;
@@ -24,7 +29,9 @@ using namespace lldb_private;
 MemoryCache::MemoryCache(Process &process)
     : m_mutex(), m_L1_cache(), m_L2_cache(), m_invalid_ranges(),
       m_process(process),
-      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()) {}
+      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()) {
+  UpdateSettings();
+}
 
 // Destructor
 MemoryCache::~MemoryCache() = default;
@@ -33,9 +40,107 @@ void MemoryCache::Clear(bool clear_invalid_ranges) {
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
   m_L1_cache.clear();
   m_L2_cache.clear();
+  m_L2_lru.clear();
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
+  m_read_ahead_lines = 1;
+  m_next_sequential_line = LLDB_INVALID_ADDRESS;
+  UpdateSettings();
+}
+
+void MemoryCache::ClearVolatileData() {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  if (!m_process.GetMemoryCacheKeepReadOnly() ||
+      m_process.GetMemoryCacheLineSize() != m_L2_cache_line_byte_size) {
+    Clear();
+    return;
+  }
+
+  // The lines of read-only sections are kept. They are checked again when
+  // they are used, as the section may get unloaded after the stop.
+  m_L1_cache.clear();
+  for (auto pos = m_L2_cache.begin(); pos != m_L2_cache.end();) {
+    if (pos->second.section_wp.expired())
+      pos = EraseL2CacheLine(pos);
+    else
+      ++pos;
+  }
+  m_read_ahead_lines = 1;
+  m_next_sequential_line = LLDB_INVALID_ADDRESS;
+  UpdateSettings();
+  if (m_L2_max_lines != 0) {
+    while (m_L2_cache.size() > m_L2_max_lines)
+      EraseL2CacheLine(m_L2_cache.find(m_L2_lru.back()));
+  }
+}
+
+void MemoryCache::UpdateSettings() {
   m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  m_L2_max_lines = m_process.GetMemoryCacheMaxLines();
+  m_max_read_ahead_lines =
+      std::max<uint64_t>(m_process.GetMemoryCacheReadAhead(), 1);
+  // Reading ahead more lines than can be cached would be wasted.
+  if (m_L2_max_lines != 0)
+    m_max_read_ahead_lines = std::min(m_max_read_ahead_lines, m_L2_max_lines);
+  m_keep_read_only_lines = m_process.GetMemoryCacheKeepReadOnly();
+}
+
+void MemoryCache::InsertL2CacheLine(lldb::addr_t line_base_addr,
+                                    const DataBufferSP &data_sp) {
+  auto [pos, inserted] = m_L2_cache.try_emplace(line_base_addr);
+  L2CacheLine &line = pos->second;
+  if (inserted) {
+    m_L2_lru.push_front(line_base_addr);
+    line.lru_pos = m_L2_lru.begin();
+  } else {
+    m_L2_lru.splice(m_L2_lru.begin(), m_L2_lru, line.lru_pos);
+  }
+  line.data_sp = data_sp;
+  line.section_wp.reset();
+  line.section_load_addr = LLDB_INVALID_ADDRESS;
+  // The missing part of a partial line may become readable later on.
+  if (m_keep_read_only_lines &&
+      data_sp->GetByteSize() == m_L2_cache_line_byte_size)
+    FindReadOnlySection(line_base_addr, line);
+
+  if (m_L2_max_lines == 0)
+    return;
+  while (m_L2_cache.size() > m_L2_max_lines)
+    EraseL2CacheLine(m_L2_cache.find(m_L2_lru.back()));
+}
+
+MemoryCache::L2BlockMap::iterator
+MemoryCache::EraseL2CacheLine(L2BlockMap::iterator pos) {
+  m_L2_lru.erase(pos->second.lru_pos);
+  return m_L2_cache.erase(pos);
+}
+
+void MemoryCache::FindReadOnlySection(lldb::addr_t line_base_addr,
+                                      L2CacheLine &line) {
+  Target &target = m_process.GetTarget();
+  Address so_addr;
+  if (!target.ResolveLoadAddress(line_base_addr, so_addr))
+    return;
+  SectionSP section_sp = so_addr.GetSection();
+  if (!section_sp || section_sp->IsThreadSpecific())
+    return;
+  const uint32_t permissions = section_sp->GetPermissions();
+  if (!(permissions & ePermissionsReadable) ||
+      (permissions & ePermissionsWritable))
+    return;
+  const addr_t section_load_addr = section_sp->GetLoadBaseAddress(&target);
+  if (section_load_addr == LLDB_INVALID_ADDRESS ||
+      line_base_addr + m_L2_cache_line_byte_size >
+          section_load_addr + section_sp->GetByteSize())
+    return;
+  line.section_wp = section_sp;
+  line.section_load_addr = section_load_addr;
+}
+
+bool MemoryCache::IsReadOnlySectionStillLoaded(const L2CacheLine &line) {
+  SectionSP section_sp = line.section_wp.lock();
+  return section_sp && section_sp->GetLoadBaseAddress(&m_process.GetTarget()) ==
+                           line.section_load_addr;
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -91,9 +196,9 @@ void MemoryCache::Flush(addr_t addr, size_t size) {
     uint32_t cache_idx = 0;
     for (addr_t curr_addr = first_cache_line_addr; cache_idx < num_cache_lines;
          curr_addr += cache_line_byte_size, ++cache_idx) {
-      BlockMap::iterator pos = m_L2_cache.find(curr_addr);
+      auto pos = m_L2_cache.find(curr_addr);
       if (pos != m_L2_cache.end())
-        m_L2_cache.erase(pos);
+        EraseL2CacheLine(pos);
     }
   }
 }
@@ -130,24 +235,68 @@ lldb::DataBufferSP MemoryCache::GetL2CacheLine(lldb::addr_t line_base_addr,
 
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
   auto pos = m_L2_cache.find(line_base_addr);
-  if (pos != m_L2_cache.end())
-    return pos->second;
+  if (pos != m_L2_cache.end()) {
+    // The lines kept across stops are only valid while their section stays
+    // loaded at the same address.
+    if (pos->second.section_load_addr == LLDB_INVALID_ADDRESS ||
+        IsReadOnlySectionStillLoaded(pos->second)) {
+      m_L2_lru.splice(m_L2_lru.begin(), m_L2_lru, pos->second.lru_pos);
+      return pos->second.data_sp;
+    }
+    EraseL2CacheLine(pos);
+  }
+
+  // Sequential misses, e.g. from formatters walking a string or an array,
+  // double the number of lines read at once. Any other miss resets it.
+  if (line_base_addr == m_next_sequential_line)
+    m_read_ahead_lines =
+        std::min(m_read_ahead_lines * 2, m_max_read_ahead_lines);
+  else
+    m_read_ahead_lines = 1;
+
+  // Don't read ahead into the lines which are cached already, into invalid
+  // ranges or past the end of the address space.
+  const uint64_t line_size = m_L2_cache_line_byte_size;
+  uint64_t num_lines = 1;
+  while (num_lines < m_read_ahead_lines) {
+    const addr_t next_line_addr = line_base_addr + num_lines * line_size;
+    if (next_line_addr < line_base_addr || m_L2_cache.count(next_line_addr) ||
+        m_invalid_ranges.FindEntryThatContains(next_line_addr))
+      break;
+    ++num_lines;
+  }
 
-  auto data_buffer_heap_sp =
-      std::make_shared<DataBufferHeap>(m_L2_cache_line_byte_size, 0);
+  std::vector<uint8_t> buffer(num_lines * line_size);
   size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-      line_base_addr, data_buffer_heap_sp->GetBytes(),
-      data_buffer_heap_sp->GetByteSize(), error);
+      line_base_addr, buffer.data(), buffer.size(), error);
+  // Some stubs fail the whole read when the memory past the requested line
+  // isn't readable.
+  if (process_bytes_read == 0 && num_lines > 1) {
+    num_lines = 1;
+    error.Clear();
+    process_bytes_read = m_process.ReadMemoryFromInferior(
+        line_base_addr, buffer.data(), line_size, error);
+  }
 
   // If we failed a read, not much we can do.
-  if (process_bytes_read == 0)
+  if (process_bytes_read == 0) {
+    m_next_sequential_line = LLDB_INVALID_ADDRESS;
     return lldb::DataBufferSP();
-
-  // If we didn't get a complete read, we can still cache what we did get.
-  if (process_bytes_read < m_L2_cache_line_byte_size)
-    data_buffer_heap_sp->SetByteSize(process_bytes_read);
-
-  m_L2_cache[line_base_addr] = data_buffer_heap_sp;
+  }
+  m_next_sequential_line = line_base_addr + num_lines * line_size;
+
+  // If we didn't get a complete read, we can still cache what we did get. The
+  // requested line is inserted last, so that it is the most recently used.
+  DataBufferSP data_buffer_heap_sp;
+  for (uint64_t idx = num_lines; idx-- > 0;) {
+    const size_t offset = idx * line_size;
+    if (offset >= process_bytes_read)
+      continue;
+    data_buffer_heap_sp = std::make_shared<DataBufferHeap>(
+        buffer.data() + offset,
+        std::min<size_t>(line_size, process_bytes_read - offset));
+    InsertL2CacheLine(line_base_addr + offset, data_buffer_heap_sp);
+  }
   return data_buffer_heap_sp;
 }
 
@@ -265,6 +414,59 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   return dst_len;
 }
 
+void MemoryCache::Prefetch(llvm::ArrayRef<Range<addr_t, size_t>> ranges) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+
+  // Reads larger than a cache line are served from the L1 cache, so these
+  // ranges are read as is. The others are served from the L2 cache lines
+  // they touch.
+  std::vector<Range<addr_t, size_t>> requests;
+  std::set<addr_t> missing_lines;
+  for (const Range<addr_t, size_t> &range : ranges) {
+    const addr_t addr = range.GetRangeBase();
+    const size_t size = range.GetByteSize();
+    if (size == 0 || m_invalid_ranges.FindEntryThatContains(addr))
+      continue;
+    if (size > m_L2_cache_line_byte_size) {
+      requests.push_back(range);
+      continue;
+    }
+    for (addr_t line_base_addr = addr - addr % m_L2_cache_line_byte_size;
+         line_base_addr < addr + size;
+         line_base_addr += m_L2_cache_line_byte_size) {
+      if (!m_L2_cache.count(line_base_addr) &&
+          !m_invalid_ranges.FindEntryThatContains(line_base_addr))
+        missing_lines.insert(line_base_addr);
+    }
+  }
+  const size_t num_l1_requests = requests.size();
+  for (addr_t line_base_addr : missing_lines)
+    requests.emplace_back(line_base_addr, m_L2_cache_line_byte_size);
+  if (requests.empty())
+    return;
+
+  size_t total_size = 0;
+  for (const Range<addr_t, size_t> &request : requests)
+    total_size += request.GetByteSize();
+  std::vector<uint8_t> buffer(total_size);
+  std::vector<size_t> bytes_read =
+      m_process.ReadMemoryRangesFromInferior(requests, buffer.data());
+
+  const uint8_t *request_buf = buffer.data();
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const addr_t addr = requests[i].GetRangeBase();
+    // As in GetL2CacheLine, partial reads are cached too.
+    if (bytes_read[i] > 0) {
+      if (i < num_l1_requests)
+        AddL1CacheData(addr, request_buf, bytes_read[i]);
+      else
+        InsertL2CacheLine(
+            addr, std::make_shared<DataBufferHeap>(request_buf, bytes_read[i]));
+    }
+    request_buf += requests[i].GetByteSize();
+  }
+}
+
 AllocatedBlock::AllocatedBlock(lldb::addr_t addr, uint32_t byte_size,
                                uint32_t permissions, uint32_t chunk_size)
     : m_range(addr, byte_size), m_permissions(permissions),
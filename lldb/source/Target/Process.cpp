@@ -200,6 +200,24 @@ uint64_t ProcessProperties::GetMemoryCacheLineSize() const {
       idx, g_process_properties[idx].default_uint_value);
 }
 
+uint64_t ProcessProperties::GetMemoryCacheMaxLines() const {
+  const uint32_t idx = ePropertyMemCacheMaxLines;
+  return GetPropertyAtIndexAs<uint64_t>(
+      idx, g_process_properties[idx].default_uint_value);
+}
+
+uint64_t ProcessProperties::GetMemoryCacheReadAhead() const {
+  const uint32_t idx = ePropertyMemCacheReadAhead;
+  return GetPropertyAtIndexAs<uint64_t>(
+      idx, g_process_properties[idx].default_uint_value);
+}
+
+bool ProcessProperties::GetMemoryCacheKeepReadOnly() const {
+  const uint32_t idx = ePropertyMemCacheKeepReadOnly;
+  return GetPropertyAtIndexAs<bool>(
+      idx, g_process_properties[idx].default_uint_value != 0);
+}
+
 Args ProcessProperties::GetExtraStartupCommands() const {
   Args args;
   const uint32_t idx = ePropertyExtraStartCommand;
@@ -1478,7 +1496,7 @@ void Process::SetPrivateState(StateType new_state) {
 
       if (!m_mod_id.IsLastResumeForUserExpression())
         m_mod_id.SetStopEventForLastNaturalStopID(event_sp);
-      m_memory_cache.Clear();
+      m_memory_cache.ClearVolatileData();
       LLDB_LOGF(log, "(plugin = %s, state = %s, stop_id = %u",
                GetPluginName().data(), StateAsCString(new_state),
                m_mod_id.GetStopID());
@@ -2214,6 +2232,67 @@ size_t Process::ReadMemoryFromInferior(addr_t addr, void *buf, size_t size,
   return bytes_read;
 }
 
+std::vector<size_t> Process::ReadMemoryRangesFromInferior(
+    llvm::ArrayRef<Range<addr_t, size_t>> ranges, uint8_t *buf) {
+  LLDB_SCOPED_TIMER();
+
+  std::vector<Range<addr_t, size_t>> fixed_ranges(ranges.begin(),
+                                                  ranges.end());
+  if (ABISP abi_sp = GetABI())
+    for (Range<addr_t, size_t> &range : fixed_ranges)
+      range.SetRangeBase(abi_sp->FixAnyAddress(range.GetRangeBase()));
+
+  std::vector<size_t> bytes_read = DoReadMemoryRanges(fixed_ranges, buf);
+
+  // Replace any software breakpoint opcodes that fall into these ranges back
+  // into "buf" before we return
+  uint8_t *range_buf = buf;
+  for (size_t i = 0; i < fixed_ranges.size(); ++i) {
+    if (bytes_read[i] > 0)
+      RemoveBreakpointOpcodesFromBuffer(fixed_ranges[i].GetRangeBase(),
+                                        bytes_read[i], range_buf);
+    range_buf += fixed_ranges[i].GetByteSize();
+  }
+  return bytes_read;
+}
+
+std::vector<size_t>
+Process::DoReadMemoryRanges(llvm::ArrayRef<Range<addr_t, size_t>> ranges,
+                            uint8_t *buf) {
+  std::vector<size_t> bytes_read;
+  bytes_read.reserve(ranges.size());
+  for (const Range<addr_t, size_t> &range : ranges) {
+    const addr_t addr = range.GetRangeBase();
+    const size_t size = range.GetByteSize();
+    size_t range_bytes_read = 0;
+    while (range_bytes_read < size) {
+      Status error;
+      const size_t curr_size = size - range_bytes_read;
+      const size_t curr_bytes_read =
+          DoReadMemory(addr + range_bytes_read, buf + range_bytes_read,
+                       curr_size, error);
+      range_bytes_read += curr_bytes_read;
+      if (curr_bytes_read == curr_size || curr_bytes_read == 0)
+        break;
+    }
+    bytes_read.push_back(range_bytes_read);
+    buf += size;
+  }
+  return bytes_read;
+}
+
+void Process::PrefetchMemory(llvm::ArrayRef<Range<addr_t, size_t>> ranges) {
+  if (GetDisableMemoryCache() || ranges.empty())
+    return;
+
+  std::vector<Range<addr_t, size_t>> fixed_ranges(ranges.begin(),
+                                                  ranges.end());
+  if (ABISP abi_sp = GetABI())
+    for (Range<addr_t, size_t> &range : fixed_ranges)
+      range.SetRangeBase(abi_sp->FixAnyAddress(range.GetRangeBase()));
+  m_memory_cache.Prefetch(fixed_ranges);
+}
+
 uint64_t Process::ReadUnsignedIntegerFromMemory(lldb::addr_t vm_addr,
                                                 size_t integer_byte_size,
                                                 uint64_t fail_value,
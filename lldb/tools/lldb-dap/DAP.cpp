@@ -38,7 +38,7 @@ DAP::DAP(llvm::StringRef path, ReplMode repl_mode)
       stop_at_entry(false), is_attach(false),
       enable_auto_variable_summaries(false),
       enable_synthetic_child_debugging(false),
-      display_extended_backtrace(false),
+      display_extended_backtrace(false), enable_request_telemetry(false),
       restarting_process_id(LLDB_INVALID_PROCESS_ID),
       configuration_done_sent(false), waiting_for_run_in_terminal(false),
       progress_event_reporter(
@@ -329,6 +329,21 @@ void DAP::SendOutput(OutputType o, const llvm::StringRef output) {
   } while (idx < output.size());
 }
 
+// Report the time taken by a request, so that clients can find the slow
+// formatters, or the requests which would benefit from being paged.
+void DAP::SendRequestTelemetry(llvm::StringRef command, int64_t seq,
+                               double seconds) {
+  llvm::json::Object event(CreateEventObject("output"));
+  llvm::json::Object body;
+  body.try_emplace("category", "telemetry");
+  body.try_emplace("output", "request");
+  body.try_emplace("data", llvm::json::Object{{"command", command},
+                                              {"seq", seq},
+                                              {"duration", seconds}});
+  event.try_emplace("body", std::move(body));
+  SendJSON(llvm::json::Value(std::move(event)));
+}
+
 // interface ProgressStartEvent extends Event {
 //   event: 'progressStart';
 //
@@ -699,7 +714,18 @@ bool DAP::HandleObject(const llvm::json::Object &object) {
       return false; // Fail
     }
 
+    const auto start = std::chrono::steady_clock::now();
     handler_pos->second(*this, object);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (log)
+      *log << llvm::formatv("request \"{0}\" took {1:f6}s", command,
+                            elapsed.count())
+                  .str()
+           << std::endl;
+    if (enable_request_telemetry)
+      SendRequestTelemetry(command, GetSigned(object, "seq", 0),
+                           elapsed.count());
     return true; // Success
   }
 
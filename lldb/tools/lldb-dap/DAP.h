@@ -172,6 +172,8 @@ struct DAP {
   bool enable_auto_variable_summaries;
   bool enable_synthetic_child_debugging;
   bool display_extended_backtrace;
+  // Report the time taken by each request as a telemetry output event.
+  bool enable_request_telemetry;
   // The process event thread normally responds to process exited events by
   // shutting down the entire adapter. When we're restarting, we keep the id of
   // the old process here so we can detect this case and keep running.
@@ -213,6 +215,10 @@ struct DAP {
 
   void SendOutput(OutputType o, const llvm::StringRef output);
 
+  /// Send a "telemetry" output event with the duration of a request.
+  void SendRequestTelemetry(llvm::StringRef command, int64_t seq,
+                            double seconds);
+
   void SendProgressEvent(uint64_t progress_id, const char *message,
                          uint64_t completed, uint64_t total);
 
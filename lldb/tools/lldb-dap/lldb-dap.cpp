@@ -787,6 +787,8 @@ void request_attach(DAP &dap, const llvm::json::Object &request) {
       GetBoolean(arguments, "enableAutoVariableSummaries", false);
   dap.enable_synthetic_child_debugging =
       GetBoolean(arguments, "enableSyntheticChildDebugging", false);
+  dap.enable_request_telemetry =
+      GetBoolean(arguments, "enableRequestTelemetry", false);
   dap.display_extended_backtrace =
       GetBoolean(arguments, "displayExtendedBacktrace", false);
   dap.command_escape_prefix = GetString(arguments, "commandEscapePrefix", "`");
@@ -2189,6 +2191,8 @@ void request_launch(DAP &dap, const llvm::json::Object &request) {
       GetBoolean(arguments, "enableAutoVariableSummaries", false);
   dap.enable_synthetic_child_debugging =
       GetBoolean(arguments, "enableSyntheticChildDebugging", false);
+  dap.enable_request_telemetry =
+      GetBoolean(arguments, "enableRequestTelemetry", false);
   dap.display_extended_backtrace =
       GetBoolean(arguments, "displayExtendedBacktrace", false);
   dap.command_escape_prefix = GetString(arguments, "commandEscapePrefix", "`");
@@ -3941,7 +3945,6 @@ void request_variables(DAP &dap, const llvm::json::Object &request) {
           GetTopLevelScope(dap, variablesReference)) {
     // variablesReference is one of our scopes, not an actual variable it is
     // asking for the list of args, locals or globals.
-    int64_t start_idx = 0;
     int64_t num_children = 0;
 
     if (variablesReference == VARREF_REGS) {
@@ -3989,11 +3992,16 @@ void request_variables(DAP &dap, const llvm::json::Object &request) {
         variables.emplace_back(std::move(object));
       }
     }
-    const int64_t end_idx = start_idx + ((count == 0) ? num_children : count);
-
-    // We first find out which variable names are duplicated
+    // Only create the variables of the requested page, as creating them
+    // formats their values and summaries, which can be slow.
+    const int64_t start_idx = std::clamp<int64_t>(start, 0, num_children);
+    const int64_t end_idx =
+        count == 0 ? num_children : std::min(start_idx + count, num_children);
+
+    // We first find out which variable names are duplicated. Look at the whole
+    // scope so that the names don't depend on the page size.
     std::map<std::string, int> variable_name_counts;
-    for (auto i = start_idx; i < end_idx; ++i) {
+    for (int64_t i = 0; i < num_children; ++i) {
       lldb::SBValue variable = top_scope->GetValueAtIndex(i);
       if (!variable.IsValid())
         break;
@@ -4031,7 +4039,11 @@ void request_variables(DAP &dap, const llvm::json::Object &request) {
             dap.enable_synthetic_child_debugging,
             /*is_name_duplicated=*/false, custom_name));
       };
-      const int64_t num_children = variable.GetNumChildren();
+      // Counting the children of some synthetic values requires walking all
+      // of them, so only count past the end of the requested page.
+      const int64_t num_children =
+          count == 0 ? variable.GetNumChildren()
+                     : variable.GetNumChildren(start + count + 1);
       int64_t end_idx = start + ((count == 0) ? num_children : count);
       int64_t i = start;
       for (; i < end_idx && i < num_children; ++i)
@@ -0,0 +1,48 @@
+//===-- SimpleConditionTest.cpp -------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Breakpoint/SimpleCondition.h"
+
+using namespace lldb_private;
+
+TEST(SimpleConditionTest, ParseSimpleConditions) {
+  EXPECT_TRUE(SimpleCondition::Parse("i == 5"));
+  EXPECT_TRUE(SimpleCondition::Parse("flag"));
+  EXPECT_TRUE(SimpleCondition::Parse("!flag"));
+  EXPECT_TRUE(SimpleCondition::Parse("p != nullptr && p->count >= 10"));
+  EXPECT_TRUE(SimpleCondition::Parse("(a < -1 || b > 0x10u) && !(c <= 'x')"));
+  EXPECT_TRUE(SimpleCondition::Parse("s.values[3] == 0777L"));
+  EXPECT_TRUE(SimpleCondition::Parse(" this -> m_size > 18446744073709551615"));
+  EXPECT_TRUE(SimpleCondition::Parse("c == '\\n'"));
+}
+
+TEST(SimpleConditionTest, RejectOtherConditions) {
+  EXPECT_FALSE(SimpleCondition::Parse(""));
+  // Side effects.
+  EXPECT_FALSE(SimpleCondition::Parse("i = 5"));
+  EXPECT_FALSE(SimpleCondition::Parse("i++ == 5"));
+  EXPECT_FALSE(SimpleCondition::Parse("foo() == 1"));
+  EXPECT_FALSE(SimpleCondition::Parse("[obj count] > 1"));
+  // Unsupported operators and operands.
+  EXPECT_FALSE(SimpleCondition::Parse("a + 1 == b"));
+  EXPECT_FALSE(SimpleCondition::Parse("a & 1"));
+  EXPECT_FALSE(SimpleCondition::Parse("*p == 1"));
+  EXPECT_FALSE(SimpleCondition::Parse("a[i] == 1"));
+  EXPECT_FALSE(SimpleCondition::Parse("f == 1.5"));
+  EXPECT_FALSE(SimpleCondition::Parse("s == \"str\""));
+  EXPECT_FALSE(SimpleCondition::Parse("a == b == c"));
+  EXPECT_FALSE(SimpleCondition::Parse("i == 0x1ffffffffffffffff"));
+  EXPECT_FALSE(SimpleCondition::Parse("i == 1uu"));
+  // Incomplete conditions.
+  EXPECT_FALSE(SimpleCondition::Parse("(a == 1"));
+  EXPECT_FALSE(SimpleCondition::Parse("a =="));
+  EXPECT_FALSE(SimpleCondition::Parse("a && "));
+  EXPECT_FALSE(SimpleCondition::Parse("p->"));
+}
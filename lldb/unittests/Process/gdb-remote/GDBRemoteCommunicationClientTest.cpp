@@ -138,6 +138,31 @@ TEST_F(GDBRemoteCommunicationClientTest, ReadRegister) {
             memcmp(buffer_sp->GetBytes(), all_registers, sizeof all_registers));
 }
 
+TEST_F(GDBRemoteCommunicationClientTest, ReadRegistersPipelined) {
+  const lldb::tid_t tid = 0x47;
+  client.SetPacketPipeliningEnabled(true);
+  std::future<std::vector<DataBufferSP>> read_result =
+      std::async(std::launch::async,
+                 [&] { return client.ReadRegisters(tid, {4, 5}); });
+  Handle_QThreadSuffixSupported(server, true);
+
+  // Both packets are sent before the first one is answered.
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("p4;thread:0047;", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("p5;thread:0047;", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket(one_register_hex));
+  ASSERT_EQ(PacketResult::Success, server.SendErrorResponse(0x01));
+
+  std::vector<DataBufferSP> buffers = read_result.get();
+  ASSERT_EQ(2u, buffers.size());
+  ASSERT_TRUE(bool(buffers[0]));
+  ASSERT_EQ(0,
+            memcmp(buffers[0]->GetBytes(), one_register, sizeof one_register));
+  ASSERT_FALSE(bool(buffers[1]));
+}
+
 TEST_F(GDBRemoteCommunicationClientTest, SaveRestoreRegistersNoSuffix) {
   const lldb::tid_t tid = 0x47;
   uint32_t save_id;
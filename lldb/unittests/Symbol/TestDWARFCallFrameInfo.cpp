@@ -148,6 +148,18 @@ Sections:
 #  DW_CFA_nop
 #  DW_CFA_nop
 #  DW_CFA_nop
+  - Name:            .eh_frame_hdr
+    Type:            SHT_PROGBITS
+    Flags:           [ SHF_ALLOC ]
+    Address:         0x00000000000002C8
+    AddressAlign:    0x0000000000000004
+    Content:         011B033BC4FFFFFF0100000098FFFFFFE0FFFFFF
+#  Version:               1
+#  eh_frame_ptr_enc:      1b (pcrel sdata4), eh_frame at 00000290
+#  fde_count_enc:         03 (udata4), 1 FDE
+#  table_enc:             3b (datarel sdata4)
+#
+#  initial_loc=00000260 fde=000002a8
   - Name:            .debug_frame
     Type:            SHT_PROGBITS
     AddressAlign:    0x0000000000000008
@@ -242,6 +254,12 @@ Symbols:
   EXPECT_EQ(GetExpectedRow0(), *plan.GetRowAtIndex(0));
   EXPECT_EQ(GetExpectedRow1(), *plan.GetRowAtIndex(1));
   EXPECT_EQ(GetExpectedRow2(), *plan.GetRowAtIndex(2));
+
+  AddressRange range;
+  ASSERT_TRUE(cfi.GetAddressRange(sym->GetAddress(), range));
+  EXPECT_EQ(sym->GetAddress().GetFileAddress(),
+            range.GetBaseAddress().GetFileAddress());
+  EXPECT_EQ(0xcu, range.GetByteSize());
 }
 
 TEST_F(DWARFCallFrameInfoTest, Basic_dwarf3) {
@@ -50,6 +50,7 @@ public:
   void RefreshStateAfterStop() override {}
   size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                       Status &error) override {
+    ++m_num_reads;
     if (m_bytes_left == 0)
       return 0;
 
@@ -72,6 +73,7 @@ public:
 
   // Test-specific additions
   size_t m_bytes_left;
+  size_t m_num_reads = 0;
   MemoryCache &GetMemoryCache() { return m_memory_cache; }
   void SetMaxReadSize(size_t size) { m_bytes_left = size; }
 };
@@ -226,3 +228,73 @@ TEST_F(MemoryTest, TesetMemoryCacheRead) {
                                                        // instead of using an
                                                        // old cache
 }
+
+TEST_F(MemoryTest, TestMemoryCacheReadAheadAndEviction) {
+  ArchSpec arch("x86_64-apple-macosx-");
+
+  Platform::SetHostPlatform(PlatformRemoteMacOSX::CreateInstance(true, &arch));
+
+  DebuggerSP debugger_sp = Debugger::CreateInstance();
+  ASSERT_TRUE(debugger_sp);
+
+  TargetSP target_sp = CreateTarget(debugger_sp, arch);
+  ASSERT_TRUE(target_sp);
+
+  ListenerSP listener_sp(Listener::MakeListener("dummy"));
+  ProcessSP process_sp = std::make_shared<DummyProcess>(target_sp, listener_sp);
+  ASSERT_TRUE(process_sp);
+
+  DummyProcess *process = static_cast<DummyProcess *>(process_sp.get());
+  ASSERT_TRUE(process
+                  ->SetPropertyValue(nullptr, eVarSetOperationAssign,
+                                     "memory-cache-max-lines", "3")
+                  .Success());
+  ASSERT_TRUE(process
+                  ->SetPropertyValue(nullptr, eVarSetOperationAssign,
+                                     "memory-cache-read-ahead", "2")
+                  .Success());
+  MemoryCache &mem_cache = process->GetMemoryCache();
+  mem_cache.Clear();
+
+  const uint64_t l2_cache_size = process->GetMemoryCacheLineSize();
+  Status error;
+  std::vector<uint8_t> data(l2_cache_size);
+  process->SetMaxReadSize(l2_cache_size * 16);
+
+  // A single miss reads a single line.
+  ASSERT_EQ(mem_cache.Read(0x1000, data.data(), data.size(), error),
+            data.size());
+  ASSERT_EQ(process->m_num_reads, 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 15);
+
+  // The next line is read along with the one after it.
+  ASSERT_EQ(mem_cache.Read(0x1000 + l2_cache_size, data.data(), data.size(),
+                           error),
+            data.size());
+  ASSERT_EQ(process->m_num_reads, 2u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 13);
+  ASSERT_EQ(mem_cache.Read(0x1000 + l2_cache_size * 2, data.data(),
+                           data.size(), error),
+            data.size());
+  ASSERT_EQ(process->m_num_reads, 2u);
+
+  // A non-sequential miss only reads its line, and evicts the least recently
+  // used one.
+  ASSERT_EQ(mem_cache.Read(0x8000, data.data(), data.size(), error),
+            data.size());
+  ASSERT_EQ(process->m_num_reads, 3u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 12);
+  ASSERT_EQ(mem_cache.Read(0x1000 + l2_cache_size, data.data(), data.size(),
+                           error),
+            data.size());
+  ASSERT_EQ(process->m_num_reads, 3u);
+  ASSERT_EQ(mem_cache.Read(0x1000, data.data(), data.size(), error),
+            data.size());
+  ASSERT_EQ(process->m_num_reads, 4u);
+
+  // Without the setting, nothing is kept when the process stops.
+  mem_cache.ClearVolatileData();
+  ASSERT_EQ(mem_cache.Read(0x1000, data.data(), data.size(), error),
+            data.size());
+  ASSERT_EQ(process->m_num_reads, 5u);
+}
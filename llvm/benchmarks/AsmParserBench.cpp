@@ -0,0 +1,219 @@
+//===- AsmParserBench.cpp -------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// These benchmarks measure the integrated assembler on compiler generated
+// assembly: the input is parsed by the generic AsmParser and the target parser,
+// and encoded into an in-memory ELF object. The throughput is reported in bytes
+// of assembly per second.
+//
+// Without arguments, synthetic x86-64 inputs in the style of clang -S output
+// are assembled, one made mostly of instructions and one made of data
+// directives. Assembly files from a real corpus can be given as positional
+// arguments after the benchmark flags, together with -triple.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/TargetParser/Triple.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+static cl::list<std::string> InputFiles(cl::Positional,
+                                        cl::desc("<input assembly files>"));
+
+static cl::opt<std::string> TripleName("triple",
+                                       cl::desc("Target triple of the inputs"),
+                                       cl::init("x86_64-linux-gnu"));
+
+// Generate NumFunctions functions that look like the -O2 output of clang, with
+// their labels, CFI directives and the usual mix of instructions.
+static std::string generateCode(unsigned NumFunctions) {
+  std::string Asm;
+  raw_string_ostream OS(Asm);
+  OS << "\t.text\n";
+  for (unsigned I = 0; I != NumFunctions; ++I) {
+    OS << "\t.globl\tf" << I << "\n"
+       << "\t.p2align\t4, 0x90\n"
+       << "\t.type\tf" << I << ",@function\n"
+       << "f" << I << ":\n"
+       << "\t.cfi_startproc\n"
+       << "\tpushq\t%rbx\n"
+       << "\t.cfi_def_cfa_offset 16\n"
+       << "\t.cfi_offset %rbx, -16\n"
+       << "\tmovq\t%rdi, %rbx\n"
+       << "\txorl\t%eax, %eax\n"
+       << "\ttestl\t%esi, %esi\n"
+       << "\tjle\t.LBB" << I << "_2\n"
+       << ".LBB" << I << "_1:\n"
+       << "\tmovl\t(%rbx,%rax,4), %ecx\n"
+       << "\tleal\t1(%rcx,%rcx,2), %ecx\n"
+       << "\tmovl\t%ecx, (%rbx,%rax,4)\n"
+       << "\tincq\t%rax\n"
+       << "\tcmpq\t%rax, %rsi\n"
+       << "\tjne\t.LBB" << I << "_1\n"
+       << ".LBB" << I << "_2:\n"
+       << "\tmovq\t%rbx, %rdi\n"
+       << "\tcallq\tf" << (I + 1) % NumFunctions << "@PLT\n"
+       << "\tvmovups\t16(%rbx), %ymm0\n"
+       << "\tvaddps\t.LCPI" << I << "_0(%rip), %ymm0, %ymm0\n"
+       << "\tvmovups\t%ymm0, 16(%rbx)\n"
+       << "\tpopq\t%rbx\n"
+       << "\t.cfi_def_cfa_offset 8\n"
+       << "\tvzeroupper\n"
+       << "\tretq\n"
+       << ".Lfunc_end" << I << ":\n"
+       << "\t.size\tf" << I << ", .Lfunc_end" << I << "-f" << I << "\n"
+       << "\t.cfi_endproc\n"
+       << "\t.section\t.rodata.cst32,\"aM\",@progbits,32\n"
+       << "\t.p2align\t5, 0x0\n"
+       << ".LCPI" << I << "_0:\n"
+       << "\t.long\t0x3f800000\n"
+       << "\t.long\t0x40000000\n"
+       << "\t.zero\t24\n"
+       << "\t.text\n";
+  }
+  return Asm;
+}
+
+// Generate data sections the way compilers emit initializers and debug info:
+// long lists of .byte, .short, .long and .quad values and of LEB128 numbers.
+static std::string generateData(unsigned NumObjects) {
+  std::string Asm;
+  raw_string_ostream OS(Asm);
+  for (unsigned I = 0; I != NumObjects; ++I) {
+    OS << "\t.section\t.rodata,\"a\",@progbits\n"
+       << "\t.globl\ttable" << I << "\n"
+       << "\t.p2align\t4, 0x0\n"
+       << "table" << I << ":\n";
+    for (unsigned J = 0; J != 16; ++J)
+      OS << "\t.byte\t" << (I * 7 + J) % 256 << "\n";
+    OS << "\t.byte\t1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16\n";
+    for (unsigned J = 0; J != 8; ++J)
+      OS << "\t.short\t" << (I * 31 + J) % 65536 << "\n";
+    for (unsigned J = 0; J != 8; ++J)
+      OS << "\t.long\t" << I * 1021 + J << "\n";
+    for (unsigned J = 0; J != 8; ++J)
+      OS << "\t.quad\t" << uint64_t(I) * 1000003 + J << "\n";
+    OS << "\t.quad\ttable" << I << "+8\n"
+       << "\t.section\t.debug_abbrev,\"\",@progbits\n";
+    for (unsigned J = 0; J != 8; ++J)
+      OS << "\t.uleb128\t" << I * 131 + J << "\n";
+    for (unsigned J = 0; J != 4; ++J)
+      OS << "\t.sleb128\t-" << I + J << "\n";
+  }
+  return Asm;
+}
+
+static void assemble(benchmark::State &State, std::string Asm) {
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!T) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+  Triple TheTriple(TripleName);
+  MCTargetOptions MCOptions;
+  std::unique_ptr<MCRegisterInfo> MRI(T->createMCRegInfo(TripleName));
+  std::unique_ptr<MCAsmInfo> MAI(
+      T->createMCAsmInfo(*MRI, TripleName, MCOptions));
+  std::unique_ptr<MCSubtargetInfo> STI(
+      T->createMCSubtargetInfo(TripleName, "", ""));
+  std::unique_ptr<MCInstrInfo> MCII(T->createMCInstrInfo());
+
+  for (auto _ : State) {
+    SourceMgr SrcMgr;
+    SrcMgr.AddNewSourceBuffer(
+        MemoryBuffer::getMemBuffer(Asm, "<bench>",
+                                   /*RequiresNullTerminator=*/true),
+        SMLoc());
+    MCContext Ctx(TheTriple, MAI.get(), MRI.get(), STI.get(), &SrcMgr,
+                  &MCOptions);
+    std::unique_ptr<MCObjectFileInfo> MOFI(
+        T->createMCObjectFileInfo(Ctx, /*PIC=*/true));
+    Ctx.setObjectFileInfo(MOFI.get());
+
+    SmallString<0> Object;
+    raw_svector_ostream OS(Object);
+    std::unique_ptr<MCAsmBackend> MAB(
+        T->createMCAsmBackend(*STI, *MRI, MCOptions));
+    std::unique_ptr<MCObjectWriter> OW = MAB->createObjectWriter(OS);
+    std::unique_ptr<MCStreamer> Str(T->createMCObjectStreamer(
+        TheTriple, Ctx, std::move(MAB), std::move(OW),
+        std::unique_ptr<MCCodeEmitter>(T->createMCCodeEmitter(*MCII, Ctx)),
+        *STI));
+    std::unique_ptr<MCAsmParser> Parser(
+        createMCAsmParser(SrcMgr, Ctx, *Str, *MAI));
+    std::unique_ptr<MCTargetAsmParser> TAP(
+        T->createMCAsmParser(*STI, *Parser, *MCII, MCOptions));
+    Parser->setTargetParser(*TAP);
+    if (Parser->Run(/*NoInitialTextSection=*/false)) {
+      State.SkipWithError("assembly failed");
+      return;
+    }
+    benchmark::DoNotOptimize(Object.data());
+  }
+  State.SetBytesProcessed(int64_t(State.iterations()) * Asm.size());
+}
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "Integrated assembler benchmarks\n");
+
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllAsmParsers();
+
+  if (InputFiles.empty()) {
+    for (unsigned N : {100, 1000}) {
+      benchmark::RegisterBenchmark(
+          ("AsmParser/Code/" + std::to_string(N)).c_str(), assemble,
+          generateCode(N))
+          ->Unit(benchmark::kMillisecond);
+      benchmark::RegisterBenchmark(
+          ("AsmParser/Data/" + std::to_string(N)).c_str(), assemble,
+          generateData(N))
+          ->Unit(benchmark::kMillisecond);
+    }
+  }
+  for (const std::string &File : InputFiles) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer =
+        MemoryBuffer::getFile(File, /*IsText=*/true);
+    if (!Buffer) {
+      errs() << File << ": " << Buffer.getError().message() << "\n";
+      return 1;
+    }
+    benchmark::RegisterBenchmark(("AsmParser/" + File).c_str(), assemble,
+                                 (*Buffer)->getBuffer().str())
+        ->Unit(benchmark::kMillisecond);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
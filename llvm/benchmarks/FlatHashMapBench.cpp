@@ -0,0 +1,160 @@
+//===- FlatHashMapBench.cpp -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// These benchmarks compare FlatHashMap with DenseMap and StringMap for the
+// key types of the hot maps in LLVM tools: pointers, as in the uniquing and
+// value maps, and CachedHashStringRef, as in lld's symbol table. Every
+// benchmark measures building the map, looking up present keys, and looking
+// up missing keys, the latter being the common case when resolving symbols
+// that are defined in a later input file.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/CachedHashString.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/FlatHashMap.h"
+#include "llvm/ADT/StringMap.h"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+// Return NumKeys pointers to distinct heap allocations in random order, as
+// the keys of a map of IR objects.
+std::vector<std::unique_ptr<int>> makePointerKeys(unsigned NumKeys) {
+  std::vector<std::unique_ptr<int>> Keys;
+  for (unsigned I = 0; I != NumKeys; ++I)
+    Keys.push_back(std::make_unique<int>(I));
+  std::shuffle(Keys.begin(), Keys.end(), std::mt19937(0));
+  return Keys;
+}
+
+// Return NumKeys symbol names in the style of mangled C++ names.
+std::vector<std::string> makeNames(unsigned NumKeys, StringRef Prefix) {
+  std::vector<std::string> Names;
+  for (unsigned I = 0; I != NumKeys; ++I)
+    Names.push_back(Prefix.str() + "_ZN4llvm12SymbolTable" +
+                    std::to_string(I) + "E7addNameEv");
+  return Names;
+}
+
+template <typename MapT> void pointerInsert(benchmark::State &State) {
+  auto Keys = makePointerKeys(State.range(0));
+  for (auto _ : State) {
+    MapT M;
+    for (unsigned I = 0, E = Keys.size(); I != E; ++I)
+      M[Keys[I].get()] = I;
+    benchmark::DoNotOptimize(M.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+template <typename MapT> void pointerLookup(benchmark::State &State) {
+  auto Keys = makePointerKeys(State.range(0));
+  auto Missing = makePointerKeys(State.range(0));
+  MapT M;
+  for (unsigned I = 0, E = Keys.size(); I != E; ++I)
+    M[Keys[I].get()] = I;
+  for (auto _ : State) {
+    unsigned Found = 0;
+    for (unsigned I = 0, E = Keys.size(); I != E; ++I) {
+      Found += M.count(Keys[I].get());
+      Found += M.count(Missing[I].get());
+    }
+    benchmark::DoNotOptimize(Found);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size() * 2);
+}
+
+// The symbol table of lld maps CachedHashStringRef to an index.
+template <typename MapT> void symbolInsert(benchmark::State &State) {
+  auto Names = makeNames(State.range(0), "");
+  for (auto _ : State) {
+    MapT M;
+    for (unsigned I = 0, E = Names.size(); I != E; ++I)
+      M.try_emplace(CachedHashStringRef(Names[I]), I);
+    benchmark::DoNotOptimize(M.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Names.size());
+}
+
+template <typename MapT> void symbolLookup(benchmark::State &State) {
+  auto Names = makeNames(State.range(0), "");
+  auto Missing = makeNames(State.range(0), "missing");
+  std::vector<CachedHashStringRef> Keys, MissingKeys;
+  for (unsigned I = 0, E = Names.size(); I != E; ++I) {
+    Keys.emplace_back(Names[I]);
+    MissingKeys.emplace_back(Missing[I]);
+  }
+  MapT M;
+  for (unsigned I = 0, E = Keys.size(); I != E; ++I)
+    M.try_emplace(Keys[I], I);
+  for (auto _ : State) {
+    unsigned Found = 0;
+    for (unsigned I = 0, E = Keys.size(); I != E; ++I) {
+      Found += M.count(Keys[I]);
+      Found += M.count(MissingKeys[I]);
+    }
+    benchmark::DoNotOptimize(Found);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size() * 2);
+}
+
+// StringMap hashes the string itself, so it is given the plain names.
+void stringMapInsert(benchmark::State &State) {
+  auto Names = makeNames(State.range(0), "");
+  for (auto _ : State) {
+    StringMap<unsigned> M;
+    for (unsigned I = 0, E = Names.size(); I != E; ++I)
+      M.try_emplace(Names[I], I);
+    benchmark::DoNotOptimize(M.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Names.size());
+}
+
+void stringMapLookup(benchmark::State &State) {
+  auto Names = makeNames(State.range(0), "");
+  auto Missing = makeNames(State.range(0), "missing");
+  StringMap<unsigned> M;
+  for (unsigned I = 0, E = Names.size(); I != E; ++I)
+    M.try_emplace(Names[I], I);
+  for (auto _ : State) {
+    unsigned Found = 0;
+    for (unsigned I = 0, E = Names.size(); I != E; ++I) {
+      Found += M.count(Names[I]);
+      Found += M.count(Missing[I]);
+    }
+    benchmark::DoNotOptimize(Found);
+  }
+  State.SetItemsProcessed(State.iterations() * Names.size() * 2);
+}
+
+using PtrDenseMap = DenseMap<int *, unsigned>;
+using PtrFlatHashMap = FlatHashMap<int *, unsigned>;
+using SymDenseMap = DenseMap<CachedHashStringRef, int>;
+using SymFlatHashMap = FlatHashMap<CachedHashStringRef, int>;
+
+} // namespace
+
+BENCHMARK(pointerInsert<PtrDenseMap>)->Range(1 << 6, 1 << 20);
+BENCHMARK(pointerInsert<PtrFlatHashMap>)->Range(1 << 6, 1 << 20);
+BENCHMARK(pointerLookup<PtrDenseMap>)->Range(1 << 6, 1 << 20);
+BENCHMARK(pointerLookup<PtrFlatHashMap>)->Range(1 << 6, 1 << 20);
+BENCHMARK(symbolInsert<SymDenseMap>)->Range(1 << 6, 1 << 20);
+BENCHMARK(symbolInsert<SymFlatHashMap>)->Range(1 << 6, 1 << 20);
+BENCHMARK(stringMapInsert)->Range(1 << 6, 1 << 20);
+BENCHMARK(symbolLookup<SymDenseMap>)->Range(1 << 6, 1 << 20);
+BENCHMARK(symbolLookup<SymFlatHashMap>)->Range(1 << 6, 1 << 20);
+BENCHMARK(stringMapLookup)->Range(1 << 6, 1 << 20);
+
+BENCHMARK_MAIN();
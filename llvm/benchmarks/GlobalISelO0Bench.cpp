@@ -0,0 +1,249 @@
+//===- GlobalISelO0Bench.cpp ----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// These benchmarks measure -O0 code generation with GlobalISel against
+// FastISel on AArch64 and X86. Besides the total time, every benchmark reports
+// the average wall time of the GlobalISel passes and of the target's
+// instruction selection pass as counters, so regressions can be attributed to
+// a single pass.
+//
+// Without arguments, a synthetic module in the style of clang -O0 output is
+// compiled. Modules from a real corpus can be given as positional arguments
+// after the benchmark flags; they are compiled for the triple they carry.
+// LLVM options such as -track-memory are accepted as well.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+static cl::list<std::string> InputFiles(cl::Positional,
+                                        cl::desc("<input modules>"));
+
+enum class Selector { FastISel, GlobalISel };
+
+// The passes whose time is reported. The DAG-based selectors run as part of
+// the target's instruction selection pass.
+static constexpr const char *TimedPasses[] = {
+    "irtranslator", "legalizer",  "regbankselect", "instruction-select",
+    "aarch64-isel", "x86-isel",
+};
+
+// Generate a module with NumFunctions functions that look like the -O0 output
+// of clang: every value goes through an alloca, with a mix of integer and
+// floating-point arithmetic, comparisons, branches, array accesses and calls.
+static std::string generateO0Module(unsigned NumFunctions) {
+  std::string IR;
+  raw_string_ostream OS(IR);
+  OS << "declare i32 @ext(i32)\n";
+  for (unsigned I = 0; I != NumFunctions; ++I) {
+    OS << "define i32 @f" << I << "(i32 %a, i64 %b, ptr %p) {\n"
+       << "entry:\n"
+       << "  %a.addr = alloca i32\n"
+       << "  %b.addr = alloca i64\n"
+       << "  %p.addr = alloca ptr\n"
+       << "  %arr = alloca [4 x i32]\n"
+       << "  %ret = alloca i32\n"
+       << "  store i32 %a, ptr %a.addr\n"
+       << "  store i64 %b, ptr %b.addr\n"
+       << "  store ptr %p, ptr %p.addr\n"
+       << "  %0 = load i32, ptr %a.addr\n"
+       << "  %1 = load i64, ptr %b.addr\n"
+       << "  %conv = sext i32 %0 to i64\n"
+       << "  %add = add nsw i64 %conv, %1\n"
+       << "  %cmp = icmp sgt i64 %add, " << I << "\n"
+       << "  br i1 %cmp, label %then, label %else\n"
+       << "then:\n"
+       << "  %idx = and i64 %1, 3\n"
+       << "  %gep = getelementptr inbounds [4 x i32], ptr %arr, i64 0, "
+          "i64 %idx\n"
+       << "  %2 = load i32, ptr %gep\n"
+       << "  %call = call i32 @ext(i32 %2)\n"
+       << "  store i32 %call, ptr %ret\n"
+       << "  br label %end\n"
+       << "else:\n"
+       << "  %mul = mul nsw i32 %0, 3\n"
+       << "  %fp = sitofp i32 %mul to double\n"
+       << "  %fadd = fadd double %fp, 1.5\n"
+       << "  %3 = load ptr, ptr %p.addr\n"
+       << "  %4 = load i8, ptr %3\n"
+       << "  %ext = zext i8 %4 to i32\n"
+       << "  %int = fptosi double %fadd to i32\n"
+       << "  %sum = add i32 %int, %ext\n"
+       << "  %sel = select i1 %cmp, i32 %sum, i32 %0\n"
+       << "  store i32 %sel, ptr %ret\n"
+       << "  br label %end\n"
+       << "end:\n"
+       << "  %5 = load i32, ptr %ret\n"
+       << "  ret i32 %5\n"
+       << "}\n";
+  }
+  return IR;
+}
+
+// Return the accumulated wall time of every timer in the "pass" group, and
+// the memory it used if -track-memory is enabled, keyed by pass argument.
+static StringMap<std::pair<double, double>> collectPassTimes() {
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  OS << "{";
+  TimerGroup::printAllJSONValues(OS, "");
+  OS << "}";
+  TimerGroup::clearAll();
+
+  StringMap<std::pair<double, double>> Times;
+  Expected<json::Value> V = json::parse(Buf);
+  if (!V) {
+    consumeError(V.takeError());
+    return Times;
+  }
+  for (const auto &[Key, Value] : *V->getAsObject()) {
+    StringRef Name = Key;
+    if (!Name.consume_front("time.pass."))
+      continue;
+    std::optional<double> D = Value.getAsNumber();
+    if (!D)
+      continue;
+    if (Name.consume_back(".wall"))
+      Times[Name].first += *D;
+    else if (Name.consume_back(".mem"))
+      Times[Name].second += *D;
+  }
+  return Times;
+}
+
+static void compileO0(benchmark::State &State, Selector Sel,
+                      std::string TripleStr, std::string InputFile) {
+  std::string IR;
+  if (InputFile.empty())
+    IR = generateO0Module(State.range(0));
+
+  std::unique_ptr<TargetMachine> TM;
+  int64_t MallocBytes = 0;
+  TimePassesIsEnabled = true;
+  TimerGroup::clearAll();
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    LLVMContext Ctx;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M =
+        InputFile.empty()
+            ? parseIR(MemoryBufferRef(IR, "bench"), Err, Ctx)
+            : parseIRFile(InputFile, Err, Ctx);
+    if (!M) {
+      State.SkipWithError(Err.getMessage().str());
+      return;
+    }
+    if (!TripleStr.empty())
+      M->setTargetTriple(TripleStr);
+
+    if (!TM) {
+      std::string Error;
+      const Target *T =
+          TargetRegistry::lookupTarget(M->getTargetTriple(), Error);
+      if (!T) {
+        State.SkipWithError(Error);
+        return;
+      }
+      TM.reset(T->createTargetMachine(M->getTargetTriple(), "", "",
+                                      TargetOptions(), std::nullopt,
+                                      std::nullopt, CodeGenOptLevel::None));
+      TM->setGlobalISel(Sel == Selector::GlobalISel);
+      TM->setGlobalISelAbort(GlobalISelAbortMode::Disable);
+      TM->setFastISel(Sel == Selector::FastISel);
+      TM->setO0WantsFastISel(Sel == Selector::FastISel);
+    }
+    M->setDataLayout(TM->createDataLayout());
+
+    legacy::PassManager PM;
+    raw_null_ostream OS;
+    if (TM->addPassesToEmitFile(PM, OS, nullptr,
+                                CodeGenFileType::ObjectFile)) {
+      State.SkipWithError("target does not support object emission");
+      return;
+    }
+    int64_t MallocBefore = sys::Process::GetMallocUsage();
+    State.ResumeTiming();
+
+    PM.run(*M);
+
+    State.PauseTiming();
+    MallocBytes += int64_t(sys::Process::GetMallocUsage()) - MallocBefore;
+    M.reset();
+    State.ResumeTiming();
+  }
+
+  StringMap<std::pair<double, double>> Times = collectPassTimes();
+  for (const char *Pass : TimedPasses) {
+    auto It = Times.find(Pass);
+    if (It == Times.end())
+      continue;
+    State.counters[std::string(Pass) + ".s"] = benchmark::Counter(
+        It->second.first, benchmark::Counter::kAvgIterations);
+    if (It->second.second)
+      State.counters[std::string(Pass) + ".mem"] = benchmark::Counter(
+          It->second.second, benchmark::Counter::kAvgIterations);
+  }
+  // The heap growth while the pipeline runs, that is the memory held by the
+  // machine functions and MC state at the end of compilation.
+  State.counters["malloc_bytes"] =
+      benchmark::Counter(MallocBytes, benchmark::Counter::kAvgIterations);
+  TimePassesIsEnabled = false;
+}
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "GlobalISel -O0 benchmarks\n");
+
+  InitializeAllTargets();
+  InitializeAllTargetMCs();
+  InitializeAllAsmPrinters();
+
+  const std::pair<const char *, Selector> Selectors[] = {
+      {"FastISel", Selector::FastISel}, {"GlobalISel", Selector::GlobalISel}};
+  for (const auto &[SelName, Sel] : Selectors) {
+    if (InputFiles.empty()) {
+      for (const char *Triple : {"aarch64-linux-gnu", "x86_64-linux-gnu"})
+        benchmark::RegisterBenchmark(
+            (std::string("O0/") + SelName + "/" + Triple).c_str(), compileO0,
+            Sel, Triple, "")
+            ->Arg(100)
+            ->Arg(1000)
+            ->Unit(benchmark::kMillisecond);
+      continue;
+    }
+    for (const std::string &File : InputFiles)
+      benchmark::RegisterBenchmark(
+          (std::string("O0/") + SelName + "/" + File).c_str(), compileO0, Sel,
+          "", File)
+          ->Unit(benchmark::kMillisecond);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,153 @@
+//===- IRMemoryBench.cpp --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This benchmark measures how much memory the in-memory IR takes per
+// instruction, to evaluate changes to the layout of instructions, operands and
+// use lists.
+//
+// The input modules given as positional arguments are parsed and linked into
+// a single module, as in a full LTO link. Without arguments, a synthetic
+// module is used. Besides the time, every benchmark reports as counters
+//
+//  - the heap growth per instruction of the linked module,
+//  - the number of operands per instruction and the memory their Use objects
+//    take per instruction, and
+//  - the fraction of instructions with hung-off operands, which are allocated
+//    separately from the instruction.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+static cl::list<std::string> InputFiles(cl::Positional,
+                                        cl::desc("<input modules>"));
+
+// Generate a module with NumFunctions functions with a mix of arithmetic,
+// memory accesses, calls, PHIs and switches, in the style of optimized code.
+static std::string generateModule(unsigned NumFunctions) {
+  std::string IR;
+  raw_string_ostream OS(IR);
+  OS << "declare i64 @ext(i64, ptr)\n";
+  for (unsigned I = 0; I != NumFunctions; ++I) {
+    OS << "define i64 @f" << I << "(i64 %n, ptr %p) {\n"
+       << "entry:\n"
+       << "  br label %loop\n"
+       << "loop:\n"
+       << "  %i = phi i64 [ 0, %entry ], [ %i.next, %latch ]\n"
+       << "  %acc = phi i64 [ 0, %entry ], [ %acc.next, %latch ]\n"
+       << "  %gep = getelementptr inbounds i64, ptr %p, i64 %i\n"
+       << "  %v = load i64, ptr %gep\n"
+       << "  %k = and i64 %v, 3\n"
+       << "  switch i64 %k, label %other [ i64 0, label %a\n"
+       << "                                i64 1, label %b ]\n"
+       << "a:\n"
+       << "  %x = mul i64 %v, " << I + 3 << "\n"
+       << "  br label %latch\n"
+       << "b:\n"
+       << "  %y = call i64 @ext(i64 %v, ptr %gep)\n"
+       << "  br label %latch\n"
+       << "other:\n"
+       << "  %z = xor i64 %v, %acc\n"
+       << "  store i64 %z, ptr %gep\n"
+       << "  br label %latch\n"
+       << "latch:\n"
+       << "  %r = phi i64 [ %x, %a ], [ %y, %b ], [ %z, %other ]\n"
+       << "  %acc.next = add i64 %acc, %r\n"
+       << "  %i.next = add nuw i64 %i, 1\n"
+       << "  %cmp = icmp ult i64 %i.next, %n\n"
+       << "  br i1 %cmp, label %loop, label %exit\n"
+       << "exit:\n"
+       << "  ret i64 %acc.next\n"
+       << "}\n";
+  }
+  return IR;
+}
+
+static void irMemory(benchmark::State &State) {
+  std::string IR;
+  if (InputFiles.empty())
+    IR = generateModule(State.range(0));
+
+  int64_t MallocBytes = 0;
+  uint64_t NumInsts = 0, NumOperands = 0, NumHungOff = 0;
+  for (auto _ : State) {
+    int64_t MallocBefore = sys::Process::GetMallocUsage();
+    LLVMContext Ctx;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> Combined;
+    if (InputFiles.empty()) {
+      Combined = parseAssemblyString(IR, Err, Ctx);
+    } else {
+      Combined = std::make_unique<Module>("ld-temp.o", Ctx);
+      Linker L(*Combined);
+      for (const std::string &File : InputFiles) {
+        std::unique_ptr<Module> M = parseIRFile(File, Err, Ctx);
+        if (!M || L.linkInModule(std::move(M))) {
+          State.SkipWithError("cannot link " + File);
+          return;
+        }
+      }
+    }
+    if (!Combined) {
+      State.SkipWithError(Err.getMessage().str());
+      return;
+    }
+
+    State.PauseTiming();
+    MallocBytes += int64_t(sys::Process::GetMallocUsage()) - MallocBefore;
+    NumInsts = NumOperands = NumHungOff = 0;
+    for (const Function &F : *Combined)
+      for (const Instruction &I : instructions(F)) {
+        ++NumInsts;
+        NumOperands += I.getNumOperands();
+        if (isa<PHINode, SwitchInst, IndirectBrInst, LandingPadInst,
+                CatchSwitchInst>(I))
+          ++NumHungOff;
+      }
+    State.ResumeTiming();
+  }
+
+  if (!NumInsts)
+    return;
+  double Iterations = State.iterations();
+  State.counters["insts"] = NumInsts;
+  State.counters["bytes/inst"] = MallocBytes / Iterations / NumInsts;
+  State.counters["operands/inst"] = double(NumOperands) / NumInsts;
+  State.counters["use_bytes/inst"] =
+      double(NumOperands) * sizeof(Use) / NumInsts;
+  State.counters["hung_off_fraction"] = double(NumHungOff) / NumInsts;
+}
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "IR memory benchmarks\n");
+
+  auto *B = benchmark::RegisterBenchmark("IRMemory", irMemory)
+                ->Unit(benchmark::kMillisecond);
+  if (InputFiles.empty())
+    B->Arg(1000)->Arg(10000);
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
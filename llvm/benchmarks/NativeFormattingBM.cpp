@@ -0,0 +1,100 @@
+//===- NativeFormattingBM.cpp - raw_ostream formatting benchmark ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// These benchmarks measure the integer, hex and byte dump formatting of
+// raw_ostream, which dominates the run time of tools like llvm-objdump,
+// llvm-dwarfdump and llvm-nm. The output goes to a buffered stream that
+// discards it, as stdout redirected to /dev/null would.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/NativeFormatting.h"
+#include "llvm/Support/raw_ostream.h"
+#include <random>
+#include <vector>
+
+using namespace llvm;
+
+// Values with a mix of magnitudes, as found in addresses, sizes and offsets.
+static std::vector<uint64_t> getValues() {
+  std::mt19937_64 Rng(0);
+  std::vector<uint64_t> Values;
+  for (unsigned I = 0; I != 4096; ++I)
+    Values.push_back(Rng() >> (Rng() % 64));
+  return Values;
+}
+
+static void BM_WriteDecimal(benchmark::State &State) {
+  std::vector<uint64_t> Values = getValues();
+  raw_null_ostream OS;
+  for (auto _ : State) {
+    for (uint64_t V : Values)
+      OS << V << ' ';
+    OS.flush();
+  }
+  State.SetItemsProcessed(State.iterations() * Values.size());
+}
+BENCHMARK(BM_WriteDecimal);
+
+static void BM_WriteDecimalPadded(benchmark::State &State) {
+  std::vector<uint64_t> Values = getValues();
+  raw_null_ostream OS;
+  for (auto _ : State) {
+    for (uint64_t V : Values)
+      OS << format_decimal(int64_t(V % 100000), 8) << ' ';
+    OS.flush();
+  }
+  State.SetItemsProcessed(State.iterations() * Values.size());
+}
+BENCHMARK(BM_WriteDecimalPadded);
+
+static void BM_WriteHex(benchmark::State &State) {
+  std::vector<uint64_t> Values = getValues();
+  raw_null_ostream OS;
+  for (auto _ : State) {
+    for (uint64_t V : Values)
+      OS << format_hex(V, 18) << ' ';
+    OS.flush();
+  }
+  State.SetItemsProcessed(State.iterations() * Values.size());
+}
+BENCHMARK(BM_WriteHex);
+
+// The section dumps of llvm-objdump -s and llvm-readobj --hex-dump.
+static void BM_FormatBytes(benchmark::State &State) {
+  std::vector<uint8_t> Bytes(1 << 16);
+  std::mt19937 Rng(0);
+  for (uint8_t &B : Bytes)
+    B = Rng();
+  raw_null_ostream OS;
+  for (auto _ : State) {
+    OS << format_bytes_with_ascii(Bytes, /*FirstByteOffset=*/0,
+                                  /*NumPerLine=*/16, /*ByteGroupSize=*/4);
+    OS.flush();
+  }
+  State.SetBytesProcessed(State.iterations() * Bytes.size());
+}
+BENCHMARK(BM_FormatBytes);
+
+static void BM_WriteHexBlock(benchmark::State &State) {
+  std::vector<uint8_t> Bytes(1 << 16);
+  std::mt19937 Rng(0);
+  for (uint8_t &B : Bytes)
+    B = Rng();
+  raw_null_ostream OS;
+  for (auto _ : State) {
+    write_hex_block(OS, Bytes);
+    OS.flush();
+  }
+  State.SetBytesProcessed(State.iterations() * Bytes.size());
+}
+BENCHMARK(BM_WriteHexBlock);
+
+BENCHMARK_MAIN();
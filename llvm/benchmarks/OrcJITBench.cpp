@@ -0,0 +1,359 @@
+//===- OrcJITBench.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// These benchmarks track the startup latency, compile throughput and memory
+// overhead of the ORC JIT, so that regressions show up over time (run with
+// --benchmark_format=json to get results which can be tracked):
+//
+//  - OrcFirstCallLatency adds a synthetic module with the given number of
+//    functions to an LLLazyJIT and calls every function once. It reports the
+//    time it takes to create the JIT and add the module, and the distribution
+//    of the latencies of the first calls, which include the lazy compilation.
+//  - OrcCompileThroughput adds the input modules given as positional arguments
+//    (or synthetic ones) to an LLJIT with the given number of compile threads,
+//    and looks up all their functions. It reports the functions compiled per
+//    second.
+//  - OrcMemoryOverhead links the same modules with an ObjectLinkingLayer and
+//    reports the bytes of the linked blocks and of the pages they take, per
+//    function. The difference is the overhead of the JITLinkMemoryManager
+//    layout.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/JITLink/JITLink.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+static cl::list<std::string> InputFiles(cl::Positional,
+                                        cl::desc("<input modules>"));
+
+namespace {
+
+/// The modules to add to the JIT, and the names of the functions they define.
+struct Corpus {
+  std::vector<ThreadSafeModule> Modules;
+  std::vector<std::string> Functions;
+  std::string Error;
+};
+
+} // end anonymous namespace
+
+// Generate a module with NumFunctions functions of type i64(i64), which can be
+// called from the benchmarks.
+static std::string generateModule(unsigned ModuleIdx, unsigned NumFunctions) {
+  std::string IR;
+  raw_string_ostream OS(IR);
+  for (unsigned I = 0; I != NumFunctions; ++I) {
+    OS << "define i64 @m" << ModuleIdx << "_f" << I << "(i64 %n) {\n"
+       << "entry:\n"
+       << "  br label %loop\n"
+       << "loop:\n"
+       << "  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]\n"
+       << "  %acc = phi i64 [ 0, %entry ], [ %acc.next, %loop ]\n"
+       << "  %x = mul i64 %i, " << I + 3 << "\n"
+       << "  %y = xor i64 %x, %acc\n"
+       << "  %acc.next = add i64 %y, %n\n"
+       << "  %i.next = add nuw i64 %i, 1\n"
+       << "  %cmp = icmp ult i64 %i.next, %n\n"
+       << "  br i1 %cmp, label %loop, label %exit\n"
+       << "exit:\n"
+       << "  ret i64 %acc.next\n"
+       << "}\n";
+  }
+  return IR;
+}
+
+// Load the input modules, or NumModules synthetic modules of
+// FunctionsPerModule functions if there are none (or if Synthetic is set).
+static Corpus loadCorpus(unsigned NumModules, unsigned FunctionsPerModule,
+                         bool Synthetic = false) {
+  Corpus C;
+  auto AddModule = [&](std::unique_ptr<Module> M, ThreadSafeContext TSCtx) {
+    for (const Function &F : *M)
+      if (!F.isDeclaration() && !F.hasLocalLinkage())
+        C.Functions.push_back(F.getName().str());
+    C.Modules.emplace_back(std::move(M), std::move(TSCtx));
+  };
+
+  SMDiagnostic Err;
+  if (Synthetic || InputFiles.empty()) {
+    for (unsigned I = 0; I != NumModules; ++I) {
+      ThreadSafeContext TSCtx(std::make_unique<LLVMContext>());
+      auto M = parseAssemblyString(generateModule(I, FunctionsPerModule), Err,
+                                   *TSCtx.getContext());
+      if (!M) {
+        C.Error = Err.getMessage().str();
+        return C;
+      }
+      AddModule(std::move(M), std::move(TSCtx));
+    }
+    return C;
+  }
+
+  for (const std::string &File : InputFiles) {
+    ThreadSafeContext TSCtx(std::make_unique<LLVMContext>());
+    auto M = parseIRFile(File, Err, *TSCtx.getContext());
+    if (!M) {
+      C.Error = "cannot read " + File + ": " + Err.getMessage().str();
+      return C;
+    }
+    AddModule(std::move(M), std::move(TSCtx));
+  }
+  return C;
+}
+
+static double getPercentile(ArrayRef<double> Sorted, double P) {
+  if (Sorted.empty())
+    return 0;
+  return Sorted[std::min<size_t>(Sorted.size() * P, Sorted.size() - 1)];
+}
+
+static void orcFirstCallLatency(benchmark::State &State) {
+  using Clock = std::chrono::steady_clock;
+  std::vector<double> Latencies;
+  double StartupUs = 0;
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    Corpus C = loadCorpus(1, State.range(0), /*Synthetic=*/true);
+    if (!C.Error.empty()) {
+      State.SkipWithError(C.Error);
+      return;
+    }
+    State.ResumeTiming();
+
+    auto Start = Clock::now();
+    auto J = LLLazyJITBuilder().create();
+    if (!J) {
+      State.SkipWithError(toString(J.takeError()));
+      return;
+    }
+    for (auto &TSM : C.Modules)
+      if (Error Err = (*J)->addLazyIRModule(std::move(TSM))) {
+        State.SkipWithError(toString(std::move(Err)));
+        return;
+      }
+    StartupUs += std::chrono::duration<double, std::micro>(Clock::now() - Start)
+                     .count();
+
+    for (const std::string &Name : C.Functions) {
+      auto CallStart = Clock::now();
+      auto Addr = (*J)->lookup(Name);
+      if (!Addr) {
+        State.SkipWithError(toString(Addr.takeError()));
+        return;
+      }
+      benchmark::DoNotOptimize(Addr->toPtr<int64_t (*)(int64_t)>()(10));
+      Latencies.push_back(
+          std::chrono::duration<double, std::micro>(Clock::now() - CallStart)
+              .count());
+    }
+  }
+
+  llvm::sort(Latencies);
+  State.counters["startup_us"] = StartupUs / State.iterations();
+  State.counters["first_call_p50_us"] = getPercentile(Latencies, 0.5);
+  State.counters["first_call_p90_us"] = getPercentile(Latencies, 0.9);
+  State.counters["first_call_p99_us"] = getPercentile(Latencies, 0.99);
+  State.counters["first_call_max_us"] =
+      Latencies.empty() ? 0 : Latencies.back();
+}
+
+static void orcCompileThroughput(benchmark::State &State) {
+  uint64_t NumFunctions = 0;
+  for (auto _ : State) {
+    State.PauseTiming();
+    Corpus C = loadCorpus(64, 64);
+    if (!C.Error.empty()) {
+      State.SkipWithError(C.Error);
+      return;
+    }
+    State.ResumeTiming();
+
+    auto J = LLJITBuilder().setNumCompileThreads(State.range(0)).create();
+    if (!J) {
+      State.SkipWithError(toString(J.takeError()));
+      return;
+    }
+    for (auto &TSM : C.Modules)
+      if (Error Err = (*J)->addIRModule(std::move(TSM))) {
+        State.SkipWithError(toString(std::move(Err)));
+        return;
+      }
+
+    // Look up all the functions at once, so that the modules can be compiled
+    // concurrently.
+    SymbolLookupSet Symbols;
+    for (const std::string &Name : C.Functions)
+      Symbols.add((*J)->mangleAndIntern(Name));
+    auto Result = (*J)->getExecutionSession().lookup(
+        makeJITDylibSearchOrder(&(*J)->getMainJITDylib()), std::move(Symbols));
+    if (!Result) {
+      State.SkipWithError(toString(Result.takeError()));
+      return;
+    }
+    NumFunctions += C.Functions.size();
+  }
+  State.counters["functions"] =
+      benchmark::Counter(NumFunctions, benchmark::Counter::kIsRate);
+}
+
+namespace {
+
+/// Records the bytes of the blocks linked and the pages they take.
+class FootprintPlugin : public ObjectLinkingLayer::Plugin {
+public:
+  FootprintPlugin() : PageSize(sys::Process::getPageSizeEstimate()) {}
+
+  void modifyPassConfig(MaterializationResponsibility &MR,
+                        jitlink::LinkGraph &G,
+                        jitlink::PassConfiguration &Config) override {
+    Config.PostAllocationPasses.push_back([this](jitlink::LinkGraph &G) {
+      record(G);
+      return Error::success();
+    });
+  }
+
+  Error notifyFailed(MaterializationResponsibility &MR) override {
+    return Error::success();
+  }
+  Error notifyRemovingResources(JITDylib &JD, ResourceKey K) override {
+    return Error::success();
+  }
+  void notifyTransferringResources(JITDylib &JD, ResourceKey DstKey,
+                                   ResourceKey SrcKey) override {}
+
+  uint64_t getBlockBytes() const { return BlockBytes; }
+  uint64_t getPageBytes() const { return Pages.size() * PageSize; }
+
+private:
+  void record(jitlink::LinkGraph &G) {
+    std::lock_guard<std::mutex> Lock(M);
+    for (auto &Sec : G.sections()) {
+      if (Sec.getMemLifetime() == MemLifetime::NoAlloc)
+        continue;
+      for (auto *B : Sec.blocks()) {
+        if (!B->getSize())
+          continue;
+        BlockBytes += B->getSize();
+        uint64_t First = B->getAddress().getValue() / PageSize;
+        uint64_t Last = (B->getAddress() + B->getSize() - 1).getValue() /
+                        PageSize;
+        for (uint64_t P = First; P <= Last; ++P)
+          Pages.insert(P);
+      }
+    }
+  }
+
+  uint64_t PageSize;
+  std::mutex M;
+  uint64_t BlockBytes = 0;
+  DenseSet<uint64_t> Pages;
+};
+
+} // end anonymous namespace
+
+static void orcMemoryOverhead(benchmark::State &State) {
+  uint64_t NumFunctions = 0, BlockBytes = 0, PageBytes = 0;
+  for (auto _ : State) {
+    State.PauseTiming();
+    Corpus C = loadCorpus(64, 64);
+    if (!C.Error.empty()) {
+      State.SkipWithError(C.Error);
+      return;
+    }
+    State.ResumeTiming();
+
+    auto Plugin = std::make_shared<FootprintPlugin>();
+    auto J =
+        LLJITBuilder()
+            .setObjectLinkingLayerCreator(
+                [&](ExecutionSession &ES, const Triple &TT)
+                    -> Expected<std::unique_ptr<ObjectLayer>> {
+                  auto L = std::make_unique<ObjectLinkingLayer>(ES);
+                  L->addPlugin(Plugin);
+                  return std::move(L);
+                })
+            .create();
+    if (!J) {
+      State.SkipWithError(toString(J.takeError()));
+      return;
+    }
+    for (auto &TSM : C.Modules)
+      if (Error Err = (*J)->addIRModule(std::move(TSM))) {
+        State.SkipWithError(toString(std::move(Err)));
+        return;
+      }
+
+    SymbolLookupSet Symbols;
+    for (const std::string &Name : C.Functions)
+      Symbols.add((*J)->mangleAndIntern(Name));
+    auto Result = (*J)->getExecutionSession().lookup(
+        makeJITDylibSearchOrder(&(*J)->getMainJITDylib()), std::move(Symbols));
+    if (!Result) {
+      State.SkipWithError(toString(Result.takeError()));
+      return;
+    }
+
+    NumFunctions += C.Functions.size();
+    BlockBytes += Plugin->getBlockBytes();
+    PageBytes += Plugin->getPageBytes();
+  }
+
+  if (!NumFunctions)
+    return;
+  State.counters["block_bytes/function"] = double(BlockBytes) / NumFunctions;
+  State.counters["page_bytes/function"] = double(PageBytes) / NumFunctions;
+  State.counters["overhead"] = BlockBytes ? double(PageBytes) / BlockBytes : 0;
+}
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "ORC JIT benchmarks\n");
+
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+
+  benchmark::RegisterBenchmark("OrcFirstCallLatency", orcFirstCallLatency)
+      ->Unit(benchmark::kMillisecond)
+      ->Arg(100)
+      ->Arg(1000);
+  benchmark::RegisterBenchmark("OrcCompileThroughput", orcCompileThroughput)
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime()
+      ->Arg(0)
+      ->Arg(2)
+      ->Arg(4)
+      ->Arg(8);
+  benchmark::RegisterBenchmark("OrcMemoryOverhead", orcMemoryOverhead)
+      ->Unit(benchmark::kMillisecond);
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,646 @@
+//===- llvm/ADT/FlatHashMap.h - Group probed hash table ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines the FlatHashMap class, an open addressing hash map in the
+/// style of the "Swiss tables" of Abseil.
+///
+/// Every slot has a control byte which is either empty, deleted, or holds the
+/// low 7 bits of the hash of the key in the slot. The control bytes are probed
+/// a group (16 with SSE2 or NEON, 8 otherwise) at a time, so a lookup usually
+/// compares a single key, and keys do not need reserved empty and tombstone
+/// values. A deleted slot only leaves a tombstone if its group is full.
+///
+/// FlatHashMap mostly has the same interface as DenseMap and uses DenseMapInfo
+/// to hash and compare keys, but getEmptyKey() and getTombstoneKey() are never
+/// called, so every key value can be stored. As for DenseMap, insertions
+/// invalidate iterators and references, and the iteration order is
+/// unspecified.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_FLATHASHMAP_H
+#define LLVM_ADT_FLATHASHMAP_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/EpochTracker.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemAlloc.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LLVM_FLATHASHMAP_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__) && !defined(__ARM_BIG_ENDIAN)
+#define LLVM_FLATHASHMAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace llvm {
+
+namespace detail {
+
+/// Control byte values. The control byte of a full slot holds the low 7 bits
+/// of the hash, so the sign bit is only set for empty and deleted slots.
+enum : int8_t { FlatHashEmpty = -128, FlatHashDeleted = -2 };
+
+/// The slots of a group that match a condition. Every slot is represented by
+/// a single bit at Shift bits per slot.
+template <typename T, unsigned Shift> class FlatHashBitMask {
+  T Mask;
+
+public:
+  explicit FlatHashBitMask(T Mask) : Mask(Mask) {}
+
+  explicit operator bool() const { return Mask != 0; }
+
+  /// Return the index of the first matching slot.
+  unsigned lowest() const { return llvm::countr_zero(Mask) >> Shift; }
+
+  void clearLowest() { Mask &= Mask - 1; }
+};
+
+/// A group of control bytes that are matched at once.
+class FlatHashGroup {
+#if defined(LLVM_FLATHASHMAP_SSE2)
+  __m128i Ctrl;
+
+public:
+  static constexpr unsigned Width = 16;
+  using BitMask = FlatHashBitMask<uint32_t, 0>;
+
+  explicit FlatHashGroup(const int8_t *P)
+      : Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(P))) {}
+
+  BitMask match(int8_t H2) const {
+    return BitMask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Ctrl)));
+  }
+  BitMask matchEmptyOrDeleted() const {
+    return BitMask(_mm_movemask_epi8(Ctrl));
+  }
+#elif defined(LLVM_FLATHASHMAP_NEON)
+  int8x16_t Ctrl;
+
+  // Narrow every byte of the comparison result to 4 bits and keep one of them.
+  static uint64_t toMask(uint8x16_t Eq) {
+    uint8x8_t Narrowed = vshrn_n_u16(vreinterpretq_u16_u8(Eq), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(Narrowed), 0) &
+           0x8888888888888888ULL;
+  }
+
+public:
+  static constexpr unsigned Width = 16;
+  using BitMask = FlatHashBitMask<uint64_t, 2>;
+
+  explicit FlatHashGroup(const int8_t *P) : Ctrl(vld1q_s8(P)) {}
+
+  BitMask match(int8_t H2) const {
+    return BitMask(toMask(vceqq_s8(Ctrl, vdupq_n_s8(H2))));
+  }
+  BitMask matchEmptyOrDeleted() const {
+    return BitMask(toMask(vcltzq_s8(Ctrl)));
+  }
+#else
+  static constexpr uint64_t LSBs = 0x0101010101010101ULL;
+  static constexpr uint64_t MSBs = 0x8080808080808080ULL;
+  uint64_t Ctrl;
+
+public:
+  static constexpr unsigned Width = 8;
+  using BitMask = FlatHashBitMask<uint64_t, 3>;
+
+  explicit FlatHashGroup(const int8_t *P)
+      : Ctrl(support::endian::read64le(P)) {}
+
+  // Find the zero bytes of Ctrl ^ H2. This may have false positives right
+  // after a true match, but never for empty or deleted slots, which is fine
+  // as the keys are compared anyway.
+  BitMask match(int8_t H2) const {
+    uint64_t X = Ctrl ^ (LSBs * uint8_t(H2));
+    return BitMask((X - LSBs) & ~X & MSBs);
+  }
+  BitMask matchEmptyOrDeleted() const { return BitMask(Ctrl & MSBs); }
+#endif
+
+  BitMask matchEmpty() const {
+#if defined(LLVM_FLATHASHMAP_SSE2) || defined(LLVM_FLATHASHMAP_NEON)
+    return match(FlatHashEmpty);
+#else
+    // Empty is the only control byte with the sign bit set and bit 1 clear.
+    return BitMask((Ctrl & ~(Ctrl << 6)) & MSBs);
+#endif
+  }
+};
+
+} // end namespace detail
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, bool IsConst>
+class FlatHashMapIterator;
+
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>>
+class FlatHashMap : public DebugEpochBase {
+  using Group = detail::FlatHashGroup;
+  static constexpr unsigned GroupWidth = Group::Width;
+
+public:
+  using size_type = unsigned;
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  using value_type = detail::DenseMapPair<KeyT, ValueT>;
+  using iterator = FlatHashMapIterator<KeyT, ValueT, KeyInfoT, false>;
+  using const_iterator = FlatHashMapIterator<KeyT, ValueT, KeyInfoT, true>;
+
+private:
+  value_type *Slots = nullptr;
+  int8_t *Ctrl = nullptr;
+  unsigned Capacity = 0;
+  unsigned Size = 0;
+  /// The number of empty slots that may still be filled before a rehash.
+  unsigned GrowthLeft = 0;
+
+public:
+  explicit FlatHashMap(unsigned InitialReserve = 0) { reserve(InitialReserve); }
+
+  FlatHashMap(const FlatHashMap &Other) : DebugEpochBase() { copyFrom(Other); }
+
+  FlatHashMap(FlatHashMap &&Other) : DebugEpochBase() { swap(Other); }
+
+  template <typename InputIt> FlatHashMap(const InputIt &I, const InputIt &E) {
+    insert(I, E);
+  }
+
+  FlatHashMap(std::initializer_list<value_type> Vals) {
+    reserve(Vals.size());
+    insert(Vals.begin(), Vals.end());
+  }
+
+  ~FlatHashMap() {
+    destroyAll();
+    deallocate();
+  }
+
+  FlatHashMap &operator=(const FlatHashMap &Other) {
+    if (&Other != this) {
+      incrementEpoch();
+      destroyAll();
+      deallocate();
+      copyFrom(Other);
+    }
+    return *this;
+  }
+
+  FlatHashMap &operator=(FlatHashMap &&Other) {
+    incrementEpoch();
+    destroyAll();
+    deallocate();
+    Slots = nullptr;
+    Ctrl = nullptr;
+    Capacity = Size = GrowthLeft = 0;
+    swap(Other);
+    return *this;
+  }
+
+  void swap(FlatHashMap &Other) {
+    incrementEpoch();
+    Other.incrementEpoch();
+    std::swap(Slots, Other.Slots);
+    std::swap(Ctrl, Other.Ctrl);
+    std::swap(Capacity, Other.Capacity);
+    std::swap(Size, Other.Size);
+    std::swap(GrowthLeft, Other.GrowthLeft);
+  }
+
+  iterator begin() { return makeIterator(0); }
+  iterator end() { return makeIterator(Capacity); }
+  const_iterator begin() const { return makeConstIterator(0); }
+  const_iterator end() const { return makeConstIterator(Capacity); }
+
+  [[nodiscard]] bool empty() const { return Size == 0; }
+  unsigned size() const { return Size; }
+
+  /// Grow the table so that NumEntries entries can be inserted without
+  /// rehashing.
+  void reserve(size_type NumEntries) {
+    if (NumEntries <= Size + GrowthLeft)
+      return;
+    incrementEpoch();
+    rehash(capacityFor(NumEntries));
+  }
+
+  void clear() {
+    incrementEpoch();
+    if (Size == 0 && GrowthLeft == maxLoad(Capacity))
+      return;
+    destroyAll();
+    if (Capacity)
+      std::memset(Ctrl, detail::FlatHashEmpty, Capacity);
+    Size = 0;
+    GrowthLeft = maxLoad(Capacity);
+  }
+
+  /// Return true if the specified key is in the map, false otherwise.
+  bool contains(const KeyT &Key) const { return findSlot(Key) != Capacity; }
+
+  /// Return 1 if the specified key is in the map, 0 otherwise.
+  size_type count(const KeyT &Key) const { return contains(Key) ? 1 : 0; }
+
+  iterator find(const KeyT &Key) { return makeIterator(findSlot(Key)); }
+  const_iterator find(const KeyT &Key) const {
+    return makeConstIterator(findSlot(Key));
+  }
+
+  /// Alternate version of find() which allows a different, and possibly less
+  /// expensive, key type. The DenseMapInfo is responsible for supplying
+  /// methods getHashValue(LookupKeyT) and isEqual(LookupKeyT, KeyT) for each
+  /// key type used.
+  template <class LookupKeyT> iterator find_as(const LookupKeyT &Key) {
+    return makeIterator(findSlot(Key));
+  }
+  template <class LookupKeyT>
+  const_iterator find_as(const LookupKeyT &Key) const {
+    return makeConstIterator(findSlot(Key));
+  }
+
+  /// Return the entry for the specified key, or a default constructed value
+  /// if no such entry exists.
+  ValueT lookup(const KeyT &Key) const {
+    unsigned I = findSlot(Key);
+    if (I != Capacity)
+      return Slots[I].getSecond();
+    return ValueT();
+  }
+
+  /// Return the entry for the specified key, or abort if no such entry exists.
+  const ValueT &at(const KeyT &Key) const {
+    unsigned I = findSlot(Key);
+    assert(I != Capacity && "FlatHashMap::at failed due to a missing key");
+    return Slots[I].getSecond();
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(const value_type &KV) {
+    return try_emplace(KV.first, KV.second);
+  }
+  std::pair<iterator, bool> insert(value_type &&KV) {
+    return try_emplace(std::move(KV.first), std::move(KV.second));
+  }
+
+  /// Insert a range of pairs. Existing keys are not updated.
+  template <typename InputIt> void insert(InputIt I, InputIt E) {
+    for (; I != E; ++I)
+      insert(*I);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(KeyT &&Key, Ts &&...Args) {
+    auto [I, Inserted] = findOrPrepareInsert(Key);
+    if (Inserted)
+      ::new (&Slots[I]) value_type(std::piecewise_construct,
+                                   std::forward_as_tuple(std::move(Key)),
+                                   std::forward_as_tuple(
+                                       std::forward<Ts>(Args)...));
+    return {makeIterator(I, /*NoAdvance=*/true), Inserted};
+  }
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(const KeyT &Key, Ts &&...Args) {
+    auto [I, Inserted] = findOrPrepareInsert(Key);
+    if (Inserted)
+      ::new (&Slots[I]) value_type(std::piecewise_construct,
+                                   std::forward_as_tuple(Key),
+                                   std::forward_as_tuple(
+                                       std::forward<Ts>(Args)...));
+    return {makeIterator(I, /*NoAdvance=*/true), Inserted};
+  }
+
+  template <typename V>
+  std::pair<iterator, bool> insert_or_assign(const KeyT &Key, V &&Val) {
+    auto Ret = try_emplace(Key, std::forward<V>(Val));
+    if (!Ret.second)
+      Ret.first->second = std::forward<V>(Val);
+    return Ret;
+  }
+  template <typename V>
+  std::pair<iterator, bool> insert_or_assign(KeyT &&Key, V &&Val) {
+    auto Ret = try_emplace(std::move(Key), std::forward<V>(Val));
+    if (!Ret.second)
+      Ret.first->second = std::forward<V>(Val);
+    return Ret;
+  }
+
+  ValueT &operator[](const KeyT &Key) { return try_emplace(Key).first->second; }
+  ValueT &operator[](KeyT &&Key) {
+    return try_emplace(std::move(Key)).first->second;
+  }
+
+  /// Erase the entry for the specified key. Return true if it existed.
+  bool erase(const KeyT &Key) {
+    unsigned I = findSlot(Key);
+    if (I == Capacity)
+      return false;
+    eraseSlot(I);
+    return true;
+  }
+  void erase(iterator It) { eraseSlot(It.Ptr - Slots); }
+
+  /// Return the approximate size (in bytes) of the actual map.
+  size_t getMemorySize() const {
+    return size_t(Capacity) * (sizeof(value_type) + 1);
+  }
+
+private:
+  friend class FlatHashMapIterator<KeyT, ValueT, KeyInfoT, false>;
+  friend class FlatHashMapIterator<KeyT, ValueT, KeyInfoT, true>;
+
+  iterator makeIterator(unsigned I, bool NoAdvance = false) {
+    return iterator(Slots + I, Ctrl + I, Slots + Capacity, *this, NoAdvance);
+  }
+  const_iterator makeConstIterator(unsigned I) const {
+    return const_iterator(Slots + I, Ctrl + I, Slots + Capacity, *this);
+  }
+
+  static unsigned maxLoad(unsigned Capacity) {
+    return Capacity - Capacity / 8;
+  }
+
+  static unsigned capacityFor(size_type NumEntries) {
+    if (!NumEntries)
+      return 0;
+    unsigned Capacity = PowerOf2Ceil(uint64_t(NumEntries) * 8 / 7 + 1);
+    return std::max(Capacity, GroupWidth);
+  }
+
+  // DenseMapInfo hashes are often weak, e.g. for pointers, so mix them before
+  // taking the low 7 bits for the control byte and the next bits for the
+  // group.
+  template <typename LookupKeyT> static uint64_t hash(const LookupKeyT &Key) {
+    uint64_t H = uint64_t(KeyInfoT::getHashValue(Key)) * 0x9E3779B97F4A7C15ULL;
+    return H ^ (H >> 32);
+  }
+  static int8_t h2(uint64_t Hash) { return Hash & 0x7f; }
+
+  /// Visit the groups of the probe sequence of Hash, that is the group given
+  /// by the hash and then triangular steps, until Callback returns true.
+  /// Return the index of the first slot of that group.
+  template <typename CallbackT>
+  unsigned probe(uint64_t Hash, CallbackT Callback) const {
+    assert(Capacity && "probing an empty table");
+    unsigned GroupMask = Capacity / GroupWidth - 1;
+    unsigned G = (Hash >> 7) & GroupMask;
+    for (unsigned Step = 1;; G = (G + Step++) & GroupMask) {
+      unsigned Offset = G * GroupWidth;
+      if (Callback(Offset, Group(Ctrl + Offset)))
+        return Offset;
+    }
+  }
+
+  /// Return the slot of Key, or Capacity if it does not exist.
+  template <typename LookupKeyT>
+  unsigned findSlot(const LookupKeyT &Key) const {
+    if (!Capacity)
+      return 0;
+    uint64_t Hash = hash(Key);
+    unsigned Found = Capacity;
+    probe(Hash, [&](unsigned Offset, const Group &G) {
+      for (auto M = G.match(h2(Hash)); M; M.clearLowest()) {
+        unsigned I = Offset + M.lowest();
+        if (KeyInfoT::isEqual(Key, Slots[I].getFirst())) {
+          Found = I;
+          return true;
+        }
+      }
+      // Entries are never inserted past a group with an empty slot.
+      return bool(G.matchEmpty());
+    });
+    return Found;
+  }
+
+  /// Return the first empty or deleted slot of the probe sequence of Hash.
+  unsigned findFirstNonFull(uint64_t Hash) const {
+    unsigned I = 0;
+    probe(Hash, [&](unsigned Offset, const Group &G) {
+      auto M = G.matchEmptyOrDeleted();
+      if (M)
+        I = Offset + M.lowest();
+      return bool(M);
+    });
+    return I;
+  }
+
+  /// Return the slot of Key, and whether a new entry has to be constructed
+  /// in it.
+  std::pair<unsigned, bool> findOrPrepareInsert(const KeyT &Key) {
+    unsigned I = findSlot(Key);
+    if (Capacity && I != Capacity)
+      return {I, false};
+
+    incrementEpoch();
+    uint64_t Hash = hash(Key);
+    if (Capacity)
+      I = findFirstNonFull(Hash);
+    // A deleted slot can be reused without rehashing.
+    if (!Capacity || (!GrowthLeft && Ctrl[I] != detail::FlatHashDeleted)) {
+      // Only grow if the table is mostly filled with entries rather than
+      // tombstones, otherwise drop the tombstones.
+      rehash(Size + 1 > maxLoad(Capacity) / 2
+                 ? std::max(Capacity * 2, GroupWidth)
+                 : Capacity);
+      I = findFirstNonFull(Hash);
+    }
+    if (Ctrl[I] == detail::FlatHashEmpty)
+      --GrowthLeft;
+    Ctrl[I] = h2(Hash);
+    ++Size;
+    return {I, true};
+  }
+
+  void eraseSlot(unsigned I) {
+    assert(I < Capacity && Ctrl[I] >= 0 && "erasing an empty slot");
+    Slots[I].~value_type();
+    --Size;
+    // Lookups stop at a group with an empty slot, so they never probe past
+    // this group and the slot does not need to leave a tombstone.
+    if (Group(Ctrl + I / GroupWidth * GroupWidth).matchEmpty()) {
+      Ctrl[I] = detail::FlatHashEmpty;
+      ++GrowthLeft;
+    } else {
+      Ctrl[I] = detail::FlatHashDeleted;
+    }
+  }
+
+  void allocate(unsigned NewCapacity) {
+    Capacity = NewCapacity;
+    GrowthLeft = maxLoad(Capacity);
+    if (!Capacity) {
+      Slots = nullptr;
+      Ctrl = nullptr;
+      return;
+    }
+    Slots = static_cast<value_type *>(allocate_buffer(
+        size_t(Capacity) * (sizeof(value_type) + 1), alignof(value_type)));
+    Ctrl = reinterpret_cast<int8_t *>(Slots + Capacity);
+    std::memset(Ctrl, detail::FlatHashEmpty, Capacity);
+  }
+
+  void deallocate() {
+    if (Capacity)
+      deallocate_buffer(Slots, size_t(Capacity) * (sizeof(value_type) + 1),
+                        alignof(value_type));
+  }
+
+  void destroyAll() {
+    if (std::is_trivially_destructible_v<value_type>)
+      return;
+    for (unsigned I = 0; I != Capacity; ++I)
+      if (Ctrl[I] >= 0)
+        Slots[I].~value_type();
+  }
+
+  void rehash(unsigned NewCapacity) {
+    value_type *OldSlots = Slots;
+    int8_t *OldCtrl = Ctrl;
+    unsigned OldCapacity = Capacity;
+    allocate(NewCapacity);
+    for (unsigned I = 0; I != OldCapacity; ++I) {
+      if (OldCtrl[I] < 0)
+        continue;
+      uint64_t Hash = hash(OldSlots[I].getFirst());
+      unsigned J = findFirstNonFull(Hash);
+      Ctrl[J] = h2(Hash);
+      ::new (&Slots[J]) value_type(std::move(OldSlots[I]));
+      OldSlots[I].~value_type();
+    }
+    GrowthLeft -= Size;
+    if (OldCapacity)
+      deallocate_buffer(OldSlots,
+                        size_t(OldCapacity) * (sizeof(value_type) + 1),
+                        alignof(value_type));
+  }
+
+  void copyFrom(const FlatHashMap &Other) {
+    allocate(Other.Capacity);
+    Size = Other.Size;
+    GrowthLeft = Other.GrowthLeft;
+    if (!Capacity)
+      return;
+    std::memcpy(Ctrl, Other.Ctrl, Capacity);
+    for (unsigned I = 0; I != Capacity; ++I)
+      if (Ctrl[I] >= 0)
+        ::new (&Slots[I]) value_type(Other.Slots[I]);
+  }
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, bool IsConst>
+class FlatHashMapIterator : DebugEpochBase::HandleBase {
+  friend class FlatHashMap<KeyT, ValueT, KeyInfoT>;
+  friend class FlatHashMapIterator<KeyT, ValueT, KeyInfoT, true>;
+  friend class FlatHashMapIterator<KeyT, ValueT, KeyInfoT, false>;
+
+  using Bucket = detail::DenseMapPair<KeyT, ValueT>;
+
+public:
+  using difference_type = ptrdiff_t;
+  using value_type = std::conditional_t<IsConst, const Bucket, Bucket>;
+  using pointer = value_type *;
+  using reference = value_type &;
+  using iterator_category = std::forward_iterator_tag;
+
+private:
+  pointer Ptr = nullptr;
+  const int8_t *Ctrl = nullptr;
+  pointer End = nullptr;
+
+  FlatHashMapIterator(pointer Pos, const int8_t *PosCtrl, pointer E,
+                      const DebugEpochBase &Epoch, bool NoAdvance = false)
+      : DebugEpochBase::HandleBase(&Epoch), Ptr(Pos), Ctrl(PosCtrl), End(E) {
+    if (!NoAdvance)
+      advancePastEmptySlots();
+  }
+
+public:
+  FlatHashMapIterator() = default;
+
+  // Converting ctor from non-const iterators to const iterators. SFINAE'd out
+  // for const iterator destinations so it doesn't end up as a user defined copy
+  // constructor.
+  template <bool IsConstSrc,
+            typename = std::enable_if_t<!IsConstSrc && IsConst>>
+  FlatHashMapIterator(
+      const FlatHashMapIterator<KeyT, ValueT, KeyInfoT, IsConstSrc> &I)
+      : DebugEpochBase::HandleBase(I), Ptr(I.Ptr), Ctrl(I.Ctrl), End(I.End) {}
+
+  reference operator*() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    assert(Ptr != End && "dereferencing end() iterator");
+    return *Ptr;
+  }
+  pointer operator->() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    assert(Ptr != End && "dereferencing end() iterator");
+    return Ptr;
+  }
+
+  friend bool operator==(const FlatHashMapIterator &LHS,
+                         const FlatHashMapIterator &RHS) {
+    assert((!LHS.Ptr || LHS.isHandleInSync()) && "handle not in sync!");
+    assert((!RHS.Ptr || RHS.isHandleInSync()) && "handle not in sync!");
+    assert(LHS.getEpochAddress() == RHS.getEpochAddress() &&
+           "comparing incomparable iterators!");
+    return LHS.Ptr == RHS.Ptr;
+  }
+  friend bool operator!=(const FlatHashMapIterator &LHS,
+                         const FlatHashMapIterator &RHS) {
+    return !(LHS == RHS);
+  }
+
+  FlatHashMapIterator &operator++() { // Preincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    assert(Ptr != End && "incrementing end() iterator");
+    ++Ptr;
+    ++Ctrl;
+    advancePastEmptySlots();
+    return *this;
+  }
+  FlatHashMapIterator operator++(int) { // Postincrement
+    FlatHashMapIterator Tmp = *this;
+    ++*this;
+    return Tmp;
+  }
+
+private:
+  void advancePastEmptySlots() {
+    while (Ptr != End && *Ctrl < 0) {
+      ++Ptr;
+      ++Ctrl;
+    }
+  }
+};
+
+} // end namespace llvm
+
+#undef LLVM_FLATHASHMAP_SSE2
+#undef LLVM_FLATHASHMAP_NEON
+
+#endif // LLVM_ADT_FLATHASHMAP_H
@@ -46,68 +46,75 @@ class raw_ostream;
 class raw_fd_ostream;
 class StringRef;
 
+/// A statistic that counts. To keep counting cheap when many threads bump the
+/// same statistics, as in parallel ThinLTO backends or lld, increments and
+/// decrements go to a per-thread shard of counters without read-modify-write
+/// operations, and the shards are summed up when the value is read.
 class TrackingStatistic {
 public:
   const char *const DebugType;
   const char *const Name;
   const char *const Desc;
 
+  /// The part of the value that is not in the per-thread shards: the value
+  /// assigned last and the maxima of updateMax.
   std::atomic<uint64_t> Value;
   std::atomic<bool> Initialized;
+  /// The index of this statistic in the per-thread shards, assigned when it
+  /// is first registered. 0 if the statistic has no shard slot.
+  std::atomic<unsigned> ShardIndex;
 
   constexpr TrackingStatistic(const char *DebugType, const char *Name,
                               const char *Desc)
       : DebugType(DebugType), Name(Name), Desc(Desc), Value(0),
-        Initialized(false) {}
+        Initialized(false), ShardIndex(0) {}
 
   const char *getDebugType() const { return DebugType; }
   const char *getName() const { return Name; }
   const char *getDesc() const { return Desc; }
 
-  uint64_t getValue() const { return Value.load(std::memory_order_relaxed); }
+  uint64_t getValue() const {
+    uint64_t V = Value.load(std::memory_order_relaxed);
+    if (unsigned I = ShardIndex.load(std::memory_order_relaxed))
+      V += sumShards(I);
+    return V;
+  }
 
   // Allow use of this class as the value itself.
   operator uint64_t() const { return getValue(); }
 
   const TrackingStatistic &operator=(uint64_t Val) {
+    init();
     Value.store(Val, std::memory_order_relaxed);
-    return init();
+    if (unsigned I = ShardIndex.load(std::memory_order_relaxed))
+      clearShards(I);
+    return *this;
   }
 
-  const TrackingStatistic &operator++() {
-    Value.fetch_add(1, std::memory_order_relaxed);
-    return init();
-  }
+  const TrackingStatistic &operator++() { return add(1); }
 
-  uint64_t operator++(int) {
-    init();
-    return Value.fetch_add(1, std::memory_order_relaxed);
-  }
+  // The postfix operators do not return the previous value, which would have
+  // to be summed up from all the shards.
+  void operator++(int) { add(1); }
 
-  const TrackingStatistic &operator--() {
-    Value.fetch_sub(1, std::memory_order_relaxed);
-    return init();
-  }
+  const TrackingStatistic &operator--() { return add(-1); }
 
-  uint64_t operator--(int) {
-    init();
-    return Value.fetch_sub(1, std::memory_order_relaxed);
-  }
+  void operator--(int) { add(-1); }
 
   const TrackingStatistic &operator+=(uint64_t V) {
     if (V == 0)
       return *this;
-    Value.fetch_add(V, std::memory_order_relaxed);
-    return init();
+    return add(V);
   }
 
   const TrackingStatistic &operator-=(uint64_t V) {
     if (V == 0)
       return *this;
-    Value.fetch_sub(V, std::memory_order_relaxed);
-    return init();
+    return add(-V);
   }
 
+  /// Raise the value to \p V if it is smaller. This is meant for statistics
+  /// that track a maximum, and are not otherwise incremented.
   void updateMax(uint64_t V) {
     uint64_t PrevMax = Value.load(std::memory_order_relaxed);
     // Keep trying to update max until we succeed or another thread produces
@@ -125,7 +132,20 @@ protected:
     return *this;
   }
 
+  /// Add \p V, modulo 2^64, to the shard of the calling thread.
+  const TrackingStatistic &add(uint64_t V) {
+    init();
+    if (unsigned I = ShardIndex.load(std::memory_order_relaxed))
+      addToShard(I, V);
+    else
+      Value.fetch_add(V, std::memory_order_relaxed);
+    return *this;
+  }
+
   void RegisterStatistic();
+  static void addToShard(unsigned Index, uint64_t V);
+  static uint64_t sumShards(unsigned Index);
+  static void clearShards(unsigned Index);
 };
 
 class NoopStatistic {
@@ -142,11 +162,11 @@ public:
 
   const NoopStatistic &operator++() { return *this; }
 
-  uint64_t operator++(int) { return 0; }
+  void operator++(int) {}
 
   const NoopStatistic &operator--() { return *this; }
 
-  uint64_t operator--(int) { return 0; }
+  void operator--(int) {}
 
   const NoopStatistic &operator+=(const uint64_t &V) { return *this; }
 
@@ -298,7 +298,16 @@ public:
   /// passes that lazily update the DT while performing AA queries.
   bool UseDominatorTree = true;
 
+  /// Uniquely identifies this query info. Alias analyses may use it to tag
+  /// storage derived from the IR, such as decomposed GEPs, that stays valid as
+  /// long as this query info is alive, because the IR must not change within
+  /// a batch of queries.
+  const uint64_t BatchID = getNextBatchID();
+
   AAQueryInfo(AAResults &AAR, CaptureAnalysis *CA) : AAR(AAR), CA(CA) {}
+
+private:
+  static uint64_t getNextBatchID();
 };
 
 /// AAQueryInfo that uses SimpleCaptureAnalysis.
@@ -640,6 +649,17 @@ public:
   AliasResult alias(const MemoryLocation &LocA, const MemoryLocation &LocB) {
     return AA.alias(LocA, LocB, AAQI);
   }
+  /// Alias \p Loc against each of \p Others, appending the results to
+  /// \p Results in the same order. This is cheaper than issuing the queries
+  /// one by one through separate BatchAAResults, as the information derived
+  /// for \p Loc, like its underlying object and GEP decomposition, is only
+  /// computed once.
+  void alias(const MemoryLocation &Loc, ArrayRef<MemoryLocation> Others,
+             SmallVectorImpl<AliasResult> &Results) {
+    Results.reserve(Results.size() + Others.size());
+    for (const MemoryLocation &Other : Others)
+      Results.push_back(AA.alias(Loc, Other, AAQI));
+  }
   bool pointsToConstantMemory(const MemoryLocation &Loc, bool OrLocal = false) {
     return isNoModRef(AA.getModRefInfoMask(Loc, AAQI, OrLocal));
   }
@@ -54,15 +54,10 @@ class BasicAAResult : public AAResultBase {
 public:
   BasicAAResult(const DataLayout &DL, const Function &F,
                 const TargetLibraryInfo &TLI, AssumptionCache &AC,
-                DominatorTree *DT = nullptr)
-      : DL(DL), F(F), TLI(TLI), AC(AC), DT_(DT) {}
-
-  BasicAAResult(const BasicAAResult &Arg)
-      : AAResultBase(Arg), DL(Arg.DL), F(Arg.F), TLI(Arg.TLI), AC(Arg.AC),
-        DT_(Arg.DT_) {}
-  BasicAAResult(BasicAAResult &&Arg)
-      : AAResultBase(std::move(Arg)), DL(Arg.DL), F(Arg.F), TLI(Arg.TLI),
-        AC(Arg.AC), DT_(Arg.DT_) {}
+                DominatorTree *DT = nullptr);
+  BasicAAResult(const BasicAAResult &Arg);
+  BasicAAResult(BasicAAResult &&Arg);
+  ~BasicAAResult();
 
   /// Handle invalidation events in the new pass manager.
   bool invalidate(Function &Fn, const PreservedAnalyses &PA,
@@ -103,6 +98,23 @@ private:
   /// Tracks instructions visited by pointsToConstantMemory.
   SmallPtrSet<const Value *, 16> Visited;
 
+  struct BatchCacheT;
+
+  /// Decomposed GEPs and underlying objects computed for the queries of a
+  /// single AAQueryInfo. The IR does not change while it is alive, so this is
+  /// reused across the queries of a BatchAAResults and discarded once a query
+  /// with a different AAQueryInfo comes in. Not copied along with the result.
+  std::unique_ptr<BatchCacheT> BatchCache;
+
+  BatchCacheT &getBatchCache(const AAQueryInfo &AAQI);
+
+  /// Return DecomposeGEPExpression(V), reusing earlier results of the batch.
+  DecomposedGEP getDecomposedGEP(const Value *V, const AAQueryInfo &AAQI);
+
+  /// Return getUnderlyingObject(V), reusing earlier results of the batch.
+  const Value *getUnderlyingObjectCached(const Value *V,
+                                         const AAQueryInfo &AAQI);
+
   static DecomposedGEP
   DecomposeGEPExpression(const Value *V, const DataLayout &DL,
                          AssumptionCache *AC, DominatorTree *DT);
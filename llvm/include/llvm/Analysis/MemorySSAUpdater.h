@@ -222,6 +222,13 @@ public:
       removeMemoryAccess(MA, OptimizePhis);
   }
 
+  /// Remove a set of MemoryAccesses from MemorySSA, as if by calling
+  /// removeMemoryAccess on each of them in order. If \p OptimizePhis is true,
+  /// the phis whose incoming values changed are only checked for triviality
+  /// once, after all accesses have been removed.
+  void removeMemoryAccesses(ArrayRef<MemoryAccess *> MAs,
+                            bool OptimizePhis = false);
+
   /// Remove all MemoryAcceses in a set of BasicBlocks about to be deleted.
   /// Assumption we make here: all uses of deleted defs and phi must either
   /// occur in blocks about to be deleted (thus will be deleted as well), or
@@ -246,6 +253,9 @@ private:
   // Move all memory accesses from `From` to `To` starting at `Start`.
   // Restrictions apply, see public wrappers of this method.
   void moveAllAccesses(BasicBlock *From, BasicBlock *To, Instruction *Start);
+  void removeMemoryAccessImpl(MemoryAccess *MA,
+                              SmallSetVector<MemoryPhi *, 4> *PhisToCheck);
+  void optimizePhis(SmallSetVector<MemoryPhi *, 4> &Phis);
   MemoryAccess *getPreviousDef(MemoryAccess *);
   MemoryAccess *getPreviousDefInBlock(MemoryAccess *);
   MemoryAccess *
@@ -1725,15 +1725,10 @@ private:
   /// Used to parameterize getRange
   enum RangeSignHint { HINT_RANGE_UNSIGNED, HINT_RANGE_SIGNED };
 
-  /// Set the memoized range for the given SCEV.
+  /// Set the memoized range for the given SCEV. The cache is flushed first if
+  /// it has reached -scalar-evolution-max-cache-entries.
   const ConstantRange &setRange(const SCEV *S, RangeSignHint Hint,
-                                ConstantRange CR) {
-    DenseMap<const SCEV *, ConstantRange> &Cache =
-        Hint == HINT_RANGE_UNSIGNED ? UnsignedRanges : SignedRanges;
-
-    auto Pair = Cache.insert_or_assign(S, std::move(CR));
-    return Pair.first->second;
-  }
+                                ConstantRange CR);
 
   /// Determine the range for a particular SCEV.
   /// NOTE: This returns a reference to an entry in a cache. It must be
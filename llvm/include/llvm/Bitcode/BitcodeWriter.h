@@ -26,6 +26,7 @@
 namespace llvm {
 
 class BitstreamWriter;
+struct BitcodeLTOInfo;
 class Module;
 class raw_ostream;
 
@@ -44,6 +45,9 @@ class BitcodeWriter {
 
   std::vector<Module *> Mods;
 
+  // The LTO information of each module in Mods, as a reader will find it.
+  std::vector<BitcodeLTOInfo> LTOInfos;
+
 public:
   /// Create a BitcodeWriter that writes to Buffer.
   BitcodeWriter(SmallVectorImpl<char> &Buffer);
@@ -196,6 +196,23 @@ public:
   /// Retrieve the number of bits currently used to encode an abbrev ID.
   unsigned GetAbbrevIDWidth() const { return CurCodeSize; }
 
+  /// Use the abbreviations that \p Other recorded from its BLOCKINFO block,
+  /// so that blocks written by this writer can be copied into the stream of
+  /// \p Other with emitAlignedBytes.
+  void copyBlockInfo(const BitstreamWriter &Other) {
+    BlockInfoRecords = Other.BlockInfoRecords;
+  }
+
+  /// Append \p Bytes, which were written by another BitstreamWriter starting
+  /// and ending at 32-bit boundaries, to the stream. The current position must
+  /// be at a 32-bit boundary.
+  void emitAlignedBytes(ArrayRef<char> Bytes) {
+    assert(CurBit == 0 && "Not 32-bit aligned");
+    assert((Bytes.size() & 3) == 0 && "Bytes not a multiple of 32 bits");
+    Buffer.append(Bytes.begin(), Bytes.end());
+    FlushToFile();
+  }
+
   //===--------------------------------------------------------------------===//
   // Basic Primitives for emitting bits to the stream.
   //===--------------------------------------------------------------------===//
@@ -26,6 +26,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/TargetParser/Triple.h"
 #include <mutex>
+#include <optional>
 
 namespace llvm {
 
@@ -264,6 +265,16 @@ std::unique_ptr<Module> loadModuleForTwoRounds(BitcodeModule &OrigModule,
 /// \return the combined hash of the merged codegen data.
 Expected<stable_hash> mergeCodeGenData(ArrayRef<StringRef> ObjectFiles);
 
+/// Merge the codegen data from the scratch objects \p ObjectFiles like
+/// mergeCodeGenData(), and save it to \p Path in the indexed format instead of
+/// publishing it. The file replaces any previous one atomically.
+Error saveMergedCodeGenData(ArrayRef<StringRef> ObjectFiles, StringRef Path);
+
+/// Publish the codegen data saved by saveMergedCodeGenData() at \p Path.
+/// \return the hash of the saved data, or std::nullopt if there is no valid
+/// codegen data at \p Path.
+std::optional<stable_hash> publishSavedCodeGenData(StringRef Path);
+
 void warn(Error E, StringRef Whence = "");
 void warn(Twine Message, std::string Whence = "", std::string Hint = "");
 
@@ -272,16 +272,14 @@ namespace llvm {
       assert(I != end());
       if (Pos >= endIndex())
         return end();
-      while (I->end <= Pos) ++I;
-      return I;
+      return gallopTo(I, end(), Pos);
     }
 
     const_iterator advanceTo(const_iterator I, SlotIndex Pos) const {
       assert(I != end());
       if (Pos >= endIndex())
         return end();
-      while (I->end <= Pos) ++I;
-      return I;
+      return gallopTo(I, end(), Pos);
     }
 
     /// find - Return an iterator pointing to the first segment that ends after
@@ -672,6 +670,22 @@ namespace llvm {
     void append(const LiveRange::Segment S);
 
   private:
+    /// Return the first segment in [I, E) that ends after Pos, or E. Every
+    /// SlotIndex comparison dereferences an index list entry, so rather than
+    /// stepping one segment at a time, probe I, I+1, I+3, I+7, ... and bisect
+    /// the last gap. This costs the same as a linear scan when the result is
+    /// close to I and is logarithmic in the distance otherwise.
+    template <typename IterT>
+    static IterT gallopTo(IterT I, IterT E, SlotIndex Pos) {
+      IterT Lo = I;
+      for (size_t Step = 1; I != E && I->end <= Pos; Step *= 2) {
+        Lo = std::next(I);
+        I = size_t(E - I) > Step ? I + Step : E;
+      }
+      return std::partition_point(
+          Lo, I, [&](const Segment &S) { return S.end <= Pos; });
+    }
+
     friend class LiveRangeUpdater;
     void addSegmentToSet(Segment S);
     void markValNoForDeletion(VNInfo *V);
@@ -130,6 +130,13 @@ public:
   /// sections using specified \p SectionHandler.
   virtual void setOutputDWARFHandler(const Triple &TargetTriple,
                                      SectionHandlerTy SectionHandler) = 0;
+
+  /// Bound the memory used for linking: the contents of the sections of each
+  /// linked object file are moved into a temporary file and read back one
+  /// section at a time when they are passed to the output DWARF handler. The
+  /// section contents are released once the handler returns, so the handler
+  /// should not keep references to them.
+  virtual void setMemoryBounded(bool MemoryBounded) = 0;
 };
 
 } // end of namespace parallel
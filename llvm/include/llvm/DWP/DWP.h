@@ -66,8 +66,12 @@ struct CompileUnitIdentifiers {
   const char *DWOName = "";
 };
 
+/// Merge the .dwo and .dwp files \p Inputs into \p Out. The inputs are read
+/// and decompressed with \p NumThreads threads (0 means all available
+/// threads), ahead of the merge. The output doesn't depend on the number of
+/// threads.
 Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
-            OnCuIndexOverflow OverflowOptValue);
+            OnCuIndexOverflow OverflowOptValue, unsigned NumThreads = 1);
 
 unsigned getContributionIndex(DWARFSectionKind Kind, uint32_t IndexVersion);
 
@@ -76,8 +80,7 @@ Error handleSection(
     const MCSection *StrSection, const MCSection *StrOffsetSection,
     const MCSection *TypesSection, const MCSection *CUIndexSection,
     const MCSection *TUIndexSection, const MCSection *InfoSection,
-    const object::SectionRef &Section, MCStreamer &Out,
-    std::deque<SmallString<32>> &UncompressedSections,
+    const object::SectionRef &Section, StringRef Contents, MCStreamer &Out,
     uint32_t (&ContributionOffsets)[8], UnitIndexEntry &CurEntry,
     StringRef &CurStrSection, StringRef &CurStrOffsetSection,
     std::vector<StringRef> &CurTypesSection,
@@ -173,6 +173,14 @@ struct GloballyHashedType {
     });
     return Hashes;
   }
+
+  /// Given several independent type streams, such as the type streams of
+  /// different object files, compute global hashes for each record of each of
+  /// them. As the hash of a record depends on the hashes of the records it
+  /// references, every stream is hashed on a single thread, but the streams
+  /// are hashed in parallel.
+  static std::vector<std::vector<GloballyHashedType>>
+  hashTypeStreams(ArrayRef<CVTypeArray> Streams);
 };
 static_assert(std::is_trivially_copyable<GloballyHashedType>::value,
               "GloballyHashedType must be trivially copyable so that we can "
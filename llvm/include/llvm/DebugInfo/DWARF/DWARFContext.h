@@ -78,6 +78,8 @@ public:
     virtual const DWARFDebugAbbrev *getDebugAbbrev() = 0;
     virtual const DWARFDebugLoc *getDebugLoc() = 0;
     virtual const DWARFDebugAranges *getDebugAranges() = 0;
+    virtual void
+    setDebugAranges(std::unique_ptr<DWARFDebugAranges> NewAranges) = 0;
     virtual Expected<const DWARFDebugLine::LineTable *>
         getLineTableForUnit(DWARFUnit *U,
                             function_ref<void(Error)> RecoverableErrHandler) = 0;
@@ -162,6 +164,9 @@ public:
 
   bool verify(raw_ostream &OS, DIDumpOptions DumpOpts = {}) override;
 
+  /// Return true if this context may be used from several threads at once.
+  bool isThreadSafe() const { return State->isThreadSafe(); }
+
   using unit_iterator_range = DWARFUnitVector::iterator_range;
   using compile_unit_range = DWARFUnitVector::compile_unit_range;
 
@@ -309,6 +314,19 @@ public:
   /// Get a pointer to the parsed DebugAranges object.
   const DWARFDebugAranges *getDebugAranges();
 
+  /// Write the address to compile unit map used by the address lookups below
+  /// in a compact form. Building the map parses the unit DIE of every compile
+  /// unit that .debug_aranges does not describe, so a later process can load
+  /// the saved map with loadAddressIndex() and only parse the units it looks
+  /// up. The index is tied to the layout of the DWARF sections; callers should
+  /// still store it under a key identifying the binary, such as its build ID.
+  void saveAddressIndex(raw_ostream &OS);
+
+  /// Use an address to compile unit map written by saveAddressIndex() instead
+  /// of building it. Fails, leaving the context unchanged, if the index does
+  /// not match the DWARF of this context.
+  Error loadAddressIndex(StringRef Data);
+
   /// Get a pointer to the parsed frame information object.
   Expected<const DWARFDebugFrame *> getDebugFrame();
 
@@ -11,12 +11,14 @@
 
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/StringRef.h"
 #include <cstdint>
 #include <vector>
 
 namespace llvm {
 class DWARFDataExtractor;
 class Error;
+class raw_ostream;
 
 class DWARFContext;
 
@@ -25,6 +27,14 @@ public:
   void generate(DWARFContext *CTX);
   uint64_t findAddress(uint64_t Address) const;
 
+  /// Write the address ranges in a compact form that readIndex() loads
+  /// without looking at the DWARF. \p Key identifies the DWARF the ranges
+  /// were generated from, and must be passed to readIndex() again.
+  void writeIndex(raw_ostream &OS, uint64_t Key) const;
+  /// Replace the address ranges by the ones written by writeIndex(). Fails if
+  /// \p Data is malformed or was written with a different \p Key.
+  Error readIndex(StringRef Data, uint64_t Key);
+
 private:
   void clear();
   void extract(DWARFDataExtractor DebugArangesData,
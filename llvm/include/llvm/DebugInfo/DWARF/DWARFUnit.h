@@ -22,11 +22,13 @@
 #include "llvm/DebugInfo/DWARF/DWARFLocationExpression.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnitIndex.h"
 #include "llvm/Support/DataExtractor.h"
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <utility>
 #include <vector>
@@ -241,6 +243,24 @@ class DWARFUnit {
   std::optional<object::SectionedAddress> BaseAddr;
   /// The compile unit debug information entry items.
   std::vector<DWARFDebugInfoEntry> DieArray;
+  /// The array that held only the unit DIE before the other DIEs were
+  /// extracted. It is kept so that DWARFDies referring to the unit DIE found
+  /// by another thread stay valid.
+  std::vector<DWARFDebugInfoEntry> CUDieOnlyArray;
+  /// The unit DIE, published once it has been extracted.
+  std::atomic<const DWARFDebugInfoEntry *> UnitDieEntry = nullptr;
+  /// Set once the unit DIE, respectively all DIEs, have been extracted, to
+  /// skip taking ExtractDIEsMutex afterwards.
+  std::atomic<bool> CUDieExtracted = false;
+  std::atomic<bool> AllDIEsExtracted = false;
+  /// Serializes the lazy extraction of DieArray and the loading of the DWO
+  /// unit, which may be requested from several threads for units of a
+  /// thread-safe DWARFContext. It is recursive because the extraction reads
+  /// attributes of the unit DIE.
+  std::recursive_mutex ExtractDIEsMutex;
+  /// Serialize the lazy construction of AddrDieMap and VariableDieMap.
+  std::mutex AddrDieMapMutex;
+  std::mutex VariableDieMapMutex;
 
   /// Map from range's start address to end address and corresponding DIE.
   /// IntervalMap does not support range removal, as a result, we use the
@@ -442,9 +462,11 @@ public:
 
   DWARFDie getUnitDIE(bool ExtractUnitDIEOnly = true) {
     extractDIEsIfNeeded(ExtractUnitDIEOnly);
-    if (DieArray.empty())
+    const DWARFDebugInfoEntry *Entry =
+        UnitDieEntry.load(std::memory_order_acquire);
+    if (!Entry)
       return DWARFDie();
-    return DWARFDie(this, &DieArray[0]);
+    return DWARFDie(this, Entry);
   }
 
   DWARFDie getNonSkeletonUnitDIE(bool ExtractUnitDIEOnly = true,
@@ -577,6 +599,10 @@ private:
   /// hasn't already been done
   void extractDIEsIfNeeded(bool CUDieOnly);
 
+  /// Extracts the DIEs into DieArray and copies several attribute values
+  /// from the unit DIE. Must be called with ExtractDIEsMutex held.
+  Error extractDIEsLocked(bool CUDieOnly);
+
   /// extractDIEsToVector - Appends all parsed DIEs to a vector.
   void extractDIEsToVector(bool AppendCUDie, bool AppendNonCUDIEs,
                            std::vector<DWARFDebugInfoEntry> &DIEs) const;
@@ -9,6 +9,7 @@
 #ifndef LLVM_DEBUGINFO_DWARF_DWARFVERIFIER_H
 #define LLVM_DEBUGINFO_DWARF_DWARFVERIFIER_H
 
+#include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/DebugInfo/DIContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFAcceleratorTable.h"
 #include "llvm/DebugInfo/DWARF/DWARFAddressRange.h"
@@ -41,6 +42,8 @@ public:
   void ShowDetail(bool showDetail) { IncludeDetail = showDetail; }
   size_t GetNumCategories() const { return Aggregation.size(); }
   void Report(StringRef s, std::function<void()> detailCallback);
+  /// Add the counts of \p Other to the counts of this aggregator.
+  void Merge(const OutputCategoryAggregator &Other);
   void EnumerateResults(std::function<void(StringRef, unsigned)> handleCounts);
 };
 
@@ -110,6 +113,18 @@ private:
   raw_ostream &note() const;
   raw_ostream &dump(const DWARFDie &Die, unsigned indent = 0) const;
 
+  /// Call \p Verify for every index in [0, \p N). With
+  /// DumpOpts.VerifyNumThreads > 1 and a thread-safe context, the indices are
+  /// split into contiguous chunks that are verified on a thread pool, each by
+  /// a verifier of its own that buffers its output. The output and error
+  /// counts of the chunks are then merged in order, so the result doesn't
+  /// depend on the scheduling.
+  ///
+  /// \returns The sum of the values returned by \p Verify.
+  unsigned
+  verifyInParallel(size_t N,
+                   function_ref<unsigned(DWARFVerifier &, size_t)> Verify);
+
   /// Verifies the abbreviations section.
   ///
   /// This function currently checks that:
@@ -246,6 +261,7 @@ private:
   /// - addresses within a sequence that decrease in value
   /// - invalid file indexes
   void verifyDebugLineRows();
+  void verifyDebugLineRows(DWARFUnit *CU);
 
   /// Verify that an Apple-style accelerator table is valid.
   ///
@@ -147,6 +147,7 @@ class GsymCreator {
   bool IsSegment = false;
   bool Finalized = false;
   bool Quiet;
+  unsigned NumThreads = 1;
 
 
   /// Get the first function start address.
@@ -398,6 +399,12 @@ public:
     UUID.assign(UUIDBytes.begin(), UUIDBytes.end());
   }
 
+  /// Set the number of threads used to sort the function infos in finalize()
+  /// and to encode them in encode(). Zero means all available threads. The
+  /// function infos are still written in the same order, and only a bounded
+  /// number of encoded function infos are kept in memory at any time.
+  void setNumThreads(unsigned Threads) { NumThreads = Threads; }
+
   /// Thread safe iteration over all function infos.
   ///
   /// \param  Callback A callback function that will get called with each
@@ -18,6 +18,7 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -99,7 +100,12 @@ private:
   // entire file is mapped anyway.  Because of that, the user must supply the
   // allocator to allocate broken records from.
   BumpPtrAllocator &Allocator;
-  DenseMap<uint32_t, std::vector<CacheEntry>> CacheMap;
+
+  // The buffers allocated for reads, keyed by stream offset.  The map is
+  // ordered so that looking for a buffer which covers a read only needs to
+  // visit the buffers starting less than MaxCachedSize bytes before it.
+  std::map<uint64_t, std::vector<CacheEntry>> CacheMap;
+  uint64_t MaxCachedSize = 0;
 };
 
 class WritableMappedBlockStream : public WritableBinaryStream {
@@ -20,10 +20,12 @@
 #include "llvm/Object/Binary.h"
 #include "llvm/Object/BuildID.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/RWMutex.h"
 #include <algorithm>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -47,6 +49,12 @@ using FileLineInfoKind = DILineInfoSpecifier::FileLineInfoKind;
 
 class CachedBinary;
 
+/// Symbolizes addresses in modules given by path, object file, or build ID.
+///
+/// The symbolize*() and findSymbol() methods may be called concurrently from
+/// several threads. The loaded modules are shared between the threads, and
+/// the debug info of each compile unit is parsed once, on first use.
+/// flush() and pruneCache() wait for the queries in flight to finish.
 class LLVMSymbolizer {
 public:
   struct Options {
@@ -63,6 +71,15 @@ public:
     std::string FallbackDebugPath;
     std::string DWPName;
     std::vector<std::string> DebugFileDirectory;
+    /// Look up addresses in a GSYM file for the debug binary, if there is an
+    /// up-to-date one, instead of parsing its DWARF.
+    bool UseGsym = false;
+    /// With UseGsym, convert the DWARF to GSYM when there is no up-to-date
+    /// GSYM file, and save the result for later runs.
+    bool GenerateGsym = false;
+    /// The directory for the GSYM files. If empty, the GSYM file of a binary
+    /// is the binary's path with ".gsym" appended.
+    std::string GsymDirectory;
     size_t MaxCacheSize =
         sizeof(size_t) == 4
             ? 512 * 1024 * 1024 /* 512 MiB */
@@ -91,6 +108,16 @@ public:
   symbolizeInlinedCode(ArrayRef<uint8_t> BuildID,
                        object::SectionedAddress ModuleOffset);
 
+  /// Symbolize all of \p ModuleOffsets in the module \p ModuleName, spreading
+  /// the work over the threads of llvm::parallelFor(). The module is loaded
+  /// once, and the results are in the order of \p ModuleOffsets.
+  Expected<std::vector<DILineInfo>>
+  symbolizeCodeBatch(StringRef ModuleName,
+                     ArrayRef<object::SectionedAddress> ModuleOffsets);
+  Expected<std::vector<DIInliningInfo>>
+  symbolizeInlinedCodeBatch(StringRef ModuleName,
+                            ArrayRef<object::SectionedAddress> ModuleOffsets);
+
   Expected<DIGlobal> symbolizeData(const ObjectFile &Obj,
                                    object::SectionedAddress ModuleOffset);
   Expected<DIGlobal> symbolizeData(StringRef ModuleName,
@@ -137,6 +164,12 @@ private:
   // corresponding debug info. These objects can be the same.
   using ObjectPair = std::pair<const ObjectFile *, const ObjectFile *>;
 
+  DILineInfo symbolizeCodeInModule(SymbolizableModule *Info,
+                                   object::SectionedAddress ModuleOffset);
+  DIInliningInfo
+  symbolizeInlinedCodeInModule(SymbolizableModule *Info,
+                               object::SectionedAddress ModuleOffset);
+
   template <typename T>
   Expected<DILineInfo>
   symbolizeCodeCommon(const T &ModuleSpecifier,
@@ -168,6 +201,12 @@ private:
   createModuleInfo(const ObjectFile *Obj, std::unique_ptr<DIContext> Context,
                    StringRef ModuleName);
 
+  /// Returns a context reading the GSYM file for \p DbgObj, generating it
+  /// first if allowed, or nullptr if there is no usable GSYM file.
+  std::unique_ptr<DIContext> getOrCreateGsymContext(const ObjectFile &DbgObj);
+  std::string getGsymPath(const ObjectFile &DbgObj);
+  Error convertToGsym(const ObjectFile &DbgObj, StringRef GsymPath);
+
   ObjectFile *lookUpDsymFile(const std::string &Path,
                              const MachOObjectFile *ExeObj,
                              const std::string &ArchName);
@@ -219,6 +258,15 @@ private:
   std::map<std::pair<std::string, std::string>, std::unique_ptr<ObjectFile>>
       ObjectForUBPathAndArch;
 
+  /// Guards the caches above. It is recursive because looking up a module
+  /// by build ID looks it up by path, and a module's lookups go through the
+  /// binary cache.
+  std::recursive_mutex CacheMutex;
+
+  /// Held shared by the queries for as long as they use a module, and
+  /// exclusively to evict modules.
+  sys::RWMutex EvictionMutex;
+
   Options Opts;
 
   std::unique_ptr<BuildIDFetcher> BIDFetcher;
@@ -35,6 +35,7 @@
 #include <condition_variable>
 #include <optional>
 #include <queue>
+#include <vector>
 
 namespace llvm {
 
@@ -61,6 +62,11 @@ Expected<std::string> getDefaultDebuginfodCacheDirectory();
 /// DEBUGINFOD_TIMEOUT environment variable, default is 90 seconds (90000 ms).
 std::chrono::milliseconds getDefaultDebuginfodTimeout();
 
+/// Finds the default time for which an artifact that no server had is not
+/// requested again. Checks DEBUGINFOD_CACHE_MISS_TIMEOUT environment variable,
+/// default is 600 seconds. Zero disables the negative cache.
+std::chrono::seconds getDefaultDebuginfodCacheMissTimeout();
+
 /// Get the full URL path for a source request of a given BuildID and file
 /// path.
 std::string getDebuginfodSourceUrlPath(object::BuildIDRef ID,
@@ -85,6 +91,13 @@ std::string getDebuginfodDebuginfoUrlPath(object::BuildIDRef ID);
 /// server URLs.
 Expected<std::string> getCachedOrDownloadDebuginfo(object::BuildIDRef ID);
 
+/// Fetches the debug binaries of all \p IDs, with up to
+/// \p MaxConcurrentRequests requests in flight at once (0 means one per
+/// hardware thread). The results are in the same order as \p IDs.
+std::vector<Expected<std::string>>
+getCachedOrDownloadDebuginfos(ArrayRef<object::BuildID> IDs,
+                              unsigned MaxConcurrentRequests = 16);
+
 /// Fetches any debuginfod artifact using the default local cache directory and
 /// server URLs.
 Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
@@ -92,7 +105,10 @@ Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
 
 /// Fetches any debuginfod artifact using the specified local cache directory,
 /// server URLs, and request timeout (in milliseconds). If the artifact is
-/// found, uses the UniqueKey for the local cache file.
+/// found, uses the UniqueKey for the local cache file. If none of the servers
+/// has the artifact, this is recorded in the cache directory, and the servers
+/// aren't queried again for it until getDefaultDebuginfodCacheMissTimeout()
+/// has elapsed.
 Expected<std::string> getCachedOrDownloadArtifact(
     StringRef UniqueKey, StringRef UrlPath, StringRef CacheDirectoryPath,
     ArrayRef<StringRef> DebuginfodUrls, std::chrono::milliseconds Timeout);
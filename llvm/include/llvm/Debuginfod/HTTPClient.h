@@ -50,6 +50,8 @@ protected:
 };
 
 /// A reusable client that can perform HTTPRequests through a network socket.
+/// A client keeps its connections open, so later requests to the same server
+/// reuse them. A client can only be used by one thread at a time.
 class HTTPClient {
 #ifdef LLVM_ENABLE_CURL
   void *Curl = nullptr;
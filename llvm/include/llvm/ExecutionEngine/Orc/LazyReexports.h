@@ -17,6 +17,8 @@
 #define LLVM_EXECUTIONENGINE_ORC_LAZYREEXPORTS_H
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
 #include "llvm/ExecutionEngine/Orc/RedirectionManager.h"
@@ -179,6 +181,22 @@ class LazyReexportsManager : public ResourceManager {
   lazyReexports(LazyReexportsManager &, SymbolAliasMap);
 
 public:
+  /// Notified of the lazy reexports created by the manager, and of the first
+  /// call through each of them.
+  class Listener {
+  public:
+    virtual ~Listener();
+
+    /// Called when the lazy reexports \p Reexports are defined in \p JD.
+    virtual void onLazyReexportsCreated(JITDylib &JD,
+                                        const SymbolAliasMap &Reexports) = 0;
+
+    /// Called when the lazy reexport of \p BodyName in \p JD is called for
+    /// the first time, before \p BodyName is looked up.
+    virtual void onLazyReexportCalled(JITDylib &JD,
+                                      const SymbolStringPtr &BodyName) = 0;
+  };
+
   using OnTrampolinesReadyFn = unique_function<void(
       Expected<std::vector<ExecutorSymbolDef>> EntryAddrs)>;
   using EmitTrampolinesFn =
@@ -186,10 +204,11 @@ public:
                            OnTrampolinesReadyFn OnTrampolinesReady)>;
 
   /// Create a LazyReexportsManager that uses the ORC runtime for reentry.
-  /// This will work both in-process and out-of-process.
+  /// This will work both in-process and out-of-process. If \p L is not null,
+  /// it must outlive the manager.
   static Expected<std::unique_ptr<LazyReexportsManager>>
   Create(EmitTrampolinesFn EmitTrampolines, RedirectableSymbolManager &RSMgr,
-         JITDylib &PlatformJD);
+         JITDylib &PlatformJD, Listener *L = nullptr);
 
   LazyReexportsManager(LazyReexportsManager &&) = delete;
   LazyReexportsManager &operator=(LazyReexportsManager &&) = delete;
@@ -213,7 +232,7 @@ private:
 
   LazyReexportsManager(EmitTrampolinesFn EmitTrampolines,
                        RedirectableSymbolManager &RSMgr, JITDylib &PlatformJD,
-                       Error &Err);
+                       Listener *L, Error &Err);
 
   std::unique_ptr<MaterializationUnit>
   createLazyReexports(SymbolAliasMap Reexports);
@@ -229,6 +248,7 @@ private:
   ExecutionSession &ES;
   EmitTrampolinesFn EmitTrampolines;
   RedirectableSymbolManager &RSMgr;
+  Listener *L;
 
   DenseMap<ResourceKey, std::vector<ExecutorAddr>> KeyToReentryAddrs;
   DenseMap<ExecutorAddr, CallThroughInfo> CallThroughs;
@@ -242,6 +262,63 @@ lazyReexports(LazyReexportsManager &LRM, SymbolAliasMap Reexports) {
   return LRM.createLazyReexports(std::move(Reexports));
 }
 
+/// Records the order in which the lazy reexports are first called, and
+/// speculatively compiles the functions of a previously recorded order.
+///
+/// The functions of the recorded order are looked up one at a time as soon as
+/// their lazy reexports are created, in that order, from idle tasks. On
+/// startup, the functions which the previous runs needed first are thus
+/// compiled in the background before they are called, while the work the
+/// program is waiting for keeps priority. A function is speculated at most
+/// once, and not at all if it gets called first.
+///
+/// The speculator must be destroyed after the ExecutionSession has ended.
+class CallOrderSpeculator : public LazyReexportsManager::Listener {
+public:
+  /// Create a speculator for \p ES, which compiles the functions named in
+  /// \p RecordedOrder speculatively.
+  CallOrderSpeculator(ExecutionSession &ES,
+                      std::vector<std::string> RecordedOrder = {});
+
+  void onLazyReexportsCreated(JITDylib &JD,
+                              const SymbolAliasMap &Reexports) override;
+  void onLazyReexportCalled(JITDylib &JD,
+                            const SymbolStringPtr &BodyName) override;
+
+  /// Returns the names of the functions called so far, in first-call order.
+  std::vector<std::string> getCallOrder();
+
+  /// Read a call order written by writeCallOrder.
+  static Expected<std::vector<std::string>> readCallOrder(StringRef Path);
+
+  /// Write the names in \p Order to \p Path, one per line.
+  static Error writeCallOrder(StringRef Path, ArrayRef<std::string> Order);
+
+private:
+  /// Speculatively look up the first pending function, unless a speculative
+  /// lookup is in flight already.
+  void speculateNext();
+
+  struct PendingFunction {
+    JITDylibSP JD;
+    SymbolStringPtr Name;
+  };
+
+  ExecutionSession &ES;
+  std::mutex M;
+
+  /// The position of every function in the recorded order.
+  StringMap<size_t> RecordedIndex;
+
+  /// The functions of the recorded order which have lazy reexports and
+  /// haven't been speculated or called yet, by position.
+  std::map<size_t, PendingFunction> Pending;
+  bool LookupInFlight = false;
+
+  StringSet<> Called;
+  std::vector<std::string> CallOrder;
+};
+
 } // End namespace orc
 } // End namespace llvm
 
@@ -81,9 +81,13 @@ public:
 
 class InProcessMemoryMapper : public MemoryMapper {
 public:
-  InProcessMemoryMapper(size_t PageSize);
+  /// If \p UseHugePages is true, large reservations are aligned to and backed
+  /// by huge pages when the host supports it. This reduces the iTLB misses of
+  /// JIT'd code spread over many small allocations.
+  InProcessMemoryMapper(size_t PageSize, bool UseHugePages = false);
 
-  static Expected<std::unique_ptr<InProcessMemoryMapper>> Create();
+  static Expected<std::unique_ptr<InProcessMemoryMapper>>
+  Create(bool UseHugePages = false);
 
   unsigned int getPageSize() override { return PageSize; }
 
@@ -119,6 +123,7 @@ private:
   AllocationMap Allocations;
 
   size_t PageSize;
+  bool UseHugePages;
 };
 
 class SharedMemoryMapper final : public MemoryMapper {
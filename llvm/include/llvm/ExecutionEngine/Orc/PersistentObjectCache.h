@@ -0,0 +1,87 @@
+//===--- PersistentObjectCache.h - On-disk object cache ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A content-addressed ObjectCache that keeps the compiled objects on disk, so
+// that they can be reused across processes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Error.h"
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace orc {
+
+/// An ObjectCache that stores the objects in a directory, keyed on the hash of
+/// the module contents and of the code generation options.
+///
+/// Unlike a cache keyed on module identifiers, entries are shared by all the
+/// modules with the same contents, and are never reused for a module whose
+/// contents changed. The directory is pruned with the given
+/// CachePruningPolicy when the cache is created and then periodically as
+/// objects are added, so that its size stays bounded.
+///
+/// This cache can be used by several threads and processes at the same time,
+/// e.g. by passing it to a ConcurrentIRCompiler:
+///
+/// \code{.cpp}
+///   auto Cache = PersistentObjectCache::Create(Dir, JTMB);
+///   if (!Cache)
+///     return Cache.takeError();
+///   Builder.setCompileFunctionCreator(
+///       [&](JITTargetMachineBuilder JTMB)
+///           -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+///         return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB),
+///                                                       Cache->get());
+///       });
+/// \endcode
+class PersistentObjectCache : public ObjectCache {
+public:
+  /// Create a cache in \p CacheDir for objects compiled with \p JTMB. The
+  /// TargetOptions aren't part of the key: clients changing them should pass
+  /// a description of them as \p ExtraKey.
+  static Expected<std::unique_ptr<PersistentObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB,
+         StringRef ExtraKey = "",
+         CachePruningPolicy Policy = CachePruningPolicy());
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+  /// Return the key of the cache entry for \p M.
+  std::string getKey(const Module &M) const;
+
+private:
+  PersistentObjectCache(StringRef CacheDir, std::string OptionsKey,
+                        CachePruningPolicy Policy);
+
+  /// Return the path of the entry for \p Key.
+  std::string getEntryPath(StringRef Key) const;
+
+  std::string CacheDir;
+  std::string OptionsKey;
+  CachePruningPolicy Policy;
+
+  /// The keys computed by getObject for the modules which missed the cache,
+  /// to be reused once they have been compiled.
+  std::mutex PendingKeysMutex;
+  DenseMap<const Module *, std::string> PendingKeys;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
@@ -18,9 +18,13 @@
 #include "llvm/ExecutionEngine/Orc/RedirectionManager.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/Passes/OptimizationLevel.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 
+#include <atomic>
+#include <chrono>
+
 namespace llvm {
 namespace orc {
 
@@ -45,6 +49,18 @@ public:
       ReOptimizeLayer &Parent, ReOptMaterializationUnitID MUID,
       unsigned CurVersion, ResourceTrackerSP OldRT, ThreadSafeModule &TSM)>;
 
+  /// Counts of the reoptimizations, and of the time spent compiling the
+  /// initial and the reoptimized versions of the materialization units. The
+  /// compile times include the time spent in the AddProfilerFunc and the
+  /// ReOptimizeFunc respectively.
+  struct Statistics {
+    uint64_t NumInitialCompiles = 0;
+    uint64_t NumReoptimizations = 0;
+    uint64_t NumFailedReoptimizations = 0;
+    std::chrono::nanoseconds InitialCompileTime{0};
+    std::chrono::nanoseconds ReoptimizeCompileTime{0};
+  };
+
   ReOptimizeLayer(ExecutionSession &ES, DataLayout &DL, IRLayer &BaseLayer,
                   RedirectableSymbolManager &RM)
       : IRLayer(ES, BaseLayer.getManglingOptions()), ES(ES), Mangle(ES, DL),
@@ -59,6 +75,24 @@ public:
     this->ProfilerFunc = std::move(ProfilerFunc);
   }
 
+  /// Set the number of calls after which reoptimizeIfCallFrequent requests
+  /// the reoptimization of a materialization unit.
+  void setCallCountThreshold(uint64_t Threshold) { CallThreshold = Threshold; }
+  uint64_t getCallCountThreshold() const { return CallThreshold; }
+
+  /// If true, reoptimization requests are handled by a task dispatched to the
+  /// ExecutionSession, and the calling code keeps running the current
+  /// version until the new one is ready. Otherwise the call that requested
+  /// the reoptimization waits for it. Defaults to false.
+  void setReoptimizeInBackground(bool InBackground) {
+    ReoptimizeInBackground = InBackground;
+  }
+
+  Statistics getStatistics() {
+    std::lock_guard<std::mutex> Lock(StatsMutex);
+    return Stats;
+  }
+
   /// Registers reoptimize runtime dispatch handlers to given PlatformJD. The
   /// reoptimization request will not be handled if dispatch handler is not
   /// registered by using this function.
@@ -72,7 +106,8 @@ public:
   static const uint64_t CallCountThreshold = 10;
 
   /// Basic AddProfilerFunc that reoptimizes the function when the call count
-  /// exceeds CallCountThreshold.
+  /// exceeds the call count threshold of the layer (CallCountThreshold unless
+  /// changed with setCallCountThreshold).
   static Error reoptimizeIfCallFrequent(ReOptimizeLayer &Parent,
                                         ReOptMaterializationUnitID MUID,
                                         unsigned CurVersion,
@@ -84,6 +119,12 @@ public:
     return Error::success();
   }
 
+  /// Returns a ReOptimizeFunc that runs the default optimization pipeline for
+  /// \p Level. Together with reoptimizeIfCallFrequent, this gives a two tier
+  /// policy: modules are first compiled as they were added, and only the
+  /// frequently called ones are optimized and compiled again.
+  static ReOptimizeFunc createOptimizeFunc(OptimizationLevel Level);
+
   // Create IR reoptimize request fucntion call.
   static void createReoptimizeCall(Module &M, Instruction &IP,
                                    GlobalVariable *ArgBuffer);
@@ -147,6 +188,10 @@ private:
   void rt_reoptimize(SendErrorFn SendResult, ReOptMaterializationUnitID MUID,
                      uint32_t CurVersion);
 
+  /// Reoptimize the materialization unit \p MUID and redirect its symbols to
+  /// the new version. Errors are reported to the ExecutionSession.
+  void reoptimize(ReOptMaterializationUnitID MUID, uint32_t CurVersion);
+
   static Expected<Constant *>
   createReoptimizeArgBuffer(Module &M, ReOptMaterializationUnitID MUID,
                             uint32_t CurVersion);
@@ -168,6 +213,11 @@ private:
 
   ReOptimizeFunc ReOptFunc;
   AddProfilerFunc ProfilerFunc;
+  std::atomic<uint64_t> CallThreshold = CallCountThreshold;
+  std::atomic<bool> ReoptimizeInBackground = false;
+
+  std::mutex StatsMutex;
+  Statistics Stats;
 
   std::mutex Mutex;
   std::map<ReOptMaterializationUnitID, ReOptMaterializationUnitState> MUStates;
@@ -83,6 +83,21 @@ public:
 
   Error disconnect() override;
 
+  /// Create a memory manager that allocates slabs of \p SlabSize bytes shared
+  /// with the executor, using the ExecutorSharedMemoryMapperService. The
+  /// contents of the allocations are written straight to the shared memory,
+  /// so only finalization requests go through the transport. This requires
+  /// the executor to run on the same host, and can be used as
+  /// Setup::CreateMemoryManager:
+  ///
+  /// \code{.cpp}
+  ///   S.CreateMemoryManager = [](SimpleRemoteEPC &SREPC) {
+  ///     return SimpleRemoteEPC::createSharedMemoryManager(SREPC, SlabSize);
+  ///   };
+  /// \endcode
+  static Expected<std::unique_ptr<jitlink::JITLinkMemoryManager>>
+  createSharedMemoryManager(SimpleRemoteEPC &SREPC, size_t SlabSize);
+
   Expected<HandleMessageAction>
   handleMessage(SimpleRemoteEPCOpcode OpC, uint64_t SeqNo, ExecutorAddr TagAddr,
                 SimpleRemoteEPCArgBytesVector ArgBytes) override;
@@ -105,17 +105,24 @@ private:
 
     // for a given symbol, there may be no symbol qualified for speculatively
     // compile try to fix this before jumping to this code if possible.
-    for (auto &LookupPair : SpeculativeLookUpImpls)
-      ES.lookup(
-          LookupKind::Static,
-          makeJITDylibSearchOrder(LookupPair.first,
-                                  JITDylibLookupFlags::MatchAllSymbols),
-          SymbolLookupSet(LookupPair.second), SymbolState::Ready,
-          [this](Expected<SymbolMap> Result) {
-            if (auto Err = Result.takeError())
-              ES.reportError(std::move(Err));
-          },
-          NoDependenciesToRegister);
+    // The lookups are only issued once the dispatcher is idle, so that they
+    // don't delay the materializations the program is waiting for.
+    auto IssueLookups = [this, SpeculativeLookUpImpls =
+                                   std::move(SpeculativeLookUpImpls)]() {
+      for (auto &LookupPair : SpeculativeLookUpImpls)
+        ES.lookup(
+            LookupKind::Static,
+            makeJITDylibSearchOrder(LookupPair.first,
+                                    JITDylibLookupFlags::MatchAllSymbols),
+            SymbolLookupSet(LookupPair.second), SymbolState::Ready,
+            [this](Expected<SymbolMap> Result) {
+              if (auto Err = Result.takeError())
+                ES.reportError(std::move(Err));
+            },
+            NoDependenciesToRegister);
+    };
+    ES.dispatchTask(makeIdleTask(
+        makeGenericNamedTask(std::move(IssueLookups), "Speculative lookups")));
   }
 
 public:
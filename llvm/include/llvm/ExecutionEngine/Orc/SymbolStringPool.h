@@ -56,8 +56,25 @@ private:
   using RefCountType = std::atomic<size_t>;
   using PoolMap = StringMap<RefCountType>;
   using PoolMapEntry = StringMapEntry<RefCountType>;
-  mutable std::mutex PoolMutex;
-  PoolMap Pool;
+
+  /// The pool is split into shards, each with its own lock, so that threads
+  /// interning different strings rarely contend. Reference counts are atomic
+  /// and never need a lock.
+  struct Shard {
+    mutable std::mutex Mutex;
+    PoolMap Map;
+  };
+
+  static constexpr unsigned NumShardsLog2 = 5;
+  static constexpr unsigned NumShards = 1U << NumShardsLog2;
+
+  // The StringMaps pick buckets with the low bits of the hash, so use the high
+  // bits to pick the shard.
+  Shard &getShard(uint32_t FullHashValue) {
+    return Shards[FullHashValue >> (32 - NumShardsLog2)];
+  }
+
+  Shard Shards[NumShards];
 };
 
 /// Base class for both owning and non-owning symbol-string ptrs.
@@ -282,30 +299,38 @@ inline SymbolStringPtr::SymbolStringPtr(NonOwningSymbolStringPtr Other)
 inline SymbolStringPool::~SymbolStringPool() {
 #ifndef NDEBUG
   clearDeadEntries();
-  assert(Pool.empty() && "Dangling references at pool destruction time");
+  assert(empty() && "Dangling references at pool destruction time");
 #endif // NDEBUG
 }
 
 inline SymbolStringPtr SymbolStringPool::intern(StringRef S) {
-  std::lock_guard<std::mutex> Lock(PoolMutex);
+  uint32_t FullHashValue = PoolMap::hash(S);
+  Shard &Sh = getShard(FullHashValue);
+  std::lock_guard<std::mutex> Lock(Sh.Mutex);
   PoolMap::iterator I;
   bool Added;
-  std::tie(I, Added) = Pool.try_emplace(S, 0);
+  std::tie(I, Added) = Sh.Map.try_emplace_with_hash(S, FullHashValue, 0);
   return SymbolStringPtr(&*I);
 }
 
 inline void SymbolStringPool::clearDeadEntries() {
-  std::lock_guard<std::mutex> Lock(PoolMutex);
-  for (auto I = Pool.begin(), E = Pool.end(); I != E;) {
-    auto Tmp = I++;
-    if (Tmp->second == 0)
-      Pool.erase(Tmp);
+  for (auto &Sh : Shards) {
+    std::lock_guard<std::mutex> Lock(Sh.Mutex);
+    for (auto I = Sh.Map.begin(), E = Sh.Map.end(); I != E;) {
+      auto Tmp = I++;
+      if (Tmp->second == 0)
+        Sh.Map.erase(Tmp);
+    }
   }
 }
 
 inline bool SymbolStringPool::empty() const {
-  std::lock_guard<std::mutex> Lock(PoolMutex);
-  return Pool.empty();
+  for (auto &Sh : Shards) {
+    std::lock_guard<std::mutex> Lock(Sh.Mutex);
+    if (!Sh.Map.empty())
+      return false;
+  }
+  return true;
 }
 
 inline size_t
@@ -18,14 +18,18 @@
 #include "llvm/Support/ExtensibleRTTI.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <atomic>
 #include <cassert>
+#include <memory>
 #include <string>
 
 #if LLVM_ENABLE_THREADS
 #include <condition_variable>
 #include <deque>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <vector>
 #endif
 
 namespace llvm {
@@ -92,6 +96,39 @@ makeGenericNamedTask(FnT &&Fn, const char *Desc = nullptr) {
                                                      Desc);
 }
 
+/// A task that should only be run when there's no more urgent work, e.g.
+/// speculative compilation. Idle tasks wrap another task, and are dropped
+/// without running it if they get cancelled before they start. Only tasks
+/// which can be dropped safely should be cancelled: a MaterializationTask,
+/// for example, would leave its symbols pending forever.
+class IdleTask : public RTTIExtends<IdleTask, Task> {
+public:
+  static char ID;
+
+  IdleTask(std::unique_ptr<Task> T,
+           std::shared_ptr<std::atomic<bool>> Cancelled = nullptr)
+      : T(std::move(T)), Cancelled(std::move(Cancelled)) {
+    assert(this->T && "Wrapped task cannot be null");
+  }
+  void printDescription(raw_ostream &OS) override;
+  void run() override;
+
+  /// Returns true if the task was cancelled before running.
+  bool isCancelled() const { return Cancelled && Cancelled->load(); }
+
+private:
+  std::unique_ptr<Task> T;
+  std::shared_ptr<std::atomic<bool>> Cancelled;
+};
+
+/// Create an idle task running \p T, which is dropped instead if
+/// \p Cancelled is set before it runs.
+inline std::unique_ptr<IdleTask>
+makeIdleTask(std::unique_ptr<Task> T,
+             std::shared_ptr<std::atomic<bool>> Cancelled = nullptr) {
+  return std::make_unique<IdleTask>(std::move(T), std::move(Cancelled));
+}
+
 /// Abstract base for classes that dispatch ORC Tasks.
 class TaskDispatcher {
 public:
@@ -113,14 +150,26 @@ public:
 
 #if LLVM_ENABLE_THREADS
 
+/// Runs every task on a thread of its own, except for materialization and idle
+/// tasks, which may be queued. At most MaxMaterializationThreads run
+/// materialization tasks at the same time. Idle tasks only start when no
+/// materialization task is queued, and only on the threads left over by the
+/// materialization tasks: the idle and materialization tasks together run on
+/// at most MaxMaterializationThreads threads, or on as many threads as the
+/// hardware supports if there's no limit.
 class DynamicThreadPoolTaskDispatcher : public TaskDispatcher {
 public:
   DynamicThreadPoolTaskDispatcher(
-      std::optional<size_t> MaxMaterializationThreads)
-      : MaxMaterializationThreads(MaxMaterializationThreads) {}
+      std::optional<size_t> MaxMaterializationThreads);
   void dispatch(std::unique_ptr<Task> T) override;
   void shutdown() override;
 private:
+  /// Pops the next idle task that isn't cancelled, if there's a free thread
+  /// to run it on. The cancelled tasks are moved to \p Cancelled, so that
+  /// they are destroyed after the lock is released. Requires DispatchMutex.
+  std::unique_ptr<Task>
+  takeIdleTask(std::vector<std::unique_ptr<Task>> &Cancelled);
+
   std::mutex DispatchMutex;
   bool Running = true;
   size_t Outstanding = 0;
@@ -129,6 +178,10 @@ private:
   std::optional<size_t> MaxMaterializationThreads;
   size_t NumMaterializationThreads = 0;
   std::deque<std::unique_ptr<Task>> MaterializationTaskQueue;
+
+  size_t MaxIdleAndMaterializationThreads;
+  size_t NumIdleThreads = 0;
+  std::deque<std::unique_ptr<Task>> IdleTaskQueue;
 };
 
 #endif // LLVM_ENABLE_THREADS
@@ -64,6 +64,13 @@ enum {
 /// infrastructure, including the type and constant uniquing tables.
 /// LLVMContext itself provides no locking guarantees, so you should be careful
 /// to have one context per thread.
+///
+/// Locking the uniquing tables alone would not make a context safe to share:
+/// uniqued constants, metadata and types are shared by every module in the
+/// context, and building IR updates their use lists and metadata tracking
+/// without synchronization. To hand modules between threads, use
+/// orc::ThreadSafeContext and orc::ThreadSafeModule, which lock the whole
+/// context around each access.
 class LLVMContext {
 public:
   LLVMContextImpl *const pImpl;
@@ -153,6 +160,16 @@ public:
   /// especially in release mode.
   void setDiscardValueNames(bool Discard);
 
+  /// Return true if MDStrings read from bitcode may refer directly to the
+  /// bitcode buffer instead of being copied into the context.
+  bool shouldReferenceBitcodeMDStrings() const;
+
+  /// Let MDStrings read from bitcode refer directly to the bitcode buffer,
+  /// which saves copying the strings when loading metadata. Clients that
+  /// enable this must keep every buffer that bitcode is read from alive for as
+  /// long as the context.
+  void setReferenceBitcodeMDStrings(bool Reference);
+
   /// Whether there is a string map for uniquing debug info
   /// identifiers across the context.  Off by default.
   bool isODRUniquingDebugTypes() const;
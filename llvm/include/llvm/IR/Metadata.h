@@ -718,25 +718,38 @@ dyn_extract_or_null(Y &&MD) {
 /// These are used to efficiently contain a byte sequence for metadata.
 /// MDString is always unnamed.
 class MDString : public Metadata {
-  friend class StringMapEntryStorage<MDString>;
+  /// The bytes of the string, whose length is kept in SubclassData32. They
+  /// are owned by the context, unless the string was created by getUnowned.
+  const char *Data;
 
-  StringMapEntry<MDString> *Entry = nullptr;
+  MDString(StringRef Str) : Metadata(MDStringKind, Uniqued), Data(Str.data()) {
+    SubclassData32 = Str.size();
+  }
 
-  MDString() : Metadata(MDStringKind, Uniqued) {}
+  static MDString *getImpl(LLVMContext &Context, StringRef Str, bool Copy);
 
 public:
   MDString(const MDString &) = delete;
   MDString &operator=(MDString &&) = delete;
   MDString &operator=(const MDString &) = delete;
 
-  static MDString *get(LLVMContext &Context, StringRef Str);
+  static MDString *get(LLVMContext &Context, StringRef Str) {
+    return getImpl(Context, Str, /*Copy=*/true);
+  }
   static MDString *get(LLVMContext &Context, const char *Str) {
     return get(Context, Str ? StringRef(Str) : StringRef());
   }
 
-  StringRef getString() const;
+  /// Like get, but if the string is not uniqued in the context yet, the new
+  /// MDString refers to the bytes of \p Str instead of a copy of them. \p Str
+  /// must outlive \p Context and is not necessarily null-terminated.
+  static MDString *getUnowned(LLVMContext &Context, StringRef Str) {
+    return getImpl(Context, Str, /*Copy=*/false);
+  }
+
+  StringRef getString() const { return StringRef(Data, SubclassData32); }
 
-  unsigned getLength() const { return (unsigned)getString().size(); }
+  unsigned getLength() const { return SubclassData32; }
 
   using iterator = StringRef::iterator;
 
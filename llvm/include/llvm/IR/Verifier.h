@@ -97,8 +97,12 @@ bool verifyFunction(const Function &F, raw_ostream *OS = nullptr);
 /// supplied, DebugInfo verification failures won't be considered as
 /// error and instead *BrokenDebugInfo will be set to true. Debug
 /// info errors can be "recovered" from by stripping the debug info.
+///
+/// If \p Threads is not 1, the functions are verified concurrently on that
+/// many threads, or on all hardware threads if it is 0. The module-level
+/// checks still run once, afterwards.
 bool verifyModule(const Module &M, raw_ostream *OS = nullptr,
-                  bool *BrokenDebugInfo = nullptr);
+                  bool *BrokenDebugInfo = nullptr, unsigned Threads = 1);
 
 FunctionPass *createVerifierPass(bool FatalErrors = true);
 
@@ -131,9 +135,13 @@ public:
 /// nothing to do with \c VerifierPass.
 class VerifierPass : public PassInfoMixin<VerifierPass> {
   bool FatalErrors;
+  /// The number of threads to verify the functions of a module on, see
+  /// verifyModule.
+  unsigned Threads;
 
 public:
-  explicit VerifierPass(bool FatalErrors = true) : FatalErrors(FatalErrors) {}
+  explicit VerifierPass(bool FatalErrors = true, unsigned Threads = 1)
+      : FatalErrors(FatalErrors), Threads(Threads) {}
 
   PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
   PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
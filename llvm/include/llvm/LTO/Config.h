@@ -59,6 +59,9 @@ struct Config {
   unsigned OptLevel = 2;
   bool VerifyEach = false;
   bool DisableVerify = false;
+  /// The number of threads to verify the functions of the module on before
+  /// and after optimization, 0 for all hardware threads.
+  unsigned VerifyThreads = 1;
 
   /// Flag to indicate that the optimizer should not assume builtins are present
   /// on the target.
@@ -67,6 +70,11 @@ struct Config {
   /// Disable entirely the optimizer, including importing for ThinLTO
   bool CodeGenOnly = false;
 
+  /// Split the module for parallel code generation by clustering functions
+  /// along the call graph and balancing the estimated codegen cost, instead of
+  /// distributing them by name hash.
+  bool CostBasedCodeGenSplit = false;
+
   /// Run PGO context sensitive IR instrumentation.
   bool RunCSIRInstr = false;
 
@@ -176,6 +184,28 @@ struct Config {
   /// Specific thinLTO modules to compile.
   std::vector<std::string> ThinLTOModulesToCompile;
 
+  /// Approximate upper bound, in bytes, on the memory used by concurrently
+  /// running in-process ThinLTO backends. The peak memory of each backend is
+  /// estimated from the instruction counts in the summary index, and a backend
+  /// is delayed until its estimate fits in the budget. A backend is always
+  /// admitted when no other backend is running. Zero means unlimited.
+  uint64_t ThinLTOMemoryBudget = 0;
+
+  /// If true, in-process ThinLTO backends with a cache also cache the
+  /// optimized IR of each module, under a key that leaves out the options that
+  /// only affect code generation. Object files are then cached under a key
+  /// derived from the optimized IR rather than from the backend inputs. This
+  /// skips the optimization pipeline if only codegen options changed, and
+  /// skips code generation if a change to the inputs did not change the
+  /// optimized IR.
+  bool ThinLTOCacheOptimizedIR = false;
+
+  /// If this field is set, in-process ThinLTO backends write a JSON file with
+  /// statistics for each module to this path: the wall time of importing,
+  /// optimization and code generation, the cache result, the change in heap
+  /// usage of the process and the size of the output.
+  std::string ThinLTOBackendStatsFile;
+
   /// Time trace enabled.
   bool TimeTraceEnabled = false;
 
@@ -183,6 +213,11 @@ struct Config {
   unsigned TimeTraceGranularity = 500;
 
   bool ShouldDiscardValueNames = true;
+
+  /// If true, MDStrings read from bitcode refer directly to the input buffers
+  /// instead of being copied. The client must keep every buffer passed to LTO
+  /// alive until the LTO object and its backends are destroyed.
+  bool ReferenceBitcodeMDStrings = false;
   DiagnosticHandlerFunction DiagHandler;
 
   /// Add FSAFDO discriminators.
@@ -300,6 +335,7 @@ struct LTOLLVMContext : LLVMContext {
 
   LTOLLVMContext(const Config &C) : DiagHandler(C.DiagHandler) {
     setDiscardValueNames(C.ShouldDiscardValueNames);
+    setReferenceBitcodeMDStrings(C.ReferenceBitcodeMDStrings);
     enableDebugTypeODRUniquing();
     setDiagnosticHandler(
         std::make_unique<LTOLLVMDiagnosticHandler>(&DiagHandler), true);
@@ -47,6 +47,7 @@ class ToolOutputFile;
 ///
 /// This is done for correctness (if value exported, ensure we always
 /// emit a copy), and compile-time optimization (allow drop of duplicates).
+/// \p isPrevailing may be called concurrently from multiple threads.
 void thinLTOResolvePrevailingInIndex(
     const lto::Config &C, ModuleSummaryIndex &Index,
     function_ref<bool(GlobalValue::GUID, const GlobalValueSummary *)>
@@ -58,6 +59,8 @@ void thinLTOResolvePrevailingInIndex(
 /// Update the linkages in the given \p Index to mark exported values
 /// as external and non-exported values as internal. The ThinLTO backends
 /// must apply the changes to the Module via thinLTOInternalizeModule.
+/// \p isExported and \p isPrevailing may be called concurrently from multiple
+/// threads.
 void thinLTOInternalizeAndPromoteInIndex(
     ModuleSummaryIndex &Index,
     function_ref<bool(StringRef, ValueInfo)> isExported,
@@ -65,7 +68,9 @@ void thinLTOInternalizeAndPromoteInIndex(
         isPrevailing);
 
 /// Computes a unique hash for the Module considering the current list of
-/// export/import and other global analysis results.
+/// export/import and other global analysis results. If \p OptimizationOnly is
+/// set, the options that only affect code generation are left out, so the hash
+/// identifies the optimized IR rather than the object file.
 std::string computeLTOCacheKey(
     const lto::Config &Conf, const ModuleSummaryIndex &Index,
     StringRef ModuleID, const FunctionImporter::ImportMapTy &ImportList,
@@ -73,7 +78,8 @@ std::string computeLTOCacheKey(
     const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
     const GVSummaryMapTy &DefinedGlobals,
     const DenseSet<GlobalValue::GUID> &CfiFunctionDefs = {},
-    const DenseSet<GlobalValue::GUID> &CfiFunctionDecls = {});
+    const DenseSet<GlobalValue::GUID> &CfiFunctionDecls = {},
+    bool OptimizationOnly = false);
 
 /// Recomputes the LTO cache key for a given key with an extra identifier.
 std::string recomputeLTOCacheKey(const std::string &Key, StringRef ExtraID);
@@ -128,6 +134,9 @@ private:
   // [begin, end) for each module
   std::vector<std::pair<size_t, size_t>> ModuleSymIndices;
 
+  // The LTO information recorded in the symbol table for each module, if any.
+  std::vector<std::optional<BitcodeLTOInfo>> ModuleLTOInfos;
+
   StringRef TargetTriple, SourceFileName, COFFLinkerOpts;
   std::vector<StringRef> DependentLibraries;
   std::vector<std::pair<StringRef, Comdat::SelectionKind>> ComdatTable;
@@ -195,6 +204,14 @@ private:
     const auto &Indices = ModuleSymIndices[I];
     return {Symbols.data() + Indices.first, Symbols.data() + Indices.second};
   }
+
+  // Returns the LTO information of the I'th module, reading it from the module
+  // only if the symbol table does not record it.
+  Expected<BitcodeLTOInfo> getModuleLTOInfo(unsigned I) {
+    if (ModuleLTOInfos[I])
+      return *ModuleLTOInfos[I];
+    return Mods[I].getLTOInfo();
+  }
 };
 
 using IndexWriteCallback = std::function<void(const std::string &)>;
@@ -229,7 +246,7 @@ public:
       const FunctionImporter::ExportSetTy &ExportList,
       const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
       MapVector<StringRef, BitcodeModule> &ModuleMap) = 0;
-  Error wait() {
+  virtual Error wait() {
     BackendThreadPool.wait();
     if (Err)
       return std::move(*Err);
@@ -237,6 +254,9 @@ public:
   }
   unsigned getThreadCount() { return BackendThreadPool.getMaxConcurrency(); }
   virtual bool isSensitiveToInputOrder() { return false; }
+  // Whether the backends run in this process and import from the module map
+  // passed to start().
+  virtual bool isInProcess() { return false; }
 
   // Write sharded indices and (optionally) imports to disk
   Error emitFiles(const FunctionImporter::ImportMapTy &ImportList,
@@ -23,6 +23,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/Transforms/IPO/FunctionImport.h"
+#include <chrono>
 
 namespace llvm {
 
@@ -45,6 +46,13 @@ Error backend(const Config &C, AddStreamFn AddStream,
               unsigned ParallelCodeGenParallelismLevel, Module &M,
               ModuleSummaryIndex &CombinedIndex);
 
+/// The wall time spent in the phases of a ThinLTO backend.
+struct ThinBackendTimes {
+  std::chrono::nanoseconds Import{0};
+  std::chrono::nanoseconds Optimize{0};
+  std::chrono::nanoseconds CodeGen{0};
+};
+
 /// Runs a ThinLTO backend.
 /// If \p ModuleMap is not nullptr, all the module files to be imported have
 /// already been mapped to memory and the corresponding BitcodeModule objects
@@ -53,14 +61,17 @@ Error backend(const Config &C, AddStreamFn AddStream,
 /// one source module will be kept open at the most. If \p CodeGenOnly is true,
 /// the backend will skip optimization and only perform code generation. If
 /// \p IRAddStream is not nullptr, it will be called just before code generation
-/// to serialize the optimized IR.
+/// to serialize the optimized IR. If \p AddStream is nullptr as well, the
+/// backend stops after serializing the optimized IR. If \p Times is not
+/// nullptr, the time spent in each phase is added to it.
 Error thinBackend(const Config &C, unsigned Task, AddStreamFn AddStream,
                   Module &M, const ModuleSummaryIndex &CombinedIndex,
                   const FunctionImporter::ImportMapTy &ImportList,
                   const GVSummaryMapTy &DefinedGlobals,
                   MapVector<StringRef, BitcodeModule> *ModuleMap,
                   bool CodeGenOnly, AddStreamFn IRAddStream = nullptr,
-                  const std::vector<uint8_t> &CmdArgs = std::vector<uint8_t>());
+                  const std::vector<uint8_t> &CmdArgs = std::vector<uint8_t>(),
+                  ThinBackendTimes *Times = nullptr);
 
 Error finalizeOptimizationRemarks(
     std::unique_ptr<ToolOutputFile> DiagOutputFile);
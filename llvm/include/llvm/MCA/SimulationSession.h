@@ -0,0 +1,69 @@
+//===---------------- SimulationSession.h -----------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file contains SimulationSession, a helper class to run many small
+/// simulations on the same processor, e.g. to use llvm-mca as a cost model.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_MCA_SIMULATIONSESSION_H
+#define LLVM_MCA_SIMULATIONSESSION_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MCA/Context.h"
+#include "llvm/MCA/CustomBehaviour.h"
+#include "llvm/MCA/InstrBuilder.h"
+#include "llvm/Support/Error.h"
+
+namespace llvm {
+namespace mca {
+
+/// A session simulates instruction sequences on the default pipeline, one
+/// after the other.
+///
+/// The instruction descriptors computed by the InstrBuilder are kept for the
+/// whole session, so that every query only pays for the simulation itself.
+/// Every query runs on new hardware units, and isn't affected by the previous
+/// ones. A sequence is simulated as the body of a loop, for the given number
+/// of iterations.
+class SimulationSession {
+  const MCSubtargetInfo &STI;
+  const MCRegisterInfo &MRI;
+  const MCInstrInfo &MCII;
+  PipelineOptions PO;
+  unsigned Iterations;
+  InstrumentManager IM;
+  InstrBuilder IB;
+
+public:
+  SimulationSession(const MCSubtargetInfo &STI, const MCInstrInfo &MCII,
+                    const MCRegisterInfo &MRI, const MCInstrAnalysis *MCIA,
+                    const PipelineOptions &PO, unsigned Iterations = 100,
+                    unsigned CallLatency = 100);
+
+  unsigned getNumIterations() const { return Iterations; }
+
+  /// Return the number of cycles taken by the simulation of \p Insts.
+  Expected<unsigned> simulate(ArrayRef<MCInst> Insts);
+
+  /// Return the reciprocal throughput of \p Insts, i.e. the average number of
+  /// cycles per iteration.
+  Expected<double> estimateThroughput(ArrayRef<MCInst> Insts);
+
+  /// Estimate the reciprocal throughput of every sequence of \p Sequences, and
+  /// append them to \p RThroughputs. Stops at the first sequence which can't
+  /// be simulated.
+  Error estimateThroughputs(ArrayRef<ArrayRef<MCInst>> Sequences,
+                            SmallVectorImpl<double> &RThroughputs);
+};
+
+} // namespace mca
+} // namespace llvm
+
+#endif // LLVM_MCA_SIMULATIONSESSION_H
@@ -26,6 +26,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/iterator_range.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/IR/Comdat.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/Object/SymbolicFile.h"
@@ -34,11 +35,11 @@
 #include "llvm/Support/Error.h"
 #include <cassert>
 #include <cstdint>
+#include <optional>
 #include <vector>
 
 namespace llvm {
 
-struct BitcodeFileContents;
 class StringTableBuilder;
 
 namespace irsymtab {
@@ -76,6 +77,17 @@ struct Module {
 
   /// The index of the first Uncommon for this Module.
   Word UncBegin;
+
+  /// Describes how the module takes part in LTO. This lets linkers add the
+  /// module to an LTO link without reading the module block.
+  Word Flags;
+  enum FlagBits {
+    FB_has_lto_info, // The other bits are only valid if this one is set.
+    FB_has_summary,
+    FB_thin_lto,
+    FB_split_lto_unit,
+    FB_unified_lto,
+  };
 };
 
 /// This is equivalent to an IR comdat.
@@ -136,7 +148,7 @@ struct Header {
   /// when the format changes, but it does not need to be incremented if a
   /// change to LLVM would cause it to create a different symbol table.
   Word Version;
-  enum { kCurrentVersion = 3 };
+  enum { kCurrentVersion = 4 };
 
   /// The producer's version string (LLVM_VERSION_STRING " " LLVM_REVISION).
   /// Consumers should rebuild the symbol table from IR if the producer's
@@ -161,9 +173,12 @@ struct Header {
 } // end namespace storage
 
 /// Fills in Symtab and StrtabBuilder with a valid symbol and string table for
-/// Mods.
+/// Mods. If LTOInfos is not empty, it must provide the LTO information of each
+/// module as it is written to the bitcode file, and it is recorded in the
+/// symbol table.
 Error build(ArrayRef<Module *> Mods, SmallVector<char, 0> &Symtab,
-            StringTableBuilder &StrtabBuilder, BumpPtrAllocator &Alloc);
+            StringTableBuilder &StrtabBuilder, BumpPtrAllocator &Alloc,
+            ArrayRef<BitcodeLTOInfo> LTOInfos = {});
 
 /// This represents a symbol that has been read from a storage::Symbol and
 /// possibly a storage::Uncommon.
@@ -279,6 +294,19 @@ public:
   /// copied into an irsymtab::Symbol object.
   symbol_range module_symbols(unsigned I) const;
 
+  /// Returns the LTO information of the I'th module in the file, or
+  /// std::nullopt if the symbol table does not record it.
+  std::optional<BitcodeLTOInfo> getModuleLTOInfo(unsigned I) const {
+    uint32_t Flags = Modules[I].Flags;
+    auto Has = [&](unsigned Bit) { return bool((Flags >> Bit) & 1); };
+    if (!Has(storage::Module::FB_has_lto_info))
+      return std::nullopt;
+    return BitcodeLTOInfo{Has(storage::Module::FB_thin_lto),
+                          Has(storage::Module::FB_has_summary),
+                          Has(storage::Module::FB_split_lto_unit),
+                          Has(storage::Module::FB_unified_lto)};
+  }
+
   StringRef getTargetTriple() const { return str(header().TargetTriple); }
 
   /// Returns the source file path specified at compile time.
@@ -15,8 +15,10 @@
 #ifndef LLVM_PASSES_STANDARDINSTRUMENTATIONS_H
 #define LLVM_PASSES_STANDARDINSTRUMENTATIONS_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StableHashing.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
@@ -30,6 +32,7 @@
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Transforms/IPO/SampleProfileProbe.h"
 
+#include <chrono>
 #include <string>
 #include <utility>
 
@@ -108,6 +111,35 @@ public:
   void registerCallbacks(PassInstrumentationCallbacks &PIC);
 };
 
+/// Skips runs of idempotent function passes, named with
+/// -skip-unchanged-passes, on functions whose structural hash has not changed
+/// since the pass last ran on them. Passes are identified by name only, so the
+/// listed passes must give the same result under every set of options they
+/// appear with in the pipeline.
+class SkipUnchangedPassesInstrumentation {
+  struct FunctionState {
+    stable_hash Hash = 0;
+    /// The tracked passes that ran on the function since it last changed, with
+    /// the wall time of that run in seconds.
+    SmallDenseMap<StringRef, double, 4> Passes;
+  };
+  DenseMap<const Function *, FunctionState> Functions;
+  /// The hash of HashedFunction computed before the tracked pass that is
+  /// running now.
+  const Function *HashedFunction = nullptr;
+  stable_hash HashBeforeRun = 0;
+  std::chrono::steady_clock::time_point StartTime;
+  StringSet<> TrackedPasses;
+  PassInstrumentationCallbacks *PIC = nullptr;
+
+  bool isTracked(StringRef PassID);
+  bool shouldRun(StringRef PassID, Any IR);
+  void runAfterPass(StringRef PassID, Any IR, const PreservedAnalyses &PA);
+
+public:
+  void registerCallbacks(PassInstrumentationCallbacks &PIC);
+};
+
 struct PrintPassOptions {
   /// Print adaptors and pass managers.
   bool Verbose = false;
@@ -589,6 +621,7 @@ class StandardInstrumentations {
   TimeProfilingPassesHandler TimeProfilingPasses;
   OptNoneInstrumentation OptNone;
   OptPassGateInstrumentation OptPassGate;
+  SkipUnchangedPassesInstrumentation SkipUnchangedPasses;
   PreservedCFGCheckerInstrumentation PreservedCFGChecker;
   IRChangedPrinter PrintChangedIR;
   PseudoProbeVerifier PseudoProbeVerification;
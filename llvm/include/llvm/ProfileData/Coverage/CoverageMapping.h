@@ -953,9 +953,26 @@ class CoverageMapping {
                bool &DataFound,
                SmallVectorImpl<object::BuildID> *FoundBinaryIDs = nullptr);
 
-  /// Add a function record corresponding to \p Record.
-  Error loadFunctionRecord(const CoverageMappingRecord &Record,
-                           IndexedInstrProfReader &ProfileReader);
+  /// A coverage mapping record with its counters and bitmap, copied out of
+  /// its reader so that its regions can be evaluated on any thread.
+  struct PendingFunctionRecord;
+
+  /// Read the counters and bitmap of \p Record from \p ProfileReader into
+  /// \p Pending. \p Pending is left empty if the record should be ignored.
+  Error loadFunctionCounts(const CoverageMappingRecord &Record,
+                           IndexedInstrProfReader &ProfileReader,
+                           std::optional<PendingFunctionRecord> &Pending);
+
+  /// Evaluate the regions of \p Pending. Return std::nullopt if they can't
+  /// be evaluated, in which case the record is ignored.
+  static std::optional<FunctionRecord>
+  evaluateFunctionRecord(const PendingFunctionRecord &Pending,
+                         bool IsVersion11);
+
+  /// Add \p Function, whose regions are in the files \p Filenames, unless a
+  /// record for the same function and files was already added.
+  void addFunctionRecord(FunctionRecord &&Function,
+                         ArrayRef<StringRef> Filenames);
 
   /// Look up the indices for function records which are at least partially
   /// defined in the specified file. This is guaranteed to return a superset of
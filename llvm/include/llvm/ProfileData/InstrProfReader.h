@@ -744,6 +744,11 @@ private:
   StringRef VTableName;
   /// A memory buffer holding binary ids.
   ArrayRef<uint8_t> BinaryIdsBuffer;
+  /// The temporal profile traces which are yet to be decoded, if any. The
+  /// traces are only decoded when they are requested, as the compiler doesn't
+  /// need them.
+  const unsigned char *TemporalProfTracesBuffer = nullptr;
+  uint64_t NumTemporalProfTraces = 0;
 
   // Index to the current record in the record array.
   unsigned RecordIndex = 0;
@@ -870,6 +875,9 @@ public:
   // the client is the compiler.
   InstrProfSymtab &getSymtab() override;
 
+  SmallVector<TemporalProfTraceTy> &
+  getTemporalProfTraces(std::optional<uint64_t> Weight = {}) override;
+
   /// Return the profile summary.
   /// \c UseCS indicates whether to use the context-sensitive summary.
   ProfileSummary &getSummary(bool UseCS) {
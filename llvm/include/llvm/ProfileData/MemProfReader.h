@@ -199,9 +199,13 @@ private:
   // A map from callstack id (same as key in CallStackMap below) to the heap
   // information recorded for that allocation context.
   llvm::MapVector<uint64_t, MemInfoBlock> CallstackProfileData;
+  // Released once the records have been constructed.
   CallStackMap StackMap;
+  // The number of call stacks in the raw profile after symbolization.
+  size_t NumStackOffsets = 0;
 
-  // Cached symbolization from PC to Frame.
+  // Cached symbolization from PC to Frame. Released once the records have been
+  // constructed.
   llvm::DenseMap<uint64_t, llvm::SmallVector<FrameId>> SymbolizedFrame;
 
   // Whether to keep the symbol name for each frame after hashing.
@@ -764,10 +764,13 @@ public:
 /// SampleProfileReaderExtBinaryBase/SampleProfileWriterExtBinaryBase.
 class SampleProfileReaderExtBinaryBase : public SampleProfileReaderBinary {
 private:
-  std::error_code decompressSection(const uint8_t *SecStart,
-                                    const uint64_t SecSize,
-                                    const uint8_t *&DecompressBuf,
-                                    uint64_t &DecompressBufSize);
+  /// Return true if the section \p Entry is not read.
+  bool skipSection(const SecHdrTableEntry &Entry) const;
+  /// Decompress the compressed sections which are read, in parallel.
+  /// \p Decompressed[I] is set to the decompressed data and size of the I-th
+  /// section of SecHdrTable if it is compressed.
+  std::error_code decompressSections(
+      std::vector<std::pair<const uint8_t *, uint64_t>> &Decompressed);
 
   BumpPtrAllocator Allocator;
 
@@ -48,6 +48,10 @@ class RemarkStreamer final {
   std::unique_ptr<remarks::RemarkSerializer> RemarkSerializer;
   /// The filename that the remark diagnostics are emitted to.
   const std::optional<std::string> Filename;
+  /// Only one remark out of every SampleRate is emitted.
+  unsigned SampleRate;
+  /// The number of remarks seen since the last one that was emitted.
+  unsigned SampleCounter = 0;
 
 public:
   RemarkStreamer(std::unique_ptr<remarks::RemarkSerializer> RemarkSerializer,
@@ -66,6 +70,18 @@ public:
   Error setFilter(StringRef Filter);
   /// Check wether the string matches the filter.
   bool matchesFilter(StringRef Str);
+  /// Emit only one remark out of every \p Rate. A rate of 0 or 1 emits all
+  /// of them.
+  void setSampleRate(unsigned Rate) { SampleRate = Rate ? Rate : 1; }
+  unsigned getSampleRate() const { return SampleRate; }
+  /// Check whether the next remark is picked by the sampling. This has to be
+  /// called once per remark that would otherwise be emitted.
+  bool shouldSample() {
+    if (++SampleCounter < SampleRate)
+      return false;
+    SampleCounter = 0;
+    return true;
+  }
   /// Check if the remarks also need to have associated metadata in a section.
   bool needsSection() const;
 };
@@ -87,9 +87,11 @@ public:
       : AllocTy(std::move(Old.getAllocator())), CurPtr(Old.CurPtr),
         End(Old.End), Slabs(std::move(Old.Slabs)),
         CustomSizedSlabs(std::move(Old.CustomSizedSlabs)),
-        BytesAllocated(Old.BytesAllocated), RedZoneSize(Old.RedZoneSize) {
+        BytesAllocated(Old.BytesAllocated), RedZoneSize(Old.RedZoneSize),
+        NextSlab(Old.NextSlab) {
     Old.CurPtr = Old.End = nullptr;
     Old.BytesAllocated = 0;
+    Old.NextSlab = 0;
     Old.Slabs.clear();
     Old.CustomSizedSlabs.clear();
   }
@@ -107,12 +109,14 @@ public:
     End = RHS.End;
     BytesAllocated = RHS.BytesAllocated;
     RedZoneSize = RHS.RedZoneSize;
+    NextSlab = RHS.NextSlab;
     Slabs = std::move(RHS.Slabs);
     CustomSizedSlabs = std::move(RHS.CustomSizedSlabs);
     AllocTy::operator=(std::move(RHS.getAllocator()));
 
     RHS.CurPtr = RHS.End = nullptr;
     RHS.BytesAllocated = 0;
+    RHS.NextSlab = 0;
     RHS.Slabs.clear();
     RHS.CustomSizedSlabs.clear();
     return *this;
@@ -136,6 +140,26 @@ public:
     __asan_poison_memory_region(*Slabs.begin(), computeSlabSize(0));
     DeallocateSlabs(std::next(Slabs.begin()), Slabs.end());
     Slabs.erase(std::next(Slabs.begin()), Slabs.end());
+    NextSlab = 1;
+  }
+
+  /// Like Reset(), but keep all regular slabs so that subsequent allocations
+  /// reuse them instead of going back to the underlying allocator. This is
+  /// meant for allocators that are emptied and refilled many times, such as
+  /// per-block scratch storage. Custom-sized slabs are still deallocated.
+  void ResetRetainingSlabs() {
+    DeallocateCustomSizedSlabs();
+    CustomSizedSlabs.clear();
+
+    if (Slabs.empty())
+      return;
+
+    BytesAllocated = 0;
+    CurPtr = (char *)Slabs.front();
+    End = CurPtr + SlabSize;
+    NextSlab = 1;
+    for (size_t Idx = 0, E = Slabs.size(); Idx != E; ++Idx)
+      __asan_poison_memory_region(Slabs[Idx], computeSlabSize(Idx));
   }
 
   /// Allocate space at the specified alignment.
@@ -329,6 +353,10 @@ private:
   /// a sanitizer.
   size_t RedZoneSize = 1;
 
+  /// The index of the slab that StartNewSlab() moves to. This is
+  /// Slabs.size() unless ResetRetainingSlabs() left slabs to be reused.
+  size_t NextSlab = 0;
+
   static size_t computeSlabSize(unsigned SlabIdx) {
     // Scale the actual allocated slab size based on the number of slabs
     // allocated. Every GrowthDelay slabs allocated, we double
@@ -341,7 +369,12 @@ private:
   /// Allocate a new slab and move the bump pointers over into the new
   /// slab, modifying CurPtr and End.
   void StartNewSlab() {
-    size_t AllocatedSlabSize = computeSlabSize(Slabs.size());
+    size_t AllocatedSlabSize = computeSlabSize(NextSlab);
+    if (NextSlab < Slabs.size()) {
+      CurPtr = (char *)Slabs[NextSlab++];
+      End = CurPtr + AllocatedSlabSize;
+      return;
+    }
 
     void *NewSlab = this->getAllocator().Allocate(AllocatedSlabSize,
                                                   alignof(std::max_align_t));
@@ -350,6 +383,7 @@ private:
     __asan_poison_memory_region(NewSlab, AllocatedSlabSize);
 
     Slabs.push_back(NewSlab);
+    NextSlab = Slabs.size();
     CurPtr = (char *)(NewSlab);
     End = ((char *)NewSlab) + AllocatedSlabSize;
   }
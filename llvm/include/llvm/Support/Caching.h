@@ -8,7 +8,9 @@
 //
 // This file defines the CachedFileStream and the localCache function, which
 // simplifies caching files on the local filesystem in a directory whose
-// contents are managed by a CachePruningPolicy.
+// contents are managed by a CachePruningPolicy. It also defines the
+// RemoteCacheStore interface for stores shared between machines, which can be
+// used to back a local cache.
 //
 //===----------------------------------------------------------------------===//
 
@@ -16,6 +18,8 @@
 #define LLVM_SUPPORT_CACHING_H
 
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBufferRef.h"
+#include <memory>
 
 namespace llvm {
 
@@ -101,6 +105,38 @@ Expected<FileCache> localCache(
     const Twine &CacheDirectoryPathRef,
     AddBufferFn AddBuffer = [](size_t Task, const Twine &ModuleName,
                                std::unique_ptr<MemoryBuffer> MB) {});
+
+/// A content-addressed store shared between machines, for example a directory
+/// on a network file system or an HTTP service. See remoteBackedCache().
+///
+/// All member functions must be thread safe.
+class RemoteCacheStore {
+public:
+  virtual ~RemoteCacheStore() = default;
+
+  /// Returns the contents stored under \p Key, or nullptr if there are none.
+  virtual Expected<std::unique_ptr<MemoryBuffer>> get(StringRef Key) = 0;
+
+  /// Stores \p Data under \p Key. An implementation may return before the
+  /// data is stored, for example to upload it in the background, but must then
+  /// finish storing it before it is destroyed.
+  virtual Error put(StringRef Key, MemoryBufferRef Data) = 0;
+};
+
+/// Create a store which keeps its entries in the directory \p Path, which is
+/// typically on a file system shared between machines. Entries are named like
+/// those of localCache(), so the directory can be pruned with pruneCache().
+std::unique_ptr<RemoteCacheStore> createDirectoryCacheStore(const Twine &Path);
+
+/// Create a cache which behaves like localCache(), except that entries missing
+/// from the local cache are looked up in \p Store, and entries produced on a
+/// miss in both are added to \p Store as well. Failures to access \p Store are
+/// ignored, so the cache never does worse than the local one.
+Expected<FileCache> remoteBackedCache(
+    const Twine &CacheNameRef, const Twine &TempFilePrefixRef,
+    const Twine &CacheDirectoryPathRef, std::shared_ptr<RemoteCacheStore> Store,
+    AddBufferFn AddBuffer = [](size_t Task, const Twine &ModuleName,
+                               std::unique_ptr<MemoryBuffer> MB) {});
 } // namespace llvm
 
 #endif
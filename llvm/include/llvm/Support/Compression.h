@@ -14,6 +14,7 @@
 #define LLVM_SUPPORT_COMPRESSION_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/Support/DataTypes.h"
 
 namespace llvm {
@@ -71,6 +72,26 @@ Error decompress(ArrayRef<uint8_t> Input, uint8_t *Output,
 Error decompress(ArrayRef<uint8_t> Input, SmallVectorImpl<uint8_t> &Output,
                  size_t UncompressedSize);
 
+/// The size of the blocks compressParallel compresses into separate frames by
+/// default.
+constexpr size_t DefaultParallelBlockSize = 1 << 20;
+
+/// Like compress, but split Input into blocks of BlockSize bytes, which are
+/// compressed into independent frames concurrently using parallelFor. The
+/// concatenated frames decompress as a whole with decompress. The output only
+/// depends on BlockSize and not on the number of threads.
+void compressParallel(ArrayRef<uint8_t> Input,
+                      SmallVectorImpl<uint8_t> &CompressedBuffer,
+                      int Level = DefaultCompression, bool EnableLdm = false,
+                      size_t BlockSize = DefaultParallelBlockSize);
+
+/// Decompress Input, which may consist of several frames, and pass the
+/// decompressed data to Consumer in pieces as it is produced, so that it does
+/// not have to be held in memory at once. Stops at the first error returned
+/// by Consumer and returns it.
+Error decompressStreaming(ArrayRef<uint8_t> Input,
+                          function_ref<Error(ArrayRef<uint8_t>)> Consumer);
+
 } // End of namespace zstd
 
 enum class Format {
@@ -101,9 +122,9 @@ struct Params {
   Format format;
   int level;
   bool zstdEnableLdm = false; // Enable zstd long distance matching
-  // This may support multi-threading for zstd in the future. Note that
-  // different threads may produce different output, so be careful if certain
-  // output determinism is desired.
+  // Compress independent zstd frames in parallel, see zstd::compressParallel.
+  // The output does not depend on the number of threads.
+  bool zstdParallel = false;
 };
 
 // Return nullptr if LLVM was built with support (LLVM_ENABLE_ZLIB,
@@ -76,6 +76,13 @@ public:
   /// but keeps the memory mapping alive.
   virtual void discard() {}
 
+  /// Hints that the bytes in [\p Offset, \p Offset + \p Size) have been
+  /// written and will not be accessed again soon. A buffer backed by a memory
+  /// mapped file may drop the pages fully contained in the range from the
+  /// resident set of the process, leaving them to be written back to the file
+  /// by the OS. The contents of the buffer are not affected.
+  virtual void releaseRange(size_t Offset, size_t Size) {}
+
 protected:
   FileOutputBuffer(StringRef Path) : FinalPath(Path) {}
 
@@ -1296,6 +1296,7 @@ private:
 
   void unmapImpl();
   void dontNeedImpl();
+  void willNeedImpl();
 
   std::error_code init(sys::fs::file_t FD, uint64_t Offset, mapmode Mode);
 
@@ -1326,6 +1327,9 @@ public:
     copyFrom(mapped_file_region());
   }
   void dontNeed() { dontNeedImpl(); }
+  /// Ask the OS to start reading the mapped pages in, so that the first
+  /// accesses do not block on I/O. This is only a hint.
+  void willNeed() { willNeedImpl(); }
 
   size_t size() const;
   char *data() const;
@@ -82,6 +82,11 @@ public:
   /// function should not be called on a writable buffer.
   virtual void dontNeedIfMmap() {}
 
+  /// For MemoryBuffer_MMap, ask the kernel to read the file contents in ahead
+  /// of their first use. This calls madvise(MADV_WILLNEED) on file mappings
+  /// on *NIX systems. Buffers that are not mapped are already in memory.
+  virtual void willNeedIfMmap() {}
+
   /// Open the specified file as a MemoryBuffer, returning a new MemoryBuffer
   /// if successful, otherwise returning null.
   ///
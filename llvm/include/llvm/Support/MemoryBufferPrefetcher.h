@@ -0,0 +1,74 @@
+//===- MemoryBufferPrefetcher.h - Load files in the background --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Tools like linkers and archivers open a large number of input files one
+// after the other, and each open, stat and first touch of the contents waits
+// for the file system. On cold caches and network file systems this time adds
+// up. MemoryBufferPrefetcher opens and maps files on a thread pool, so that
+// the latencies overlap, and asks the OS to read the mapped contents in ahead
+// of their use.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_MEMORYBUFFERPREFETCHER_H
+#define LLVM_SUPPORT_MEMORYBUFFERPREFETCHER_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm {
+
+/// Loads files into MemoryBuffers on a thread pool.
+///
+/// Every call to prefetch() returns a future of the buffer that
+/// MemoryBuffer::getFile would return for the same arguments, including its
+/// error code. The prefetcher may be destroyed before the futures are
+/// consumed; destroying it waits for the pending loads.
+class MemoryBufferPrefetcher {
+public:
+  using BufferOrError = ErrorOr<std::unique_ptr<MemoryBuffer>>;
+
+  /// Loads are mostly waiting for the file system, so the default uses more
+  /// threads than there are cores.
+  explicit MemoryBufferPrefetcher(
+      ThreadPoolStrategy S = hardware_concurrency(DefaultNumThreads));
+  ~MemoryBufferPrefetcher();
+
+  MemoryBufferPrefetcher(const MemoryBufferPrefetcher &) = delete;
+  MemoryBufferPrefetcher &operator=(const MemoryBufferPrefetcher &) = delete;
+
+  /// Start loading \p Filename. The arguments are those of
+  /// MemoryBuffer::getFile.
+  std::future<BufferOrError> prefetch(const Twine &Filename, bool IsText = false,
+                                      bool RequiresNullTerminator = true,
+                                      bool IsVolatile = false);
+
+  /// Start loading every file in \p Filenames. The returned futures are in the
+  /// order of \p Filenames.
+  std::vector<std::future<BufferOrError>>
+  prefetchAll(ArrayRef<std::string> Filenames, bool IsText = false,
+              bool RequiresNullTerminator = true, bool IsVolatile = false);
+
+  /// Block until every pending load has finished.
+  void wait() { Pool.wait(); }
+
+private:
+  static constexpr unsigned DefaultNumThreads = 16;
+
+  DefaultThreadPool Pool;
+};
+
+} // namespace llvm
+
+#endif // LLVM_SUPPORT_MEMORYBUFFERPREFETCHER_H
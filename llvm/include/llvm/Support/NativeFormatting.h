@@ -9,6 +9,7 @@
 #ifndef LLVM_SUPPORT_NATIVEFORMATTING_H
 #define LLVM_SUPPORT_NATIVEFORMATTING_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include <cstdint>
 #include <optional>
 
@@ -39,6 +40,10 @@ void write_integer(raw_ostream &S, long long N, size_t MinDigits,
 
 void write_hex(raw_ostream &S, uint64_t N, HexPrintStyle Style,
                std::optional<size_t> Width = std::nullopt);
+/// Write every byte of \p Bytes as two hex digits, without prefix or
+/// separators. This is much faster than calling write_hex for each byte.
+void write_hex_block(raw_ostream &S, ArrayRef<uint8_t> Bytes,
+                     bool Upper = false);
 void write_double(raw_ostream &S, double D, FloatStyle Style,
                   std::optional<size_t> Precision = std::nullopt);
 }
@@ -13,14 +13,18 @@
 #ifndef LLVM_SUPPORT_ONDISKHASHTABLE_H
 #define LLVM_SUPPORT_ONDISKHASHTABLE_H
 
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Alignment.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/DataTypes.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <vector>
 
 namespace llvm {
 
@@ -148,13 +152,80 @@ public:
   ///
   /// Uses the provided Info instead of a stack allocated one.
   offset_type Emit(raw_ostream &Out, Info &InfoObj) {
-    using namespace llvm::support;
-    endian::Writer LE(Out, llvm::endianness::little);
+    computeFinalLayout();
+
+    // Emit the payload of the table.
+    for (offset_type I = 0; I < NumBuckets; ++I) {
+      Bucket &B = Buckets[I];
+      if (!B.Head)
+        continue;
+
+      // Store the offset for the data of this bucket.
+      B.Off = Out.tell();
+      assert(B.Off && "Cannot write a bucket at offset 0. Please add padding.");
+      emitBucket(Out, B, InfoObj);
+    }
+
+    return emitBucketOffsets(Out);
+  }
+
+  /// Emit the table to Out, which must not be at offset 0, the same way as
+  /// Emit, but serialize the payload of groups of buckets in parallel into
+  /// separate buffers. The buffers are written in bucket order, so that the
+  /// output is the same as that of Emit.
+  ///
+  /// The methods of the provided Info must be safe to call concurrently.
+  offset_type EmitParallel(raw_ostream &Out, Info &InfoObj) {
+    computeFinalLayout();
+
+    // Serialize a batch of groups at a time, so that the buffers don't hold
+    // the whole payload.
+    constexpr offset_type BucketsPerGroup = 256;
+    const offset_type NumGroups = divideCeil(NumBuckets, BucketsPerGroup);
+    const offset_type GroupsPerBatch = std::min<offset_type>(
+        NumGroups, 4 * parallel::strategy.compute_thread_count());
+    std::vector<SmallString<0>> Buffers(GroupsPerBatch);
+    for (offset_type Batch = 0; Batch < NumGroups; Batch += GroupsPerBatch) {
+      const offset_type BatchSize =
+          std::min(GroupsPerBatch, NumGroups - Batch);
+      parallelFor(0, BatchSize, [&](size_t G) {
+        Buffers[G].clear();
+        raw_svector_ostream OS(Buffers[G]);
+        const offset_type Begin = (Batch + G) * BucketsPerGroup;
+        const offset_type End = std::min(Begin + BucketsPerGroup, NumBuckets);
+        for (offset_type I = Begin; I < End; ++I) {
+          Bucket &B = Buckets[I];
+          if (!B.Head)
+            continue;
+          // Relative to the start of the buffer until it is written.
+          B.Off = OS.tell();
+          emitBucket(OS, B, InfoObj);
+        }
+      });
+
+      for (offset_type G = 0; G < BatchSize; ++G) {
+        const offset_type Base = Out.tell();
+        assert(Base &&
+               "Cannot write a bucket at offset 0. Please add padding.");
+        const offset_type Begin = (Batch + G) * BucketsPerGroup;
+        const offset_type End = std::min(Begin + BucketsPerGroup, NumBuckets);
+        for (offset_type I = Begin; I < End; ++I)
+          if (Buckets[I].Head)
+            Buckets[I].Off += Base;
+        Out << Buffers[G];
+      }
+    }
+
+    return emitBucketOffsets(Out);
+  }
 
-    // Now we're done adding entries, resize the bucket list if it's
-    // significantly too large. (This only happens if the number of
-    // entries is small and we're within our initial allocation of
-    // 64 buckets.) We aim for an occupancy ratio in [3/8, 3/4).
+private:
+  /// Resize the bucket list if it's significantly too large, now that we're
+  /// done adding entries.
+  void computeFinalLayout() {
+    // This only happens if the number of entries is small and we're within
+    // our initial allocation of 64 buckets. We aim for an occupancy ratio in
+    // [3/8, 3/4).
     //
     // As a special case, if there are two or fewer entries, just
     // form a single bucket. A linear scan is fine in that case, and
@@ -166,44 +237,45 @@ public:
         NumEntries <= 2 ? 1 : llvm::bit_ceil(NumEntries * 4 / 3 + 1);
     if (TargetNumBuckets != NumBuckets)
       resize(TargetNumBuckets);
+  }
 
-    // Emit the payload of the table.
-    for (offset_type I = 0; I < NumBuckets; ++I) {
-      Bucket &B = Buckets[I];
-      if (!B.Head)
-        continue;
-
-      // Store the offset for the data of this bucket.
-      B.Off = Out.tell();
-      assert(B.Off && "Cannot write a bucket at offset 0. Please add padding.");
+  /// Write out the number of items in the bucket \p B and its entries.
+  static void emitBucket(raw_ostream &Out, const Bucket &B, Info &InfoObj) {
+    using namespace llvm::support;
+    endian::Writer LE(Out, llvm::endianness::little);
 
-      // Write out the number of items in the bucket.
-      LE.write<uint16_t>(B.Length);
-      assert(B.Length != 0 && "Bucket has a head but zero length?");
+    // Write out the number of items in the bucket.
+    LE.write<uint16_t>(B.Length);
+    assert(B.Length != 0 && "Bucket has a head but zero length?");
 
-      // Write out the entries in the bucket.
-      for (Item *I = B.Head; I; I = I->Next) {
-        LE.write<typename Info::hash_value_type>(I->Hash);
-        const std::pair<offset_type, offset_type> &Len =
-            InfoObj.EmitKeyDataLength(Out, I->Key, I->Data);
+    // Write out the entries in the bucket.
+    for (Item *I = B.Head; I; I = I->Next) {
+      LE.write<typename Info::hash_value_type>(I->Hash);
+      const std::pair<offset_type, offset_type> &Len =
+          InfoObj.EmitKeyDataLength(Out, I->Key, I->Data);
 #ifdef NDEBUG
-        InfoObj.EmitKey(Out, I->Key, Len.first);
-        InfoObj.EmitData(Out, I->Key, I->Data, Len.second);
+      InfoObj.EmitKey(Out, I->Key, Len.first);
+      InfoObj.EmitData(Out, I->Key, I->Data, Len.second);
 #else
-        // In asserts mode, check that the users length matches the data they
-        // wrote.
-        uint64_t KeyStart = Out.tell();
-        InfoObj.EmitKey(Out, I->Key, Len.first);
-        uint64_t DataStart = Out.tell();
-        InfoObj.EmitData(Out, I->Key, I->Data, Len.second);
-        uint64_t End = Out.tell();
-        assert(offset_type(DataStart - KeyStart) == Len.first &&
-               "key length does not match bytes written");
-        assert(offset_type(End - DataStart) == Len.second &&
-               "data length does not match bytes written");
+      // In asserts mode, check that the users length matches the data they
+      // wrote.
+      uint64_t KeyStart = Out.tell();
+      InfoObj.EmitKey(Out, I->Key, Len.first);
+      uint64_t DataStart = Out.tell();
+      InfoObj.EmitData(Out, I->Key, I->Data, Len.second);
+      uint64_t End = Out.tell();
+      assert(offset_type(DataStart - KeyStart) == Len.first &&
+             "key length does not match bytes written");
+      assert(offset_type(End - DataStart) == Len.second &&
+             "data length does not match bytes written");
 #endif
-      }
     }
+  }
+
+  /// Emit the hashtable itself, after the payload, and return its offset.
+  offset_type emitBucketOffsets(raw_ostream &Out) {
+    using namespace llvm::support;
+    endian::Writer LE(Out, llvm::endianness::little);
 
     // Pad with zeros so that we can start the hashtable at an aligned address.
     offset_type TableOff = Out.tell();
@@ -221,6 +293,7 @@ public:
     return TableOff;
   }
 
+public:
   OnDiskChainedHashTableGenerator() {
     NumEntries = 0;
     NumBuckets = 64;
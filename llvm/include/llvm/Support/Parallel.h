@@ -16,6 +16,7 @@
 #include "llvm/Support/Threading.h"
 
 #include <algorithm>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
@@ -38,20 +39,33 @@ extern ThreadPoolStrategy strategy;
          "ThreadPoolExecutor");                                                \
   return threadIndex;
 
+#define GET_THREAD_INDEX_IF_AVAILABLE_IMPL                                     \
+  if (parallel::strategy.ThreadsRequested == 1)                                \
+    return 0;                                                                  \
+  return threadIndex;
+
 #ifdef _WIN32
 // Direct access to thread_local variables from a different DLL isn't
 // possible with Windows Native TLS.
 unsigned getThreadIndex();
+unsigned getThreadIndexIfAvailable();
 #else
 // Don't access this directly, use the getThreadIndex wrapper.
 extern thread_local unsigned threadIndex;
 
 inline unsigned getThreadIndex() { GET_THREAD_INDEX_IMPL; }
+
+/// Like getThreadIndex(), but return UINT_MAX rather than asserting if the
+/// current thread was not created by ThreadPoolExecutor.
+inline unsigned getThreadIndexIfAvailable() {
+  GET_THREAD_INDEX_IF_AVAILABLE_IMPL;
+}
 #endif
 
 size_t getThreadCount();
 #else
 inline unsigned getThreadIndex() { return 0; }
+inline unsigned getThreadIndexIfAvailable() { return 0; }
 inline size_t getThreadCount() { return 1; }
 #endif
 
@@ -83,6 +97,18 @@ public:
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
   }
+
+  bool isZero() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
+
+  /// Wait for at most \p Timeout and return whether the count is zero.
+  template <typename Rep, typename Period>
+  bool waitFor(const std::chrono::duration<Rep, Period> &Timeout) const {
+    std::unique_lock<std::mutex> lock(Mutex);
+    return Cond.wait_for(lock, Timeout, [&] { return Count == 0; });
+  }
 };
 } // namespace detail
 
@@ -99,7 +125,9 @@ public:
   // exactly in the order which they were spawned.
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  /// Wait for all spawned tasks to finish. On a thread of the default
+  /// executor, pending tasks of any group are run while waiting.
+  void sync() const;
 
   bool isParallel() const { return Parallel; }
 };
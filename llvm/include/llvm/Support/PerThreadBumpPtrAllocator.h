@@ -11,17 +11,19 @@
 
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Parallel.h"
+#include <memory>
+#include <mutex>
 
 namespace llvm {
 namespace parallel {
 
 /// PerThreadAllocator is used in conjunction with ThreadPoolExecutor to allow
 /// per-thread allocations. It wraps a possibly thread-unsafe allocator,
-/// e.g. BumpPtrAllocator. PerThreadAllocator must be used with only main thread
-/// or threads created by ThreadPoolExecutor, as it utilizes getThreadIndex,
-/// which is set by ThreadPoolExecutor. To work properly, ThreadPoolExecutor
+/// e.g. BumpPtrAllocator, with one instance per thread of ThreadPoolExecutor,
+/// selected by getThreadIndex. Other threads, such as the main thread or the
+/// threads of a ThreadPool, share one more instance under a lock, so Allocate
+/// is thread-safe for every thread. To work properly, ThreadPoolExecutor
 /// should be initialized before PerThreadAllocator is created.
-/// TODO: The same approach might be implemented for ThreadPool.
 
 template <typename AllocatorTy>
 class PerThreadAllocator
@@ -29,7 +31,8 @@ class PerThreadAllocator
 public:
   PerThreadAllocator()
       : NumOfAllocators(parallel::getThreadCount()),
-        Allocators(std::make_unique<AllocatorTy[]>(NumOfAllocators)) {}
+        Allocators(std::make_unique<AllocatorTy[]>(NumOfAllocators)),
+        Shared(std::make_unique<SharedAllocator>()) {}
 
   /// \defgroup Methods which could be called asynchronously:
   ///
@@ -41,24 +44,31 @@ public:
 
   /// Allocate \a Size bytes of \a Alignment aligned memory.
   void *Allocate(size_t Size, size_t Alignment) {
-    assert(getThreadIndex() < NumOfAllocators);
-    return Allocators[getThreadIndex()].Allocate(Size, Alignment);
+    unsigned Idx = getThreadIndexIfAvailable();
+    if (LLVM_LIKELY(Idx < NumOfAllocators))
+      return Allocators[Idx].Allocate(Size, Alignment);
+    std::lock_guard<std::mutex> Lock(Shared->Mutex);
+    return Shared->Alloc.Allocate(Size, Alignment);
   }
 
   /// Deallocate \a Ptr to \a Size bytes of memory allocated by this
   /// allocator.
   void Deallocate(const void *Ptr, size_t Size, size_t Alignment) {
-    assert(getThreadIndex() < NumOfAllocators);
-    return Allocators[getThreadIndex()].Deallocate(Ptr, Size, Alignment);
+    unsigned Idx = getThreadIndexIfAvailable();
+    if (LLVM_LIKELY(Idx < NumOfAllocators))
+      return Allocators[Idx].Deallocate(Ptr, Size, Alignment);
+    std::lock_guard<std::mutex> Lock(Shared->Mutex);
+    return Shared->Alloc.Deallocate(Ptr, Size, Alignment);
   }
 
-  /// Return allocator corresponding to the current thread.
+  /// Return allocator corresponding to the current thread, which must have
+  /// been created by ThreadPoolExecutor.
   AllocatorTy &getThreadLocalAllocator() {
     assert(getThreadIndex() < NumOfAllocators);
     return Allocators[getThreadIndex()];
   }
 
-  // Return number of used allocators.
+  // Return number of per-thread allocators.
   size_t getNumberOfAllocators() const { return NumOfAllocators; }
   /// @}
 
@@ -70,6 +80,7 @@ public:
   void Reset() {
     for (size_t Idx = 0; Idx < getNumberOfAllocators(); Idx++)
       Allocators[Idx].Reset();
+    Shared->Alloc.Reset();
   }
 
   /// Return total memory size used by all allocators.
@@ -78,6 +89,7 @@ public:
 
     for (size_t Idx = 0; Idx < getNumberOfAllocators(); Idx++)
       TotalMemory += Allocators[Idx].getTotalMemory();
+    TotalMemory += Shared->Alloc.getTotalMemory();
 
     return TotalMemory;
   }
@@ -88,6 +100,7 @@ public:
 
     for (size_t Idx = 0; Idx < getNumberOfAllocators(); Idx++)
       BytesAllocated += Allocators[Idx].getBytesAllocated();
+    BytesAllocated += Shared->Alloc.getBytesAllocated();
 
     return BytesAllocated;
   }
@@ -96,6 +109,7 @@ public:
   void setRedZoneSize(size_t NewSize) {
     for (size_t Idx = 0; Idx < getNumberOfAllocators(); Idx++)
       Allocators[Idx].setRedZoneSize(NewSize);
+    Shared->Alloc.setRedZoneSize(NewSize);
   }
 
   /// Print statistic for each allocator.
@@ -104,12 +118,22 @@ public:
       errs() << "\n Allocator " << Idx << "\n";
       Allocators[Idx].PrintStats();
     }
+    errs() << "\n Shared allocator\n";
+    Shared->Alloc.PrintStats();
   }
   /// @}
 
 protected:
+  /// The allocator of the threads that were not created by
+  /// ThreadPoolExecutor.
+  struct SharedAllocator {
+    std::mutex Mutex;
+    AllocatorTy Alloc;
+  };
+
   size_t NumOfAllocators;
   std::unique_ptr<AllocatorTy[]> Allocators;
+  std::unique_ptr<SharedAllocator> Shared;
 };
 
 using PerThreadBumpPtrAllocator = PerThreadAllocator<BumpPtrAllocator>;
@@ -78,6 +78,7 @@
 
 #include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/Support/Error.h"
+#include <chrono>
 
 namespace llvm {
 
@@ -115,9 +116,14 @@ struct TimeTraceProfilerEntry;
 /// Initialize the time trace profiler.
 /// This sets up the global \p TimeTraceProfilerInstance
 /// variable to be the profiler instance.
+/// If \p MaxEntries is not zero, only the latest \p MaxEntries events are
+/// kept, like in a ring buffer, so that the profiler can be left enabled for
+/// long runs with bounded memory. The totals per section name still cover all
+/// events.
 void timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
                                  StringRef ProcName,
-                                 bool TimeTraceVerbose = false);
+                                 bool TimeTraceVerbose = false,
+                                 size_t MaxEntries = 0);
 
 /// Cleanup the time trace profiler, if it was initialized.
 void timeTraceProfilerCleanup();
@@ -143,6 +149,20 @@ void timeTraceProfilerWrite(raw_pwrite_stream &OS);
 Error timeTraceProfilerWrite(StringRef PreferredFileName,
                              StringRef FallbackFileName);
 
+/// Make the profiler of the current thread write its profiling data to
+/// \p Path whenever a time section ends at least \p Interval after the last
+/// write, or after timeTraceProfilerRequestFlush() was called. Sections that
+/// are still open are written as if they ended at the time of the write, so a
+/// long run can be inspected while it is in progress. A zero \p Interval only
+/// writes on request. The file is replaced atomically.
+void timeTraceProfilerSetFlush(StringRef Path,
+                               std::chrono::milliseconds Interval);
+
+/// Request a write of the profiling data set up by timeTraceProfilerSetFlush()
+/// at the end of the next time section. This is async-signal-safe, e.g. to
+/// call from a SIGUSR1 handler.
+void timeTraceProfilerRequestFlush();
+
 /// Manually begin a time section, with the given \p Name and \p Detail.
 /// Profiler copies the string data, so the pointers can be given into
 /// temporaries. Time sections can be hierarchical; every Begin must have a
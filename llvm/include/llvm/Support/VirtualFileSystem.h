@@ -17,6 +17,7 @@
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Chrono.h"
 #include "llvm/Support/Errc.h"
@@ -30,6 +31,7 @@
 #include <cstdint>
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <system_error>
@@ -1199,6 +1201,78 @@ protected:
                  unsigned IndentLevel) const override;
 };
 
+/// File system that caches the results of \c status() and \c dir_begin() of
+/// the underlying file system, including failed lookups. This is meant for
+/// long-lived processes that repeat the same queries, e.g. for header search,
+/// on top of \c RealFileSystem. Paths are made absolute before they are looked
+/// up, so the working directory may change.
+///
+/// The cache does not notice changes to the underlying file system by itself.
+/// Clients that watch it, e.g. with clang's DirectoryWatcher, call
+/// \c invalidate() for the paths that changed. At most \c MaxEntries status
+/// results and directory listings are kept, and the cache is flushed when the
+/// limit is reached.
+///
+/// The cache is thread-safe, as long as the underlying file system is.
+class CachingFileSystem
+    : public llvm::RTTIExtends<CachingFileSystem, ProxyFileSystem> {
+public:
+  static const char ID;
+
+  struct Statistics {
+    std::size_t StatusHits = 0;
+    std::size_t StatusMisses = 0;
+    std::size_t DirHits = 0;
+    std::size_t DirMisses = 0;
+    std::size_t Flushes = 0;
+  };
+
+  explicit CachingFileSystem(IntrusiveRefCntPtr<FileSystem> FS,
+                             std::size_t MaxEntries = 1 << 16)
+      : RTTIExtends(std::move(FS)), MaxEntries(MaxEntries) {}
+
+  ErrorOr<Status> status(const Twine &Path) override;
+  bool exists(const Twine &Path) override;
+  directory_iterator dir_begin(const Twine &Dir, std::error_code &EC) override;
+
+  /// Drop the cached status and listing of \p Path, of everything below it,
+  /// and the listing of its parent directory, which may have gained or lost
+  /// \p Path.
+  void invalidate(const Twine &Path);
+
+  /// Drop all cached results.
+  void invalidateAll();
+
+  Statistics getStatistics() const;
+
+  /// A snapshot of the contents of a directory.
+  struct DirListing {
+    std::vector<directory_entry> Entries;
+    /// The error that ended the iteration of the underlying file system, if
+    /// any.
+    std::error_code EC;
+  };
+
+protected:
+  void printImpl(raw_ostream &OS, PrintType Type,
+                 unsigned IndentLevel) const override;
+
+private:
+  /// Make Path absolute in Storage and return it, or return Path if that
+  /// fails.
+  StringRef getKey(const Twine &Path, SmallVectorImpl<char> &Storage) const;
+
+  /// Flush the cache if it is full. Mutex must be held.
+  void flushIfFull();
+
+  const std::size_t MaxEntries;
+  mutable std::mutex Mutex;
+  StringMap<ErrorOr<Status>> StatusCache;
+  /// The listings of directories, or the error dir_begin() returned.
+  StringMap<ErrorOr<std::shared_ptr<const DirListing>>> DirCache;
+  Statistics Stats;
+};
+
 } // namespace vfs
 } // namespace llvm
 
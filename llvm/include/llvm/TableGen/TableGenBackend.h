@@ -48,6 +48,11 @@ public:
 /// is no callback was applied.
 bool ApplyCallback(const RecordKeeper &Records, raw_ostream &OS);
 
+/// Apply the callback registered with the option \p Name, irrespective of the
+/// command line. Returns true if there is no such callback.
+bool ApplyCallback(StringRef Name, const RecordKeeper &Records,
+                   raw_ostream &OS);
+
 } // namespace TableGen::Emitter
 
 /// emitSourceFileHeader - Output an LLVM style file header to the specified
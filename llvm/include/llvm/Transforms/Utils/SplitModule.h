@@ -27,6 +27,9 @@ class Module;
 /// PreserveLocals: Split without externalizing locals.
 /// RoundRobin: Use round-robin distribution of functions to modules instead
 /// of the default name-hash-based one.
+/// CostBased: Cluster functions along the call graph and balance partitions
+/// by estimated codegen cost instead of using name hashes. Takes precedence
+/// over RoundRobin.
 ///
 /// FIXME: This function does not deal with the somewhat subtle symbol
 /// visibility issues around module splitting, including (but not limited to):
@@ -38,7 +41,8 @@ class Module;
 void SplitModule(
     Module &M, unsigned N,
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
-    bool PreserveLocals = false, bool RoundRobin = false);
+    bool PreserveLocals = false, bool RoundRobin = false,
+    bool CostBased = false);
 
 } // end namespace llvm
 
@@ -219,7 +219,7 @@ class MemDGNode final : public DGNode {
 
   void setNextNode(MemDGNode *N) { NextMemN = N; }
   void setPrevNode(MemDGNode *N) { PrevMemN = N; }
-  friend class DependencyGraph; // For setNextNode(), setPrevNode().
+  friend class DependencyGraph; // For setNextNode(), setPrevNode(), MemPreds.
   void detachFromChain() {
     if (PrevMemN != nullptr)
       PrevMemN->NextMemN = NextMemN;
@@ -258,6 +258,15 @@ public:
       ++PredN->UnscheduledSuccs;
     }
   }
+  /// Removes the mem dependency edge PredN->this. This also decrements the
+  /// UnscheduledSuccs counter of the predecessor if this node has not been
+  /// scheduled.
+  void removeMemPred(MemDGNode *PredN) {
+    [[maybe_unused]] auto Erased = MemPreds.erase(PredN);
+    assert(Erased && "PredN not found!");
+    if (!Scheduled)
+      PredN->decrUnscheduledSuccs();
+  }
   /// \Returns true if there is a memory dependency N->this.
   bool hasMemPred(DGNode *N) const {
     if (auto *MN = dyn_cast<MemDGNode>(N))
@@ -320,7 +329,13 @@ private:
   /// as it won't call AA. Therefore it returns the worst-case dep type.
   static DependencyType getRoughDepType(Instruction *FromI, Instruction *ToI);
 
-  // TODO: Implement AABudget.
+  /// The number of alias queries left for finding the memory dependencies of
+  /// the current destination node. Once it reaches zero, the remaining sources
+  /// are assumed to alias without asking AA.
+  unsigned AABudgetLeft = 0;
+  /// Resets the AA budget before scanning for the deps of a new node.
+  void resetAABudget();
+
   /// \Returns true if there is a memory/other dependency \p SrcI->DstI.
   bool alias(Instruction *SrcI, Instruction *DstI, DependencyType DepType);
 
@@ -46,6 +46,7 @@
 #include "llvm/Support/AtomicOrdering.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
+#include <atomic>
 #include <cassert>
 #include <functional>
 #include <iterator>
@@ -71,6 +72,11 @@ static cl::opt<bool> EnableAATrace("aa-trace", cl::Hidden, cl::init(false));
 static const bool EnableAATrace = false;
 #endif
 
+uint64_t AAQueryInfo::getNextBatchID() {
+  static std::atomic<uint64_t> NextBatchID{0};
+  return NextBatchID.fetch_add(1, std::memory_order_relaxed);
+}
+
 AAResults::AAResults(const TargetLibraryInfo &TLI) : TLI(TLI) {}
 
 AAResults::AAResults(AAResults &&Arg)
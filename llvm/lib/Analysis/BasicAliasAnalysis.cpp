@@ -14,6 +14,8 @@
 
 #include "llvm/Analysis/BasicAliasAnalysis.h"
 #include "llvm/ADT/APInt.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
@@ -78,11 +80,28 @@ static cl::opt<bool> EnableSeparateStorageAnalysis("basic-aa-separate-storage",
 STATISTIC(SearchLimitReached, "Number of times the limit to "
                               "decompose GEPs is reached");
 STATISTIC(SearchTimes, "Number of times a GEP is decomposed");
+STATISTIC(NumBatchCacheHits, "Number of GEP decompositions and underlying "
+                             "objects reused within a batch of queries");
 
 // The max limit of the search depth in DecomposeGEPExpression() and
 // getUnderlyingObject().
 static const unsigned MaxLookupSearchDepth = 6;
 
+BasicAAResult::BasicAAResult(const DataLayout &DL, const Function &F,
+                             const TargetLibraryInfo &TLI, AssumptionCache &AC,
+                             DominatorTree *DT)
+    : DL(DL), F(F), TLI(TLI), AC(AC), DT_(DT) {}
+
+BasicAAResult::BasicAAResult(const BasicAAResult &Arg)
+    : AAResultBase(Arg), DL(Arg.DL), F(Arg.F), TLI(Arg.TLI), AC(Arg.AC),
+      DT_(Arg.DT_) {}
+
+BasicAAResult::BasicAAResult(BasicAAResult &&Arg)
+    : AAResultBase(std::move(Arg)), DL(Arg.DL), F(Arg.F), TLI(Arg.TLI),
+      AC(Arg.AC), DT_(Arg.DT_), BatchCache(std::move(Arg.BatchCache)) {}
+
+BasicAAResult::~BasicAAResult() = default;
+
 bool BasicAAResult::invalidate(Function &Fn, const PreservedAnalyses &PA,
                                FunctionAnalysisManager::Invalidator &Inv) {
   // We don't care if this analysis itself is preserved, it has no state. But
@@ -564,6 +583,51 @@ struct BasicAAResult::DecomposedGEP {
   }
 };
 
+struct BasicAAResult::BatchCacheT {
+  /// The AAQueryInfo the entries were computed for.
+  uint64_t BatchID;
+  /// Decompositions keyed by the pointer and whether the dominator tree was
+  /// available while computing them.
+  DenseMap<PointerIntPair<const Value *, 1, bool>, DecomposedGEP> Decomposed;
+  DenseMap<const Value *, const Value *> UnderlyingObjects;
+};
+
+BasicAAResult::BatchCacheT &
+BasicAAResult::getBatchCache(const AAQueryInfo &AAQI) {
+  if (!BatchCache)
+    BatchCache = std::make_unique<BatchCacheT>();
+  if (BatchCache->BatchID != AAQI.BatchID) {
+    BatchCache->BatchID = AAQI.BatchID;
+    BatchCache->Decomposed.clear();
+    BatchCache->UnderlyingObjects.clear();
+  }
+  return *BatchCache;
+}
+
+BasicAAResult::DecomposedGEP
+BasicAAResult::getDecomposedGEP(const Value *V, const AAQueryInfo &AAQI) {
+  DominatorTree *DT = getDT(AAQI);
+  auto &Decomposed = getBatchCache(AAQI).Decomposed;
+  auto [It, Inserted] = Decomposed.try_emplace({V, DT != nullptr});
+  if (Inserted)
+    It->second = DecomposeGEPExpression(V, DL, &AC, DT);
+  else
+    ++NumBatchCacheHits;
+  return It->second;
+}
+
+const Value *
+BasicAAResult::getUnderlyingObjectCached(const Value *V,
+                                         const AAQueryInfo &AAQI) {
+  auto &UnderlyingObjects = getBatchCache(AAQI).UnderlyingObjects;
+  auto [It, Inserted] = UnderlyingObjects.try_emplace(V);
+  if (Inserted)
+    It->second = getUnderlyingObject(V, MaxLookupSearchDepth);
+  else
+    ++NumBatchCacheHits;
+  return It->second;
+}
+
 
 /// If V is a symbolic pointer expression, decompose it into a base pointer
 /// with a constant offset and a number of scaled symbolic offsets.
@@ -1083,8 +1147,8 @@ AliasResult BasicAAResult::aliasGEP(
   }
 
   DominatorTree *DT = getDT(AAQI);
-  DecomposedGEP DecompGEP1 = DecomposeGEPExpression(GEP1, DL, &AC, DT);
-  DecomposedGEP DecompGEP2 = DecomposeGEPExpression(V2, DL, &AC, DT);
+  DecomposedGEP DecompGEP1 = getDecomposedGEP(GEP1, AAQI);
+  DecomposedGEP DecompGEP2 = getDecomposedGEP(V2, AAQI);
 
   // Bail if we were not able to decompose anything.
   if (DecompGEP1.Base == GEP1 && DecompGEP2.Base == V2)
@@ -1572,8 +1636,8 @@ AliasResult BasicAAResult::aliasCheck(const Value *V1, LocationSize V1Size,
     return AliasResult::NoAlias; // Scalars cannot alias each other
 
   // Figure out what objects these things are pointing to if we can.
-  const Value *O1 = getUnderlyingObject(V1, MaxLookupSearchDepth);
-  const Value *O2 = getUnderlyingObject(V2, MaxLookupSearchDepth);
+  const Value *O1 = getUnderlyingObjectCached(V1, AAQI);
+  const Value *O2 = getUnderlyingObjectCached(V2, AAQI);
 
   // Null values in the default address space don't point to any object, so they
   // don't alias any other pointer.
@@ -14,6 +14,7 @@
 #include "llvm/Analysis/LazyValueInfo.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/ConstantFolding.h"
 #include "llvm/Analysis/InstructionSimplify.h"
@@ -36,6 +37,7 @@
 #include "llvm/IR/PatternMatch.h"
 #include "llvm/IR/ValueHandle.h"
 #include "llvm/InitializePasses.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FormattedStream.h"
 #include "llvm/Support/KnownBits.h"
@@ -50,6 +52,14 @@ using namespace PatternMatch;
 // answer for a given value.
 static const unsigned MaxProcessedPerValue = 500;
 
+static cl::opt<unsigned> MaxCacheEntries(
+    "lvi-max-cache-entries", cl::Hidden, cl::init(0),
+    cl::desc("Maximum number of values cached per function before the blocks "
+             "cached first are evicted (0 = no limit)"));
+
+STATISTIC(MaxCachedEntries, "Maximum number of values cached for a function");
+STATISTIC(NumEvictedBlocks, "Number of blocks evicted from the cache");
+
 char LazyValueInfoWrapperPass::ID = 0;
 LazyValueInfoWrapperPass::LazyValueInfoWrapperPass() : FunctionPass(ID) {
   initializeLazyValueInfoWrapperPassPass(*PassRegistry::getPassRegistry());
@@ -121,11 +131,20 @@ class LazyValueInfoCache {
     std::optional<NonNullPointerSet> NonNullPointers;
   };
 
+  static unsigned getNumEntries(const BlockCacheEntry &E) {
+    return E.LatticeElements.size() + E.OverDefined.size() +
+           (E.NonNullPointers ? E.NonNullPointers->size() : 0);
+  }
+
   /// Cached information per basic block.
   DenseMap<PoisoningVH<BasicBlock>, std::unique_ptr<BlockCacheEntry>>
       BlockCache;
   /// Set of value handles used to erase values from the cache on deletion.
   DenseSet<LVIValueHandle, DenseMapInfo<Value *>> ValueHandles;
+  /// With -lvi-max-cache-entries, the blocks in the order their entries were
+  /// created, and an upper bound on the number of values cached.
+  SmallVector<BasicBlock *, 0> BlockOrder;
+  unsigned NumEntriesBound = 0;
 
   const BlockCacheEntry *getBlockEntry(BasicBlock *BB) const {
     auto It = BlockCache.find_as(BB);
@@ -136,8 +155,11 @@ class LazyValueInfoCache {
 
   BlockCacheEntry *getOrCreateBlockEntry(BasicBlock *BB) {
     auto It = BlockCache.find_as(BB);
-    if (It == BlockCache.end())
+    if (It == BlockCache.end()) {
       It = BlockCache.insert({BB, std::make_unique<BlockCacheEntry>()}).first;
+      if (MaxCacheEntries)
+        BlockOrder.push_back(BB);
+    }
 
     return It->second.get();
   }
@@ -159,6 +181,7 @@ public:
       Entry->OverDefined.insert(Val);
     else
       Entry->LatticeElements.insert({Val, Result});
+    ++NumEntriesBound;
 
     addValueHandle(Val);
   }
@@ -185,6 +208,7 @@ public:
     BlockCacheEntry *Entry = getOrCreateBlockEntry(BB);
     if (!Entry->NonNullPointers) {
       Entry->NonNullPointers = InitFn(BB);
+      NumEntriesBound += Entry->NonNullPointers->size();
       for (Value *V : *Entry->NonNullPointers)
         addValueHandle(V);
     }
@@ -196,8 +220,15 @@ public:
   void clear() {
     BlockCache.clear();
     ValueHandles.clear();
+    BlockOrder.clear();
+    NumEntriesBound = 0;
   }
 
+  /// Evict the blocks cached first if more than -lvi-max-cache-entries values
+  /// are cached. This must not be called while solving, which relies on the
+  /// values it has computed staying in the cache.
+  void trimToLimit();
+
   /// Inform the cache that a given value has been deleted.
   void eraseValue(Value *V);
 
@@ -231,6 +262,32 @@ void LVIValueHandle::deleted() {
   Parent->eraseValue(*this);
 }
 
+void LazyValueInfoCache::trimToLimit() {
+  if (!MaxCacheEntries || NumEntriesBound <= MaxCacheEntries)
+    return;
+
+  // Erasing values and blocks does not update the bound, so compute the
+  // actual number first.
+  unsigned NumEntries = 0;
+  for (const auto &Pair : BlockCache)
+    NumEntries += getNumEntries(*Pair.second);
+  MaxCachedEntries.updateMax(NumEntries);
+
+  // Evict down to half the limit, so that this does not happen again on the
+  // next query. BlockOrder may name blocks that have been erased already.
+  unsigned I = 0, E = BlockOrder.size();
+  for (; I != E && NumEntries > MaxCacheEntries / 2; ++I) {
+    auto It = BlockCache.find_as(BlockOrder[I]);
+    if (It == BlockCache.end())
+      continue;
+    NumEntries -= getNumEntries(*It->second);
+    BlockCache.erase(It);
+    ++NumEvictedBlocks;
+  }
+  BlockOrder.erase(BlockOrder.begin(), BlockOrder.begin() + I);
+  NumEntriesBound = NumEntries;
+}
+
 void LazyValueInfoCache::eraseBlock(BasicBlock *BB) {
   BlockCache.erase(BB);
 }
@@ -1548,6 +1605,7 @@ ValueLatticeElement LazyValueInfoImpl::getValueInBlock(Value *V, BasicBlock *BB,
                     << BB->getName() << "'\n");
 
   assert(BlockValueStack.empty() && BlockValueSet.empty());
+  TheCache.trimToLimit();
   std::optional<ValueLatticeElement> OptResult = getBlockValue(V, BB, CxtI);
   if (!OptResult) {
     solve();
@@ -1583,6 +1641,7 @@ getValueOnEdge(Value *V, BasicBlock *FromBB, BasicBlock *ToBB,
                     << FromBB->getName() << "' to '" << ToBB->getName()
                     << "'\n");
 
+  TheCache.trimToLimit();
   std::optional<ValueLatticeElement> Result =
       getEdgeValue(V, FromBB, ToBB, CxtI);
   while (!Result) {
@@ -1288,6 +1288,36 @@ void MemorySSAUpdater::wireOldPredecessorsToNewImmediatePredecessor(
 }
 
 void MemorySSAUpdater::removeMemoryAccess(MemoryAccess *MA, bool OptimizePhis) {
+  SmallSetVector<MemoryPhi *, 4> PhisToCheck;
+  removeMemoryAccessImpl(MA, OptimizePhis ? &PhisToCheck : nullptr);
+  optimizePhis(PhisToCheck);
+}
+
+void MemorySSAUpdater::removeMemoryAccesses(ArrayRef<MemoryAccess *> MAs,
+                                            bool OptimizePhis) {
+  // Collect the phis whose incoming values changed across the whole batch, so
+  // that each of them is only checked once at the end.
+  SmallSetVector<MemoryPhi *, 4> PhisToCheck;
+  for (MemoryAccess *MA : MAs)
+    removeMemoryAccessImpl(MA, OptimizePhis ? &PhisToCheck : nullptr);
+  optimizePhis(PhisToCheck);
+}
+
+void MemorySSAUpdater::optimizePhis(SmallSetVector<MemoryPhi *, 4> &Phis) {
+  if (Phis.empty())
+    return;
+  // This will recursively remove trivial phis.
+  SmallVector<WeakVH, 16> PhisToOptimize{Phis.begin(), Phis.end()};
+  Phis.clear();
+
+  unsigned PhisSize = PhisToOptimize.size();
+  while (PhisSize-- > 0)
+    if (MemoryPhi *MP = cast_or_null<MemoryPhi>(PhisToOptimize.pop_back_val()))
+      tryRemoveTrivialPhi(MP);
+}
+
+void MemorySSAUpdater::removeMemoryAccessImpl(
+    MemoryAccess *MA, SmallSetVector<MemoryPhi *, 4> *PhisToCheck) {
   assert(!MSSA->isLiveOnEntryDef(MA) &&
          "Trying to remove the live on entry def");
   // We can only delete phi nodes if they have no uses, or we can replace all
@@ -1302,12 +1332,12 @@ void MemorySSAUpdater::removeMemoryAccess(MemoryAccess *MA, bool OptimizePhis) {
     NewDefTarget = onlySingleValue(MP);
     assert((NewDefTarget || MP->use_empty()) &&
            "We can't delete this memory phi");
+    if (PhisToCheck)
+      PhisToCheck->remove(MP);
   } else {
     NewDefTarget = cast<MemoryUseOrDef>(MA)->getDefiningAccess();
   }
 
-  SmallSetVector<MemoryPhi *, 4> PhisToCheck;
-
   // Re-point the uses at our defining access
   if (!isa<MemoryUse>(MA) && !MA->use_empty()) {
     // Reset optimized on users of this store, and reset the uses.
@@ -1328,9 +1358,9 @@ void MemorySSAUpdater::removeMemoryAccess(MemoryAccess *MA, bool OptimizePhis) {
       Use &U = *MA->use_begin();
       if (auto *MUD = dyn_cast<MemoryUseOrDef>(U.getUser()))
         MUD->resetOptimized();
-      if (OptimizePhis)
+      if (PhisToCheck)
         if (MemoryPhi *MP = dyn_cast<MemoryPhi>(U.getUser()))
-          PhisToCheck.insert(MP);
+          PhisToCheck->insert(MP);
       U.set(NewDefTarget);
     }
   }
@@ -1339,19 +1369,6 @@ void MemorySSAUpdater::removeMemoryAccess(MemoryAccess *MA, bool OptimizePhis) {
   // are doing things here
   MSSA->removeFromLookups(MA);
   MSSA->removeFromLists(MA);
-
-  // Optionally optimize Phi uses. This will recursively remove trivial phis.
-  if (!PhisToCheck.empty()) {
-    SmallVector<WeakVH, 16> PhisToOptimize{PhisToCheck.begin(),
-                                           PhisToCheck.end()};
-    PhisToCheck.clear();
-
-    unsigned PhisSize = PhisToOptimize.size();
-    while (PhisSize-- > 0)
-      if (MemoryPhi *MP =
-              cast_or_null<MemoryPhi>(PhisToOptimize.pop_back_val()))
-        tryRemoveTrivialPhi(MP);
-  }
 }
 
 void MemorySSAUpdater::removeBlocks(
@@ -142,6 +142,8 @@ STATISTIC(NumExitCountsComputed,
           "Number of loop exits with predictable exit counts");
 STATISTIC(NumExitCountsNotComputed,
           "Number of loop exits without predictable exit counts");
+STATISTIC(NumCacheFlushes,
+          "Number of times a SCEV range or disposition cache was flushed");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
 
@@ -219,6 +221,12 @@ static cl::opt<unsigned>
                   cl::desc("Size of the expression which is considered huge"),
                   cl::init(4096));
 
+static cl::opt<unsigned> MaxCacheEntries(
+    "scalar-evolution-max-cache-entries", cl::Hidden,
+    cl::desc("Maximum number of entries in each of the range and block "
+             "disposition caches before they are flushed (0 = no limit)"),
+    cl::init(0));
+
 static cl::opt<unsigned> RangeIterThreshold(
     "scev-range-iter-threshold", cl::Hidden,
     cl::desc("Threshold for switching to iteratively computing SCEV ranges"),
@@ -6558,6 +6566,22 @@ getRangeForUnknownRecurrence(const SCEVUnknown *U) {
   return FullSet;
 }
 
+const ConstantRange &ScalarEvolution::setRange(const SCEV *S,
+                                               RangeSignHint Hint,
+                                               ConstantRange CR) {
+  DenseMap<const SCEV *, ConstantRange> &Cache =
+      Hint == HINT_RANGE_UNSIGNED ? UnsignedRanges : SignedRanges;
+
+  // Callers never hold references into the cache across a call to setRange,
+  // since inserting may grow it, so it can be dropped here as well.
+  if (MaxCacheEntries && Cache.size() >= MaxCacheEntries) {
+    Cache.clear();
+    ++NumCacheFlushes;
+  }
+  auto Pair = Cache.insert_or_assign(S, std::move(CR));
+  return Pair.first->second;
+}
+
 const ConstantRange &
 ScalarEvolution::getRangeRefIter(const SCEV *S,
                                  ScalarEvolution::RangeSignHint SignHint) {
@@ -14112,6 +14136,12 @@ bool ScalarEvolution::hasComputableLoopEvolution(const SCEV *S, const Loop *L) {
 
 ScalarEvolution::BlockDisposition
 ScalarEvolution::getBlockDisposition(const SCEV *S, const BasicBlock *BB) {
+  // Dispositions are only a cache and can be recomputed, so drop all of them
+  // rather than let them grow without bound on huge functions.
+  if (MaxCacheEntries && BlockDispositions.size() >= MaxCacheEntries) {
+    BlockDispositions.clear();
+    ++NumCacheFlushes;
+  }
   auto &Values = BlockDispositions[S];
   for (auto &V : Values) {
     if (V.getPointer() == BB)
@@ -421,6 +421,13 @@ class MetadataLoader::MetadataLoaderImpl {
   /// populated.
   MDString *lazyLoadOneMDString(unsigned Idx);
 
+  /// Return the MDString for a string that points into the bitcode buffer.
+  MDString *getMDStringFromBitcode(StringRef Str) {
+    if (Context.shouldReferenceBitcodeMDStrings())
+      return MDString::getUnowned(Context, Str);
+    return MDString::get(Context, Str);
+  }
+
   /// Index that keeps track of where to find a metadata record in the stream.
   std::vector<uint64_t> GlobalMetadataBitPosIndex;
 
@@ -1148,7 +1155,7 @@ MDString *MetadataLoader::MetadataLoaderImpl::lazyLoadOneMDString(unsigned ID) {
   ++NumMDStringLoaded;
   if (Metadata *MD = MetadataList.lookup(ID))
     return cast<MDString>(MD);
-  auto MDS = MDString::get(Context, MDStringRef[ID]);
+  auto MDS = getMDStringFromBitcode(MDStringRef[ID]);
   MetadataList.assignValue(MDS, ID);
   return MDS;
 }
@@ -2243,7 +2250,7 @@ Error MetadataLoader::MetadataLoaderImpl::parseOneMetadata(
   case bitc::METADATA_STRINGS: {
     auto CreateNextMDString = [&](StringRef Str) {
       ++NumMDStringLoaded;
-      MetadataList.assignValue(MDString::get(Context, Str), NextMetadataNo);
+      MetadataList.assignValue(getMDStringFromBitcode(Str), NextMetadataNo);
       NextMetadataNo++;
     };
     if (Error Err = parseMetadataStrings(Record, Blob, CreateNextMDString))
@@ -68,6 +68,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Triple.h"
@@ -94,6 +95,11 @@ static cl::opt<uint32_t> FlushThreshold(
     "bitcode-flush-threshold", cl::Hidden, cl::init(512),
     cl::desc("The threshold (unit M) for flushing LLVM bitcode."));
 
+static cl::opt<bool> ParallelFunctionBlocks(
+    "bitcode-parallel-function-blocks", cl::Hidden, cl::init(false),
+    cl::desc("Write the function blocks of a module in parallel. The output "
+             "is identical to writing them serially."));
+
 static cl::opt<bool> WriteRelBFToSummary(
     "write-relbf-to-summary", cl::Hidden, cl::init(false),
     cl::desc("Write relative block frequency to function summary "));
@@ -225,6 +231,14 @@ public:
         }
   }
 
+  /// Constructs a ModuleBitcodeWriterBase object that shares the enumeration
+  /// of \p Parent and writes to \p Stream.
+  ModuleBitcodeWriterBase(const ModuleBitcodeWriterBase &Parent,
+                          BitstreamWriter &Stream)
+      : BitcodeWriterBase(Stream, Parent.StrtabBuilder), M(Parent.M),
+        VE(Parent.VE), Index(Parent.Index),
+        GlobalValueId(Parent.GlobalValueId) {}
+
 protected:
   void writePerModuleGlobalValueSummary();
 
@@ -289,6 +303,13 @@ public:
         GenerateHash(GenerateHash), ModHash(ModHash),
         BitcodeStartBit(Stream.GetCurrentBitNo()) {}
 
+  /// Constructs a ModuleBitcodeWriter object that writes function blocks of
+  /// the module of \p Parent to \p Stream.
+  ModuleBitcodeWriter(const ModuleBitcodeWriter &Parent,
+                      BitstreamWriter &Stream)
+      : ModuleBitcodeWriterBase(Parent, Stream), GenerateHash(false),
+        ModHash(nullptr), BitcodeStartBit(Stream.GetCurrentBitNo()) {}
+
   /// Emit the current module to the bitstream.
   void write();
 
@@ -416,6 +437,8 @@ private:
   void
   writeFunction(const Function &F,
                 DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex);
+  void writeFunctionBlocks(
+      DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex);
   void writeBlockInfo();
   void writeModuleHash(StringRef View);
 
@@ -3752,6 +3775,87 @@ void ModuleBitcodeWriter::writeFunction(
   Stream.ExitBlock();
 }
 
+/// Emit the bodies of all functions defined in the module.
+void ModuleBitcodeWriter::writeFunctionBlocks(
+    DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex) {
+  SmallVector<const Function *, 0> Functions;
+  uint64_t NumInsts = 0;
+  for (const Function &F : M) {
+    if (F.isDeclaration())
+      continue;
+    Functions.push_back(&F);
+    NumInsts += F.getInstructionCount();
+  }
+
+  // With -bitcode-parallel-function-blocks, the functions are split into
+  // contiguous chunks of about the same number of instructions. Each chunk is
+  // written by a copy of this writer, whose value enumerator is a copy of
+  // ours, into a buffer of its own. Function blocks start and end at 32-bit
+  // boundaries, so the buffers are then copied into the stream as is. The
+  // use-list order blocks are written from a stack shared by all functions,
+  // so they are only written serially. Every chunk copies the value
+  // enumerator, which bounds the number of chunks.
+  size_t NumChunks = std::min<size_t>(
+      {parallel::strategy.compute_thread_count(), Functions.size(), 8});
+  if (!ParallelFunctionBlocks || NumChunks < 2 ||
+      VE.shouldPreserveUseListOrder() || Stream.GetCurrentBitNo() % 32) {
+    for (const Function *F : Functions)
+      writeFunction(*F, FunctionToBitcodeIndex);
+    return;
+  }
+
+  struct Chunk {
+    size_t Begin = 0;
+    size_t End = 0;
+    SmallVector<char, 0> Buffer;
+    // The range of the function blocks in Buffer, in bytes.
+    size_t BlocksBegin = 0;
+    size_t BlocksEnd = 0;
+    // The bit offsets of the function blocks relative to BlocksBegin.
+    SmallVector<uint64_t, 0> Offsets;
+  };
+  SmallVector<Chunk, 0> Chunks(NumChunks);
+  uint64_t InstsPerChunk = NumInsts / NumChunks + 1;
+  uint64_t Insts = 0;
+  for (size_t I = 0, C = 0, E = Functions.size(); I != E; ++I) {
+    Chunks[C].End = I + 1;
+    Insts += Functions[I]->getInstructionCount();
+    if (Insts >= InstsPerChunk * (C + 1) && C + 1 != NumChunks)
+      Chunks[++C].Begin = I + 1;
+  }
+  for (size_t C = 1; C != NumChunks; ++C)
+    Chunks[C].End = std::max(Chunks[C].Begin, Chunks[C].End);
+
+  parallelFor(0, NumChunks, [&](size_t C) {
+    Chunk &Ch = Chunks[C];
+    if (Ch.Begin == Ch.End)
+      return;
+    BitstreamWriter ChunkStream(Ch.Buffer);
+    ChunkStream.copyBlockInfo(Stream);
+    // The function blocks are nested in a block with the abbrev ID width of
+    // the module block, so that they encode exactly as in the module block.
+    ChunkStream.EnterSubblock(bitc::MODULE_BLOCK_ID, Stream.GetAbbrevIDWidth());
+    uint64_t Begin = ChunkStream.GetCurrentBitNo();
+    ModuleBitcodeWriter Writer(*this, ChunkStream);
+    DenseMap<const Function *, uint64_t> Indices;
+    for (size_t I = Ch.Begin; I != Ch.End; ++I) {
+      Writer.writeFunction(*Functions[I], Indices);
+      Ch.Offsets.push_back(Indices[Functions[I]] - Begin);
+    }
+    Ch.BlocksBegin = Begin / 8;
+    Ch.BlocksEnd = ChunkStream.GetCurrentBitNo() / 8;
+    ChunkStream.ExitBlock();
+  });
+
+  for (Chunk &Ch : Chunks) {
+    uint64_t Base = Stream.GetCurrentBitNo();
+    for (size_t I = Ch.Begin; I != Ch.End; ++I)
+      FunctionToBitcodeIndex[Functions[I]] = Base + Ch.Offsets[I - Ch.Begin];
+    Stream.emitAlignedBytes(ArrayRef(Ch.Buffer).slice(
+        Ch.BlocksBegin, Ch.BlocksEnd - Ch.BlocksBegin));
+  }
+}
+
 // Emit blockinfo, which defines the standard abbreviations etc.
 void ModuleBitcodeWriter::writeBlockInfo() {
   // We only want to emit block info records for blocks that have multiple
@@ -4429,16 +4533,32 @@ void ModuleBitcodeWriterBase::writeModuleLevelReferences(
   NameVals.clear();
 }
 
-/// Emit the per-module summary section alongside the rest of
-/// the module's bitcode.
-void ModuleBitcodeWriterBase::writePerModuleGlobalValueSummary() {
+/// Returns whether the per-module summary of M is written as a ThinLTO summary
+/// rather than as a full LTO one.
+static bool isThinLTOModule(const Module &M) {
   // By default we compile with ThinLTO if the module has a summary, but the
   // client can request full LTO with a module flag.
-  bool IsThinLTO = true;
   if (auto *MD =
           mdconst::extract_or_null<ConstantInt>(M.getModuleFlag("ThinLTO")))
-    IsThinLTO = MD->getZExtValue();
-  Stream.EnterSubblock(IsThinLTO ? bitc::GLOBALVAL_SUMMARY_BLOCK_ID
+    return MD->getZExtValue();
+  return true;
+}
+
+/// Returns the LTO information that BitcodeModule::getLTOInfo will find for M
+/// written with the per-module summary Index.
+static BitcodeLTOInfo getWrittenLTOInfo(const Module &M,
+                                        const ModuleSummaryIndex *Index) {
+  if (!Index)
+    return BitcodeLTOInfo{/*IsThinLTO=*/false, /*HasSummary=*/false,
+                          /*EnableSplitLTOUnit=*/false, /*UnifiedLTO=*/false};
+  return BitcodeLTOInfo{isThinLTOModule(M), /*HasSummary=*/true,
+                        Index->enableSplitLTOUnit(), Index->hasUnifiedLTO()};
+}
+
+/// Emit the per-module summary section alongside the rest of
+/// the module's bitcode.
+void ModuleBitcodeWriterBase::writePerModuleGlobalValueSummary() {
+  Stream.EnterSubblock(isThinLTOModule(M) ? bitc::GLOBALVAL_SUMMARY_BLOCK_ID
                                  : bitc::FULL_LTO_GLOBALVAL_SUMMARY_BLOCK_ID,
                        4);
 
@@ -5161,9 +5281,7 @@ void ModuleBitcodeWriter::write() {
 
   // Emit function bodies.
   DenseMap<const Function *, uint64_t> FunctionToBitcodeIndex;
-  for (const Function &F : M)
-    if (!F.isDeclaration())
-      writeFunction(F, FunctionToBitcodeIndex);
+  writeFunctionBlocks(FunctionToBitcodeIndex);
 
   // Need to write after the above call to WriteFunction which populates
   // the summary information in the index.
@@ -5301,7 +5419,8 @@ void BitcodeWriter::writeSymtab() {
   // module is malformed (e.g. it contains an invalid alias). Writing a symbol
   // table is not required for correctness, but we still want to be able to
   // write malformed modules to bitcode files, so swallow the error.
-  if (Error E = irsymtab::build(Mods, Symtab, StrtabBuilder, Alloc)) {
+  if (Error E =
+          irsymtab::build(Mods, Symtab, StrtabBuilder, Alloc, LTOInfos)) {
     consumeError(std::move(E));
     return;
   }
@@ -5341,6 +5460,7 @@ void BitcodeWriter::writeModule(const Module &M,
   // after checking that it is in fact materialized.
   assert(M.isMaterialized());
   Mods.push_back(const_cast<Module *>(&M));
+  LTOInfos.push_back(getWrittenLTOInfo(M, Index));
 
   ModuleBitcodeWriter ModuleWriter(M, StrtabBuilder, *Stream,
                                    ShouldPreserveUseListOrder, Index,
@@ -5557,6 +5677,7 @@ void BitcodeWriter::writeThinLinkBitcode(const Module &M,
   // after checking that it is in fact materialized.
   assert(M.isMaterialized());
   Mods.push_back(const_cast<Module *>(&M));
+  LTOInfos.push_back(getWrittenLTOInfo(M, &Index));
 
   ThinLinkBitcodeWriter ThinLinkWriter(M, StrtabBuilder, *Stream, Index,
                                        ModHash);
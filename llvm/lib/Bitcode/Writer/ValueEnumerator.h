@@ -139,7 +139,9 @@ private:
 
 public:
   ValueEnumerator(const Module &M, bool ShouldPreserveUseListOrder);
-  ValueEnumerator(const ValueEnumerator &) = delete;
+  /// Copying is expensive. It is used to enumerate the function-local values
+  /// of several functions at the same time.
+  ValueEnumerator(const ValueEnumerator &) = default;
   ValueEnumerator &operator=(const ValueEnumerator &) = delete;
 
   void dump() const;
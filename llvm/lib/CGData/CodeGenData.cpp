@@ -13,6 +13,7 @@
 
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/CGData/CodeGenDataReader.h"
+#include "llvm/CGData/CodeGenDataWriter.h"
 #include "llvm/CGData/OutlinedHashTreeRecord.h"
 #include "llvm/CGData/StableFunctionMapRecord.h"
 #include "llvm/Object/ObjectFile.h"
@@ -21,6 +22,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/WithColor.h"
+#include "llvm/Support/xxhash.h"
 
 #define DEBUG_TYPE "cg-data"
 
@@ -38,6 +40,12 @@ cl::opt<bool> CodeGenDataThinLTOTwoRounds(
     cl::desc("Enable two-round ThinLTO code generation. The first round "
              "emits codegen data, while the second round uses the emitted "
              "codegen data for further optimizations."));
+cl::opt<unsigned> CodeGenDataThinLTOReuseHours(
+    "codegen-data-thinlto-reuse-hours", cl::init(0), cl::Hidden,
+    cl::desc("With -codegen-data-thinlto-two-rounds and a ThinLTO cache, save "
+             "the merged codegen data in the cache, and let the links of the "
+             "next N hours run a single round of code generation using it. "
+             "The saved data is regenerated once it is older than that."));
 
 static std::string getCGDataErrString(cgdata_error Err,
                                       const std::string &ErrMsg = "") {
@@ -254,10 +262,11 @@ std::unique_ptr<Module> loadModuleForTwoRounds(BitcodeModule &OrigModule,
   return std::move(*RestoredModule);
 }
 
-Expected<stable_hash> mergeCodeGenData(ArrayRef<StringRef> ObjFiles) {
-  OutlinedHashTreeRecord GlobalOutlineRecord;
-  StableFunctionMapRecord GlobalStableFunctionMapRecord;
-  stable_hash CombinedHash = 0;
+/// Merge the codegen data of the object files \p ObjFiles into the records.
+static Error mergeObjectFiles(ArrayRef<StringRef> ObjFiles,
+                              OutlinedHashTreeRecord &GlobalOutlineRecord,
+                              StableFunctionMapRecord &GlobalFunctionMapRecord,
+                              stable_hash *CombinedHash) {
   for (auto File : ObjFiles) {
     if (File.empty())
       continue;
@@ -270,12 +279,22 @@ Expected<stable_hash> mergeCodeGenData(ArrayRef<StringRef> ObjFiles) {
 
     std::unique_ptr<object::ObjectFile> &Obj = BinOrErr.get();
     if (auto E = CodeGenDataReader::mergeFromObjectFile(
-            Obj.get(), GlobalOutlineRecord, GlobalStableFunctionMapRecord,
-            &CombinedHash))
+            Obj.get(), GlobalOutlineRecord, GlobalFunctionMapRecord,
+            CombinedHash))
       return E;
   }
 
-  GlobalStableFunctionMapRecord.finalize();
+  GlobalFunctionMapRecord.finalize();
+  return Error::success();
+}
+
+Expected<stable_hash> mergeCodeGenData(ArrayRef<StringRef> ObjFiles) {
+  OutlinedHashTreeRecord GlobalOutlineRecord;
+  StableFunctionMapRecord GlobalStableFunctionMapRecord;
+  stable_hash CombinedHash = 0;
+  if (Error E = mergeObjectFiles(ObjFiles, GlobalOutlineRecord,
+                                 GlobalStableFunctionMapRecord, &CombinedHash))
+    return std::move(E);
 
   if (!GlobalOutlineRecord.empty())
     cgdata::publishOutlinedHashTree(std::move(GlobalOutlineRecord.HashTree));
@@ -286,6 +305,58 @@ Expected<stable_hash> mergeCodeGenData(ArrayRef<StringRef> ObjFiles) {
   return CombinedHash;
 }
 
+Error saveMergedCodeGenData(ArrayRef<StringRef> ObjFiles, StringRef Path) {
+  OutlinedHashTreeRecord GlobalOutlineRecord;
+  StableFunctionMapRecord GlobalStableFunctionMapRecord;
+  if (Error E = mergeObjectFiles(ObjFiles, GlobalOutlineRecord,
+                                 GlobalStableFunctionMapRecord,
+                                 /*CombinedHash=*/nullptr))
+    return E;
+
+  CodeGenDataWriter Writer;
+  if (!GlobalOutlineRecord.empty())
+    Writer.addRecord(GlobalOutlineRecord);
+  if (!GlobalStableFunctionMapRecord.empty())
+    Writer.addRecord(GlobalStableFunctionMapRecord);
+
+  // Write to a temporary file first so that concurrent links never read a
+  // partially written file.
+  Expected<sys::fs::TempFile> Temp =
+      sys::fs::TempFile::create(Path + ".tmp-%%%%%%%%");
+  if (!Temp)
+    return Temp.takeError();
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    if (Error E = Writer.write(OS))
+      return joinErrors(std::move(E), Temp->discard());
+  }
+  return Temp->keep(Path);
+}
+
+std::optional<stable_hash> publishSavedCodeGenData(StringRef Path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+      MemoryBuffer::getFile(Path);
+  if (!BufferOrErr)
+    return std::nullopt;
+  stable_hash Hash = xxh3_64bits((*BufferOrErr)->getBuffer());
+
+  // Like with -codegen-data-use-path, invalid data is not an error: the caller
+  // falls back to generating the codegen data again.
+  auto ReaderOrErr = CodeGenDataReader::create(std::move(*BufferOrErr));
+  if (Error E = ReaderOrErr.takeError()) {
+    warn(std::move(E), Path);
+    return std::nullopt;
+  }
+  auto &Reader = *ReaderOrErr;
+  if (!Reader->hasOutlinedHashTree() && !Reader->hasStableFunctionMap())
+    return std::nullopt;
+  if (Reader->hasOutlinedHashTree())
+    publishOutlinedHashTree(Reader->releaseOutlinedHashTree());
+  if (Reader->hasStableFunctionMap())
+    publishStableFunctionMap(Reader->releaseStableFunctionMap());
+  return Hash;
+}
+
 } // end namespace cgdata
 
 } // end namespace llvm
@@ -24,6 +24,7 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/DomTreeUpdater.h"
 #include "llvm/Analysis/InstructionSimplify.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/ProfileSummaryInfo.h"
@@ -132,6 +133,8 @@ STATISTIC(NumRetsDup, "Number of return instructions duplicated");
 STATISTIC(NumDbgValueMoved, "Number of debug value instructions moved");
 STATISTIC(NumSelectsExpanded, "Number of selects turned into branches");
 STATISTIC(NumStoreExtractExposed, "Number of store(extractelement) exposed");
+STATISTIC(NumDTRecomputations,
+          "Number of times the dominator tree was computed from scratch");
 
 static cl::opt<bool> DisableBranchOpts(
     "disable-cgp-branch-opts", cl::Hidden, cl::init(false),
@@ -410,8 +413,10 @@ private:
 
   // Get the DominatorTree, building if necessary.
   DominatorTree &getDT(Function &F) {
-    if (!DT)
+    if (!DT) {
       DT = std::make_unique<DominatorTree>(F);
+      ++NumDTRecomputations;
+    }
     return *DT;
   }
 
@@ -654,11 +659,10 @@ bool CodeGenPrepare::_run(Function &F) {
         continue;
 
       ModifyDT ModifiedDTOnIteration = ModifyDT::NotModifyDT;
+      // The CFG changes made by optimizeBlock keep the dominator tree, if it
+      // has been built, and the loop info up to date.
       bool Changed = optimizeBlock(BB, ModifiedDTOnIteration);
 
-      if (ModifiedDTOnIteration == ModifyDT::ModifyBBDT)
-        DT.reset();
-
       MadeChange |= Changed;
       if (IsHugeFunc) {
         // If the BB is updated, it may still has chance to be optimized.
@@ -696,6 +700,9 @@ bool CodeGenPrepare::_run(Function &F) {
 #ifndef NDEBUG
     if (MadeChange && VerifyLoopInfo)
       LI->verify(getDT(F));
+    if (MadeChange && VerifyDomInfo && DT)
+      assert(DT->verify(DominatorTree::VerificationLevel::Fast) &&
+             "Dominator tree not updated correctly");
 #endif
 
     // Really free removed instructions during promotion.
@@ -2492,7 +2499,7 @@ static bool OptimizeExtractBits(BinaryOperator *ShiftI, ConstantInt *CI,
 ///
 /// If the transform is performed, return true and set ModifiedDT to true.
 static bool despeculateCountZeros(IntrinsicInst *CountZeros,
-                                  LoopInfo &LI,
+                                  DomTreeUpdater *DTU, LoopInfo &LI,
                                   const TargetLowering *TLI,
                                   const DataLayout *DL, ModifyDT &ModifiedDT,
                                   SmallSet<BasicBlock *, 32> &FreshBBs,
@@ -2518,9 +2525,11 @@ static bool despeculateCountZeros(IntrinsicInst *CountZeros,
   if (isKnownNonZero(Op, *DL))
     return false;
 
-  // The intrinsic will be sunk behind a compare against zero and branch.
+  // The intrinsic will be sunk behind a compare against zero and branch. The
+  // new blocks are in the same loop as the start block.
   BasicBlock *StartBlock = CountZeros->getParent();
-  BasicBlock *CallBlock = StartBlock->splitBasicBlock(CountZeros, "cond.false");
+  BasicBlock *CallBlock =
+      SplitBlock(StartBlock, CountZeros, DTU, &LI, nullptr, "cond.false");
   if (IsHugeFunc)
     FreshBBs.insert(CallBlock);
 
@@ -2530,17 +2539,11 @@ static bool despeculateCountZeros(IntrinsicInst *CountZeros,
   BasicBlock::iterator SplitPt = std::next(BasicBlock::iterator(CountZeros));
   // Any debug-info after CountZeros should not be included.
   SplitPt.setHeadBit(true);
-  BasicBlock *EndBlock = CallBlock->splitBasicBlock(SplitPt, "cond.end");
+  BasicBlock *EndBlock =
+      SplitBlock(CallBlock, SplitPt, DTU, &LI, nullptr, "cond.end");
   if (IsHugeFunc)
     FreshBBs.insert(EndBlock);
 
-  // Update the LoopInfo. The new blocks are in the same loop as the start
-  // block.
-  if (Loop *L = LI.getLoopFor(StartBlock)) {
-    L->addBasicBlockToLoop(CallBlock, LI);
-    L->addBasicBlockToLoop(EndBlock, LI);
-  }
-
   // Set up a builder to create a compare, conditional branch, and PHI.
   IRBuilder<> Builder(CountZeros->getContext());
   Builder.SetInsertPoint(StartBlock->getTerminator());
@@ -2555,6 +2558,7 @@ static bool despeculateCountZeros(IntrinsicInst *CountZeros,
   Value *Cmp = Builder.CreateICmpEQ(Op, Zero, "cmpz");
   Builder.CreateCondBr(Cmp, EndBlock, CallBlock);
   StartBlock->getTerminator()->eraseFromParent();
+  DTU->applyUpdates({{DominatorTree::Insert, StartBlock, EndBlock}});
 
   // Create a PHI in the end block to select either the output of the intrinsic
   // or the bit width of the operand.
@@ -2715,10 +2719,12 @@ bool CodeGenPrepare::optimizeCallInst(CallInst *CI, ModifyDT &ModifiedDT) {
       return true;
     }
     case Intrinsic::cttz:
-    case Intrinsic::ctlz:
+    case Intrinsic::ctlz: {
       // If counting zeros is expensive, try to avoid it.
-      return despeculateCountZeros(II, *LI, TLI, DL, ModifiedDT, FreshBBs,
-                                   IsHugeFunc);
+      DomTreeUpdater DTU(DT.get(), DomTreeUpdater::UpdateStrategy::Eager);
+      return despeculateCountZeros(II, &DTU, *LI, TLI, DL, ModifiedDT,
+                                   FreshBBs, IsHugeFunc);
+    }
     case Intrinsic::fshl:
     case Intrinsic::fshr:
       return optimizeFunnelShift(II);
@@ -3011,6 +3017,7 @@ bool CodeGenPrepare::dupRetToEnableTailCallOpts(BasicBlock *BB,
   }
 
   bool Changed = false;
+  DomTreeUpdater DTU(DT.get(), DomTreeUpdater::UpdateStrategy::Eager);
   for (auto const &TailCallBB : TailCallBBs) {
     // Make sure the call instruction is followed by an unconditional branch to
     // the return block.
@@ -3019,7 +3026,7 @@ bool CodeGenPrepare::dupRetToEnableTailCallOpts(BasicBlock *BB,
       continue;
 
     // Duplicate the return into TailCallBB.
-    (void)FoldReturnIntoUncondBranch(RetI, BB, TailCallBB);
+    (void)FoldReturnIntoUncondBranch(RetI, BB, TailCallBB, &DTU);
     assert(!VerifyBFIUpdates ||
            BFI->getBlockFreq(BB) >= BFI->getBlockFreq(TailCallBB));
     BFI->setBlockFreq(BB,
@@ -8804,13 +8811,9 @@ bool CodeGenPrepare::optimizeBlock(BasicBlock &BB, ModifyDT &ModifiedDT) {
         // For huge function we tend to quickly go though the inner optmization
         // opportunities in the BB. So we go back to the BB head to re-optimize
         // each instruction instead of go back to the function head.
-        if (IsHugeFunc) {
-          DT.reset();
-          getDT(*BB.getParent());
+        if (IsHugeFunc)
           break;
-        } else {
-          return true;
-        }
+        return true;
       }
     }
   } while (ModifiedDT == ModifyDT::ModifyInstDT);
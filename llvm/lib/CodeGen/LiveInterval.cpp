@@ -413,18 +413,20 @@ bool LiveRange::overlapsFrom(const LiveRange& other,
 
   if (j == je) return false;
 
-  while (i != ie) {
+  while (true) {
     if (i->start > j->start) {
       std::swap(i, j);
       std::swap(ie, je);
     }
 
-    if (i->end > j->start)
+    // i starts at or before j, so they overlap unless i ends before j starts.
+    // Skip all such segments at once; they cannot overlap anything in other.
+    i = gallopTo(i, ie, j->start);
+    if (i == ie)
+      return false;
+    if (i->start <= j->start)
       return true;
-    ++i;
   }
-
-  return false;
 }
 
 bool LiveRange::overlaps(const LiveRange &Other, const CoalescerPair &CP,
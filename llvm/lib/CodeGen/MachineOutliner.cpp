@@ -75,6 +75,7 @@
 #include "llvm/InitializePasses.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SuffixTree.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
@@ -128,6 +129,12 @@ static cl::opt<unsigned> OutlinerBenefitThreshold(
     cl::desc(
         "The minimum size in bytes before an outlining candidate is accepted"));
 
+static cl::opt<bool> OutlinerParallelCostModel(
+    "machine-outliner-parallel-cost-model", cl::init(false), cl::Hidden,
+    cl::desc("Query the target for the cost of the candidates of all repeated "
+             "sequences in parallel. The target's getOutliningCandidateInfo "
+             "must be thread-safe"));
+
 static cl::opt<bool> OutlinerLeafDescendants(
     "outliner-leaf-descendants", cl::init(true), cl::Hidden,
     cl::desc("Consider all leaf descendants of internal nodes of the suffix "
@@ -748,13 +755,14 @@ void MachineOutliner::findCandidates(
   SuffixTree ST(Mapper.UnsignedVec, OutlinerLeafDescendants);
 
   // First, find all of the repeated substrings in the tree of minimum length
-  // 2.
-  std::vector<Candidate> CandidatesForRepeatedSeq;
+  // 2, and collect their non-overlapping occurrences.
+  unsigned MinRepeats = 2;
+  std::vector<std::vector<Candidate>> CandidateSets;
   LLVM_DEBUG(dbgs() << "*** Discarding overlapping candidates *** \n");
   LLVM_DEBUG(
       dbgs() << "Searching for overlaps in all repeated sequences...\n");
   for (SuffixTree::RepeatedSubstring &RS : ST) {
-    CandidatesForRepeatedSeq.clear();
+    std::vector<Candidate> CandidatesForRepeatedSeq;
     unsigned StringLen = RS.Length;
     LLVM_DEBUG(dbgs() << "  Sequence length: " << StringLen << "\n");
     // Debug code to keep track of how many candidates we removed.
@@ -810,7 +818,7 @@ void MachineOutliner::findCandidates(
       MachineBasicBlock::iterator EndIt = Mapper.InstrList[EndIdx];
       MachineBasicBlock *MBB = StartIt->getParent();
       CandidatesForRepeatedSeq.emplace_back(StartIdx, StringLen, StartIt, EndIt,
-                                            MBB, FunctionList.size(),
+                                            MBB, /*FunctionIdx=*/0,
                                             Mapper.MBBFlagsMap[MBB]);
     }
 #ifndef NDEBUG
@@ -818,22 +826,32 @@ void MachineOutliner::findCandidates(
                       << "\n");
     LLVM_DEBUG(dbgs() << "    Candidates kept: " << NumKept << "\n\n");
 #endif
-    unsigned MinRepeats = 2;
 
     // We've found something we might want to outline.
-    // Create an OutlinedFunction to store it and check if it'd be beneficial
-    // to outline.
-    if (CandidatesForRepeatedSeq.size() < MinRepeats)
-      continue;
+    if (CandidatesForRepeatedSeq.size() >= MinRepeats)
+      CandidateSets.push_back(std::move(CandidatesForRepeatedSeq));
+  }
 
+  // Create an OutlinedFunction for each set of candidates to check if it'd be
+  // beneficial to outline. The queries are independent of each other, so they
+  // can run in parallel if the target allows it.
+  std::vector<std::optional<std::unique_ptr<OutlinedFunction>>> OFs(
+      CandidateSets.size());
+  auto GetCandidateInfo = [&](size_t I) {
     // Arbitrarily choose a TII from the first candidate.
     // FIXME: Should getOutliningCandidateInfo move to TargetMachine?
     const TargetInstrInfo *TII =
-        CandidatesForRepeatedSeq[0].getMF()->getSubtarget().getInstrInfo();
+        CandidateSets[I][0].getMF()->getSubtarget().getInstrInfo();
+    OFs[I] = TII->getOutliningCandidateInfo(*MMI, CandidateSets[I], MinRepeats);
+  };
+  if (OutlinerParallelCostModel)
+    parallelFor(0, CandidateSets.size(), GetCandidateInfo);
+  else
+    for (size_t I = 0, E = CandidateSets.size(); I != E; ++I)
+      GetCandidateInfo(I);
 
-    std::optional<std::unique_ptr<OutlinedFunction>> OF =
-        TII->getOutliningCandidateInfo(*MMI, CandidatesForRepeatedSeq,
-                                       MinRepeats);
+  for (size_t I = 0, E = CandidateSets.size(); I != E; ++I) {
+    std::optional<std::unique_ptr<OutlinedFunction>> &OF = OFs[I];
 
     // If we deleted too many candidates, then there's nothing worth outlining.
     // FIXME: This should take target-specified instruction sizes into account.
@@ -842,11 +860,13 @@ void MachineOutliner::findCandidates(
 
     // Is it better to outline this candidate than not?
     if (OF.value()->getBenefit() < OutlinerBenefitThreshold) {
-      emitNotOutliningCheaperRemark(StringLen, CandidatesForRepeatedSeq,
-                                    *OF.value());
+      emitNotOutliningCheaperRemark(CandidateSets[I].front().getLength(),
+                                    CandidateSets[I], *OF.value());
       continue;
     }
 
+    for (Candidate &C : OF.value()->Candidates)
+      C.FunctionIdx = FunctionList.size();
     FunctionList.emplace_back(std::move(OF.value()));
   }
 }
@@ -189,6 +189,12 @@ static cl::opt<bool> MISchedSortResourcesInTrace(
     cl::desc("Sort the resources printed in the dump trace"));
 #endif
 
+static cl::opt<unsigned> MISchedMaxRegionSize(
+    "misched-max-region-size", cl::Hidden, cl::init(0),
+    cl::desc("Split scheduling regions into windows of at most this many "
+             "instructions, so that DAG construction stays linear in the size "
+             "of huge blocks (0 = no limit)"));
+
 static cl::opt<unsigned>
     MIResourceCutOff("misched-resource-cutoff", cl::Hidden,
                      cl::desc("Number of intervals to track"), cl::init(10));
@@ -564,6 +570,11 @@ getSchedRegions(MachineBasicBlock *MBB,
       if (isSchedBoundary(&MI, &*MBB, MF, TII))
         break;
       if (!MI.isDebugOrPseudoInstr()) {
+        // End the window once it is full. MI then separates this window from
+        // the next one like a scheduling boundary: it is not part of either,
+        // so it cannot be moved while the window below it is scheduled.
+        if (MISchedMaxRegionSize && NumRegionInstrs == MISchedMaxRegionSize)
+          break;
         // MBB::size() uses instr_iterator to count. Here we need a bundle to
         // count as a single instruction.
         ++NumRegionInstrs;
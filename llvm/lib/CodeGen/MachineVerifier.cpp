@@ -76,6 +76,7 @@
 #include "llvm/MC/MCTargetOptions.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
@@ -93,6 +94,83 @@
 
 using namespace llvm;
 
+static cl::opt<bool> VerifyIncrementally(
+    "verify-machineinstrs-incremental", cl::Hidden,
+    cl::desc("Skip machine verification of functions that have not changed "
+             "since they were last verified"));
+
+static cl::opt<unsigned> VerifyFullInterval(
+    "verify-machineinstrs-full-interval", cl::Hidden, cl::init(8),
+    cl::desc("With -verify-machineinstrs-incremental, verify a function even "
+             "if it has not changed after this many skipped runs (0 = never)"));
+
+namespace {
+
+/// Remembers, for every function, a fingerprint of its machine code at the
+/// time it was last verified. The verifier runs after every pass, and most
+/// passes leave most functions untouched, so comparing fingerprints is much
+/// cheaper than verifying again. Changes that are only visible in analyses,
+/// such as LiveIntervals, are not part of the fingerprint; these are still
+/// caught by the full verification every VerifyFullInterval runs.
+class IncrementalVerifierState {
+  struct Entry {
+    uint64_t Fingerprint = 0;
+    unsigned SkippedRuns = 0;
+  };
+  sys::SmartMutex<true> Lock;
+  DenseMap<const MachineFunction *, Entry> Functions;
+
+  static uint64_t fingerprint(const MachineFunction &MF) {
+    hash_code H = hash_combine(MF.getName(), MF.getNumBlockIDs());
+    for (const MachineBasicBlock &MBB : MF) {
+      H = hash_combine(H, MBB.getNumber());
+      for (const MachineBasicBlock *Succ : MBB.successors())
+        H = hash_combine(H, Succ->getNumber());
+      for (const auto &LI : MBB.liveins_dbg())
+        H = hash_combine(H, LI.PhysReg, LI.LaneMask.getAsInteger());
+      for (const MachineInstr &MI : MBB.instrs()) {
+        H = hash_combine(H, MI.getOpcode(), MI.getFlags());
+        for (const MachineOperand &MO : MI.operands())
+          H = hash_combine(H, MO);
+      }
+    }
+    return H;
+  }
+
+public:
+  /// Return true if \p MF needs to be verified, and record its current state
+  /// as verified if so.
+  bool needsVerification(const MachineFunction &MF) {
+    uint64_t Fingerprint = fingerprint(MF);
+    sys::SmartScopedLock<true> Guard(Lock);
+    auto [It, Inserted] = Functions.try_emplace(&MF);
+    Entry &E = It->second;
+    if (!Inserted && E.Fingerprint == Fingerprint &&
+        (!VerifyFullInterval || E.SkippedRuns + 1 < VerifyFullInterval)) {
+      ++E.SkippedRuns;
+      return false;
+    }
+    E.Fingerprint = Fingerprint;
+    E.SkippedRuns = 0;
+    return true;
+  }
+};
+
+} // end anonymous namespace
+
+static ManagedStatic<IncrementalVerifierState> IncrementalState;
+
+/// Return true if the verifier passes should skip \p MF.
+static bool skipVerification(const MachineFunction &MF) {
+  // Skip functions that have known verification problems.
+  // FIXME: Remove this mechanism when all problematic passes have been
+  // fixed.
+  if (MF.getProperties().hasProperty(
+          MachineFunctionProperties::Property::FailsVerification))
+    return true;
+  return VerifyIncrementally && !IncrementalState->needsVerification(MF);
+}
+
 namespace {
 
 /// Used the by the ReportedErrors class to guarantee only one error is reported
@@ -378,11 +456,7 @@ struct MachineVerifierLegacyPass : public MachineFunctionPass {
   }
 
   bool runOnMachineFunction(MachineFunction &MF) override {
-    // Skip functions that have known verification problems.
-    // FIXME: Remove this mechanism when all problematic passes have been
-    // fixed.
-    if (MF.getProperties().hasProperty(
-            MachineFunctionProperties::Property::FailsVerification))
+    if (skipVerification(MF))
       return false;
 
     MachineVerifier(this, Banner.c_str(), &errs()).verify(MF);
@@ -395,11 +469,7 @@ struct MachineVerifierLegacyPass : public MachineFunctionPass {
 PreservedAnalyses
 MachineVerifierPass::run(MachineFunction &MF,
                          MachineFunctionAnalysisManager &MFAM) {
-  // Skip functions that have known verification problems.
-  // FIXME: Remove this mechanism when all problematic passes have been
-  // fixed.
-  if (MF.getProperties().hasProperty(
-          MachineFunctionProperties::Property::FailsVerification))
+  if (skipVerification(MF))
     return PreservedAnalyses::all();
   MachineVerifier(MFAM, Banner.c_str(), &errs()).verify(MF);
   return PreservedAnalyses::all();
@@ -78,6 +78,7 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumOverBudget,   "Number of functions that exceeded the budget");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -124,6 +125,14 @@ static cl::opt<unsigned long> GrowRegionComplexityBudget(
              "limit its budget and bail out once we reach the limit."),
     cl::init(10000), cl::Hidden);
 
+static cl::opt<uint64_t> GreedyRegAllocBudget(
+    "greedy-regalloc-budget",
+    cl::desc("Maximum number of live range allocation attempts per function. "
+             "Once it is reached, live ranges that do not fit in a free "
+             "register are spilled without eviction or splitting (0 = no "
+             "limit)"),
+    cl::init(0), cl::Hidden);
+
 static cl::opt<bool> GreedyRegClassPriorityTrumpsGlobalness(
     "greedy-regclass-priority-trumps-globalness",
     cl::desc("Change the greedy register allocator's live range priority "
@@ -2408,6 +2417,10 @@ MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
                                        RecoloringStack &RecolorStack,
                                        unsigned Depth) {
   uint8_t CostPerUseLimit = uint8_t(~0u);
+  // Last chance recoloring undoes the assignments it made when it fails, so
+  // only top-level attempts are subject to the budget.
+  bool OverBudget = !Depth && GreedyRegAllocBudget &&
+                    ++NumAllocAttempts > GreedyRegAllocBudget;
   // First try assigning a free register.
   auto Order =
       AllocationOrder::create(VirtReg.reg(), *VRM, RegClassInfo, Matrix);
@@ -2437,8 +2450,10 @@ MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
 
   // Try to evict a less worthy live range, but only for ranges from the primary
   // queue. The RS_Split ranges already failed to do this, and they should not
-  // get a second chance until they have been split.
-  if (Stage != RS_Split)
+  // get a second chance until they have been split. Once the budget is
+  // exhausted, go straight to spilling: eviction and splitting are what makes
+  // allocation expensive on pathological functions.
+  if (Stage != RS_Split && !OverBudget)
     if (Register PhysReg =
             tryEvict(VirtReg, Order, NewVRegs, CostPerUseLimit,
                      FixedRegisters)) {
@@ -2458,14 +2473,14 @@ MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
   // The first time we see a live range, don't try to split or spill.
   // Wait until the second time, when all smaller ranges have been allocated.
   // This gives a better picture of the interference to split around.
-  if (Stage < RS_Split) {
+  if (Stage < RS_Split && !OverBudget) {
     ExtraInfo->setStage(VirtReg, RS_Split);
     LLVM_DEBUG(dbgs() << "wait for second round\n");
     NewVRegs.push_back(VirtReg.reg());
     return 0;
   }
 
-  if (Stage < RS_Spill && !VirtReg.empty()) {
+  if (Stage < RS_Spill && !VirtReg.empty() && !OverBudget) {
     // Try splitting VirtReg or interferences.
     unsigned NewVRegSizeBefore = NewVRegs.size();
     Register PhysReg = trySplit(VirtReg, Order, NewVRegs, FixedRegisters);
@@ -2481,6 +2496,8 @@ MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
   }
 
   // Finally spill VirtReg itself.
+  if (OverBudget)
+    ++NumOverBudgetSpills;
   if ((EnableDeferredSpilling ||
        TRI->shouldUseDeferredSpillingForVirtReg(*MF, VirtReg)) &&
       ExtraInfo->getStage(VirtReg) < RS_Memory) {
@@ -2688,6 +2705,23 @@ void RAGreedy::reportStats() {
   }
 }
 
+void RAGreedy::reportBudgetExceeded() {
+  ++NumOverBudget;
+  using namespace ore;
+  ORE->emit([&]() {
+    DebugLoc Loc;
+    if (auto *SP = MF->getFunction().getSubprogram())
+      Loc = DILocation::get(SP->getContext(), SP->getLine(), 1, SP);
+    MachineOptimizationRemarkMissed R(DEBUG_TYPE, "BudgetExceeded", Loc,
+                                      &MF->front());
+    R << "register allocation budget of "
+      << NV("Budget", uint64_t(GreedyRegAllocBudget))
+      << " attempts exceeded; " << NV("NumSpills", NumOverBudgetSpills)
+      << " live ranges spilled without eviction or splitting in function";
+    return R;
+  });
+}
+
 bool RAGreedy::hasVirtRegAlloc() {
   for (unsigned I = 0, E = MRI->getNumVirtRegs(); I != E; ++I) {
     Register Reg = Register::index2VirtReg(I);
@@ -2765,8 +2799,12 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   IntfCache.init(MF, Matrix->getLiveUnions(), Indexes, LIS, TRI);
   GlobalCand.resize(32);  // This will grow as needed.
   SetOfBrokenHints.clear();
+  NumAllocAttempts = 0;
+  NumOverBudgetSpills = 0;
 
   allocatePhysRegs();
+  if (GreedyRegAllocBudget && NumAllocAttempts > GreedyRegAllocBudget)
+    reportBudgetExceeded();
   tryHintsRecoloring();
 
   if (VerifyEnabled)
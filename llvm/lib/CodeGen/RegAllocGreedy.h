@@ -281,6 +281,14 @@ private:
 
   bool ReverseLocalAssignment = false;
 
+  /// Number of live range allocation attempts in the current function, counted
+  /// against -greedy-regalloc-budget.
+  uint64_t NumAllocAttempts = 0;
+
+  /// Number of live ranges spilled without trying eviction or splitting
+  /// because the budget was exhausted.
+  unsigned NumOverBudgetSpills = 0;
+
 public:
   RAGreedy(const RegAllocFilterFunc F = nullptr);
 
@@ -451,6 +459,9 @@ private:
 
   /// Report the statistic for each loop.
   void reportStats();
+
+  /// Report that the allocation budget of the function was exhausted.
+  void reportBudgetExceeded();
 };
 } // namespace llvm
 #endif // #ifndef LLVM_CODEGEN_REGALLOCGREEDY_H_
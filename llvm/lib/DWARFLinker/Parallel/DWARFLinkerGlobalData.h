@@ -54,6 +54,10 @@ struct DWARFLinkerOptions {
   /// Number of threads.
   unsigned Threads = 1;
 
+  /// Keep contents of linked compile units in a temporary file until they
+  /// are written to the output.
+  bool MemoryBounded = false;
+
   /// The accelerator table kinds
   SmallVector<DWARFLinkerBase::AccelTableKind, 1> AccelTables;
 
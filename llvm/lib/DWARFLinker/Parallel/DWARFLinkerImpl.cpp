@@ -180,6 +180,16 @@ Error DWARFLinkerImpl::link() {
     llvm::parallel::strategy =
         hardware_concurrency(GlobalData.getOptions().Threads);
 
+  // In memory-bounded mode the contents of each linked object file are moved
+  // out of memory until they are written to the output.
+  if (GlobalData.getOptions().MemoryBounded && GlobalData.getTargetTriple()) {
+    if (Expected<std::unique_ptr<SectionsSpillFile>> File =
+            SectionsSpillFile::create())
+      SpillFile = std::move(*File);
+    else
+      GlobalData.warn(File.takeError(), "memory-bounded linking");
+  }
+
   // Link object files.
   if (GlobalData.getOptions().Threads == 1) {
     for (std::unique_ptr<LinkContext> &Context : ObjectContexts) {
@@ -188,6 +198,7 @@ Error DWARFLinkerImpl::link() {
         GlobalData.error(std::move(Err), Context->InputDWARFFile.FileName);
 
       Context->InputDWARFFile.unload();
+      spillLinkedSections(*Context);
     }
   } else {
     DefaultThreadPool Pool(llvm::parallel::strategy);
@@ -198,6 +209,7 @@ Error DWARFLinkerImpl::link() {
           GlobalData.error(std::move(Err), Context->InputDWARFFile.FileName);
 
         Context->InputDWARFFile.unload();
+        spillLinkedSections(*Context);
       });
 
     Pool.wait();
@@ -212,6 +224,12 @@ Error DWARFLinkerImpl::link() {
       if (Error Err = ArtificialTypeUnit->finishCloningAndEmit(
               (*GlobalData.getTargetTriple()).get()))
         return Err;
+
+    // The type DIEs are still needed to patch references to them, only the
+    // emitted contents of the type unit are spilled.
+    if (SpillFile)
+      if (Error Err = ArtificialTypeUnit->spillSections(*SpillFile))
+        GlobalData.warn(std::move(Err), "memory-bounded linking");
   }
 
   // At this stage each compile units are cloned to their own set of debug
@@ -873,6 +891,7 @@ void DWARFLinkerImpl::glueCompileUnitsAndWriteToTheOutput() {
 
   // Cleanup data.
   cleanupDataAfterDWARFOutputIsWritten();
+  SpillFile.reset();
 
   if (GlobalData.getOptions().Statistics)
     printStatistic();
@@ -889,7 +908,7 @@ void DWARFLinkerImpl::printStatistic() {
     for (std::unique_ptr<CompileUnit> &CU : Context->CompileUnits)
       if (std::optional<SectionDescriptor *> DebugInfo =
               CU->tryGetSectionDescriptor(DebugSectionKind::DebugInfo))
-        AllDebugInfoSectionsSize += (*DebugInfo)->getContents().size();
+        AllDebugInfoSectionsSize += (*DebugInfo)->getContentsSize();
 
     SizeByObject[Context->InputDWARFFile.FileName].Input =
         Context->OriginalDebugInfoSize;
@@ -1104,6 +1123,11 @@ void DWARFLinkerImpl::forEachCompileUnit(
 }
 
 void DWARFLinkerImpl::patchOffsetsAndSizes() {
+  // In memory-bounded mode the patches are applied when the sections are
+  // read back from the spill file.
+  if (SpillFile)
+    return;
+
   forEachObjectSectionsSet([&](OutputSections &SectionsSet) {
     SectionsSet.forEach([&](SectionDescriptor &OutSection) {
       SectionsSet.applyPatches(OutSection, DebugStrStrings, DebugLineStrStrings,
@@ -1403,12 +1427,45 @@ void DWARFLinkerImpl::cleanupDataAfterDWARFOutputIsWritten() {
   DebugLineStrStrings.clear();
 }
 
+void DWARFLinkerImpl::spillLinkedSections(LinkContext &Context) {
+  if (!SpillFile)
+    return;
+
+  // Sections which failed to spill are kept in memory.
+  auto Spill = [&](OutputSections &Sections) {
+    if (Error Err = Sections.spillSections(*SpillFile))
+      GlobalData.warn(std::move(Err), Context.InputDWARFFile.FileName);
+  };
+
+  Spill(Context);
+  for (LinkContext::RefModuleUnit &ModuleUnit : Context.ModulesCompileUnits)
+    if (ModuleUnit.Unit->getStage() != CompileUnit::Stage::Skipped)
+      Spill(*ModuleUnit.Unit);
+  for (std::unique_ptr<CompileUnit> &CU : Context.CompileUnits)
+    if (CU->getStage() != CompileUnit::Stage::Skipped)
+      Spill(*CU);
+}
+
 void DWARFLinkerImpl::writeCompileUnitsToTheOutput() {
   // Enumerate all sections and store them into the final emitter.
   forEachObjectSectionsSet([&](OutputSections &Sections) {
     Sections.forEach([&](std::shared_ptr<SectionDescriptor> OutSection) {
+      if (SpillFile) {
+        // Read the section back and patch it, so that only one section is
+        // kept in memory at a time.
+        if (Error Err = OutSection->restoreContents(*SpillFile)) {
+          GlobalData.error(std::move(Err), "memory-bounded linking");
+          return;
+        }
+        Sections.applyPatches(*OutSection, DebugStrStrings,
+                              DebugLineStrStrings, ArtificialTypeUnit.get());
+      }
+
       // Emit section content.
       SectionHandler(OutSection);
+
+      if (SpillFile)
+        OutSection->releaseContents();
     });
   });
 }
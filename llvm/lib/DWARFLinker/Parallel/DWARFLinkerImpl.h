@@ -95,6 +95,12 @@ public:
     GlobalData.Options.Threads = NumThreads;
   }
 
+  /// Keep contents of linked object files in a temporary file until they are
+  /// written to the output.
+  void setMemoryBounded(bool MemoryBounded) override {
+    GlobalData.Options.MemoryBounded = MemoryBounded;
+  }
+
   /// Add kind of accelerator tables to be generated.
   void addAccelTableKind(AccelTableKind Kind) override {
     assert(!llvm::is_contained(GlobalData.getOptions().AccelTables, Kind));
@@ -326,6 +332,10 @@ protected:
   /// Cleanup data(string pools) after output sections are generated.
   void cleanupDataAfterDWARFOutputIsWritten();
 
+  /// Move contents of the sections of the linked object file into the spill
+  /// file.
+  void spillLinkedSections(LinkContext &Context);
+
   /// Enumerate all compile units and put their data into the output stream.
   void writeCompileUnitsToTheOutput();
 
@@ -345,6 +355,10 @@ protected:
 
   /// Type unit.
   std::unique_ptr<TypeUnit> ArtificialTypeUnit;
+
+  /// Temporary file keeping contents of linked object files in memory-bounded
+  /// mode.
+  std::unique_ptr<SectionsSpillFile> SpillFile;
   /// @}
 
   /// \defgroup Data members accessed sequentially.
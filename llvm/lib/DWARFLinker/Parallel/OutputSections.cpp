@@ -10,6 +10,7 @@
 #include "DWARFLinkerCompileUnit.h"
 #include "DWARFLinkerTypeUnit.h"
 #include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/Path.h"
 
 using namespace llvm;
 using namespace dwarf_linker;
@@ -75,6 +76,96 @@ void SectionDescriptor::clearAllSectionData() {
 
 void SectionDescriptor::clearSectionContent() { Contents = OutSectionDataTy(); }
 
+Error SectionDescriptor::spillContents(SectionsSpillFile &File) {
+  if (SpillOffset)
+    return Error::success();
+
+  StringRef Data = getContents();
+  Expected<uint64_t> Offset = File.write(Data);
+  if (!Offset)
+    return Offset.takeError();
+
+  SpillOffset = *Offset;
+  ReleasedContentsSize = Data.size();
+  clearSectionContent();
+  // Only the section data itself is spilled, the rest of the AsmPrinter
+  // output is not needed anymore.
+  SectionOffsetInsideAsmPrinterOutputStart = 0;
+  SectionOffsetInsideAsmPrinterOutputEnd = 0;
+  return Error::success();
+}
+
+Error SectionDescriptor::restoreContents(SectionsSpillFile &File) {
+  if (!SpillOffset)
+    return Error::success();
+
+  Contents.resize_for_overwrite(*ReleasedContentsSize);
+  if (Error Err = File.read(*SpillOffset, Contents))
+    return Err;
+
+  SpillOffset.reset();
+  ReleasedContentsSize.reset();
+  return Error::success();
+}
+
+void SectionDescriptor::releaseContents() {
+  ReleasedContentsSize = getContents().size();
+  clearSectionContent();
+  SectionOffsetInsideAsmPrinterOutputStart = 0;
+  SectionOffsetInsideAsmPrinterOutputEnd = 0;
+}
+
+Expected<std::unique_ptr<SectionsSpillFile>> SectionsSpillFile::create() {
+  SmallString<128> Model;
+  sys::path::system_temp_directory(/*ErasedOnReboot=*/true, Model);
+  sys::path::append(Model, "dwarflinker-%%%%%%.spill");
+  Expected<sys::fs::TempFile> File = sys::fs::TempFile::create(Model);
+  if (!File)
+    return File.takeError();
+  return std::unique_ptr<SectionsSpillFile>(
+      new SectionsSpillFile(std::move(*File)));
+}
+
+SectionsSpillFile::SectionsSpillFile(sys::fs::TempFile File)
+    : File(std::move(File)), OS(this->File.FD, /*shouldClose=*/false) {}
+
+SectionsSpillFile::~SectionsSpillFile() {
+  OS.flush();
+  OS.clear_error();
+  consumeError(File.discard());
+}
+
+Expected<uint64_t> SectionsSpillFile::write(StringRef Data) {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  uint64_t Offset = OS.tell();
+  OS << Data;
+  if (OS.has_error())
+    return createFileError(File.TmpName, OS.error());
+  return Offset;
+}
+
+Error SectionsSpillFile::read(uint64_t Offset, MutableArrayRef<char> Buffer) {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  OS.flush();
+  if (OS.has_error())
+    return createFileError(File.TmpName, OS.error());
+
+  sys::fs::file_t FD = sys::fs::convertFDToNativeFile(File.FD);
+  while (!Buffer.empty()) {
+    Expected<size_t> NumRead =
+        sys::fs::readNativeFileSlice(FD, Buffer, Offset);
+    if (!NumRead)
+      return createFileError(File.TmpName, NumRead.takeError());
+    if (*NumRead == 0)
+      return createFileError(
+          File.TmpName,
+          createStringError(std::errc::io_error, "unexpected end of file"));
+    Buffer = Buffer.drop_front(*NumRead);
+    Offset += *NumRead;
+  }
+  return Error::success();
+}
+
 void SectionDescriptor::setSizesForSectionCreatedByAsmPrinter() {
   if (Contents.empty())
     return;
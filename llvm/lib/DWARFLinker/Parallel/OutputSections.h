@@ -21,12 +21,14 @@
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MemoryBufferRef.h"
 #include "llvm/Support/raw_ostream.h"
 #include <array>
 #include <cstdint>
+#include <mutex>
 
 namespace llvm {
 namespace dwarf_linker {
@@ -147,6 +149,31 @@ using OffsetsPtrVector = SmallVector<uint64_t *>;
 
 class OutputSections;
 
+/// This class keeps the contents of linked output sections in a temporary
+/// file until they are written to the output, so that the contents of all
+/// compile units do not need to be kept in memory for the whole link.
+class SectionsSpillFile {
+public:
+  /// Creates a spill file in the system temporary directory.
+  static Expected<std::unique_ptr<SectionsSpillFile>> create();
+
+  ~SectionsSpillFile();
+
+  /// Appends \p Data to the file and returns its offset inside the file.
+  /// It is safe to call this method from several threads.
+  Expected<uint64_t> write(StringRef Data);
+
+  /// Reads Buffer.size() bytes located at \p Offset into \p Buffer.
+  Error read(uint64_t Offset, MutableArrayRef<char> Buffer);
+
+private:
+  SectionsSpillFile(sys::fs::TempFile File);
+
+  std::mutex Mutex;
+  sys::fs::TempFile File;
+  raw_fd_ostream OS;
+};
+
 /// This structure is used to keep data of the concrete section.
 /// Like data bits, list of patches, format.
 struct SectionDescriptor : SectionDescriptorBase {
@@ -175,6 +202,23 @@ struct SectionDescriptor : SectionDescriptorBase {
   /// Erase only section output data bits.
   void clearSectionContent();
 
+  /// Move section output data bits into the \p File and release memory
+  /// used by them. The patches are kept in memory.
+  Error spillContents(SectionsSpillFile &File);
+
+  /// Read back section output data bits moved by spillContents().
+  Error restoreContents(SectionsSpillFile &File);
+
+  /// Release section output data bits after they were written into the
+  /// output. Unlike clearSectionContent() the size of the data is kept.
+  void releaseContents();
+
+  /// Returns size of the section content, including the content which was
+  /// spilled or released.
+  uint64_t getContentsSize() {
+    return ReleasedContentsSize ? *ReleasedContentsSize : getContents().size();
+  }
+
   /// When objects(f.e. compile units) are glued into the single file,
   /// the debug sections corresponding to the concrete object are assigned
   /// with offsets inside the whole file. This field keeps offset
@@ -295,6 +339,12 @@ protected:
   /// real section content inside elf file.
   size_t SectionOffsetInsideAsmPrinterOutputStart = 0;
   size_t SectionOffsetInsideAsmPrinterOutputEnd = 0;
+
+  /// Offset of the spilled section content inside the spill file.
+  std::optional<uint64_t> SpillOffset;
+
+  /// Size of the section content which was spilled or released.
+  std::optional<uint64_t> ReleasedContentsSize;
 };
 
 /// This class keeps contents and offsets to the debug sections. Any objects
@@ -380,6 +430,14 @@ public:
     return *It->second;
   }
 
+  /// Move contents of all sections into the \p File.
+  Error spillSections(SectionsSpillFile &File) {
+    for (auto &Section : SectionDescriptors)
+      if (Error Err = Section.second->spillContents(File))
+        return Err;
+    return Error::success();
+  }
+
   /// Erases data of all sections.
   void eraseSections() {
     for (auto &Section : SectionDescriptors)
@@ -411,7 +469,7 @@ public:
           SectionSizesAccumulator[static_cast<uint8_t>(
               Section.second->getKind())];
       SectionSizesAccumulator[static_cast<uint8_t>(
-          Section.second->getKind())] += Section.second->getContents().size();
+          Section.second->getKind())] += Section.second->getContentsSize();
     }
   }
 
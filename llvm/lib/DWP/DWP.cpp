@@ -11,6 +11,8 @@
 //
 //===----------------------------------------------------------------------===//
 #include "llvm/DWP/DWP.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/DWP/DWPError.h"
 #include "llvm/MC/MCContext.h"
@@ -20,7 +22,9 @@
 #include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include <limits>
+#include <optional>
 
 using namespace llvm;
 using namespace llvm::object;
@@ -354,6 +358,50 @@ handleCompressedSection(std::deque<SmallString<32>> &UncompressedSections,
   return Error::success();
 }
 
+namespace {
+/// An input file whose sections are read and decompressed, ready to be merged
+/// into the output.
+struct DWPInput {
+  OwningBinary<ObjectFile> Binary;
+  std::deque<SmallString<32>> UncompressedSections;
+  /// The contents of every section of Binary, in order. They are empty for
+  /// the BSS and virtual sections.
+  std::vector<StringRef> SectionContents;
+};
+} // namespace
+
+static Expected<std::unique_ptr<DWPInput>> loadInput(StringRef Input) {
+  auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
+  if (!ErrOrObj) {
+    return handleErrors(ErrOrObj.takeError(),
+                        [&](std::unique_ptr<ECError> EC) -> Error {
+                          return createFileError(Input, Error(std::move(EC)));
+                        });
+  }
+
+  auto Result = std::make_unique<DWPInput>();
+  Result->Binary = std::move(*ErrOrObj);
+  for (const SectionRef &Section : Result->Binary.getBinary()->sections()) {
+    StringRef &Contents = Result->SectionContents.emplace_back();
+    if (Section.isBSS() || Section.isVirtual())
+      continue;
+
+    Expected<StringRef> NameOrErr = Section.getName();
+    if (!NameOrErr)
+      return NameOrErr.takeError();
+
+    Expected<StringRef> ContentsOrErr = Section.getContents();
+    if (!ContentsOrErr)
+      return ContentsOrErr.takeError();
+    Contents = *ContentsOrErr;
+
+    if (auto Err = handleCompressedSection(Result->UncompressedSections,
+                                           Section, *NameOrErr, Contents))
+      return std::move(Err);
+  }
+  return std::move(Result);
+}
+
 namespace llvm {
 // Parse and return the header of an info section compile/type unit.
 Expected<InfoSectionUnitHeader> parseInfoSectionUnitHeader(StringRef Info) {
@@ -558,8 +606,7 @@ Error handleSection(
     const MCSection *StrSection, const MCSection *StrOffsetSection,
     const MCSection *TypesSection, const MCSection *CUIndexSection,
     const MCSection *TUIndexSection, const MCSection *InfoSection,
-    const SectionRef &Section, MCStreamer &Out,
-    std::deque<SmallString<32>> &UncompressedSections,
+    const SectionRef &Section, StringRef Contents, MCStreamer &Out,
     uint32_t (&ContributionOffsets)[8], UnitIndexEntry &CurEntry,
     StringRef &CurStrSection, StringRef &CurStrOffsetSection,
     std::vector<StringRef> &CurTypesSection,
@@ -577,15 +624,6 @@ Error handleSection(
     return NameOrErr.takeError();
   StringRef Name = *NameOrErr;
 
-  Expected<StringRef> ContentsOrErr = Section.getContents();
-  if (!ContentsOrErr)
-    return ContentsOrErr.takeError();
-  StringRef Contents = *ContentsOrErr;
-
-  if (auto Err = handleCompressedSection(UncompressedSections, Section, Name,
-                                         Contents))
-    return Err;
-
   Name = Name.substr(Name.find_first_not_of("._"));
 
   auto SectionPair = KnownSections.find(Name);
@@ -623,7 +661,7 @@ Error handleSection(
 }
 
 Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
-            OnCuIndexOverflow OverflowOptValue) {
+            OnCuIndexOverflow OverflowOptValue, unsigned NumThreads) {
   const auto &MCOFI = *Out.getContext().getObjectFileInfo();
   MCSection *const StrSection = MCOFI.getDwarfStrDWOSection();
   MCSection *const StrOffsetSection = MCOFI.getDwarfStrOffDWOSection();
@@ -657,22 +695,53 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
 
   DWPStringPool Strings(Out, StrSection);
 
-  SmallVector<OwningBinary<object::ObjectFile>, 128> Objects;
-  Objects.reserve(Inputs.size());
-
-  std::deque<SmallString<32>> UncompressedSections;
-
-  for (const auto &Input : Inputs) {
-    auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
-    if (!ErrOrObj) {
-      return handleErrors(ErrOrObj.takeError(),
-                          [&](std::unique_ptr<ECError> EC) -> Error {
-                            return createFileError(Input, Error(std::move(EC)));
-                          });
+  // The inputs are read and decompressed on a thread pool, ahead of the merge.
+  // The merge itself is sequential, so that the output doesn't depend on the
+  // number of threads. At most Window inputs are loaded and not merged yet,
+  // and every input is released once it is merged, so the memory used by the
+  // inputs doesn't grow with their number.
+  std::vector<std::optional<Expected<std::unique_ptr<DWPInput>>>> Loaded(
+      Inputs.size());
+  std::vector<std::shared_future<void>> PendingLoads(Inputs.size());
+  std::optional<DefaultThreadPool> Pool;
+  size_t Window = 0;
+  if (NumThreads != 1 && Inputs.size() > 1) {
+    Pool.emplace(hardware_concurrency(NumThreads));
+    Window = 2 * Pool->getMaxConcurrency();
+  }
+  auto EnqueueLoad = [&](size_t I) {
+    if (I < Inputs.size())
+      PendingLoads[I] =
+          Pool->async([&, I] { Loaded[I].emplace(loadInput(Inputs[I])); });
+  };
+  for (size_t I = 0; Pool && I != Window; ++I)
+    EnqueueLoad(I);
+  auto WaitForLoads = make_scope_exit([&] {
+    if (Pool)
+      Pool->wait();
+    for (auto &Input : Loaded)
+      if (Input && !*Input)
+        consumeError(Input->takeError());
+  });
+
+  for (size_t InputIdx = 0; InputIdx != Inputs.size(); ++InputIdx) {
+    const std::string &Input = Inputs[InputIdx];
+    std::unique_ptr<DWPInput> CurInput;
+    if (Pool) {
+      PendingLoads[InputIdx].wait();
+      Expected<std::unique_ptr<DWPInput>> &InputOrErr = *Loaded[InputIdx];
+      if (!InputOrErr)
+        return InputOrErr.takeError();
+      CurInput = std::move(*InputOrErr);
+      Loaded[InputIdx].reset();
+      EnqueueLoad(InputIdx + Window);
+    } else {
+      Expected<std::unique_ptr<DWPInput>> InputOrErr = loadInput(Input);
+      if (!InputOrErr)
+        return InputOrErr.takeError();
+      CurInput = std::move(*InputOrErr);
     }
-
-    auto &Obj = *ErrOrObj->getBinary();
-    Objects.push_back(std::move(*ErrOrObj));
+    auto &Obj = *CurInput->Binary.getBinary();
 
     UnitIndexEntry CurEntry = {};
 
@@ -689,14 +758,15 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
     // i.e. offset and length, of each compile/type unit to a section.
     std::vector<std::pair<DWARFSectionKind, uint32_t>> SectionLength;
 
-    for (const auto &Section : Obj.sections())
+    for (const auto &[Section, Contents] :
+         zip_equal(Obj.sections(), CurInput->SectionContents))
       if (auto Err = handleSection(
               KnownSections, StrSection, StrOffsetSection, TypesSection,
-              CUIndexSection, TUIndexSection, InfoSection, Section, Out,
-              UncompressedSections, ContributionOffsets, CurEntry,
-              CurStrSection, CurStrOffsetSection, CurTypesSection,
-              CurInfoSection, AbbrevSection, CurCUIndexSection,
-              CurTUIndexSection, SectionLength))
+              CUIndexSection, TUIndexSection, InfoSection, Section, Contents,
+              Out, ContributionOffsets, CurEntry, CurStrSection,
+              CurStrOffsetSection, CurTypesSection, CurInfoSection,
+              AbbrevSection, CurCUIndexSection, CurTUIndexSection,
+              SectionLength))
         return Err;
 
     if (CurInfoSection.empty())
@@ -10,6 +10,7 @@
 
 #include "llvm/DebugInfo/CodeView/TypeIndexDiscovery.h"
 #include "llvm/Support/BLAKE3.h"
+#include "llvm/Support/Parallel.h"
 
 using namespace llvm;
 using namespace llvm::codeview;
@@ -78,3 +79,11 @@ GloballyHashedType::hashType(ArrayRef<uint8_t> RecordData,
 
   return {S.final()};
 }
+
+std::vector<std::vector<GloballyHashedType>>
+GloballyHashedType::hashTypeStreams(ArrayRef<CVTypeArray> Streams) {
+  std::vector<std::vector<GloballyHashedType>> Hashes(Streams.size());
+  parallelFor(0, Streams.size(),
+              [&](size_t I) { Hashes[I] = hashTypes(Streams[I]); });
+  return Hashes;
+}
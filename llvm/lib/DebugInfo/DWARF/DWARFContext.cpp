@@ -50,6 +50,7 @@
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdint>
 #include <deque>
@@ -393,6 +394,10 @@ public:
     return Aranges.get();
   }
 
+  void setDebugAranges(std::unique_ptr<DWARFDebugAranges> NewAranges) override {
+    Aranges = std::move(NewAranges);
+  }
+
   Expected<const DWARFDebugLine::LineTable *>
   getLineTableForUnit(DWARFUnit *U, function_ref<void(Error)> RecoverableErrorHandler) override {
     if (!Line)
@@ -672,6 +677,10 @@ public:
     std::unique_lock<std::recursive_mutex> LockGuard(Mutex);
     return ThreadUnsafeDWARFContextState::getDebugAranges();
   }
+  void setDebugAranges(std::unique_ptr<DWARFDebugAranges> NewAranges) override {
+    std::unique_lock<std::recursive_mutex> LockGuard(Mutex);
+    ThreadUnsafeDWARFContextState::setDebugAranges(std::move(NewAranges));
+  }
   Expected<const DWARFDebugLine::LineTable *>
   getLineTableForUnit(DWARFUnit *U, function_ref<void(Error)> RecoverableErrorHandler) override {
     std::unique_lock<std::recursive_mutex> LockGuard(Mutex);
@@ -1438,6 +1447,36 @@ const DWARFDebugAranges *DWARFContext::getDebugAranges() {
   return State->getDebugAranges();
 }
 
+// Identify the DWARF an address index was built from by the sizes of the
+// sections that describe address ranges, which is cheap to compute.
+static uint64_t getAddressIndexKey(const DWARFObject &DObj) {
+  SmallVector<uint8_t, 64> Sizes;
+  auto AddSize = [&](uint64_t Size) {
+    uint8_t Buf[sizeof(uint64_t)];
+    support::endian::write64le(Buf, Size);
+    Sizes.append(std::begin(Buf), std::end(Buf));
+  };
+  DObj.forEachInfoSections(
+      [&](const DWARFSection &S) { AddSize(S.Data.size()); });
+  AddSize(DObj.getArangesSection().size());
+  AddSize(DObj.getRangesSection().Data.size());
+  AddSize(DObj.getRnglistsSection().Data.size());
+  AddSize(DObj.getAddrSection().Data.size());
+  return xxh3_64bits(Sizes);
+}
+
+void DWARFContext::saveAddressIndex(raw_ostream &OS) {
+  getDebugAranges()->writeIndex(OS, getAddressIndexKey(*DObj));
+}
+
+Error DWARFContext::loadAddressIndex(StringRef Data) {
+  auto Aranges = std::make_unique<DWARFDebugAranges>();
+  if (Error Err = Aranges->readIndex(Data, getAddressIndexKey(*DObj)))
+    return Err;
+  State->setDebugAranges(std::move(Aranges));
+  return Error::success();
+}
+
 Expected<const DWARFDebugFrame *> DWARFContext::getDebugFrame() {
   return State->getDebugFrame();
 }
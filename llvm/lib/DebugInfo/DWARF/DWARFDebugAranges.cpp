@@ -13,6 +13,9 @@
 #include "llvm/DebugInfo/DWARF/DWARFDebugArangeSet.h"
 #include "llvm/DebugInfo/DWARF/DWARFObject.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
+#include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/Errc.h"
 #include <cassert>
 #include <cstdint>
 #include <set>
@@ -127,3 +130,55 @@ uint64_t DWARFDebugAranges::findAddress(uint64_t Address) const {
     return It->CUOffset;
   return -1ULL;
 }
+
+static constexpr StringLiteral IndexMagic = "DWARFARI";
+static constexpr uint32_t IndexVersion = 1;
+
+void DWARFDebugAranges::writeIndex(raw_ostream &OS, uint64_t Key) const {
+  support::endian::Writer W(OS, llvm::endianness::little);
+  OS << IndexMagic;
+  W.write<uint32_t>(IndexVersion);
+  W.write<uint64_t>(Key);
+  W.write<uint64_t>(Aranges.size());
+  for (const Range &R : Aranges) {
+    W.write<uint64_t>(R.LowPC);
+    W.write<uint64_t>(R.Length);
+    W.write<uint64_t>(R.CUOffset);
+  }
+}
+
+Error DWARFDebugAranges::readIndex(StringRef Data, uint64_t Key) {
+  if (!Data.consume_front(IndexMagic))
+    return createStringError(errc::invalid_argument,
+                             "not a DWARF address index");
+  DataExtractor DE(Data, /*IsLittleEndian=*/true, /*AddressSize=*/8);
+  DataExtractor::Cursor C(0);
+  uint32_t Version = DE.getU32(C);
+  uint64_t IndexKey = DE.getU64(C);
+  uint64_t NumRanges = DE.getU64(C);
+  if (!C)
+    return C.takeError();
+  if (Version != IndexVersion || IndexKey != Key)
+    return createStringError(errc::invalid_argument,
+                             "DWARF address index is out of date");
+  if (NumRanges > (Data.size() - C.tell()) / (3 * sizeof(uint64_t)))
+    return createStringError(errc::invalid_argument,
+                             "DWARF address index is truncated");
+
+  clear();
+  Aranges.reserve(NumRanges);
+  for (uint64_t I = 0; I != NumRanges; ++I) {
+    uint64_t LowPC = DE.getU64(C);
+    uint64_t Length = DE.getU64(C);
+    uint64_t CUOffset = DE.getU64(C);
+    Aranges.emplace_back(LowPC, LowPC + Length, CUOffset);
+    // Range stores a zero length for ranges reaching the end of the address
+    // space, which the constructor does not recreate.
+    Aranges.back().Length = Length;
+  }
+  if (Error Err = C.takeError()) {
+    clear();
+    return Err;
+  }
+  return Error::success();
+}
@@ -496,12 +496,37 @@ void DWARFUnit::extractDIEsIfNeeded(bool CUDieOnly) {
 }
 
 Error DWARFUnit::tryExtractDIEsIfNeeded(bool CUDieOnly) {
+  if (AllDIEsExtracted.load(std::memory_order_acquire) ||
+      (CUDieOnly && CUDieExtracted.load(std::memory_order_acquire)))
+    return Error::success(); // Already parsed.
+
+  std::lock_guard<std::recursive_mutex> Lock(ExtractDIEsMutex);
   if ((CUDieOnly && !DieArray.empty()) ||
       DieArray.size() > 1)
     return Error::success(); // Already parsed.
 
+  Error Err = extractDIEsLocked(CUDieOnly);
+  CUDieExtracted.store(true, std::memory_order_release);
+  if (!CUDieOnly)
+    AllDIEsExtracted.store(true, std::memory_order_release);
+  return Err;
+}
+
+Error DWARFUnit::extractDIEsLocked(bool CUDieOnly) {
   bool HasCUDie = !DieArray.empty();
-  extractDIEsToVector(!HasCUDie, !CUDieOnly, DieArray);
+  if (!HasCUDie) {
+    extractDIEsToVector(true, !CUDieOnly, DieArray);
+  } else {
+    // Extract the remaining DIEs into a new array instead of growing the
+    // current one, which would move the unit DIE under the feet of threads
+    // that already hold it.
+    std::vector<DWARFDebugInfoEntry> Dies(DieArray);
+    extractDIEsToVector(false, true, Dies);
+    CUDieOnlyArray = std::move(DieArray);
+    DieArray = std::move(Dies);
+  }
+  UnitDieEntry.store(DieArray.empty() ? nullptr : &DieArray[0],
+                     std::memory_order_release);
 
   if (DieArray.empty())
     return Error::success();
@@ -603,6 +628,7 @@ Error DWARFUnit::tryExtractDIEsIfNeeded(bool CUDieOnly) {
 bool DWARFUnit::parseDWO(StringRef DWOAlternativeLocation) {
   if (IsDWO)
     return false;
+  std::lock_guard<std::recursive_mutex> Lock(ExtractDIEsMutex);
   if (DWO)
     return false;
   DWARFDie UnitDie = getUnitDIE();
@@ -658,9 +684,15 @@ void DWARFUnit::clearDIEs(bool KeepCUDie) {
   // It depends on the implementation whether the request is fulfilled.
   // Create a new vector with a small capacity and assign it to the DieArray to
   // have previous contents freed.
+  std::lock_guard<std::recursive_mutex> Lock(ExtractDIEsMutex);
   DieArray = (KeepCUDie && !DieArray.empty())
                  ? std::vector<DWARFDebugInfoEntry>({DieArray[0]})
                  : std::vector<DWARFDebugInfoEntry>();
+  CUDieOnlyArray = std::vector<DWARFDebugInfoEntry>();
+  UnitDieEntry.store(DieArray.empty() ? nullptr : &DieArray[0],
+                     std::memory_order_release);
+  CUDieExtracted.store(!DieArray.empty(), std::memory_order_release);
+  AllDIEsExtracted.store(false, std::memory_order_release);
 }
 
 Expected<DWARFAddressRangesVector>
@@ -762,6 +794,7 @@ void DWARFUnit::updateAddressDieMap(DWARFDie Die) {
 
 DWARFDie DWARFUnit::getSubroutineForAddress(uint64_t Address) {
   extractDIEsIfNeeded(false);
+  std::lock_guard<std::mutex> Lock(AddrDieMapMutex);
   if (AddrDieMap.empty())
     updateAddressDieMap(getUnitDIE());
   auto R = AddrDieMap.upper_bound(Address);
@@ -853,6 +886,7 @@ DWARFDie DWARFUnit::getVariableForAddress(uint64_t Address) {
 
   auto RootDie = getUnitDIE();
 
+  std::lock_guard<std::mutex> Lock(VariableDieMapMutex);
   auto RootLookup = RootsParsedForVariables.insert(RootDie.getOffset());
   if (RootLookup.second)
     updateVariableDieMap(RootDie);
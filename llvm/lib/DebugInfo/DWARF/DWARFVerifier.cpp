@@ -33,6 +33,8 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -413,25 +415,80 @@ bool DWARFVerifier::handleDebugAbbrev() {
   return NumErrors == 0;
 }
 
-unsigned DWARFVerifier::verifyUnits(const DWARFUnitVector &Units) {
-  unsigned NumDebugInfoErrors = 0;
-  ReferenceMap CrossUnitReferences;
+unsigned DWARFVerifier::verifyInParallel(
+    size_t N, function_ref<unsigned(DWARFVerifier &, size_t)> Verify) {
+  unsigned NumErrors = 0;
+  if (N <= 1 || DumpOpts.VerifyNumThreads <= 1 || !DCtx.isThreadSafe()) {
+    for (size_t I = 0; I != N; ++I)
+      NumErrors += Verify(*this, I);
+    return NumErrors;
+  }
 
-  unsigned Index = 1;
-  for (const auto &Unit : Units) {
-    OS << "Verifying unit: " << Index << " / " << Units.getNumUnits();
-    if (const char* Name = Unit->getUnitDIE(true).getShortName())
-      OS << ", \"" << Name << '\"';
-    OS << '\n';
-    OS.flush();
-    ReferenceMap UnitLocalReferences;
-    NumDebugInfoErrors +=
-        verifyUnitContents(*Unit, UnitLocalReferences, CrossUnitReferences);
-    NumDebugInfoErrors += verifyDebugInfoReferences(
-        UnitLocalReferences, [&](uint64_t Offset) { return Unit.get(); });
-    ++Index;
+  ThreadPoolStrategy Strategy = hardware_concurrency(DumpOpts.VerifyNumThreads);
+  // Use a few chunks per thread so that a single large unit doesn't leave the
+  // other threads idle, without creating a verifier for every item.
+  size_t NumChunks =
+      std::min<size_t>(N, size_t(Strategy.compute_thread_count()) * 8);
+  struct Chunk {
+    std::string Output;
+    OutputCategoryAggregator ErrorCategory;
+    uint32_t NumDebugLineErrors = 0;
+    unsigned NumErrors = 0;
+  };
+  std::vector<Chunk> Chunks(NumChunks);
+  {
+    DefaultThreadPool Pool(Strategy);
+    for (size_t C = 0; C != NumChunks; ++C) {
+      Pool.async([&, C] {
+        Chunk &Result = Chunks[C];
+        raw_string_ostream ChunkOS(Result.Output);
+        ChunkOS.enable_colors(OS.colors_enabled());
+        DWARFVerifier V(ChunkOS, DCtx, DumpOpts);
+        for (size_t I = C * N / NumChunks, E = (C + 1) * N / NumChunks; I != E;
+             ++I)
+          Result.NumErrors += Verify(V, I);
+        Result.ErrorCategory = std::move(V.ErrorCategory);
+        Result.NumDebugLineErrors = V.NumDebugLineErrors;
+      });
+    }
+    Pool.wait();
+  }
+
+  for (Chunk &Result : Chunks) {
+    OS << Result.Output;
+    ErrorCategory.Merge(Result.ErrorCategory);
+    NumDebugLineErrors += Result.NumDebugLineErrors;
+    NumErrors += Result.NumErrors;
   }
+  return NumErrors;
+}
+
+unsigned DWARFVerifier::verifyUnits(const DWARFUnitVector &Units) {
+  // The cross unit references are collected per unit so that the units can
+  // be verified in parallel, and are checked once all units are done.
+  std::vector<ReferenceMap> UnitCrossUnitReferences(Units.getNumUnits());
+  unsigned NumDebugInfoErrors = verifyInParallel(
+      Units.getNumUnits(), [&](DWARFVerifier &V, size_t Index) {
+        DWARFUnit *Unit = Units[Index].get();
+        V.OS << "Verifying unit: " << Index + 1 << " / "
+             << Units.getNumUnits();
+        if (const char *Name = Unit->getUnitDIE(true).getShortName())
+          V.OS << ", \"" << Name << '\"';
+        V.OS << '\n';
+        V.OS.flush();
+        ReferenceMap UnitLocalReferences;
+        unsigned NumErrors = V.verifyUnitContents(
+            *Unit, UnitLocalReferences, UnitCrossUnitReferences[Index]);
+        NumErrors += V.verifyDebugInfoReferences(
+            UnitLocalReferences, [&](uint64_t Offset) { return Unit; });
+        return NumErrors;
+      });
 
+  ReferenceMap CrossUnitReferences;
+  for (ReferenceMap &References : UnitCrossUnitReferences)
+    for (auto &[Offset, Referencers] : References)
+      CrossUnitReferences[Offset].insert(Referencers.begin(),
+                                         Referencers.end());
   NumDebugInfoErrors += verifyDebugInfoReferences(
       CrossUnitReferences, [&](uint64_t Offset) -> DWARFUnit * {
         if (DWARFUnit *U = Units.getUnitForOffset(Offset))
@@ -986,104 +1043,112 @@ void DWARFVerifier::verifyDebugLineStmtOffsets() {
 }
 
 void DWARFVerifier::verifyDebugLineRows() {
-  for (const auto &CU : DCtx.compile_units()) {
-    auto Die = CU->getUnitDIE();
-    auto LineTable = DCtx.getLineTableForUnit(CU.get());
-    // If there is no line table we will have created an error in the
-    // .debug_info verifier or in verifyDebugLineStmtOffsets().
-    if (!LineTable)
-      continue;
-
-    // Verify prologue.
-    bool isDWARF5 = LineTable->Prologue.getVersion() >= 5;
-    uint32_t MaxDirIndex = LineTable->Prologue.IncludeDirectories.size();
-    uint32_t MinFileIndex = isDWARF5 ? 0 : 1;
-    uint32_t FileIndex = MinFileIndex;
-    StringMap<uint16_t> FullPathMap;
-    for (const auto &FileName : LineTable->Prologue.FileNames) {
-      // Verify directory index.
-      if (FileName.DirIdx > MaxDirIndex) {
-        ++NumDebugLineErrors;
-        ErrorCategory.Report(
-            "Invalid index in .debug_line->prologue.file_names->dir_idx",
-            [&]() {
-              error() << ".debug_line["
-                      << format("0x%08" PRIx64,
-                                *toSectionOffset(Die.find(DW_AT_stmt_list)))
-                      << "].prologue.file_names[" << FileIndex
-                      << "].dir_idx contains an invalid index: "
-                      << FileName.DirIdx << "\n";
-            });
-      }
+  SmallVector<DWARFUnit *, 0> CUs;
+  for (const auto &CU : DCtx.compile_units())
+    CUs.push_back(CU.get());
+  verifyInParallel(CUs.size(), [&](DWARFVerifier &V, size_t Index) {
+    V.verifyDebugLineRows(CUs[Index]);
+    return 0;
+  });
+}
 
-      // Check file paths for duplicates.
-      std::string FullPath;
-      const bool HasFullPath = LineTable->getFileNameByIndex(
-          FileIndex, CU->getCompilationDir(),
-          DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath, FullPath);
-      assert(HasFullPath && "Invalid index?");
-      (void)HasFullPath;
-      auto [It, Inserted] = FullPathMap.try_emplace(FullPath, FileIndex);
-      if (!Inserted && It->second != FileIndex && DumpOpts.Verbose) {
-        warn() << ".debug_line["
-               << format("0x%08" PRIx64,
-                         *toSectionOffset(Die.find(DW_AT_stmt_list)))
-               << "].prologue.file_names[" << FileIndex
-               << "] is a duplicate of file_names[" << It->second << "]\n";
-      }
+void DWARFVerifier::verifyDebugLineRows(DWARFUnit *CU) {
+  auto Die = CU->getUnitDIE();
+  auto LineTable = DCtx.getLineTableForUnit(CU);
+  // If there is no line table we will have created an error in the
+  // .debug_info verifier or in verifyDebugLineStmtOffsets().
+  if (!LineTable)
+    return;
+
+  // Verify prologue.
+  bool isDWARF5 = LineTable->Prologue.getVersion() >= 5;
+  uint32_t MaxDirIndex = LineTable->Prologue.IncludeDirectories.size();
+  uint32_t MinFileIndex = isDWARF5 ? 0 : 1;
+  uint32_t FileIndex = MinFileIndex;
+  StringMap<uint16_t> FullPathMap;
+  for (const auto &FileName : LineTable->Prologue.FileNames) {
+    // Verify directory index.
+    if (FileName.DirIdx > MaxDirIndex) {
+      ++NumDebugLineErrors;
+      ErrorCategory.Report(
+          "Invalid index in .debug_line->prologue.file_names->dir_idx",
+          [&]() {
+            error() << ".debug_line["
+                    << format("0x%08" PRIx64,
+                              *toSectionOffset(Die.find(DW_AT_stmt_list)))
+                    << "].prologue.file_names[" << FileIndex
+                    << "].dir_idx contains an invalid index: "
+                    << FileName.DirIdx << "\n";
+          });
+    }
 
-      FileIndex++;
+    // Check file paths for duplicates.
+    std::string FullPath;
+    const bool HasFullPath = LineTable->getFileNameByIndex(
+        FileIndex, CU->getCompilationDir(),
+        DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath, FullPath);
+    assert(HasFullPath && "Invalid index?");
+    (void)HasFullPath;
+    auto [It, Inserted] = FullPathMap.try_emplace(FullPath, FileIndex);
+    if (!Inserted && It->second != FileIndex && DumpOpts.Verbose) {
+      warn() << ".debug_line["
+             << format("0x%08" PRIx64,
+                       *toSectionOffset(Die.find(DW_AT_stmt_list)))
+             << "].prologue.file_names[" << FileIndex
+             << "] is a duplicate of file_names[" << It->second << "]\n";
     }
 
-    // Nothing to verify in a line table with a single row containing the end
-    // sequence.
-    if (LineTable->Rows.size() == 1 && LineTable->Rows.front().EndSequence)
-      continue;
+    FileIndex++;
+  }
 
-    // Verify rows.
-    uint64_t PrevAddress = 0;
-    uint32_t RowIndex = 0;
-    for (const auto &Row : LineTable->Rows) {
-      // Verify row address.
-      if (Row.Address.Address < PrevAddress) {
-        ++NumDebugLineErrors;
-        ErrorCategory.Report(
-            "decreasing address between debug_line rows", [&]() {
-              error() << ".debug_line["
-                      << format("0x%08" PRIx64,
-                                *toSectionOffset(Die.find(DW_AT_stmt_list)))
-                      << "] row[" << RowIndex
-                      << "] decreases in address from previous row:\n";
-
-              DWARFDebugLine::Row::dumpTableHeader(OS, 0);
-              if (RowIndex > 0)
-                LineTable->Rows[RowIndex - 1].dump(OS);
-              Row.dump(OS);
-              OS << '\n';
-            });
-      }
+  // Nothing to verify in a line table with a single row containing the end
+  // sequence.
+  if (LineTable->Rows.size() == 1 && LineTable->Rows.front().EndSequence)
+    return;
 
-      if (!LineTable->hasFileAtIndex(Row.File)) {
-        ++NumDebugLineErrors;
-        ErrorCategory.Report("Invalid file index in debug_line", [&]() {
-          error() << ".debug_line["
-                  << format("0x%08" PRIx64,
-                            *toSectionOffset(Die.find(DW_AT_stmt_list)))
-                  << "][" << RowIndex << "] has invalid file index " << Row.File
-                  << " (valid values are [" << MinFileIndex << ','
-                  << LineTable->Prologue.FileNames.size()
-                  << (isDWARF5 ? ")" : "]") << "):\n";
-          DWARFDebugLine::Row::dumpTableHeader(OS, 0);
-          Row.dump(OS);
-          OS << '\n';
-        });
-      }
-      if (Row.EndSequence)
-        PrevAddress = 0;
-      else
-        PrevAddress = Row.Address.Address;
-      ++RowIndex;
+  // Verify rows.
+  uint64_t PrevAddress = 0;
+  uint32_t RowIndex = 0;
+  for (const auto &Row : LineTable->Rows) {
+    // Verify row address.
+    if (Row.Address.Address < PrevAddress) {
+      ++NumDebugLineErrors;
+      ErrorCategory.Report(
+          "decreasing address between debug_line rows", [&]() {
+            error() << ".debug_line["
+                    << format("0x%08" PRIx64,
+                              *toSectionOffset(Die.find(DW_AT_stmt_list)))
+                    << "] row[" << RowIndex
+                    << "] decreases in address from previous row:\n";
+
+            DWARFDebugLine::Row::dumpTableHeader(OS, 0);
+            if (RowIndex > 0)
+              LineTable->Rows[RowIndex - 1].dump(OS);
+            Row.dump(OS);
+            OS << '\n';
+          });
+    }
+
+    if (!LineTable->hasFileAtIndex(Row.File)) {
+      ++NumDebugLineErrors;
+      ErrorCategory.Report("Invalid file index in debug_line", [&]() {
+        error() << ".debug_line["
+                << format("0x%08" PRIx64,
+                          *toSectionOffset(Die.find(DW_AT_stmt_list)))
+                << "][" << RowIndex << "] has invalid file index " << Row.File
+                << " (valid values are [" << MinFileIndex << ','
+                << LineTable->Prologue.FileNames.size()
+                << (isDWARF5 ? ")" : "]") << "):\n";
+        DWARFDebugLine::Row::dumpTableHeader(OS, 0);
+        Row.dump(OS);
+        OS << '\n';
+      });
     }
+    if (Row.EndSequence)
+      PrevAddress = 0;
+    else
+      PrevAddress = Row.Address.Address;
+    ++RowIndex;
   }
 }
 
@@ -1982,14 +2047,25 @@ unsigned DWARFVerifier::verifyDebugNames(const DWARFSection &AccelSection,
   if (NumErrors > 0)
     return NumErrors;
   for (const auto &NI : AccelTable)
-    for (const DWARFDebugNames::NameTableEntry &NTE : NI)
-      NumErrors += verifyNameIndexEntries(NI, NTE);
+    NumErrors += verifyInParallel(
+        NI.getNameCount(), [&](DWARFVerifier &V, size_t Index) {
+          // Name table entries are numbered from 1.
+          return V.verifyNameIndexEntries(NI, NI.getNameTableEntry(Index + 1));
+        });
 
-  for (const std::unique_ptr<DWARFUnit> &U : DCtx.info_section_units()) {
+  SmallVector<std::pair<DWARFCompileUnit *, const DWARFDebugNames::NameIndex *>,
+              0>
+      IndexedCUs;
+  for (const std::unique_ptr<DWARFUnit> &U : DCtx.info_section_units())
     if (const DWARFDebugNames::NameIndex *NI =
-            AccelTable.getCUOrTUNameIndex(U->getOffset())) {
-      DWARFCompileUnit *CU = dyn_cast<DWARFCompileUnit>(U.get());
-      if (CU) {
+            AccelTable.getCUOrTUNameIndex(U->getOffset()))
+      if (auto *CU = dyn_cast<DWARFCompileUnit>(U.get()))
+        IndexedCUs.emplace_back(CU, NI);
+
+  NumErrors += verifyInParallel(
+      IndexedCUs.size(), [&](DWARFVerifier &V, size_t Index) {
+        auto [CU, NI] = IndexedCUs[Index];
+        unsigned NumErrors = 0;
         if (CU->getDWOId()) {
           DWARFDie CUDie = CU->getUnitDIE(true);
           DWARFDie NonSkeletonUnitDie =
@@ -1997,16 +2073,15 @@ unsigned DWARFVerifier::verifyDebugNames(const DWARFSection &AccelSection,
           if (CUDie != NonSkeletonUnitDie) {
             for (const DWARFDebugInfoEntry &Die :
                  NonSkeletonUnitDie.getDwarfUnit()->dies())
-              NumErrors += verifyNameIndexCompleteness(
+              NumErrors += V.verifyNameIndexCompleteness(
                   DWARFDie(NonSkeletonUnitDie.getDwarfUnit(), &Die), *NI);
           }
         } else {
           for (const DWARFDebugInfoEntry &Die : CU->dies())
-            NumErrors += verifyNameIndexCompleteness(DWARFDie(CU, &Die), *NI);
+            NumErrors += V.verifyNameIndexCompleteness(DWARFDie(CU, &Die), *NI);
         }
-      }
-    }
-  }
+        return NumErrors;
+      });
   return NumErrors;
 }
 
@@ -2174,6 +2249,11 @@ void OutputCategoryAggregator::Report(
     detailCallback();
 }
 
+void OutputCategoryAggregator::Merge(const OutputCategoryAggregator &Other) {
+  for (auto &&[name, count] : Other.Aggregation)
+    Aggregation[name] += count;
+}
+
 void OutputCategoryAggregator::EnumerateResults(
     std::function<void(StringRef, unsigned)> handleCounts) {
   for (auto &&[name, count] : Aggregation) {
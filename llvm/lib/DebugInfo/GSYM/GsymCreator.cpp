@@ -11,6 +11,7 @@
 #include "llvm/DebugInfo/GSYM/LineTable.h"
 #include "llvm/DebugInfo/GSYM/OutputAggregator.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
@@ -21,6 +22,36 @@
 using namespace llvm;
 using namespace gsym;
 
+/// The number of function infos per thread that are encoded in parallel
+/// before being written out.
+static constexpr size_t EncodeBatchSizePerThread = 1024;
+
+/// Sort \p Funcs by sorting chunks of it in parallel and merging the sorted
+/// chunks pairwise.
+static void parallelSortFunctions(std::vector<FunctionInfo> &Funcs,
+                                  ThreadPoolInterface &Pool) {
+  const size_t NumChunks =
+      std::min<size_t>(Pool.getMaxConcurrency(), Funcs.size());
+  const size_t ChunkSize = (Funcs.size() + NumChunks - 1) / NumChunks;
+  auto ChunkBegin = [&](size_t I) {
+    return Funcs.begin() + std::min(Funcs.size(), I * ChunkSize);
+  };
+
+  ThreadPoolTaskGroup Group(Pool);
+  for (size_t I = 0; I < NumChunks; ++I)
+    Group.async([&, I] { std::stable_sort(ChunkBegin(I), ChunkBegin(I + 1)); });
+  Group.wait();
+
+  for (size_t Width = 1; Width < NumChunks; Width *= 2) {
+    for (size_t I = 0; I + Width < NumChunks; I += 2 * Width)
+      Group.async([&, I, Width] {
+        std::inplace_merge(ChunkBegin(I), ChunkBegin(I + Width),
+                           ChunkBegin(std::min(I + 2 * Width, NumChunks)));
+      });
+    Group.wait();
+  }
+}
+
 GsymCreator::GsymCreator(bool Quiet)
     : StrTab(StringTableBuilder::ELF), Quiet(Quiet) {
   insertFile(StringRef());
@@ -169,12 +200,55 @@ llvm::Error GsymCreator::encode(FileWriter &O) const {
   const off_t StrtabSize = O.tell() - StrtabOffset;
   std::vector<uint32_t> AddrInfoOffsets;
 
+  AddrInfoOffsets.reserve(Funcs.size());
+
   // Write out the address infos for each function info.
-  for (const auto &FuncInfo : Funcs) {
-    if (Expected<uint64_t> OffsetOrErr = FuncInfo.encode(O))
-      AddrInfoOffsets.push_back(OffsetOrErr.get());
-    else
-      return OffsetOrErr.takeError();
+  if (NumThreads == 1 || Funcs.size() < 2) {
+    for (const auto &FuncInfo : Funcs) {
+      if (Expected<uint64_t> OffsetOrErr = FuncInfo.encode(O))
+        AddrInfoOffsets.push_back(OffsetOrErr.get());
+      else
+        return OffsetOrErr.takeError();
+    }
+  } else {
+    // Encode batches of function infos in parallel into separate buffers,
+    // and write each batch out in order before encoding the next one. The
+    // encoding of a function info doesn't depend on its offset in the file.
+    DefaultThreadPool Pool(hardware_concurrency(NumThreads));
+    const size_t BatchSize =
+        EncodeBatchSizePerThread * Pool.getMaxConcurrency();
+    std::vector<SmallString<0>> Encoded;
+    std::mutex ErrorMutex;
+    for (size_t Begin = 0; Begin < Funcs.size(); Begin += BatchSize) {
+      const size_t End = std::min(Begin + BatchSize, Funcs.size());
+      Encoded.assign(End - Begin, SmallString<0>());
+      Error BatchErr = Error::success();
+      for (size_t I = Begin; I < End; I += EncodeBatchSizePerThread)
+        Pool.async([&, I] {
+          for (size_t J = I; J < std::min(I + EncodeBatchSizePerThread, End);
+               ++J) {
+            raw_svector_ostream OutStrm(Encoded[J - Begin]);
+            FileWriter FW(OutStrm, O.getByteOrder());
+            if (Expected<uint64_t> OffsetOrErr = Funcs[J].encode(FW);
+                !OffsetOrErr) {
+              std::lock_guard<std::mutex> Guard(ErrorMutex);
+              BatchErr = joinErrors(std::move(BatchErr),
+                                    OffsetOrErr.takeError());
+            }
+          }
+        });
+      Pool.wait();
+      if (BatchErr)
+        return BatchErr;
+
+      for (size_t I = 0; I < Encoded.size(); ++I) {
+        O.alignTo(4);
+        AddrInfoOffsets.push_back(O.tell());
+        O.writeData(ArrayRef<uint8_t>(
+            reinterpret_cast<const uint8_t *>(Encoded[I].data()),
+            Encoded[I].size()));
+      }
+    }
   }
   // Fixup the string table offset and size in the header
   O.fixup32((uint32_t)StrtabOffset, offsetof(Header, StrtabOffset));
@@ -276,7 +350,12 @@ llvm::Error GsymCreator::finalize(OutputAggregator &Out) {
   if (!IsSegment) {
     if (NumBefore > 1) {
       // Sort function infos so we can emit sorted functions.
-      llvm::sort(Funcs);
+      if (NumThreads == 1) {
+        llvm::sort(Funcs);
+      } else {
+        DefaultThreadPool Pool(hardware_concurrency(NumThreads));
+        parallelSortFunctions(Funcs, Pool);
+      }
       std::vector<FunctionInfo> FinalizedFuncs;
       FinalizedFuncs.reserve(Funcs.size());
       FinalizedFuncs.emplace_back(std::move(Funcs.front()));
@@ -0,0 +1,159 @@
+//===- GsymDIContext.cpp --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/GsymDIContext.h"
+
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/Support/Path.h"
+
+using namespace llvm;
+using namespace llvm::gsym;
+
+GsymDIContext::GsymDIContext(std::unique_ptr<GsymReader> Reader)
+    : DIContext(CK_GSYM), Reader(std::move(Reader)) {}
+
+GsymDIContext::~GsymDIContext() = default;
+
+void GsymDIContext::dump(raw_ostream &OS, DIDumpOptions DumpOpts) {
+  Reader->dump(OS);
+}
+
+static bool fillLineInfoFromLocation(const SourceLocation &Location,
+                                     DILineInfoSpecifier Specifier,
+                                     DILineInfo &LineInfo) {
+  if (Specifier.FNKind != DINameKind::None)
+    LineInfo.FunctionName = Location.Name.str();
+
+  switch (Specifier.FLIKind) {
+  case DILineInfoSpecifier::FileLineInfoKind::RelativeFilePath:
+    // GSYM does not record the compilation directory, so fall back to the
+    // path as recorded.
+  case DILineInfoSpecifier::FileLineInfoKind::RawValue:
+  case DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath:
+    if (Location.Dir.empty()) {
+      if (Location.Base.empty())
+        LineInfo.FileName = DILineInfo::BadString;
+      else
+        LineInfo.FileName = Location.Base.str();
+    } else {
+      SmallString<128> Path(Location.Dir);
+      sys::path::append(Path, Location.Base);
+      LineInfo.FileName = static_cast<std::string>(Path);
+    }
+    break;
+
+  case DILineInfoSpecifier::FileLineInfoKind::BaseNameOnly:
+    LineInfo.FileName = Location.Base.str();
+    break;
+
+  default:
+    return false;
+  }
+  // GSYM has no columns, start lines or embedded sources.
+  LineInfo.Line = Location.Line;
+  return true;
+}
+
+DILineInfo
+GsymDIContext::getLineInfoForAddress(object::SectionedAddress Address,
+                                     DILineInfoSpecifier Specifier) {
+  if (Address.SectionIndex != object::SectionedAddress::UndefSection)
+    return {};
+
+  auto ResultOrErr = Reader->lookup(Address.Address);
+  if (!ResultOrErr) {
+    consumeError(ResultOrErr.takeError());
+    return {};
+  }
+
+  DILineInfo LineInfo;
+  if (ResultOrErr->Locations.empty()) {
+    // There is no line table for the function, only its symbol.
+    if (Specifier.FNKind != DINameKind::None)
+      LineInfo.FunctionName = ResultOrErr->FuncName.str();
+  } else if (!fillLineInfoFromLocation(ResultOrErr->Locations.front(),
+                                       Specifier, LineInfo)) {
+    return {};
+  }
+  LineInfo.StartAddress = ResultOrErr->FuncRange.start();
+  return LineInfo;
+}
+
+DILineInfo
+GsymDIContext::getLineInfoForDataAddress(object::SectionedAddress Address) {
+  // GSYM does not convey such information.
+  return {};
+}
+
+DILineInfoTable
+GsymDIContext::getLineInfoForAddressRange(object::SectionedAddress Address,
+                                          uint64_t Size,
+                                          DILineInfoSpecifier Specifier) {
+  if (Size == 0 ||
+      Address.SectionIndex != object::SectionedAddress::UndefSection)
+    return {};
+
+  auto FuncInfoOrErr = Reader->getFunctionInfo(Address.Address);
+  if (!FuncInfoOrErr) {
+    consumeError(FuncInfoOrErr.takeError());
+    return {};
+  }
+
+  DILineInfoTable Table;
+  if (!FuncInfoOrErr->OptLineTable)
+    return Table;
+  for (const LineEntry &LE : *FuncInfoOrErr->OptLineTable) {
+    if (LE.Addr < Address.Address)
+      continue;
+    if (LE.Addr >= Address.Address + Size)
+      break;
+    std::optional<FileEntry> FE = Reader->getFile(LE.File);
+    if (!FE)
+      continue;
+    SourceLocation Location;
+    Location.Name = Reader->getString(FuncInfoOrErr->Name);
+    Location.Dir = Reader->getString(FE->Dir);
+    Location.Base = Reader->getString(FE->Base);
+    Location.Line = LE.Line;
+    DILineInfo LineInfo;
+    if (fillLineInfoFromLocation(Location, Specifier, LineInfo))
+      Table.push_back(std::make_pair(LE.Addr, LineInfo));
+  }
+  return Table;
+}
+
+DIInliningInfo
+GsymDIContext::getInliningInfoForAddress(object::SectionedAddress Address,
+                                         DILineInfoSpecifier Specifier) {
+  if (Address.SectionIndex != object::SectionedAddress::UndefSection)
+    return {};
+
+  auto ResultOrErr = Reader->lookup(Address.Address);
+  if (!ResultOrErr) {
+    consumeError(ResultOrErr.takeError());
+    return {};
+  }
+
+  // The locations go from the innermost inlined frame to the concrete
+  // function, in the order DIInliningInfo expects the frames.
+  DIInliningInfo InlineInfo;
+  for (const SourceLocation &Location : ResultOrErr->Locations) {
+    DILineInfo LineInfo;
+    if (!fillLineInfoFromLocation(Location, Specifier, LineInfo))
+      return {};
+    LineInfo.StartAddress = ResultOrErr->FuncRange.start();
+    InlineInfo.addFrame(LineInfo);
+  }
+  return InlineInfo;
+}
+
+std::vector<DILocal>
+GsymDIContext::getLocalsForAddress(object::SectionedAddress Address) {
+  // GSYM does not convey such information.
+  return {};
+}
@@ -105,40 +105,34 @@ Error MappedBlockStream::readBytes(uint64_t Offset, uint64_t Size,
 
   // We couldn't find a buffer that started at the correct offset (the most
   // common scenario).  Try to see if there is a buffer that starts at some
-  // other offset but overlaps the desired range.
-  for (auto &CacheItem : CacheMap) {
-    Interval RequestExtent = std::make_pair(Offset, Offset + Size);
+  // earlier offset but covers the desired range.  Only the entries which start
+  // less than MaxCachedSize bytes before the end of the request can cover it,
+  // so there is no need to look at every cached buffer of a large stream.
+  Interval RequestExtent = std::make_pair(Offset, Offset + Size);
+  for (auto It = std::make_reverse_iterator(CacheMap.upper_bound(Offset)),
+            End = CacheMap.rend();
+       It != End; ++It) {
+    if (It->first + MaxCachedSize < RequestExtent.second)
+      break;
 
     // We already checked this one on the fast path above.
-    if (CacheItem.first == Offset)
-      continue;
-    // If the initial extent of the cached item is beyond the ending extent
-    // of the request, there is no overlap.
-    if (CacheItem.first >= Offset + Size)
+    if (It->first == Offset)
       continue;
 
     // We really only have to check the last item in the list, since we append
     // in order of increasing length.
-    if (CacheItem.second.empty())
+    if (It->second.empty())
       continue;
 
-    auto CachedAlloc = CacheItem.second.back();
-    // If the initial extent of the request is beyond the ending extent of
-    // the cached item, there is no overlap.
+    auto CachedAlloc = It->second.back();
     Interval CachedExtent =
-        std::make_pair(CacheItem.first, CacheItem.first + CachedAlloc.size());
-    if (RequestExtent.first >= CachedExtent.first + CachedExtent.second)
-      continue;
-
-    Interval Intersection = intersect(CachedExtent, RequestExtent);
+        std::make_pair(It->first, It->first + CachedAlloc.size());
     // Only use this if the entire request extent is contained in the cached
     // extent.
-    if (Intersection != RequestExtent)
+    if (CachedExtent.second < RequestExtent.second)
       continue;
 
-    uint64_t CacheRangeOffset =
-        AbsoluteDifference(CachedExtent.first, Intersection.first);
-    Buffer = CachedAlloc.slice(CacheRangeOffset, Size);
+    Buffer = CachedAlloc.slice(Offset - CachedExtent.first, Size);
     return Error::success();
   }
 
@@ -150,13 +144,8 @@ Error MappedBlockStream::readBytes(uint64_t Offset, uint64_t Size,
   if (auto EC = readBytes(Offset, MutableArrayRef<uint8_t>(WriteBuffer, Size)))
     return EC;
 
-  if (CacheIter != CacheMap.end()) {
-    CacheIter->second.emplace_back(WriteBuffer, Size);
-  } else {
-    std::vector<CacheEntry> List;
-    List.emplace_back(WriteBuffer, Size);
-    CacheMap.insert(std::make_pair(Offset, List));
-  }
+  CacheMap[Offset].emplace_back(WriteBuffer, Size);
+  MaxCachedSize = std::max(MaxCachedSize, Size);
   Buffer = ArrayRef<uint8_t>(WriteBuffer, Size);
   return Error::success();
 }
@@ -267,7 +256,10 @@ Error MappedBlockStream::readBytes(uint64_t Offset,
   return Error::success();
 }
 
-void MappedBlockStream::invalidateCache() { CacheMap.shrink_and_clear(); }
+void MappedBlockStream::invalidateCache() {
+  CacheMap.clear();
+  MaxCachedSize = 0;
+}
 
 void MappedBlockStream::fixCacheAfterWrite(uint64_t Offset,
                                            ArrayRef<uint8_t> Data) const {
@@ -275,11 +267,15 @@ void MappedBlockStream::fixCacheAfterWrite(uint64_t Offset,
   // someone may still be holding a pointer to that alloc which is now invalid.
   // Compute the overlapping range and update the cache entry, so any
   // outstanding buffers are automatically updated.
-  for (const auto &MapEntry : CacheMap) {
+  // Cached extents which start MaxCachedSize bytes or more before the written
+  // extent can't overlap it.
+  uint64_t FirstCached = Offset > MaxCachedSize ? Offset - MaxCachedSize : 0;
+  for (const auto &MapEntry : make_range(CacheMap.lower_bound(FirstCached),
+                                         CacheMap.end())) {
     // If the end of the written extent precedes the beginning of the cached
-    // extent, ignore this map entry.
+    // extent, no later map entry overlaps it either.
     if (Offset + Data.size() < MapEntry.first)
-      continue;
+      break;
     for (const auto &Alloc : MapEntry.second) {
       // If the end of the cached extent precedes the beginning of the written
       // extent, ignore this alloc.
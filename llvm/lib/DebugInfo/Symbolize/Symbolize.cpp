@@ -15,6 +15,12 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/DebugInfo/BTF/BTFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/DwarfTransformer.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/GsymDIContext.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/GSYM/ObjectFileTransformer.h"
+#include "llvm/DebugInfo/GSYM/OutputAggregator.h"
 #include "llvm/DebugInfo/PDB/PDB.h"
 #include "llvm/DebugInfo/PDB/PDBContext.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableObjectFile.h"
@@ -30,7 +36,10 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/xxhash.h"
 #include <cassert>
 #include <cstring>
 
@@ -48,17 +57,9 @@ LLVMSymbolizer::LLVMSymbolizer(const Options &Opts)
 
 LLVMSymbolizer::~LLVMSymbolizer() = default;
 
-template <typename T>
-Expected<DILineInfo>
-LLVMSymbolizer::symbolizeCodeCommon(const T &ModuleSpecifier,
-                                    object::SectionedAddress ModuleOffset) {
-
-  auto InfoOrErr = getOrCreateModuleInfo(ModuleSpecifier);
-  if (!InfoOrErr)
-    return InfoOrErr.takeError();
-
-  SymbolizableModule *Info = *InfoOrErr;
-
+DILineInfo
+LLVMSymbolizer::symbolizeCodeInModule(SymbolizableModule *Info,
+                                      object::SectionedAddress ModuleOffset) {
   // A null module means an error has already been reported. Return an empty
   // result.
   if (!Info)
@@ -79,6 +80,17 @@ LLVMSymbolizer::symbolizeCodeCommon(const T &ModuleSpecifier,
   return LineInfo;
 }
 
+template <typename T>
+Expected<DILineInfo>
+LLVMSymbolizer::symbolizeCodeCommon(const T &ModuleSpecifier,
+                                    object::SectionedAddress ModuleOffset) {
+  sys::ScopedReader Lock(EvictionMutex);
+  auto InfoOrErr = getOrCreateModuleInfo(ModuleSpecifier);
+  if (!InfoOrErr)
+    return InfoOrErr.takeError();
+  return symbolizeCodeInModule(*InfoOrErr, ModuleOffset);
+}
+
 Expected<DILineInfo>
 LLVMSymbolizer::symbolizeCode(const ObjectFile &Obj,
                               object::SectionedAddress ModuleOffset) {
@@ -97,15 +109,8 @@ LLVMSymbolizer::symbolizeCode(ArrayRef<uint8_t> BuildID,
   return symbolizeCodeCommon(BuildID, ModuleOffset);
 }
 
-template <typename T>
-Expected<DIInliningInfo> LLVMSymbolizer::symbolizeInlinedCodeCommon(
-    const T &ModuleSpecifier, object::SectionedAddress ModuleOffset) {
-  auto InfoOrErr = getOrCreateModuleInfo(ModuleSpecifier);
-  if (!InfoOrErr)
-    return InfoOrErr.takeError();
-
-  SymbolizableModule *Info = *InfoOrErr;
-
+DIInliningInfo LLVMSymbolizer::symbolizeInlinedCodeInModule(
+    SymbolizableModule *Info, object::SectionedAddress ModuleOffset) {
   // A null module means an error has already been reported. Return an empty
   // result.
   if (!Info)
@@ -130,6 +135,16 @@ Expected<DIInliningInfo> LLVMSymbolizer::symbolizeInlinedCodeCommon(
   return InlinedContext;
 }
 
+template <typename T>
+Expected<DIInliningInfo> LLVMSymbolizer::symbolizeInlinedCodeCommon(
+    const T &ModuleSpecifier, object::SectionedAddress ModuleOffset) {
+  sys::ScopedReader Lock(EvictionMutex);
+  auto InfoOrErr = getOrCreateModuleInfo(ModuleSpecifier);
+  if (!InfoOrErr)
+    return InfoOrErr.takeError();
+  return symbolizeInlinedCodeInModule(*InfoOrErr, ModuleOffset);
+}
+
 Expected<DIInliningInfo>
 LLVMSymbolizer::symbolizeInlinedCode(const ObjectFile &Obj,
                                      object::SectionedAddress ModuleOffset) {
@@ -148,11 +163,37 @@ LLVMSymbolizer::symbolizeInlinedCode(ArrayRef<uint8_t> BuildID,
   return symbolizeInlinedCodeCommon(BuildID, ModuleOffset);
 }
 
+Expected<std::vector<DILineInfo>> LLVMSymbolizer::symbolizeCodeBatch(
+    StringRef ModuleName, ArrayRef<object::SectionedAddress> ModuleOffsets) {
+  sys::ScopedReader Lock(EvictionMutex);
+  auto InfoOrErr = getOrCreateModuleInfo(ModuleName);
+  if (!InfoOrErr)
+    return InfoOrErr.takeError();
+  std::vector<DILineInfo> Results(ModuleOffsets.size());
+  parallelFor(0, ModuleOffsets.size(), [&](size_t I) {
+    Results[I] = symbolizeCodeInModule(*InfoOrErr, ModuleOffsets[I]);
+  });
+  return std::move(Results);
+}
+
+Expected<std::vector<DIInliningInfo>> LLVMSymbolizer::symbolizeInlinedCodeBatch(
+    StringRef ModuleName, ArrayRef<object::SectionedAddress> ModuleOffsets) {
+  sys::ScopedReader Lock(EvictionMutex);
+  auto InfoOrErr = getOrCreateModuleInfo(ModuleName);
+  if (!InfoOrErr)
+    return InfoOrErr.takeError();
+  std::vector<DIInliningInfo> Results(ModuleOffsets.size());
+  parallelFor(0, ModuleOffsets.size(), [&](size_t I) {
+    Results[I] = symbolizeInlinedCodeInModule(*InfoOrErr, ModuleOffsets[I]);
+  });
+  return std::move(Results);
+}
+
 template <typename T>
 Expected<DIGlobal>
 LLVMSymbolizer::symbolizeDataCommon(const T &ModuleSpecifier,
                                     object::SectionedAddress ModuleOffset) {
-
+  sys::ScopedReader Lock(EvictionMutex);
   auto InfoOrErr = getOrCreateModuleInfo(ModuleSpecifier);
   if (!InfoOrErr)
     return InfoOrErr.takeError();
@@ -197,6 +238,7 @@ template <typename T>
 Expected<std::vector<DILocal>>
 LLVMSymbolizer::symbolizeFrameCommon(const T &ModuleSpecifier,
                                      object::SectionedAddress ModuleOffset) {
+  sys::ScopedReader Lock(EvictionMutex);
   auto InfoOrErr = getOrCreateModuleInfo(ModuleSpecifier);
   if (!InfoOrErr)
     return InfoOrErr.takeError();
@@ -238,6 +280,7 @@ template <typename T>
 Expected<std::vector<DILineInfo>>
 LLVMSymbolizer::findSymbolCommon(const T &ModuleSpecifier, StringRef Symbol,
                                  uint64_t Offset) {
+  sys::ScopedReader Lock(EvictionMutex);
   auto InfoOrErr = getOrCreateModuleInfo(ModuleSpecifier);
   if (!InfoOrErr)
     return InfoOrErr.takeError();
@@ -283,6 +326,8 @@ LLVMSymbolizer::findSymbol(ArrayRef<uint8_t> BuildID, StringRef Symbol,
 }
 
 void LLVMSymbolizer::flush() {
+  sys::ScopedWriter Lock(EvictionMutex);
+  std::lock_guard<std::recursive_mutex> CacheLock(CacheMutex);
   ObjectForUBPathAndArch.clear();
   LRUBinaries.clear();
   CacheSize = 0;
@@ -604,6 +649,7 @@ LLVMSymbolizer::createModuleInfo(const ObjectFile *Obj,
 
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(StringRef ModuleName) {
+  std::lock_guard<std::recursive_mutex> Lock(CacheMutex);
   StringRef BinaryName = ModuleName;
   StringRef ArchName = Opts.DefaultArch;
   size_t ColonPos = ModuleName.find_last_of(':');
@@ -660,10 +706,13 @@ LLVMSymbolizer::getOrCreateModuleInfo(StringRef ModuleName) {
       Context.reset(new PDBContext(*CoffObject, std::move(Session)));
     }
   }
+  if (!Context && Opts.UseGsym)
+    Context = getOrCreateGsymContext(*Objects.second);
   if (!Context)
     Context = DWARFContext::create(
         *Objects.second, DWARFContext::ProcessDebugRelocations::Process,
-        nullptr, Opts.DWPName);
+        nullptr, Opts.DWPName, WithColor::defaultErrorHandler,
+        WithColor::defaultWarningHandler, /*ThreadSafe=*/true);
   auto ModuleOrErr =
       createModuleInfo(Objects.first, std::move(Context), ModuleName);
   if (ModuleOrErr) {
@@ -675,6 +724,100 @@ LLVMSymbolizer::getOrCreateModuleInfo(StringRef ModuleName) {
   return ModuleOrErr;
 }
 
+std::string LLVMSymbolizer::getGsymPath(const ObjectFile &DbgObj) {
+  StringRef Path = DbgObj.getFileName();
+  if (Opts.GsymDirectory.empty())
+    return (Path + ".gsym").str();
+  // Binaries with the same name may be cached in the directory, so name the
+  // GSYM file after the build ID, or the full path if there is none.
+  SmallString<128> GsymPath(Opts.GsymDirectory);
+  ArrayRef<uint8_t> BuildID;
+  if (auto *ELFObj = dyn_cast<ELFObjectFileBase>(&DbgObj))
+    BuildID = getBuildID(ELFObj);
+  else if (auto *MachObj = dyn_cast<MachOObjectFile>(&DbgObj))
+    BuildID = MachObj->getUuid();
+  std::string Key = BuildID.empty() ? utohexstr(xxh3_64bits(Path))
+                                    : toHex(BuildID, /*LowerCase=*/true);
+  sys::path::append(GsymPath,
+                    sys::path::filename(Path) + "-" + Key + ".gsym");
+  return std::string(GsymPath);
+}
+
+Error LLVMSymbolizer::convertToGsym(const ObjectFile &DbgObj,
+                                    StringRef GsymPath) {
+  std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
+      DbgObj, DWARFContext::ProcessDebugRelocations::Process, nullptr,
+      Opts.DWPName, WithColor::defaultErrorHandler,
+      WithColor::defaultWarningHandler, /*ThreadSafe=*/true);
+  gsym::GsymCreator Gsym(/*Quiet=*/true);
+  gsym::OutputAggregator Out(nullptr);
+
+  // Only keep the functions in code sections, as llvm-gsymutil does.
+  AddressRanges TextRanges;
+  for (const SectionRef &Sect : DbgObj.sections())
+    if (Sect.isText() && Sect.getSize())
+      TextRanges.insert(AddressRange(Sect.getAddress(),
+                                     Sect.getAddress() + Sect.getSize()));
+  if (!TextRanges.empty())
+    Gsym.SetValidTextRanges(TextRanges);
+
+  gsym::DwarfTransformer DT(*DICtx, Gsym);
+  if (Error Err = DT.convert(
+          hardware_concurrency().compute_thread_count(), Out))
+    return Err;
+  if (Error Err = gsym::ObjectFileTransformer::convert(DbgObj, Out, Gsym))
+    return Err;
+  if (Error Err = Gsym.finalize(Out))
+    return Err;
+
+  // Write to a temporary file and rename it, so that concurrent symbolizers
+  // never read a partially written GSYM file.
+  SmallString<128> TmpPath;
+  sys::fs::createUniquePath(GsymPath + "-%%%%%%%%.tmp", TmpPath,
+                            /*MakeAbsolute=*/false);
+  llvm::endianness Endian = DbgObj.isLittleEndian() ? llvm::endianness::little
+                                                    : llvm::endianness::big;
+  if (Error Err = Gsym.save(TmpPath, Endian)) {
+    sys::fs::remove(TmpPath);
+    return Err;
+  }
+  if (std::error_code EC = sys::fs::rename(TmpPath, GsymPath)) {
+    sys::fs::remove(TmpPath);
+    return createFileError(GsymPath, EC);
+  }
+  return Error::success();
+}
+
+std::unique_ptr<DIContext>
+LLVMSymbolizer::getOrCreateGsymContext(const ObjectFile &DbgObj) {
+  std::string GsymPath = getGsymPath(DbgObj);
+
+  // A GSYM file older than the binary was made for a previous build of it.
+  sys::fs::file_status ObjStatus, GsymStatus;
+  bool UpToDate =
+      !sys::fs::status(GsymPath, GsymStatus) &&
+      (sys::fs::status(DbgObj.getFileName(), ObjStatus) ||
+       GsymStatus.getLastModificationTime() >=
+           ObjStatus.getLastModificationTime());
+  if (!UpToDate) {
+    if (!Opts.GenerateGsym || !DbgObj.hasDebugInfo())
+      return nullptr;
+    if (Error Err = convertToGsym(DbgObj, GsymPath)) {
+      // Fall back to DWARF; the error only means there is no cache.
+      consumeError(std::move(Err));
+      return nullptr;
+    }
+  }
+
+  Expected<gsym::GsymReader> ReaderOrErr = gsym::GsymReader::openFile(GsymPath);
+  if (!ReaderOrErr) {
+    consumeError(ReaderOrErr.takeError());
+    return nullptr;
+  }
+  return std::make_unique<gsym::GsymDIContext>(
+      std::make_unique<gsym::GsymReader>(std::move(*ReaderOrErr)));
+}
+
 // For BPF programs .BTF.ext section contains line numbers information,
 // use it if regular DWARF is not available (e.g. for stripped binary).
 static bool useBTFContext(const ObjectFile &Obj) {
@@ -684,6 +827,7 @@ static bool useBTFContext(const ObjectFile &Obj) {
 
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(const ObjectFile &Obj) {
+  std::lock_guard<std::recursive_mutex> Lock(CacheMutex);
   StringRef ObjName = Obj.getFileName();
   auto I = Modules.find(ObjName);
   if (I != Modules.end())
@@ -693,13 +837,17 @@ LLVMSymbolizer::getOrCreateModuleInfo(const ObjectFile &Obj) {
   if (useBTFContext(Obj))
     Context = BTFContext::create(Obj);
   else
-    Context = DWARFContext::create(Obj);
+    Context = DWARFContext::create(
+        Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr, "",
+        WithColor::defaultErrorHandler, WithColor::defaultWarningHandler,
+        /*ThreadSafe=*/true);
   // FIXME: handle COFF object with PDB info to use PDBContext
   return createModuleInfo(&Obj, std::move(Context), ObjName);
 }
 
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(ArrayRef<uint8_t> BuildID) {
+  std::lock_guard<std::recursive_mutex> Lock(CacheMutex);
   std::string Path;
   if (!getOrFindDebugBinary(BuildID, Path)) {
     return createStringError(errc::no_such_file_or_directory,
@@ -784,6 +932,8 @@ void LLVMSymbolizer::recordAccess(CachedBinary &Bin) {
 }
 
 void LLVMSymbolizer::pruneCache() {
+  sys::ScopedWriter Lock(EvictionMutex);
+  std::lock_guard<std::recursive_mutex> CacheLock(CacheMutex);
   // Evict the LRU binary until the max cache size is reached or there's <= 1
   // item in the cache. The MRU binary is always kept to avoid thrashing if it's
   // larger than the cache size.
@@ -116,6 +116,17 @@ std::chrono::milliseconds getDefaultDebuginfodTimeout() {
   return std::chrono::milliseconds(90 * 1000);
 }
 
+std::chrono::seconds getDefaultDebuginfodCacheMissTimeout() {
+  long Timeout;
+  const char *CacheMissTimeoutEnv =
+      std::getenv("DEBUGINFOD_CACHE_MISS_TIMEOUT");
+  if (CacheMissTimeoutEnv &&
+      to_integer(StringRef(CacheMissTimeoutEnv).trim(), Timeout, 10))
+    return std::chrono::seconds(std::max(Timeout, 0L));
+
+  return std::chrono::seconds(600);
+}
+
 /// The following functions fetch a debuginfod artifact to a file in a local
 /// cache and return the cached file path. They first search the local cache,
 /// followed by the debuginfod servers.
@@ -159,6 +170,34 @@ Expected<std::string> getCachedOrDownloadDebuginfo(BuildIDRef ID) {
   return getCachedOrDownloadArtifact(getDebuginfodCacheKey(UrlPath), UrlPath);
 }
 
+std::vector<Expected<std::string>>
+getCachedOrDownloadDebuginfos(ArrayRef<object::BuildID> IDs,
+                              unsigned MaxConcurrentRequests) {
+  std::vector<std::optional<Expected<std::string>>> Paths(IDs.size());
+  if (IDs.size() > 1) {
+    // The requests mostly wait for the servers, so there can be more of them
+    // in flight than there are hardware threads. Every thread reuses its
+    // connections to the servers for its later requests.
+    unsigned NumThreads = MaxConcurrentRequests
+                              ? std::min<size_t>(MaxConcurrentRequests,
+                                                 IDs.size())
+                              : 0;
+    DefaultThreadPool Pool(hardware_concurrency(NumThreads));
+    for (size_t I = 0; I < IDs.size(); ++I)
+      Pool.async(
+          [&, I] { Paths[I].emplace(getCachedOrDownloadDebuginfo(IDs[I])); });
+    Pool.wait();
+  } else if (!IDs.empty()) {
+    Paths.front().emplace(getCachedOrDownloadDebuginfo(IDs.front()));
+  }
+
+  std::vector<Expected<std::string>> Result;
+  Result.reserve(IDs.size());
+  for (std::optional<Expected<std::string>> &Path : Paths)
+    Result.push_back(std::move(*Path));
+  return Result;
+}
+
 // General fetching function.
 Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
                                                   StringRef UrlPath) {
@@ -248,6 +287,38 @@ static SmallVector<std::string, 0> getHeaders() {
   return Headers;
 }
 
+// Returns the contents of the negative cache entry for the given servers. The
+// entry is only valid for the servers it was created for.
+static std::string getCacheMissContents(ArrayRef<StringRef> DebuginfodUrls) {
+  std::string Contents;
+  for (StringRef ServerUrl : DebuginfodUrls)
+    (Contents += ServerUrl) += '\n';
+  return Contents;
+}
+
+// Returns true if the negative cache entry at CacheMissPath shows that none
+// of the servers had the artifact recently.
+static bool isCachedMiss(StringRef CacheMissPath,
+                         ArrayRef<StringRef> DebuginfodUrls) {
+  std::chrono::seconds CacheMissTimeout =
+      getDefaultDebuginfodCacheMissTimeout();
+  if (CacheMissTimeout.count() == 0)
+    return false;
+
+  sys::fs::file_status Status;
+  if (sys::fs::status(CacheMissPath, Status))
+    return false;
+  auto Age = std::chrono::system_clock::now() -
+             Status.getLastModificationTime();
+  if (Age < std::chrono::seconds(0) || Age > CacheMissTimeout)
+    return false;
+
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Entry =
+      MemoryBuffer::getFile(CacheMissPath, /*IsText=*/true);
+  return Entry &&
+         (*Entry)->getBuffer() == getCacheMissContents(DebuginfodUrls);
+}
+
 Expected<std::string> getCachedOrDownloadArtifact(
     StringRef UniqueKey, StringRef UrlPath, StringRef CacheDirectoryPath,
     ArrayRef<StringRef> DebuginfodUrls, std::chrono::milliseconds Timeout) {
@@ -269,6 +340,16 @@ Expected<std::string> getCachedOrDownloadArtifact(
   AddStreamFn &CacheAddStream = *CacheAddStreamOrErr;
   if (!CacheAddStream)
     return std::string(AbsCachedArtifactPath);
+
+  // Don't query the servers again if none of them had the artifact recently.
+  // The negative cache entries share the prefix of the cached artifacts, so
+  // they are pruned with them.
+  SmallString<64> CacheMissPath(AbsCachedArtifactPath);
+  CacheMissPath += ".miss";
+  if (!DebuginfodUrls.empty() && isCachedMiss(CacheMissPath, DebuginfodUrls))
+    return createStringError(errc::argument_out_of_domain,
+                             "build id not found");
+
   // The artifact was not found in the local cache, query the debuginfod
   // servers.
   if (!HTTPClient::isAvailable())
@@ -282,8 +363,16 @@ Expected<std::string> getCachedOrDownloadArtifact(
         "allow Debuginfod to make HTTP requests, call HTTPClient::initialize() "
         "at the beginning of main.");
 
-  HTTPClient Client;
+  // Reuse the client of this thread, so that its connections to the servers
+  // are reused as well.
+  static thread_local std::optional<HTTPClient> ThreadClient;
+  if (!ThreadClient)
+    ThreadClient.emplace();
+  HTTPClient &Client = *ThreadClient;
   Client.setTimeout(Timeout);
+  // Only record a miss if all servers answered that they don't have the
+  // artifact, not if some of them failed.
+  bool AllNotFound = true;
   for (StringRef ServerUrl : DebuginfodUrls) {
     SmallString<64> ArtifactUrl;
     sys::path::append(ArtifactUrl, sys::path::Style::posix, ServerUrl, UrlPath);
@@ -300,8 +389,10 @@ Expected<std::string> getCachedOrDownloadArtifact(
         return std::move(Err);
 
       unsigned Code = Client.responseCode();
-      if (Code && Code != 200)
+      if (Code && Code != 200) {
+        AllNotFound &= Code == 404;
         continue;
+      }
     }
 
     Expected<CachePruningPolicy> PruningPolicyOrErr =
@@ -314,6 +405,17 @@ Expected<std::string> getCachedOrDownloadArtifact(
     return std::string(AbsCachedArtifactPath);
   }
 
+  if (AllNotFound && !DebuginfodUrls.empty() &&
+      getDefaultDebuginfodCacheMissTimeout().count() != 0 &&
+      !sys::fs::create_directories(CacheDirectoryPath)) {
+    // Failing to record the miss only means that the servers will be queried
+    // again next time.
+    consumeError(writeToOutput(CacheMissPath, [&](raw_ostream &OS) {
+      OS << getCacheMissContents(DebuginfodUrls);
+      return Error::success();
+    }));
+  }
+
   return createStringError(errc::argument_out_of_domain, "build id not found");
 }
 
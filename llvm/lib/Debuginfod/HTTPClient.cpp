@@ -20,6 +20,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #ifdef LLVM_ENABLE_CURL
 #include <curl/curl.h>
+#include <mutex>
 #endif
 
 using namespace llvm;
@@ -45,15 +46,41 @@ static const HTTPClientCleanup Cleanup;
 
 bool HTTPClient::isAvailable() { return true; }
 
+/// The DNS lookups and TLS sessions are shared by all clients, so that clients
+/// on different threads don't redo them for the same server. The connection
+/// cache isn't shared, libcurl doesn't support sharing it between threads.
+static CURLSH *CurlShare = nullptr;
+static std::mutex CurlShareMutexes[CURL_LOCK_DATA_LAST];
+
+static void curlLockFunction(CURL *, curl_lock_data Data, curl_lock_access,
+                             void *) {
+  CurlShareMutexes[Data].lock();
+}
+
+static void curlUnlockFunction(CURL *, curl_lock_data Data, void *) {
+  CurlShareMutexes[Data].unlock();
+}
+
 void HTTPClient::initialize() {
   if (!IsInitialized) {
     curl_global_init(CURL_GLOBAL_ALL);
+    CurlShare = curl_share_init();
+    if (CurlShare) {
+      curl_share_setopt(CurlShare, CURLSHOPT_LOCKFUNC, curlLockFunction);
+      curl_share_setopt(CurlShare, CURLSHOPT_UNLOCKFUNC, curlUnlockFunction);
+      curl_share_setopt(CurlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+      curl_share_setopt(CurlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
     IsInitialized = true;
   }
 }
 
 void HTTPClient::cleanup() {
   if (IsInitialized) {
+    if (CurlShare) {
+      curl_share_cleanup(CurlShare);
+      CurlShare = nullptr;
+    }
     curl_global_cleanup();
     IsInitialized = false;
   }
@@ -99,6 +126,13 @@ HTTPClient::HTTPClient() {
   curl_easy_setopt(Curl, CURLOPT_WRITEFUNCTION, curlWriteFunction);
   // Detect supported compressed encodings and accept all.
   curl_easy_setopt(Curl, CURLOPT_ACCEPT_ENCODING, "");
+  // Keep the connections alive so that they can be reused by later requests.
+  curl_easy_setopt(Curl, CURLOPT_TCP_KEEPALIVE, 1L);
+#if LIBCURL_VERSION_NUM >= 0x072f00
+  curl_easy_setopt(Curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+  if (CurlShare)
+    curl_easy_setopt(Curl, CURLOPT_SHARE, CurlShare);
 }
 
 HTTPClient::~HTTPClient() { curl_easy_cleanup(Curl); }
@@ -14,6 +14,9 @@
 #define LIB_EXECUTIONENGINE_JITLINK_JITLINKGENERIC_H
 
 #include "llvm/ExecutionEngine/JITLink/JITLink.h"
+#include "llvm/Support/Parallel.h"
+
+#include <mutex>
 
 #define DEBUG_TYPE "jitlink"
 
@@ -132,46 +135,77 @@ private:
   Error fixUpBlocks(LinkGraph &G) const override {
     LLVM_DEBUG(dbgs() << "Fixing up blocks:\n");
 
+    std::vector<Block *> Blocks;
+    size_t NumEdges = 0;
     for (auto &Sec : G.sections()) {
       bool NoAllocSection = Sec.getMemLifetime() == orc::MemLifetime::NoAlloc;
 
       for (auto *B : Sec.blocks()) {
-        LLVM_DEBUG(dbgs() << "  " << *B << ":\n");
-
-        // Copy Block data and apply fixups.
-        LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
-        assert((!B->isZeroFill() || all_of(B->edges(),
-                                           [](const Edge &E) {
-                                             return E.getKind() ==
-                                                    Edge::KeepAlive;
-                                           })) &&
-               "Non-KeepAlive edges in zero-fill block?");
-
         // If this is a no-alloc section then copy the block content into
         // memory allocated on the Graph's allocator (if it hasn't been
-        // already).
+        // already). The allocator isn't thread safe, so this is done before
+        // any fixup is applied.
         if (NoAllocSection)
           (void)B->getMutableContent(G);
 
-        for (auto &E : B->edges()) {
-
-          // Skip non-relocation edges.
-          if (!E.isRelocation())
-            continue;
+        Blocks.push_back(B);
+        NumEdges += B->edges_size();
+      }
+    }
 
-          // If B is a block in a Standard or Finalize section then make sure
-          // that no edges point to symbols in NoAlloc sections.
-          assert((NoAllocSection || !E.getTarget().isDefined() ||
-                  E.getTarget().getBlock().getSection().getMemLifetime() !=
-                      orc::MemLifetime::NoAlloc) &&
-                 "Block in allocated section has edge pointing to no-alloc "
-                 "section");
+    // Fixups only write to the content of their own block, so the blocks of
+    // large graphs are fixed up in parallel.
+    if (NumEdges < ParallelFixupThreshold) {
+      for (auto *B : Blocks)
+        if (auto Err = fixUpBlock(G, *B))
+          return Err;
+      return Error::success();
+    }
 
-          // Dispatch to LinkerImpl for fixup.
-          if (auto Err = impl().applyFixup(G, *B, E))
-            return Err;
-        }
+    std::mutex ErrMutex;
+    Error Err = Error::success();
+    parallelFor(0, Blocks.size(), [&](size_t I) {
+      if (auto BlockErr = fixUpBlock(G, *Blocks[I])) {
+        std::lock_guard<std::mutex> Lock(ErrMutex);
+        Err = joinErrors(std::move(Err), std::move(BlockErr));
       }
+    });
+    return Err;
+  }
+
+  /// The number of edges from which a graph is fixed up in parallel.
+  static constexpr size_t ParallelFixupThreshold = 1 << 16;
+
+  Error fixUpBlock(LinkGraph &G, Block &B) const {
+    LLVM_DEBUG(dbgs() << "  " << B << ":\n");
+
+    // Copy Block data and apply fixups.
+    LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
+    assert((!B.isZeroFill() || all_of(B.edges(),
+                                      [](const Edge &E) {
+                                        return E.getKind() == Edge::KeepAlive;
+                                      })) &&
+           "Non-KeepAlive edges in zero-fill block?");
+
+    bool NoAllocSection =
+        B.getSection().getMemLifetime() == orc::MemLifetime::NoAlloc;
+    for (auto &E : B.edges()) {
+
+      // Skip non-relocation edges.
+      if (!E.isRelocation())
+        continue;
+
+      // If B is a block in a Standard or Finalize section then make sure
+      // that no edges point to symbols in NoAlloc sections.
+      assert((NoAllocSection || !E.getTarget().isDefined() ||
+              E.getTarget().getBlock().getSection().getMemLifetime() !=
+                  orc::MemLifetime::NoAlloc) &&
+             "Block in allocated section has edge pointing to no-alloc "
+             "section");
+
+      // Dispatch to LinkerImpl for fixup.
+      if (auto Err = impl().applyFixup(G, B, E))
+        return Err;
     }
 
     return Error::success();
@@ -445,10 +445,17 @@ void DebugObjectManagerPlugin::modifyPassConfig(
 
 Error DebugObjectManagerPlugin::notifyEmitted(
     MaterializationResponsibility &MR) {
-  std::lock_guard<std::mutex> Lock(PendingObjsLock);
-  auto It = PendingObjs.find(&MR);
-  if (It == PendingObjs.end())
-    return Error::success();
+  // Take the debug object out of the pending ones, so that the objects of
+  // other MaterializationResponsibilities can be registered at the same time.
+  OwnedDebugObject DebugObj;
+  {
+    std::lock_guard<std::mutex> Lock(PendingObjsLock);
+    auto It = PendingObjs.find(&MR);
+    if (It == PendingObjs.end())
+      return Error::success();
+    DebugObj = std::move(It->second);
+    PendingObjs.erase(It);
+  }
 
   // During finalization the debug object is registered with the target.
   // Materialization must wait for this process to finish. Otherwise we might
@@ -457,8 +464,9 @@ Error DebugObjectManagerPlugin::notifyEmitted(
   std::promise<MSVCPError> FinalizePromise;
   std::future<MSVCPError> FinalizeErr = FinalizePromise.get_future();
 
-  It->second->finalizeAsync(
-      [this, &FinalizePromise, &MR](Expected<ExecutorAddrRange> TargetMem) {
+  DebugObj->finalizeAsync(
+      [this, &FinalizePromise, &MR,
+       &DebugObj](Expected<ExecutorAddrRange> TargetMem) {
         // Any failure here will fail materialization.
         if (!TargetMem) {
           FinalizePromise.set_value(TargetMem.takeError());
@@ -473,10 +481,8 @@ Error DebugObjectManagerPlugin::notifyEmitted(
         // Once our tracking info is updated, notifyEmitted() can return and
         // finish materialization.
         FinalizePromise.set_value(MR.withResourceKeyDo([&](ResourceKey K) {
-          assert(PendingObjs.count(&MR) && "We still hold PendingObjsLock");
           std::lock_guard<std::mutex> Lock(RegisteredObjsLock);
-          RegisteredObjs[K].push_back(std::move(PendingObjs[&MR]));
-          PendingObjs.erase(&MR);
+          RegisteredObjs[K].push_back(std::move(DebugObj));
         }));
       });
 
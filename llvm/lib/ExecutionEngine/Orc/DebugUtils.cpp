@@ -292,10 +292,12 @@ raw_ostream &operator<<(raw_ostream &OS, const SymbolState &S) {
 }
 
 raw_ostream &operator<<(raw_ostream &OS, const SymbolStringPool &SSP) {
-  std::lock_guard<std::mutex> Lock(SSP.PoolMutex);
   SmallVector<std::pair<StringRef, int>, 0> Vec;
-  for (auto &KV : SSP.Pool)
-    Vec.emplace_back(KV.first(), KV.second);
+  for (auto &Sh : SSP.Shards) {
+    std::lock_guard<std::mutex> Lock(Sh.Mutex);
+    for (auto &KV : Sh.Map)
+      Vec.emplace_back(KV.first(), KV.second);
+  }
   llvm::sort(Vec, less_first());
   for (auto &[K, V] : Vec)
     OS << K << ": " << V << "\n";
@@ -11,6 +11,9 @@
 #include "llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/Orc/OrcABISupport.h"
 #include "llvm/ExecutionEngine/Orc/Shared/SimplePackedSerialization.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Triple.h"
 
 #define DEBUG_TYPE "orc"
@@ -280,13 +283,15 @@ private:
   std::mutex M;
 };
 
+LazyReexportsManager::Listener::~Listener() = default;
+
 Expected<std::unique_ptr<LazyReexportsManager>>
 LazyReexportsManager::Create(EmitTrampolinesFn EmitTrampolines,
                              RedirectableSymbolManager &RSMgr,
-                             JITDylib &PlatformJD) {
+                             JITDylib &PlatformJD, Listener *L) {
   Error Err = Error::success();
   std::unique_ptr<LazyReexportsManager> LRM(new LazyReexportsManager(
-      std::move(EmitTrampolines), RSMgr, PlatformJD, Err));
+      std::move(EmitTrampolines), RSMgr, PlatformJD, L, Err));
   if (Err)
     return std::move(Err);
   return std::move(LRM);
@@ -328,9 +333,10 @@ void LazyReexportsManager::handleTransferResources(JITDylib &JD,
 
 LazyReexportsManager::LazyReexportsManager(EmitTrampolinesFn EmitTrampolines,
                                            RedirectableSymbolManager &RSMgr,
-                                           JITDylib &PlatformJD, Error &Err)
+                                           JITDylib &PlatformJD, Listener *L,
+                                           Error &Err)
     : ES(PlatformJD.getExecutionSession()),
-      EmitTrampolines(std::move(EmitTrampolines)), RSMgr(RSMgr) {
+      EmitTrampolines(std::move(EmitTrampolines)), RSMgr(RSMgr), L(L) {
 
   using namespace shared;
 
@@ -397,6 +403,9 @@ void LazyReexportsManager::emitRedirectableSymbols(
     return;
   }
 
+  if (L)
+    L->onLazyReexportsCreated(MR->getTargetJITDylib(), Reexports);
+
   RSMgr.emitRedirectableSymbols(std::move(MR), std::move(Redirs));
 }
 
@@ -415,6 +424,12 @@ void LazyReexportsManager::resolve(ResolveSendResultFn SendResult,
     LandingInfo = I->second;
   });
 
+  if (!LandingInfo.JD)
+    return;
+
+  if (L)
+    L->onLazyReexportCalled(*LandingInfo.JD, LandingInfo.BodyName);
+
   SymbolInstance LandingSym(LandingInfo.JD, std::move(LandingInfo.BodyName));
   LandingSym.lookupAsync([this, JD = std::move(LandingInfo.JD),
                           ReentryName = std::move(LandingInfo.Name),
@@ -432,5 +447,119 @@ void LazyReexportsManager::resolve(ResolveSendResultFn SendResult,
   });
 }
 
+CallOrderSpeculator::CallOrderSpeculator(ExecutionSession &ES,
+                                         std::vector<std::string> RecordedOrder)
+    : ES(ES) {
+  for (size_t I = 0, E = RecordedOrder.size(); I != E; ++I)
+    RecordedIndex.try_emplace(RecordedOrder[I], I);
+}
+
+void CallOrderSpeculator::onLazyReexportsCreated(
+    JITDylib &JD, const SymbolAliasMap &Reexports) {
+  {
+    std::lock_guard<std::mutex> Lock(M);
+    for (auto &[Name, AI] : Reexports) {
+      auto I = RecordedIndex.find(*AI.Aliasee);
+      if (I == RecordedIndex.end() || Called.contains(*AI.Aliasee))
+        continue;
+      Pending.try_emplace(I->second, PendingFunction{&JD, AI.Aliasee});
+      // Speculate every function at most once.
+      RecordedIndex.erase(I);
+    }
+  }
+  speculateNext();
+}
+
+void CallOrderSpeculator::onLazyReexportCalled(
+    JITDylib &JD, const SymbolStringPtr &BodyName) {
+  std::lock_guard<std::mutex> Lock(M);
+  if (!Called.insert(*BodyName).second)
+    return;
+  CallOrder.push_back((*BodyName).str());
+
+  // The function is being looked up for real now.
+  auto I = RecordedIndex.find(*BodyName);
+  if (I != RecordedIndex.end()) {
+    Pending.erase(I->second);
+    RecordedIndex.erase(I);
+  } else {
+    for (auto J = Pending.begin(), E = Pending.end(); J != E; ++J) {
+      if (J->second.Name == BodyName && J->second.JD.get() == &JD) {
+        Pending.erase(J);
+        break;
+      }
+    }
+  }
+}
+
+void CallOrderSpeculator::speculateNext() {
+  PendingFunction Next;
+  {
+    std::lock_guard<std::mutex> Lock(M);
+    if (LookupInFlight || Pending.empty())
+      return;
+    Next = std::move(Pending.begin()->second);
+    Pending.erase(Pending.begin());
+    LookupInFlight = true;
+  }
+
+  // Look the functions up one at a time, so that they are compiled in the
+  // recorded order, and from idle tasks, so that they don't delay the work
+  // the program waits for.
+  auto Lookup = [this, Next = std::move(Next)]() {
+    ES.lookup(
+        LookupKind::Static,
+        makeJITDylibSearchOrder(Next.JD.get(),
+                                JITDylibLookupFlags::MatchAllSymbols),
+        SymbolLookupSet(Next.Name, SymbolLookupFlags::WeaklyReferencedSymbol),
+        SymbolState::Ready,
+        [this](Expected<SymbolMap> Result) {
+          if (!Result)
+            ES.reportError(Result.takeError());
+          {
+            std::lock_guard<std::mutex> Lock(M);
+            LookupInFlight = false;
+          }
+          speculateNext();
+        },
+        NoDependenciesToRegister);
+  };
+  ES.dispatchTask(
+      makeIdleTask(makeGenericNamedTask(std::move(Lookup), "Speculation")));
+}
+
+std::vector<std::string> CallOrderSpeculator::getCallOrder() {
+  std::lock_guard<std::mutex> Lock(M);
+  return CallOrder;
+}
+
+Expected<std::vector<std::string>>
+CallOrderSpeculator::readCallOrder(StringRef Path) {
+  auto Buf = MemoryBuffer::getFile(Path, /*IsText=*/true);
+  if (!Buf)
+    return createFileError(Path, Buf.getError());
+
+  std::vector<std::string> Order;
+  SmallVector<StringRef> Lines;
+  (*Buf)->getBuffer().split(Lines, '\n', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (StringRef Line : Lines)
+    Order.push_back(Line.str());
+  return Order;
+}
+
+Error CallOrderSpeculator::writeCallOrder(StringRef Path,
+                                         ArrayRef<std::string> Order) {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::OF_TextWithCRLF);
+  if (EC)
+    return createFileError(Path, EC);
+  for (const std::string &Name : Order)
+    OS << Name << '\n';
+  OS.close();
+  if (OS.has_error())
+    return createFileError(Path, OS.error());
+  return Error::success();
+}
+
 } // End namespace orc.
 } // End namespace llvm.
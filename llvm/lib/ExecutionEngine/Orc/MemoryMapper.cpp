@@ -29,22 +29,26 @@ namespace orc {
 
 MemoryMapper::~MemoryMapper() {}
 
-InProcessMemoryMapper::InProcessMemoryMapper(size_t PageSize)
-    : PageSize(PageSize) {}
+InProcessMemoryMapper::InProcessMemoryMapper(size_t PageSize,
+                                             bool UseHugePages)
+    : PageSize(PageSize), UseHugePages(UseHugePages) {}
 
 Expected<std::unique_ptr<InProcessMemoryMapper>>
-InProcessMemoryMapper::Create() {
+InProcessMemoryMapper::Create(bool UseHugePages) {
   auto PageSize = sys::Process::getPageSize();
   if (!PageSize)
     return PageSize.takeError();
-  return std::make_unique<InProcessMemoryMapper>(*PageSize);
+  return std::make_unique<InProcessMemoryMapper>(*PageSize, UseHugePages);
 }
 
 void InProcessMemoryMapper::reserve(size_t NumBytes,
                                     OnReservedFunction OnReserved) {
+  unsigned Flags = sys::Memory::MF_READ | sys::Memory::MF_WRITE;
+  if (UseHugePages)
+    Flags |= sys::Memory::MF_HUGE_HINT;
+
   std::error_code EC;
-  auto MB = sys::Memory::allocateMappedMemory(
-      NumBytes, nullptr, sys::Memory::MF_READ | sys::Memory::MF_WRITE, EC);
+  auto MB = sys::Memory::allocateMappedMemory(NumBytes, nullptr, Flags, EC);
 
   if (EC)
     return OnReserved(errorCodeToError(EC));
@@ -67,6 +71,15 @@ void InProcessMemoryMapper::initialize(MemoryMapper::AllocInfo &AI,
   ExecutorAddr MinAddr(~0ULL);
   ExecutorAddr MaxAddr(0);
 
+  // The ranges to protect. Adjacent segments with the same protections are
+  // merged, so that they only need one call to protectMappedMemory.
+  struct ProtectRange {
+    ExecutorAddr Base;
+    size_t Size;
+    MemProt Prot;
+  };
+  SmallVector<ProtectRange, 4> Ranges;
+
   // FIXME: Release finalize lifetime segments.
   for (auto &Segment : AI.Segments) {
     auto Base = AI.MappingBase + Segment.Offset;
@@ -81,13 +94,24 @@ void InProcessMemoryMapper::initialize(MemoryMapper::AllocInfo &AI,
     std::memset((Base + Segment.ContentSize).toPtr<void *>(), 0,
                 Segment.ZeroFillSize);
 
+    MemProt Prot = Segment.AG.getMemProt();
+    if (!Ranges.empty() && Ranges.back().Prot == Prot &&
+        alignTo(Ranges.back().Base.getValue() + Ranges.back().Size,
+                PageSize) == Base.getValue()) {
+      Ranges.back().Size = Base + Size - Ranges.back().Base;
+      continue;
+    }
+    Ranges.push_back({Base, Size, Prot});
+  }
+
+  for (auto &R : Ranges) {
     if (auto EC = sys::Memory::protectMappedMemory(
-            {Base.toPtr<void *>(), Size},
-            toSysMemoryProtectionFlags(Segment.AG.getMemProt()))) {
+            {R.Base.toPtr<void *>(), R.Size},
+            toSysMemoryProtectionFlags(R.Prot))) {
       return OnInitialized(errorCodeToError(EC));
     }
-    if ((Segment.AG.getMemProt() & MemProt::Exec) == MemProt::Exec)
-      sys::Memory::InvalidateInstructionCache(Base.toPtr<void *>(), Size);
+    if ((R.Prot & MemProt::Exec) == MemProt::Exec)
+      sys::Memory::InvalidateInstructionCache(R.Base.toPtr<void *>(), R.Size);
   }
 
   auto DeinitializeActions = shared::runFinalizeActions(AI.Actions);
@@ -0,0 +1,147 @@
+//===------ PersistentObjectCache.cpp - On-disk object cache --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/BLAKE3.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace orc {
+
+Expected<std::unique_ptr<PersistentObjectCache>>
+PersistentObjectCache::Create(StringRef CacheDir,
+                              const JITTargetMachineBuilder &JTMB,
+                              StringRef ExtraKey, CachePruningPolicy Policy) {
+  if (std::error_code EC =
+          sys::fs::create_directories(CacheDir, /*IgnoreExisting=*/true))
+    return createFileError(CacheDir, EC);
+
+  std::string OptionsKey;
+  raw_string_ostream OS(OptionsKey);
+  OS << JTMB.getTargetTriple().str() << '\0' << JTMB.getCPU() << '\0'
+     << JTMB.getFeatures().getString() << '\0'
+     << static_cast<int>(JTMB.getCodeGenOptLevel()) << '\0';
+  if (const auto &RM = JTMB.getRelocationModel())
+    OS << static_cast<int>(*RM);
+  OS << '\0';
+  if (const auto &CM = JTMB.getCodeModel())
+    OS << static_cast<int>(*CM);
+  OS << '\0' << ExtraKey;
+
+  // Drop the stale entries before the first lookup.
+  pruneCache(CacheDir, Policy);
+
+  return std::unique_ptr<PersistentObjectCache>(
+      new PersistentObjectCache(CacheDir, std::move(OptionsKey), Policy));
+}
+
+PersistentObjectCache::PersistentObjectCache(StringRef CacheDir,
+                                             std::string OptionsKey,
+                                             CachePruningPolicy Policy)
+    : CacheDir(CacheDir), OptionsKey(std::move(OptionsKey)), Policy(Policy) {}
+
+std::string PersistentObjectCache::getKey(const Module &M) const {
+  SmallString<0> Bitcode;
+  raw_svector_ostream OS(Bitcode);
+  WriteBitcodeToFile(M, OS);
+
+  BLAKE3 Hasher;
+  Hasher.update(OptionsKey);
+  Hasher.update(Bitcode);
+  return toHex(Hasher.final());
+}
+
+std::string PersistentObjectCache::getEntryPath(StringRef Key) const {
+  // This choice of file name allows the cache to be pruned (see pruneCache()
+  // in include/llvm/Support/CachePruning.h).
+  SmallString<128> EntryPath(CacheDir);
+  sys::path::append(EntryPath, "llvmcache-" + Key);
+  return std::string(EntryPath);
+}
+
+std::unique_ptr<MemoryBuffer>
+PersistentObjectCache::getObject(const Module *M) {
+  std::string Key = getKey(*M);
+  std::string EntryPath = getEntryPath(Key);
+
+  Expected<sys::fs::file_t> FDOrErr =
+      sys::fs::openNativeFileForRead(EntryPath, sys::fs::OF_UpdateAtime);
+  if (FDOrErr) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr = MemoryBuffer::getOpenFile(
+        *FDOrErr, M->getModuleIdentifier(), /*FileSize=*/-1,
+        /*RequiresNullTerminator=*/false);
+    sys::fs::closeFile(*FDOrErr);
+    if (MBOrErr)
+      return std::move(*MBOrErr);
+  } else {
+    consumeError(FDOrErr.takeError());
+  }
+
+  // Remember the key, so that the module doesn't need to be hashed again once
+  // it has been compiled.
+  std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+  PendingKeys[M] = std::move(Key);
+  return nullptr;
+}
+
+void PersistentObjectCache::notifyObjectCompiled(const Module *M,
+                                                 MemoryBufferRef Obj) {
+  std::string Key;
+  {
+    std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+    auto It = PendingKeys.find(M);
+    if (It != PendingKeys.end()) {
+      Key = std::move(It->second);
+      PendingKeys.erase(It);
+    }
+  }
+  if (Key.empty())
+    Key = getKey(*M);
+
+  // Write to a temporary file first, so that other processes never see a
+  // partially written entry. The cache is best effort: if the entry can't be
+  // written, the module is compiled again next time.
+  SmallString<128> TempFileModel(CacheDir);
+  sys::path::append(TempFileModel, "objcache-%%%%%%.tmp.o");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+      TempFileModel, sys::fs::owner_read | sys::fs::owner_write);
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    OS << Obj.getBuffer();
+    OS.flush();
+    if (OS.has_error()) {
+      OS.clear_error();
+      consumeError(Temp->discard());
+      return;
+    }
+  }
+  // On failure, keep() removes the temporary file itself.
+  if (Error Err = Temp->keep(getEntryPath(Key))) {
+    consumeError(std::move(Err));
+    return;
+  }
+
+  // The pruning interval of the policy keeps this from scanning the directory
+  // after every compilation.
+  pruneCache(CacheDir, Policy);
+}
+
+} // end namespace orc
+} // end namespace llvm
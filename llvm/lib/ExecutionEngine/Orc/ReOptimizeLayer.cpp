@@ -1,5 +1,6 @@
 #include "llvm/ExecutionEngine/Orc/ReOptimizeLayer.h"
 #include "llvm/ExecutionEngine/Orc/Mangling.h"
+#include "llvm/Passes/PassBuilder.h"
 
 using namespace llvm;
 using namespace orc;
@@ -61,6 +62,7 @@ void ReOptimizeLayer::emit(std::unique_ptr<MaterializationResponsibility> R,
     return;
   }
 
+  auto StartTime = std::chrono::steady_clock::now();
   if (auto Err =
           ProfilerFunc(*this, MUState.getID(), MUState.getCurVersion(), TSM)) {
     ES.reportError(std::move(Err));
@@ -76,6 +78,12 @@ void ReOptimizeLayer::emit(std::unique_ptr<MaterializationResponsibility> R,
     return;
   }
 
+  {
+    std::lock_guard<std::mutex> Lock(StatsMutex);
+    ++Stats.NumInitialCompiles;
+    Stats.InitialCompileTime += std::chrono::steady_clock::now() - StartTime;
+  }
+
   RSManager.emitRedirectableSymbols(std::move(R), std::move(*InitialDests));
 }
 
@@ -100,7 +108,8 @@ Error ReOptimizeLayer::reoptimizeIfCallFrequent(ReOptimizeLayer &Parent,
       auto &BB = F.getEntryBlock();
       auto *IP = &*BB.getFirstInsertionPt();
       IRBuilder<> IRB(IP);
-      Value *Threshold = ConstantInt::get(I64Ty, CallCountThreshold, true);
+      Value *Threshold =
+          ConstantInt::get(I64Ty, Parent.getCallCountThreshold(), true);
       Value *Cnt = IRB.CreateLoad(I64Ty, Counter);
       // Use EQ to prevent further reoptimize calls.
       Value *Cmp = IRB.CreateICmpEQ(Cnt, Threshold);
@@ -158,41 +167,76 @@ ReOptimizeLayer::emitMUImplSymbols(ReOptMaterializationUnitState &MUState,
 void ReOptimizeLayer::rt_reoptimize(SendErrorFn SendResult,
                                     ReOptMaterializationUnitID MUID,
                                     uint32_t CurVersion) {
-  auto &MUState = getMaterializationUnitState(MUID);
-  if (CurVersion < MUState.getCurVersion() || !MUState.tryStartReoptimize()) {
+  if (!ReoptimizeInBackground) {
+    reoptimize(MUID, CurVersion);
     SendResult(Error::success());
     return;
   }
 
+  SendResult(Error::success());
+  ES.dispatchTask(makeGenericNamedTask(
+      [this, MUID, CurVersion]() { reoptimize(MUID, CurVersion); },
+      "ReOptimizeLayer reoptimization"));
+}
+
+void ReOptimizeLayer::reoptimize(ReOptMaterializationUnitID MUID,
+                                 uint32_t CurVersion) {
+  auto &MUState = getMaterializationUnitState(MUID);
+  if (CurVersion < MUState.getCurVersion() || !MUState.tryStartReoptimize())
+    return;
+
+  auto StartTime = std::chrono::steady_clock::now();
+  auto Fail = [&](Error Err) {
+    ES.reportError(std::move(Err));
+    MUState.reoptimizeFailed();
+    std::lock_guard<std::mutex> Lock(StatsMutex);
+    ++Stats.NumFailedReoptimizations;
+  };
+
   ThreadSafeModule TSM = cloneToNewContext(MUState.getThreadSafeModule());
   auto OldRT = MUState.getResourceTracker();
   auto &JD = OldRT->getJITDylib();
 
-  if (auto Err = ReOptFunc(*this, MUID, CurVersion + 1, OldRT, TSM)) {
-    ES.reportError(std::move(Err));
-    MUState.reoptimizeFailed();
-    SendResult(Error::success());
-    return;
-  }
+  if (auto Err = ReOptFunc(*this, MUID, CurVersion + 1, OldRT, TSM))
+    return Fail(std::move(Err));
 
   auto SymbolDests =
       emitMUImplSymbols(MUState, CurVersion + 1, JD, std::move(TSM));
-  if (!SymbolDests) {
-    ES.reportError(SymbolDests.takeError());
-    MUState.reoptimizeFailed();
-    SendResult(Error::success());
-    return;
-  }
+  if (!SymbolDests)
+    return Fail(SymbolDests.takeError());
 
-  if (auto Err = RSManager.redirect(JD, std::move(*SymbolDests))) {
-    ES.reportError(std::move(Err));
-    MUState.reoptimizeFailed();
-    SendResult(Error::success());
-    return;
-  }
+  if (auto Err = RSManager.redirect(JD, std::move(*SymbolDests)))
+    return Fail(std::move(Err));
 
   MUState.reoptimizeSucceeded();
-  SendResult(Error::success());
+  std::lock_guard<std::mutex> Lock(StatsMutex);
+  ++Stats.NumReoptimizations;
+  Stats.ReoptimizeCompileTime += std::chrono::steady_clock::now() - StartTime;
+}
+
+ReOptimizeLayer::ReOptimizeFunc
+ReOptimizeLayer::createOptimizeFunc(OptimizationLevel Level) {
+  return [Level](ReOptimizeLayer &Parent, ReOptMaterializationUnitID MUID,
+                 unsigned CurVersion, ResourceTrackerSP OldRT,
+                 ThreadSafeModule &TSM) -> Error {
+    TSM.withModuleDo([&](Module &M) {
+      LoopAnalysisManager LAM;
+      FunctionAnalysisManager FAM;
+      CGSCCAnalysisManager CGAM;
+      ModuleAnalysisManager MAM;
+
+      PassBuilder PB;
+      PB.registerModuleAnalyses(MAM);
+      PB.registerCGSCCAnalyses(CGAM);
+      PB.registerFunctionAnalyses(FAM);
+      PB.registerLoopAnalyses(LAM);
+      PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+      ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(Level);
+      MPM.run(M, MAM);
+    });
+    return Error::success();
+  };
 }
 
 Expected<Constant *> ReOptimizeLayer::createReoptimizeArgBuffer(
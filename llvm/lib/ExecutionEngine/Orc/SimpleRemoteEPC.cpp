@@ -8,6 +8,8 @@
 
 #include "llvm/ExecutionEngine/Orc/SimpleRemoteEPC.h"
 #include "llvm/ExecutionEngine/Orc/EPCGenericJITLinkMemoryManager.h"
+#include "llvm/ExecutionEngine/Orc/MapperJITLinkMemoryManager.h"
+#include "llvm/ExecutionEngine/Orc/MemoryMapper.h"
 #include "llvm/ExecutionEngine/Orc/Shared/OrcRTBridge.h"
 #include "llvm/Support/FormatVariadic.h"
 
@@ -28,37 +30,42 @@ SimpleRemoteEPC::loadDylib(const char *DylibPath) {
   return EPCDylibMgr->open(DylibPath, 0);
 }
 
-/// Async helper to chain together calls to DylibMgr::lookupAsync to fulfill all
-/// all the requests.
-/// FIXME: The dylib manager should support multiple LookupRequests natively.
-static void
-lookupSymbolsAsyncHelper(EPCGenericDylibManager &DylibMgr,
-                         ArrayRef<DylibManager::LookupRequest> Request,
-                         std::vector<tpctypes::LookupResult> Result,
-                         DylibManager::SymbolLookupCompleteFn Complete) {
-  if (Request.empty())
-    return Complete(std::move(Result));
-
-  auto &Element = Request.front();
-  DylibMgr.lookupAsync(Element.Handle, Element.Symbols,
-                       [&DylibMgr, Request, Complete = std::move(Complete),
-                        Result = std::move(Result)](auto R) mutable {
-                         if (!R)
-                           return Complete(R.takeError());
-                         Result.push_back({});
-                         Result.back().reserve(R->size());
-                         for (auto Addr : *R)
-                           Result.back().push_back(Addr);
-
-                         lookupSymbolsAsyncHelper(
-                             DylibMgr, Request.drop_front(), std::move(Result),
-                             std::move(Complete));
-                       });
-}
-
 void SimpleRemoteEPC::lookupSymbolsAsync(ArrayRef<LookupRequest> Request,
                                          SymbolLookupCompleteFn Complete) {
-  lookupSymbolsAsyncHelper(*EPCDylibMgr, Request, {}, std::move(Complete));
+  if (Request.empty())
+    return Complete(std::vector<tpctypes::LookupResult>());
+
+  // Send all the lookups before waiting for any of their results, so that
+  // they cost a single round trip rather than one per request.
+  // FIXME: The dylib manager should support multiple LookupRequests natively.
+  struct LookupState {
+    std::mutex M;
+    std::vector<tpctypes::LookupResult> Results;
+    size_t NumPending = 0;
+    Error Err = Error::success();
+    SymbolLookupCompleteFn Complete;
+  };
+  auto State = std::make_shared<LookupState>();
+  State->Results.resize(Request.size());
+  State->NumPending = Request.size();
+  State->Complete = std::move(Complete);
+
+  for (size_t I = 0; I != Request.size(); ++I)
+    EPCDylibMgr->lookupAsync(
+        Request[I].Handle, Request[I].Symbols, [State, I](auto R) {
+          std::unique_lock<std::mutex> Lock(State->M);
+          if (R)
+            State->Results[I] = std::move(*R);
+          else
+            State->Err = joinErrors(std::move(State->Err), R.takeError());
+          if (--State->NumPending)
+            return;
+          Lock.unlock();
+
+          if (State->Err)
+            return State->Complete(std::move(State->Err));
+          State->Complete(std::move(State->Results));
+        });
 }
 
 Expected<int32_t> SimpleRemoteEPC::runAsMain(ExecutorAddr MainFnAddr,
@@ -225,6 +232,26 @@ SimpleRemoteEPC::createDefaultMemoryManager(SimpleRemoteEPC &SREPC) {
   return std::make_unique<EPCGenericJITLinkMemoryManager>(SREPC, SAs);
 }
 
+Expected<std::unique_ptr<jitlink::JITLinkMemoryManager>>
+SimpleRemoteEPC::createSharedMemoryManager(SimpleRemoteEPC &SREPC,
+                                           size_t SlabSize) {
+  SharedMemoryMapper::SymbolAddrs SAs;
+  if (auto Err = SREPC.getBootstrapSymbols(
+          {{SAs.Instance, rt::ExecutorSharedMemoryMapperServiceInstanceName},
+           {SAs.Reserve,
+            rt::ExecutorSharedMemoryMapperServiceReserveWrapperName},
+           {SAs.Initialize,
+            rt::ExecutorSharedMemoryMapperServiceInitializeWrapperName},
+           {SAs.Deinitialize,
+            rt::ExecutorSharedMemoryMapperServiceDeinitializeWrapperName},
+           {SAs.Release,
+            rt::ExecutorSharedMemoryMapperServiceReleaseWrapperName}}))
+    return std::move(Err);
+
+  return MapperJITLinkMemoryManager::CreateWithMapper<SharedMemoryMapper>(
+      SlabSize, SREPC, SAs);
+}
+
 Expected<std::unique_ptr<ExecutorProcessControl::MemoryAccess>>
 SimpleRemoteEPC::createDefaultMemoryAccess(SimpleRemoteEPC &SREPC) {
   EPCGenericMemoryAccess::FuncAddrs FAs;
@@ -15,18 +15,56 @@ namespace orc {
 
 char Task::ID = 0;
 char GenericNamedTask::ID = 0;
+char IdleTask::ID = 0;
 const char *GenericNamedTask::DefaultDescription = "Generic Task";
 
 void Task::anchor() {}
 TaskDispatcher::~TaskDispatcher() = default;
 
+void IdleTask::printDescription(raw_ostream &OS) {
+  OS << "idle: ";
+  T->printDescription(OS);
+}
+
+void IdleTask::run() {
+  if (!isCancelled())
+    T->run();
+}
+
 void InPlaceTaskDispatcher::dispatch(std::unique_ptr<Task> T) { T->run(); }
 
 void InPlaceTaskDispatcher::shutdown() {}
 
 #if LLVM_ENABLE_THREADS
+DynamicThreadPoolTaskDispatcher::DynamicThreadPoolTaskDispatcher(
+    std::optional<size_t> MaxMaterializationThreads)
+    : MaxMaterializationThreads(MaxMaterializationThreads) {
+  if (MaxMaterializationThreads)
+    MaxIdleAndMaterializationThreads = *MaxMaterializationThreads;
+  else
+    MaxIdleAndMaterializationThreads = std::thread::hardware_concurrency();
+  if (MaxIdleAndMaterializationThreads == 0)
+    MaxIdleAndMaterializationThreads = 1;
+}
+
+std::unique_ptr<Task> DynamicThreadPoolTaskDispatcher::takeIdleTask(
+    std::vector<std::unique_ptr<Task>> &Cancelled) {
+  if (NumIdleThreads + NumMaterializationThreads >=
+      MaxIdleAndMaterializationThreads)
+    return nullptr;
+  while (!IdleTaskQueue.empty()) {
+    std::unique_ptr<Task> T = std::move(IdleTaskQueue.front());
+    IdleTaskQueue.pop_front();
+    if (!cast<IdleTask>(*T).isCancelled())
+      return T;
+    Cancelled.push_back(std::move(T));
+  }
+  return nullptr;
+}
+
 void DynamicThreadPoolTaskDispatcher::dispatch(std::unique_ptr<Task> T) {
   bool IsMaterializationTask = isa<MaterializationTask>(*T);
+  bool IsIdleTask = isa<IdleTask>(*T);
 
   {
     std::lock_guard<std::mutex> Lock(DispatchMutex);
@@ -43,35 +81,70 @@ void DynamicThreadPoolTaskDispatcher::dispatch(std::unique_ptr<Task> T) {
 
       // Otherwise record that we have a materialization task running.
       ++NumMaterializationThreads;
+    } else if (IsIdleTask) {
+      if (cast<IdleTask>(*T).isCancelled())
+        return;
+
+      // Idle tasks wait for the queued materialization tasks and for a free
+      // thread. The threads running now pick them up when they are done.
+      if (!MaterializationTaskQueue.empty() ||
+          NumIdleThreads + NumMaterializationThreads >=
+              MaxIdleAndMaterializationThreads) {
+        IdleTaskQueue.push_back(std::move(T));
+        return;
+      }
+
+      ++NumIdleThreads;
     }
 
     ++Outstanding;
   }
 
-  std::thread([this, T = std::move(T), IsMaterializationTask]() mutable {
+  std::thread([this, T = std::move(T), IsMaterializationTask,
+               IsIdleTask]() mutable {
     while (true) {
 
       // Run the task.
       T->run();
 
+      std::vector<std::unique_ptr<Task>> Cancelled;
       std::lock_guard<std::mutex> Lock(DispatchMutex);
       if (!MaterializationTaskQueue.empty()) {
         // If there are any materialization tasks running then steal that work.
         T = std::move(MaterializationTaskQueue.front());
         MaterializationTaskQueue.pop_front();
+        if (IsIdleTask) {
+          --NumIdleThreads;
+          IsIdleTask = false;
+        }
         if (!IsMaterializationTask) {
           ++NumMaterializationThreads;
           IsMaterializationTask = true;
         }
-      } else {
-        // Otherwise decrement work counters.
-        if (IsMaterializationTask)
-          --NumMaterializationThreads;
-        --Outstanding;
-        if (Outstanding == 0)
-          OutstandingCV.notify_all();
-        return;
+        continue;
       }
+
+      // Otherwise release this thread's slot, and run an idle task if there's
+      // room for one.
+      if (IsMaterializationTask) {
+        --NumMaterializationThreads;
+        IsMaterializationTask = false;
+      }
+      if (IsIdleTask) {
+        --NumIdleThreads;
+        IsIdleTask = false;
+      }
+      if ((T = takeIdleTask(Cancelled))) {
+        ++NumIdleThreads;
+        IsIdleTask = true;
+        continue;
+      }
+
+      // Otherwise decrement work counters.
+      --Outstanding;
+      if (Outstanding == 0)
+        OutstandingCV.notify_all();
+      return;
     }
   }).detach();
 }
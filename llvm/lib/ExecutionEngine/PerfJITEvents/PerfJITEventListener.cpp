@@ -15,6 +15,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Config/config.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
@@ -25,12 +26,15 @@
 #include "llvm/Support/Errno.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
-#include "llvm/Support/Mutex.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <string>
+#include <thread>
 
 #include <sys/mman.h>  // mmap()
 #include <time.h>      // clock_gettime(), time(), localtime_r() */
@@ -60,10 +64,21 @@ class PerfJITEventListener : public JITEventListener {
 public:
   PerfJITEventListener();
   ~PerfJITEventListener() {
+#if LLVM_ENABLE_THREADS
+    // Write the records still pending before closing the file.
+    if (Writer.joinable()) {
+      {
+        std::lock_guard<std::mutex> Guard(Mutex);
+        Stopping = true;
+      }
+      PendingCV.notify_one();
+      Writer.join();
+    }
+#endif
     // Lock a mutex to correctly synchronize with prior calls to
     // `notifyObjectLoaded` and `notifyFreeingObject` that happened on other
     // threads to prevent tsan from complaining.
-    std::lock_guard<sys::Mutex> Guard(Mutex);
+    std::lock_guard<std::mutex> Guard(Mutex);
     if (MarkerAddr)
       CloseMarker();
   }
@@ -78,9 +93,17 @@ private:
   void CloseMarker();
   static bool FillMachine(LLVMPerfJitHeader &hdr);
 
-  void NotifyCode(Expected<llvm::StringRef> &Symbol, uint64_t CodeAddr,
-                  uint64_t CodeSize);
-  void NotifyDebug(uint64_t CodeAddr, DILineInfoTable Lines);
+  void NotifyCode(raw_ostream &OS, Expected<llvm::StringRef> &Symbol,
+                  uint64_t CodeAddr, uint64_t CodeSize);
+  void NotifyDebug(raw_ostream &OS, uint64_t CodeAddr, DILineInfoTable Lines);
+
+  // Queue the records of an object to be written to the dump file.
+  void writeRecords(StringRef Records);
+
+#if LLVM_ENABLE_THREADS
+  // Body of the writer thread, which writes the queued records in batches.
+  void runWriter();
+#endif
 
   // cache lookups
   sys::Process::Pid Pid;
@@ -95,7 +118,18 @@ private:
   std::unique_ptr<raw_fd_ostream> Dumpstream;
 
   // prevent concurrent dumps from messing up the output file
-  sys::Mutex Mutex;
+  std::mutex Mutex;
+
+#if LLVM_ENABLE_THREADS
+  // The records of the objects loaded since the writer thread last woke up.
+  // The objects are formatted by the threads that load them, and the formatted
+  // records are written to the file by the writer thread, so that loading an
+  // object doesn't wait for the file I/O.
+  std::string Pending;
+  std::condition_variable PendingCV;
+  bool Stopping = false;
+  std::thread Writer;
+#endif
 
   // perf mmap marker
   void *MarkerAddr = NULL;
@@ -104,7 +138,7 @@ private:
   bool SuccessfullyInitialized = false;
 
   // identifier for functions, primarily to identify when moving them around
-  uint64_t CodeGeneration = 1;
+  std::atomic<uint64_t> CodeGeneration = 1;
 };
 
 // The following are POD struct definitions from the perf jit specification
@@ -225,8 +259,13 @@ PerfJITEventListener::PerfJITEventListener()
   Dumpstream->write(reinterpret_cast<const char *>(&Header), sizeof(Header));
 
   // Everything initialized, can do profiling now.
-  if (!Dumpstream->has_error())
-    SuccessfullyInitialized = true;
+  if (Dumpstream->has_error())
+    return;
+  SuccessfullyInitialized = true;
+
+#if LLVM_ENABLE_THREADS
+  Writer = std::thread([this]() { runWriter(); });
+#endif
 }
 
 void PerfJITEventListener::notifyObjectLoaded(
@@ -236,6 +275,11 @@ void PerfJITEventListener::notifyObjectLoaded(
   if (!SuccessfullyInitialized)
     return;
 
+  // Format the records in a local buffer, so that the lock is only taken to
+  // queue them.
+  SmallString<0> Records;
+  raw_svector_ostream OS(Records);
+
   OwningBinary<ObjectFile> DebugObjOwner = L.getObjectForDebug(Obj);
   const ObjectFile &DebugObj = *DebugObjOwner.getBinary();
 
@@ -282,15 +326,47 @@ void PerfJITEventListener::notifyObjectLoaded(
     DILineInfoTable Lines = Context->getLineInfoForAddressRange(
         {*AddrOrErr, SectionIndex}, Size, FileLineInfoKind::AbsoluteFilePath);
 
-    NotifyDebug(*AddrOrErr, Lines);
-    NotifyCode(Name, *AddrOrErr, Size);
+    NotifyDebug(OS, *AddrOrErr, Lines);
+    NotifyCode(OS, Name, *AddrOrErr, Size);
   }
 
-  // avoid races with writes
-  std::lock_guard<sys::Mutex> Guard(Mutex);
+  if (!Records.empty())
+    writeRecords(Records);
+}
 
+void PerfJITEventListener::writeRecords(StringRef Records) {
+#if LLVM_ENABLE_THREADS
+  {
+    std::lock_guard<std::mutex> Guard(Mutex);
+    Pending.append(Records.begin(), Records.end());
+  }
+  PendingCV.notify_one();
+#else
+  std::lock_guard<std::mutex> Guard(Mutex);
+  Dumpstream->write(Records.data(), Records.size());
   Dumpstream->flush();
+#endif
+}
+
+#if LLVM_ENABLE_THREADS
+void PerfJITEventListener::runWriter() {
+  std::unique_lock<std::mutex> Lock(Mutex);
+  for (;;) {
+    PendingCV.wait(Lock, [this]() { return Stopping || !Pending.empty(); });
+    if (Pending.empty())
+      return;
+
+    // Write everything that was queued while the previous batch was being
+    // written, without holding the lock.
+    std::string Batch;
+    std::swap(Batch, Pending);
+    Lock.unlock();
+    Dumpstream->write(Batch.data(), Batch.size());
+    Dumpstream->flush();
+    Lock.lock();
+  }
 }
+#endif
 
 void PerfJITEventListener::notifyFreeingObject(ObjectKey K) {
   // perf currently doesn't have an interface for unloading. But munmap()ing the
@@ -404,7 +480,8 @@ bool PerfJITEventListener::FillMachine(LLVMPerfJitHeader &hdr) {
   return true;
 }
 
-void PerfJITEventListener::NotifyCode(Expected<llvm::StringRef> &Symbol,
+void PerfJITEventListener::NotifyCode(raw_ostream &OS,
+                                      Expected<llvm::StringRef> &Symbol,
                                       uint64_t CodeAddr, uint64_t CodeSize) {
   assert(SuccessfullyInitialized);
 
@@ -424,18 +501,14 @@ void PerfJITEventListener::NotifyCode(Expected<llvm::StringRef> &Symbol,
   rec.CodeAddr = CodeAddr;
   rec.Pid = Pid;
   rec.Tid = get_threadid();
+  rec.CodeIndex = CodeGeneration++;
 
-  // avoid interspersing output
-  std::lock_guard<sys::Mutex> Guard(Mutex);
-
-  rec.CodeIndex = CodeGeneration++; // under lock!
-
-  Dumpstream->write(reinterpret_cast<const char *>(&rec), sizeof(rec));
-  Dumpstream->write(Symbol->data(), Symbol->size() + 1);
-  Dumpstream->write(reinterpret_cast<const char *>(CodeAddr), CodeSize);
+  OS.write(reinterpret_cast<const char *>(&rec), sizeof(rec));
+  OS.write(Symbol->data(), Symbol->size() + 1);
+  OS.write(reinterpret_cast<const char *>(CodeAddr), CodeSize);
 }
 
-void PerfJITEventListener::NotifyDebug(uint64_t CodeAddr,
+void PerfJITEventListener::NotifyDebug(raw_ostream &OS, uint64_t CodeAddr,
                                        DILineInfoTable Lines) {
   assert(SuccessfullyInitialized);
 
@@ -467,10 +540,7 @@ void PerfJITEventListener::NotifyDebug(uint64_t CodeAddr,
   // * uint32_t discrim  : column discriminator, 0 is default
   // * char name[n]      : source file name in ASCII, including null termination
 
-  // avoid interspersing output
-  std::lock_guard<sys::Mutex> Guard(Mutex);
-
-  Dumpstream->write(reinterpret_cast<const char *>(&rec), sizeof(rec));
+  OS.write(reinterpret_cast<const char *>(&rec), sizeof(rec));
 
   for (DILineInfoTable::iterator It = Begin; It != End; ++It) {
     LLVMPerfJitDebugEntry LineInfo;
@@ -484,9 +554,8 @@ void PerfJITEventListener::NotifyDebug(uint64_t CodeAddr,
     LineInfo.Lineno = Line.Line;
     LineInfo.Discrim = Line.Discriminator;
 
-    Dumpstream->write(reinterpret_cast<const char *>(&LineInfo),
-                      sizeof(LineInfo));
-    Dumpstream->write(Line.FileName.c_str(), Line.FileName.size() + 1);
+    OS.write(reinterpret_cast<const char *>(&LineInfo), sizeof(LineInfo));
+    OS.write(Line.FileName.c_str(), Line.FileName.size() + 1);
   }
 }
 
@@ -346,6 +346,14 @@ void LLVMContext::setDiscardValueNames(bool Discard) {
   pImpl->DiscardValueNames = Discard;
 }
 
+bool LLVMContext::shouldReferenceBitcodeMDStrings() const {
+  return pImpl->ReferenceBitcodeMDStrings;
+}
+
+void LLVMContext::setReferenceBitcodeMDStrings(bool Reference) {
+  pImpl->ReferenceBitcodeMDStrings = Reference;
+}
+
 OptPassGate &LLVMContext::getOptPassGate() const {
   return pImpl->getOptPassGate();
 }
@@ -1378,6 +1378,35 @@ struct DIArgListInfo {
   }
 };
 
+/// DenseMapInfo for MDString, which can be looked up by its contents.
+struct MDStringInfo {
+  static inline MDString *getEmptyKey() {
+    return DenseMapInfo<MDString *>::getEmptyKey();
+  }
+
+  static inline MDString *getTombstoneKey() {
+    return DenseMapInfo<MDString *>::getTombstoneKey();
+  }
+
+  static unsigned getHashValue(StringRef Str) {
+    return DenseMapInfo<StringRef>::getHashValue(Str);
+  }
+
+  static unsigned getHashValue(const MDString *S) {
+    return getHashValue(S->getString());
+  }
+
+  static bool isEqual(StringRef LHS, const MDString *RHS) {
+    if (RHS == getEmptyKey() || RHS == getTombstoneKey())
+      return false;
+    return LHS == RHS->getString();
+  }
+
+  static bool isEqual(const MDString *LHS, const MDString *RHS) {
+    return LHS == RHS;
+  }
+};
+
 /// DenseMapInfo for MDNode subclasses.
 template <class NodeTy> struct MDNodeInfo {
   using KeyTy = MDNodeKeyImpl<NodeTy>;
@@ -1531,7 +1560,7 @@ public:
   FoldingSet<AttributeListImpl> AttrsLists;
   FoldingSet<AttributeSetNode> AttrsSetNodes;
 
-  StringMap<MDString, BumpPtrAllocator> MDStringCache;
+  DenseSet<MDString *, MDStringInfo> MDStringCache;
   DenseMap<Value *, ValueAsMetadata *> ValuesAsMetadata;
   DenseMap<Metadata *, MetadataAsValue *> MetadataAsValues;
   DenseSet<DIArgList *, DIArgListInfo> DIArgLists;
@@ -1694,6 +1723,10 @@ public:
   /// not.
   bool DiscardValueNames = false;
 
+  /// Flag to indicate if MDStrings read from bitcode may refer to the bitcode
+  /// buffer instead of being copied.
+  bool ReferenceBitcodeMDStrings = false;
+
   LLVMContextImpl(LLVMContext &C);
   ~LLVMContextImpl();
 
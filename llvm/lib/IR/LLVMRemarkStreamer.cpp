@@ -81,6 +81,9 @@ LLVMRemarkStreamer::toRemark(const DiagnosticInfoOptimizationBase &Diag) const {
 void LLVMRemarkStreamer::emit(const DiagnosticInfoOptimizationBase &Diag) {
   if (!RS.matchesFilter(Diag.getPassName()))
       return;
+  // Drop the remarks that are not sampled before paying for the conversion.
+  if (!RS.shouldSample())
+    return;
 
   // First, convert the diagnostic to a remark.
   remarks::Remark R = toRemark(Diag);
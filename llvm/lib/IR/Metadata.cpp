@@ -51,6 +51,8 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -603,19 +605,24 @@ void ValueAsMetadata::handleRAUW(Value *From, Value *To) {
 // MDString implementation.
 //
 
-MDString *MDString::get(LLVMContext &Context, StringRef Str) {
-  auto &Store = Context.pImpl->MDStringCache;
-  auto I = Store.try_emplace(Str);
-  auto &MapEntry = I.first->getValue();
-  if (!I.second)
-    return &MapEntry;
-  MapEntry.Entry = &*I.first;
-  return &MapEntry;
-}
-
-StringRef MDString::getString() const {
-  assert(Entry && "Expected to find string map entry");
-  return Entry->first();
+MDString *MDString::getImpl(LLVMContext &Context, StringRef Str, bool Copy) {
+  assert(Str.size() <= std::numeric_limits<unsigned>::max() &&
+         "MDString is too long");
+  LLVMContextImpl *pImpl = Context.pImpl;
+  auto I = pImpl->MDStringCache.find_as(Str);
+  if (I != pImpl->MDStringCache.end())
+    return *I;
+
+  if (Copy) {
+    char *Buf = pImpl->Alloc.Allocate<char>(Str.size() + 1);
+    if (!Str.empty())
+      memcpy(Buf, Str.data(), Str.size());
+    Buf[Str.size()] = '\0';
+    Str = StringRef(Buf, Str.size());
+  }
+  auto *MDS = new (pImpl->Alloc.Allocate<MDString>()) MDString(Str);
+  pImpl->MDStringCache.insert(MDS);
+  return MDS;
 }
 
 //===----------------------------------------------------------------------===//
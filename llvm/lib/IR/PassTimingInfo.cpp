@@ -94,9 +94,14 @@ private:
 
 static ManagedStatic<sys::SmartMutex<true>> TimingInfoMutex;
 
+/// Incremented when a PassTimingInfo is destroyed, which invalidates the timer
+/// caches of all threads.
+static std::atomic<unsigned> TimingInfoEpoch{0};
+
 PassTimingInfo::PassTimingInfo() : TG("pass", "Pass execution timing report") {}
 
 PassTimingInfo::~PassTimingInfo() {
+  TimingInfoEpoch.fetch_add(1, std::memory_order_release);
   // Deleting the timers accumulates their info into the TG member.
   // Then TG member is (implicitly) deleted, actually printing the report.
   TimingData.clear();
@@ -132,6 +137,25 @@ Timer *PassTimingInfo::getPassTimer(Pass *P, PassInstanceID Pass) {
     return nullptr;
 
   init();
+
+  // Every pass run looks its timer up. Cache the timers in the calling thread,
+  // so that threads running pass managers in parallel, as the ThinLTO backends
+  // do, only contend on TimingInfoMutex the first time they run a pass. The
+  // timers live as long as this PassTimingInfo.
+  struct TimerCache {
+    unsigned Epoch = 0;
+    DenseMap<PassInstanceID, Timer *> Timers;
+  };
+  static thread_local TimerCache Cache;
+  unsigned Epoch = TimingInfoEpoch.load(std::memory_order_acquire);
+  if (Cache.Epoch != Epoch) {
+    Cache.Timers.clear();
+    Cache.Epoch = Epoch;
+  }
+  Timer *&Cached = Cache.Timers[Pass];
+  if (Cached)
+    return Cached;
+
   sys::SmartScopedLock<true> Lock(*TimingInfoMutex);
   std::unique_ptr<Timer> &T = TimingData[Pass];
 
@@ -142,7 +166,8 @@ Timer *PassTimingInfo::getPassTimer(Pass *P, PassInstanceID Pass) {
       PassArgument = PI->getPassArgument();
     T.reset(newPassTimer(PassArgument.empty() ? PassName : PassArgument, PassName));
   }
-  return T.get();
+  Cached = T.get();
+  return Cached;
 }
 
 PassTimingInfo *PassTimingInfo::TheTimeInfo;
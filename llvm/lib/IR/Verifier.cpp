@@ -119,6 +119,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/ModRef.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -448,6 +449,28 @@ public:
     return !Broken;
   }
 
+  /// Take over the state that \p Other collected while verifying functions
+  /// for the module-level checks, as if those functions had been verified by
+  /// this instance. Returns false if this reveals that the module is broken.
+  bool takeFunctionState(const Verifier &Other) {
+    Broken = false;
+    BrokenDebugInfo |= Other.BrokenDebugInfo;
+    for (const auto &[SP, F] : Other.DISubprogramAttachments) {
+      const Function *&AttachedTo = DISubprogramAttachments[SP];
+      if (AttachedTo && AttachedTo != F)
+        DebugInfoCheckFailed("DISubprogram attached to more than one function",
+                             SP, F);
+      AttachedTo = F;
+    }
+    for (const auto &[F, Counts] : Other.FrameEscapeInfo) {
+      auto &Entry = FrameEscapeInfo[F];
+      Entry.first = std::max(Entry.first, Counts.first);
+      Entry.second = std::max(Entry.second, Counts.second);
+    }
+    CUVisited.insert(Other.CUVisited.begin(), Other.CUVisited.end());
+    return !Broken;
+  }
+
   /// Verify the module that this instance of \c Verifier was initialized with.
   bool verify() {
     Broken = false;
@@ -7305,14 +7328,89 @@ bool llvm::verifyFunction(const Function &f, raw_ostream *OS) {
   return !V.verify(F);
 }
 
-bool llvm::verifyModule(const Module &M, raw_ostream *OS,
-                        bool *BrokenDebugInfo) {
+/// Verifying a function only reads the IR, except for a few lookups that
+/// create the uniqued object they look for on first use. Create these objects
+/// up front, so that no function verification modifies the context.
+static void prepareConcurrentVerification(const Module &M) {
+  LLVMContext &Context = M.getContext();
+  const DataLayout &DL = M.getDataLayout();
+  ConstantTokenNone::get(Context);
+  for (const Function &F : M) {
+    DL.getIntPtrType(F.getType());
+    Intrinsic::ID ID = F.getIntrinsicID();
+    if (ID == Intrinsic::not_intrinsic)
+      continue;
+    // Overloaded intrinsics derive and mangle types when their signatures are
+    // matched, see visitIntrinsicCall.
+    SmallVector<Intrinsic::IITDescriptor, 8> Table;
+    getIntrinsicInfoTableEntries(ID, Table);
+    ArrayRef<Intrinsic::IITDescriptor> TableRef = Table;
+    SmallVector<Type *, 4> ArgTys;
+    if (Intrinsic::matchIntrinsicSignature(F.getFunctionType(), TableRef,
+                                           ArgTys) ==
+        Intrinsic::MatchIntrinsicTypes_Match)
+      Intrinsic::getName(ID, ArgTys, const_cast<Module *>(F.getParent()),
+                         F.getFunctionType());
+  }
+}
+
+/// Verify the functions of \p M on \p Threads threads and fold the state the
+/// workers collect into \p V, which is left to run the module-level checks.
+/// Diagnostics are printed to \p OS in the order of the functions in \p M.
+static bool verifyFunctionsConcurrently(Verifier &V, const Module &M,
+                                        raw_ostream *OS,
+                                        bool TreatBrokenDebugInfoAsError,
+                                        unsigned Threads) {
+  prepareConcurrentVerification(M);
+
+  struct Shard {
+    std::string Output;
+    raw_string_ostream OS{Output};
+    std::unique_ptr<Verifier> V;
+    bool Broken = false;
+  };
+  SmallVector<const Function *, 0> Functions(llvm::make_pointer_range(M));
+  DefaultThreadPool Pool(hardware_concurrency(Threads));
+  // Use a few contiguous shards per thread to balance the load, while keeping
+  // the per-shard verifier setup and the output deterministic.
+  size_t NumShards =
+      std::min<size_t>(Functions.size(), Pool.getMaxConcurrency() * 4);
+  std::vector<Shard> Shards(NumShards);
+  for (size_t I = 0; I != NumShards; ++I) {
+    Pool.async([&, I] {
+      Shard &S = Shards[I];
+      S.V = std::make_unique<Verifier>(OS ? &S.OS : nullptr,
+                                       TreatBrokenDebugInfoAsError, M);
+      size_t End = Functions.size() * (I + 1) / NumShards;
+      for (size_t J = Functions.size() * I / NumShards; J != End; ++J)
+        S.Broken |= !S.V->verify(*Functions[J]);
+    });
+  }
+  Pool.wait();
+
+  bool Broken = false;
+  for (Shard &S : Shards) {
+    if (OS)
+      *OS << S.Output;
+    Broken |= S.Broken;
+    Broken |= !V.takeFunctionState(*S.V);
+  }
+  return !Broken;
+}
+
+bool llvm::verifyModule(const Module &M, raw_ostream *OS, bool *BrokenDebugInfo,
+                        unsigned Threads) {
   // Don't use a raw_null_ostream.  Printing IR is expensive.
   Verifier V(OS, /*ShouldTreatBrokenDebugInfoAsError=*/!BrokenDebugInfo, M);
 
   bool Broken = false;
-  for (const Function &F : M)
-    Broken |= !V.verify(F);
+  if (Threads != 1 && M.size() > 1) {
+    Broken |= !verifyFunctionsConcurrently(
+        V, M, OS, /*TreatBrokenDebugInfoAsError=*/!BrokenDebugInfo, Threads);
+  } else {
+    for (const Function &F : M)
+      Broken |= !V.verify(F);
+  }
 
   Broken |= !V.verify();
   if (BrokenDebugInfo)
@@ -7738,7 +7836,12 @@ VerifierAnalysis::Result VerifierAnalysis::run(Function &F,
 }
 
 PreservedAnalyses VerifierPass::run(Module &M, ModuleAnalysisManager &AM) {
-  auto Res = AM.getResult<VerifierAnalysis>(M);
+  VerifierAnalysis::Result Res;
+  if (Threads == 1)
+    Res = AM.getResult<VerifierAnalysis>(M);
+  else
+    Res.IRBroken =
+        llvm::verifyModule(M, &dbgs(), &Res.DebugInfoBroken, Threads);
   if (FatalErrors && (Res.IRBroken || Res.DebugInfoBroken))
     report_fatal_error("Broken module found, compilation aborted!");
 
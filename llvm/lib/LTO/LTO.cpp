@@ -41,8 +41,11 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/ThreadPool.h"
@@ -58,6 +61,7 @@
 #include "llvm/Transforms/Utils/FunctionImportUtils.h"
 #include "llvm/Transforms/Utils/SplitModule.h"
 
+#include <condition_variable>
 #include <optional>
 #include <set>
 
@@ -74,6 +78,7 @@ static cl::opt<bool>
                    cl::desc("Dump the SCCs in the ThinLTO index's callgraph"));
 
 extern cl::opt<bool> CodeGenDataThinLTOTwoRounds;
+extern cl::opt<unsigned> CodeGenDataThinLTOReuseHours;
 
 namespace llvm {
 /// Enable global value internalization in LTO.
@@ -85,6 +90,17 @@ static cl::opt<bool>
     LTOKeepSymbolCopies("lto-keep-symbol-copies", cl::init(false), cl::Hidden,
                         cl::desc("Keep copies of symbols in LTO indexing"));
 
+static cl::opt<unsigned> ThinLTOMemoryPerInstruction(
+    "thinlto-memory-per-instruction", cl::init(1024), cl::Hidden,
+    cl::desc("Estimated peak memory in bytes used by a ThinLTO backend for "
+             "each IR instruction it optimizes, used with a memory budget"));
+
+static cl::opt<unsigned> ThinLTOImportSliceThreshold(
+    "thinlto-import-slice-threshold", cl::init(0), cl::Hidden,
+    cl::desc("For in-process ThinLTO backends, import from a copy of each "
+             "module imported from by at least this many backends, which only "
+             "keeps the definitions that are imported from it (0 = disabled)"));
+
 /// Indicate we are linking with an allocator that supports hot/cold operator
 /// new interfaces.
 extern cl::opt<bool> SupportsHotColdNew;
@@ -93,30 +109,17 @@ extern cl::opt<bool> SupportsHotColdNew;
 extern cl::opt<bool> EnableMemProfContextDisambiguation;
 } // namespace llvm
 
-// Computes a unique hash for the Module considering the current list of
-// export/import and other global analysis results.
-// Returns the hash in its hexadecimal representation.
-std::string llvm::computeLTOCacheKey(
-    const Config &Conf, const ModuleSummaryIndex &Index, StringRef ModuleID,
-    const FunctionImporter::ImportMapTy &ImportList,
-    const FunctionImporter::ExportSetTy &ExportList,
-    const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
-    const GVSummaryMapTy &DefinedGlobals,
-    const DenseSet<GlobalValue::GUID> &CfiFunctionDefs,
-    const DenseSet<GlobalValue::GUID> &CfiFunctionDecls) {
-  // Compute the unique hash for this entry.
-  // This is based on the current compiler version, the module itself, the
-  // export list, the hash for every single module in the import list, the
-  // list of ResolvedODR for the module, and the list of preserved symbols.
-  SHA1 Hasher;
-
+// Adds the compiler revision and the parts of the LTO configuration that
+// affect the backend to Hasher. If OptimizationOnly is set, the options that
+// only affect code generation are left out.
+static void hashLTOConfig(SHA1 &Hasher, const Config &Conf,
+                          bool OptimizationOnly) {
   // Start with the compiler revision
   Hasher.update(LLVM_VERSION_STRING);
 #ifdef LLVM_REVISION
   Hasher.update(LLVM_REVISION);
 #endif
 
-  // Include the parts of the LTO configuration that affect code generation.
   auto AddString = [&](StringRef Str) {
     Hasher.update(Str);
     Hasher.update(ArrayRef<uint8_t>{0});
@@ -126,23 +129,17 @@ std::string llvm::computeLTOCacheKey(
     support::endian::write32le(Data, I);
     Hasher.update(Data);
   };
-  auto AddUint64 = [&](uint64_t I) {
-    uint8_t Data[8];
-    support::endian::write64le(Data, I);
-    Hasher.update(Data);
-  };
-  auto AddUint8 = [&](const uint8_t I) {
-    Hasher.update(ArrayRef<uint8_t>((const uint8_t *)&I, 1));
-  };
   AddString(Conf.CPU);
   // FIXME: Hash more of Options. For now all clients initialize Options from
   // command-line flags (which is unsupported in production), but may set
   // X86RelaxRelocations. The clang driver can also pass FunctionSections,
   // DataSections and DebuggerTuning via command line flags.
-  AddUnsigned(Conf.Options.MCOptions.X86RelaxRelocations);
-  AddUnsigned(Conf.Options.FunctionSections);
-  AddUnsigned(Conf.Options.DataSections);
-  AddUnsigned((unsigned)Conf.Options.DebuggerTuning);
+  if (!OptimizationOnly) {
+    AddUnsigned(Conf.Options.MCOptions.X86RelaxRelocations);
+    AddUnsigned(Conf.Options.FunctionSections);
+    AddUnsigned(Conf.Options.DataSections);
+    AddUnsigned((unsigned)Conf.Options.DebuggerTuning);
+  }
   for (auto &A : Conf.MAttrs)
     AddString(A);
   if (Conf.RelocModel)
@@ -155,15 +152,58 @@ std::string llvm::computeLTOCacheKey(
     AddUnsigned(-1);
   for (const auto &S : Conf.MllvmArgs)
     AddString(S);
-  AddUnsigned(static_cast<int>(Conf.CGOptLevel));
-  AddUnsigned(static_cast<int>(Conf.CGFileType));
+  if (!OptimizationOnly) {
+    AddUnsigned(static_cast<int>(Conf.CGOptLevel));
+    AddUnsigned(static_cast<int>(Conf.CGFileType));
+  }
   AddUnsigned(Conf.OptLevel);
   AddUnsigned(Conf.Freestanding);
   AddString(Conf.OptPipeline);
   AddString(Conf.AAPipeline);
   AddString(Conf.OverrideTriple);
   AddString(Conf.DefaultTriple);
-  AddString(Conf.DwoDir);
+  if (!OptimizationOnly)
+    AddString(Conf.DwoDir);
+}
+
+// Computes a unique hash for the Module considering the current list of
+// export/import and other global analysis results.
+// Returns the hash in its hexadecimal representation.
+std::string llvm::computeLTOCacheKey(
+    const Config &Conf, const ModuleSummaryIndex &Index, StringRef ModuleID,
+    const FunctionImporter::ImportMapTy &ImportList,
+    const FunctionImporter::ExportSetTy &ExportList,
+    const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
+    const GVSummaryMapTy &DefinedGlobals,
+    const DenseSet<GlobalValue::GUID> &CfiFunctionDefs,
+    const DenseSet<GlobalValue::GUID> &CfiFunctionDecls,
+    bool OptimizationOnly) {
+  // Compute the unique hash for this entry.
+  // This is based on the current compiler version, the module itself, the
+  // export list, the hash for every single module in the import list, the
+  // list of ResolvedODR for the module, and the list of preserved symbols.
+  SHA1 Hasher;
+
+  // Include the parts of the LTO configuration that affect code generation.
+  hashLTOConfig(Hasher, Conf, OptimizationOnly);
+
+  auto AddString = [&](StringRef Str) {
+    Hasher.update(Str);
+    Hasher.update(ArrayRef<uint8_t>{0});
+  };
+  auto AddUnsigned = [&](unsigned I) {
+    uint8_t Data[4];
+    support::endian::write32le(Data, I);
+    Hasher.update(Data);
+  };
+  auto AddUint64 = [&](uint64_t I) {
+    uint8_t Data[8];
+    support::endian::write64le(Data, I);
+    Hasher.update(Data);
+  };
+  auto AddUint8 = [&](const uint8_t I) {
+    Hasher.update(ArrayRef<uint8_t>((const uint8_t *)&I, 1));
+  };
 
   // Include the hash for the current module
   auto ModHash = Index.getModuleHash(ModuleID);
@@ -346,6 +386,17 @@ std::string llvm::computeLTOCacheKey(
   return toHex(Hasher.result());
 }
 
+// Computes a key for the object file generated from OptimizedIR. Unlike the
+// key computed by computeLTOCacheKey, it only depends on the optimized IR and
+// on the options that affect code generation.
+static std::string computeLTOCodeGenCacheKey(const Config &Conf,
+                                             StringRef OptimizedIR) {
+  SHA1 Hasher;
+  hashLTOConfig(Hasher, Conf, /*OptimizationOnly=*/false);
+  Hasher.update(OptimizedIR);
+  return toHex(Hasher.result());
+}
+
 std::string llvm::recomputeLTOCacheKey(const std::string &Key,
                                        StringRef ExtraID) {
   SHA1 Hasher;
@@ -453,10 +504,27 @@ void llvm::thinLTOResolvePrevailingInIndex(
       if (auto AS = dyn_cast<AliasSummary>(S.get()))
         GlobalInvolvedWithAlias.insert(&AS->getAliasee());
 
+  // Each GUID only updates its own summaries, so GUIDs are resolved in
+  // parallel. The new linkages are buffered and recorded in index order to
+  // keep the output deterministic.
+  std::vector<ValueInfo> VIs;
+  VIs.reserve(Index.size());
   for (auto &I : Index)
-    thinLTOResolvePrevailingGUID(C, Index.getValueInfo(I),
-                                 GlobalInvolvedWithAlias, isPrevailing,
-                                 recordNewLinkage, GUIDPreservedSymbols);
+    VIs.push_back(Index.getValueInfo(I));
+  std::vector<SmallVector<std::pair<StringRef, GlobalValue::LinkageTypes>, 0>>
+      NewLinkages(VIs.size());
+  parallelFor(0, VIs.size(), [&](size_t I) {
+    thinLTOResolvePrevailingGUID(
+        C, VIs[I], GlobalInvolvedWithAlias, isPrevailing,
+        [&](StringRef ModulePath, GlobalValue::GUID,
+            GlobalValue::LinkageTypes NewLinkage) {
+          NewLinkages[I].emplace_back(ModulePath, NewLinkage);
+        },
+        GUIDPreservedSymbols);
+  });
+  for (size_t I = 0, E = VIs.size(); I != E; ++I)
+    for (auto &[ModulePath, NewLinkage] : NewLinkages[I])
+      recordNewLinkage(ModulePath, VIs[I].getGUID(), NewLinkage);
 }
 
 static void thinLTOInternalizeAndPromoteGUID(
@@ -543,9 +611,13 @@ void llvm::thinLTOInternalizeAndPromoteInIndex(
     function_ref<bool(StringRef, ValueInfo)> isExported,
     function_ref<bool(GlobalValue::GUID, const GlobalValueSummary *)>
         isPrevailing) {
+  std::vector<ValueInfo> VIs;
+  VIs.reserve(Index.size());
   for (auto &I : Index)
-    thinLTOInternalizeAndPromoteGUID(Index.getValueInfo(I), isExported,
-                                     isPrevailing);
+    VIs.push_back(Index.getValueInfo(I));
+  parallelFor(0, VIs.size(), [&](size_t I) {
+    thinLTOInternalizeAndPromoteGUID(VIs[I], isExported, isPrevailing);
+  });
 }
 
 // Requires a destructor for std::vector<InputModule>.
@@ -573,6 +645,7 @@ Expected<std::unique_ptr<InputFile>> InputFile::create(MemoryBufferRef Object) {
       if (Sym.isGlobal() && !Sym.isFormatSpecific())
         File->Symbols.push_back(Sym);
     File->ModuleSymIndices.push_back({Begin, File->Symbols.size()});
+    File->ModuleLTOInfos.push_back(FOrErr->TheReader.getModuleLTOInfo(I));
   }
 
   File->Mods = FOrErr->Mods;
@@ -750,7 +823,7 @@ Error LTO::add(std::unique_ptr<InputFile> Input,
 Error LTO::addModule(InputFile &Input, unsigned ModI,
                      const SymbolResolution *&ResI,
                      const SymbolResolution *ResE) {
-  Expected<BitcodeLTOInfo> LTOInfo = Input.Mods[ModI].getLTOInfo();
+  Expected<BitcodeLTOInfo> LTOInfo = Input.getModuleLTOInfo(ModI);
   if (!LTOInfo)
     return LTOInfo.takeError();
 
@@ -1416,6 +1489,39 @@ Error ThinBackendProc::emitFiles(
 }
 
 namespace {
+// Forwards to another CachedFileStream and records the number of bytes written
+// before the other stream commits them.
+struct SizeRecordingStream : CachedFileStream {
+  std::unique_ptr<CachedFileStream> Inner;
+  std::optional<uint64_t> &Size;
+
+  SizeRecordingStream(std::unique_ptr<CachedFileStream> Stream,
+                      std::optional<uint64_t> &Size)
+      : CachedFileStream(std::move(Stream->OS), Stream->ObjectPathName),
+        Inner(std::move(Stream)), Size(Size) {}
+
+  ~SizeRecordingStream() override {
+    Size = OS->tell();
+    Inner->OS = std::move(OS);
+    Inner.reset();
+  }
+};
+
+// Returns an AddStreamFn that stores the size of the output of AddStream in
+// Size.
+static AddStreamFn recordOutputSize(AddStreamFn AddStream,
+                                    std::optional<uint64_t> &Size) {
+  return [=, &Size](unsigned Task, const Twine &ModuleName)
+             -> Expected<std::unique_ptr<CachedFileStream>> {
+    Expected<std::unique_ptr<CachedFileStream>> StreamOrErr =
+        AddStream(Task, ModuleName);
+    if (!StreamOrErr)
+      return StreamOrErr.takeError();
+    return std::make_unique<SizeRecordingStream>(std::move(*StreamOrErr),
+                                                 Size);
+  };
+}
+
 class InProcessThinBackend : public ThinBackendProc {
 protected:
   AddStreamFn AddStream;
@@ -1425,6 +1531,103 @@ protected:
 
   bool ShouldEmitIndexFiles;
 
+  // Memory budget accounting for Conf.ThinLTOMemoryBudget.
+  std::mutex BudgetMu;
+  std::condition_variable BudgetCV;
+  uint64_t BudgetInUse = 0;
+
+  // Estimates the peak memory used by the backend for a module from the
+  // instruction counts of the functions it defines and imports.
+  uint64_t
+  estimateBackendMemory(const FunctionImporter::ImportMapTy &ImportList,
+                        const GVSummaryMapTy &DefinedGlobals) const {
+    uint64_t NumInsts = 0;
+    for (const auto &[GUID, Summary] : DefinedGlobals)
+      if (auto *FS = dyn_cast<FunctionSummary>(Summary->getBaseObject()))
+        NumInsts += FS->instCount();
+    for (const auto &[FromModule, GUID, Type] : ImportList) {
+      if (Type != GlobalValueSummary::Definition)
+        continue;
+      GlobalValueSummary *S =
+          CombinedIndex.findSummaryInModule(GUID, FromModule);
+      if (auto *FS = dyn_cast_or_null<FunctionSummary>(S))
+        NumInsts += FS->instCount();
+    }
+    return NumInsts * ThinLTOMemoryPerInstruction;
+  }
+
+  // Blocks until a backend with the given estimate fits in the budget. A
+  // backend is always admitted when nothing else is running, so that a module
+  // larger than the budget still makes progress.
+  void acquireBudget(uint64_t Estimate) {
+    std::unique_lock<std::mutex> L(BudgetMu);
+    BudgetCV.wait(L, [&] {
+      return BudgetInUse == 0 ||
+             BudgetInUse + Estimate <= Conf.ThinLTOMemoryBudget;
+    });
+    BudgetInUse += Estimate;
+  }
+
+  void releaseBudget(uint64_t Estimate) {
+    {
+      std::lock_guard<std::mutex> L(BudgetMu);
+      BudgetInUse -= Estimate;
+    }
+    BudgetCV.notify_all();
+  }
+
+  // Statistics of one backend for Conf.ThinLTOBackendStatsFile.
+  struct ModuleStats {
+    std::string ModuleID;
+    StringRef CacheResult = "disabled";
+    ThinBackendTimes Times;
+    std::chrono::nanoseconds Total{0};
+    int64_t MallocDelta = 0;
+    std::optional<uint64_t> OutputSize;
+  };
+  std::mutex StatsMu;
+  std::map<unsigned, ModuleStats> Stats;
+
+  // Returns the statistics of Task, or nullptr if they are not collected.
+  ModuleStats *getStats(unsigned Task) {
+    if (Conf.ThinLTOBackendStatsFile.empty())
+      return nullptr;
+    std::lock_guard<std::mutex> L(StatsMu);
+    return &Stats[Task];
+  }
+
+  Error writeStats() {
+    std::error_code EC;
+    raw_fd_ostream OS(Conf.ThinLTOBackendStatsFile, EC, sys::fs::OF_Text);
+    if (EC)
+      return createFileError(Conf.ThinLTOBackendStatsFile, EC);
+    auto Micros = [](std::chrono::nanoseconds D) -> int64_t {
+      return std::chrono::duration_cast<std::chrono::microseconds>(D).count();
+    };
+    json::OStream J(OS, /*IndentSize=*/2);
+    J.object([&] {
+      J.attributeArray("modules", [&] {
+        for (const auto &Entry : Stats) {
+          const ModuleStats &S = Entry.second;
+          J.object([&] {
+            J.attribute("module", S.ModuleID);
+            J.attribute("task", Entry.first);
+            J.attribute("cache", S.CacheResult);
+            J.attribute("import_us", Micros(S.Times.Import));
+            J.attribute("optimize_us", Micros(S.Times.Optimize));
+            J.attribute("codegen_us", Micros(S.Times.CodeGen));
+            J.attribute("total_us", Micros(S.Total));
+            J.attribute("malloc_delta", S.MallocDelta);
+            if (S.OutputSize)
+              J.attribute("output_size", int64_t(*S.OutputSize));
+          });
+        }
+      });
+    });
+    OS << "\n";
+    return Error::success();
+  }
+
 public:
   InProcessThinBackend(
       const Config &Conf, ModuleSummaryIndex &CombinedIndex,
@@ -1444,6 +1647,94 @@ public:
           GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
   }
 
+  bool isInProcess() override { return true; }
+
+  Error wait() override {
+    if (Error E = ThinBackendProc::wait())
+      return E;
+    if (Conf.ThinLTOBackendStatsFile.empty())
+      return Error::success();
+    return writeStats();
+  }
+
+  // Runs the backend with two cache levels. The optimized IR is cached under a
+  // key that leaves out the codegen-only options, and the object file is
+  // cached under a key computed from the optimized IR.
+  Error runThinLTOBackendWithIRCache(
+      FileCache &Cache, unsigned Task, BitcodeModule BM,
+      ModuleSummaryIndex &CombinedIndex,
+      const FunctionImporter::ImportMapTy &ImportList,
+      const FunctionImporter::ExportSetTy &ExportList,
+      const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
+      const GVSummaryMapTy &DefinedGlobals,
+      MapVector<StringRef, BitcodeModule> &ModuleMap) {
+    StringRef ModuleID = BM.getModuleIdentifier();
+    ModuleStats *S = getStats(Task);
+    ThinBackendTimes *Times = S ? &S->Times : nullptr;
+    std::string IRKey = recomputeLTOCacheKey(
+        computeLTOCacheKey(Conf, CombinedIndex, ModuleID, ImportList,
+                           ExportList, ResolvedODR, DefinedGlobals,
+                           CfiFunctionDefs, CfiFunctionDecls,
+                           /*OptimizationOnly=*/true),
+        /*ExtraID=*/"OptIR");
+
+    // The optimized IR is handed back through AddBuffer both on a cache hit
+    // and when a new entry is committed.
+    std::unique_ptr<MemoryBuffer> OptimizedIR;
+    Expected<FileCache> IRCacheOrErr = localCache(
+        "ThinLTO", "ThinLTO-IR", Cache.getCacheDirectoryPath(),
+        [&](unsigned, const Twine &, std::unique_ptr<MemoryBuffer> MB) {
+          OptimizedIR = std::move(MB);
+        });
+    if (!IRCacheOrErr)
+      return IRCacheOrErr.takeError();
+    Expected<AddStreamFn> IRAddStreamOrErr =
+        (*IRCacheOrErr)(Task, IRKey, ModuleID);
+    if (Error Err = IRAddStreamOrErr.takeError())
+      return Err;
+
+    LTOLLVMContext BackendContext(Conf);
+    std::unique_ptr<Module> Mod;
+    if (AddStreamFn &IRAddStream = *IRAddStreamOrErr) {
+      Expected<std::unique_ptr<Module>> MOrErr = BM.parseModule(BackendContext);
+      if (!MOrErr)
+        return MOrErr.takeError();
+      Mod = std::move(*MOrErr);
+      if (Error E = thinBackend(Conf, Task, /*AddStream=*/nullptr, *Mod,
+                                CombinedIndex, ImportList, DefinedGlobals,
+                                &ModuleMap, /*CodeGenOnly=*/false, IRAddStream,
+                                /*CmdArgs=*/{}, Times))
+        return E;
+      // A module hook stopped the backend before optimization finished.
+      if (!OptimizedIR)
+        return Error::success();
+    }
+
+    std::string Key =
+        computeLTOCodeGenCacheKey(Conf, OptimizedIR->getBuffer());
+    Expected<AddStreamFn> CacheAddStreamOrErr = Cache(Task, Key, ModuleID);
+    if (Error Err = CacheAddStreamOrErr.takeError())
+      return Err;
+    AddStreamFn &CacheAddStream = *CacheAddStreamOrErr;
+    if (S)
+      S->CacheResult = !CacheAddStream ? "hit" : Mod ? "miss" : "ir-hit";
+    if (!CacheAddStream)
+      return Error::success();
+
+    if (!Mod) {
+      Expected<std::unique_ptr<Module>> MOrErr =
+          parseBitcodeFile(*OptimizedIR, BackendContext);
+      if (!MOrErr)
+        return MOrErr.takeError();
+      Mod = std::move(*MOrErr);
+    }
+    return thinBackend(
+        Conf, Task, S ? recordOutputSize(CacheAddStream, S->OutputSize)
+                      : CacheAddStream,
+        *Mod, CombinedIndex, ImportList, DefinedGlobals, &ModuleMap,
+        /*CodeGenOnly=*/true, /*IRAddStream=*/nullptr, /*CmdArgs=*/{}, Times);
+  }
+
   virtual Error runThinLTOBackendThread(
       AddStreamFn AddStream, FileCache Cache, unsigned Task, BitcodeModule BM,
       ModuleSummaryIndex &CombinedIndex,
@@ -1452,15 +1743,21 @@ public:
       const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
       const GVSummaryMapTy &DefinedGlobals,
       MapVector<StringRef, BitcodeModule> &ModuleMap) {
+    ModuleStats *S = getStats(Task);
     auto RunThinBackend = [&](AddStreamFn AddStream) {
       LTOLLVMContext BackendContext(Conf);
       Expected<std::unique_ptr<Module>> MOrErr = BM.parseModule(BackendContext);
       if (!MOrErr)
         return MOrErr.takeError();
 
-      return thinBackend(Conf, Task, AddStream, **MOrErr, CombinedIndex,
-                         ImportList, DefinedGlobals, &ModuleMap,
-                         Conf.CodeGenOnly);
+      if (!S)
+        return thinBackend(Conf, Task, AddStream, **MOrErr, CombinedIndex,
+                           ImportList, DefinedGlobals, &ModuleMap,
+                           Conf.CodeGenOnly);
+      return thinBackend(Conf, Task, recordOutputSize(AddStream, S->OutputSize),
+                         **MOrErr, CombinedIndex, ImportList, DefinedGlobals,
+                         &ModuleMap, Conf.CodeGenOnly, /*IRAddStream=*/nullptr,
+                         /*CmdArgs=*/{}, &S->Times);
     };
 
     auto ModuleID = BM.getModuleIdentifier();
@@ -1477,6 +1774,11 @@ public:
       // no module hash.
       return RunThinBackend(AddStream);
 
+    if (Conf.ThinLTOCacheOptimizedIR && !Conf.CodeGenOnly)
+      return runThinLTOBackendWithIRCache(Cache, Task, BM, CombinedIndex,
+                                          ImportList, ExportList, ResolvedODR,
+                                          DefinedGlobals, ModuleMap);
+
     // The module may be cached, this helps handling it.
     std::string Key = computeLTOCacheKey(
         Conf, CombinedIndex, ModuleID, ImportList, ExportList, ResolvedODR,
@@ -1485,6 +1787,8 @@ public:
     if (Error Err = CacheAddStreamOrErr.takeError())
       return Err;
     AddStreamFn &CacheAddStream = *CacheAddStreamOrErr;
+    if (S)
+      S->CacheResult = CacheAddStream ? "miss" : "hit";
     if (CacheAddStream)
       return RunThinBackend(CacheAddStream);
 
@@ -1501,6 +1805,9 @@ public:
     assert(ModuleToDefinedGVSummaries.count(ModulePath));
     const GVSummaryMapTy &DefinedGlobals =
         ModuleToDefinedGVSummaries.find(ModulePath)->second;
+    uint64_t Estimate = 0;
+    if (Conf.ThinLTOMemoryBudget)
+      Estimate = estimateBackendMemory(ImportList, DefinedGlobals);
     BackendThreadPool.async(
         [=](BitcodeModule BM, ModuleSummaryIndex &CombinedIndex,
             const FunctionImporter::ImportMapTy &ImportList,
@@ -1512,9 +1819,26 @@ public:
           if (LLVM_ENABLE_THREADS && Conf.TimeTraceEnabled)
             timeTraceProfilerInitialize(Conf.TimeTraceGranularity,
                                         "thin backend");
-          Error E = runThinLTOBackendThread(
-              AddStream, Cache, Task, BM, CombinedIndex, ImportList, ExportList,
-              ResolvedODR, DefinedGlobals, ModuleMap);
+          if (Conf.ThinLTOMemoryBudget)
+            acquireBudget(Estimate);
+          ModuleStats *S = getStats(Task);
+          auto Start = std::chrono::steady_clock::now();
+          size_t MallocBefore = S ? sys::Process::GetMallocUsage() : 0;
+          Error E = [&] {
+            TimeTraceScope TimeScope("Thin backend",
+                                     BM.getModuleIdentifier());
+            return runThinLTOBackendThread(
+                AddStream, Cache, Task, BM, CombinedIndex, ImportList,
+                ExportList, ResolvedODR, DefinedGlobals, ModuleMap);
+          }();
+          if (S) {
+            S->ModuleID = BM.getModuleIdentifier().str();
+            S->Total = std::chrono::steady_clock::now() - Start;
+            S->MallocDelta = int64_t(sys::Process::GetMallocUsage()) -
+                             int64_t(MallocBefore);
+          }
+          if (Conf.ThinLTOMemoryBudget)
+            releaseBudget(Estimate);
           if (E) {
             std::unique_lock<std::mutex> L(ErrMu);
             if (Err)
@@ -1839,6 +2163,142 @@ ThinBackend lto::createWriteIndexesThinBackend(
   return ThinBackend(Func, Parallelism);
 }
 
+// Returns the bitcode of a copy of BM in which the definitions that are not
+// imported by any backend are turned into declarations. Definitions that must
+// stay for the module to remain valid, such as local and appending globals and
+// aliasees, are kept. Lazily loading the copy for importing reads far fewer
+// module-level records, constants and metadata than loading the original.
+static Expected<SmallVector<char, 0>>
+buildImportSlice(BitcodeModule BM,
+                 const DenseSet<GlobalValue::GUID> &ImportedDefs) {
+  LLVMContext Context;
+  Expected<std::unique_ptr<Module>> MOrErr = BM.parseModule(Context);
+  if (!MOrErr)
+    return MOrErr.takeError();
+  Module &M = **MOrErr;
+
+  SmallPtrSet<const GlobalObject *, 8> Keep;
+  for (const GlobalAlias &GA : M.aliases())
+    if (const GlobalObject *GO = GA.getAliaseeObject())
+      Keep.insert(GO);
+  for (const GlobalIFunc &GI : M.ifuncs())
+    if (const Function *Resolver = GI.getResolverFunction())
+      Keep.insert(Resolver);
+
+  auto ShouldStrip = [&](const GlobalObject &GO) {
+    return !GO.isDeclaration() && !GO.hasLocalLinkage() &&
+           !GO.hasAppendingLinkage() && !Keep.count(&GO) &&
+           !ImportedDefs.count(GO.getGUID());
+  };
+  for (Function &F : M) {
+    // Deleting a block whose address is taken would rewrite the blockaddress
+    // users in the remaining functions.
+    if (!ShouldStrip(F) ||
+        any_of(F, [](const BasicBlock &BB) { return BB.hasAddressTaken(); }))
+      continue;
+    F.deleteBody();
+    F.setComdat(nullptr);
+  }
+  for (GlobalVariable &GV : M.globals()) {
+    if (!ShouldStrip(GV))
+      continue;
+    GV.setInitializer(nullptr);
+    GV.setLinkage(GlobalValue::ExternalLinkage);
+    GV.setComdat(nullptr);
+    GV.eraseMetadata(LLVMContext::MD_dbg);
+  }
+
+  SmallVector<char, 0> Buffer;
+  raw_svector_ostream OS(Buffer);
+  WriteBitcodeToFile(M, OS);
+  return std::move(Buffer);
+}
+
+// Returns a copy of ModuleMap in which every module that is imported from by at
+// least -thinlto-import-slice-threshold of the modules in ModulesToCompile is
+// replaced by a slice that only keeps the imported definitions. The slices are
+// built in parallel and their bitcode is stored in Slices.
+static MapVector<StringRef, BitcodeModule> buildImportModuleMap(
+    const MapVector<StringRef, BitcodeModule> &ModuleMap,
+    const MapVector<StringRef, BitcodeModule> &ModulesToCompile,
+    const FunctionImporter::ImportListsTy &ImportLists,
+    ThreadPoolStrategy Parallelism,
+    std::vector<SmallVector<char, 0>> &Slices) {
+  DenseMap<StringRef, unsigned> NumImporters;
+  DenseMap<StringRef, DenseSet<GlobalValue::GUID>> ImportedDefs;
+  for (const auto &Mod : ModulesToCompile) {
+    DenseSet<StringRef> SourceModules;
+    for (const auto &[FromModule, GUID, Type] : ImportLists.lookup(Mod.first)) {
+      if (SourceModules.insert(FromModule).second)
+        ++NumImporters[FromModule];
+      if (Type == GlobalValueSummary::Definition)
+        ImportedDefs[FromModule].insert(GUID);
+    }
+  }
+
+  MapVector<StringRef, BitcodeModule> Result = ModuleMap;
+  SmallVector<BitcodeModule *, 0> Sliced;
+  for (auto &[Path, BM] : Result) {
+    if (NumImporters.lookup(Path) >= ThinLTOImportSliceThreshold) {
+      Sliced.push_back(&BM);
+      // Create the entry now, as the map must not change while the slices
+      // are built.
+      ImportedDefs.try_emplace(Path);
+    }
+  }
+  if (Sliced.empty())
+    return Result;
+
+  Slices.resize(Sliced.size());
+  DefaultThreadPool Pool(Parallelism);
+  for (size_t I = 0, E = Sliced.size(); I != E; ++I) {
+    Pool.async([&, I] {
+      BitcodeModule &BM = *Sliced[I];
+      const DenseSet<GlobalValue::GUID> &Defs =
+          ImportedDefs.find(BM.getModuleIdentifier())->second;
+      Expected<SmallVector<char, 0>> BufOrErr = buildImportSlice(BM, Defs);
+      if (!BufOrErr) {
+        // Keep importing from the original module, whose backend reports the
+        // error if there is one.
+        consumeError(BufOrErr.takeError());
+        return;
+      }
+      Slices[I] = std::move(*BufOrErr);
+      Expected<std::vector<BitcodeModule>> BMsOrErr =
+          getBitcodeModuleList(MemoryBufferRef(
+              StringRef(Slices[I].data(), Slices[I].size()),
+              BM.getModuleIdentifier()));
+      if (!BMsOrErr) {
+        consumeError(BMsOrErr.takeError());
+        return;
+      }
+      BM = BMsOrErr->front();
+    });
+  }
+  Pool.wait();
+  return Result;
+}
+
+// Returns the path of the codegen data saved in the cache directory for the
+// links of the modules in \p ModuleMap. The name starts with "llvmcache-" so
+// that the cache pruning also applies to it.
+static std::string
+getSavedCGDataPath(StringRef CacheDir,
+                   const MapVector<StringRef, BitcodeModule> &ModuleMap) {
+  SmallVector<StringRef, 0> ModuleIDs;
+  for (const auto &Mod : ModuleMap)
+    ModuleIDs.push_back(Mod.first);
+  llvm::sort(ModuleIDs);
+  SHA1 Hasher;
+  for (StringRef ID : ModuleIDs) {
+    Hasher.update(ID);
+    Hasher.update(ArrayRef<uint8_t>{0});
+  }
+  SmallString<128> Path(CacheDir);
+  sys::path::append(Path, "llvmcache-CGData-" + toHex(Hasher.result()));
+  return std::string(Path);
+}
+
 Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
                       const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols) {
   LLVM_DEBUG(dbgs() << "Running ThinLTO\n");
@@ -1928,7 +2388,7 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
                                LocalWPDTargetsMap);
 
   auto isPrevailing = [&](GlobalValue::GUID GUID, const GlobalValueSummary *S) {
-    return ThinLTO.PrevailingModuleForGUID[GUID] == S->modulePath();
+    return ThinLTO.PrevailingModuleForGUID.lookup(GUID) == S->modulePath();
   };
   if (EnableMemProfContextDisambiguation) {
     MemProfContextDisambiguation ContextDisambiguation;
@@ -2005,7 +2465,21 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
   auto &ModuleMap =
       ThinLTO.ModulesToCompile ? *ThinLTO.ModulesToCompile : ThinLTO.ModuleMap;
 
+  // The module map that in-process backends import from, and the bitcode of
+  // the import slices it refers to.
+  std::optional<MapVector<StringRef, BitcodeModule>> ImportModuleMap;
+  std::vector<SmallVector<char, 0>> ImportSlices;
+
   auto RunBackends = [&](ThinBackendProc *BackendProcess) -> Error {
+    MapVector<StringRef, BitcodeModule> *SourceModuleMap = &ThinLTO.ModuleMap;
+    if (ThinLTOImportSliceThreshold && BackendProcess->isInProcess()) {
+      if (!ImportModuleMap)
+        ImportModuleMap = buildImportModuleMap(
+            ThinLTO.ModuleMap, ModuleMap, ImportLists,
+            ThinLTO.Backend.getParallelism(), ImportSlices);
+      SourceModuleMap = &*ImportModuleMap;
+    }
+
     auto ProcessOneModule = [&](int I) -> Error {
       auto &Mod = *(ModuleMap.begin() + I);
       // Tasks 0 through ParallelCodeGenParallelismLevel-1 are reserved for
@@ -2013,7 +2487,7 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
       return BackendProcess->start(
           RegularLTO.ParallelCodeGenParallelismLevel + I, Mod.second,
           ImportLists[Mod.first], ExportLists[Mod.first],
-          ResolvedODR[Mod.first], ThinLTO.ModuleMap);
+          ResolvedODR[Mod.first], *SourceModuleMap);
     };
 
     if (BackendProcess->getThreadCount() == 1 ||
@@ -2049,6 +2523,41 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
     return RunBackends(BackendProc.get());
   }
 
+  // With -codegen-data-thinlto-reuse-hours, the codegen data merged by the
+  // last two-round link of the same set of modules is saved in the cache.
+  // While it is recent enough, a single round of code generation uses it, and
+  // the objects are cached under its hash so that the unchanged modules of an
+  // incremental link come from the cache.
+  std::string SavedCGDataPath;
+  if (CodeGenDataThinLTOReuseHours && Cache.isValid()) {
+    SavedCGDataPath =
+        getSavedCGDataPath(Cache.getCacheDirectoryPath(), ThinLTO.ModuleMap);
+    sys::fs::file_status Status;
+    bool IsRecent =
+        !sys::fs::status(SavedCGDataPath, Status) &&
+        std::chrono::system_clock::now() - Status.getLastModificationTime() <
+            std::chrono::hours(CodeGenDataThinLTOReuseHours);
+    std::optional<stable_hash> SavedHash;
+    if (IsRecent)
+      SavedHash = cgdata::publishSavedCodeGenData(SavedCGDataPath);
+    if (SavedHash) {
+      LLVM_DEBUG(dbgs() << "[TwoRounds] Reusing saved codegen data with hash "
+                        << *SavedHash << "\n");
+      std::string ExtraID = std::to_string(*SavedHash);
+      FileCache ReuseCache(
+          [Cache, ExtraID](unsigned Task, StringRef Key,
+                           const Twine &ModuleName) mutable {
+            return Cache(Task, recomputeLTOCacheKey(Key.str(), ExtraID),
+                         ModuleName);
+          },
+          Cache.getCacheDirectoryPath());
+      std::unique_ptr<ThinBackendProc> BackendProc =
+          ThinLTO.Backend(Conf, ThinLTO.CombinedIndex,
+                          ModuleToDefinedGVSummaries, AddStream, ReuseCache);
+      return RunBackends(BackendProc.get());
+    }
+  }
+
   // Perform two rounds of code generation for ThinLTO:
   // 1. First round: Perform optimization and code generation, outputting to
   // temporary scratch objects.
@@ -2085,7 +2594,21 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
   auto SecondRoundLTO = std::make_unique<SecondRoundThinBackend>(
       Conf, ThinLTO.CombinedIndex, Parallelism, ModuleToDefinedGVSummaries,
       AddStream, Cache, IR.getResult(), CombinedHash);
-  return RunBackends(SecondRoundLTO.get());
+  if (Error E = RunBackends(SecondRoundLTO.get()))
+    return E;
+
+  // The saved codegen data only speeds up later links, failing to write it
+  // does not fail this one.
+  if (!SavedCGDataPath.empty()) {
+    LLVM_DEBUG(dbgs() << "[TwoRounds] Saving codegen data to "
+                      << SavedCGDataPath << "\n");
+    if (Error E = cgdata::saveMergedCodeGenData(*CG.getResult(),
+                                                SavedCGDataPath))
+      llvm::errs() << "warning: could not save codegen data to '"
+                   << SavedCGDataPath << "': " << toString(std::move(E))
+                   << "\n";
+  }
+  return Error::success();
 }
 
 Expected<std::unique_ptr<ToolOutputFile>> lto::setupLLVMOptimizationRemarks(
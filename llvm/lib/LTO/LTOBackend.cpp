@@ -302,7 +302,7 @@ static void runNewPMPasses(const Config &Conf, Module &Mod, TargetMachine *TM,
   ModulePassManager MPM;
 
   if (!Conf.DisableVerify)
-    MPM.addPass(VerifierPass());
+    MPM.addPass(VerifierPass(/*FatalErrors=*/true, Conf.VerifyThreads));
 
   OptimizationLevel OL;
 
@@ -336,7 +336,7 @@ static void runNewPMPasses(const Config &Conf, Module &Mod, TargetMachine *TM,
   }
 
   if (!Conf.DisableVerify)
-    MPM.addPass(VerifierPass());
+    MPM.addPass(VerifierPass(/*FatalErrors=*/true, Conf.VerifyThreads));
 
   if (PrintPipelinePasses) {
     std::string PipelineStr;
@@ -482,7 +482,8 @@ static void splitCodeGen(const Config &C, TargetMachine *TM,
   if (!TM->splitModule(Mod, ParallelCodeGenParallelismLevel,
                        HandleModulePartition)) {
     SplitModule(Mod, ParallelCodeGenParallelismLevel, HandleModulePartition,
-                false);
+                /*PreserveLocals=*/false, /*RoundRobin=*/false,
+                C.CostBasedCodeGenSplit);
   }
 
   // Because the inner lambda (which runs in a worker thread) captures our local
@@ -542,6 +543,24 @@ Error lto::backend(const Config &C, AddStreamFn AddStream,
   return Error::success();
 }
 
+namespace {
+// Adds the wall time of its lifetime to one phase of a ThinBackendTimes.
+class PhaseTimer {
+  std::chrono::nanoseconds *Phase;
+  std::chrono::steady_clock::time_point Start;
+
+public:
+  PhaseTimer(ThinBackendTimes *Times,
+             std::chrono::nanoseconds ThinBackendTimes::*Member)
+      : Phase(Times ? &(Times->*Member) : nullptr),
+        Start(std::chrono::steady_clock::now()) {}
+  ~PhaseTimer() {
+    if (Phase)
+      *Phase += std::chrono::steady_clock::now() - Start;
+  }
+};
+} // end anonymous namespace
+
 static void dropDeadSymbols(Module &Mod, const GVSummaryMapTy &DefinedGlobals,
                             const ModuleSummaryIndex &Index) {
   std::vector<GlobalValue*> DeadGVs;
@@ -569,7 +588,8 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
                        const GVSummaryMapTy &DefinedGlobals,
                        MapVector<StringRef, BitcodeModule> *ModuleMap,
                        bool CodeGenOnly, AddStreamFn IRAddStream,
-                       const std::vector<uint8_t> &CmdArgs) {
+                       const std::vector<uint8_t> &CmdArgs,
+                       ThinBackendTimes *Times) {
   Expected<const Target *> TOrErr = initAndLookupTarget(Conf, Mod);
   if (!TOrErr)
     return TOrErr.takeError();
@@ -593,7 +613,10 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
   if (CodeGenOnly) {
     // If CodeGenOnly is set, we only perform code generation and skip
     // optimization. This value may differ from Conf.CodeGenOnly.
-    codegen(Conf, TM.get(), AddStream, Task, Mod, CombinedIndex);
+    {
+      PhaseTimer Timer(Times, &ThinBackendTimes::CodeGen);
+      codegen(Conf, TM.get(), AddStream, Task, Mod, CombinedIndex);
+    }
     return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
   }
 
@@ -604,9 +627,14 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
       [&](Module &Mod, TargetMachine *TM,
           std::unique_ptr<ToolOutputFile> DiagnosticOutputFile) {
         // Perform optimization and code generation for ThinLTO.
-        if (!opt(Conf, TM, Task, Mod, /*IsThinLTO=*/true,
-                 /*ExportSummary=*/nullptr, /*ImportSummary=*/&CombinedIndex,
-                 CmdArgs))
+        bool Optimized;
+        {
+          PhaseTimer Timer(Times, &ThinBackendTimes::Optimize);
+          Optimized = opt(Conf, TM, Task, Mod, /*IsThinLTO=*/true,
+                          /*ExportSummary=*/nullptr,
+                          /*ImportSummary=*/&CombinedIndex, CmdArgs);
+        }
+        if (!Optimized)
           return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
 
         // Save the current module before the first codegen round.
@@ -616,7 +644,14 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
         if (IRAddStream)
           cgdata::saveModuleForTwoRounds(Mod, Task, IRAddStream);
 
-        codegen(Conf, TM, AddStream, Task, Mod, CombinedIndex);
+        // The caller only wants the optimized IR.
+        if (!AddStream)
+          return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+
+        {
+          PhaseTimer Timer(Times, &ThinBackendTimes::CodeGen);
+          codegen(Conf, TM, AddStream, Task, Mod, CombinedIndex);
+        }
         return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
       };
 
@@ -681,8 +716,11 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
 
   FunctionImporter Importer(CombinedIndex, ModuleLoader,
                             ClearDSOLocalOnDeclarations);
-  if (Error Err = Importer.importFunctions(Mod, ImportList).takeError())
-    return Err;
+  {
+    PhaseTimer Timer(Times, &ThinBackendTimes::Import);
+    if (Error Err = Importer.importFunctions(Mod, ImportList).takeError())
+      return Err;
+  }
 
   // Do this after any importing so that imported code is updated.
   updateMemProfAttributes(Mod, CombinedIndex);
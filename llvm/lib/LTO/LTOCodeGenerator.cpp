@@ -546,7 +546,8 @@ void LTOCodeGenerator::verifyMergedModuleOnce() {
   HasVerifiedInput = true;
 
   bool BrokenDebugInfo = false;
-  if (verifyModule(*MergedModule, &dbgs(), &BrokenDebugInfo))
+  if (verifyModule(*MergedModule, &dbgs(), &BrokenDebugInfo,
+                   Config.VerifyThreads))
     report_fatal_error("Broken module found, compilation aborted!");
   if (BrokenDebugInfo) {
     emitWarning("Invalid debug info found, debug info will be stripped");
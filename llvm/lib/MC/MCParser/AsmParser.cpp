@@ -569,6 +569,14 @@ private:
   // ".ascii", ".asciz", ".string"
   bool parseDirectiveAscii(StringRef IDVal, bool ZeroTerminated);
   bool parseDirectiveReloc(SMLoc DirectiveLoc); // ".reloc"
+  /// Return true if the current token is an integer that is a whole operand,
+  /// i.e. that is followed by a comma or by the end of the statement.
+  bool isPlainInteger() {
+    if (getTok().isNot(AsmToken::Integer))
+      return false;
+    AsmToken::TokenKind Next = Lexer.peekTok().getKind();
+    return Next == AsmToken::Comma || Next == AsmToken::EndOfStatement;
+  }
   bool parseDirectiveValue(StringRef IDVal,
                            unsigned Size);       // ".byte", ".long", ...
   bool parseDirectiveOctaValue(StringRef IDVal); // ".octa", ...
@@ -1772,6 +1780,16 @@ bool AsmParser::parseBinOpRHS(unsigned Precedence, const MCExpr *&Res,
   }
 }
 
+/// Return \p Str in lower case. Compiler generated assembly is already in lower
+/// case, so only copy it to \p Storage if it has any upper case letter.
+static StringRef lowerIfNeeded(StringRef Str, SmallVectorImpl<char> &Storage) {
+  if (llvm::none_of(Str, isUpper))
+    return Str;
+  Storage.resize(Str.size());
+  llvm::transform(Str, Storage.begin(), toLower);
+  return StringRef(Storage.data(), Storage.size());
+}
+
 /// ParseStatement:
 ///   ::= EndOfStatement
 ///   ::= Label* Directive ...Operands... EndOfStatement
@@ -1848,8 +1866,9 @@ bool AsmParser::parseStatement(ParseStatementInfo &Info,
   // Handle conditional assembly here before checking for skipping.  We
   // have to do this so that .endif isn't skipped in a ".if 0" block for
   // example.
+  SmallString<32> LowerIDVal;
   StringMap<DirectiveKind>::const_iterator DirKindIt =
-      DirectiveKindMap.find(IDVal.lower());
+      DirectiveKindMap.find(lowerIfNeeded(IDVal, LowerIDVal));
   DirectiveKind DirKind = (DirKindIt == DirectiveKindMap.end())
                               ? DK_NO_DIRECTIVE
                               : DirKindIt->getValue();
@@ -2322,7 +2341,8 @@ bool AsmParser::parseAndMatchAndEmitTargetInstruction(ParseStatementInfo &Info,
                                                       AsmToken ID,
                                                       SMLoc IDLoc) {
   // Canonicalize the opcode to lower case.
-  std::string OpcodeStr = IDVal.lower();
+  SmallString<32> LowerIDVal;
+  StringRef OpcodeStr = lowerIfNeeded(IDVal, LowerIDVal);
   ParseInstructionInfo IInfo(Info.AsmRewrites);
   bool ParseHadError = getTargetParser().parseInstruction(IInfo, OpcodeStr, ID,
                                                           Info.ParsedOperands);
@@ -3209,7 +3229,20 @@ bool AsmParser::parseDirectiveValue(StringRef IDVal, unsigned Size) {
   auto parseOp = [&]() -> bool {
     const MCExpr *Value;
     SMLoc ExprLoc = getLexer().getLoc();
-    if (checkForValidSection() || parseExpression(Value))
+    if (checkForValidSection())
+      return true;
+    // Compilers emit plain integers, parse them without going through the
+    // expression parser.
+    if (isPlainInteger()) {
+      uint64_t IntValue = getTok().getIntVal();
+      Lex();
+      assert(Size <= 8 && "Invalid size");
+      if (!isUIntN(8 * Size, IntValue) && !isIntN(8 * Size, IntValue))
+        return Error(ExprLoc, "out of range literal value");
+      getStreamer().emitIntValue(IntValue, Size);
+      return false;
+    }
+    if (parseExpression(Value))
       return true;
     // Special case constant expressions to match code generator.
     if (const MCConstantExpr *MCE = dyn_cast<MCConstantExpr>(Value)) {
@@ -5029,8 +5062,12 @@ bool AsmParser::parseDirectiveLEB128(bool Signed) {
 
   auto parseOp = [&]() -> bool {
     const MCExpr *Value;
-    if (parseExpression(Value))
+    if (isPlainInteger()) {
+      Value = MCConstantExpr::create(getTok().getIntVal(), getContext());
+      Lex();
+    } else if (parseExpression(Value)) {
       return true;
+    }
     if (Signed)
       getStreamer().emitSLEB128Value(Value);
     else
@@ -0,0 +1,76 @@
+//===--------------------- SimulationSession.cpp ----------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file defines the SimulationSession class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "llvm/MCA/SimulationSession.h"
+#include "llvm/MCA/Pipeline.h"
+#include "llvm/MCA/SourceMgr.h"
+
+namespace llvm {
+namespace mca {
+
+SimulationSession::SimulationSession(const MCSubtargetInfo &STI,
+                                     const MCInstrInfo &MCII,
+                                     const MCRegisterInfo &MRI,
+                                     const MCInstrAnalysis *MCIA,
+                                     const PipelineOptions &PO,
+                                     unsigned Iterations, unsigned CallLatency)
+    : STI(STI), MRI(MRI), MCII(MCII), PO(PO),
+      Iterations(Iterations ? Iterations : 1), IM(STI, MCII),
+      IB(STI, MCII, MRI, MCIA, IM, CallLatency) {}
+
+Expected<unsigned> SimulationSession::simulate(ArrayRef<MCInst> Insts) {
+  if (Insts.empty())
+    return 0;
+
+  const SmallVector<Instrument *> Instruments;
+  SmallVector<std::unique_ptr<Instruction>> LoweredInsts;
+  LoweredInsts.reserve(Insts.size());
+  for (const MCInst &MCI : Insts) {
+    Expected<std::unique_ptr<Instruction>> Inst =
+        IB.createInstruction(MCI, Instruments);
+    if (!Inst)
+      return Inst.takeError();
+    LoweredInsts.emplace_back(std::move(*Inst));
+  }
+
+  // The hardware units are owned by the Context, so a new one starts every
+  // simulation from an empty pipeline.
+  Context MCA(MRI, STI);
+  CircularSourceMgr SM(LoweredInsts, Iterations);
+  CustomBehaviour CB(STI, SM, MCII);
+  std::unique_ptr<Pipeline> P = MCA.createDefaultPipeline(PO, SM, CB);
+  return P->run();
+}
+
+Expected<double> SimulationSession::estimateThroughput(ArrayRef<MCInst> Insts) {
+  Expected<unsigned> Cycles = simulate(Insts);
+  if (!Cycles)
+    return Cycles.takeError();
+  return double(*Cycles) / Iterations;
+}
+
+Error SimulationSession::estimateThroughputs(
+    ArrayRef<ArrayRef<MCInst>> Sequences,
+    SmallVectorImpl<double> &RThroughputs) {
+  RThroughputs.reserve(RThroughputs.size() + Sequences.size());
+  for (ArrayRef<MCInst> Insts : Sequences) {
+    Expected<double> RThroughput = estimateThroughput(Insts);
+    if (!RThroughput)
+      return RThroughput.takeError();
+    RThroughputs.push_back(*RThroughput);
+  }
+  return Error::success();
+}
+
+} // namespace mca
+} // namespace llvm
@@ -28,6 +28,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Memory.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -215,6 +216,9 @@ Error Object::compressOrDecompressSections(const CommonConfig &Config) {
   // because it would mutate the sections array.
   SmallVector<std::pair<SectionBase *, std::function<SectionBase *()>>, 0>
       ToReplace;
+  SmallVector<std::pair<const SectionBase *, DebugCompressionType>, 0>
+      ToCompress;
+  SmallVector<SmallVector<uint8_t, 128>, 0> CompressedData;
   for (SectionBase &Sec : sections()) {
     std::optional<DebugCompressionType> CType;
     for (auto &[Matcher, T] : Config.compressSections)
@@ -242,13 +246,23 @@ Error Object::compressOrDecompressSections(const CommonConfig &Config) {
         ToReplace.emplace_back(
             &Sec, [=] { return &addSection<DecompressedSection>(*CS); });
     } else if (*CType != DebugCompressionType::None) {
-      ToReplace.emplace_back(&Sec, [=, S = &Sec] {
-        return &addSection<CompressedSection>(
-            CompressedSection(*S, *CType, Is64Bits));
+      const size_t Index = ToCompress.size();
+      ToCompress.emplace_back(&Sec, *CType);
+      ToReplace.emplace_back(&Sec, [=, S = &Sec, &CompressedData] {
+        return &addSection<CompressedSection>(CompressedSection(
+            *S, *CType, Is64Bits, std::move(CompressedData[Index])));
       });
     }
   }
 
+  // Compress the sections in parallel before the replacement sections are
+  // added, which has to be done serially.
+  CompressedData.resize(ToCompress.size());
+  parallelFor(0, ToCompress.size(), [&](size_t I) {
+    CompressedData[I] = CompressedSection::compressData(*ToCompress[I].first,
+                                                        ToCompress[I].second);
+  });
+
   DenseMap<SectionBase *, SectionBase *> FromTo;
   for (auto [S, Func] : ToReplace)
     FromTo[S] = Func();
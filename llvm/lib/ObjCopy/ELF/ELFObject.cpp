@@ -18,6 +18,7 @@
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include <algorithm>
 #include <cstddef>
@@ -554,14 +555,31 @@ Error ELFSectionWriter<ELFT>::visit(const CompressedSection &Sec) {
   return Error::success();
 }
 
+SmallVector<uint8_t, 128>
+CompressedSection::compressData(const SectionBase &Sec,
+                                DebugCompressionType CompressionType) {
+  // Large debug sections are compressed into independent zstd frames in
+  // parallel, which does not affect the output determinism.
+  compression::Params P(CompressionType);
+  P.zstdParallel = true;
+  SmallVector<uint8_t, 128> CompressedData;
+  compression::compress(P, Sec.OriginalData, CompressedData);
+  return CompressedData;
+}
+
 CompressedSection::CompressedSection(const SectionBase &Sec,
                                      DebugCompressionType CompressionType,
                                      bool Is64Bits)
-    : SectionBase(Sec), CompressionType(CompressionType),
-      DecompressedSize(Sec.OriginalData.size()), DecompressedAlign(Sec.Align) {
-  compression::compress(compression::Params(CompressionType), OriginalData,
-                        CompressedData);
+    : CompressedSection(Sec, CompressionType, Is64Bits,
+                        compressData(Sec, CompressionType)) {}
 
+CompressedSection::CompressedSection(const SectionBase &Sec,
+                                     DebugCompressionType CompressionType,
+                                     bool Is64Bits,
+                                     SmallVector<uint8_t, 128> CompressedData)
+    : SectionBase(Sec), CompressionType(CompressionType),
+      DecompressedSize(Sec.OriginalData.size()), DecompressedAlign(Sec.Align),
+      CompressedData(std::move(CompressedData)) {
   Flags |= ELF::SHF_COMPRESSED;
   OriginalFlags |= ELF::SHF_COMPRESSED;
   size_t ChdrSize = Is64Bits ? sizeof(object::Elf_Chdr_Impl<object::ELF64LE>)
@@ -2108,15 +2126,33 @@ template <class ELFT> void ELFWriter<ELFT>::writeShdrs() {
 }
 
 template <class ELFT> Error ELFWriter<ELFT>::writeSectionData() {
+  // Segments are responsible for writing their contents, so only write the
+  // section data if the section is not in a segment. Note that this renders
+  // sections in segments effectively immutable.
+  SmallVector<SectionBase *, 0> ToWrite;
   for (SectionBase &Sec : Obj.sections())
-    // Segments are responsible for writing their contents, so only write the
-    // section data if the section is not in a segment. Note that this renders
-    // sections in segments effectively immutable.
     if (Sec.ParentSegment == nullptr)
-      if (Error Err = Sec.accept(*SecWriter))
-        return Err;
-
-  return Error::success();
+      ToWrite.push_back(&Sec);
+
+  // The sections are laid out at distinct offsets, so they are written in
+  // parallel. This decompresses the sections at the same time, and copies the
+  // large sections on other threads. Only the first error is reported, as
+  // with a serial write.
+  SmallVector<std::optional<Error>, 0> Errors(ToWrite.size());
+  parallelFor(0, ToWrite.size(), [&](size_t I) {
+    if (Error Err = ToWrite[I]->accept(*SecWriter))
+      Errors[I] = std::move(Err);
+  });
+  Error FirstErr = Error::success();
+  for (std::optional<Error> &Err : Errors) {
+    if (!Err)
+      continue;
+    if (FirstErr)
+      consumeError(std::move(*Err));
+    else
+      FirstErr = std::move(*Err);
+  }
+  return FirstErr;
 }
 
 template <class ELFT> void ELFWriter<ELFT>::writeSegmentData() {
@@ -668,6 +668,11 @@ class CompressedSection : public SectionBase {
 public:
   CompressedSection(const SectionBase &Sec,
     DebugCompressionType CompressionType, bool Is64Bits);
+  /// Create the section from the contents of \p Sec, already compressed into
+  /// \p CompressedData.
+  CompressedSection(const SectionBase &Sec,
+                    DebugCompressionType CompressionType, bool Is64Bits,
+                    SmallVector<uint8_t, 128> CompressedData);
   CompressedSection(ArrayRef<uint8_t> CompressedData, uint32_t ChType,
                     uint64_t DecompressedSize, uint64_t DecompressedAlign);
 
@@ -675,6 +680,10 @@ public:
   uint64_t getDecompressedAlign() const { return DecompressedAlign; }
   uint64_t getChType() const { return ChType; }
 
+  /// Return the contents of \p Sec compressed with \p CompressionType.
+  static SmallVector<uint8_t, 128>
+  compressData(const SectionBase &Sec, DebugCompressionType CompressionType);
+
   Error accept(SectionVisitor &Visitor) const override;
   Error accept(MutableSectionVisitor &Visitor) override;
 
@@ -12,6 +12,7 @@
 
 #include "llvm/Object/ArchiveWriter.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
@@ -31,6 +32,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -846,15 +848,51 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
   std::vector<std::unique_ptr<SymbolicFile>> SymFiles;
 
   if (NeedSymbols != SymtabWritingMode::NoSymtab || isAIXBigArchive(Kind)) {
-    for (const NewArchiveMember &M : NewMembers) {
-      Expected<std::unique_ptr<SymbolicFile>> SymFileOrErr = getSymbolicFile(
-          M.Buf->getMemBufferRef(), Context, Kind, [&](Error Err) {
+    // Parsing the members dominates the time spent on large archives, so the
+    // object files are parsed in parallel. Bitcode files share the
+    // LLVMContext, and are parsed afterwards on this thread, which is also
+    // the only one that reports warnings.
+    SymFiles.resize(NewMembers.size());
+    std::vector<std::optional<Error>> Errors(NewMembers.size());
+    parallelFor(0, NewMembers.size(), [&](size_t I) {
+      MemoryBufferRef Buf = NewMembers[I].Buf->getMemBufferRef();
+      if (identify_magic(Buf.getBuffer()) == file_magic::bitcode)
+        return;
+      Expected<std::unique_ptr<SymbolicFile>> SymFileOrErr =
+          getSymbolicFile(Buf, Context, Kind, [](Error Err) {
+            llvm_unreachable("only bitcode files report warnings");
+          });
+      if (SymFileOrErr)
+        SymFiles[I] = std::move(*SymFileOrErr);
+      else
+        Errors[I] = SymFileOrErr.takeError();
+    });
+
+    Error FirstErr = Error::success();
+    for (auto [I, M] : enumerate(NewMembers)) {
+      if (FirstErr) {
+        if (Errors[I])
+          consumeError(std::move(*Errors[I]));
+        continue;
+      }
+      if (Errors[I]) {
+        FirstErr = createFileError(M.MemberName, std::move(*Errors[I]));
+        continue;
+      }
+      MemoryBufferRef Buf = M.Buf->getMemBufferRef();
+      if (identify_magic(Buf.getBuffer()) != file_magic::bitcode)
+        continue;
+      Expected<std::unique_ptr<SymbolicFile>> SymFileOrErr =
+          getSymbolicFile(Buf, Context, Kind, [&](Error Err) {
             Warn(createFileError(M.MemberName, std::move(Err)));
           });
-      if (!SymFileOrErr)
-        return createFileError(M.MemberName, SymFileOrErr.takeError());
-      SymFiles.push_back(std::move(*SymFileOrErr));
+      if (SymFileOrErr)
+        SymFiles[I] = std::move(*SymFileOrErr);
+      else
+        FirstErr = createFileError(M.MemberName, SymFileOrErr.takeError());
     }
+    if (FirstErr)
+      return std::move(FirstErr);
   }
 
   if (SymMap) {
@@ -113,15 +113,15 @@ struct Builder {
 
   Expected<int> getComdatIndex(const Comdat *C, const Module *M);
 
-  Error addModule(Module *M);
+  Error addModule(Module *M, const BitcodeLTOInfo *LTOInfo);
   Error addSymbol(const ModuleSymbolTable &Msymtab,
                   const SmallPtrSet<GlobalValue *, 4> &Used,
                   ModuleSymbolTable::Symbol Sym);
 
-  Error build(ArrayRef<Module *> Mods);
+  Error build(ArrayRef<Module *> Mods, ArrayRef<BitcodeLTOInfo> LTOInfos);
 };
 
-Error Builder::addModule(Module *M) {
+Error Builder::addModule(Module *M, const BitcodeLTOInfo *LTOInfo) {
   if (M->getDataLayoutStr().empty())
     return make_error<StringError>("input module has no datalayout",
                                    inconvertibleErrorCode());
@@ -149,6 +149,18 @@ Error Builder::addModule(Module *M) {
   Mod.Begin = Syms.size();
   Mod.End = Syms.size() + Msymtab.symbols().size();
   Mod.UncBegin = Uncommons.size();
+  Mod.Flags = 0;
+  if (LTOInfo) {
+    Mod.Flags |= 1 << storage::Module::FB_has_lto_info;
+    if (LTOInfo->HasSummary)
+      Mod.Flags |= 1 << storage::Module::FB_has_summary;
+    if (LTOInfo->IsThinLTO)
+      Mod.Flags |= 1 << storage::Module::FB_thin_lto;
+    if (LTOInfo->EnableSplitLTOUnit)
+      Mod.Flags |= 1 << storage::Module::FB_split_lto_unit;
+    if (LTOInfo->UnifiedLTO)
+      Mod.Flags |= 1 << storage::Module::FB_unified_lto;
+  }
   Mods.push_back(Mod);
 
   if (TT.isOSBinFormatCOFF()) {
@@ -344,18 +356,22 @@ Error Builder::addSymbol(const ModuleSymbolTable &Msymtab,
   return Error::success();
 }
 
-Error Builder::build(ArrayRef<Module *> IRMods) {
+Error Builder::build(ArrayRef<Module *> IRMods,
+                     ArrayRef<BitcodeLTOInfo> LTOInfos) {
   storage::Header Hdr;
 
   assert(!IRMods.empty());
+  assert((LTOInfos.empty() || LTOInfos.size() == IRMods.size()) &&
+         "Expected LTO information for every module");
   Hdr.Version = storage::Header::kCurrentVersion;
   setStr(Hdr.Producer, kExpectedProducerName);
   setStr(Hdr.TargetTriple, IRMods[0]->getTargetTriple());
   setStr(Hdr.SourceFileName, IRMods[0]->getSourceFileName());
   TT = Triple(IRMods[0]->getTargetTriple());
 
-  for (auto *M : IRMods)
-    if (Error Err = addModule(M))
+  for (unsigned I = 0, E = IRMods.size(); I != E; ++I)
+    if (Error Err =
+            addModule(IRMods[I], LTOInfos.empty() ? nullptr : &LTOInfos[I]))
       return Err;
 
   COFFLinkerOptsOS.flush();
@@ -377,8 +393,9 @@ Error Builder::build(ArrayRef<Module *> IRMods) {
 
 Error irsymtab::build(ArrayRef<Module *> Mods, SmallVector<char, 0> &Symtab,
                       StringTableBuilder &StrtabBuilder,
-                      BumpPtrAllocator &Alloc) {
-  return Builder(Symtab, StrtabBuilder, Alloc).build(Mods);
+                      BumpPtrAllocator &Alloc,
+                      ArrayRef<BitcodeLTOInfo> LTOInfos) {
+  return Builder(Symtab, StrtabBuilder, Alloc).build(Mods, LTOInfos);
 }
 
 // Upgrade a vector of bitcode modules created by an old version of LLVM by
@@ -389,7 +406,13 @@ static Expected<FileContents> upgrade(ArrayRef<BitcodeModule> BMs) {
   LLVMContext Ctx;
   std::vector<Module *> Mods;
   std::vector<std::unique_ptr<Module>> OwnedMods;
+  std::vector<BitcodeLTOInfo> LTOInfos;
   for (auto BM : BMs) {
+    Expected<BitcodeLTOInfo> LTOInfoOrErr = BM.getLTOInfo();
+    if (!LTOInfoOrErr)
+      return LTOInfoOrErr.takeError();
+    LTOInfos.push_back(*LTOInfoOrErr);
+
     Expected<std::unique_ptr<Module>> MOrErr =
         BM.getLazyModule(Ctx, /*ShouldLazyLoadMetadata*/ true,
                          /*IsImporting*/ false);
@@ -402,7 +425,7 @@ static Expected<FileContents> upgrade(ArrayRef<BitcodeModule> BMs) {
 
   StringTableBuilder StrtabBuilder(StringTableBuilder::RAW);
   BumpPtrAllocator Alloc;
-  if (Error E = build(Mods, FC.Symtab, StrtabBuilder, Alloc))
+  if (Error E = build(Mods, FC.Symtab, StrtabBuilder, Alloc, LTOInfos))
     return std::move(E);
 
   StrtabBuilder.finalizeInOrder();
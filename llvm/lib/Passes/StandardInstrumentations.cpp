@@ -14,6 +14,7 @@
 
 #include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/ADT/Any.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
 #include "llvm/Analysis/LazyCallGraph.h"
@@ -145,6 +146,19 @@ static cl::opt<bool>
                     cl::desc("Dump dropped debug variables stats"),
                     cl::init(false));
 
+static cl::list<std::string> SkipUnchangedPassList(
+    "skip-unchanged-passes", cl::CommaSeparated, cl::Hidden,
+    cl::desc("Skip the given idempotent function passes on functions that "
+             "have not changed since the pass last ran on them"),
+    cl::value_desc("pass names"));
+
+#define DEBUG_TYPE "skip-unchanged-passes"
+STATISTIC(NumSkippedUnchanged,
+          "Number of pass runs skipped on unchanged functions");
+STATISTIC(SkippedUnchangedMicroseconds,
+          "Estimated time saved by skipping pass runs, in microseconds");
+#undef DEBUG_TYPE
+
 template <typename IRUnitT> static const IRUnitT *unwrapIR(Any IR) {
   const IRUnitT **IRPtr = llvm::any_cast<const IRUnitT *>(&IR);
   return IRPtr ? *IRPtr : nullptr;
@@ -164,6 +178,13 @@ static cl::opt<std::string>
                 cl::desc("exe called with module IR after each pass that "
                          "changes it"));
 
+// The number of threads Verify Each uses to verify the functions of a module
+// after a module or CGSCC pass.
+static cl::opt<unsigned> VerifyEachThreads(
+    "verify-each-threads", cl::Hidden, cl::init(1),
+    cl::desc("Number of threads to verify the functions of a module on "
+             "after each pass, 0 for all hardware threads"));
+
 /// Extract Module out of \p IR unit. May return nullptr if \p IR does not match
 /// certain global filters. Will never return nullptr if \p Force is true.
 const Module *unwrapModule(Any IR, bool Force = false) {
@@ -1063,6 +1084,86 @@ bool OptNoneInstrumentation::shouldRun(StringRef PassID, Any IR) {
   return ShouldRun;
 }
 
+void SkipUnchangedPassesInstrumentation::registerCallbacks(
+    PassInstrumentationCallbacks &PIC) {
+  if (SkipUnchangedPassList.empty())
+    return;
+  this->PIC = &PIC;
+  for (const std::string &Name : SkipUnchangedPassList)
+    TrackedPasses.insert(Name);
+  PIC.registerShouldRunOptionalPassCallback(
+      [this](StringRef P, Any IR) { return this->shouldRun(P, IR); });
+  PIC.registerBeforeNonSkippedPassCallback([this](StringRef P, Any IR) {
+    if (unwrapIR<Function>(IR) && isTracked(P))
+      StartTime = std::chrono::steady_clock::now();
+  });
+  PIC.registerAfterPassCallback(
+      [this](StringRef P, Any IR, const PreservedAnalyses &PA) {
+        this->runAfterPass(P, IR, PA);
+      });
+}
+
+bool SkipUnchangedPassesInstrumentation::isTracked(StringRef PassID) {
+  return TrackedPasses.contains(PassID) ||
+         TrackedPasses.contains(PIC->getPassNameForClassName(PassID));
+}
+
+// The name is part of the hash so that a function allocated at the address of
+// a deleted one does not inherit its state.
+static stable_hash hashFunction(const Function &F) {
+  return stable_hash_combine(StructuralHash(F, /*DetailedHash=*/true),
+                             xxh3_64bits(F.getName()));
+}
+
+bool SkipUnchangedPassesInstrumentation::shouldRun(StringRef PassID, Any IR) {
+  const auto *F = unwrapIR<Function>(IR);
+  if (!F || !isTracked(PassID))
+    return true;
+
+  HashBeforeRun = hashFunction(*F);
+  HashedFunction = F;
+  auto It = Functions.find(F);
+  if (It != Functions.end() && It->second.Hash == HashBeforeRun) {
+    auto PassIt = It->second.Passes.find(PassID);
+    if (PassIt != It->second.Passes.end()) {
+      ++NumSkippedUnchanged;
+      SkippedUnchangedMicroseconds += PassIt->second * 1e6;
+      return false;
+    }
+  }
+  return true;
+}
+
+void SkipUnchangedPassesInstrumentation::runAfterPass(
+    StringRef PassID, Any IR, const PreservedAnalyses &PA) {
+  const auto *F = unwrapIR<Function>(IR);
+  if (!F)
+    return;
+
+  if (!isTracked(PassID)) {
+    // Changes made by module and CGSCC passes are caught by comparing
+    // hashes before the next tracked pass.
+    if (!PA.areAllPreserved())
+      Functions.erase(F);
+    return;
+  }
+
+  std::chrono::duration<double> Elapsed =
+      std::chrono::steady_clock::now() - StartTime;
+  // Required passes do not go through shouldRun, so they have no hash from
+  // before the run.
+  stable_hash Hash = PA.areAllPreserved() && HashedFunction == F
+                         ? HashBeforeRun
+                         : hashFunction(*F);
+  HashedFunction = nullptr;
+  FunctionState &State = Functions[F];
+  if (State.Hash != Hash) {
+    State.Hash = Hash;
+    State.Passes.clear();
+  }
+  State.Passes[PassID] = Elapsed.count();
+}
+
 bool OptPassGateInstrumentation::shouldRun(StringRef PassName, Any IR) {
   if (isIgnored(PassName))
     return true;
@@ -1491,7 +1592,8 @@ void VerifyInstrumentation::registerCallbacks(PassInstrumentationCallbacks &PIC,
             if (DebugLogging)
               dbgs() << "Verifying module " << M->getName() << "\n";
 
-            if (verifyModule(*M, &errs()))
+            if (verifyModule(*M, &errs(), /*BrokenDebugInfo=*/nullptr,
+                             VerifyEachThreads))
               report_fatal_error(formatv("Broken module found after pass "
                                          "\"{0}\", compilation aborted!",
                                          P));
@@ -2530,6 +2632,7 @@ void StandardInstrumentations::registerCallbacks(
   TimePasses.registerCallbacks(PIC);
   OptNone.registerCallbacks(PIC);
   OptPassGate.registerCallbacks(PIC);
+  SkipUnchangedPasses.registerCallbacks(PIC);
   PrintChangedIR.registerCallbacks(PIC);
   PseudoProbeVerification.registerCallbacks(PIC);
   if (VerifyEach)
@@ -27,6 +27,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -793,9 +794,18 @@ public:
 
 } // namespace
 
-Error CoverageMapping::loadFunctionRecord(
-    const CoverageMappingRecord &Record,
-    IndexedInstrProfReader &ProfileReader) {
+struct CoverageMapping::PendingFunctionRecord {
+  StringRef FunctionName;
+  std::vector<StringRef> Filenames;
+  std::vector<CounterExpression> Expressions;
+  std::vector<CounterMappingRegion> MappingRegions;
+  std::vector<uint64_t> Counts;
+  BitVector Bitmap;
+};
+
+Error CoverageMapping::loadFunctionCounts(
+    const CoverageMappingRecord &Record, IndexedInstrProfReader &ProfileReader,
+    std::optional<PendingFunctionRecord> &Pending) {
   StringRef OrigFuncName = Record.FunctionName;
   if (OrigFuncName.empty())
     return make_error<CoverageMapError>(coveragemap_error::malformed,
@@ -821,7 +831,6 @@ Error CoverageMapping::loadFunctionRecord(
       return make_error<InstrProfError>(IPE);
     Counts.assign(getMaxCounterID(Ctx, Record) + 1, 0);
   }
-  Ctx.setCounts(Counts);
 
   bool IsVersion11 =
       ProfileReader.getVersion() < IndexedInstrProf::ProfVersion::Version12;
@@ -839,7 +848,6 @@ Error CoverageMapping::loadFunctionRecord(
       return make_error<InstrProfError>(IPE);
     Bitmap = BitVector(getMaxBitmapSize(Record, IsVersion11));
   }
-  Ctx.setBitmap(std::move(Bitmap));
 
   assert(!Record.MappingRegions.empty() && "Function has no regions");
 
@@ -852,9 +860,28 @@ Error CoverageMapping::loadFunctionRecord(
       Record.MappingRegions[0].Count.isZero() && Counts[0] > 0)
     return Error::success();
 
+  // The reader reuses the storage of the record for the next one.
+  Pending.emplace();
+  Pending->FunctionName = OrigFuncName;
+  Pending->Filenames.assign(Record.Filenames.begin(), Record.Filenames.end());
+  Pending->Expressions.assign(Record.Expressions.begin(),
+                              Record.Expressions.end());
+  Pending->MappingRegions.assign(Record.MappingRegions.begin(),
+                                 Record.MappingRegions.end());
+  Pending->Counts = std::move(Counts);
+  Pending->Bitmap = std::move(Bitmap);
+  return Error::success();
+}
+
+std::optional<FunctionRecord> CoverageMapping::evaluateFunctionRecord(
+    const PendingFunctionRecord &Pending, bool IsVersion11) {
+  CounterMappingContext Ctx(Pending.Expressions);
+  Ctx.setCounts(Pending.Counts);
+  Ctx.setBitmap(BitVector(Pending.Bitmap));
+
   MCDCDecisionRecorder MCDCDecisions;
-  FunctionRecord Function(OrigFuncName, Record.Filenames);
-  for (const auto &Region : Record.MappingRegions) {
+  FunctionRecord Function(Pending.FunctionName, Pending.Filenames);
+  for (const auto &Region : Pending.MappingRegions) {
     // MCDCDecisionRegion should be handled first since it overlaps with
     // others inside.
     if (Region.Kind == CounterMappingRegion::MCDCDecisionRegion) {
@@ -864,12 +891,12 @@ Error CoverageMapping::loadFunctionRecord(
     Expected<int64_t> ExecutionCount = Ctx.evaluate(Region.Count);
     if (auto E = ExecutionCount.takeError()) {
       consumeError(std::move(E));
-      return Error::success();
+      return std::nullopt;
     }
     Expected<int64_t> AltExecutionCount = Ctx.evaluate(Region.FalseCount);
     if (auto E = AltExecutionCount.takeError()) {
       consumeError(std::move(E));
-      return Error::success();
+      return std::nullopt;
     }
     Function.pushRegion(Region, *ExecutionCount, *AltExecutionCount);
 
@@ -897,18 +924,23 @@ Error CoverageMapping::loadFunctionRecord(
         Ctx.evaluateMCDCRegion(*MCDCDecision, MCDCBranches, IsVersion11);
     if (auto E = Record.takeError()) {
       consumeError(std::move(E));
-      return Error::success();
+      return std::nullopt;
     }
 
     // Save the MC/DC Record so that it can be visualized later.
     Function.pushMCDCRecord(std::move(*Record));
   }
+  return std::move(Function);
+}
 
+void CoverageMapping::addFunctionRecord(FunctionRecord &&Function,
+                                        ArrayRef<StringRef> Filenames) {
   // Don't create records for (filenames, function) pairs we've already seen.
-  auto FilenamesHash = hash_combine_range(Record.Filenames.begin(),
-                                          Record.Filenames.end());
-  if (!RecordProvenance[FilenamesHash].insert(hash_value(OrigFuncName)).second)
-    return Error::success();
+  auto FilenamesHash = hash_combine_range(Filenames.begin(), Filenames.end());
+  if (!RecordProvenance[FilenamesHash]
+           .insert(hash_value(StringRef(Function.Name)))
+           .second)
+    return;
 
   Functions.push_back(std::move(Function));
 
@@ -916,7 +948,7 @@ Error CoverageMapping::loadFunctionRecord(
   // which correspond to each filename. This can be used to substantially speed
   // up queries for coverage info in a file.
   unsigned RecordIndex = Functions.size() - 1;
-  for (StringRef Filename : Record.Filenames) {
+  for (StringRef Filename : Filenames) {
     auto &RecordIndices = FilenameHash2RecordIndices[hash_value(Filename)];
     // Note that there may be duplicates in the filename set for a function
     // record, because of e.g. macro expansions in the function in which both
@@ -924,8 +956,6 @@ Error CoverageMapping::loadFunctionRecord(
     if (RecordIndices.empty() || RecordIndices.back() != RecordIndex)
       RecordIndices.push_back(RecordIndex);
   }
-
-  return Error::success();
 }
 
 // This function is for memory optimization by shortening the lifetimes
@@ -936,14 +966,46 @@ Error CoverageMapping::loadFromReaders(
   assert(!Coverage.SingleByteCoverage ||
          *Coverage.SingleByteCoverage == ProfileReader.hasSingleByteCoverage());
   Coverage.SingleByteCoverage = ProfileReader.hasSingleByteCoverage();
+  bool IsVersion11 =
+      ProfileReader.getVersion() < IndexedInstrProf::ProfVersion::Version12;
+
+  // The records are read and their counters looked up serially, as neither
+  // the readers nor the profile reader are thread safe, and they are added
+  // in the order they were read. Evaluating the regions of the records, which
+  // is where most of the time goes, is done in parallel for batches of
+  // records.
+  constexpr size_t BatchSize = 4096;
+  std::vector<std::optional<PendingFunctionRecord>> Batch;
+  std::vector<std::optional<FunctionRecord>> Evaluated;
+  auto FlushBatch = [&]() {
+    Evaluated.clear();
+    Evaluated.resize(Batch.size());
+    parallelFor(0, Batch.size(), [&](size_t I) {
+      if (Batch[I])
+        Evaluated[I] = evaluateFunctionRecord(*Batch[I], IsVersion11);
+    });
+    for (auto [Pending, Function] : zip_equal(Batch, Evaluated))
+      if (Function)
+        Coverage.addFunctionRecord(std::move(*Function), Pending->Filenames);
+    Batch.clear();
+  };
+
   for (const auto &CoverageReader : CoverageReaders) {
     for (auto RecordOrErr : *CoverageReader) {
       if (Error E = RecordOrErr.takeError())
         return E;
       const auto &Record = *RecordOrErr;
-      if (Error E = Coverage.loadFunctionRecord(Record, ProfileReader))
+      std::optional<PendingFunctionRecord> Pending;
+      if (Error E = Coverage.loadFunctionCounts(Record, ProfileReader, Pending))
         return E;
+      if (!Pending)
+        continue;
+      Batch.push_back(std::move(Pending));
+      if (Batch.size() == BatchSize)
+        FlushBatch();
     }
+    // The filenames of the pending records may refer to the reader.
+    FlushBatch();
   }
   return Error::success();
 }
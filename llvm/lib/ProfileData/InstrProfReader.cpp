@@ -71,9 +71,13 @@ static InstrProfKind getProfileKindFromVersion(uint64_t Version) {
 }
 
 static Expected<std::unique_ptr<MemoryBuffer>>
-setupMemoryBuffer(const Twine &Filename, vfs::FileSystem &FS) {
-  auto BufferOrErr = Filename.str() == "-" ? MemoryBuffer::getSTDIN()
-                                           : FS.getBufferForFile(Filename);
+setupMemoryBuffer(const Twine &Filename, vfs::FileSystem &FS,
+                  bool RequiresNullTerminator = true) {
+  auto BufferOrErr =
+      Filename.str() == "-"
+          ? MemoryBuffer::getSTDIN()
+          : FS.getBufferForFile(Filename, /*FileSize=*/-1,
+                                RequiresNullTerminator);
   if (std::error_code EC = BufferOrErr.getError())
     return errorCodeToError(EC);
   return std::move(BufferOrErr.get());
@@ -201,8 +205,11 @@ Expected<std::unique_ptr<InstrProfReader>> InstrProfReader::create(
 Expected<std::unique_ptr<IndexedInstrProfReader>>
 IndexedInstrProfReader::create(const Twine &Path, vfs::FileSystem &FS,
                                const Twine &RemappingPath) {
-  // Set up the buffer to read.
-  auto BufferOrError = setupMemoryBuffer(Path, FS);
+  // Set up the buffer to read. The indexed format doesn't need a null
+  // terminator, so the file is always mapped rather than read, and the
+  // processes which read the same profile share its pages.
+  auto BufferOrError =
+      setupMemoryBuffer(Path, FS, /*RequiresNullTerminator=*/false);
   if (Error E = BufferOrError.takeError())
     return std::move(E);
 
@@ -1430,28 +1437,24 @@ Error IndexedInstrProfReader::readHeader() {
     // Expect at least two 64 bit fields: NumTraces, and TraceStreamSize
     if (Ptr + 2 * sizeof(uint64_t) > PtrEnd)
       return error(instrprof_error::truncated);
-    const uint64_t NumTraces =
+    NumTemporalProfTraces =
         support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
     TemporalProfTraceStreamSize =
         support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
-    for (unsigned i = 0; i < NumTraces; i++) {
+    // Only check the bounds of the traces here, getTemporalProfTraces decodes
+    // them.
+    TemporalProfTracesBuffer = Ptr;
+    for (uint64_t I = 0; I < NumTemporalProfTraces; I++) {
       // Expect at least two 64 bit fields: Weight and NumFunctions
       if (Ptr + 2 * sizeof(uint64_t) > PtrEnd)
         return error(instrprof_error::truncated);
-      TemporalProfTraceTy Trace;
-      Trace.Weight =
-          support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+      Ptr += sizeof(uint64_t);
       const uint64_t NumFunctions =
           support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
       // Expect at least NumFunctions 64 bit fields
-      if (Ptr + NumFunctions * sizeof(uint64_t) > PtrEnd)
+      if (NumFunctions > uint64_t(PtrEnd - Ptr) / sizeof(uint64_t))
         return error(instrprof_error::truncated);
-      for (unsigned j = 0; j < NumFunctions; j++) {
-        const uint64_t NameRef =
-            support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
-        Trace.FunctionNameRefs.push_back(NameRef);
-      }
-      TemporalProfTraces.push_back(std::move(Trace));
+      Ptr += NumFunctions * sizeof(uint64_t);
     }
   }
 
@@ -1491,6 +1494,28 @@ InstrProfSymtab &IndexedInstrProfReader::getSymtab() {
   return *Symtab;
 }
 
+SmallVector<TemporalProfTraceTy> &
+IndexedInstrProfReader::getTemporalProfTraces(std::optional<uint64_t> Weight) {
+  // As for the other non-raw profiles, the input weight is ignored.
+  if (const unsigned char *Ptr = TemporalProfTracesBuffer) {
+    TemporalProfTracesBuffer = nullptr;
+    for (uint64_t I = 0; I < NumTemporalProfTraces; I++) {
+      TemporalProfTraceTy Trace;
+      Trace.Weight =
+          support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+      const uint64_t NumFunctions =
+          support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+      Trace.FunctionNameRefs.reserve(NumFunctions);
+      for (uint64_t J = 0; J < NumFunctions; J++)
+        Trace.FunctionNameRefs.push_back(
+            support::endian::readNext<uint64_t, llvm::endianness::little>(
+                Ptr));
+      TemporalProfTraces.push_back(std::move(Trace));
+    }
+  }
+  return TemporalProfTraces;
+}
+
 Expected<InstrProfRecord> IndexedInstrProfReader::getInstrProfRecord(
     StringRef FuncName, uint64_t FuncHash, StringRef DeprecatedFuncName,
     uint64_t *MismatchedFuncSum) {
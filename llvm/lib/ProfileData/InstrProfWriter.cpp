@@ -111,8 +111,6 @@ public:
   using offset_type = uint64_t;
 
   llvm::endianness ValueProfDataEndianness = llvm::endianness::little;
-  InstrProfSummaryBuilder *SummaryBuilder;
-  InstrProfSummaryBuilder *CSSummaryBuilder;
 
   InstrProfRecordWriterTrait() = default;
 
@@ -150,17 +148,13 @@ public:
     Out.write(K.data(), N);
   }
 
+  // This may be called concurrently for different records.
   void EmitData(raw_ostream &Out, key_type_ref, data_type_ref V, offset_type) {
     using namespace support;
 
     endian::Writer LE(Out, llvm::endianness::little);
     for (const auto &ProfileData : *V) {
       const InstrProfRecord &ProfRecord = ProfileData.second;
-      if (NamedInstrProfRecord::hasCSFlagInHash(ProfileData.first))
-        CSSummaryBuilder->addRecord(ProfRecord);
-      else
-        SummaryBuilder->addRecord(ProfRecord);
-
       LE.write<uint64_t>(ProfileData.first); // Function hash
       LE.write<uint64_t>(ProfRecord.Counts.size());
       for (uint64_t I : ProfRecord.Counts)
@@ -887,18 +881,24 @@ Error InstrProfWriter::writeImpl(ProfOStream &OS) {
   OnDiskChainedHashTableGenerator<InstrProfRecordWriterTrait> Generator;
 
   InstrProfSummaryBuilder ISB(ProfileSummaryBuilder::DefaultCutoffs);
-  InfoObj->SummaryBuilder = &ISB;
   InstrProfSummaryBuilder CSISB(ProfileSummaryBuilder::DefaultCutoffs);
-  InfoObj->CSSummaryBuilder = &CSISB;
 
-  // Populate the hash table generator.
+  // Populate the hash table generator, and build the summaries of the records
+  // up front, as the records are serialized in parallel.
   SmallVector<std::pair<StringRef, const ProfilingData *>> OrderedData;
   for (const auto &I : FunctionData)
     if (shouldEncodeData(I.getValue()))
       OrderedData.emplace_back((I.getKey()), &I.getValue());
   llvm::sort(OrderedData, less_first());
-  for (const auto &I : OrderedData)
+  for (const auto &I : OrderedData) {
     Generator.insert(I.first, I.second);
+    for (const auto &ProfileData : *I.second) {
+      if (NamedInstrProfRecord::hasCSFlagInHash(ProfileData.first))
+        CSISB.addRecord(ProfileData.second);
+      else
+        ISB.addRecord(ProfileData.second);
+    }
+  }
 
   // Write the header.
   IndexedInstrProf::Header Header;
@@ -948,7 +948,7 @@ Error InstrProfWriter::writeImpl(ProfOStream &OS) {
   }
 
   // Write the hash table.
-  uint64_t HashTableStart = Generator.Emit(OS.OS, *InfoObj);
+  uint64_t HashTableStart = Generator.EmitParallel(OS.OS, *InfoObj);
 
   // Write the MemProf profile data if we have it.
   uint64_t MemProfSectionStart = 0;
@@ -989,7 +989,6 @@ Error InstrProfWriter::writeImpl(ProfOStream &OS) {
   // structure to be serialized out (to disk or buffer).
   std::unique_ptr<ProfileSummary> PS = ISB.getSummary();
   setSummary(TheSummary.get(), *PS);
-  InfoObj->SummaryBuilder = nullptr;
 
   // For Context Sensitive summary.
   std::unique_ptr<IndexedInstrProf::Summary> TheCSSummary = nullptr;
@@ -998,7 +997,6 @@ Error InstrProfWriter::writeImpl(ProfOStream &OS) {
     std::unique_ptr<ProfileSummary> CSPS = CSISB.getSummary();
     setSummary(TheCSSummary.get(), *CSPS);
   }
-  InfoObj->CSSummaryBuilder = nullptr;
 
   SmallVector<uint64_t, 8> HeaderOffsets = {HashTableStart, MemProfSectionStart,
                                             BinaryIdSectionStart,
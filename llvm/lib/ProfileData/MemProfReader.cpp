@@ -170,6 +170,7 @@ CallStackMap readStackInfo(const char *Ptr) {
   const uint64_t NumItemsToRead =
       endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
   CallStackMap Items;
+  Items.reserve(NumItemsToRead);
 
   for (uint64_t I = 0; I < NumItemsToRead; I++) {
     const uint64_t StackId =
@@ -184,7 +185,7 @@ CallStackMap readStackInfo(const char *Ptr) {
           endian::readNext<uint64_t, llvm::endianness::little>(Ptr));
     }
 
-    Items[StackId] = CallStack;
+    Items[StackId] = std::move(CallStack);
   }
   return Items;
 }
@@ -320,7 +321,7 @@ void RawMemProfReader::printYAML(raw_ostream &OS) {
   OS << "    NumSegments: " << SegmentInfo.size() << "\n";
   OS << "    NumMibInfo: " << NumMibInfo << "\n";
   OS << "    NumAllocFunctions: " << NumAllocFunctions << "\n";
-  OS << "    NumStackOffsets: " << StackMap.size() << "\n";
+  OS << "    NumStackOffsets: " << NumStackOffsets << "\n";
   // Print out the segment information.
   OS << "  Segments:\n";
   for (const auto &Entry : SegmentInfo) {
@@ -460,6 +461,11 @@ Error RawMemProfReader::mapRawProfileToRecords() {
   llvm::MapVector<GlobalValue::GUID, llvm::SetVector<LocationPtr>>
       PerFunctionCallSites;
 
+  // The raw call stacks and the symbolized frames are released as soon as
+  // they have been converted, so that they don't stay live alongside the
+  // records for the rest of the reader's lifetime.
+  NumStackOffsets = StackMap.size();
+
   // Convert the raw profile callstack data into memprof records. While doing so
   // keep track of related contexts so that we can fill these in later.
   for (const auto &[StackId, MIB] : CallstackProfileData) {
@@ -500,6 +506,7 @@ Error RawMemProfReader::mapRawProfileToRecords() {
       // Add all the frames to the current allocation callstack.
       Callstack.append(Frames.begin(), Frames.end());
     }
+    StackMap.erase(It);
 
     CallStackId CSId = MemProfData.addCallStack(Callstack);
 
@@ -523,6 +530,9 @@ Error RawMemProfReader::mapRawProfileToRecords() {
     for (LocationPtr Loc : Locs)
       Record.CallSiteIds.push_back(MemProfData.addCallStack(*Loc));
   }
+  PerFunctionCallSites.clear();
+  SymbolizedFrame = decltype(SymbolizedFrame)();
+  StackMap = CallStackMap();
 
   return Error::success();
 }
@@ -700,9 +710,9 @@ Error RawMemProfReader::readRawProfile(
 
     // Read in the callstack for each ids. For multiple raw profiles in the same
     // file, we expect that the callstack is the same for a unique id.
-    const CallStackMap CSM = readStackInfo(Next + Header->StackOffset);
+    CallStackMap CSM = readStackInfo(Next + Header->StackOffset);
     if (StackMap.empty()) {
-      StackMap = CSM;
+      StackMap = std::move(CSM);
     } else {
       if (mergeStackMap(CSM, StackMap))
         return make_error<InstrProfError>(
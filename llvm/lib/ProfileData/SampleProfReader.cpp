@@ -35,9 +35,11 @@
 #include "llvm/Support/LineIterator.h"
 #include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -1015,30 +1017,64 @@ std::error_code SampleProfileReaderExtBinaryBase::readProfileSymbolList() {
   return sampleprof_error::success;
 }
 
-std::error_code SampleProfileReaderExtBinaryBase::decompressSection(
-    const uint8_t *SecStart, const uint64_t SecSize,
-    const uint8_t *&DecompressBuf, uint64_t &DecompressBufSize) {
-  Data = SecStart;
-  End = SecStart + SecSize;
-  auto DecompressSize = readNumber<uint64_t>();
-  if (std::error_code EC = DecompressSize.getError())
-    return EC;
-  DecompressBufSize = *DecompressSize;
+bool SampleProfileReaderExtBinaryBase::skipSection(
+    const SecHdrTableEntry &Entry) const {
+  // Skip empty section, and sections without inlined functions when
+  // SkipFlatProf is true.
+  return !Entry.Size ||
+         (SkipFlatProf && hasSecFlag(Entry, SecCommonFlags::SecFlagFlat));
+}
 
-  auto CompressSize = readNumber<uint64_t>();
-  if (std::error_code EC = CompressSize.getError())
-    return EC;
+std::error_code SampleProfileReaderExtBinaryBase::decompressSections(
+    std::vector<std::pair<const uint8_t *, uint64_t>> &Decompressed) {
+  const uint8_t *BufStart =
+      reinterpret_cast<const uint8_t *>(Buffer->getBufferStart());
+  struct DecompressJob {
+    ArrayRef<uint8_t> Input;
+    uint8_t *Output;
+    size_t OutputSize;
+  };
+  SmallVector<DecompressJob, 4> Jobs;
+
+  // Read the section sizes and allocate the buffers first, as the allocator
+  // isn't thread safe.
+  Decompressed.assign(SecHdrTable.size(), {nullptr, 0});
+  for (auto [I, Entry] : enumerate(SecHdrTable)) {
+    if (skipSection(Entry) ||
+        !hasSecFlag(Entry, SecCommonFlags::SecFlagCompress))
+      continue;
+    Data = BufStart + Entry.Offset;
+    End = Data + Entry.Size;
+    auto DecompressSize = readNumber<uint64_t>();
+    if (std::error_code EC = DecompressSize.getError())
+      return EC;
+    auto CompressSize = readNumber<uint64_t>();
+    if (std::error_code EC = CompressSize.getError())
+      return EC;
+    if (*CompressSize > uint64_t(End - Data))
+      return sampleprof_error::truncated;
 
+    uint8_t *Buffer = Allocator.Allocate<uint8_t>(*DecompressSize);
+    Decompressed[I] = {Buffer, *DecompressSize};
+    Jobs.push_back({ArrayRef(Data, *CompressSize), Buffer, *DecompressSize});
+  }
+  if (Jobs.empty())
+    return sampleprof_error::success;
   if (!llvm::compression::zlib::isAvailable())
     return sampleprof_error::zlib_unavailable;
 
-  uint8_t *Buffer = Allocator.Allocate<uint8_t>(DecompressBufSize);
-  size_t UCSize = DecompressBufSize;
-  llvm::Error E = compression::zlib::decompress(ArrayRef(Data, *CompressSize),
-                                                Buffer, UCSize);
-  if (E)
+  std::atomic<bool> Failed = false;
+  parallelFor(0, Jobs.size(), [&](size_t I) {
+    DecompressJob &Job = Jobs[I];
+    size_t UCSize = Job.OutputSize;
+    if (Error E = compression::zlib::decompress(Job.Input, Job.Output,
+                                                UCSize)) {
+      consumeError(std::move(E));
+      Failed = true;
+    }
+  });
+  if (Failed)
     return sampleprof_error::uncompress_failed;
-  DecompressBuf = reinterpret_cast<const uint8_t *>(Buffer);
   return sampleprof_error::success;
 }
 
@@ -1046,32 +1082,25 @@ std::error_code SampleProfileReaderExtBinaryBase::readImpl() {
   const uint8_t *BufStart =
       reinterpret_cast<const uint8_t *>(Buffer->getBufferStart());
 
-  for (auto &Entry : SecHdrTable) {
-    // Skip empty section.
-    if (!Entry.Size)
-      continue;
+  // Decompressing large sections takes most of the time of reading a
+  // compressed profile, so all of them are decompressed at once.
+  std::vector<std::pair<const uint8_t *, uint64_t>> Decompressed;
+  if (std::error_code EC = decompressSections(Decompressed))
+    return EC;
 
-    // Skip sections without inlined functions when SkipFlatProf is true.
-    if (SkipFlatProf && hasSecFlag(Entry, SecCommonFlags::SecFlagFlat))
+  for (auto [I, Entry] : enumerate(SecHdrTable)) {
+    if (skipSection(Entry))
       continue;
 
     const uint8_t *SecStart = BufStart + Entry.Offset;
     uint64_t SecSize = Entry.Size;
 
-    // If the section is compressed, decompress it into a buffer
-    // DecompressBuf before reading the actual data. The pointee of
-    // 'Data' will be changed to buffer hold by DecompressBuf
-    // temporarily when reading the actual data.
+    // If the section is compressed, read the actual data from the buffer it
+    // was decompressed into. The pointee of 'Data' is changed to that buffer
+    // temporarily.
     bool isCompressed = hasSecFlag(Entry, SecCommonFlags::SecFlagCompress);
-    if (isCompressed) {
-      const uint8_t *DecompressBuf;
-      uint64_t DecompressBufSize;
-      if (std::error_code EC = decompressSection(
-              SecStart, SecSize, DecompressBuf, DecompressBufSize))
-        return EC;
-      SecStart = DecompressBuf;
-      SecSize = DecompressBufSize;
-    }
+    if (isCompressed)
+      std::tie(SecStart, SecSize) = Decompressed[I];
 
     if (std::error_code EC = readOneSection(SecStart, SecSize, Entry))
       return EC;
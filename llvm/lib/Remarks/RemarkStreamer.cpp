@@ -24,12 +24,21 @@ static cl::opt<cl::boolOrDefault> EnableRemarksSection(
         "this is enabled for the following formats: yaml-strtab, bitstream."),
     cl::init(cl::BOU_UNSET), cl::Hidden);
 
+static cl::opt<unsigned> RemarksSampleRate(
+    "remarks-sample-rate",
+    cl::desc("Only emit one out of every N remarks that match the pass "
+             "filter, to bound the cost of remarks on large builds. The "
+             "counts of the emitted remarks have to be scaled by N."),
+    cl::init(1), cl::Hidden);
+
 RemarkStreamer::RemarkStreamer(
     std::unique_ptr<remarks::RemarkSerializer> RemarkSerializer,
     std::optional<StringRef> FilenameIn)
     : RemarkSerializer(std::move(RemarkSerializer)),
       Filename(FilenameIn ? std::optional<std::string>(FilenameIn->str())
-                          : std::nullopt) {}
+                          : std::nullopt) {
+  setSampleRate(RemarksSampleRate);
+}
 
 Error RemarkStreamer::setFilter(StringRef Filter) {
   Regex R = Regex(Filter);
@@ -9,6 +9,8 @@
 // This file implements the localCache function, which simplifies creating,
 // adding to, and querying a local file system cache. localCache takes care of
 // periodically pruning older files from the cache using a CachePruningPolicy.
+// It also implements remoteBackedCache, which layers a local cache on top of a
+// RemoteCacheStore.
 //
 //===----------------------------------------------------------------------===//
 
@@ -17,6 +19,9 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <map>
+#include <mutex>
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
@@ -169,3 +174,116 @@ Expected<FileCache> llvm::localCache(const Twine &CacheNameRef,
   };
   return FileCache(Func, CacheDirectoryPathRef.str());
 }
+
+namespace {
+class DirectoryCacheStore : public RemoteCacheStore {
+public:
+  DirectoryCacheStore(const Twine &Path) : Path(Path.str()) {}
+
+  Expected<std::unique_ptr<MemoryBuffer>> get(StringRef Key) override {
+    SmallString<128> EntryPath;
+    sys::path::append(EntryPath, Path, "llvmcache-" + Key);
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+        MemoryBuffer::getFile(EntryPath, /*IsText=*/false,
+                              /*RequiresNullTerminator=*/false);
+    if (MBOrErr)
+      return std::move(*MBOrErr);
+    if (MBOrErr.getError() == errc::no_such_file_or_directory)
+      return nullptr;
+    return createFileError(EntryPath, MBOrErr.getError());
+  }
+
+  Error put(StringRef Key, MemoryBufferRef Data) override {
+    if (std::error_code EC =
+            sys::fs::create_directories(Path, /*IgnoreExisting=*/true))
+      return createFileError(Path, EC);
+
+    // Write to a temporary file and rename it, so that readers on other
+    // machines never see a partially written entry.
+    SmallString<128> EntryPath, TempFilenameModel;
+    sys::path::append(EntryPath, Path, "llvmcache-" + Key);
+    sys::path::append(TempFilenameModel, Path, "Remote-%%%%%%.tmp.o");
+    Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+        TempFilenameModel, sys::fs::owner_read | sys::fs::owner_write);
+    if (!Temp)
+      return Temp.takeError();
+    {
+      raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+      OS << Data.getBuffer();
+    }
+    if (Error E = Temp->keep(EntryPath))
+      return joinErrors(std::move(E), Temp->discard());
+    return Error::success();
+  }
+
+private:
+  std::string Path;
+};
+} // namespace
+
+std::unique_ptr<RemoteCacheStore>
+llvm::createDirectoryCacheStore(const Twine &Path) {
+  return std::make_unique<DirectoryCacheStore>(Path);
+}
+
+Expected<FileCache> llvm::remoteBackedCache(
+    const Twine &CacheNameRef, const Twine &TempFilePrefixRef,
+    const Twine &CacheDirectoryPathRef, std::shared_ptr<RemoteCacheStore> Store,
+    AddBufferFn AddBuffer) {
+  // Keys of the entries which missed both caches, indexed by task. When the
+  // local cache commits such an entry, it is also added to the store.
+  struct PendingPuts {
+    std::mutex Mu;
+    std::map<unsigned, std::string> Keys;
+  };
+  auto Pending = std::make_shared<PendingPuts>();
+
+  Expected<FileCache> LocalOrErr = localCache(
+      CacheNameRef, TempFilePrefixRef, CacheDirectoryPathRef,
+      [=](size_t Task, const Twine &ModuleName,
+          std::unique_ptr<MemoryBuffer> MB) {
+        std::string Key;
+        {
+          std::lock_guard<std::mutex> Lock(Pending->Mu);
+          auto It = Pending->Keys.find(Task);
+          if (It != Pending->Keys.end()) {
+            Key = std::move(It->second);
+            Pending->Keys.erase(It);
+          }
+        }
+        if (!Key.empty())
+          consumeError(Store->put(Key, MB->getMemBufferRef()));
+        AddBuffer(Task, ModuleName, std::move(MB));
+      });
+  if (!LocalOrErr)
+    return LocalOrErr.takeError();
+  FileCache Local = std::move(*LocalOrErr);
+
+  auto Func = [=](unsigned Task, StringRef Key,
+                  const Twine &ModuleName) mutable -> Expected<AddStreamFn> {
+    Expected<AddStreamFn> AddStreamOrErr = Local(Task, Key, ModuleName);
+    if (!AddStreamOrErr || !*AddStreamOrErr)
+      return AddStreamOrErr;
+    AddStreamFn &AddStream = *AddStreamOrErr;
+
+    // On a hit in the store, add the entry to the local cache, which also
+    // adds it to the link, and report a hit.
+    Expected<std::unique_ptr<MemoryBuffer>> MBOrErr = Store->get(Key);
+    if (!MBOrErr) {
+      consumeError(MBOrErr.takeError());
+    } else if (*MBOrErr) {
+      Expected<std::unique_ptr<CachedFileStream>> StreamOrErr =
+          AddStream(Task, ModuleName);
+      if (!StreamOrErr)
+        return StreamOrErr.takeError();
+      *(*StreamOrErr)->OS << (*MBOrErr)->getBuffer();
+      StreamOrErr->reset();
+      return AddStreamFn();
+    }
+
+    std::lock_guard<std::mutex> Lock(Pending->Mu);
+    Pending->Keys[Task] = Key.str();
+    return std::move(AddStream);
+  };
+  return FileCache(Func, CacheDirectoryPathRef.str());
+}
@@ -11,12 +11,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Compression.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Config/config.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #if LLVM_ENABLE_ZLIB
 #include <zlib.h>
 #endif
@@ -50,7 +53,10 @@ void compression::compress(Params P, ArrayRef<uint8_t> Input,
     zlib::compress(Input, Output, P.level);
     break;
   case compression::Format::Zstd:
-    zstd::compress(Input, Output, P.level, P.zstdEnableLdm);
+    if (P.zstdParallel)
+      zstd::compressParallel(Input, Output, P.level, P.zstdEnableLdm);
+    else
+      zstd::compress(Input, Output, P.level, P.zstdEnableLdm);
     break;
   }
 }
@@ -225,6 +231,62 @@ Error zstd::decompress(ArrayRef<uint8_t> Input,
   return E;
 }
 
+void zstd::compressParallel(ArrayRef<uint8_t> Input,
+                            SmallVectorImpl<uint8_t> &CompressedBuffer,
+                            int Level, bool EnableLdm, size_t BlockSize) {
+  assert(BlockSize && "block size must not be zero");
+  if (Input.size() <= BlockSize)
+    return zstd::compress(Input, CompressedBuffer, Level, EnableLdm);
+
+  size_t NumBlocks = divideCeil(Input.size(), BlockSize);
+  std::vector<SmallVector<uint8_t, 0>> Blocks(NumBlocks);
+  parallelFor(0, NumBlocks, [&](size_t I) {
+    size_t Begin = I * BlockSize;
+    size_t Size = std::min(BlockSize, Input.size() - Begin);
+    zstd::compress(Input.slice(Begin, Size), Blocks[I], Level, EnableLdm);
+  });
+
+  size_t CompressedSize = 0;
+  for (const SmallVector<uint8_t, 0> &Block : Blocks)
+    CompressedSize += Block.size();
+  CompressedBuffer.clear();
+  CompressedBuffer.reserve(CompressedSize);
+  for (const SmallVector<uint8_t, 0> &Block : Blocks)
+    CompressedBuffer.append(Block.begin(), Block.end());
+}
+
+Error zstd::decompressStreaming(
+    ArrayRef<uint8_t> Input, function_ref<Error(ArrayRef<uint8_t>)> Consumer) {
+  ZSTD_DCtx *Dctx = ZSTD_createDCtx();
+  if (!Dctx)
+    report_bad_alloc_error("Failed to create ZSTD_DCtx");
+  auto FreeDctx = make_scope_exit([&] { ZSTD_freeDCtx(Dctx); });
+
+  SmallVector<uint8_t, 0> Buffer;
+  Buffer.resize_for_overwrite(ZSTD_DStreamOutSize());
+  ZSTD_inBuffer In = {Input.data(), Input.size(), 0};
+  size_t Res;
+  bool OutputFull;
+  do {
+    ZSTD_outBuffer Out = {Buffer.data(), Buffer.size(), 0};
+    Res = ZSTD_decompressStream(Dctx, &Out, &In);
+    if (ZSTD_isError(Res))
+      return make_error<StringError>(ZSTD_getErrorName(Res),
+                                     inconvertibleErrorCode());
+    __msan_unpoison(Buffer.data(), Out.pos);
+    if (Out.pos)
+      if (Error E = Consumer(ArrayRef(Buffer.data(), Out.pos)))
+        return E;
+    // A full output buffer may leave decompressed data in the context.
+    OutputFull = Out.pos == Out.size;
+  } while (In.pos < In.size || OutputFull);
+
+  if (Res != 0)
+    return make_error<StringError>("Truncated zstd input",
+                                   inconvertibleErrorCode());
+  return Error::success();
+}
+
 #else
 bool zstd::isAvailable() { return false; }
 void zstd::compress(ArrayRef<uint8_t> Input,
@@ -241,4 +303,13 @@ Error zstd::decompress(ArrayRef<uint8_t> Input,
                        size_t UncompressedSize) {
   llvm_unreachable("zstd::decompress is unavailable");
 }
+void zstd::compressParallel(ArrayRef<uint8_t> Input,
+                            SmallVectorImpl<uint8_t> &CompressedBuffer,
+                            int Level, bool EnableLdm, size_t BlockSize) {
+  llvm_unreachable("zstd::compressParallel is unavailable");
+}
+Error zstd::decompressStreaming(
+    ArrayRef<uint8_t> Input, function_ref<Error(ArrayRef<uint8_t>)> Consumer) {
+  llvm_unreachable("zstd::decompressStreaming is unavailable");
+}
 #endif
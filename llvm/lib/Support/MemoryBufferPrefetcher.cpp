@@ -0,0 +1,64 @@
+//===- MemoryBufferPrefetcher.cpp - Load files in the background ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/MemoryBufferPrefetcher.h"
+#include "llvm/Config/llvm-config.h" // for LLVM_ENABLE_THREADS
+
+using namespace llvm;
+
+MemoryBufferPrefetcher::MemoryBufferPrefetcher(ThreadPoolStrategy S)
+    : Pool(S) {}
+
+MemoryBufferPrefetcher::~MemoryBufferPrefetcher() { Pool.wait(); }
+
+static MemoryBufferPrefetcher::BufferOrError
+loadFile(const std::string &Filename, bool IsText, bool RequiresNullTerminator,
+         bool IsVolatile) {
+  MemoryBufferPrefetcher::BufferOrError BufOrErr = MemoryBuffer::getFile(
+      Filename, IsText, RequiresNullTerminator, IsVolatile);
+  // Small files are read into memory by getFile. Mapped files only have their
+  // first pages in memory, if any, so start reading the rest now.
+  if (BufOrErr)
+    (*BufOrErr)->willNeedIfMmap();
+  return BufOrErr;
+}
+
+std::future<MemoryBufferPrefetcher::BufferOrError>
+MemoryBufferPrefetcher::prefetch(const Twine &Filename, bool IsText,
+                                 bool RequiresNullTerminator,
+                                 bool IsVolatile) {
+  auto Promise = std::make_shared<std::promise<BufferOrError>>();
+  std::future<BufferOrError> Future = Promise->get_future();
+#if LLVM_ENABLE_THREADS
+  // The buffer is moved out of the future, which the shared_future returned
+  // by ThreadPool::async does not allow, hence the promise.
+  Pool.async([Promise, Name = Filename.str(), IsText, RequiresNullTerminator,
+              IsVolatile] {
+    Promise->set_value(
+        loadFile(Name, IsText, RequiresNullTerminator, IsVolatile));
+  });
+#else
+  // Without threads the pool would only run the load when it is waited on,
+  // so load the file right away.
+  Promise->set_value(
+      loadFile(Filename.str(), IsText, RequiresNullTerminator, IsVolatile));
+#endif
+  return Future;
+}
+
+std::vector<std::future<MemoryBufferPrefetcher::BufferOrError>>
+MemoryBufferPrefetcher::prefetchAll(ArrayRef<std::string> Filenames,
+                                    bool IsText, bool RequiresNullTerminator,
+                                    bool IsVolatile) {
+  std::vector<std::future<BufferOrError>> Futures;
+  Futures.reserve(Filenames.size());
+  for (const std::string &Filename : Filenames)
+    Futures.push_back(
+        prefetch(Filename, IsText, RequiresNullTerminator, IsVolatile));
+  return Futures;
+}
@@ -21,15 +21,40 @@
 
 using namespace llvm;
 
+// The decimal representations of 00 to 99, so that format_to_buffer needs
+// one division per two digits.
+static constexpr char DigitPairs[] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
+static constexpr char LowerHexDigits[] = "0123456789abcdef";
+static constexpr char UpperHexDigits[] = "0123456789ABCDEF";
+
 template<typename T, std::size_t N>
 static int format_to_buffer(T Value, char (&Buffer)[N]) {
   char *EndPtr = std::end(Buffer);
   char *CurPtr = EndPtr;
 
-  do {
-    *--CurPtr = '0' + char(Value % 10);
-    Value /= 10;
-  } while (Value);
+  while (Value >= 100) {
+    const char *Pair = &DigitPairs[(Value % 100) * 2];
+    Value /= 100;
+    *--CurPtr = Pair[1];
+    *--CurPtr = Pair[0];
+  }
+  if (Value >= 10) {
+    const char *Pair = &DigitPairs[Value * 2];
+    *--CurPtr = Pair[1];
+    *--CurPtr = Pair[0];
+  } else {
+    *--CurPtr = '0' + char(Value);
+  }
   return EndPtr - CurPtr;
 }
 
@@ -59,6 +84,21 @@ static void write_unsigned_impl(raw_ostream &S, T N, size_t MinDigits,
   char NumberBuffer[128];
   size_t Len = format_to_buffer(N, NumberBuffer);
 
+  // Prepend the padding and the sign in the buffer, so that the common case
+  // is a single write to the stream.
+  if (Style != IntegerStyle::Number &&
+      std::max(Len, MinDigits) + IsNegative <= std::size(NumberBuffer)) {
+    char *Begin = std::end(NumberBuffer) - Len;
+    if (Len < MinDigits) {
+      Begin -= MinDigits - Len;
+      ::memset(Begin, '0', MinDigits - Len);
+    }
+    if (IsNegative)
+      *--Begin = '-';
+    S.write(Begin, std::end(NumberBuffer) - Begin);
+    return;
+  }
+
   if (IsNegative)
     S << '-';
 
@@ -146,21 +186,37 @@ void llvm::write_hex(raw_ostream &S, uint64_t N, HexPrintStyle Style,
   unsigned NumChars =
       std::max(static_cast<unsigned>(W), std::max(1u, Nibbles) + PrefixChars);
 
+  const char *Digits = Upper ? UpperHexDigits : LowerHexDigits;
   char NumberBuffer[kMaxWidth];
-  ::memset(NumberBuffer, '0', std::size(NumberBuffer));
-  if (Prefix)
-    NumberBuffer[1] = 'x';
   char *EndPtr = NumberBuffer + NumChars;
   char *CurPtr = EndPtr;
   while (N) {
-    unsigned char x = static_cast<unsigned char>(N) % 16;
-    *--CurPtr = hexdigit(x, !Upper);
-    N /= 16;
+    *--CurPtr = Digits[N & 15];
+    N >>= 4;
   }
+  ::memset(NumberBuffer, '0', CurPtr - NumberBuffer);
+  if (Prefix)
+    NumberBuffer[1] = 'x';
 
   S.write(NumberBuffer, NumChars);
 }
 
+void llvm::write_hex_block(raw_ostream &S, ArrayRef<uint8_t> Bytes,
+                           bool Upper) {
+  const char *Digits = Upper ? UpperHexDigits : LowerHexDigits;
+  char Buffer[256];
+  while (!Bytes.empty()) {
+    ArrayRef<uint8_t> Chunk = Bytes.take_front(std::size(Buffer) / 2);
+    char *Out = Buffer;
+    for (uint8_t Byte : Chunk) {
+      *Out++ = Digits[Byte >> 4];
+      *Out++ = Digits[Byte & 15];
+    }
+    S.write(Buffer, Out - Buffer);
+    Bytes = Bytes.drop_front(Chunk.size());
+  }
+}
+
 void llvm::write_double(raw_ostream &S, double N, FloatStyle Style,
                         std::optional<size_t> Precision) {
   size_t Prec = Precision.value_or(getDefaultPrecision(Style));
@@ -12,6 +12,8 @@
 #include "llvm/Support/Threading.h"
 
 #include <atomic>
+#include <chrono>
+#include <deque>
 #include <future>
 #include <thread>
 #include <vector>
@@ -26,6 +28,7 @@ namespace parallel {
 static thread_local unsigned threadIndex = UINT_MAX;
 
 unsigned getThreadIndex() { GET_THREAD_INDEX_IMPL; }
+unsigned getThreadIndexIfAvailable() { GET_THREAD_INDEX_IF_AVAILABLE_IMPL; }
 #else
 thread_local unsigned threadIndex = UINT_MAX;
 #endif
@@ -41,15 +44,27 @@ public:
   virtual void add(std::function<void()> func) = 0;
   virtual size_t getThreadCount() const = 0;
 
+  /// Run one of the pending closures on the calling thread, which must be a
+  /// thread of this executor. Returns false if there was none.
+  virtual bool runPendingTask() = 0;
+
   static Executor *getDefaultExecutor();
 };
 
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// An implementation of an Executor that runs closures on a thread pool.
+///
+/// Every worker has its own queue of closures. Closures added by a worker go
+/// to its own queue and are run in filo order. Closures added from other
+/// threads are distributed round-robin. A worker whose queue is empty steals
+/// the oldest closure from the queue of another worker, starting at a random
+/// one, so that the workers rarely contend on the same lock.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(ThreadPoolStrategy S) {
     ThreadCount = S.compute_thread_count();
+    Queues = std::make_unique<WorkQueue[]>(ThreadCount);
+    for (unsigned I = 0; I < ThreadCount; ++I)
+      Queues[I].RandomState = I + 1;
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     Threads.reserve(ThreadCount);
@@ -98,33 +113,99 @@ public:
   };
 
   void add(std::function<void()> F) override {
+    unsigned Index =
+        threadIndex < ThreadCount ? threadIndex : NextQueue++ % ThreadCount;
+    // Count the closure before it becomes visible, so that the count of
+    // pending closures never drops below zero.
+    ++PendingTasks;
     {
+      std::lock_guard<std::mutex> Lock(Queues[Index].Mutex);
+      Queues[Index].Tasks.push_back(std::move(F));
+    }
+    if (NumSleeping) {
       std::lock_guard<std::mutex> Lock(Mutex);
-      WorkStack.push_back(std::move(F));
+      Cond.notify_one();
     }
-    Cond.notify_one();
   }
 
   size_t getThreadCount() const override { return ThreadCount; }
 
+  bool runPendingTask() override {
+    assert(threadIndex < ThreadCount && "not a thread of this executor");
+    std::function<void()> Task;
+    if (!takeTask(threadIndex, Task))
+      return false;
+    Task();
+    return true;
+  }
+
 private:
+  struct alignas(64) WorkQueue {
+    std::mutex Mutex;
+    std::deque<std::function<void()>> Tasks;
+    /// State of the generator for the steal order, only used by the owner.
+    uint32_t RandomState;
+  };
+
+  /// Take the newest closure from the queue of \p ThreadID or, failing that,
+  /// the oldest closure from the queue of another worker.
+  bool takeTask(unsigned ThreadID, std::function<void()> &Task) {
+    if (PendingTasks <= 0)
+      return false;
+    WorkQueue &Own = Queues[ThreadID];
+    {
+      std::lock_guard<std::mutex> Lock(Own.Mutex);
+      if (!Own.Tasks.empty()) {
+        Task = std::move(Own.Tasks.back());
+        Own.Tasks.pop_back();
+        --PendingTasks;
+        return true;
+      }
+    }
+    // Xorshift is good enough to spread the thieves over the queues.
+    uint32_t &R = Own.RandomState;
+    R ^= R << 13;
+    R ^= R >> 17;
+    R ^= R << 5;
+    for (unsigned I = 0, Victim = R % ThreadCount; I < ThreadCount;
+         ++I, Victim = Victim + 1 == ThreadCount ? 0 : Victim + 1) {
+      if (Victim == ThreadID)
+        continue;
+      WorkQueue &Q = Queues[Victim];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (Q.Tasks.empty())
+        continue;
+      Task = std::move(Q.Tasks.front());
+      Q.Tasks.pop_front();
+      --PendingTasks;
+      return true;
+    }
+    return false;
+  }
+
   void work(ThreadPoolStrategy S, unsigned ThreadID) {
     threadIndex = ThreadID;
     S.apply_thread_strategy(ThreadID);
-    while (true) {
+    while (!Stop) {
+      std::function<void()> Task;
+      if (takeTask(ThreadID, Task)) {
+        Task();
+        continue;
+      }
       std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
-      if (Stop)
-        break;
-      auto Task = std::move(WorkStack.back());
-      WorkStack.pop_back();
-      Lock.unlock();
-      Task();
+      ++NumSleeping;
+      Cond.wait(Lock, [&] { return Stop || PendingTasks > 0; });
+      --NumSleeping;
     }
   }
 
   std::atomic<bool> Stop{false};
-  std::vector<std::function<void()>> WorkStack;
+  std::unique_ptr<WorkQueue[]> Queues;
+  /// The number of closures added but not taken yet.
+  std::atomic<int64_t> PendingTasks{0};
+  /// The number of workers waiting on Cond for closures to be added.
+  std::atomic<unsigned> NumSleeping{0};
+  std::atomic<unsigned> NextQueue{0};
   std::mutex Mutex;
   std::condition_variable Cond;
   std::promise<void> ThreadsCreated;
@@ -174,20 +255,34 @@ size_t getThreadCount() {
 }
 #endif
 
-// Latch::sync() called by the dtor may cause one thread to block. If is a dead
-// lock if all threads in the default executor are blocked. To prevent the dead
-// lock, only allow the root TaskGroup to run tasks parallelly. In the scenario
-// of nested parallel_for_each(), only the outermost one runs parallelly.
+// Nested TaskGroups run their tasks in parallel too. A thread of the default
+// executor waiting for a TaskGroup runs pending tasks in the meantime instead
+// of blocking, see sync(), so the executor cannot run out of threads.
 TaskGroup::TaskGroup()
 #if LLVM_ENABLE_THREADS
-    : Parallel((parallel::strategy.ThreadsRequested != 1) &&
-               (threadIndex == UINT_MAX)) {}
+    : Parallel(parallel::strategy.ThreadsRequested != 1) {}
 #else
     : Parallel(false) {}
 #endif
 TaskGroup::~TaskGroup() {
   // We must ensure that all the workloads have finished before decrementing the
   // instances count.
+  sync();
+}
+
+void TaskGroup::sync() const {
+#if LLVM_ENABLE_THREADS
+  if (Parallel && threadIndex != UINT_MAX) {
+    detail::Executor *Exec = detail::Executor::getDefaultExecutor();
+    while (!L.isZero())
+      // The remaining tasks of this group may be running on other threads and
+      // spawn more tasks, so only wait for a short while if there is nothing
+      // to run.
+      if (!Exec->runPendingTask())
+        L.waitFor(std::chrono::microseconds(100));
+    return;
+  }
+#endif
   L.sync();
 }
 
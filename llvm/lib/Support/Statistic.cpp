@@ -93,6 +93,121 @@ public:
 static ManagedStatic<StatisticInfo> StatInfo;
 static ManagedStatic<sys::SmartMutex<true> > StatLock;
 
+namespace {
+/// The counters of the statistics for one thread, indexed by
+/// TrackingStatistic::ShardIndex. Only the thread that owns the shard updates
+/// its counters, with plain loads and stores rather than read-modify-write
+/// operations, so that bumping a statistic never moves a cache line between
+/// threads. Readers sum up the counters of all shards.
+///
+/// Shards live until the process exits. When a thread exits its shard is
+/// handed to the next new thread, which keeps the counts of the exited thread
+/// and bounds the number of shards by the peak number of threads.
+struct StatisticShard {
+  static constexpr unsigned ChunkSize = 1024;
+  static constexpr unsigned NumChunks = 64;
+  static constexpr unsigned MaxIndex = ChunkSize * NumChunks - 1;
+
+  /// The counters are allocated in chunks when first used, so that a thread
+  /// that bumps few statistics uses little memory.
+  std::atomic<std::atomic<uint64_t> *> Chunks[NumChunks] = {};
+  std::atomic<bool> InUse{true};
+  /// The next shard in ShardList. Set before the shard is published and never
+  /// changed afterwards.
+  StatisticShard *Next = nullptr;
+
+  /// Return the counter of \p Index, allocating it if needed. Only called by
+  /// the owner of the shard.
+  std::atomic<uint64_t> &getCounter(unsigned Index) {
+    std::atomic<uint64_t> *Chunk =
+        Chunks[Index / ChunkSize].load(std::memory_order_relaxed);
+    if (LLVM_UNLIKELY(!Chunk)) {
+      Chunk = new std::atomic<uint64_t>[ChunkSize]();
+      Chunks[Index / ChunkSize].store(Chunk, std::memory_order_release);
+    }
+    return Chunk[Index % ChunkSize];
+  }
+
+  /// Return the counter of \p Index if it is allocated, or null.
+  std::atomic<uint64_t> *findCounter(unsigned Index) const {
+    std::atomic<uint64_t> *Chunk =
+        Chunks[Index / ChunkSize].load(std::memory_order_acquire);
+    return Chunk ? &Chunk[Index % ChunkSize] : nullptr;
+  }
+};
+
+/// Gives the shard of a thread back when the thread exits.
+struct StatisticShardOwner {
+  StatisticShard *Shard = nullptr;
+  ~StatisticShardOwner() {
+    if (Shard)
+      Shard->InUse.store(false, std::memory_order_release);
+  }
+};
+} // end anonymous namespace
+
+/// All shards ever created. Shards are only pushed to the front, so readers
+/// can walk the list without a lock.
+static std::atomic<StatisticShard *> ShardList{nullptr};
+/// The index the next registered statistic gets. Guarded by StatLock.
+static unsigned NextShardIndex = 1;
+
+static LLVM_THREAD_LOCAL StatisticShard *CurrentShard = nullptr;
+
+static StatisticShard *acquireShard() {
+  static thread_local StatisticShardOwner Owner;
+  // Reuse the shard of a thread that exited, if any.
+  for (StatisticShard *S = ShardList.load(std::memory_order_acquire); S;
+       S = S->Next) {
+    bool Expected = false;
+    if (!S->InUse.load(std::memory_order_relaxed) &&
+        S->InUse.compare_exchange_strong(Expected, true,
+                                         std::memory_order_acquire)) {
+      Owner.Shard = CurrentShard = S;
+      return S;
+    }
+  }
+  auto *S = new StatisticShard();
+  S->Next = ShardList.load(std::memory_order_relaxed);
+  while (!ShardList.compare_exchange_weak(S->Next, S,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+  }
+  Owner.Shard = CurrentShard = S;
+  return S;
+}
+
+void TrackingStatistic::addToShard(unsigned Index, uint64_t V) {
+  StatisticShard *Shard = CurrentShard;
+  if (LLVM_UNLIKELY(!Shard))
+    Shard = acquireShard();
+  std::atomic<uint64_t> &Counter = Shard->getCounter(Index);
+  Counter.store(Counter.load(std::memory_order_relaxed) + V,
+                std::memory_order_relaxed);
+}
+
+uint64_t TrackingStatistic::sumShards(unsigned Index) {
+  uint64_t Sum = 0;
+  for (StatisticShard *S = ShardList.load(std::memory_order_acquire); S;
+       S = S->Next)
+    if (std::atomic<uint64_t> *Counter = S->findCounter(Index))
+      Sum += Counter->load(std::memory_order_relaxed);
+  return Sum;
+}
+
+static void clearShardCounters(unsigned Index) {
+  // Updates that other threads make concurrently may be lost, as with the
+  // assignment of a statistic that is being incremented.
+  for (StatisticShard *S = ShardList.load(std::memory_order_acquire); S;
+       S = S->Next)
+    if (std::atomic<uint64_t> *Counter = S->findCounter(Index))
+      Counter->store(0, std::memory_order_relaxed);
+}
+
+void TrackingStatistic::clearShards(unsigned Index) {
+  clearShardCounters(Index);
+}
+
 /// RegisterStatistic - The first time a statistic is bumped, this method is
 /// called.
 void TrackingStatistic::RegisterStatistic() {
@@ -113,6 +228,11 @@ void TrackingStatistic::RegisterStatistic() {
       return;
     if (EnableStats || Enabled)
       SI.addStatistic(this);
+    // A statistic keeps its index when it is reset. Statistics beyond the
+    // capacity of the shards are counted in Value directly.
+    if (!ShardIndex.load(std::memory_order_relaxed) &&
+        NextShardIndex <= StatisticShard::MaxIndex)
+      ShardIndex.store(NextShardIndex++, std::memory_order_relaxed);
 
     // Remember we have been registered.
     Initialized.store(true, std::memory_order_release);
@@ -163,6 +283,8 @@ void StatisticInfo::reset() {
     // iteration for that statistic will be lost as intended.
     Stat->Initialized = false;
     Stat->Value = 0;
+    if (unsigned I = Stat->ShardIndex.load(std::memory_order_relaxed))
+      clearShardCounters(I);
   }
 
   // Clear the registration list and release the lock once we're done. Any
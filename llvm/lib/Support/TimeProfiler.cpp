@@ -15,13 +15,16 @@
 #include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Threading.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -54,6 +57,9 @@ TimeTraceProfilerInstances &getTimeTraceProfilerInstances() {
 // Per Thread instance
 static LLVM_THREAD_LOCAL TimeTraceProfiler *TimeTraceProfilerInstance = nullptr;
 
+// Set by timeTraceProfilerRequestFlush, possibly from a signal handler.
+static std::atomic<bool> FlushRequested(false);
+
 TimeTraceProfiler *llvm::getTimeTraceProfilerInstance() {
   return TimeTraceProfilerInstance;
 }
@@ -126,11 +132,11 @@ struct InProgressEntry {
 
 struct llvm::TimeTraceProfiler {
   TimeTraceProfiler(unsigned TimeTraceGranularity = 0, StringRef ProcName = "",
-                    bool TimeTraceVerbose = false)
+                    bool TimeTraceVerbose = false, size_t MaxEntries = 0)
       : BeginningOfTime(system_clock::now()), StartTime(ClockType::now()),
         ProcName(ProcName), Pid(sys::Process::getProcessId()),
         Tid(llvm::get_threadid()), TimeTraceGranularity(TimeTraceGranularity),
-        TimeTraceVerbose(TimeTraceVerbose) {
+        TimeTraceVerbose(TimeTraceVerbose), MaxEntries(MaxEntries) {
     llvm::get_thread_name(ThreadName);
   }
 
@@ -185,9 +191,9 @@ struct llvm::TimeTraceProfiler {
 
     // Only include sections longer or equal to TimeTraceGranularity msec.
     if (duration_cast<microseconds>(Duration).count() >= TimeTraceGranularity) {
-      Entries.emplace_back(E);
+      addEntry(E);
       for (auto &IE : Iter->get()->InstantEvents) {
-        Entries.emplace_back(IE);
+        addEntry(IE);
       }
     }
 
@@ -206,15 +212,47 @@ struct llvm::TimeTraceProfiler {
     };
 
     Stack.erase(Iter);
+
+    if (!FlushPath.empty() &&
+        ((FlushInterval.count() && E.End - LastFlush >= FlushInterval) ||
+         (FlushRequested.load(std::memory_order_relaxed) &&
+          FlushRequested.exchange(false))))
+      flush();
+  }
+
+  void addEntry(const TimeTraceProfilerEntry &E) {
+    Entries.emplace_back(E);
+    if (MaxEntries && Entries.size() > MaxEntries) {
+      Entries.pop_front();
+      ++NumDroppedEntries;
+    }
+  }
+
+  // Write the events so far to FlushPath, through a temporary file so that
+  // readers never see a partial trace.
+  void flush() {
+    LastFlush = ClockType::now();
+    std::string TmpPath = FlushPath + ".tmp";
+    {
+      std::error_code EC;
+      raw_fd_ostream OS(TmpPath, EC, sys::fs::OF_TextWithCRLF);
+      if (EC)
+        return;
+      write(OS, /*IncludeOpenEntries=*/true);
+    }
+    if (sys::fs::rename(TmpPath, FlushPath))
+      sys::fs::remove(TmpPath);
   }
 
   // Write events from this TimeTraceProfilerInstance and
-  // ThreadTimeTraceProfilerInstances.
-  void write(raw_pwrite_stream &OS) {
+  // ThreadTimeTraceProfilerInstances. If IncludeOpenEntries is set, the
+  // sections of this instance that are still open are written as if they
+  // ended now.
+  void write(raw_pwrite_stream &OS, bool IncludeOpenEntries = false) {
     // Acquire Mutex as reading ThreadTimeTraceProfilerInstances.
     auto &Instances = getTimeTraceProfilerInstances();
     std::lock_guard<std::mutex> Lock(Instances.Lock);
-    assert(Stack.empty() &&
+    assert((IncludeOpenEntries || Stack.empty()) &&
            "All profiler sections should be ended when calling write");
     assert(llvm::all_of(Instances.List,
                         [](const auto &TTP) { return TTP->Stack.empty(); }) &&
@@ -276,6 +314,14 @@ struct llvm::TimeTraceProfiler {
     for (const TimeTraceProfiler *TTP : Instances.List)
       for (const TimeTraceProfilerEntry &E : TTP->Entries)
         writeEvent(E, TTP->Tid);
+    if (IncludeOpenEntries) {
+      TimePointType Now = ClockType::now();
+      for (const std::unique_ptr<InProgressEntry> &Open : Stack) {
+        TimeTraceProfilerEntry E = Open->Event;
+        E.End = Now;
+        writeEvent(E, this->Tid);
+      }
+    }
 
     // Emit totals by section name as additional "thread" events, sorted from
     // longest one.
@@ -360,11 +406,18 @@ struct llvm::TimeTraceProfiler {
                     .time_since_epoch()
                     .count());
 
+    // Report how many of the oldest events were dropped due to MaxEntries.
+    size_t Dropped = NumDroppedEntries;
+    for (const TimeTraceProfiler *TTP : Instances.List)
+      Dropped += TTP->NumDroppedEntries;
+    if (Dropped)
+      J.attribute("droppedEvents", int64_t(Dropped));
+
     J.objectEnd();
   }
 
   SmallVector<std::unique_ptr<InProgressEntry>, 16> Stack;
-  SmallVector<TimeTraceProfilerEntry, 128> Entries;
+  std::deque<TimeTraceProfilerEntry> Entries;
   StringMap<CountAndDurationType> CountAndTotalPerName;
   // System clock time when the session was begun.
   const time_point<system_clock> BeginningOfTime;
@@ -381,6 +434,16 @@ struct llvm::TimeTraceProfiler {
   // Make time trace capture verbose event details (e.g. source filenames). This
   // can increase the size of the output by 2-3 times.
   const bool TimeTraceVerbose;
+
+  // The maximum number of entries to keep, or zero if unlimited, and the
+  // number of entries that were dropped to stay below it.
+  const size_t MaxEntries;
+  size_t NumDroppedEntries = 0;
+
+  // Where and how often to write the profile while it is being recorded.
+  std::string FlushPath;
+  DurationType FlushInterval{};
+  TimePointType LastFlush;
 };
 
 bool llvm::isTimeTraceVerbose() {
@@ -390,12 +453,13 @@ bool llvm::isTimeTraceVerbose() {
 
 void llvm::timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
                                        StringRef ProcName,
-                                       bool TimeTraceVerbose) {
+                                       bool TimeTraceVerbose,
+                                       size_t MaxEntries) {
   assert(TimeTraceProfilerInstance == nullptr &&
          "Profiler should not be initialized");
   TimeTraceProfilerInstance = new TimeTraceProfiler(
       TimeTraceGranularity, llvm::sys::path::filename(ProcName),
-      TimeTraceVerbose);
+      TimeTraceVerbose, MaxEntries);
 }
 
 // Removes all TimeTraceProfilerInstances.
@@ -446,6 +510,19 @@ Error llvm::timeTraceProfilerWrite(StringRef PreferredFileName,
   return Error::success();
 }
 
+void llvm::timeTraceProfilerSetFlush(StringRef Path,
+                                     std::chrono::milliseconds Interval) {
+  assert(TimeTraceProfilerInstance != nullptr &&
+         "Profiler object can't be null");
+  TimeTraceProfilerInstance->FlushPath = Path.str();
+  TimeTraceProfilerInstance->FlushInterval = Interval;
+  TimeTraceProfilerInstance->LastFlush = ClockType::now();
+}
+
+void llvm::timeTraceProfilerRequestFlush() {
+  FlushRequested.store(true, std::memory_order_relaxed);
+}
+
 TimeTraceProfilerEntry *llvm::timeTraceProfilerBegin(StringRef Name,
                                                      StringRef Detail) {
   if (TimeTraceProfilerInstance != nullptr)
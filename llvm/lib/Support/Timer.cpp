@@ -240,10 +240,15 @@ namespace {
 
 typedef StringMap<Timer> Name2TimerMap;
 
+/// Incremented when a Name2PairMap is destroyed, which invalidates the timer
+/// caches of all threads.
+static std::atomic<unsigned> NamedTimersEpoch{0};
+
 class Name2PairMap {
   StringMap<std::pair<TimerGroup*, Name2TimerMap> > Map;
 public:
   ~Name2PairMap() {
+    NamedTimersEpoch.fetch_add(1, std::memory_order_release);
     for (StringMap<std::pair<TimerGroup*, Name2TimerMap> >::iterator
          I = Map.begin(), E = Map.end(); I != E; ++I)
       delete I->second.first;
@@ -251,6 +256,26 @@ public:
 
   Timer &get(StringRef Name, StringRef Description, StringRef GroupName,
              StringRef GroupDescription) {
+    // Named regions are usually entered many times. Cache the timers in the
+    // calling thread, so that TimerLock is only taken the first time a thread
+    // enters a region. The timers live as long as the map.
+    struct TimerCache {
+      unsigned Epoch = 0;
+      StringMap<Timer *> Timers;
+    };
+    static thread_local TimerCache Cache;
+    unsigned Epoch = NamedTimersEpoch.load(std::memory_order_acquire);
+    if (Cache.Epoch != Epoch) {
+      Cache.Timers.clear();
+      Cache.Epoch = Epoch;
+    }
+    SmallString<128> Key(GroupName);
+    Key.push_back('\0');
+    Key += Name;
+    Timer *&Cached = Cache.Timers[Key];
+    if (Cached)
+      return *Cached;
+
     sys::SmartScopedLock<true> L(*TimerLock);
 
     std::pair<TimerGroup*, Name2TimerMap> &GroupEntry = Map[GroupName];
@@ -261,6 +286,7 @@ public:
     Timer &T = GroupEntry.second[Name];
     if (!T.isInitialized())
       T.init(Name, Description, *GroupEntry.first);
+    Cached = &T;
     return T;
   }
 };
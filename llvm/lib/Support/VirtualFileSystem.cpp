@@ -2982,9 +2982,214 @@ void TracingFileSystem::printImpl(raw_ostream &OS, PrintType Type,
   getUnderlyingFS().print(OS, Type, IndentLevel + 1);
 }
 
+StringRef CachingFileSystem::getKey(const Twine &Path,
+                                    SmallVectorImpl<char> &Storage) const {
+  Path.toVector(Storage);
+  if (makeAbsolute(Storage))
+    Path.toVector(Storage);
+  return StringRef(Storage.data(), Storage.size());
+}
+
+void CachingFileSystem::flushIfFull() {
+  if (StatusCache.size() + DirCache.size() < MaxEntries)
+    return;
+  StatusCache.clear();
+  DirCache.clear();
+  ++Stats.Flushes;
+}
+
+ErrorOr<Status> CachingFileSystem::status(const Twine &Path) {
+  SmallString<256> Storage;
+  StringRef Key = getKey(Path, Storage);
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = StatusCache.find(Key);
+    if (It != StatusCache.end()) {
+      ++Stats.StatusHits;
+      if (!It->second)
+        return It->second.getError();
+      return Status::copyWithNewName(*It->second, Path);
+    }
+    ++Stats.StatusMisses;
+  }
+
+  ErrorOr<Status> Result = ProxyFileSystem::status(Key);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  flushIfFull();
+  StatusCache.insert_or_assign(Key, Result);
+  if (!Result)
+    return Result;
+  return Status::copyWithNewName(*Result, Path);
+}
+
+bool CachingFileSystem::exists(const Twine &Path) {
+  return bool(status(Path));
+}
+
+namespace {
+
+/// Iterates over a DirListing of a CachingFileSystem.
+class CachedDirIterImpl : public llvm::vfs::detail::DirIterImpl {
+  std::shared_ptr<const CachingFileSystem::DirListing> Listing;
+  size_t Index = 0;
+
+  void setCurrentEntry() {
+    if (Index < Listing->Entries.size())
+      CurrentEntry = Listing->Entries[Index];
+    else
+      CurrentEntry = directory_entry();
+  }
+
+public:
+  CachedDirIterImpl(std::shared_ptr<const CachingFileSystem::DirListing> L,
+                    std::error_code &EC)
+      : Listing(std::move(L)) {
+    setCurrentEntry();
+    EC = Listing->Entries.empty() ? Listing->EC : std::error_code();
+  }
+
+  std::error_code increment() override {
+    ++Index;
+    setCurrentEntry();
+    if (Index >= Listing->Entries.size())
+      return Listing->EC;
+    return {};
+  }
+};
+
+} // namespace
+
+directory_iterator CachingFileSystem::dir_begin(const Twine &Dir,
+                                                std::error_code &EC) {
+  SmallString<256> Storage;
+  StringRef Key = getKey(Dir, Storage);
+  std::shared_ptr<const DirListing> Listing;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = DirCache.find(Key);
+    if (It != DirCache.end()) {
+      ++Stats.DirHits;
+      if (!It->second) {
+        EC = It->second.getError();
+        return {};
+      }
+      Listing = *It->second;
+    } else {
+      ++Stats.DirMisses;
+    }
+  }
+
+  if (!Listing) {
+    std::error_code BeginEC;
+    directory_iterator I = ProxyFileSystem::dir_begin(Key, BeginEC);
+    if (BeginEC) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      flushIfFull();
+      DirCache.insert_or_assign(Key, BeginEC);
+      EC = BeginEC;
+      return {};
+    }
+    auto NewListing = std::make_shared<DirListing>();
+    for (directory_iterator E; I != E;) {
+      NewListing->Entries.push_back(*I);
+      I.increment(NewListing->EC);
+      if (NewListing->EC)
+        break;
+    }
+    Listing = std::move(NewListing);
+    // An incomplete listing is returned but not cached.
+    if (!Listing->EC) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      flushIfFull();
+      DirCache.insert_or_assign(Key, Listing);
+    }
+  }
+
+  // The underlying file system names the entries after Dir as given.
+  std::string DirStr = Dir.str();
+  if (DirStr != Key) {
+    auto Renamed = std::make_shared<DirListing>(*Listing);
+    for (directory_entry &Entry : Renamed->Entries) {
+      SmallString<256> Name(DirStr);
+      sys::path::append(Name, sys::path::filename(Entry.path()));
+      Entry = directory_entry(std::string(Name), Entry.type());
+    }
+    Listing = std::move(Renamed);
+  }
+  return directory_iterator(
+      std::make_shared<CachedDirIterImpl>(std::move(Listing), EC));
+}
+
+void CachingFileSystem::invalidate(const Twine &Path) {
+  SmallString<256> Storage;
+  StringRef Key = getKey(Path, Storage);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  // Unless Path is known to be a file, it may be a directory with cached
+  // entries below it.
+  bool MayBeDirectory = true;
+  auto It = StatusCache.find(Key);
+  if (It != StatusCache.end()) {
+    MayBeDirectory = !It->second || It->second->isDirectory();
+    StatusCache.erase(It);
+  }
+  DirCache.erase(Key);
+  DirCache.erase(sys::path::parent_path(Key));
+  if (!MayBeDirectory)
+    return;
+
+  // Entries below a changed directory, e.g. one that was removed or replaced,
+  // are stale as well.
+  auto IsBelow = [&](StringRef Name) {
+    return Name.size() > Key.size() && Name.starts_with(Key) &&
+           sys::path::is_separator(Name[Key.size()]);
+  };
+  for (auto I = StatusCache.begin(), E = StatusCache.end(); I != E;) {
+    auto Cur = I++;
+    if (IsBelow(Cur->getKey()))
+      StatusCache.erase(Cur);
+  }
+  for (auto I = DirCache.begin(), E = DirCache.end(); I != E;) {
+    auto Cur = I++;
+    if (IsBelow(Cur->getKey()))
+      DirCache.erase(Cur);
+  }
+}
+
+void CachingFileSystem::invalidateAll() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  StatusCache.clear();
+  DirCache.clear();
+}
+
+CachingFileSystem::Statistics CachingFileSystem::getStatistics() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return Stats;
+}
+
+void CachingFileSystem::printImpl(raw_ostream &OS, PrintType Type,
+                                  unsigned IndentLevel) const {
+  printIndent(OS, IndentLevel);
+  OS << "CachingFileSystem\n";
+  if (Type == PrintType::Summary)
+    return;
+
+  Statistics S = getStatistics();
+  printIndent(OS, IndentLevel);
+  OS << "StatusHits=" << S.StatusHits << " StatusMisses=" << S.StatusMisses
+     << "\n";
+  printIndent(OS, IndentLevel);
+  OS << "DirHits=" << S.DirHits << " DirMisses=" << S.DirMisses
+     << " Flushes=" << S.Flushes << "\n";
+
+  if (Type == PrintType::Contents)
+    Type = PrintType::Summary;
+  getUnderlyingFS().print(OS, Type, IndentLevel + 1);
+}
+
 const char FileSystem::ID = 0;
 const char OverlayFileSystem::ID = 0;
 const char ProxyFileSystem::ID = 0;
 const char InMemoryFileSystem::ID = 0;
 const char RedirectingFileSystem::ID = 0;
 const char TracingFileSystem::ID = 0;
+const char CachingFileSystem::ID = 0;
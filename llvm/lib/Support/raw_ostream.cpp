@@ -440,12 +440,14 @@ raw_ostream &raw_ostream::operator<<(const FormattedBytes &FB) {
 
     size_t CharsPrinted = 0;
     // Print the hex bytes for this line in groups
-    for (size_t I = 0; I < Line.size(); ++I, CharsPrinted += 2) {
-      if (I && (I % FB.ByteGroupSize) == 0) {
+    for (size_t I = 0; I < Line.size(); I += FB.ByteGroupSize) {
+      if (I) {
         ++CharsPrinted;
         *this << " ";
       }
-      llvm::write_hex(*this, Line[I], HPS, 2);
+      auto Group = Line.drop_front(I).take_front(FB.ByteGroupSize);
+      llvm::write_hex_block(*this, Group, FB.Upper);
+      CharsPrinted += Group.size() * 2;
     }
 
     if (FB.ASCII) {
@@ -858,6 +860,11 @@ size_t raw_fd_ostream::preferred_buffer_size() const {
   // the complexity.
   if (S_ISCHR(statbuf.st_mode) && is_displayed())
     return 0;
+  // Tools that dump large amounts of text to stdout spend a noticeable time
+  // in write(2) when it goes to a pipe or file, whose block size is usually
+  // only a few KiB. Use a larger buffer for stdout.
+  if (FD == STDOUT_FILENO)
+    return std::max<size_t>(statbuf.st_blksize, 64 * 1024);
   // Return the preferred block size.
   return statbuf.st_blksize;
 #endif
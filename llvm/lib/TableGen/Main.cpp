@@ -17,6 +17,7 @@
 #include "llvm/TableGen/Main.h"
 #include "TGLexer.h"
 #include "TGParser.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/CommandLine.h"
@@ -68,6 +69,13 @@ static cl::opt<bool> NoWarnOnUnusedTemplateArgs(
     "no-warn-on-unused-template-args",
     cl::desc("Disable unused template argument warnings."));
 
+static cl::list<std::string> ExtraOutputs(
+    "extra-output",
+    cl::desc("Also run the action <action> on the parsed records and write "
+             "its output to <filename>, e.g. -extra-output="
+             "gen-instr-info=XGenInstrInfo.inc"),
+    cl::value_desc("action=filename"));
+
 static int reportError(const char *ProgName, Twine Msg) {
   errs() << ProgName << ": " << Msg;
   errs().flush();
@@ -96,6 +104,28 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
+/// Write the output of a backend to \p Filename, honoring -write-if-changed.
+static int writeOutput(const char *argv0, StringRef Filename,
+                       StringRef OutString) {
+  if (WriteIfChanged) {
+    // Only updates the real output file if there are any differences.
+    // This prevents recompilation of all the files depending on it if there
+    // aren't any.
+    if (auto ExistingOrErr = MemoryBuffer::getFile(Filename, /*IsText=*/true))
+      if (std::move(ExistingOrErr.get())->getBuffer() == OutString)
+        return 0;
+  }
+  std::error_code EC;
+  ToolOutputFile OutFile(Filename, EC, sys::fs::OF_Text);
+  if (EC)
+    return reportError(argv0, "error opening " + Filename + ": " +
+                                  EC.message() + "\n");
+  OutFile.os() << OutString;
+  if (ErrorsPrinted == 0)
+    OutFile.keep();
+  return 0;
+}
+
 int llvm::TableGenMain(const char *argv0,
                        std::function<TableGenMainFn> MainFn) {
   RecordKeeper Records;
@@ -128,6 +158,16 @@ int llvm::TableGenMain(const char *argv0,
     return 1;
   Timer.stopTimer();
 
+  // Diagnose malformed extra outputs before running any backend.
+  SmallVector<std::pair<StringRef, StringRef>> Extras;
+  for (StringRef Extra : ExtraOutputs) {
+    auto [Action, Filename] = Extra.split('=');
+    if (Action.empty() || Filename.empty() || Filename == "-")
+      return reportError(argv0, "invalid -extra-output '" + Extra +
+                                    "', expected <action>=<filename>\n");
+    Extras.emplace_back(Action, Filename);
+  }
+
   // Write output to memory.
   Timer.startBackendTimer("Backend overall");
   std::string OutString;
@@ -151,28 +191,31 @@ int llvm::TableGenMain(const char *argv0,
   }
 
   Timer.startTimer("Write output");
-  bool WriteFile = true;
-  if (WriteIfChanged) {
-    // Only updates the real output file if there are any differences.
-    // This prevents recompilation of all the files depending on it if there
-    // aren't any.
-    if (auto ExistingOrErr =
-            MemoryBuffer::getFile(OutputFilename, /*IsText=*/true))
-      if (std::move(ExistingOrErr.get())->getBuffer() == OutString)
-        WriteFile = false;
-  }
-  if (WriteFile) {
-    std::error_code EC;
-    ToolOutputFile OutFile(OutputFilename, EC, sys::fs::OF_Text);
-    if (EC)
-      return reportError(argv0, "error opening " + OutputFilename + ": " +
-                                    EC.message() + "\n");
-    OutFile.os() << OutString;
-    if (ErrorsPrinted == 0)
-      OutFile.keep();
-  }
-
+  if (int Ret = writeOutput(argv0, OutputFilename, OutString))
+    return Ret;
   Timer.stopTimer();
+
+  // Run the extra backends over the same records, which saves parsing the
+  // input once per backend. They run one after the other: backends still
+  // share state through the RecordKeeper (uniqued inits, cached queries) and
+  // the error reporting machinery.
+  for (auto [Action, Filename] : Extras) {
+    if (ErrorsPrinted > 0)
+      break;
+    Timer.startBackendTimer(("Backend " + Action).str());
+    std::string ExtraString;
+    raw_string_ostream ExtraOut(ExtraString);
+    bool Unknown = TableGen::Emitter::ApplyCallback(Action, Records, ExtraOut);
+    Timer.stopBackendTimer();
+    if (Unknown)
+      return reportError(argv0, "unknown action '" + Action +
+                                    "' for -extra-output\n");
+
+    Timer.startTimer("Write output");
+    if (int Ret = writeOutput(argv0, Filename, ExtraString))
+      return Ret;
+    Timer.stopTimer();
+  }
   Timer.stopPhaseTiming();
 
   if (ErrorsPrinted > 0)
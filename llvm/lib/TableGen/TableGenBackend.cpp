@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/TableGen/TableGenBackend.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ManagedStatic.h"
@@ -52,10 +53,15 @@ struct OptCreatorT {
 
 static ManagedStatic<cl::opt<FnT>, OptCreatorT> CallbackFunction;
 
+/// All the registered callbacks by option name, so that other callbacks than
+/// the one selected on the command line can be applied.
+static ManagedStatic<StringMap<FnT>> CallbacksByName;
+
 Opt::Opt(StringRef Name, FnT CB, StringRef Desc, bool ByDefault) {
   if (ByDefault)
     CallbackFunction->setInitialValue(CB);
   CallbackFunction->getParser().addLiteralOption(Name, CB, Desc);
+  CallbacksByName->try_emplace(Name, CB);
 }
 
 /// Apply callback specified on the command line. Returns true if no callback
@@ -69,6 +75,16 @@ bool llvm::TableGen::Emitter::ApplyCallback(const RecordKeeper &Records,
   return false;
 }
 
+bool llvm::TableGen::Emitter::ApplyCallback(StringRef Name,
+                                            const RecordKeeper &Records,
+                                            raw_ostream &OS) {
+  auto It = CallbacksByName->find(Name);
+  if (It == CallbacksByName->end())
+    return true;
+  It->second(Records, OS);
+  return false;
+}
+
 static void printLine(raw_ostream &OS, const Twine &Prefix, char Fill,
                       StringRef Suffix) {
   size_t Pos = (size_t)OS.tell();
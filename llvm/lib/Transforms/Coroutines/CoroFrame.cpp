@@ -16,9 +16,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "CoroInternal.h"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/StackLifetime.h"
+#include "llvm/IR/CFG.h"
 #include "llvm/IR/DIBuilder.h"
 #include "llvm/IR/DebugInfo.h"
 #include "llvm/IR/Dominators.h"
@@ -45,6 +48,21 @@ extern cl::opt<bool> UseNewDbgInfoFormat;
 
 #define DEBUG_TYPE "coro-frame"
 
+STATISTIC(NumSharedSpillSlots,
+          "Number of spilled values put in the frame slot of another value");
+STATISTIC(NumHotFrameFields,
+          "Number of frame fields laid out before the others for resuming");
+
+static cl::opt<bool> ReuseSpillSlots(
+    "coro-reuse-spill-slots", cl::Hidden, cl::init(true),
+    cl::desc("When optimizing the coroutine frame, let spilled values whose "
+             "frame slots are never live at the same time share a slot"));
+
+static cl::opt<bool> HotFieldsFirst(
+    "coro-frame-hot-fields-first", cl::Hidden, cl::init(true),
+    cl::desc("When optimizing the coroutine frame, put the spilled values "
+             "reloaded right after a suspend point at the start of the frame"));
+
 namespace {
 class FrameTypeBuilder;
 // Mapping from the to-be-spilled value to all the users that need reload.
@@ -157,6 +175,47 @@ static void dumpAllocas(const SmallVectorImpl<coro::AllocaInfo> &Allocas) {
 
 namespace {
 using FieldIDType = size_t;
+
+/// Where the frame slot of a spilled value holds the value: from the store
+/// after its definition until the reloads at the beginning of the blocks that
+/// use it across a suspend point.
+struct SpillSlotLiveness {
+  /// The blocks on entry to which the slot is live.
+  BitVector LiveIn;
+  /// The value is stored after StoreAfter in StoreBB, or at the beginning of
+  /// StoreBB if StoreAfter is null.
+  const BasicBlock *StoreBB = nullptr;
+  const Instruction *StoreAfter = nullptr;
+
+  bool isLiveOut(const BasicBlock *BB) const {
+    return any_of(successors(BB), [&](const BasicBlock *Succ) {
+      return LiveIn.test(Succ->getNumber());
+    });
+  }
+
+  /// Returns true if the slot is live after \p Pos in \p BB, or on entry to
+  /// \p BB if \p Pos is null.
+  bool isLiveAt(const BasicBlock *BB, const Instruction *Pos) const {
+    bool IsLiveIn = LiveIn.test(BB->getNumber());
+    if (!Pos)
+      return IsLiveIn || (BB == StoreBB && !StoreAfter);
+    // The reloads are at the beginning of the block, so past them the slot is
+    // only live if a successor needs it.
+    if (!IsLiveIn &&
+        (BB != StoreBB || (StoreAfter && Pos->comesBefore(StoreAfter))))
+      return false;
+    return isLiveOut(BB);
+  }
+
+  /// Two slots that are live at the same point are live at the beginning of
+  /// the same block or one of them is live where the other is stored.
+  bool overlaps(const SpillSlotLiveness &Other) const {
+    return LiveIn.anyCommon(Other.LiveIn) ||
+           isLiveAt(Other.StoreBB, Other.StoreAfter) ||
+           Other.isLiveAt(StoreBB, StoreAfter);
+  }
+};
+
 // We cannot rely solely on natural alignment of a type when building a
 // coroutine frame and if the alignment specified on the Alloca instruction
 // differs from the natural alignment of the alloca type we will need to insert
@@ -171,6 +230,7 @@ private:
     Align Alignment;
     Align TyAlignment;
     uint64_t DynamicAlignBuffer;
+    bool IsHot = false;
   };
 
   const DataLayout &DL;
@@ -236,6 +296,17 @@ public:
   void addFieldForAllocas(const Function &F, FrameDataInfo &FrameData,
                           coro::Shape &Shape, bool OptimizeFrame);
 
+  /// Add the fields for the spilled values. Like for the allocas, spilled
+  /// values whose frame slots are never live at the same time are put into
+  /// the same slot: the slot of a value is live from the store after its
+  /// definition to the last of its reloads, so values that cross disjoint
+  /// sets of suspend points usually don't need a field each.
+  ///
+  /// The fields of the values that are reloaded right after a suspend point
+  /// are marked hot, so that they are laid out first.
+  void addFieldForSpills(Function &F, FrameDataInfo &FrameData,
+                         coro::Shape &Shape, bool OptimizeFrame);
+
   /// Add a field to this structure.
   [[nodiscard]] FieldIDType addField(Type *Ty, MaybeAlign MaybeFieldAlignment,
                                      bool IsHeader = false,
@@ -289,6 +360,10 @@ public:
     return Fields.size() - 1;
   }
 
+  /// Lay out the field \p Id before the fields that are not hot, right after
+  /// the header.
+  void setHotField(FieldIDType Id) { Fields[Id].IsHot = true; }
+
   /// Finish the layout and create the struct type with the given name.
   StructType *finish(StringRef Name);
 
@@ -334,6 +409,50 @@ void FrameDataInfo::updateLayoutIndex(FrameTypeBuilder &B) {
   LayoutIndexUpdateStarted = false;
 }
 
+/// Compute the liveness of the frame slot of \p Def, which is reloaded for
+/// \p Users. Returns std::nullopt for the values that are not stored after
+/// their definition (see coro::getSpillInsertionPt()).
+static std::optional<SpillSlotLiveness>
+computeSpillSlotLiveness(const Function &F, Value *Def,
+                         ArrayRef<Instruction *> Users,
+                         const coro::Shape &Shape, const DominatorTree &DT) {
+  // Arguments and the values that are not dominated by coro.begin are all
+  // stored right after coro.begin.
+  auto *I = dyn_cast<Instruction>(Def);
+  if (!I || !DT.dominates(Shape.CoroBegin, I))
+    return std::nullopt;
+  const BasicBlock *DefBB = I->getParent();
+  if (isa<PHINode>(I) && isa<CatchSwitchInst>(DefBB->getTerminator()))
+    return std::nullopt;
+
+  SpillSlotLiveness L;
+  L.LiveIn.resize(F.getMaxBlockNumber());
+  L.StoreBB = DefBB;
+  // The spills of PHIs are placed at the beginning of their block. The spills
+  // of suspends and invokes are placed in a successor or on the edge to it,
+  // which is approximated by storing them right after the definition.
+  L.StoreAfter = isa<PHINode>(I) ? nullptr : I;
+
+  SmallVector<const BasicBlock *, 16> Worklist;
+  for (Instruction *U : Users) {
+    const BasicBlock *BB = U->getParent();
+    if (!L.LiveIn.test(BB->getNumber())) {
+      L.LiveIn.set(BB->getNumber());
+      Worklist.push_back(BB);
+    }
+  }
+  while (!Worklist.empty()) {
+    const BasicBlock *BB = Worklist.pop_back_val();
+    for (const BasicBlock *Pred : predecessors(BB)) {
+      if (Pred == DefBB || L.LiveIn.test(Pred->getNumber()))
+        continue;
+      L.LiveIn.set(Pred->getNumber());
+      Worklist.push_back(Pred);
+    }
+  }
+  return L;
+}
+
 void FrameTypeBuilder::addFieldForAllocas(const Function &F,
                                           FrameDataInfo &FrameData,
                                           coro::Shape &Shape,
@@ -463,6 +582,89 @@ void FrameTypeBuilder::addFieldForAllocas(const Function &F,
   });
 }
 
+void FrameTypeBuilder::addFieldForSpills(Function &F, FrameDataInfo &FrameData,
+                                         coro::Shape &Shape,
+                                         bool OptimizeFrame) {
+  auto AddFieldForSpill = [&](Value *V) {
+    Type *FieldType = V->getType();
+    // For byval arguments, we need to store the pointed value in the frame,
+    // instead of the pointer itself.
+    if (const Argument *A = dyn_cast<Argument>(V))
+      if (A->hasByValAttr())
+        FieldType = A->getParamByValType();
+    FieldIDType Id = addField(FieldType, std::nullopt, false /*header*/,
+                              true /*IsSpillOfValue*/);
+    FrameData.setFieldIndex(V, Id);
+    return Id;
+  };
+
+  // Values that share a slot must not be live at the same time, and the
+  // largest one, which determines the type of the field, must be at least
+  // as aligned as the others.
+  struct SpillSlot {
+    FieldIDType Id;
+    Align Alignment;
+    SmallVector<SpillSlotLiveness *, 4> Members;
+  };
+  using SpillAndLiveness = std::pair<Value *, SpillSlotLiveness>;
+  SmallVector<SpillAndLiveness, 8> Shareable;
+  if (OptimizeFrame && ReuseSpillSlots && FrameData.Spills.size() > 1) {
+    DominatorTree DT(F);
+    for (auto &S : FrameData.Spills) {
+      if (auto L = computeSpillSlotLiveness(F, S.first, S.second, Shape, DT))
+        Shareable.emplace_back(S.first, std::move(*L));
+      else
+        (void)AddFieldForSpill(S.first);
+    }
+  } else {
+    for (auto &S : FrameData.Spills)
+      (void)AddFieldForSpill(S.first);
+  }
+
+  // Like for the allocas, the larger values are put first so that they get
+  // the slots.
+  llvm::stable_sort(Shareable, [&](const SpillAndLiveness &LHS,
+                                  const SpillAndLiveness &RHS) {
+    return DL.getTypeAllocSize(LHS.first->getType()) >
+           DL.getTypeAllocSize(RHS.first->getType());
+  });
+  SmallVector<SpillSlot, 8> Slots;
+  for (auto &[V, L] : Shareable) {
+    Align ValueAlign = DL.getABITypeAlign(V->getType());
+    auto *It = find_if(Slots, [&](const SpillSlot &Slot) {
+      return Slot.Alignment.value() % ValueAlign.value() == 0 &&
+             none_of(Slot.Members, [&](const SpillSlotLiveness *Member) {
+               return Member->overlaps(L);
+             });
+    });
+    if (It == Slots.end()) {
+      Slots.push_back({AddFieldForSpill(V), ValueAlign, {&L}});
+      continue;
+    }
+    FrameData.setFieldIndex(V, It->Id);
+    It->Members.push_back(&L);
+    ++NumSharedSpillSlots;
+    LLVM_DEBUG(dbgs() << "In Function:" << F.getName()
+                      << "\n\tSpill shares a slot: " << *V << "\n");
+  }
+
+  if (!OptimizeFrame || !HotFieldsFirst)
+    return;
+  // A suspend point is in a block of its own (see normalizeCoroutine()) and
+  // the branch on its result, if any, is in the next block.
+  SmallPtrSet<const BasicBlock *, 8> ResumeBlocks;
+  for (AnyCoroSuspendInst *CSI : Shape.CoroSuspends)
+    for (const BasicBlock *Succ : successors(CSI->getParent())) {
+      ResumeBlocks.insert(Succ);
+      ResumeBlocks.insert(succ_begin(Succ), succ_end(Succ));
+    }
+  for (auto &S : FrameData.Spills)
+    if (any_of(S.second, [&](const Instruction *U) {
+          return ResumeBlocks.contains(U->getParent());
+        }))
+      setHotField(FrameData.getFieldIndex(S.first));
+}
+
 StructType *FrameTypeBuilder::finish(StringRef Name) {
   assert(!IsFinished && "already finished!");
 
@@ -470,9 +672,31 @@ StructType *FrameTypeBuilder::finish(StringRef Name) {
   // The Id in the layout field is a pointer to our Field for it.
   SmallVector<OptimizedStructLayoutField, 8> LayoutFields;
   LayoutFields.reserve(Fields.size());
-  for (auto &Field : Fields) {
+  auto AddLayoutField = [&](Field &Field) {
     LayoutFields.emplace_back(&Field, Field.Size, Field.Alignment,
                               Field.Offset);
+  };
+  auto IsFixedOrHot = [](const Field &F) {
+    return F.Offset != OptimizedStructLayoutField::FlexibleOffset || F.IsHot;
+  };
+
+  // Lay out the header and the hot fields first, so that resuming the
+  // coroutine touches as little of the frame as possible. This fixes their
+  // offsets, and the other fields go after them or into their padding.
+  if (any_of(Fields, [](const Field &F) { return F.IsHot; }) &&
+      !all_of(Fields, IsFixedOrHot)) {
+    for (auto &Field : Fields)
+      if (IsFixedOrHot(Field))
+        AddLayoutField(Field);
+    performOptimizedStructLayout(LayoutFields);
+    NumHotFrameFields +=
+        count_if(Fields, [](const Field &F) { return F.IsHot; });
+    for (auto &Field : Fields)
+      if (!IsFixedOrHot(Field))
+        AddLayoutField(Field);
+  } else {
+    for (auto &Field : Fields)
+      AddLayoutField(Field);
   }
 
   // Perform layout.
@@ -898,6 +1122,9 @@ static StructType *buildFrameType(Function &F, coro::Shape &Shape,
     Type *IndexType = Type::getIntNTy(C, IndexBits);
 
     SwitchIndexFieldId = B.addField(IndexType, std::nullopt);
+    // The index is read by every resumption.
+    if (OptimizeFrame && HotFieldsFirst)
+      B.setHotField(*SwitchIndexFieldId);
   } else {
     assert(PromiseAlloca == nullptr && "lowering doesn't support promises");
   }
@@ -914,18 +1141,9 @@ static StructType *buildFrameType(Function &F, coro::Shape &Shape,
     // CoroBegin and no alias will be create before CoroBegin.
     FrameData.Allocas.emplace_back(
         PromiseAlloca, DenseMap<Instruction *, std::optional<APInt>>{}, false);
-  // Create an entry for every spilled value.
-  for (auto &S : FrameData.Spills) {
-    Type *FieldType = S.first->getType();
-    // For byval arguments, we need to store the pointed value in the frame,
-    // instead of the pointer itself.
-    if (const Argument *A = dyn_cast<Argument>(S.first))
-      if (A->hasByValAttr())
-        FieldType = A->getParamByValType();
-    FieldIDType Id = B.addField(FieldType, std::nullopt, false /*header*/,
-                                true /*IsSpillOfValue*/);
-    FrameData.setFieldIndex(S.first, Id);
-  }
+  // Create an entry for every spilled value. Because multiple values may own
+  // the same field slot, they are added to the fields here as well.
+  B.addFieldForSpills(F, FrameData, Shape, OptimizeFrame);
 
   StructType *FrameTy = [&] {
     SmallString<32> Name(F.getName());
@@ -1105,9 +1323,11 @@ static void insertSpills(const FrameDataInfo &FrameData, coro::Shape &Shape) {
         if (ByValTy)
           CurrentReload = GEP;
         else
+          // The field may be shared with a larger value, so load the type of
+          // the spilled value rather than the type of the field.
           CurrentReload = Builder.CreateAlignedLoad(
-              FrameTy->getElementType(FrameData.getFieldIndex(E.first)), GEP,
-              SpillAlignment, E.first->getName() + Twine(".reload"));
+              E.first->getType(), GEP, SpillAlignment,
+              E.first->getName() + Twine(".reload"));
 
         TinyPtrVector<DbgDeclareInst *> DIs = findDbgDeclares(Def);
         TinyPtrVector<DbgVariableRecord *> DVRs = findDVRDeclares(Def);
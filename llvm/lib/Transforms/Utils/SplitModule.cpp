@@ -26,6 +26,8 @@
 #include "llvm/IR/GlobalObject.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/User.h"
@@ -40,6 +42,7 @@
 #include <cassert>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -107,18 +110,11 @@ static const GlobalObject *getGVPartitioningRoot(const GlobalValue *GV) {
   return GO;
 }
 
-// Find partitions for module in the way that no locals need to be
-// globalized.
-// Try to balance pack those partitions into N files since this roughly equals
-// thread balancing for the backend codegen step.
-static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
-                           unsigned N) {
-  // At this point module should have the proper mix of globals and locals.
-  // As we attempt to partition this module, we must not change any
-  // locals to globals.
-  LLVM_DEBUG(dbgs() << "Partition module with (" << M.size()
-                    << ") functions\n");
-  ClusterMapType GVtoClusterMap;
+// Group the global values of M that must end up in the same partition: the
+// members of a comdat, aliases and ifuncs with their roots, users of block
+// addresses with the function and users of locals with the local.
+static void collectMandatoryClusters(Module &M,
+                                     ClusterMapType &GVtoClusterMap) {
   ComdatMembersType ComdatMembers;
 
   auto recordGVSet = [&GVtoClusterMap, &ComdatMembers](GlobalValue &GV) {
@@ -162,6 +158,21 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
   llvm::for_each(M.functions(), recordGVSet);
   llvm::for_each(M.globals(), recordGVSet);
   llvm::for_each(M.aliases(), recordGVSet);
+}
+
+// Find partitions for module in the way that no locals need to be
+// globalized.
+// Try to balance pack those partitions into N files since this roughly equals
+// thread balancing for the backend codegen step.
+static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
+                           unsigned N) {
+  // At this point module should have the proper mix of globals and locals.
+  // As we attempt to partition this module, we must not change any
+  // locals to globals.
+  LLVM_DEBUG(dbgs() << "Partition module with (" << M.size()
+                    << ") functions\n");
+  ClusterMapType GVtoClusterMap;
+  collectMandatoryClusters(M, GVtoClusterMap);
 
   // Assigned all GVs to merged clusters while balancing number of objects in
   // each.
@@ -218,6 +229,159 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
   }
 }
 
+// Returns a rough estimate of the time needed to generate code for GV.
+static uint64_t getCodeGenCost(const GlobalValue &GV) {
+  if (const auto *F = dyn_cast<Function>(&GV))
+    return F->getInstructionCount() + 1;
+  return 1;
+}
+
+// Find partitions for the module using a cost model instead of name hashes.
+// Functions that call each other and the globals they reference are clustered
+// greedily, heaviest edges first, as long as a cluster stays well below the
+// ideal partition size. Edges are weighted by the number of uses and, if
+// profile data is available, by the entry count of the user, so hot call
+// chains tend to be kept together. The clusters are then assigned to the
+// least loaded partition from largest to smallest, which balances the
+// estimated codegen time across partitions.
+static void findCostBasedPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
+                                    unsigned N) {
+  ClusterMapType GVtoClusterMap;
+  collectMandatoryClusters(M, GVtoClusterMap);
+
+  // Number the definitions in module order so that the result does not
+  // depend on pointer values.
+  SmallVector<const GlobalValue *, 0> GVs;
+  DenseMap<const GlobalValue *, unsigned> GVIndex;
+  auto AddGV = [&](const GlobalValue &GV) {
+    if (GV.isDeclaration())
+      return;
+    GVIndex[&GV] = GVs.size();
+    GVs.push_back(&GV);
+  };
+  llvm::for_each(M.functions(), AddGV);
+  llvm::for_each(M.globals(), AddGV);
+  llvm::for_each(M.aliases(), AddGV);
+  llvm::for_each(M.ifuncs(), AddGV);
+  if (GVs.empty())
+    return;
+
+  SmallVector<unsigned, 0> Leader(GVs.size());
+  SmallVector<uint64_t, 0> Cost(GVs.size());
+  uint64_t TotalCost = 0;
+  for (unsigned I = 0, E = GVs.size(); I != E; ++I) {
+    Leader[I] = I;
+    Cost[I] = getCodeGenCost(*GVs[I]);
+    TotalCost += Cost[I];
+  }
+  auto Find = [&](unsigned I) {
+    while (Leader[I] != I)
+      I = Leader[I] = Leader[Leader[I]];
+    return I;
+  };
+  auto Merge = [&](unsigned A, unsigned B) {
+    A = Find(A);
+    B = Find(B);
+    if (A == B)
+      return;
+    if (B < A)
+      std::swap(A, B);
+    Leader[B] = A;
+    Cost[A] += Cost[B];
+  };
+
+  for (auto I = GVtoClusterMap.begin(), E = GVtoClusterMap.end(); I != E; ++I) {
+    if (!I->isLeader())
+      continue;
+    std::optional<unsigned> First;
+    for (auto MI = GVtoClusterMap.member_begin(I);
+         MI != GVtoClusterMap.member_end(); ++MI) {
+      auto It = GVIndex.find(*MI);
+      if (It == GVIndex.end())
+        continue;
+      if (First)
+        Merge(*First, It->second);
+      else
+        First = It->second;
+    }
+  }
+  for (unsigned I = 0, E = GVs.size(); I != E; ++I)
+    if (const GlobalObject *Root = getGVPartitioningRoot(GVs[I]))
+      if (auto It = GVIndex.find(Root); It != GVIndex.end())
+        Merge(I, It->second);
+
+  // Collect the weighted reference graph between definitions.
+  DenseMap<std::pair<unsigned, unsigned>, uint64_t> EdgeWeights;
+  for (const Function &F : M.functions()) {
+    if (F.isDeclaration())
+      continue;
+    unsigned From = GVIndex.lookup(&F);
+    uint64_t Scale = 1;
+    if (std::optional<Function::ProfileCount> Count = F.getEntryCount())
+      Scale += Count->getCount();
+    for (const Instruction &I : instructions(F)) {
+      const Value *Callee = nullptr;
+      if (const auto *CB = dyn_cast<CallBase>(&I))
+        Callee = CB->getCalledOperand()->stripPointerCasts();
+      for (const Value *Op : I.operand_values()) {
+        const auto *GV = dyn_cast<GlobalValue>(Op->stripPointerCasts());
+        if (!GV)
+          continue;
+        auto It = GVIndex.find(GV);
+        if (It == GVIndex.end() || It->second == From)
+          continue;
+        // Calls are what keeps a cluster together. Other references only
+        // matter for the number of symbols shared between partitions.
+        uint64_t Weight = GV == Callee ? Scale : 1;
+        EdgeWeights[{std::min(From, It->second),
+                     std::max(From, It->second)}] += Weight;
+      }
+    }
+  }
+
+  using EdgeType = std::pair<std::pair<unsigned, unsigned>, uint64_t>;
+  SmallVector<EdgeType, 0> Edges(EdgeWeights.begin(), EdgeWeights.end());
+  llvm::sort(Edges, [](const EdgeType &A, const EdgeType &B) {
+    if (A.second != B.second)
+      return A.second > B.second;
+    return A.first < B.first;
+  });
+
+  // Clusters of at most half the ideal partition size leave enough freedom to
+  // balance the partitions below.
+  uint64_t MaxClusterCost = std::max<uint64_t>(TotalCost / (2 * N), 1);
+  for (const EdgeType &Edge : Edges) {
+    unsigned A = Find(Edge.first.first);
+    unsigned B = Find(Edge.first.second);
+    if (A != B && Cost[A] + Cost[B] <= MaxClusterCost)
+      Merge(A, B);
+  }
+
+  SmallVector<unsigned, 0> Roots;
+  for (unsigned I = 0, E = GVs.size(); I != E; ++I)
+    if (Find(I) == I)
+      Roots.push_back(I);
+  llvm::stable_sort(Roots,
+                    [&](unsigned A, unsigned B) { return Cost[A] > Cost[B]; });
+
+  using LoadType = std::pair<uint64_t, unsigned>;
+  std::priority_queue<LoadType, std::vector<LoadType>, std::greater<LoadType>>
+      Loads;
+  for (unsigned I = 0; I < N; ++I)
+    Loads.push({0, I});
+  DenseMap<unsigned, unsigned> RootPartition;
+  for (unsigned Root : Roots) {
+    auto [Load, Partition] = Loads.top();
+    Loads.pop();
+    LLVM_DEBUG(dbgs() << "Partition[" << Partition << "] cost(" << Cost[Root]
+                      << ") ----> " << GVs[Root]->getName() << "\n");
+    RootPartition[Root] = Partition;
+    Loads.push({Load + Cost[Root], Partition});
+  }
+  for (unsigned I = 0, E = GVs.size(); I != E; ++I)
+    ClusterIDMap[GVs[I]] = RootPartition[Find(I)];
+}
+
 static void externalize(GlobalValue *GV) {
   if (GV->hasLocalLinkage()) {
     GV->setLinkage(GlobalValue::ExternalLinkage);
@@ -254,7 +418,7 @@ static bool isInPartition(const GlobalValue *GV, unsigned I, unsigned N) {
 void llvm::SplitModule(
     Module &M, unsigned N,
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
-    bool PreserveLocals, bool RoundRobin) {
+    bool PreserveLocals, bool RoundRobin, bool CostBased) {
   if (!PreserveLocals) {
     for (Function &F : M)
       externalize(&F);
@@ -269,14 +433,17 @@ void llvm::SplitModule(
   // This performs splitting without a need for externalization, which might not
   // always be possible.
   ClusterIDMapType ClusterIDMap;
-  findPartitions(M, ClusterIDMap, N);
+  if (CostBased)
+    findCostBasedPartitions(M, ClusterIDMap, N);
+  else
+    findPartitions(M, ClusterIDMap, N);
 
   // Find functions not mapped to modules in ClusterIDMap and count functions
   // per module. Map unmapped functions using round-robin so that they skip
   // being distributed by isInPartition() based on function name hashes below.
   // This provides better uniformity of distribution of functions to modules
   // in some cases - for example when the number of functions equals to N.
-  if (RoundRobin) {
+  if (RoundRobin && !CostBased) {
     DenseMap<unsigned, unsigned> ModuleFunctionCount;
     SmallVector<const GlobalValue *> UnmappedFunctions;
     for (const auto &F : M.functions()) {
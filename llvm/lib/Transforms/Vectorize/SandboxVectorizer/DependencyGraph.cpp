@@ -8,10 +8,26 @@
 
 #include "llvm/Transforms/Vectorize/SandboxVectorizer/DependencyGraph.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/SandboxIR/Instruction.h"
 #include "llvm/SandboxIR/Utils.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Transforms/Vectorize/SandboxVectorizer/Scheduler.h"
 
+#define DEBUG_TYPE "SBVec:DAG"
+
+STATISTIC(NumDAGNodes, "Number of nodes created in the dependency graph");
+STATISTIC(NumAAQueries, "Number of alias queries made by the dependency graph");
+STATISTIC(NumAABudgetExhausted,
+          "Number of dependencies assumed because the AA budget ran out");
+
+static llvm::cl::opt<unsigned> AABudget(
+    "sbvec-dag-aa-budget", llvm::cl::init(256), llvm::cl::Hidden,
+    llvm::cl::desc("Limit the number of alias queries made when looking for "
+                   "the memory dependencies of an instruction. Beyond it, the "
+                   "dependencies are assumed, to cap compilation time on "
+                   "large blocks."));
+
 namespace llvm::sandboxir {
 
 PredIterator::value_type PredIterator::operator*() {
@@ -158,6 +174,8 @@ static bool isOrdered(Instruction *I) {
   return Is;
 }
 
+void DependencyGraph::resetAABudget() { AABudgetLeft = AABudget; }
+
 bool DependencyGraph::alias(Instruction *SrcI, Instruction *DstI,
                             DependencyType DepType) {
   std::optional<MemoryLocation> DstLocOpt =
@@ -167,11 +185,16 @@ bool DependencyGraph::alias(Instruction *SrcI, Instruction *DstI,
   // Check aliasing.
   assert((SrcI->mayReadFromMemory() || SrcI->mayWriteToMemory()) &&
          "Expected a mem instr");
-  // TODO: Check AABudget
+  if (isOrdered(SrcI))
+    return true;
+  if (AABudgetLeft == 0) {
+    ++NumAABudgetExhausted;
+    return true;
+  }
+  --AABudgetLeft;
+  ++NumAAQueries;
   ModRefInfo SrcModRef =
-      isOrdered(SrcI)
-          ? ModRefInfo::ModRef
-          : Utils::aliasAnalysisGetModRefInfo(*BatchAA, SrcI, *DstLocOpt);
+      Utils::aliasAnalysisGetModRefInfo(*BatchAA, SrcI, *DstLocOpt);
   switch (DepType) {
   case DependencyType::ReadAfterWrite:
   case DependencyType::WriteAfterWrite:
@@ -209,8 +232,10 @@ void DependencyGraph::scanAndAddDeps(MemDGNode &DstN,
   assert(isa<MemDGNode>(DstN) &&
          "DstN is the mem dep destination, so it must be mem");
   Instruction *DstI = DstN.getInstruction();
+  resetAABudget();
   // Walk up the instruction chain from ScanRange bottom to top, looking for
-  // memory instrs that may alias.
+  // memory instrs that may alias. The closest ones are queried first, as they
+  // are the most likely to constrain the schedule.
   for (MemDGNode &SrcN : reverse(SrcScanRange)) {
     Instruction *SrcI = SrcN.getInstruction();
     if (hasDep(SrcI, DstI))
@@ -277,9 +302,11 @@ void DependencyGraph::setDefUseUnscheduledSuccs(
 void DependencyGraph::createNewNodes(const Interval<Instruction> &NewInterval) {
   // Create Nodes only for the new sections of the DAG.
   DGNode *LastN = getOrCreateNode(NewInterval.top());
+  ++NumDAGNodes;
   MemDGNode *LastMemN = dyn_cast<MemDGNode>(LastN);
   for (Instruction &I : drop_begin(NewInterval)) {
     auto *N = getOrCreateNode(&I);
+    ++NumDAGNodes;
     // Build the Mem node chain.
     if (auto *MemN = dyn_cast<MemDGNode>(N)) {
       MemN->setPrevNode(LastMemN);
@@ -354,8 +381,9 @@ MemDGNode *DependencyGraph::getMemDGNodeAfter(DGNode *N,
 }
 
 void DependencyGraph::notifyCreateInstr(Instruction *I) {
-  auto *MemN = dyn_cast<MemDGNode>(getOrCreateNode(I));
-  // TODO: Update the dependencies for the new node.
+  DGNode *N = getOrCreateNode(I);
+  ++NumDAGNodes;
+  auto *MemN = dyn_cast<MemDGNode>(N);
 
   // Update the MemDGNode chain if this is a memory node.
   if (MemN != nullptr) {
@@ -368,6 +396,37 @@ void DependencyGraph::notifyCreateInstr(Instruction *I) {
       MemN->NextMemN = NextMemN;
     }
   }
+
+  // Only the instructions within the DAG interval get dependencies, the same
+  // way extend() only creates dependencies between nodes in the interval.
+  if (!DAGInterval.contains(I))
+    return;
+  // The new node is not scheduled, so it counts as an unscheduled successor of
+  // its operands.
+  for (Value *Op : I->operands()) {
+    auto *OpI = dyn_cast<Instruction>(Op);
+    if (OpI == nullptr || !DAGInterval.contains(OpI))
+      continue;
+    if (DGNode *OpN = getNode(OpI))
+      ++OpN->UnscheduledSuccs;
+  }
+  if (MemN == nullptr)
+    return;
+  // Add the memory dependencies from the mem nodes above the new one.
+  MemDGNode *PrevMemN = MemN->getPrevNode();
+  if (PrevMemN != nullptr && DAGInterval.contains(PrevMemN->getInstruction()))
+    scanAndAddDeps(
+        *MemN,
+        Interval<MemDGNode>(
+            MemDGNodeIntervalBuilder::getTopMemDGNode(DAGInterval, *this),
+            PrevMemN));
+  // And the ones to the mem nodes below it.
+  resetAABudget();
+  for (MemDGNode *DstN = MemN->getNextNode();
+       DstN != nullptr && DAGInterval.contains(DstN->getInstruction());
+       DstN = DstN->getNextNode())
+    if (hasDep(I, DstN->getInstruction()))
+      DstN->addMemPred(MemN);
 }
 
 void DependencyGraph::notifyMoveInstr(Instruction *I, const BBIterator &To) {
@@ -417,8 +476,31 @@ void DependencyGraph::notifyMoveInstr(Instruction *I, const BBIterator &To) {
 }
 
 void DependencyGraph::notifyEraseInstr(Instruction *I) {
-  // Update the MemDGNode chain if this is a memory node.
-  if (auto *MemN = dyn_cast_or_null<MemDGNode>(getNodeOrNull(I))) {
+  DGNode *N = getNodeOrNull(I);
+  if (N == nullptr)
+    return;
+
+  // Remove the dependencies to and from the node, so that no node is left
+  // pointing to it, and the unscheduled successor counters stay correct.
+  if (!N->scheduled()) {
+    // Def-use edges are only counted within the DAG interval.
+    for (Value *Op : I->operands()) {
+      auto *OpI = dyn_cast<Instruction>(Op);
+      if (OpI == nullptr || !DAGInterval.contains(OpI))
+        continue;
+      if (DGNode *OpN = getNode(OpI))
+        OpN->decrUnscheduledSuccs();
+    }
+  }
+  if (auto *MemN = dyn_cast<MemDGNode>(N)) {
+    while (!MemN->MemPreds.empty())
+      MemN->removeMemPred(*MemN->MemPreds.begin());
+    for (MemDGNode *SuccN = MemN->getNextNode(); SuccN != nullptr;
+         SuccN = SuccN->getNextNode())
+      if (SuccN->hasMemPred(MemN))
+        SuccN->removeMemPred(MemN);
+
+    // Update the MemDGNode chain.
     auto *PrevMemN = getMemDGNodeBefore(MemN, /*IncludingN=*/false);
     auto *NextMemN = getMemDGNodeAfter(MemN, /*IncludingN=*/false);
     if (PrevMemN != nullptr)
@@ -427,9 +509,15 @@ void DependencyGraph::notifyEraseInstr(Instruction *I) {
       NextMemN->PrevMemN = PrevMemN;
   }
 
-  InstrToNodeMap.erase(I);
+  // Shrink the DAG interval if it starts or ends at I.
+  if (DAGInterval.top() == I && DAGInterval.bottom() == I)
+    DAGInterval = {};
+  else if (DAGInterval.top() == I)
+    DAGInterval = Interval<Instruction>(I->getNextNode(), DAGInterval.bottom());
+  else if (DAGInterval.bottom() == I)
+    DAGInterval = Interval<Instruction>(DAGInterval.top(), I->getPrevNode());
 
-  // TODO: Update the dependencies.
+  InstrToNodeMap.erase(I);
 }
 
 Interval<Instruction> DependencyGraph::extend(ArrayRef<Instruction *> Instrs) {
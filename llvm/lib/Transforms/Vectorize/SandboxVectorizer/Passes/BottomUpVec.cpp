@@ -12,11 +12,14 @@
 #include "llvm/SandboxIR/Instruction.h"
 #include "llvm/SandboxIR/Module.h"
 #include "llvm/SandboxIR/Utils.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Transforms/Vectorize/SandboxVectorizer/SandboxVectorizerPassBuilder.h"
 #include "llvm/Transforms/Vectorize/SandboxVectorizer/VecUtils.h"
 
 namespace llvm::sandboxir {
 
+extern cl::opt<unsigned> SeedBundleSizeLimit;
+
 BottomUpVec::BottomUpVec(StringRef Pipeline)
     : FunctionPass("bottom-up-vec"),
       RPM("rpm", Pipeline, SandboxVectorizerPassBuilder::createRegionPass) {}
@@ -279,11 +282,18 @@ bool BottomUpVec::runOnFunction(Function &F, const Analyses &A) {
   for (auto &BB : F) {
     // TODO: Replace with proper SeedCollector function.
     auto Seeds = collectSeeds(BB);
-    // TODO: Slice Seeds into smaller chunks.
+    // Slice the seeds into chunks of at most SeedBundleSizeLimit, like the
+    // SeedCollector does, so that the size of the bundles and of the DAG
+    // built for them does not grow with the size of the block.
     // TODO: If vectorization succeeds, run the RegionPassManager on the
     // resulting region.
-    if (Seeds.size() >= 2)
-      Change |= tryVectorize(Seeds);
+    for (unsigned Begin = 0, E = Seeds.size(); Begin + 1 < E;
+         Begin += SeedBundleSizeLimit) {
+      ArrayRef<Value *> Chunk = ArrayRef(Seeds).slice(
+          Begin, std::min<unsigned>(SeedBundleSizeLimit, E - Begin));
+      if (Chunk.size() >= 2)
+        Change |= tryVectorize(Chunk);
+    }
   }
   return Change;
 }
@@ -164,6 +164,9 @@ public:
 
   bool empty() const { return Symbols.empty(); }
 
+  /// Returns all symbol mappings of this object file.
+  const StringMap<SymbolMapping> &symbols() const { return Symbols; }
+
   void addWarning(StringRef Warning) {
     Warnings.push_back(std::string(Warning));
   }
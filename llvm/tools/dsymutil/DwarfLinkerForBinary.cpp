@@ -9,6 +9,7 @@
 #include "DwarfLinkerForBinary.h"
 #include "BinaryHolder.h"
 #include "DebugMap.h"
+#include "LinkedDwarfCache.h"
 #include "MachOUtils.h"
 #include "dsymutil.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -642,6 +643,15 @@ bool DwarfLinkerForBinary::linkImpl(
         reportWarning(Warning, Context, DIE);
       });
 
+  // The linked DWARF cache is only supported by the parallel linker, whose
+  // output goes through a single handler.
+  std::unique_ptr<LinkedDwarfCache> Cache;
+  if constexpr (std::is_same<Linker, parallel::DWARFLinker>::value)
+    if (!Options.IncrementalCacheDir.empty() && !Options.NoOutput &&
+        !Options.Update)
+      Cache = std::make_unique<LinkedDwarfCache>(Options.IncrementalCacheDir,
+                                                 Options, Map);
+
   std::unique_ptr<classic::DwarfStreamer> Streamer;
   if (!Options.NoOutput) {
     if (Expected<std::unique_ptr<classic::DwarfStreamer>> StreamerOrErr =
@@ -665,7 +675,10 @@ bool DwarfLinkerForBinary::linkImpl(
           [&](std::shared_ptr<parallel::SectionDescriptorBase> Section) {
             Streamer->emitSectionContents(Section->getContents(),
                                           Section->getKind());
+            if (Cache)
+              Cache->addSection(Section->getKind(), Section->getContents());
           });
+      GeneralLinker->setMemoryBounded(Options.MemoryBounded);
     } else
       GeneralLinker->setOutputDWARFEmitter(Streamer.get());
   }
@@ -770,6 +783,10 @@ bool DwarfLinkerForBinary::linkImpl(
         MaxDWARFVersion = std::max(Unit.getVersion(), MaxDWARFVersion);
       };
 
+  // With the cache, the object files are only added to the linker once it is
+  // known that the DWARF needs to be linked.
+  std::vector<DWARFFile *> PendingObjects;
+
   for (const auto &Obj : Map.objects()) {
     // N_AST objects (swiftmodule files) should get dumped directly into the
     // appropriate DWARF section.
@@ -816,30 +833,72 @@ bool DwarfLinkerForBinary::linkImpl(
     if (ErrorOr<std::unique_ptr<DWARFFile>> ErrorOrObj =
             loadObject(*Obj, Map, RL, DLBRelocMap)) {
       ObjectsForLinking.emplace_back(std::move(*ErrorOrObj), DLBRelocMap);
-      GeneralLinker->addObjectFile(*ObjectsForLinking.back().Object, Loader,
-                                   OnCUDieLoaded);
+      DWARFFile &File = *ObjectsForLinking.back().Object;
+      if (Cache) {
+        Cache->addObject(*Obj, File.Dwarf->getDWARFObj().getFile()->getData());
+        PendingObjects.push_back(&File);
+      } else
+        GeneralLinker->addObjectFile(File, Loader, OnCUDieLoaded);
     } else {
       ObjectsForLinking.push_back(
           {std::make_unique<DWARFFile>(Obj->getObjectFilename(), nullptr,
                                        nullptr),
            DLBRelocMap});
-      GeneralLinker->addObjectFile(*ObjectsForLinking.back().Object);
+      DWARFFile &File = *ObjectsForLinking.back().Object;
+      if (Cache) {
+        Cache->addObject(*Obj, StringRef());
+        PendingObjects.push_back(&File);
+      } else
+        GeneralLinker->addObjectFile(File);
     }
   }
 
-  // If we haven't seen any CUs, pick an arbitrary valid Dwarf version anyway.
-  if (MaxDWARFVersion == 0)
-    MaxDWARFVersion = 3;
+  bool IsCached = false;
+  if (Cache) {
+    if (std::unique_ptr<MemoryBuffer> Entry = Cache->lookup()) {
+      if (Options.Verbose)
+        outs() << "Reusing the linked DWARF from the cache entry '"
+               << Entry->getBufferIdentifier() << "'\n";
+      if (Error E = LinkedDwarfCache::replay(
+              *Entry,
+              [&](StringRef Contents, DebugSectionKind Kind) {
+                Streamer->emitSectionContents(Contents, Kind);
+              },
+              ParseableSwiftInterfaces))
+        return error(toString(std::move(E)));
+      IsCached = true;
+    } else {
+      if (Error E = Cache->beginEntry()) {
+        reportWarning("cannot create linked DWARF cache entry: " +
+                      toString(std::move(E)));
+        Cache.reset();
+      }
 
-  if (Error E = GeneralLinker->setTargetDWARFVersion(MaxDWARFVersion))
-    return error(toString(std::move(E)));
+      for (DWARFFile *File : PendingObjects)
+        GeneralLinker->addObjectFile(*File, Loader, OnCUDieLoaded);
+    }
+  }
 
-  setAcceleratorTables<Linker>(*GeneralLinker, Options.TheAccelTableKind,
-                               MaxDWARFVersion);
+  if (!IsCached) {
+    // If we haven't seen any CUs, pick an arbitrary valid Dwarf version anyway.
+    if (MaxDWARFVersion == 0)
+      MaxDWARFVersion = 3;
 
-  // link debug info for loaded object files.
-  if (Error E = GeneralLinker->link())
-    return error(toString(std::move(E)));
+    if (Error E = GeneralLinker->setTargetDWARFVersion(MaxDWARFVersion))
+      return error(toString(std::move(E)));
+
+    setAcceleratorTables<Linker>(*GeneralLinker, Options.TheAccelTableKind,
+                                 MaxDWARFVersion);
+
+    // link debug info for loaded object files.
+    if (Error E = GeneralLinker->link())
+      return error(toString(std::move(E)));
+
+    if (Cache)
+      if (Error E = Cache->commitEntry(ParseableSwiftInterfaces))
+        reportWarning("cannot store linked DWARF cache entry: " +
+                      toString(std::move(E)));
+  }
 
   StringRef ArchName = Map.getTriple().getArchName();
   if (Error E = emitRemarks(Options, Map.getBinaryPath(), ArchName, RL))
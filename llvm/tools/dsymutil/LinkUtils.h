@@ -66,6 +66,14 @@ struct LinkOptions {
   /// Type of DWARFLinker to use.
   DsymutilDWARFLinkerType DWARFLinkerType = DsymutilDWARFLinkerType::Classic;
 
+  /// Keep linked sections in a temporary file until they are written to the
+  /// output (parallel DWARF linker only).
+  bool MemoryBounded = false;
+
+  /// Directory of the linked DWARF cache (parallel DWARF linker only). The
+  /// cache isn't used if this is empty.
+  std::string IncrementalCacheDir;
+
   /// Use a 64-bit header when emitting universal binaries.
   bool Fat64 = false;
 
@@ -0,0 +1,216 @@
+//===- tools/dsymutil/LinkedDwarfCache.cpp - Cache of linked DWARF --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LinkedDwarfCache.h"
+#include "DebugMap.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/xxhash.h"
+#include <vector>
+
+namespace llvm {
+namespace dsymutil {
+
+using namespace dwarf_linker;
+
+/// The entry format is the magic, followed by the sections as (kind, size,
+/// contents) records terminated by EndOfSections, followed by the number of
+/// swift interfaces and the (module name, path) pairs. All integers are
+/// little-endian, the strings are prefixed with their 32-bit size.
+static constexpr StringLiteral EntryMagic = "DSYMDWC1";
+static constexpr uint8_t EndOfSections = 0xFF;
+
+LinkedDwarfCache::LinkedDwarfCache(StringRef Directory,
+                                   const LinkOptions &Options,
+                                   const DebugMap &Map)
+    : Directory(Directory) {
+  addToKey(EntryMagic);
+  addToKey(LLVM_VERSION_STRING);
+  addToKey(Map.getTriple().str());
+  addToKey(static_cast<uint64_t>(Options.DWARFLinkerType));
+  addToKey(static_cast<uint64_t>(Options.FileType));
+  addToKey(static_cast<uint64_t>(Options.TheAccelTableKind));
+  addToKey(Options.NoODR);
+  addToKey(Options.KeepFunctionForStatic);
+  addToKey(Options.PrependPath);
+  for (const auto &[From, To] : Options.ObjectPrefixMap) {
+    addToKey(From);
+    addToKey(To);
+  }
+}
+
+LinkedDwarfCache::~LinkedDwarfCache() {
+  if (!Temp)
+    return;
+  OS->clear_error();
+  OS.reset();
+  consumeError(Temp->discard());
+}
+
+void LinkedDwarfCache::addToKey(uint64_t Value) {
+  uint8_t Bytes[sizeof(Value)];
+  support::endian::write64le(Bytes, Value);
+  Hasher.update(Bytes);
+}
+
+void LinkedDwarfCache::addToKey(StringRef Value) {
+  addToKey(Value.size());
+  Hasher.update(Value);
+}
+
+void LinkedDwarfCache::addObject(const DebugMapObject &Obj,
+                                 StringRef Contents) {
+  addToKey(Obj.getObjectFilename());
+  addToKey(Obj.getType());
+  XXH128_hash_t Hash = xxh3_128bits(arrayRefFromStringRef(Contents));
+  addToKey(Hash.low64);
+  addToKey(Hash.high64);
+
+  // The symbols are kept in a StringMap, sort them to get a stable key.
+  std::vector<const DebugMapObject::DebugMapEntry *> Symbols;
+  Symbols.reserve(Obj.symbols().size());
+  for (const DebugMapObject::DebugMapEntry &Entry : Obj.symbols())
+    Symbols.push_back(&Entry);
+  llvm::sort(Symbols, [](const DebugMapObject::DebugMapEntry *LHS,
+                         const DebugMapObject::DebugMapEntry *RHS) {
+    return LHS->getKey() < RHS->getKey();
+  });
+  addToKey(Symbols.size());
+  for (const DebugMapObject::DebugMapEntry *Entry : Symbols) {
+    const SymbolMapping &Mapping = Entry->getValue();
+    addToKey(Entry->getKey());
+    addToKey(Mapping.ObjectAddress.has_value());
+    addToKey(Mapping.ObjectAddress ? uint64_t(*Mapping.ObjectAddress) : 0);
+    addToKey(uint64_t(Mapping.BinaryAddress));
+    addToKey(uint64_t(Mapping.Size));
+  }
+}
+
+std::unique_ptr<MemoryBuffer> LinkedDwarfCache::lookup() {
+  if (Key.empty())
+    Key = toHex(Hasher.final(), /*LowerCase=*/true);
+
+  SmallString<128> Path(Directory);
+  sys::path::append(Path, "dsymutil-" + Key);
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Entry = MemoryBuffer::getFile(
+      Path, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!Entry)
+    return nullptr;
+  return std::move(*Entry);
+}
+
+Error LinkedDwarfCache::replay(MemoryBufferRef Entry,
+                               SectionHandlerTy SectionHandler,
+                               SwiftInterfacesMapTy &SwiftInterfaces) {
+  DataExtractor Data(Entry.getBuffer(), /*IsLittleEndian=*/true, 8);
+  DataExtractor::Cursor C(0);
+  auto Malformed = [&]() {
+    return createStringError(std::errc::illegal_byte_sequence,
+                             "malformed linked DWARF cache entry '%s'",
+                             Entry.getBufferIdentifier().str().c_str());
+  };
+
+  if (Data.getBytes(C, EntryMagic.size()) != EntryMagic)
+    return joinErrors(Malformed(), C.takeError());
+
+  // Read the whole entry before emitting anything, so that a truncated entry
+  // doesn't produce a partial output.
+  std::vector<std::pair<DebugSectionKind, StringRef>> Sections;
+  while (C) {
+    uint8_t Kind = Data.getU8(C);
+    if (!C || Kind == EndOfSections)
+      break;
+    if (Kind >= static_cast<uint8_t>(DebugSectionKind::NumberOfEnumEntries))
+      return joinErrors(Malformed(), C.takeError());
+    uint64_t Size = Data.getU64(C);
+    Sections.emplace_back(static_cast<DebugSectionKind>(Kind),
+                          Data.getBytes(C, Size));
+  }
+
+  SwiftInterfacesMapTy Interfaces;
+  for (uint32_t I = 0, E = Data.getU32(C); C && I != E; ++I) {
+    StringRef Name = Data.getBytes(C, Data.getU32(C));
+    StringRef Path = Data.getBytes(C, Data.getU32(C));
+    Interfaces[Name.str()] = Path.str();
+  }
+  if (!C)
+    return joinErrors(Malformed(), C.takeError());
+
+  for (const auto &[Kind, Contents] : Sections)
+    SectionHandler(Contents, Kind);
+  SwiftInterfaces.insert(Interfaces.begin(), Interfaces.end());
+  return Error::success();
+}
+
+Error LinkedDwarfCache::beginEntry() {
+  if (Key.empty())
+    Key = toHex(Hasher.final(), /*LowerCase=*/true);
+
+  if (std::error_code EC = sys::fs::create_directories(Directory))
+    return createFileError(Directory, EC);
+
+  SmallString<128> Model(Directory);
+  sys::path::append(Model, "dsymutil-%%%%%%.tmp");
+  Expected<sys::fs::TempFile> File = sys::fs::TempFile::create(Model);
+  if (!File)
+    return File.takeError();
+
+  Temp.emplace(std::move(*File));
+  OS = std::make_unique<raw_fd_ostream>(Temp->FD, /*shouldClose=*/false);
+  *OS << EntryMagic;
+  return Error::success();
+}
+
+void LinkedDwarfCache::addSection(DebugSectionKind Kind, StringRef Contents) {
+  if (!OS)
+    return;
+
+  support::endian::Writer W(*OS, llvm::endianness::little);
+  W.write<uint8_t>(static_cast<uint8_t>(Kind));
+  W.write<uint64_t>(Contents.size());
+  *OS << Contents;
+}
+
+Error LinkedDwarfCache::commitEntry(
+    const SwiftInterfacesMapTy &SwiftInterfaces) {
+  if (!OS)
+    return Error::success();
+
+  support::endian::Writer W(*OS, llvm::endianness::little);
+  W.write<uint8_t>(EndOfSections);
+  W.write<uint32_t>(SwiftInterfaces.size());
+  for (const auto &[Name, Path] : SwiftInterfaces) {
+    W.write<uint32_t>(Name.size());
+    *OS << Name;
+    W.write<uint32_t>(Path.size());
+    *OS << Path;
+  }
+
+  OS->flush();
+  std::error_code EC = OS->error();
+  OS->clear_error();
+  OS.reset();
+  if (EC) {
+    Error E = createFileError(Temp->TmpName, EC);
+    Error DiscardErr = Temp->discard();
+    Temp.reset();
+    return joinErrors(std::move(E), std::move(DiscardErr));
+  }
+
+  SmallString<128> Path(Directory);
+  sys::path::append(Path, "dsymutil-" + Key);
+  Error E = Temp->keep(Path);
+  Temp.reset();
+  return E;
+}
+
+} // namespace dsymutil
+} // namespace llvm
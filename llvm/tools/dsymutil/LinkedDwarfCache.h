@@ -0,0 +1,95 @@
+//===- tools/dsymutil/LinkedDwarfCache.h ---------------------- *- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+/// \file
+///
+/// This file contains the declaration of the LinkedDwarfCache class, which
+/// keeps the DWARF sections generated by the parallel DWARF linker for a debug
+/// map, so that the DWARF doesn't need to be linked again when none of the
+/// object files or their debug map entries changed.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_DSYMUTIL_LINKEDDWARFCACHE_H
+#define LLVM_TOOLS_DSYMUTIL_LINKEDDWARFCACHE_H
+
+#include "LinkUtils.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/DWARFLinker/DWARFLinkerBase.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace llvm {
+namespace dsymutil {
+
+class DebugMap;
+class DebugMapObject;
+
+/// The key of a cache entry covers everything the linked DWARF depends on:
+/// the linking options, the contents of every object file and the debug map
+/// entries of every object file. The entry keeps the sections passed to the
+/// output DWARF handler, in order, and the swift interfaces found while
+/// linking.
+class LinkedDwarfCache {
+public:
+  using SwiftInterfacesMapTy = std::map<std::string, std::string>;
+  using SectionHandlerTy =
+      function_ref<void(StringRef, dwarf_linker::DebugSectionKind)>;
+
+  LinkedDwarfCache(StringRef Directory, const LinkOptions &Options,
+                   const DebugMap &Map);
+  ~LinkedDwarfCache();
+
+  /// Add the object file \p Obj with the contents \p Contents to the key. The
+  /// objects should be added in the debug map order. An object file which
+  /// couldn't be loaded should be added with empty contents.
+  void addObject(const DebugMapObject &Obj, StringRef Contents);
+
+  /// Finish the key and return the cached entry for it, if any.
+  std::unique_ptr<MemoryBuffer> lookup();
+
+  /// Pass the sections of the cached \p Entry to \p SectionHandler, and
+  /// return the swift interfaces stored in it into \p SwiftInterfaces.
+  static Error replay(MemoryBufferRef Entry, SectionHandlerTy SectionHandler,
+                      SwiftInterfacesMapTy &SwiftInterfaces);
+
+  /// Start a new cache entry for the key. Nothing is stored into the cache
+  /// if this fails.
+  Error beginEntry();
+
+  /// Add the section \p Contents of \p Kind to the new cache entry.
+  void addSection(dwarf_linker::DebugSectionKind Kind, StringRef Contents);
+
+  /// Write the \p SwiftInterfaces and store the new entry into the cache.
+  Error commitEntry(const SwiftInterfacesMapTy &SwiftInterfaces);
+
+private:
+  void addToKey(uint64_t Value);
+  void addToKey(StringRef Value);
+
+  std::string Directory;
+  SHA1 Hasher;
+  std::string Key;
+
+  /// The entry being written.
+  std::optional<sys::fs::TempFile> Temp;
+  std::unique_ptr<raw_fd_ostream> OS;
+};
+
+} // end namespace dsymutil
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_DSYMUTIL_LINKEDDWARFCACHE_H
@@ -315,6 +315,10 @@ static Expected<DsymutilOptions> getOptions(opt::InputArgList &Args) {
   Options.LinkOpts.Fat64 = Args.hasArg(OPT_fat64);
   Options.LinkOpts.KeepFunctionForStatic =
       Args.hasArg(OPT_keep_func_for_static);
+  Options.LinkOpts.MemoryBounded = Args.hasArg(OPT_memory_bounded);
+
+  if (opt::Arg *CacheDir = Args.getLastArg(OPT_incremental_cache))
+    Options.LinkOpts.IncrementalCacheDir = CacheDir->getValue();
 
   if (opt::Arg *ReproducerPath = Args.getLastArg(OPT_use_reproducer)) {
     Options.ReproMode = ReproducerMode::Use;
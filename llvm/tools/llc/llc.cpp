@@ -16,6 +16,8 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/CodeGen/CommandFlags.h"
 #include "llvm/CodeGen/LinkAllAsmWriterComponents.h"
 #include "llvm/CodeGen/LinkAllCodegenComponents.h"
@@ -47,6 +49,7 @@
 #include "llvm/Support/PluginLoader.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
@@ -56,6 +59,8 @@
 #include "llvm/TargetParser/SubtargetFeature.h"
 #include "llvm/TargetParser/Triple.h"
 #include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
+#include <atomic>
 #include <memory>
 #include <optional>
 using namespace llvm;
@@ -85,6 +90,11 @@ TimeCompilations("time-compilations", cl::Hidden, cl::init(1u),
                  cl::value_desc("N"),
                  cl::desc("Repeat compilation N times for timing"));
 
+static cl::opt<unsigned> CodeGenThreads(
+    "codegen-threads", cl::init(1u), cl::value_desc("N"),
+    cl::desc("Split the module into N partitions and compile them in "
+             "parallel. Partition I > 0 is written to <output>.I"));
+
 static cl::opt<bool> TimeTrace("time-trace", cl::desc("Record time trace"));
 
 static cl::opt<unsigned> TimeTraceGranularity(
@@ -445,6 +455,91 @@ static bool addPass(PassManagerBase &PM, const char *argv0,
   return false;
 }
 
+// Split M into CodeGenThreads partitions and compile each of them on a thread
+// pool in its own LLVMContext. The first partition is written to Out and
+// partition I to "<output>.I". Local symbols that are referenced across
+// partitions are promoted to hidden globals.
+static int compileModuleInParallel(Module &M, TargetMachine &TM,
+                                   const TargetLibraryInfoImpl &TLII,
+                                   std::unique_ptr<ToolOutputFile> Out) {
+  const Target &T = TM.getTarget();
+  std::string OutputName = Out->outputFilename();
+  sys::fs::OpenFlags OpenFlags =
+      codegen::getFileType() == CodeGenFileType::AssemblyFile
+          ? sys::fs::OF_TextWithCRLF
+          : sys::fs::OF_None;
+
+  std::vector<std::unique_ptr<ToolOutputFile>> Outs;
+  Outs.reserve(CodeGenThreads);
+  std::atomic<bool> HasErrors = false;
+  DefaultThreadPool Pool(heavyweight_hardware_concurrency(CodeGenThreads));
+
+  auto HandleModulePartition = [&](std::unique_ptr<Module> MPart) {
+    unsigned I = Outs.size();
+    if (I == 0) {
+      Outs.push_back(std::move(Out));
+    } else {
+      std::string Name = OutputName + "." + utostr(I);
+      std::error_code EC;
+      Outs.push_back(std::make_unique<ToolOutputFile>(Name, EC, OpenFlags));
+      if (EC)
+        reportError(EC.message(), Name);
+    }
+
+    // The partition still belongs to the context of M, so serialize it here
+    // and let the worker thread read it into a context of its own.
+    SmallString<0> BC;
+    raw_svector_ostream BCOS(BC);
+    WriteBitcodeToFile(*MPart, BCOS);
+
+    Pool.async(
+        [&, I](const SmallString<0> &BC) {
+          LLVMContext Ctx;
+          Ctx.setDiscardValueNames(DiscardValueNames);
+          Ctx.setDiagnosticHandler(std::make_unique<LLCDiagnosticHandler>());
+          Expected<std::unique_ptr<Module>> MOrErr =
+              parseBitcodeFile(MemoryBufferRef(BC, InputFilename), Ctx);
+          if (!MOrErr)
+            reportError(MOrErr.takeError(), InputFilename);
+
+          std::unique_ptr<TargetMachine> PartTM(T.createTargetMachine(
+              TM.getTargetTriple().str(), TM.getTargetCPU(),
+              TM.getTargetFeatureString(), TM.Options,
+              TM.getRelocationModel(), TM.getCodeModel(), TM.getOptLevel()));
+          if (std::optional<uint64_t> LDT =
+                  codegen::getExplicitLargeDataThreshold())
+            PartTM->setLargeDataThreshold(*LDT);
+          ToolOutputFile &PartOut = *Outs[I];
+          PartTM->Options.ObjectFilenameForDebug = PartOut.outputFilename();
+
+          legacy::PassManager PM;
+          PM.add(new TargetLibraryInfoWrapperPass(TLII));
+          if (PartTM->addPassesToEmitFile(PM, PartOut.os(), nullptr,
+                                          codegen::getFileType(), NoVerify))
+            reportError("target does not support generation of this file "
+                        "type");
+          PM.run(**MOrErr);
+          if (Ctx.getDiagHandlerPtr()->HasErrors)
+            HasErrors = true;
+        },
+        std::move(BC));
+  };
+
+  // Try target-specific module splitting first, then fall back to the
+  // cost-based default.
+  if (!TM.splitModule(M, CodeGenThreads, HandleModulePartition))
+    SplitModule(M, CodeGenThreads, HandleModulePartition,
+                /*PreserveLocals=*/false, /*RoundRobin=*/false,
+                /*CostBased=*/true);
+  Pool.wait();
+
+  if (HasErrors)
+    return 1;
+  for (std::unique_ptr<ToolOutputFile> &PartOut : Outs)
+    PartOut->keep();
+  return 0;
+}
+
 static int compileModule(char **argv, LLVMContext &Context) {
   // Load the module to be compiled...
   SMDiagnostic Err;
@@ -666,6 +761,14 @@ static int compileModule(char **argv, LLVMContext &Context) {
                                   PassPipeline, codegen::getFileType());
   }
 
+  if (CodeGenThreads > 1) {
+    if (MIR || !getRunPassNames().empty() || CompileTwice || DwoOut ||
+        Out->outputFilename() == "-")
+      reportError("-codegen-threads cannot be used with MIR input, -run-pass, "
+                  "-compile-twice, -split-dwarf-output or standard output");
+    return compileModuleInParallel(*M, *Target, TLII, std::move(Out));
+  }
+
   // Build up all of the passes that we want to do to the module.
   legacy::PassManager PM;
   PM.add(new TargetLibraryInfoWrapperPass(TLII));
@@ -32,6 +32,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
@@ -41,6 +42,7 @@
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/TargetParser/Triple.h"
 
 #include <functional>
@@ -129,9 +131,24 @@ private:
   /// If a demangler is available, demangle all symbol names.
   void demangleSymbols(const CoverageMapping &Coverage);
 
-  /// Write out a source file view to the filesystem.
+  /// Return a hash of everything the view of \p SourceFile is rendered from,
+  /// besides the view options.
+  uint64_t hashSourceFileView(StringRef SourceFile, const MemoryBuffer &Source,
+                              const CoverageMapping &Coverage);
+
+  /// Read the hashes of the views written by the previous -incremental report
+  /// from the output directory, if it was written with the same options.
+  void readViewHashes(uint64_t OptionsHash);
+
+  /// Write the hashes of the views of this report to the output directory.
+  void writeViewHashes(uint64_t OptionsHash, ArrayRef<uint64_t> ViewHashes);
+
+  /// Write out a source file view to the filesystem. In -incremental mode,
+  /// the hash of the view is stored into \p ViewHash, and the view isn't
+  /// written if the previous report has a view with the same hash.
   void writeSourceFileView(StringRef SourceFile, CoverageMapping *Coverage,
-                           CoveragePrinter *Printer, bool ShowFilenames);
+                           CoveragePrinter *Printer, bool ShowFilenames,
+                           uint64_t *ViewHash = nullptr);
 
   typedef llvm::function_ref<int(int, const char **)> CommandLineParserType;
 
@@ -190,9 +207,16 @@ private:
   std::unique_ptr<object::BuildIDFetcher> BIDFetcher;
 
   bool CheckBinaryIDs;
+
+  /// In -incremental mode, the view hashes of the previous report by source
+  /// file.
+  StringMap<uint64_t> PreviousViewHashes;
 };
 }
 
+/// The name of the file keeping the view hashes in the output directory.
+static constexpr StringLiteral ViewHashesFilename = ".llvm-cov-view-hashes";
+
 static std::string getErrorString(const Twine &Message, StringRef Whence,
                                   bool Warning) {
   std::string Str = (Warning ? "warning" : "error");
@@ -628,10 +652,100 @@ void CodeCoverageTool::demangleSymbols(const CoverageMapping &Coverage) {
     DC.DemangledNames[Function.Name] = std::string(Symbols[I++].rtrim());
 }
 
+uint64_t CodeCoverageTool::hashSourceFileView(StringRef SourceFile,
+                                              const MemoryBuffer &Source,
+                                              const CoverageMapping &Coverage) {
+  // The view is rendered from the source and the function records in the
+  // file, including those of the other files they expand into.
+  SmallString<1024> Key;
+  raw_svector_ostream OS(Key);
+  OS << SourceFile << '\0' << xxh3_64bits(Source.getBuffer()) << '\n';
+  auto WriteRegion = [&](const CountedRegion &R) {
+    OS << R.FileID << ' ' << R.ExpandedFileID << ' ' << R.Kind << ' '
+       << R.LineStart << ' ' << R.ColumnStart << ' ' << R.LineEnd << ' '
+       << R.ColumnEnd << ' ' << R.ExecutionCount << ' '
+       << R.FalseExecutionCount << ' ' << R.TrueFolded << R.FalseFolded
+       << '\n';
+  };
+  for (const FunctionRecord &Function :
+       Coverage.getCoveredFunctions(SourceFile)) {
+    OS << Function.Name << '\0' << Function.ExecutionCount << '\n';
+    for (const std::string &Filename : Function.Filenames)
+      OS << Filename << '\0';
+    for (const CountedRegion &R : Function.CountedRegions)
+      WriteRegion(R);
+    for (const CountedRegion &R : Function.CountedBranchRegions)
+      WriteRegion(R);
+    for (MCDCRecord Record : Function.MCDCRecords) {
+      unsigned NumConditions = Record.getNumConditions();
+      for (unsigned TV = 0; TV < Record.getNumTestVectors(); ++TV) {
+        for (unsigned C = 0; C < NumConditions; ++C)
+          OS << Record.getTVCondition(TV, C) << ' ';
+        OS << Record.getTVResult(TV) << '\n';
+      }
+      for (unsigned C = 0; C < NumConditions; ++C)
+        OS << Record.isCondFolded(C)
+           << Record.isConditionIndependencePairCovered(C);
+      OS << '\n';
+    }
+  }
+  return xxh3_64bits(Key);
+}
+
+void CodeCoverageTool::readViewHashes(uint64_t OptionsHash) {
+  SmallString<256> Path(ViewOpts.ShowOutputDirectory);
+  sys::path::append(Path, ViewHashesFilename);
+  auto BufOrErr = MemoryBuffer::getFile(Path);
+  if (!BufOrErr)
+    return;
+
+  // The first line has the hash of the options, and each of the other lines
+  // the view hash and the name of a source file.
+  SmallVector<StringRef, 0> Lines;
+  (*BufOrErr)->getBuffer().split(Lines, '\n', /*MaxSplit=*/-1,
+                                 /*KeepEmpty=*/false);
+  uint64_t Hash;
+  if (Lines.empty() || Lines[0].getAsInteger(16, Hash) || Hash != OptionsHash)
+    return;
+  for (StringRef Line : drop_begin(Lines)) {
+    auto [HashStr, SourceFile] = Line.split(' ');
+    if (!HashStr.getAsInteger(16, Hash))
+      PreviousViewHashes[SourceFile] = Hash;
+  }
+}
+
+void CodeCoverageTool::writeViewHashes(uint64_t OptionsHash,
+                                       ArrayRef<uint64_t> ViewHashes) {
+  SmallString<256> Path(ViewOpts.ShowOutputDirectory);
+  sys::path::append(Path, ViewHashesFilename);
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::OF_TextWithCRLF);
+  if (EC) {
+    warning("could not write view hashes: " + EC.message(), Path);
+    return;
+  }
+  OS << Twine::utohexstr(OptionsHash) << '\n';
+  for (auto [SourceFile, Hash] : zip_equal(SourceFiles, ViewHashes))
+    if (Hash)
+      OS << Twine::utohexstr(Hash) << ' ' << SourceFile << '\n';
+}
+
 void CodeCoverageTool::writeSourceFileView(StringRef SourceFile,
                                            CoverageMapping *Coverage,
                                            CoveragePrinter *Printer,
-                                           bool ShowFilenames) {
+                                           bool ShowFilenames,
+                                           uint64_t *ViewHash) {
+  if (ViewHash) {
+    // getSourceFile reports the source files which can't be read.
+    auto SourceBuffer = getSourceFile(SourceFile);
+    if (!SourceBuffer)
+      return;
+    *ViewHash = hashSourceFileView(SourceFile, SourceBuffer.get(), *Coverage);
+    auto It = PreviousViewHashes.find(SourceFile);
+    if (It != PreviousViewHashes.end() && It->second == *ViewHash)
+      return;
+  }
+
   auto View = createSourceFileView(SourceFile, *Coverage);
   if (!View) {
     warning("The file '" + SourceFile + "' isn't covered.");
@@ -950,6 +1064,8 @@ int CodeCoverageTool::run(Command Cmd, int argc, const char **argv) {
     ViewOpts.ShowInstantiationSummary = InstantiationSummary;
     ViewOpts.ExportSummaryOnly = SummaryOnly;
     ViewOpts.NumThreads = NumThreads;
+    // The function records are also evaluated with this many threads.
+    parallel::strategy = hardware_concurrency(NumThreads);
     ViewOpts.CompilationDirectory = CompilationDirectory;
 
     return 0;
@@ -1038,6 +1154,13 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
       "project-title", cl::Optional,
       cl::desc("Set project title for the coverage report"));
 
+  cl::opt<bool> Incremental(
+      "incremental", cl::Optional,
+      cl::desc("Only write the source file views whose source or coverage "
+               "changed since the previous -incremental report in the "
+               "output directory"),
+      cl::init(false));
+
   cl::opt<std::string> CovWatermark(
       "coverage-watermark", cl::Optional,
       cl::desc("<high>,<low> value indicate thresholds for high and low"
@@ -1117,6 +1240,21 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
     }
   }
 
+  if (Incremental && !ViewOpts.hasOutputDirectory()) {
+    error("-incremental requires an output directory");
+    return 1;
+  }
+
+  // Any change to the command line may change the rendering of the views.
+  uint64_t OptionsHash = 0;
+  if (Incremental) {
+    SmallString<256> CommandLine;
+    for (int I = 0; I < argc; ++I)
+      (CommandLine += argv[I]) += '\0';
+    OptionsHash = xxh3_64bits(CommandLine);
+    readViewHashes(OptionsHash);
+  }
+
   sys::fs::file_status Status;
   if (std::error_code EC = sys::fs::status(PGOFilename, Status)) {
     error("could not read profile data!" + EC.message(), PGOFilename);
@@ -1205,19 +1343,27 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
     S.Limit = true;
   }
 
+  // A hash of zero marks the views which weren't written.
+  std::vector<uint64_t> ViewHashes(SourceFiles.size());
+  auto GetViewHash = [&](unsigned I) {
+    return Incremental ? &ViewHashes[I] : nullptr;
+  };
   if (!ViewOpts.hasOutputDirectory() || S.ThreadsRequested == 1) {
-    for (const std::string &SourceFile : SourceFiles)
+    for (const auto &[I, SourceFile] : enumerate(SourceFiles))
       writeSourceFileView(SourceFile, Coverage.get(), Printer.get(),
-                          ShowFilenames);
+                          ShowFilenames, GetViewHash(I));
   } else {
     // In -output-dir mode, it's safe to use multiple threads to print files.
     DefaultThreadPool Pool(S);
-    for (const std::string &SourceFile : SourceFiles)
+    for (const auto &[I, SourceFile] : enumerate(SourceFiles))
       Pool.async(&CodeCoverageTool::writeSourceFileView, this, SourceFile,
-                 Coverage.get(), Printer.get(), ShowFilenames);
+                 Coverage.get(), Printer.get(), ShowFilenames, GetViewHash(I));
     Pool.wait();
   }
 
+  if (Incremental)
+    writeViewHashes(OptionsHash, ViewHashes);
+
   return 0;
 }
 
@@ -37,6 +37,7 @@
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Triple.h"
+#include <atomic>
 #include <cstdlib>
 
 using namespace llvm;
@@ -297,6 +298,11 @@ static opt<ErrorDetailLevel> ErrorDetails(
            clEnumValN(BothDetailsAndSummary, "full",
                       "Display each error as well as a summary. [default]")),
     cat(DwarfDumpCategory));
+static opt<unsigned> NumThreads(
+    "num-threads",
+    desc("Number of threads to use with --verify. Use 0 to use all available "
+         "hardware threads. [default: 1]"),
+    init(1), value_desc("N"), cat(DwarfDumpCategory));
 static opt<std::string> JsonErrSummaryFile(
     "verify-json", init(""),
     desc("Output JSON-formatted error summary to the specified file. "
@@ -357,6 +363,7 @@ static DIDumpOptions getDumpOpts(DWARFContext &C) {
     DumpOpts.ShowAggregateErrors = ErrorDetails != OnlyDetailsNoSummary &&
                                    ErrorDetails != NoDetailsOnlySummary;
     DumpOpts.JsonErrSummaryFile = JsonErrSummaryFile;
+    DumpOpts.VerifyNumThreads = NumThreads;
     return DumpOpts.noImplicitRecursion();
   }
   return DumpOpts;
@@ -766,7 +773,10 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
   Expected<std::unique_ptr<Binary>> BinOrErr = object::createBinary(Buffer);
   error(Filename, BinOrErr.takeError());
 
-  bool Result = true;
+  // Parallel verification needs a context that can be used from several
+  // threads, and may report recoverable errors from any of them.
+  bool ThreadSafe = Verify && NumThreads != 1;
+  std::atomic<bool> Result = true;
   auto RecoverableErrorHandler = [&](Error E) {
     Result = false;
     WithColor::defaultErrorHandler(std::move(E));
@@ -775,7 +785,8 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
     if (filterArch(*Obj)) {
       std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
           *Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr, "",
-          RecoverableErrorHandler);
+          RecoverableErrorHandler, WithColor::defaultWarningHandler,
+          ThreadSafe);
       DICtx->setParseCUTUIndexManually(ManuallyGenerateUnitIndex);
       if (!HandleObj(*Obj, *DICtx, Filename, OS))
         Result = false;
@@ -789,7 +800,8 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
         if (filterArch(Obj)) {
           std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
               Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr, "",
-              RecoverableErrorHandler);
+              RecoverableErrorHandler, WithColor::defaultWarningHandler,
+              ThreadSafe);
           if (!HandleObj(Obj, *DICtx, ObjName, OS))
             Result = false;
         }
@@ -161,6 +161,15 @@ int llvm_dwp_main(int argc, char **argv, const llvm::ToolContext &) {
     }
   }
 
+  unsigned NumThreads = 0;
+  if (Arg *A = Args.getLastArg(OPT_numThreads)) {
+    StringRef S = A->getValue();
+    if (S.getAsInteger(10, NumThreads)) {
+      llvm::errs() << "invalid value for --num-threads: " << S << '\n';
+      exit(1);
+    }
+  }
+
   for (const llvm::opt::Arg *A : Args.filtered(OPT_execFileNames))
     ExecFilenames.emplace_back(A->getValue());
 
@@ -273,7 +282,7 @@ int llvm_dwp_main(int argc, char **argv, const llvm::ToolContext &) {
   if (!MS)
     return error("no object streamer for target " + TripleName, Context);
 
-  if (auto Err = write(*MS, DWOFilenames, OverflowOptValue)) {
+  if (auto Err = write(*MS, DWOFilenames, OverflowOptValue, NumThreads)) {
     logAllUnhandledErrors(std::move(Err), WithColor::error());
     return 1;
   }
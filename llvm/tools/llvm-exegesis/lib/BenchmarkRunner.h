@@ -54,6 +54,14 @@ public:
     RunnableConfiguration &operator=(RunnableConfiguration &&) = delete;
     RunnableConfiguration &operator=(const RunnableConfiguration &) = delete;
 
+    // Returns the assembled benchmark code, or an empty buffer if the code
+    // isn't assembled in the selected benchmark phase.
+    StringRef getObjectFileContents() const {
+      if (const object::ObjectFile *Obj = ObjectFile.getBinary())
+        return Obj->getData();
+      return StringRef();
+    }
+
   private:
     RunnableConfiguration() = default;
 
@@ -43,8 +43,12 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/TargetParser/Host.h"
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <string>
 
 namespace llvm {
@@ -274,6 +278,21 @@ static cl::opt<int> BenchmarkProcessCPU(
     cl::desc("The CPU number that the benchmarking process should executon on"),
     cl::cat(BenchmarkOptions), cl::init(-1));
 
+static cl::list<int> BenchmarkProcessCPUs(
+    "benchmark-process-cpus",
+    cl::desc("A list of CPU numbers on which snippets are measured "
+             "concurrently, one benchmarking process per CPU. Requires the "
+             "subprocess execution mode. The CPUs should be isolated from the "
+             "rest of the system"),
+    cl::CommaSeparated, cl::cat(BenchmarkOptions));
+
+static cl::opt<std::string> BenchmarkCacheDir(
+    "benchmark-cache-dir",
+    cl::desc("A directory holding the results of earlier measurements. The "
+             "snippets already measured with the same assembled code and "
+             "options aren't measured again"),
+    cl::cat(BenchmarkOptions), cl::init(""));
+
 static cl::opt<std::string> MAttr(
     "mattr", cl::desc("comma-separated list of target architecture features"),
     cl::value_desc("+feature1,-feature2,..."), cl::cat(Options), cl::init(""));
@@ -397,6 +416,126 @@ generateSnippets(const LLVMState &State, unsigned Opcode,
   return Benchmarks;
 }
 
+// Measures a configuration with all its repetitions, and aggregates the
+// results.
+static Expected<Benchmark> measureConfiguration(
+    MutableArrayRef<BenchmarkRunner::RunnableConfiguration> RCs,
+    const BenchmarkRunner &Runner, std::optional<int> BenchmarkCPU) {
+  SmallVector<Benchmark, 2> AllResults;
+  for (BenchmarkRunner::RunnableConfiguration &RC : RCs) {
+    std::optional<StringRef> DumpFile;
+    if (DumpObjectToDisk.getNumOccurrences())
+      DumpFile = DumpObjectToDisk;
+    auto [Err, BenchmarkResult] =
+        Runner.runConfiguration(std::move(RC), DumpFile, BenchmarkCPU);
+    if (Err) {
+      // Errors from executing the snippets are fine.
+      // All other errors are a framework issue and should fail.
+      if (!Err.isA<SnippetExecutionFailure>())
+        return std::move(Err);
+
+      BenchmarkResult.Error = toString(std::move(Err));
+    }
+    AllResults.push_back(std::move(BenchmarkResult));
+  }
+
+  Benchmark &Result = AllResults.front();
+
+  // If any of our measurements failed, pretend they all have failed.
+  if (AllResults.size() > 1 &&
+      any_of(AllResults,
+             [](const Benchmark &R) { return R.Measurements.empty(); }))
+    Result.Measurements.clear();
+
+  std::unique_ptr<ResultAggregator> ResultAgg =
+      ResultAggregator::CreateAggregator(RepetitionMode);
+  ResultAgg->AggregateResults(Result,
+                              ArrayRef<Benchmark>(AllResults).drop_front());
+
+  // With dummy counters, measurements are rather meaningless,
+  // so drop them altogether.
+  if (UseDummyPerfCounters)
+    Result.Measurements.clear();
+
+  return std::move(Result);
+}
+
+// Returns the path of the entry of the benchmark cache for a configuration.
+// The key covers everything that influences the measurement: the assembled
+// code of all the repetitions, the memory setup of the snippet, and the
+// measurement options.
+static std::string getBenchmarkCachePath(
+    const LLVMState &State, const BenchmarkCode &Conf,
+    ArrayRef<BenchmarkRunner::RunnableConfiguration> RCs) {
+  std::string Key;
+  raw_string_ostream OS(Key);
+  OS << State.getTargetMachine().getTargetTriple().normalize() << '\0'
+     << State.getTargetMachine().getTargetCPU() << '\0' << MAttr << '\0'
+     << BenchmarkMode << '\0' << RepetitionMode << '\0' << ResultAggMode
+     << '\0' << BenchmarkRepeatCount << '\0' << ExecutionMode << '\0'
+     << Conf.Key.Config << '\0' << Conf.Key.SnippetAddress << '\0';
+  for (const ValidationEvent &Event : ValidationCounters)
+    OS << Event << ',';
+  OS << '\0';
+  std::vector<StringRef> MemoryValueNames;
+  for (const auto &[Name, Value] : Conf.Key.MemoryValues)
+    MemoryValueNames.push_back(Name);
+  llvm::sort(MemoryValueNames);
+  for (StringRef Name : MemoryValueNames) {
+    const MemoryValue &Value = Conf.Key.MemoryValues.at(Name.str());
+    OS << Name << '=' << toString(Value.Value, 16, /*Signed=*/false) << ','
+       << Value.SizeBytes << ',' << Value.Index << '\0';
+  }
+  for (const MemoryMapping &Mapping : Conf.Key.MemoryMappings)
+    OS << Mapping.Address << ':' << Mapping.MemoryValueName << '\0';
+  for (const BenchmarkRunner::RunnableConfiguration &RC : RCs)
+    OS << RC.getObjectFileContents().size() << ':'
+       << RC.getObjectFileContents();
+
+  SmallString<128> Path(BenchmarkCacheDir);
+  sys::path::append(Path, "exegesis-" + utohexstr(xxh3_64bits(Key)) + ".yaml");
+  return std::string(Path);
+}
+
+// Returns the result stored in the benchmark cache at Path, if any.
+static std::optional<Benchmark> readCachedBenchmark(const LLVMState &State,
+                                                    StringRef Path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer =
+      MemoryBuffer::getFile(Path, /*IsText=*/true);
+  if (!Buffer)
+    return std::nullopt;
+  Expected<Benchmark> Result = Benchmark::readYaml(State, **Buffer);
+  if (!Result) {
+    consumeError(Result.takeError());
+    return std::nullopt;
+  }
+  return std::move(*Result);
+}
+
+// Stores Result in the benchmark cache at Path. The cache is best effort, the
+// configuration is measured again next time if this fails.
+static void writeCachedBenchmark(const LLVMState &State, StringRef Path,
+                                 Benchmark &Result) {
+  Expected<sys::fs::TempFile> Temp =
+      sys::fs::TempFile::create(Path + ".tmp-%%%%%%");
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    if (Error Err = Result.writeYamlTo(State, OS)) {
+      consumeError(std::move(Err));
+      consumeError(Temp->discard());
+      return;
+    }
+  }
+  // Writing the entry in one step keeps concurrent runs from reading partial
+  // entries.
+  if (Error Err = Temp->keep(Path))
+    consumeError(std::move(Err));
+}
+
 static void runBenchmarkConfigurations(
     const LLVMState &State, ArrayRef<BenchmarkCode> Configurations,
     ArrayRef<std::unique_ptr<const SnippetRepetitor>> Repetitors,
@@ -413,66 +552,107 @@ static void runBenchmarkConfigurations(
   }
   raw_ostream &Ostr = FileOstr ? *FileOstr : outs();
 
-  std::optional<ProgressMeter<>> Meter;
-  if (BenchmarkMeasurementsPrintProgress)
-    Meter.emplace(Configurations.size());
-
   SmallVector<unsigned, 2> MinInstructionCounts = {MinInstructions};
   if (RepetitionMode == Benchmark::MiddleHalfDuplicate ||
       RepetitionMode == Benchmark::MiddleHalfLoop)
     MinInstructionCounts.push_back(MinInstructions * 2);
 
-  for (const BenchmarkCode &Conf : Configurations) {
-    ProgressMeter<>::ProgressMeterStep MeterStep(Meter ? &*Meter : nullptr);
-    SmallVector<Benchmark, 2> AllResults;
-
+  auto getRunnableConfigurations = [&](const BenchmarkCode &Conf) {
+    std::vector<BenchmarkRunner::RunnableConfiguration> RCs;
     for (const std::unique_ptr<const SnippetRepetitor> &Repetitor :
-         Repetitors) {
-      for (unsigned IterationRepetitions : MinInstructionCounts) {
-        auto RC = ExitOnErr(Runner.getRunnableConfiguration(
-            Conf, IterationRepetitions, LoopBodySize, *Repetitor));
-        std::optional<StringRef> DumpFile;
-        if (DumpObjectToDisk.getNumOccurrences())
-          DumpFile = DumpObjectToDisk;
-        const std::optional<int> BenchmarkCPU =
-            BenchmarkProcessCPU == -1
-                ? std::nullopt
-                : std::optional(BenchmarkProcessCPU.getValue());
-        auto [Err, BenchmarkResult] =
-            Runner.runConfiguration(std::move(RC), DumpFile, BenchmarkCPU);
-        if (Err) {
-          // Errors from executing the snippets are fine.
-          // All other errors are a framework issue and should fail.
-          if (!Err.isA<SnippetExecutionFailure>())
-            ExitOnErr(std::move(Err));
-
-          BenchmarkResult.Error = toString(std::move(Err));
+         Repetitors)
+      for (unsigned IterationRepetitions : MinInstructionCounts)
+        RCs.push_back(ExitOnErr(Runner.getRunnableConfiguration(
+            Conf, IterationRepetitions, LoopBodySize, *Repetitor)));
+    return RCs;
+  };
+  const bool UseCache =
+      !BenchmarkCacheDir.empty() &&
+      BenchmarkPhaseSelector == BenchmarkPhaseSelectorE::Measure;
+  if (UseCache)
+    ExitOnFileError(BenchmarkCacheDir,
+                    errorCodeToError(sys::fs::create_directories(
+                        BenchmarkCacheDir, /*IgnoreExisting=*/true)));
+
+  if (BenchmarkProcessCPUs.empty()) {
+    std::optional<ProgressMeter<>> Meter;
+    if (BenchmarkMeasurementsPrintProgress)
+      Meter.emplace(Configurations.size());
+
+    const std::optional<int> BenchmarkCPU =
+        BenchmarkProcessCPU == -1
+            ? std::nullopt
+            : std::optional(BenchmarkProcessCPU.getValue());
+    for (const BenchmarkCode &Conf : Configurations) {
+      ProgressMeter<>::ProgressMeterStep MeterStep(Meter ? &*Meter : nullptr);
+      auto RCs = getRunnableConfigurations(Conf);
+      std::string CachePath;
+      if (UseCache) {
+        CachePath = getBenchmarkCachePath(State, Conf, RCs);
+        if (std::optional<Benchmark> Cached =
+                readCachedBenchmark(State, CachePath)) {
+          ExitOnFileError(BenchmarkFile, Cached->writeYamlTo(State, Ostr));
+          continue;
         }
-        AllResults.push_back(std::move(BenchmarkResult));
       }
+      Benchmark Result =
+          ExitOnErr(measureConfiguration(RCs, Runner, BenchmarkCPU));
+      if (UseCache && Result.Error.empty())
+        writeCachedBenchmark(State, CachePath, Result);
+      ExitOnFileError(BenchmarkFile, Result.writeYamlTo(State, Ostr));
     }
+    return;
+  }
 
-    Benchmark &Result = AllResults.front();
-
-    // If any of our measurements failed, pretend they all have failed.
-    if (AllResults.size() > 1 &&
-        any_of(AllResults, [](const Benchmark &R) {
-          return R.Measurements.empty();
-        }))
-      Result.Measurements.clear();
-
-    std::unique_ptr<ResultAggregator> ResultAgg =
-        ResultAggregator::CreateAggregator(RepetitionMode);
-    ResultAgg->AggregateResults(Result,
-                                ArrayRef<Benchmark>(AllResults).drop_front());
-
-    // With dummy counters, measurements are rather meaningless,
-    // so drop them altogether.
-    if (UseDummyPerfCounters)
-      Result.Measurements.clear();
+  // Assemble all the snippets up front, as the code generation is shared
+  // between the threads, then measure them with one benchmarking process per
+  // CPU. The results are written in the order of the configurations.
+  std::vector<std::vector<BenchmarkRunner::RunnableConfiguration>> AllRCs;
+  std::vector<std::string> CachePaths(Configurations.size());
+  std::vector<std::optional<Benchmark>> Results(Configurations.size());
+  std::vector<size_t> ToMeasure;
+  for (size_t I = 0; I < Configurations.size(); ++I) {
+    AllRCs.push_back(getRunnableConfigurations(Configurations[I]));
+    if (UseCache) {
+      CachePaths[I] =
+          getBenchmarkCachePath(State, Configurations[I], AllRCs[I]);
+      if (std::optional<Benchmark> Cached =
+              readCachedBenchmark(State, CachePaths[I]))
+        Results[I].emplace(std::move(*Cached));
+    }
+    if (!Results[I])
+      ToMeasure.push_back(I);
+  }
 
-    ExitOnFileError(BenchmarkFile, Result.writeYamlTo(State, Ostr));
+  std::atomic<size_t> Next = 0;
+  std::mutex ErrorMutex;
+  Error FirstError = Error::success();
+  {
+    DefaultThreadPool Pool(hardware_concurrency(BenchmarkProcessCPUs.size()));
+    for (int CPU : BenchmarkProcessCPUs) {
+      Pool.async([&, CPU]() {
+        for (size_t N = Next++; N < ToMeasure.size(); N = Next++) {
+          const size_t I = ToMeasure[N];
+          Expected<Benchmark> Result =
+              measureConfiguration(AllRCs[I], Runner, CPU);
+          if (!Result) {
+            std::lock_guard<std::mutex> Lock(ErrorMutex);
+            FirstError = joinErrors(std::move(FirstError), Result.takeError());
+            // Stop all the workers.
+            Next = ToMeasure.size();
+            return;
+          }
+          if (UseCache && Result->Error.empty())
+            writeCachedBenchmark(State, CachePaths[I], *Result);
+          Results[I].emplace(std::move(*Result));
+        }
+      });
+    }
   }
+  ExitOnErr(std::move(FirstError));
+
+  for (std::optional<Benchmark> &Result : Results)
+    ExitOnFileError(BenchmarkFile, Result->writeYamlTo(State, Ostr));
 }
 
 void benchmarkMain() {
@@ -504,6 +684,15 @@ void benchmarkMain() {
   if (BenchmarkPhaseSelector == BenchmarkPhaseSelectorE::Measure)
     ExitOnErr(State.getExegesisTarget().checkFeatureSupport());
 
+  if (!BenchmarkProcessCPUs.empty()) {
+    if (ExecutionMode != BenchmarkRunner::ExecutionModeE::SubProcess)
+      ExitWithError("--benchmark-process-cpus requires the subprocess "
+                    "execution mode");
+    if (BenchmarkProcessCPU != -1)
+      ExitWithError("--benchmark-process-cpu and --benchmark-process-cpus "
+                    "can't be used together");
+  }
+
   if (ExecutionMode == BenchmarkRunner::ExecutionModeE::SubProcess &&
       UseDummyPerfCounters)
     ExitWithError("Dummy perf counters are not supported in the subprocess "
@@ -653,19 +653,6 @@ static std::unique_ptr<JITLinkMemoryManager> createInProcessMemoryManager() {
 
 Expected<std::unique_ptr<jitlink::JITLinkMemoryManager>>
 createSharedMemoryManager(SimpleRemoteEPC &SREPC) {
-  SharedMemoryMapper::SymbolAddrs SAs;
-  if (auto Err = SREPC.getBootstrapSymbols(
-          {{SAs.Instance, rt::ExecutorSharedMemoryMapperServiceInstanceName},
-           {SAs.Reserve,
-            rt::ExecutorSharedMemoryMapperServiceReserveWrapperName},
-           {SAs.Initialize,
-            rt::ExecutorSharedMemoryMapperServiceInitializeWrapperName},
-           {SAs.Deinitialize,
-            rt::ExecutorSharedMemoryMapperServiceDeinitializeWrapperName},
-           {SAs.Release,
-            rt::ExecutorSharedMemoryMapperServiceReleaseWrapperName}}))
-    return std::move(Err);
-
 #ifdef _WIN32
   size_t SlabSize = 1024 * 1024;
 #else
@@ -675,8 +662,7 @@ createSharedMemoryManager(SimpleRemoteEPC &SREPC) {
   if (!SlabAllocateSizeString.empty())
     SlabSize = ExitOnErr(getSlabAllocSize(SlabAllocateSizeString));
 
-  return MapperJITLinkMemoryManager::CreateWithMapper<SharedMemoryMapper>(
-      SlabSize, SREPC, SAs);
+  return SimpleRemoteEPC::createSharedMemoryManager(SREPC, SlabSize);
 }
 
 
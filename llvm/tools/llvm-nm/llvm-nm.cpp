@@ -44,6 +44,7 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/LLVMDriver.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
@@ -51,6 +52,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Host.h"
 #include "llvm/TargetParser/Triple.h"
+#include <atomic>
 #include <vector>
 
 using namespace llvm;
@@ -136,20 +138,28 @@ static bool MachOPrintSizeWarning = false;
 // Miscellaneous states.
 static bool PrintAddress = true;
 static bool MultipleFiles = false;
-static bool HadError = false;
+static std::atomic<bool> HadError = false;
+static unsigned Threads = 1;
 
 static StringRef ToolName;
 
+// The diagnostics of the archive members whose symbols are read in parallel
+// are buffered, and printed when the member is printed.
+static thread_local raw_ostream *DiagStream = nullptr;
+
+static raw_ostream &diagStream() { return DiagStream ? *DiagStream : errs(); }
+
 static void warn(Error Err, Twine FileName, Twine Context = Twine(),
                  Twine Archive = Twine()) {
   assert(Err);
 
   // Flush the standard output so that the warning isn't interleaved with other
   // output if stdout and stderr are writing to the same place.
-  outs().flush();
+  if (!DiagStream)
+    outs().flush();
 
   handleAllErrors(std::move(Err), [&](const ErrorInfoBase &EI) {
-    WithColor::warning(errs(), ToolName)
+    WithColor::warning(diagStream(), ToolName)
         << (Archive.str().empty() ? FileName : Archive + "(" + FileName + ")")
         << ": " << (Context.str().empty() ? "" : Context + ": ") << EI.message()
         << "\n";
@@ -158,7 +168,7 @@ static void warn(Error Err, Twine FileName, Twine Context = Twine(),
 
 static void error(Twine Message, Twine Path = Twine()) {
   HadError = true;
-  WithColor::error(errs(), ToolName) << Path << ": " << Message << "\n";
+  WithColor::error(diagStream(), ToolName) << Path << ": " << Message << "\n";
 }
 
 static bool error(std::error_code EC, Twine Path = Twine()) {
@@ -175,7 +185,8 @@ static bool error(std::error_code EC, Twine Path = Twine()) {
 static void error(llvm::Error E, StringRef FileName, const Archive::Child &C,
                   StringRef ArchitectureName = StringRef()) {
   HadError = true;
-  WithColor::error(errs(), ToolName) << FileName;
+  raw_ostream &OS = diagStream();
+  WithColor::error(OS, ToolName) << FileName;
 
   Expected<StringRef> NameOrErr = C.getName();
   // TODO: if we have a error getting the name then it would be nice to print
@@ -183,18 +194,18 @@ static void error(llvm::Error E, StringRef FileName, const Archive::Child &C,
   // archive instead of "???" as the name.
   if (!NameOrErr) {
     consumeError(NameOrErr.takeError());
-    errs() << "(" << "???" << ")";
+    OS << "(" << "???" << ")";
   } else
-    errs() << "(" << NameOrErr.get() << ")";
+    OS << "(" << NameOrErr.get() << ")";
 
   if (!ArchitectureName.empty())
-    errs() << " (for architecture " << ArchitectureName << ")";
+    OS << " (for architecture " << ArchitectureName << ")";
 
   std::string Buf;
-  raw_string_ostream OS(Buf);
-  logAllUnhandledErrors(std::move(E), OS);
-  OS.flush();
-  errs() << ": " << Buf << "\n";
+  raw_string_ostream BufOS(Buf);
+  logAllUnhandledErrors(std::move(E), BufOS);
+  BufOS.flush();
+  OS << ": " << Buf << "\n";
 }
 
 // This version of error() prints the file name and which architecture slice it
@@ -204,16 +215,17 @@ static void error(llvm::Error E, StringRef FileName, const Archive::Child &C,
 static void error(llvm::Error E, StringRef FileName,
                   StringRef ArchitectureName = StringRef()) {
   HadError = true;
-  WithColor::error(errs(), ToolName) << FileName;
+  raw_ostream &OS = diagStream();
+  WithColor::error(OS, ToolName) << FileName;
 
   if (!ArchitectureName.empty())
-    errs() << " (for architecture " << ArchitectureName << ")";
+    OS << " (for architecture " << ArchitectureName << ")";
 
   std::string Buf;
-  raw_string_ostream OS(Buf);
-  logAllUnhandledErrors(std::move(E), OS);
-  OS.flush();
-  errs() << ": " << Buf << "\n";
+  raw_string_ostream BufOS(Buf);
+  logAllUnhandledErrors(std::move(E), BufOS);
+  BufOS.flush();
+  OS << ": " << Buf << "\n";
 }
 
 namespace {
@@ -1802,7 +1814,7 @@ static bool getSymbolNamesFromObject(SymbolicFile &Obj,
               E->readDynsymVersions())
         SymbolVersions = std::move(*VersionsOrErr);
       else
-        WithColor::warning(errs(), ToolName)
+        WithColor::warning(diagStream(), ToolName)
             << "unable to read symbol versions: "
             << toString(VersionsOrErr.takeError()) << "\n";
     }
@@ -1925,6 +1937,23 @@ static Expected<bool> hasSymbols(SymbolicFile &Obj) {
   return !Obj.symbols().empty();
 }
 
+/// Print the symbols read from \p Obj by getSymbolNamesFromObject, once they
+/// have been sorted.
+static void printSortedSymbolList(SymbolicFile &Obj,
+                                  std::vector<NMSymbol> &SymbolList,
+                                  bool PrintSymbolObject, StringRef ArchiveName,
+                                  StringRef ArchitectureName) {
+  // If there is an error in hasSymbols(), the error should be encountered in
+  // function getSymbolNamesFromObject first.
+  if (!cantFail(hasSymbols(Obj)) && SymbolList.empty() && !Quiet) {
+    writeFileName(errs(), ArchiveName, ArchitectureName);
+    errs() << "no symbols\n";
+  }
+
+  printSymbolList(Obj, SymbolList, PrintSymbolObject, ArchiveName,
+                  ArchitectureName);
+}
+
 static void printSymbolNamesFromObject(
     SymbolicFile &Obj, std::vector<NMSymbol> &SymbolList,
     bool PrintSymbolObject, bool PrintObjectLabel, StringRef ArchiveName = {},
@@ -1938,16 +1967,9 @@ static void printSymbolNamesFromObject(
   if (!getSymbolNamesFromObject(Obj, SymbolList) || ExportSymbols)
     return;
 
-  // If there is an error in hasSymbols(), the error should be encountered in
-  // function getSymbolNamesFromObject first.
-  if (!cantFail(hasSymbols(Obj)) && SymbolList.empty() && !Quiet) {
-    writeFileName(errs(), ArchiveName, ArchitectureName);
-    errs() << "no symbols\n";
-  }
-
   sortSymbolList(SymbolList);
-  printSymbolList(Obj, SymbolList, PrintSymbolObject, ArchiveName,
-                  ArchitectureName);
+  printSortedSymbolList(Obj, SymbolList, PrintSymbolObject, ArchiveName,
+                        ArchitectureName);
 }
 
 static void dumpSymbolsNameFromMachOFilesetEntry(
@@ -2080,11 +2102,118 @@ static void dumpArchiveMap(Archive *A, StringRef Filename) {
   }
 }
 
+namespace {
+/// An archive member whose symbols may be read on another thread.
+struct ArchiveMemberSymbols {
+  std::unique_ptr<Binary> Bin;
+  /// Whether the symbols of the member are read by readMemberSymbols.
+  bool ReadInParallel = false;
+  /// Whether getSymbolNamesFromObject succeeded.
+  bool Succeeded = false;
+  /// Whether checkMachOAndArchFlags rejected the member.
+  bool RejectedArch = false;
+  std::vector<NMSymbol> SymbolList;
+  /// The diagnostics reported while reading the member and its symbols.
+  std::string Diags;
+};
+} // anonymous namespace
+
+/// Returns true if the symbols of \p Obj can be read by
+/// getSymbolNamesFromObject on another thread, and printed afterwards by
+/// printSortedSymbolList.
+static bool canReadSymbolsInParallel(SymbolicFile &Obj) {
+  // IR files share the LLVMContext, and Mach-O file sets print the symbols of
+  // each entry as they are read.
+  if (isa<IRObjectFile>(Obj))
+    return false;
+  if (auto *MachO = dyn_cast<MachOObjectFile>(&Obj))
+    return !MachO->is64Bit() ||
+           MachO->getHeader64().filetype != MachO::MH_FILESET;
+  return true;
+}
+
+static void dumpArchiveInParallel(Archive *A, StringRef Filename,
+                                  LLVMContext *ContextPtr) {
+  // Open the members on this thread, as bitcode members share the context.
+  std::vector<ArchiveMemberSymbols> Members;
+  Error Err = Error::success();
+  for (auto &C : A->children(Err)) {
+    ArchiveMemberSymbols &M = Members.emplace_back();
+    raw_string_ostream DiagOS(M.Diags);
+    DiagStream = &DiagOS;
+    Expected<std::unique_ptr<Binary>> ChildOrErr = C.getAsBinary(ContextPtr);
+    if (!ChildOrErr) {
+      if (auto E = isNotObjectErrorInvalidFileType(ChildOrErr.takeError()))
+        error(std::move(E), Filename, C);
+    } else {
+      M.Bin = std::move(*ChildOrErr);
+      if (SymbolicFile *O = dyn_cast<SymbolicFile>(M.Bin.get())) {
+        M.RejectedArch = !checkMachOAndArchFlags(O, Filename);
+        M.ReadInParallel =
+            !M.RejectedArch && shouldDump(*O) && canReadSymbolsInParallel(*O);
+      }
+    }
+    DiagStream = nullptr;
+    if (M.RejectedArch)
+      break;
+  }
+
+  parallelForEach(Members, [](ArchiveMemberSymbols &M) {
+    if (!M.ReadInParallel)
+      return;
+    SymbolicFile &O = cast<SymbolicFile>(*M.Bin);
+    raw_string_ostream DiagOS(M.Diags);
+    DiagStream = &DiagOS;
+    M.Succeeded = getSymbolNamesFromObject(O, M.SymbolList);
+    if (M.Succeeded)
+      sortSymbolList(M.SymbolList);
+    DiagStream = nullptr;
+  });
+
+  // Print the members in order, as dumpArchive does.
+  for (ArchiveMemberSymbols &M : Members) {
+    SymbolicFile *O = dyn_cast_or_null<SymbolicFile>(M.Bin.get());
+    if (O && !MachOPrintSizeWarning && PrintSize && isa<MachOObjectFile>(O)) {
+      WithColor::warning(errs(), ToolName)
+          << "sizes with -print-size for Mach-O files are always zero.\n";
+      MachOPrintSizeWarning = true;
+    }
+    if (!M.ReadInParallel) {
+      errs() << M.Diags;
+      if (M.RejectedArch)
+        return;
+      if (O) {
+        std::vector<NMSymbol> SymbolList;
+        dumpSymbolNamesFromObject(*O, SymbolList, /*PrintSymbolObject=*/false,
+                                  !PrintFileName, Filename,
+                                  /*ArchitectureName=*/{}, O->getFileName(),
+                                  /*PrintArchiveName=*/false);
+      }
+      continue;
+    }
+
+    CurrentFilename = O->getFileName();
+    if (!PrintFileName)
+      printObjectLabel(/*PrintArchiveName=*/false, Filename,
+                       /*ArchitectureName=*/{}, O->getFileName());
+    outs().flush();
+    errs() << M.Diags;
+    if (M.Succeeded)
+      printSortedSymbolList(*O, M.SymbolList, /*PrintSymbolObject=*/false,
+                            Filename, /*ArchitectureName=*/{});
+  }
+  if (Err)
+    error(std::move(Err), A->getFileName());
+}
+
 static void dumpArchive(Archive *A, std::vector<NMSymbol> &SymbolList,
                         StringRef Filename, LLVMContext *ContextPtr) {
   if (ArchiveMap)
     dumpArchiveMap(A, Filename);
 
+  if (Threads != 1 && !ExportSymbols)
+    return dumpArchiveInParallel(A, Filename, ContextPtr);
+
   Error Err = Error::success();
   for (auto &C : A->children(Err)) {
     Expected<std::unique_ptr<Binary>> ChildOrErr = C.getAsBinary(ContextPtr);
@@ -2476,6 +2605,12 @@ int llvm_nm_main(int argc, char **argv, const llvm::ToolContext &) {
   SpecialSyms = Args.hasArg(OPT_special_syms);
   UndefinedOnly = Args.hasArg(OPT_undefined_only);
   WithoutAliases = Args.hasArg(OPT_without_aliases);
+  if (Arg *A = Args.getLastArg(OPT_threads_EQ)) {
+    StringRef V = A->getValue();
+    if (V.getAsInteger(10, Threads))
+      error("--threads value should be a non-negative integer");
+  }
+  parallel::strategy = hardware_concurrency(Threads);
 
   // Get BitMode from enviornment variable "OBJECT_MODE" for AIX OS, if
   // specified.
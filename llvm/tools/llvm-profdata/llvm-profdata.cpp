@@ -294,6 +294,13 @@ cl::opt<unsigned> NumThreads(
     cl::desc("Number of merge threads to use (default: autodetect)"));
 cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
                       cl::aliasopt(NumThreads));
+cl::opt<bool> ShardedMerge(
+    "sharded-merge", cl::init(false), cl::sub(MergeSubcommand),
+    cl::desc("When merging with multiple threads, merge the records of all "
+             "inputs into one function table split into shards by function "
+             "name, instead of into one table per thread. Every function is "
+             "then held in memory once, which bounds the memory used to merge "
+             "many profiles (only meaningful for -instr)"));
 
 cl::opt<std::string> ProfileSymbolListFile(
     "prof-sym-list", cl::init(""), cl::sub(MergeSubcommand),
@@ -682,12 +689,15 @@ static void overlapInput(const std::string &BaseFilename,
   }
 }
 
-/// Load an input into a writer context.
+/// Load an input into a writer context. If \p RecordShards isn't empty, the
+/// instrumentation records are added to the shard of their function name
+/// instead of to \p WC.
 static void
 loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
           const InstrProfCorrelator *Correlator, const StringRef ProfiledBinary,
           WriterContext *WC, const object::BuildIDFetcher *BIDFetcher = nullptr,
-          const ProfCorrelatorKind *BIDFetcherCorrelatorKind = nullptr) {
+          const ProfCorrelatorKind *BIDFetcherCorrelatorKind = nullptr,
+          ArrayRef<std::unique_ptr<WriterContext>> RecordShards = {}) {
   std::unique_lock<std::mutex> CtxGuard{WC->Lock};
 
   // Copy the filename, because llvm::ThreadPool copied the input "const
@@ -806,8 +816,16 @@ loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
     if (Remapper)
       I.Name = (*Remapper)(I.Name);
     const StringRef FuncName = I.Name;
+    InstrProfWriter *Writer = &WC->Writer;
+    std::unique_lock<std::mutex> ShardGuard;
+    if (!RecordShards.empty()) {
+      WriterContext *Shard =
+          RecordShards[hash_value(FuncName) % RecordShards.size()].get();
+      ShardGuard = std::unique_lock<std::mutex>(Shard->Lock);
+      Writer = &Shard->Writer;
+    }
     bool Reported = false;
-    WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
+    Writer->addRecord(std::move(I), Input.Weight, [&](Error E) {
       if (Reported) {
         consumeError(std::move(E));
         return;
@@ -856,6 +874,17 @@ loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
   }
 }
 
+/// Move the records of the \p Src writer context into \p Dst.
+static void mergeWriterRecords(WriterContext *Dst, WriterContext *Src) {
+  Dst->Writer.mergeRecordsFromWriter(std::move(Src->Writer), [&](Error E) {
+    auto [ErrorCode, Msg] = InstrProfError::take(std::move(E));
+    std::unique_lock<std::mutex> ErrGuard{Dst->ErrLock};
+    bool firstTime = Dst->WriterErrorCodes.insert(ErrorCode).second;
+    if (firstTime)
+      warn(toString(make_error<InstrProfError>(ErrorCode, Msg)));
+  });
+}
+
 /// Merge the \p Src writer context into \p Dst.
 static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
   for (auto &ErrorPair : Src->Errors)
@@ -865,13 +894,7 @@ static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
   if (Error E = Dst->Writer.mergeProfileKind(Src->Writer.getProfileKind()))
     exitWithError(std::move(E));
 
-  Dst->Writer.mergeRecordsFromWriter(std::move(Src->Writer), [&](Error E) {
-    auto [ErrorCode, Msg] = InstrProfError::take(std::move(E));
-    std::unique_lock<std::mutex> ErrGuard{Dst->ErrLock};
-    bool firstTime = Dst->WriterErrorCodes.insert(ErrorCode).second;
-    if (firstTime)
-      warn(toString(make_error<InstrProfError>(ErrorCode, Msg)));
-  });
+  mergeWriterRecords(Dst, Src);
 }
 
 static StringRef
@@ -1034,16 +1057,33 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
   } else {
     DefaultThreadPool Pool(hardware_concurrency(NumThreads));
 
+    // With -sharded-merge, the records of every input are added to the shard
+    // of their function name, so that the per-thread contexts only keep the
+    // rest of the profile data. Use more shards than threads to keep the
+    // contention on the shard locks low.
+    SmallVector<std::unique_ptr<WriterContext>, 0> RecordShards;
+    if (ShardedMerge)
+      for (unsigned I = 0; I < 4 * NumThreads; ++I)
+        RecordShards.emplace_back(std::make_unique<WriterContext>(
+            OutputSparse, ErrorLock, WriterErrorCodes));
+
     // Load the inputs in parallel (N/NumThreads serial steps).
     unsigned Ctx = 0;
     for (const auto &Input : Inputs) {
       Pool.async(loadInput, Input, Remapper, Correlator.get(), ProfiledBinary,
                  Contexts[Ctx].get(), BIDFetcher.get(),
-                 &BIDFetcherCorrelateKind);
+                 &BIDFetcherCorrelateKind, ArrayRef(RecordShards));
       Ctx = (Ctx + 1) % NumThreads;
     }
     Pool.wait();
 
+    // The shards hold disjoint sets of functions, so merging them only moves
+    // the records. Release every shard once it is merged.
+    for (std::unique_ptr<WriterContext> &Shard : RecordShards) {
+      mergeWriterRecords(Contexts[0].get(), Shard.get());
+      Shard.reset();
+    }
+
     // Merge the writer contexts together (~ lg(NumThreads) serial steps).
     unsigned Mid = Contexts.size() / 2;
     unsigned End = Contexts.size();
@@ -11,6 +11,8 @@
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 
 #define DEBUG_TYPE "perf-reader"
@@ -42,6 +44,11 @@ static cl::opt<bool>
 cl::opt<bool> ShowDetailedWarning("show-detailed-warning",
                                   cl::desc("Show detailed warning message."));
 
+static cl::opt<unsigned> NumUnwindThreads(
+    "unwind-threads", cl::init(0),
+    cl::desc("Number of threads to use for unwinding hybrid samples of a "
+             "binary with pseudo probes (default: all hardware threads)."));
+
 extern cl::opt<std::string> PerfTraceFilename;
 extern cl::opt<bool> ShowDisassemblyOnly;
 extern cl::opt<bool> ShowSourceLocations;
@@ -515,11 +522,75 @@ static std::string getContextKeyStr(ContextKey *K,
   }
 }
 
+void VirtualUnwinder::mergeStats(const VirtualUnwinder &Other) {
+  NumTotalBranches += Other.NumTotalBranches;
+  NumExtCallBranch += Other.NumExtCallBranch;
+  NumMissingExternalFrame += Other.NumMissingExternalFrame;
+  NumMismatchedProEpiBranch += Other.NumMismatchedProEpiBranch;
+  NumMismatchedExtCallBranch += Other.NumMismatchedExtCallBranch;
+  NumUnpairedExtAddr += Other.NumUnpairedExtAddr;
+  NumPairedExtAddr += Other.NumPairedExtAddr;
+  UntrackedCallsites.insert(Other.UntrackedCallsites.begin(),
+                            Other.UntrackedCallsites.end());
+}
+
 void HybridPerfReader::unwindSamples() {
   VirtualUnwinder Unwinder(&SampleCounters, Binary);
-  for (const auto &Item : AggregatedSamples) {
-    const PerfSample *Sample = Item.first.getPtr();
-    Unwinder.unwind(Sample, Item.second);
+  ThreadPoolStrategy Strategy = hardware_concurrency(NumUnwindThreads);
+  unsigned NumThreads = Strategy.compute_thread_count();
+  // Without pseudo probes, building the context keys symbolizes addresses
+  // through the lazily populated caches of the binary, which aren't thread
+  // safe.
+  if (!Binary->usePseudoProbes() || NumThreads <= 1 ||
+      AggregatedSamples.size() < 2 * NumThreads) {
+    for (const auto &Item : AggregatedSamples) {
+      const PerfSample *Sample = Item.first.getPtr();
+      Unwinder.unwind(Sample, Item.second);
+    }
+  } else {
+    // Unwind chunks of the samples into counter maps of their own, then merge
+    // them in chunk order. Each sample adds to the counters independently, so
+    // the merged counters are the same as for a serial unwinding.
+    std::vector<std::pair<const PerfSample *, uint64_t>> Samples;
+    Samples.reserve(AggregatedSamples.size());
+    for (const auto &Item : AggregatedSamples)
+      Samples.emplace_back(Item.first.getPtr(), Item.second);
+
+    unsigned NumChunks = NumThreads * 4;
+    size_t ChunkSize = divideCeil(Samples.size(), NumChunks);
+    std::vector<ContextSampleCounterMap> ChunkCounters(NumChunks);
+    std::vector<VirtualUnwinder> ChunkUnwinders;
+    ChunkUnwinders.reserve(NumChunks);
+    for (ContextSampleCounterMap &Counters : ChunkCounters)
+      ChunkUnwinders.emplace_back(&Counters, Binary);
+
+    DefaultThreadPool Pool(Strategy);
+    for (unsigned I = 0; I < NumChunks; ++I) {
+      size_t Begin = std::min(I * ChunkSize, Samples.size());
+      size_t End = std::min(Begin + ChunkSize, Samples.size());
+      Pool.async([&, I, Begin, End]() {
+        for (size_t J = Begin; J < End; ++J)
+          ChunkUnwinders[I].unwind(Samples[J].first, Samples[J].second);
+      });
+    }
+    Pool.wait();
+
+    for (unsigned I = 0; I < NumChunks; ++I) {
+      for (auto &Item : ChunkCounters[I]) {
+        auto Ret = SampleCounters.try_emplace(Item.first);
+        if (Ret.second) {
+          Ret.first->second = std::move(Item.second);
+          continue;
+        }
+        SampleCounter &SCounter = Ret.first->second;
+        for (const auto &Range : Item.second.RangeCounter)
+          SCounter.RangeCounter[Range.first] += Range.second;
+        for (const auto &Branch : Item.second.BranchCounter)
+          SCounter.BranchCounter[Branch.first] += Branch.second;
+      }
+      ChunkCounters[I].clear();
+      Unwinder.mergeStats(ChunkUnwinders[I]);
+    }
   }
 
   // Warn about untracked frames due to missing probes.
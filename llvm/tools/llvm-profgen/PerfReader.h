@@ -477,6 +477,9 @@ public:
       : CtxCounterMap(Counter), Binary(B) {}
   bool unwind(const PerfSample *Sample, uint64_t Repeat);
   std::set<uint64_t> &getUntrackedCallsites() { return UntrackedCallsites; }
+  // Add the statistics and untracked call sites of \p Other, which unwound
+  // other samples of the same binary.
+  void mergeStats(const VirtualUnwinder &Other);
 
   uint64_t NumTotalBranches = 0;
   uint64_t NumExtCallBranch = 0;
@@ -0,0 +1,217 @@
+//===- RemarkSummary.cpp --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Aggregate the remarks of many files into a summary of the number of remarks
+// and of their hotness per pass and remark name, and optionally per function.
+//
+// The inputs are parsed in parallel, one remark at a time, so that the remarks
+// of a whole build can be summarized without holding them in memory.
+//
+//===----------------------------------------------------------------------===//
+
+#include "RemarkUtilHelpers.h"
+#include "RemarkUtilRegistry.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/ThreadPool.h"
+#include <algorithm>
+#include <mutex>
+
+using namespace llvm;
+using namespace remarks;
+using namespace llvm::remarkutil;
+
+static cl::SubCommand
+    Summary("summary", "Summarize the remarks of many files per pass, remark "
+                       "name and function");
+
+namespace summary {
+INPUT_FORMAT_COMMAND_LINE_OPTIONS(Summary)
+static cl::list<std::string> InputFileNames(cl::Positional, cl::OneOrMore,
+                                            cl::desc("<input files>"),
+                                            cl::sub(Summary));
+static cl::opt<std::string> OutputFileName("o", cl::init("-"),
+                                           cl::desc("Output"),
+                                           cl::value_desc("filename"),
+                                           cl::sub(Summary));
+static cl::opt<unsigned>
+    NumThreads("num-threads", cl::init(0),
+               cl::desc("Number of threads used to parse the inputs"),
+               cl::sub(Summary));
+static cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
+                             cl::aliasopt(NumThreads), cl::sub(Summary));
+static cl::opt<bool>
+    GroupByFunction("group-by-function", cl::init(false),
+                    cl::desc("Keep a separate entry for every function"),
+                    cl::sub(Summary));
+enum class SortKey { Count, Hotness };
+static cl::opt<SortKey>
+    SortBy("sort", cl::desc("Order of the entries in the summary"),
+           cl::init(SortKey::Count),
+           cl::values(clEnumValN(SortKey::Count, "count",
+                                 "Most frequent entries first"),
+                      clEnumValN(SortKey::Hotness, "hotness",
+                                 "Hottest entries first")),
+           cl::sub(Summary));
+static cl::opt<unsigned>
+    Top("top", cl::init(0),
+        cl::desc("Only output the first N entries (0 outputs all of them)"),
+        cl::sub(Summary));
+static cl::opt<unsigned> Scale(
+    "scale", cl::init(1),
+    cl::desc("Multiply the counts and the hotness by N, e.g. to account for "
+             "remarks emitted with -remarks-sample-rate=N"),
+    cl::sub(Summary));
+
+/// The aggregated remarks of one entry of the summary.
+struct SummaryEntry {
+  uint64_t Count = 0;
+  uint64_t TotalHotness = 0;
+  uint64_t MaxHotness = 0;
+
+  void add(const Remark &R) {
+    ++Count;
+    if (R.Hotness) {
+      TotalHotness += *R.Hotness;
+      MaxHotness = std::max(MaxHotness, *R.Hotness);
+    }
+  }
+  void merge(const SummaryEntry &Other) {
+    Count += Other.Count;
+    TotalHotness += Other.TotalHotness;
+    MaxHotness = std::max(MaxHotness, Other.MaxHotness);
+  }
+};
+
+/// The entries are keyed by the type, pass, remark name and function of the
+/// remarks, separated by null characters. The parsed remarks point into the
+/// input buffers, so the key owns a copy of the strings.
+using SummaryMap = StringMap<SummaryEntry>;
+
+static std::string getKey(const Remark &R) {
+  std::string Key;
+  Key += typeToStr(R.RemarkType);
+  Key += '\0';
+  Key += R.PassName;
+  Key += '\0';
+  Key += R.RemarkName;
+  if (GroupByFunction) {
+    Key += '\0';
+    Key += R.FunctionName;
+  }
+  return Key;
+}
+
+/// Aggregate the remarks of \p InputFile into \p Result.
+static Error summarizeFile(StringRef InputFile, SummaryMap &Result) {
+  auto MaybeBuf = getInputMemoryBuffer(InputFile);
+  if (!MaybeBuf)
+    return MaybeBuf.takeError();
+  StringRef Buffer = (*MaybeBuf)->getBuffer();
+  Format InputFileFormat = InputFormat;
+  if (InputFileFormat == Format::Unknown) {
+    auto MaybeFormat = magicToFormat(Buffer);
+    if (!MaybeFormat)
+      return MaybeFormat.takeError();
+    InputFileFormat = *MaybeFormat;
+  }
+  auto MaybeParser = createRemarkParser(InputFileFormat, Buffer);
+  if (!MaybeParser)
+    return MaybeParser.takeError();
+  auto &Parser = **MaybeParser;
+  auto MaybeRemark = Parser.next();
+  for (; MaybeRemark; MaybeRemark = Parser.next())
+    Result[getKey(**MaybeRemark)].add(**MaybeRemark);
+  auto E = MaybeRemark.takeError();
+  if (!E.isA<EndOfFileError>())
+    return E;
+  consumeError(std::move(E));
+  return Error::success();
+}
+
+/// Outputs the summary of all the input files as a CSV.
+/// \returns Error::success() on success, and an Error otherwise.
+static Error trySummary() {
+  auto MaybeOF = getOutputFileWithFlags(OutputFileName,
+                                        /*Flags = */ sys::fs::OF_TextWithCRLF);
+  if (!MaybeOF)
+    return MaybeOF.takeError();
+  auto OF = std::move(*MaybeOF);
+
+  // Every input is summarized on its own and merged into the result the
+  // moment it is done, so only the keys of the summary stay in memory.
+  SummaryMap Result;
+  Error Err = Error::success();
+  std::mutex Lock;
+  auto SummarizeInput = [&](StringRef InputFile) {
+    SummaryMap FileResult;
+    Error E = summarizeFile(InputFile, FileResult);
+    std::lock_guard<std::mutex> Guard(Lock);
+    if (E) {
+      Err =
+          joinErrors(std::move(Err), createFileError(InputFile, std::move(E)));
+      return;
+    }
+    for (const auto &Entry : FileResult)
+      Result[Entry.getKey()].merge(Entry.getValue());
+  };
+
+  unsigned Threads = NumThreads;
+  if (Threads == 0)
+    Threads = std::min<size_t>(hardware_concurrency().compute_thread_count(),
+                               InputFileNames.size());
+  if (Threads <= 1) {
+    for (const std::string &InputFile : InputFileNames)
+      SummarizeInput(InputFile);
+  } else {
+    DefaultThreadPool Pool(hardware_concurrency(Threads));
+    for (const std::string &InputFile : InputFileNames)
+      Pool.async(SummarizeInput, StringRef(InputFile));
+    Pool.wait();
+  }
+  if (Err)
+    return Err;
+
+  // Sort the entries so that the output does not depend on the order in which
+  // the inputs were parsed.
+  std::vector<const SummaryMap::value_type *> Entries;
+  Entries.reserve(Result.size());
+  for (const auto &Entry : Result)
+    Entries.push_back(&Entry);
+  llvm::sort(Entries, [](const SummaryMap::value_type *LHS,
+                         const SummaryMap::value_type *RHS) {
+    const SummaryEntry &L = LHS->getValue();
+    const SummaryEntry &R = RHS->getValue();
+    if (SortBy == SortKey::Hotness && L.TotalHotness != R.TotalHotness)
+      return L.TotalHotness > R.TotalHotness;
+    if (L.Count != R.Count)
+      return L.Count > R.Count;
+    return LHS->getKey() < RHS->getKey();
+  });
+  if (Top && Entries.size() > Top)
+    Entries.resize(Top);
+
+  OF->os() << "Type,Pass,Remark,";
+  if (GroupByFunction)
+    OF->os() << "Function,";
+  OF->os() << "Count,TotalHotness,MaxHotness\n";
+  for (const SummaryMap::value_type *Entry : Entries) {
+    SmallVector<StringRef, 4> Fields;
+    Entry->getKey().split(Fields, '\0');
+    for (StringRef Field : Fields)
+      OF->os() << Field << ",";
+    const SummaryEntry &S = Entry->getValue();
+    OF->os() << S.Count * Scale << "," << S.TotalHotness * Scale << ","
+             << S.MaxHotness << "\n";
+  }
+  OF->keep();
+  return Error::success();
+}
+} // namespace summary
+
+static CommandRegistration SummaryReg(&Summary, summary::trySummary);
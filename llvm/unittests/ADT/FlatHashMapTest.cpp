@@ -0,0 +1,175 @@
+//===- llvm/unittest/ADT/FlatHashMapTest.cpp - FlatHashMap unit tests -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/FlatHashMap.h"
+#include "CountCopyAndMove.h"
+#include "llvm/ADT/CachedHashString.h"
+#include "llvm/ADT/StringRef.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <random>
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+TEST(FlatHashMapTest, EmptyMap) {
+  FlatHashMap<int, int> M;
+  EXPECT_TRUE(M.empty());
+  EXPECT_EQ(0u, M.size());
+  EXPECT_TRUE(M.begin() == M.end());
+  EXPECT_FALSE(M.contains(0));
+  EXPECT_EQ(0u, M.count(0));
+  EXPECT_TRUE(M.find(0) == M.end());
+  EXPECT_EQ(0, M.lookup(0));
+  EXPECT_FALSE(M.erase(0));
+  M.clear();
+  EXPECT_EQ(0u, M.getMemorySize());
+}
+
+TEST(FlatHashMapTest, InsertFindErase) {
+  FlatHashMap<int, int> M;
+  auto [It, Inserted] = M.insert({1, 10});
+  EXPECT_TRUE(Inserted);
+  EXPECT_EQ(1, It->first);
+  EXPECT_EQ(10, It->second);
+
+  std::tie(It, Inserted) = M.insert({1, 20});
+  EXPECT_FALSE(Inserted);
+  EXPECT_EQ(10, It->second);
+
+  EXPECT_EQ(1u, M.size());
+  EXPECT_TRUE(M.contains(1));
+  EXPECT_EQ(10, M.at(1));
+  EXPECT_EQ(10, M.lookup(1));
+  EXPECT_EQ(0, M.lookup(2));
+
+  M[2] = 30;
+  EXPECT_EQ(30, M.find(2)->second);
+  M.insert_or_assign(2, 40);
+  EXPECT_EQ(40, M[2]);
+  EXPECT_EQ(2u, M.size());
+
+  EXPECT_TRUE(M.erase(1));
+  EXPECT_FALSE(M.erase(1));
+  EXPECT_FALSE(M.contains(1));
+  M.erase(M.find(2));
+  EXPECT_TRUE(M.empty());
+}
+
+// The empty and tombstone keys of DenseMapInfo are ordinary keys.
+TEST(FlatHashMapTest, ReservedDenseMapKeys) {
+  FlatHashMap<unsigned, int> M;
+  M[DenseMapInfo<unsigned>::getEmptyKey()] = 1;
+  M[DenseMapInfo<unsigned>::getTombstoneKey()] = 2;
+  EXPECT_EQ(2u, M.size());
+  EXPECT_EQ(1, M.lookup(DenseMapInfo<unsigned>::getEmptyKey()));
+  EXPECT_EQ(2, M.lookup(DenseMapInfo<unsigned>::getTombstoneKey()));
+}
+
+// Compare against std::map under a random mix of insertions and erasures,
+// which exercises tombstones, rehashing in place and growing.
+TEST(FlatHashMapTest, RandomOperations) {
+  FlatHashMap<uint64_t, uint64_t> M;
+  std::map<uint64_t, uint64_t> Ref;
+  std::mt19937_64 Rng(0);
+  for (unsigned I = 0; I != 200000; ++I) {
+    uint64_t Key = Rng() % 5000;
+    if (Rng() % 3 == 0) {
+      EXPECT_EQ(Ref.erase(Key) != 0, M.erase(Key));
+    } else {
+      auto [It, Inserted] = M.try_emplace(Key, I);
+      EXPECT_EQ(Ref.try_emplace(Key, I).second, Inserted);
+      EXPECT_EQ(Ref[Key], It->second);
+    }
+    ASSERT_EQ(Ref.size(), M.size());
+  }
+
+  for (const auto &[Key, Value] : Ref)
+    EXPECT_EQ(Value, M.lookup(Key));
+  std::map<uint64_t, uint64_t> Iterated;
+  for (const auto &[Key, Value] : M)
+    EXPECT_TRUE(Iterated.try_emplace(Key, Value).second);
+  EXPECT_EQ(Ref, Iterated);
+}
+
+// Keys that only differ in their high bits collide in DenseMapInfo's hash of
+// the low bits unless the hash is mixed.
+TEST(FlatHashMapTest, PointerKeys) {
+  static int Array[4096];
+  FlatHashMap<int *, unsigned> M;
+  for (unsigned I = 0; I != 4096; ++I)
+    M[&Array[I]] = I;
+  for (unsigned I = 0; I != 4096; ++I)
+    EXPECT_EQ(I, M.lookup(&Array[I]));
+  EXPECT_EQ(4096u, M.size());
+}
+
+TEST(FlatHashMapTest, ReserveAvoidsRehash) {
+  FlatHashMap<unsigned, unsigned> M;
+  M.reserve(1000);
+  size_t MemorySize = M.getMemorySize();
+  for (unsigned I = 0; I != 1000; ++I)
+    M[I] = I;
+  EXPECT_EQ(MemorySize, M.getMemorySize());
+
+  M.clear();
+  EXPECT_TRUE(M.empty());
+  EXPECT_TRUE(M.begin() == M.end());
+  EXPECT_EQ(MemorySize, M.getMemorySize());
+}
+
+TEST(FlatHashMapTest, CopyAndMove) {
+  FlatHashMap<unsigned, std::string> M;
+  for (unsigned I = 0; I != 100; ++I)
+    M[I] = std::to_string(I);
+
+  FlatHashMap<unsigned, std::string> Copy(M);
+  EXPECT_EQ(100u, Copy.size());
+  EXPECT_EQ("42", Copy.lookup(42));
+
+  FlatHashMap<unsigned, std::string> Moved(std::move(Copy));
+  EXPECT_EQ(100u, Moved.size());
+  EXPECT_EQ("99", Moved.lookup(99));
+
+  Copy = Moved;
+  EXPECT_EQ(100u, Copy.size());
+  Moved = FlatHashMap<unsigned, std::string>();
+  EXPECT_TRUE(Moved.empty());
+  EXPECT_EQ("7", Copy.lookup(7));
+}
+
+TEST(FlatHashMapTest, ConstructionsAndDestructions) {
+  CountCopyAndMove::ResetCounts();
+  {
+    FlatHashMap<int, CountCopyAndMove> M;
+    for (int I = 0; I != 1000; ++I)
+      M.try_emplace(I, I);
+    for (int I = 0; I != 1000; I += 2)
+      M.erase(I);
+    EXPECT_EQ(1000, CountCopyAndMove::ValueConstructions);
+    EXPECT_EQ(0, CountCopyAndMove::TotalCopies());
+  }
+  EXPECT_EQ(CountCopyAndMove::TotalConstructions(),
+            CountCopyAndMove::Destructions);
+}
+
+TEST(FlatHashMapTest, CachedHashStringRefKeys) {
+  FlatHashMap<CachedHashStringRef, int> M;
+  std::vector<std::string> Names;
+  for (int I = 0; I != 1000; ++I)
+    Names.push_back("symbol" + std::to_string(I));
+  for (int I = 0; I != 1000; ++I)
+    M[CachedHashStringRef(Names[I])] = I;
+  for (int I = 0; I != 1000; ++I)
+    EXPECT_EQ(I, M.lookup(CachedHashStringRef(Names[I])));
+  EXPECT_FALSE(M.contains(CachedHashStringRef("symbol1000")));
+}
+
+} // namespace
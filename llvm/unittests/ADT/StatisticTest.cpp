@@ -9,6 +9,9 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
+#if LLVM_ENABLE_THREADS
+#include <thread>
+#endif
 using namespace llvm;
 
 using OptionalStatistic = std::optional<std::pair<StringRef, uint64_t>>;
@@ -18,6 +21,7 @@ namespace {
 STATISTIC(Counter, "Counts things");
 STATISTIC(Counter2, "Counts other things");
 ALWAYS_ENABLED_STATISTIC(AlwaysCounter, "Counts things always");
+ALWAYS_ENABLED_STATISTIC(ThreadCounter, "Counts things on many threads");
 
 #if LLVM_ENABLE_STATS
 static void
@@ -67,6 +71,35 @@ TEST(StatisticTest, Assign) {
   EXPECT_EQ(AlwaysCounter, 2u);
 }
 
+#if LLVM_ENABLE_THREADS
+TEST(StatisticTest, Threads) {
+  EnableStatistics();
+
+  // The counts of every thread are kept after it exits, and assignment
+  // overrides them.
+  ThreadCounter = 5;
+  std::vector<std::thread> Threads;
+  for (unsigned I = 0; I != 4; ++I)
+    Threads.emplace_back([] {
+      for (unsigned J = 0; J != 1000; ++J) {
+        ++ThreadCounter;
+        ThreadCounter += 2;
+        ThreadCounter--;
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+  EXPECT_EQ(ThreadCounter, 5u + 4 * 2000);
+
+  // New threads reuse the shards of the exited ones.
+  std::thread([] { ThreadCounter -= 8000; }).join();
+  EXPECT_EQ(ThreadCounter, 5u);
+  ThreadCounter = 0;
+  std::thread([] { ++ThreadCounter; }).join();
+  EXPECT_EQ(ThreadCounter, 1u);
+}
+#endif
+
 TEST(StatisticTest, API) {
   EnableStatistics();
   // Reset beforehand to make sure previous tests don't effect this one.
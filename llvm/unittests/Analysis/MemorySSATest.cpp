@@ -512,6 +512,44 @@ TEST_F(MemorySSATest, RemoveAPhi) {
   MSSA.verifyMemorySSA();
 }
 
+TEST_F(MemorySSATest, RemoveMemoryAccessesBatch) {
+  // We create a diamond with a store on each side and a load after the merge
+  // point. Removing both stores at once should leave a trivial phi, which is
+  // removed at the end of the batch.
+  F = Function::Create(FunctionType::get(B.getVoidTy(), {B.getPtrTy()}, false),
+                       GlobalValue::ExternalLinkage, "F", &M);
+  BasicBlock *Entry(BasicBlock::Create(C, "", F));
+  BasicBlock *Left(BasicBlock::Create(C, "", F));
+  BasicBlock *Right(BasicBlock::Create(C, "", F));
+  BasicBlock *Merge(BasicBlock::Create(C, "", F));
+  B.SetInsertPoint(Entry);
+  B.CreateCondBr(B.getTrue(), Left, Right);
+  B.SetInsertPoint(Left);
+  Argument *PointerArg = &*F->arg_begin();
+  StoreInst *LeftStore = B.CreateStore(B.getInt8(16), PointerArg);
+  BranchInst::Create(Merge, Left);
+  B.SetInsertPoint(Right);
+  StoreInst *RightStore = B.CreateStore(B.getInt8(32), PointerArg);
+  BranchInst::Create(Merge, Right);
+  B.SetInsertPoint(Merge);
+  LoadInst *LoadInst = B.CreateLoad(B.getInt8Ty(), PointerArg);
+
+  setupAnalyses();
+  MemorySSA &MSSA = *Analyses->MSSA;
+  MemorySSAUpdater Updater(&MSSA);
+
+  MemoryUse *LoadAccess = cast<MemoryUse>(MSSA.getMemoryAccess(LoadInst));
+  EXPECT_TRUE(isa<MemoryPhi>(LoadAccess->getDefiningAccess()));
+  Updater.removeMemoryAccesses({MSSA.getMemoryAccess(LeftStore),
+                                MSSA.getMemoryAccess(RightStore)},
+                               /*OptimizePhis=*/true);
+  LeftStore->eraseFromParent();
+  RightStore->eraseFromParent();
+  MSSA.verifyMemorySSA();
+  EXPECT_EQ(MSSA.getMemoryAccess(Merge), nullptr);
+  EXPECT_TRUE(MSSA.isLiveOnEntryDef(LoadAccess->getDefiningAccess()));
+}
+
 TEST_F(MemorySSATest, RemoveMemoryAccess) {
   // We create a diamond where there is a store on one side, and then a load
   // after the merge point.  This enables us to test a bunch of different
@@ -9,6 +9,9 @@
 #include "llvm/DebugInfo/CodeView/TypeHashing.h"
 #include "llvm/DebugInfo/CodeView/AppendingTypeTableBuilder.h"
 #include "llvm/DebugInfo/CodeView/TypeRecord.h"
+#include "llvm/Support/BinaryByteStream.h"
+#include "llvm/Support/BinaryStreamReader.h"
+#include "llvm/Testing/Support/Error.h"
 
 #include "gtest/gtest.h"
 
@@ -154,3 +157,38 @@ TEST(TypeHashingTest, ContentHash) {
   EXPECT_EQ(hash_of(Hashes1, Args[0]), hash_of(Hashes2, Args[1]));
   EXPECT_EQ(hash_of(Hashes1, Proc[0]), hash_of(Hashes2, Proc[1]));
 }
+
+TEST(TypeHashingTest, HashTypeStreams) {
+  TypeIndex IntP(SimpleTypeKind::Int32, SimpleTypeMode::NearPointer);
+  TypeIndex CharP(SimpleTypeKind::SignedCharacter, SimpleTypeMode::NearPointer);
+
+  BumpPtrAllocator Alloc;
+  AppendingTypeTableBuilder Builder1(Alloc);
+  AppendingTypeTableBuilder Builder2(Alloc);
+  TypeIndex IntPP = createPointerRecord(Builder1, IntP);
+  TypeIndex IntPPP = createPointerRecord(Builder1, IntPP);
+  TypeIndex Args = createArgListRecord(Builder1, IntPP, IntPPP);
+  createProcedureRecord(Builder1, 2, IntPP, Args);
+  TypeIndex CharPP = createPointerRecord(Builder2, CharP);
+  createArgListRecord(Builder2, CharPP, CharPP);
+  AppendingTypeTableBuilder *Builders[] = {&Builder1, &Builder2};
+
+  std::vector<uint8_t> Data[2];
+  CVTypeArray Streams[2];
+  for (unsigned I = 0; I != 2; ++I) {
+    for (ArrayRef<uint8_t> Record : Builders[I]->records())
+      llvm::append_range(Data[I], Record);
+    BinaryStreamReader Reader(Data[I], llvm::endianness::little);
+    ASSERT_THAT_ERROR(Reader.readArray(Streams[I], Data[I].size()),
+                      Succeeded());
+  }
+
+  auto Hashes = GloballyHashedType::hashTypeStreams(Streams);
+  ASSERT_EQ(2U, Hashes.size());
+  for (unsigned I = 0; I != 2; ++I) {
+    auto Serial = GloballyHashedType::hashTypes(Builders[I]->records());
+    ASSERT_EQ(Serial.size(), Hashes[I].size());
+    for (size_t J = 0; J != Serial.size(); ++J)
+      EXPECT_EQ(Serial[J].Hash, Hashes[I][J].Hash);
+  }
+}
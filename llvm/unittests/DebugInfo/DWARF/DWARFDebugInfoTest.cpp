@@ -2276,4 +2276,81 @@ TEST(DWARFDebugInfo, TestDWARF64UnitLength) {
   });
 }
 
+TEST(DWARFDebugInfo, TestAddressIndexRoundTrip) {
+  // Two compile units without .debug_aranges, so that the address map has to
+  // be built from their unit DIEs.
+  const char *yamldata = R"(
+    debug_abbrev:
+      - Table:
+          - Code:            0x00000001
+            Tag:             DW_TAG_compile_unit
+            Children:        DW_CHILDREN_no
+            Attributes:
+              - Attribute:       DW_AT_low_pc
+                Form:            DW_FORM_addr
+              - Attribute:       DW_AT_high_pc
+                Form:            DW_FORM_data4
+    debug_info:
+      - Version:         4
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x1000
+              - Value:           0x100
+      - Version:         4
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x2000
+              - Value:           0x80
+  )";
+  auto Sections = DWARFYAML::emitDebugSections(StringRef(yamldata));
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+  std::unique_ptr<DWARFContext> Ctx = DWARFContext::create(*Sections, 8);
+  ASSERT_EQ(2u, Ctx->getNumCompileUnits());
+  uint64_t SecondCUOffset = Ctx->getUnitAtIndex(1)->getOffset();
+
+  std::string Index;
+  raw_string_ostream OS(Index);
+  Ctx->saveAddressIndex(OS);
+
+  std::unique_ptr<DWARFContext> Loaded = DWARFContext::create(*Sections, 8);
+  ASSERT_THAT_ERROR(Loaded->loadAddressIndex(Index), Succeeded());
+  DWARFCompileUnit *CU = Loaded->getCompileUnitForCodeAddress(0x1010);
+  ASSERT_NE(nullptr, CU);
+  EXPECT_EQ(0u, CU->getOffset());
+  CU = Loaded->getCompileUnitForCodeAddress(0x207f);
+  ASSERT_NE(nullptr, CU);
+  EXPECT_EQ(SecondCUOffset, CU->getOffset());
+  EXPECT_EQ(nullptr, Loaded->getCompileUnitForCodeAddress(0x2080));
+
+  EXPECT_THAT_ERROR(Loaded->loadAddressIndex("garbage"), Failed());
+  EXPECT_THAT_ERROR(Loaded->loadAddressIndex(StringRef(Index).drop_back()),
+                    Failed());
+
+  // An index of other DWARF is rejected.
+  auto OtherSections = DWARFYAML::emitDebugSections(StringRef(R"(
+    debug_abbrev:
+      - Table:
+          - Code:            0x00000001
+            Tag:             DW_TAG_compile_unit
+            Children:        DW_CHILDREN_no
+            Attributes:
+              - Attribute:       DW_AT_low_pc
+                Form:            DW_FORM_addr
+    debug_info:
+      - Version:         4
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x1000
+  )"));
+  ASSERT_THAT_EXPECTED(OtherSections, Succeeded());
+  std::unique_ptr<DWARFContext> Other = DWARFContext::create(*OtherSections, 8);
+  EXPECT_THAT_ERROR(Other->loadAddressIndex(Index), Failed());
+}
+
 } // end anonymous namespace
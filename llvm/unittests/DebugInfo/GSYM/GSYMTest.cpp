@@ -4899,3 +4899,53 @@ TEST(GSYMTest, TestLookupsOfOverlappingAndUnequalRanges) {
   for (const auto &Line : ExpectedDumpLines)
     EXPECT_TRUE(DumpStr.find(Line) != std::string::npos);
 }
+
+TEST(GSYMTest, TestGsymCreatorParallelFinalizeAndEncode) {
+  // Make sure that sorting the function infos in finalize and encoding them
+  // with multiple threads produces the same GSYM file as with a single thread.
+  // Use enough function infos to need several batches of encoded functions.
+  constexpr uint64_t BaseAddr = 0x1000;
+  constexpr size_t NumFuncs = 10000;
+  auto Create = [&](unsigned NumThreads) -> Expected<std::string> {
+    GsymCreator GC;
+    GC.setNumThreads(NumThreads);
+    // Add the function infos in reverse order, with a symbol table entry for
+    // the same range as some of them that must be removed by finalize.
+    for (size_t I = NumFuncs; I-- > 0;) {
+      const uint64_t FuncAddr = BaseAddr + I * 0x40;
+      const std::string Name = "func" + std::to_string(I);
+      AddFunctionInfo(GC, Name.c_str(), FuncAddr, "/tmp/main.cpp",
+                      "/tmp/foo.h");
+      if (I % 3 == 0)
+        GC.addFunctionInfo(
+            FunctionInfo(FuncAddr, 0x30, GC.insertString(Name)));
+    }
+    OutputAggregator Null(nullptr);
+    if (Error Err = GC.finalize(Null))
+      return std::move(Err);
+    EXPECT_EQ(GC.getNumFunctionInfos(), NumFuncs);
+    SmallString<1024> Str;
+    raw_svector_ostream OutStrm(Str);
+    FileWriter FW(OutStrm, llvm::endianness::little);
+    if (Error Err = GC.encode(FW))
+      return std::move(Err);
+    return std::string(Str);
+  };
+
+  Expected<std::string> Serial = Create(1);
+  ASSERT_THAT_EXPECTED(Serial, Succeeded());
+  Expected<std::string> Parallel = Create(4);
+  ASSERT_THAT_EXPECTED(Parallel, Succeeded());
+  EXPECT_EQ(*Serial, *Parallel);
+
+  Expected<GsymReader> GR = GsymReader::copyBuffer(*Parallel);
+  ASSERT_THAT_EXPECTED(GR, Succeeded());
+  EXPECT_EQ(GR->getNumAddresses(), NumFuncs);
+  for (size_t I : {size_t(0), NumFuncs / 2, NumFuncs - 1}) {
+    auto ExpFI = GR->getFunctionInfo(BaseAddr + I * 0x40);
+    ASSERT_THAT_EXPECTED(ExpFI, Succeeded());
+    EXPECT_EQ(GR->getString(ExpFI->Name), "func" + std::to_string(I));
+    EXPECT_TRUE(ExpFI->OptLineTable.has_value());
+    EXPECT_TRUE(ExpFI->Inline.has_value());
+  }
+}
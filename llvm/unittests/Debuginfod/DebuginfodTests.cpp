@@ -67,3 +67,55 @@ TEST(DebuginfodClient, CacheMiss) {
   // A cache miss with no possible URLs should not create the cache directory.
   EXPECT_FALSE(sys::fs::exists(CacheDir));
 }
+
+// Check that the Debuginfod client doesn't query the servers again for an
+// artifact that none of them had recently.
+TEST(DebuginfodClient, CacheMissIsCached) {
+  SmallString<32> CacheDir;
+  ASSERT_NO_ERROR(
+      sys::fs::createUniqueDirectory("debuginfod-unittest", CacheDir));
+  setenv("DEBUGINFOD_CACHE_MISS_TIMEOUT", "600", /*replace=*/1);
+  StringRef ServerUrl = "http://debuginfod.invalid";
+  SmallString<64> CacheMissPath(CacheDir);
+  sys::path::append(CacheMissPath, "llvmcache-missing-key.miss");
+  {
+    std::error_code EC;
+    raw_fd_ostream OS(CacheMissPath, EC);
+    ASSERT_NO_ERROR(EC);
+    OS << ServerUrl << "\n";
+  }
+  // Without the negative cache, this would fail because the server can't be
+  // reached or because there is no HTTP client.
+  Expected<std::string> PathOrErr = getCachedOrDownloadArtifact(
+      /*UniqueKey=*/"missing-key", /*UrlPath=*/"/null", CacheDir,
+      /*DebuginfodUrls=*/{ServerUrl}, /*Timeout=*/std::chrono::milliseconds(1));
+  EXPECT_THAT_EXPECTED(PathOrErr, FailedWithMessage("build id not found"));
+}
+
+// Check that a batch of debug binaries is found in the local cache, in the
+// order of the requested build IDs.
+TEST(DebuginfodClient, CacheHitBatch) {
+  SmallString<32> CacheDir;
+  ASSERT_NO_ERROR(
+      sys::fs::createUniqueDirectory("debuginfod-unittest", CacheDir));
+  setenv("DEBUGINFOD_CACHE_PATH", CacheDir.c_str(), /*replace=*/1);
+  std::vector<object::BuildID> IDs;
+  std::vector<std::string> CachedFilePaths;
+  for (uint8_t I = 0; I < 4; ++I) {
+    IDs.push_back({0xab, 0xcd, I});
+    std::string Key =
+        getDebuginfodCacheKey(getDebuginfodDebuginfoUrlPath(IDs.back()));
+    SmallString<64> CachedFilePath(CacheDir);
+    sys::path::append(CachedFilePath, "llvmcache-" + Key);
+    std::error_code EC;
+    raw_fd_ostream OS(CachedFilePath, EC);
+    ASSERT_NO_ERROR(EC);
+    OS << "contents\n";
+    CachedFilePaths.push_back(std::string(CachedFilePath));
+  }
+  std::vector<Expected<std::string>> PathsOrErrs =
+      getCachedOrDownloadDebuginfos(IDs);
+  ASSERT_EQ(PathsOrErrs.size(), IDs.size());
+  for (size_t I = 0; I < IDs.size(); ++I)
+    EXPECT_THAT_EXPECTED(PathsOrErrs[I], HasValue(CachedFilePaths[I]));
+}
@@ -0,0 +1,91 @@
+//===- PersistentObjectCacheTest.cpp - Unit tests for the object cache ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class PersistentObjectCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("orc-object-cache", CacheDir));
+  }
+
+  void TearDown() override { sys::fs::remove_directories(CacheDir); }
+
+  std::unique_ptr<PersistentObjectCache> createCache(StringRef ExtraKey = "") {
+    auto Cache = PersistentObjectCache::Create(CacheDir, JTMB, ExtraKey);
+    EXPECT_THAT_EXPECTED(Cache, Succeeded());
+    return Cache ? std::move(*Cache) : nullptr;
+  }
+
+  std::unique_ptr<Module> createModule(StringRef Name) {
+    auto M = std::make_unique<Module>(Name, Ctx);
+    M->setSourceFileName("plan");
+    new GlobalVariable(*M, Type::getInt32Ty(Ctx), /*isConstant=*/false,
+                       GlobalValue::ExternalLinkage, /*Initializer=*/nullptr,
+                       "x");
+    return M;
+  }
+
+  SmallString<128> CacheDir;
+  JITTargetMachineBuilder JTMB{Triple("x86_64-unknown-linux-gnu")};
+  LLVMContext Ctx;
+};
+
+TEST_F(PersistentObjectCacheTest, ReusedAcrossInstances) {
+  std::unique_ptr<Module> M = createModule("M");
+  {
+    std::unique_ptr<PersistentObjectCache> Cache = createCache();
+    ASSERT_TRUE(Cache);
+    EXPECT_FALSE(Cache->getObject(M.get()));
+    Cache->notifyObjectCompiled(M.get(), MemoryBufferRef("object", "M"));
+  }
+
+  std::unique_ptr<PersistentObjectCache> Cache = createCache();
+  ASSERT_TRUE(Cache);
+  std::unique_ptr<MemoryBuffer> Obj = Cache->getObject(M.get());
+  ASSERT_TRUE(Obj);
+  EXPECT_EQ(Obj->getBuffer(), "object");
+
+  // The entries are keyed on the contents, not on the module identifier.
+  std::unique_ptr<Module> Copy = createModule("Copy");
+  EXPECT_EQ(Cache->getKey(*M), Cache->getKey(*Copy));
+  EXPECT_TRUE(Cache->getObject(Copy.get()));
+}
+
+TEST_F(PersistentObjectCacheTest, KeyCoversContentsAndOptions) {
+  std::unique_ptr<Module> M = createModule("M");
+  std::unique_ptr<PersistentObjectCache> Cache = createCache();
+  ASSERT_TRUE(Cache);
+  EXPECT_FALSE(Cache->getObject(M.get()));
+  Cache->notifyObjectCompiled(M.get(), MemoryBufferRef("object", "M"));
+  EXPECT_TRUE(Cache->getObject(M.get()));
+
+  std::unique_ptr<PersistentObjectCache> OtherOptions = createCache("-O3");
+  ASSERT_TRUE(OtherOptions);
+  EXPECT_FALSE(OtherOptions->getObject(M.get()));
+
+  new GlobalVariable(*M, Type::getInt32Ty(Ctx), /*isConstant=*/false,
+                     GlobalValue::ExternalLinkage, /*Initializer=*/nullptr,
+                     "y");
+  EXPECT_FALSE(Cache->getObject(M.get()));
+}
+
+} // namespace
@@ -172,3 +172,52 @@ TEST_F(ReOptimizeLayerTest, BasicReOptimization) {
     EXPECT_EQ(FuncPtr(), 42);
   EXPECT_EQ(FuncPtr(), 53);
 }
+
+TEST_F(ReOptimizeLayerTest, OptimizeFrequentlyCalled) {
+  MangleAndInterner Mangle(*ES, *DL);
+
+  auto &EPC = ES->getExecutorProcessControl();
+  EXPECT_THAT_ERROR(JD->define(absoluteSymbols(
+                        {{Mangle("__orc_rt_jit_dispatch"),
+                          {EPC.getJITDispatchInfo().JITDispatchFunction,
+                           JITSymbolFlags::Exported}},
+                         {Mangle("__orc_rt_jit_dispatch_ctx"),
+                          {EPC.getJITDispatchInfo().JITDispatchContext,
+                           JITSymbolFlags::Exported}},
+                         {Mangle("__orc_rt_reoptimize_tag"),
+                          {ExecutorAddr(), JITSymbolFlags::Exported}}})),
+                    Succeeded());
+
+  auto RM = JITLinkRedirectableSymbolManager::Create(*ObjLinkingLayer);
+  EXPECT_THAT_ERROR(RM.takeError(), Succeeded());
+
+  ROLayer = std::make_unique<ReOptimizeLayer>(*ES, *DL, *CompileLayer, **RM);
+  ROLayer->setReoptimizeFunc(
+      ReOptimizeLayer::createOptimizeFunc(OptimizationLevel::O2));
+  ROLayer->setCallCountThreshold(2);
+  EXPECT_THAT_ERROR(ROLayer->reigsterRuntimeFunctions(*JD), Succeeded());
+
+  ThreadSafeContext Ctx(std::make_unique<LLVMContext>());
+  auto M = std::make_unique<Module>("<main>", *Ctx.getContext());
+  M->setTargetTriple(sys::getProcessTriple());
+
+  (void)createRetFunction(M.get(), "main", 42);
+
+  EXPECT_THAT_ERROR(addIRModule(JD->getDefaultResourceTracker(),
+                                ThreadSafeModule(std::move(M), std::move(Ctx))),
+                    Succeeded());
+
+  auto Result = cantFail(ES->lookup({JD}, Mangle("main")));
+  auto FuncPtr = Result.getAddress().toPtr<int (*)()>();
+  for (size_t I = 0; I <= ROLayer->getCallCountThreshold(); I++)
+    EXPECT_EQ(FuncPtr(), 42);
+
+  // Calling the optimized version doesn't request another reoptimization.
+  EXPECT_EQ(FuncPtr(), 42);
+  EXPECT_EQ(FuncPtr(), 42);
+
+  ReOptimizeLayer::Statistics Stats = ROLayer->getStatistics();
+  EXPECT_EQ(Stats.NumInitialCompiles, 1U);
+  EXPECT_EQ(Stats.NumReoptimizations, 1U);
+  EXPECT_EQ(Stats.NumFailedReoptimizations, 0U);
+}
@@ -7,9 +7,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ExecutionEngine/Orc/SymbolStringPool.h"
+#include "llvm/Config/llvm-config.h" // for LLVM_ENABLE_THREADS
 #include "llvm/ExecutionEngine/Orc/DebugUtils.h"
 #include "gtest/gtest.h"
 
+#include <thread>
+
 using namespace llvm;
 using namespace llvm::orc;
 
@@ -180,4 +183,32 @@ TEST_F(SymbolStringPoolTest, SymbolStringPoolEntryUnsafe) {
   EXPECT_EQ(getRefCount(A), 1U);
 }
 
+#if LLVM_ENABLE_THREADS
+TEST_F(SymbolStringPoolTest, ConcurrentIntern) {
+  // Intern the same strings from several threads, and check that they all
+  // got the same entries.
+  constexpr unsigned NumThreads = 4;
+  constexpr unsigned NumStrings = 1000;
+  std::vector<std::vector<SymbolStringPtr>> Interned(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T]() {
+      for (unsigned I = 0; I != NumStrings; ++I)
+        Interned[T].push_back(SP.intern("sym" + std::to_string(I)));
+    });
+  for (auto &T : Threads)
+    T.join();
+
+  for (unsigned I = 0; I != NumStrings; ++I) {
+    EXPECT_EQ(getRefCount(Interned[0][I]), NumThreads);
+    for (unsigned T = 1; T != NumThreads; ++T)
+      EXPECT_EQ(Interned[0][I], Interned[T][I]);
+  }
+
+  Interned.clear();
+  SP.clearDeadEntries();
+  EXPECT_TRUE(SP.empty());
+}
+#endif
+
 } // namespace
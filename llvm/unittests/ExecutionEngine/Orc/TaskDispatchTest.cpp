@@ -23,6 +23,21 @@ TEST(InPlaceTaskDispatchTest, GenericNamedTask) {
   D->shutdown();
 }
 
+TEST(InPlaceTaskDispatchTest, IdleTask) {
+  auto D = std::make_unique<InPlaceTaskDispatcher>();
+  bool B = false;
+  D->dispatch(makeIdleTask(makeGenericNamedTask([&]() { B = true; })));
+  EXPECT_TRUE(B);
+
+  // Cancelled idle tasks are dropped.
+  auto Cancelled = std::make_shared<std::atomic<bool>>(true);
+  bool C = false;
+  D->dispatch(
+      makeIdleTask(makeGenericNamedTask([&]() { C = true; }), Cancelled));
+  EXPECT_FALSE(C);
+  D->shutdown();
+}
+
 #if LLVM_ENABLE_THREADS
 TEST(DynamicThreadPoolDispatchTest, GenericNamedTask) {
   auto D = std::make_unique<DynamicThreadPoolTaskDispatcher>(std::nullopt);
@@ -33,4 +48,34 @@ TEST(DynamicThreadPoolDispatchTest, GenericNamedTask) {
   EXPECT_TRUE(F.get());
   D->shutdown();
 }
+
+TEST(DynamicThreadPoolDispatchTest, IdleTasks) {
+  auto D = std::make_unique<DynamicThreadPoolTaskDispatcher>(1);
+
+  // While the only thread is busy, idle tasks are queued, and run in order
+  // when it becomes free.
+  std::promise<void> Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  D->dispatch(makeIdleTask(makeGenericNamedTask([Released]() {
+    Released.wait();
+  })));
+
+  std::vector<int> Order;
+  std::promise<void> Done;
+  auto Cancelled = std::make_shared<std::atomic<bool>>(false);
+  D->dispatch(
+      makeIdleTask(makeGenericNamedTask([&]() { Order.push_back(1); })));
+  D->dispatch(makeIdleTask(
+      makeGenericNamedTask([&]() { Order.push_back(2); }), Cancelled));
+  D->dispatch(makeIdleTask(makeGenericNamedTask([&]() {
+    Order.push_back(3);
+    Done.set_value();
+  })));
+  *Cancelled = true;
+  Release.set_value();
+
+  Done.get_future().wait();
+  D->shutdown();
+  EXPECT_EQ(Order, std::vector<int>({1, 3}));
+}
 #endif
@@ -148,6 +148,21 @@ TEST_F(MDStringTest, CreateSame) {
   EXPECT_EQ(s1, s2);
 }
 
+// Test that getUnowned refers to the string it is given unless the string is
+// already uniqued, and that it is uniqued with copied strings.
+TEST_F(MDStringTest, CreateUnowned) {
+  static const char x[] = "unowned";
+  static const char y[] = "owned";
+
+  MDString *s1 = MDString::getUnowned(Context, StringRef(x, 7));
+  EXPECT_EQ(x, s1->getString().data());
+  EXPECT_EQ(s1, MDString::get(Context, "unowned"));
+
+  MDString *s2 = MDString::get(Context, "owned");
+  EXPECT_NE(y, s2->getString().data());
+  EXPECT_EQ(s2, MDString::getUnowned(Context, StringRef(y, 5)));
+}
+
 // Test that MDString prints out the string we fed it.
 TEST_F(MDStringTest, PrintingSimple) {
   char str[14] = "testing 1 2 3";
@@ -437,5 +437,50 @@ TEST(VerifierTest, DetectTaggedGlobalInSection) {
       << Error;
 }
 
+TEST(VerifierTest, ConcurrentFunctionVerification) {
+  LLVMContext C;
+  Module M("M", C);
+  DIBuilder DIB(M);
+  DIFile *File = DIB.createFile("concurrent.c", "/");
+  DICompileUnit *CU = DIB.createCompileUnit(dwarf::DW_LANG_C89, File,
+                                            "unittest", false, "", 0);
+  DISubprogram *SP = DIB.createFunction(
+      CU, "f", "f", File, 1, nullptr, 1, DINode::FlagZero,
+      DISubprogram::SPFlagDefinition);
+  FunctionType *FTy = FunctionType::get(Type::getVoidTy(C), /*isVarArg=*/false);
+  for (unsigned I = 0; I != 16; ++I) {
+    Function *F = Function::Create(FTy, Function::ExternalLinkage,
+                                   "f" + Twine(I), M);
+    ReturnInst::Create(C, BasicBlock::Create(C, "entry", F));
+  }
+  DIB.finalize();
+  EXPECT_FALSE(verifyModule(M, nullptr, nullptr, /*Threads=*/4));
+
+  // Break a function in the middle of the module. The diagnostics match the
+  // sequential verification.
+  Function *Broken = M.getFunction("f7");
+  BasicBlock *Exit = BasicBlock::Create(C, "exit", Broken);
+  ReturnInst::Create(C, Exit);
+  BranchInst *BI = BranchInst::Create(Exit, Exit, ConstantInt::getFalse(C));
+  BI->insertBefore(Broken->getEntryBlock().getTerminator());
+  Broken->getEntryBlock().getTerminator()->eraseFromParent();
+  BI->setOperand(0, ConstantInt::get(Type::getInt32Ty(C), 0));
+
+  std::string Sequential, Concurrent;
+  raw_string_ostream SequentialOS(Sequential), ConcurrentOS(Concurrent);
+  EXPECT_TRUE(verifyModule(M, &SequentialOS));
+  EXPECT_TRUE(verifyModule(M, &ConcurrentOS, nullptr, /*Threads=*/4));
+  EXPECT_EQ(Sequential, Concurrent);
+  BI->setOperand(0, ConstantInt::getFalse(C));
+
+  // Attaching a subprogram to functions verified by different threads is
+  // still detected.
+  M.getFunction("f0")->setSubprogram(SP);
+  M.getFunction("f15")->setSubprogram(SP);
+  bool BrokenDebugInfo = false;
+  EXPECT_FALSE(verifyModule(M, nullptr, &BrokenDebugInfo, /*Threads=*/4));
+  EXPECT_TRUE(BrokenDebugInfo);
+}
+
 } // end anonymous namespace
 } // end namespace llvm
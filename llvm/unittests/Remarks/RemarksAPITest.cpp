@@ -7,6 +7,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+#include "llvm/Remarks/RemarkStreamer.h"
 #include "llvm/Remarks/RemarkStringTable.h"
 #include "gtest/gtest.h"
 
@@ -121,3 +123,34 @@ TEST(RemarksAPI, StringTableInternalize) {
   EXPECT_EQ(StrTab.add(R.Args.back().Loc->SourceFilePath).second.data(),
             R2.Args.back().Loc->SourceFilePath.data());
 }
+
+TEST(RemarksAPI, StreamerSampling) {
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  Expected<std::unique_ptr<remarks::RemarkSerializer>> Serializer =
+      remarks::createRemarkSerializer(remarks::Format::YAML,
+                                      remarks::SerializerMode::Separate, OS);
+  ASSERT_TRUE(static_cast<bool>(Serializer));
+  remarks::RemarkStreamer RS(std::move(*Serializer));
+
+  // By default, all the remarks are emitted.
+  EXPECT_EQ(RS.getSampleRate(), 1u);
+  EXPECT_TRUE(RS.shouldSample());
+  EXPECT_TRUE(RS.shouldSample());
+
+  // Check that one remark out of every three is emitted, starting with the
+  // third one.
+  RS.setSampleRate(3);
+  unsigned NumSampled = 0;
+  for (unsigned I = 0; I < 9; ++I)
+    if (RS.shouldSample()) {
+      EXPECT_EQ(I % 3, 2u);
+      ++NumSampled;
+    }
+  EXPECT_EQ(NumSampled, 3u);
+
+  // A rate of zero is the same as no sampling.
+  RS.setSampleRate(0);
+  EXPECT_EQ(RS.getSampleRate(), 1u);
+  EXPECT_TRUE(RS.shouldSample());
+}
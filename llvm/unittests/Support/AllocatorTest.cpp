@@ -79,6 +79,40 @@ TEST(AllocatorTest, TestReset) {
   EXPECT_EQ(2U, Alloc.GetNumSlabs());
 }
 
+// Allocate enough bytes to create three slabs, reset the allocator while
+// keeping them, and check that they are reused in order.
+TEST(AllocatorTest, TestResetRetainingSlabs) {
+  BumpPtrAllocator Alloc;
+
+  void *First = Alloc.Allocate(3000, 1);
+  Alloc.Allocate(3000, 1);
+  void *Third = Alloc.Allocate(3000, 1);
+  (void)Alloc.Allocate(5000, 1);
+  EXPECT_EQ(4U, Alloc.GetNumSlabs());
+  size_t TotalMemory = Alloc.getTotalMemory();
+
+  Alloc.ResetRetainingSlabs();
+  // The custom-sized slab is freed, the regular slabs are kept.
+  EXPECT_EQ(3U, Alloc.GetNumSlabs());
+  EXPECT_EQ(0U, Alloc.getBytesAllocated());
+  EXPECT_EQ(First, Alloc.Allocate(3000, 1));
+  Alloc.Allocate(3000, 1);
+  EXPECT_EQ(Third, Alloc.Allocate(3000, 1));
+  EXPECT_EQ(3U, Alloc.GetNumSlabs());
+  EXPECT_LT(Alloc.getTotalMemory(), TotalMemory);
+
+  // Once the retained slabs are used up, new ones are allocated.
+  Alloc.Allocate(3000, 1);
+  EXPECT_EQ(4U, Alloc.GetNumSlabs());
+
+  // Reset still frees all but the first slab.
+  Alloc.Reset();
+  EXPECT_EQ(1U, Alloc.GetNumSlabs());
+  EXPECT_EQ(First, Alloc.Allocate(3000, 1));
+  Alloc.Allocate(3000, 1);
+  EXPECT_EQ(2U, Alloc.GetNumSlabs());
+}
+
 // Test some allocations at varying alignments.
 TEST(AllocatorTest, TestAlignment) {
   BumpPtrAllocator Alloc;
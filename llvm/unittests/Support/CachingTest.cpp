@@ -0,0 +1,100 @@
+//===- CachingTest.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using llvm::unittest::TempDir;
+
+namespace {
+struct Added {
+  std::string ModuleName;
+  std::string Contents;
+};
+
+AddBufferFn recordTo(std::vector<Added> &Out) {
+  return [&Out](size_t Task, const Twine &ModuleName,
+                std::unique_ptr<MemoryBuffer> MB) {
+    Out.push_back({ModuleName.str(), MB->getBuffer().str()});
+  };
+}
+
+// Look up Key, producing Contents on a miss. Returns whether it was a hit.
+bool lookup(FileCache &Cache, StringRef Key, StringRef Contents) {
+  Expected<AddStreamFn> AddStreamOrErr = Cache(0, Key, "mod");
+  EXPECT_THAT_EXPECTED(AddStreamOrErr, Succeeded());
+  if (!AddStreamOrErr || !*AddStreamOrErr)
+    return true;
+  Expected<std::unique_ptr<CachedFileStream>> StreamOrErr =
+      (*AddStreamOrErr)(0, "mod");
+  EXPECT_THAT_EXPECTED(StreamOrErr, Succeeded());
+  *(*StreamOrErr)->OS << Contents;
+  return false;
+}
+} // namespace
+
+TEST(Caching, DirectoryCacheStore) {
+  TempDir Remote("remote", /*Unique=*/true);
+  std::unique_ptr<RemoteCacheStore> Store =
+      createDirectoryCacheStore(Remote.path("store"));
+
+  Expected<std::unique_ptr<MemoryBuffer>> MBOrErr = Store->get("key");
+  ASSERT_THAT_EXPECTED(MBOrErr, Succeeded());
+  EXPECT_EQ(nullptr, *MBOrErr);
+
+  std::unique_ptr<MemoryBuffer> Data = MemoryBuffer::getMemBuffer("data");
+  ASSERT_THAT_ERROR(Store->put("key", Data->getMemBufferRef()), Succeeded());
+  EXPECT_TRUE(sys::fs::exists(Remote.path("store/llvmcache-key")));
+
+  MBOrErr = Store->get("key");
+  ASSERT_THAT_EXPECTED(MBOrErr, Succeeded());
+  ASSERT_NE(nullptr, *MBOrErr);
+  EXPECT_EQ("data", (*MBOrErr)->getBuffer());
+}
+
+TEST(Caching, RemoteBackedCache) {
+  TempDir Remote("remote", /*Unique=*/true);
+  TempDir Local1("local1", /*Unique=*/true);
+  TempDir Local2("local2", /*Unique=*/true);
+  std::shared_ptr<RemoteCacheStore> Store =
+      createDirectoryCacheStore(Remote.path());
+
+  // A miss in both caches adds the entry to both.
+  std::vector<Added> Added1;
+  Expected<FileCache> Cache1 = remoteBackedCache(
+      "Test", "Test", Local1.path(), Store, recordTo(Added1));
+  ASSERT_THAT_EXPECTED(Cache1, Succeeded());
+  EXPECT_FALSE(lookup(*Cache1, "key", "data"));
+  ASSERT_EQ(1u, Added1.size());
+  EXPECT_EQ("data", Added1[0].Contents);
+  EXPECT_TRUE(sys::fs::exists(Local1.path("llvmcache-key")));
+  EXPECT_TRUE(sys::fs::exists(Remote.path("llvmcache-key")));
+
+  // Another machine with an empty local cache gets the entry from the store.
+  std::vector<Added> Added2;
+  Expected<FileCache> Cache2 = remoteBackedCache(
+      "Test", "Test", Local2.path(), Store, recordTo(Added2));
+  ASSERT_THAT_EXPECTED(Cache2, Succeeded());
+  EXPECT_TRUE(lookup(*Cache2, "key", "unused"));
+  ASSERT_EQ(1u, Added2.size());
+  EXPECT_EQ("mod", Added2[0].ModuleName);
+  EXPECT_EQ("data", Added2[0].Contents);
+  EXPECT_TRUE(sys::fs::exists(Local2.path("llvmcache-key")));
+
+  // Now it is a hit in the local cache.
+  EXPECT_TRUE(lookup(*Cache2, "key", "unused"));
+  ASSERT_EQ(2u, Added2.size());
+  EXPECT_EQ("data", Added2[1].Contents);
+}
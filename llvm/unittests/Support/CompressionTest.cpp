@@ -110,5 +110,71 @@ TEST(CompressionTest, Zstd) {
   testZstdCompression(BinaryDataStr, zstd::BestSpeedCompression);
   testZstdCompression(BinaryDataStr, zstd::DefaultCompression);
 }
+
+TEST(CompressionTest, ZstdParallel) {
+  std::string Input;
+  for (unsigned I = 0; I != 20000; ++I)
+    Input += "line " + utostr(I % 1000) + "\n";
+  ArrayRef<uint8_t> InputRef = arrayRefFromStringRef(Input);
+
+  // Blocks of 4 KiB give several frames, which decompress as a whole.
+  SmallVector<uint8_t, 0> Compressed, Uncompressed;
+  zstd::compressParallel(InputRef, Compressed, zstd::DefaultCompression,
+                         /*EnableLdm=*/false, /*BlockSize=*/4096);
+  EXPECT_FALSE(zstd::decompress(Compressed, Uncompressed, Input.size()));
+  EXPECT_EQ(Input, toStringRef(Uncompressed));
+
+  // The output is deterministic.
+  SmallVector<uint8_t, 0> Compressed2;
+  zstd::compressParallel(InputRef, Compressed2, zstd::DefaultCompression,
+                         /*EnableLdm=*/false, /*BlockSize=*/4096);
+  EXPECT_EQ(Compressed, Compressed2);
+
+  // Input that fits in a block is compressed into a single frame.
+  SmallVector<uint8_t, 0> Single;
+  zstd::compressParallel(InputRef, Compressed2);
+  zstd::compress(InputRef, Single);
+  EXPECT_EQ(Single, Compressed2);
+
+  // compress dispatches to compressParallel if requested.
+  Params P(Format::Zstd);
+  P.zstdParallel = true;
+  compress(P, InputRef, Compressed2);
+  EXPECT_EQ(Single, Compressed2);
+}
+
+TEST(CompressionTest, ZstdStreaming) {
+  // Use more than ZSTD_DStreamOutSize (128 KiB) of output and several frames.
+  std::string Input;
+  for (unsigned I = 0; I != 100000; ++I)
+    Input += utostr(I) + ",";
+  ArrayRef<uint8_t> InputRef = arrayRefFromStringRef(Input);
+  SmallVector<uint8_t, 0> Compressed;
+  zstd::compressParallel(InputRef, Compressed, zstd::DefaultCompression,
+                         /*EnableLdm=*/false, /*BlockSize=*/100000);
+
+  std::string Output;
+  unsigned NumPieces = 0;
+  auto Consumer = [&](ArrayRef<uint8_t> Piece) {
+    Output += toStringRef(Piece);
+    ++NumPieces;
+    return Error::success();
+  };
+  EXPECT_FALSE(zstd::decompressStreaming(Compressed, Consumer));
+  EXPECT_EQ(Input, Output);
+  EXPECT_GT(NumPieces, 1u);
+
+  // Truncated input is diagnosed.
+  Output.clear();
+  Error E = zstd::decompressStreaming(
+      ArrayRef(Compressed).drop_back(10), Consumer);
+  EXPECT_EQ("Truncated zstd input", llvm::toString(std::move(E)));
+
+  // Errors from the consumer are returned.
+  E = zstd::decompressStreaming(Compressed, [](ArrayRef<uint8_t>) {
+    return createStringError(inconvertibleErrorCode(), "stop");
+  });
+  EXPECT_EQ("stop", llvm::toString(std::move(E)));
+}
 #endif
 }
@@ -155,6 +155,32 @@ TEST(FileOutputBuffer, Test) {
   ASSERT_EQ(File6Size, 0ULL);
   ASSERT_NO_ERROR(fs::remove(File6.str()));
 
+  // TEST 7: Released ranges keep their contents.
+  SmallString<128> File7(TestDirectory);
+  File7.append("/file7");
+  {
+    Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+        FileOutputBuffer::create(File7, 65536);
+    ASSERT_NO_ERROR(errorToErrorCode(BufferOrErr.takeError()));
+    std::unique_ptr<FileOutputBuffer> &Buffer = *BufferOrErr;
+    for (size_t I = 0; I != 65536; ++I)
+      Buffer->getBufferStart()[I] = I % 251;
+    Buffer->releaseRange(1, 65534);
+    Buffer->releaseRange(0, 65536);
+    for (size_t I = 0; I != 65536; ++I)
+      ASSERT_EQ(Buffer->getBufferStart()[I], I % 251);
+    ASSERT_NO_ERROR(errorToErrorCode(Buffer->commit()));
+  }
+  {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
+        MemoryBuffer::getFile(File7);
+    ASSERT_TRUE(!!BufOrErr);
+    ASSERT_EQ((*BufOrErr)->getBufferSize(), 65536U);
+    for (size_t I = 0; I != 65536; ++I)
+      ASSERT_EQ((uint8_t)(*BufOrErr)->getBufferStart()[I], I % 251);
+  }
+  ASSERT_NO_ERROR(fs::remove(File7.str()));
+
   // Clean up.
   ASSERT_NO_ERROR(fs::remove(TestDirectory.str()));
 }
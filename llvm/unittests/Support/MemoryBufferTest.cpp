@@ -15,6 +15,7 @@
 #include "llvm/Config/llvm-config.h" // for LLVM_ENABLE_THREADS, LLVM_ON_UNIX
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MemoryBufferPrefetcher.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -436,6 +437,49 @@ TEST_F(MemoryBufferTest, mmapVolatileNoNull) {
   EXPECT_TRUE(MB->getBuffer().starts_with("01234567"));
 }
 
+TEST_F(MemoryBufferTest, prefetch) {
+  // A small file that is read and a file large enough to mmap.
+  unsigned PageSize = sys::Process::getPageSizeEstimate();
+  std::string Contents[] = {data, std::string(PageSize * 8, 'x')};
+  std::vector<std::string> Paths;
+  FileRemover Cleanup[2];
+  for (unsigned I = 0; I != 2; ++I) {
+    int FD;
+    SmallString<64> TestPath;
+    ASSERT_NO_ERROR(sys::fs::createTemporaryFile("MemoryBufferTest_prefetch",
+                                                 "temp", FD, TestPath));
+    Cleanup[I].setFile(TestPath);
+    raw_fd_ostream OF(FD, true);
+    OF << Contents[I];
+    OF.close();
+    Paths.push_back(std::string(TestPath));
+  }
+  SmallString<64> Missing(Paths[0]);
+  Missing += ".missing";
+  Paths.push_back(std::string(Missing));
+
+  std::vector<std::future<MemoryBufferPrefetcher::BufferOrError>> Futures;
+  {
+    // The futures outlive the prefetcher.
+    MemoryBufferPrefetcher Prefetcher;
+    Futures = Prefetcher.prefetchAll(Paths, /*IsText=*/false,
+                                     /*RequiresNullTerminator=*/false);
+  }
+  ASSERT_EQ(3u, Futures.size());
+  for (unsigned I = 0; I != 2; ++I) {
+    MemoryBufferPrefetcher::BufferOrError MB = Futures[I].get();
+    ASSERT_NO_ERROR(MB.getError());
+    EXPECT_EQ(Contents[I], (*MB)->getBuffer());
+    EXPECT_EQ(Paths[I], (*MB)->getBufferIdentifier());
+  }
+  EXPECT_EQ(std::errc::no_such_file_or_directory, Futures[2].get().getError());
+
+  MemoryBufferPrefetcher Prefetcher(hardware_concurrency(2));
+  auto MB = Prefetcher.prefetch(Paths[1]).get();
+  ASSERT_NO_ERROR(MB.getError());
+  EXPECT_EQ(Contents[1], (*MB)->getBuffer());
+}
+
 // Test that SmallVector without a null terminator gets one.
 TEST(SmallVectorMemoryBufferTest, WithoutNullTerminatorRequiresNullTerminator) {
   SmallString<0> Data("some data");
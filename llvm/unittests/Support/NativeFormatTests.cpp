@@ -160,6 +160,48 @@ TEST(NativeFormatTest, IntegerTests) {
   EXPECT_EQ("1234567890", format_number(1234567890, IntegerStyle::Integer));
 }
 
+TEST(NativeFormatTest, PaddedIntegerTests) {
+  auto Format = [](int64_t N, size_t MinDigits, IntegerStyle Style) {
+    std::string S;
+    raw_string_ostream Str(S);
+    write_integer(Str, N, MinDigits, Style);
+    return S;
+  };
+  EXPECT_EQ("00042", Format(42, 5, IntegerStyle::Integer));
+  EXPECT_EQ("-00042", Format(-42, 5, IntegerStyle::Integer));
+  EXPECT_EQ("123456", Format(123456, 3, IntegerStyle::Integer));
+  EXPECT_EQ(std::string(199, '0') + "7", Format(7, 200, IntegerStyle::Integer));
+  EXPECT_EQ("-" + std::string(127, '0') + "7",
+            Format(-7, 128, IntegerStyle::Integer));
+  EXPECT_EQ("-9223372036854775808",
+            Format(std::numeric_limits<int64_t>::min(), 0,
+                   IntegerStyle::Integer));
+  EXPECT_EQ("18446744073709551615",
+            format_number(std::numeric_limits<uint64_t>::max(),
+                          IntegerStyle::Integer));
+}
+
+TEST(NativeFormatTest, HexBlockTests) {
+  auto Format = [](ArrayRef<uint8_t> Bytes, bool Upper) {
+    std::string S;
+    raw_string_ostream Str(S);
+    write_hex_block(Str, Bytes, Upper);
+    return S;
+  };
+  EXPECT_EQ("", Format({}, false));
+  EXPECT_EQ("00ff1aa0", Format({0x00, 0xff, 0x1a, 0xa0}, false));
+  EXPECT_EQ("00FF1AA0", Format({0x00, 0xff, 0x1a, 0xa0}, true));
+
+  // Blocks larger than the internal buffer are written in several chunks.
+  std::vector<uint8_t> Bytes(1000);
+  std::string Expected;
+  for (size_t I = 0; I != Bytes.size(); ++I) {
+    Bytes[I] = I * 7;
+    Expected += format_number(Bytes[I], HexPrintStyle::Lower, 2);
+  }
+  EXPECT_EQ(Expected, Format(Bytes, false));
+}
+
 TEST(NativeFormatTest, CommaTests) {
   EXPECT_EQ("0", format_number(0, IntegerStyle::Number));
   EXPECT_EQ("10", format_number(10, IntegerStyle::Number));
@@ -96,9 +96,8 @@ TEST(Parallel, ForEachError) {
 
 #if LLVM_ENABLE_THREADS
 TEST(Parallel, NestedTaskGroup) {
-  // This test checks:
-  // 1. Root TaskGroup is in Parallel mode.
-  // 2. Nested TaskGroup is not in Parallel mode.
+  // This test checks that both the root TaskGroup and a nested TaskGroup are
+  // in Parallel mode.
   parallel::TaskGroup tg;
 
   tg.spawn([&]() {
@@ -107,17 +106,29 @@ TEST(Parallel, NestedTaskGroup) {
 
   tg.spawn([&]() {
     parallel::TaskGroup nestedTG;
-    EXPECT_FALSE(nestedTG.isParallel());
+    EXPECT_TRUE(nestedTG.isParallel() ||
+                (parallel::strategy.ThreadsRequested == 1));
 
     nestedTG.spawn([&]() {
-      // Check that root TaskGroup is in Parallel mode.
       EXPECT_TRUE(tg.isParallel() ||
                   (parallel::strategy.ThreadsRequested == 1));
+      EXPECT_TRUE(nestedTG.isParallel() ||
+                  (parallel::strategy.ThreadsRequested == 1));
+    });
+  });
+}
 
-      // Check that nested TaskGroup is not in Parallel mode.
-      EXPECT_FALSE(nestedTG.isParallel());
+TEST(Parallel, DeeplyNestedParallelFor) {
+  // Nest parallelFor with more tasks than there are threads at every level.
+  // The threads waiting for the nested loops have to run pending tasks to
+  // avoid a deadlock.
+  std::atomic<size_t> Count{0};
+  parallelFor(0, 64, [&](size_t) {
+    parallelFor(0, 64, [&](size_t) {
+      parallelFor(0, 16, [&](size_t) { ++Count; });
     });
   });
+  EXPECT_EQ(Count, 64ul * 64 * 16);
 }
 
 TEST(Parallel, ParallelNestedTaskGroup) {
@@ -134,9 +145,10 @@ TEST(Parallel, ParallelNestedTaskGroup) {
         EXPECT_TRUE(tg.isParallel() ||
                     (parallel::strategy.ThreadsRequested == 1));
 
-        // Check that nested TaskGroup is not in Parallel mode.
+        // Check that nested TaskGroup is in Parallel mode.
         parallel::TaskGroup nestedTG;
-        EXPECT_FALSE(nestedTG.isParallel());
+        EXPECT_TRUE(nestedTG.isParallel() ||
+                    (parallel::strategy.ThreadsRequested == 1));
         ++Count;
 
         nestedTG.spawn([&]() {
@@ -144,8 +156,9 @@ TEST(Parallel, ParallelNestedTaskGroup) {
           EXPECT_TRUE(tg.isParallel() ||
                       (parallel::strategy.ThreadsRequested == 1));
 
-          // Check that nested TaskGroup is not in Parallel mode.
-          EXPECT_FALSE(nestedTG.isParallel());
+          // Check that nested TaskGroup is in Parallel mode.
+          EXPECT_TRUE(nestedTG.isParallel() ||
+                      (parallel::strategy.ThreadsRequested == 1));
           ++Count;
         });
       });
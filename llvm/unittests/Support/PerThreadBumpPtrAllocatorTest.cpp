@@ -10,6 +10,7 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <thread>
 
 using namespace llvm;
 using namespace parallel;
@@ -53,4 +54,31 @@ TEST(PerThreadBumpPtrAllocatorTest, ParallelAllocation) {
   EXPECT_EQ(Allocator.getNumberOfAllocators(), parallel::getThreadCount());
 }
 
+TEST(PerThreadBumpPtrAllocatorTest, ForeignThreads) {
+  PerThreadBumpPtrAllocator Allocator;
+
+  static size_t constexpr NumAllocations = 1000;
+
+  // Threads that were not created by the executor, including the main thread,
+  // may allocate concurrently with the executor threads.
+  auto AllocateAll = [&] {
+    for (size_t Idx = 0; Idx < NumAllocations; ++Idx)
+      *(uint64_t *)Allocator.Allocate(sizeof(uint64_t), alignof(uint64_t)) =
+          Idx;
+  };
+  std::thread Thread(AllocateAll);
+  parallelFor(0, NumAllocations, [&](size_t Idx) {
+    uint64_t *Ptr =
+        (uint64_t *)Allocator.Allocate(sizeof(uint64_t), alignof(uint64_t));
+    *Ptr = Idx;
+  });
+  AllocateAll();
+  Thread.join();
+
+  EXPECT_EQ(sizeof(uint64_t) * NumAllocations * 3,
+            Allocator.getBytesAllocated());
+  Allocator.Reset();
+  EXPECT_EQ(0u, Allocator.getBytesAllocated());
+}
+
 } // anonymous namespace
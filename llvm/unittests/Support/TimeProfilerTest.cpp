@@ -15,6 +15,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -96,4 +99,43 @@ TEST(TimeProfiler, Instant_Not_Added_Smoke) {
   ASSERT_TRUE(json.find(R"("detail":"instant detail")") == std::string::npos);
 }
 
+TEST(TimeProfiler, MaxEntries) {
+  timeTraceProfilerInitialize(/*TimeTraceGranularity=*/0, "test",
+                              /*TimeTraceVerbose=*/false, /*MaxEntries=*/2);
+
+  { TimeTraceScope scope("first"); }
+  { TimeTraceScope scope("second"); }
+  { TimeTraceScope scope("third"); }
+
+  std::string json = teardownProfiler();
+  ASSERT_TRUE(json.find(R"("name":"first")") == std::string::npos);
+  ASSERT_TRUE(json.find(R"("name":"second")") != std::string::npos);
+  ASSERT_TRUE(json.find(R"("name":"third")") != std::string::npos);
+  ASSERT_TRUE(json.find(R"("droppedEvents":1)") != std::string::npos);
+  // The totals still cover the dropped event.
+  ASSERT_TRUE(json.find(R"("name":"Total first")") != std::string::npos);
+}
+
+TEST(TimeProfiler, Flush) {
+  unittest::TempDir Dir("time-profiler-flush", /*Unique=*/true);
+  SmallString<128> Path(Dir.path("trace.json"));
+  setupProfiler();
+  timeTraceProfilerSetFlush(Path, std::chrono::milliseconds(0));
+
+  TimeTraceProfilerEntry *Outer = timeTraceProfilerBegin("outer", "");
+  { TimeTraceScope scope("inner"); }
+  ASSERT_FALSE(sys::fs::exists(Path));
+
+  timeTraceProfilerRequestFlush();
+  { TimeTraceScope scope("inner2"); }
+  auto Buffer = MemoryBuffer::getFile(Path);
+  ASSERT_TRUE(bool(Buffer));
+  StringRef json = (*Buffer)->getBuffer();
+  ASSERT_TRUE(json.contains(R"("name":"inner2")"));
+  // The open section is written as well.
+  ASSERT_TRUE(json.contains(R"("name":"outer")"));
+  timeTraceProfilerEnd(Outer);
+  timeTraceProfilerCleanup();
+}
+
 } // namespace
@@ -3675,3 +3675,96 @@ TEST(TracingFileSystemTest, PrintOutput) {
             "  InMemoryFileSystem\n",
             Output);
 }
+
+TEST(CachingFileSystemTest, CachesStatusAndListings) {
+  auto InMemoryFS = makeIntrusiveRefCnt<vfs::InMemoryFileSystem>();
+  InMemoryFS->addFile("/dir/a", 0, MemoryBuffer::getMemBuffer("a"));
+  InMemoryFS->addFile("/dir/b", 0, MemoryBuffer::getMemBuffer("b"));
+  auto TracingFS = makeIntrusiveRefCnt<vfs::TracingFileSystem>(InMemoryFS);
+  auto CachingFS = makeIntrusiveRefCnt<vfs::CachingFileSystem>(TracingFS);
+
+  for (int I = 0; I != 3; ++I) {
+    ErrorOr<vfs::Status> S = CachingFS->status("/dir/a");
+    ASSERT_TRUE(S);
+    EXPECT_EQ("/dir/a", S->getName());
+    EXPECT_FALSE(CachingFS->exists("/dir/missing"));
+  }
+  EXPECT_EQ(TracingFS->NumStatusCalls, 2u);
+
+  // Relative paths share the entries of the absolute ones but keep their
+  // names.
+  ASSERT_FALSE(CachingFS->setCurrentWorkingDirectory("/dir"));
+  ErrorOr<vfs::Status> S = CachingFS->status("a");
+  ASSERT_TRUE(S);
+  EXPECT_EQ("a", S->getName());
+  EXPECT_EQ(TracingFS->NumStatusCalls, 2u);
+
+  std::error_code EC;
+  for (int I = 0; I != 3; ++I) {
+    std::vector<std::string> Names;
+    for (vfs::directory_iterator It = CachingFS->dir_begin("/dir", EC), E;
+         !EC && It != E; It.increment(EC))
+      Names.push_back(It->path().str());
+    ASSERT_FALSE(EC);
+    EXPECT_THAT(Names, UnorderedElementsAre("/dir/a", "/dir/b"));
+    CachingFS->dir_begin("/missing", EC);
+    EXPECT_TRUE(EC);
+    EC.clear();
+  }
+  EXPECT_EQ(TracingFS->NumDirBeginCalls, 2u);
+
+  vfs::CachingFileSystem::Statistics Stats = CachingFS->getStatistics();
+  EXPECT_EQ(5u, Stats.StatusHits);
+  EXPECT_EQ(2u, Stats.StatusMisses);
+  EXPECT_EQ(4u, Stats.DirHits);
+  EXPECT_EQ(2u, Stats.DirMisses);
+}
+
+TEST(CachingFileSystemTest, Invalidate) {
+  auto InMemoryFS = makeIntrusiveRefCnt<vfs::InMemoryFileSystem>();
+  InMemoryFS->addFile("/dir/a", 0, MemoryBuffer::getMemBuffer("a"));
+  InMemoryFS->addFile("/dir/sub/c", 0, MemoryBuffer::getMemBuffer("c"));
+  auto CachingFS = makeIntrusiveRefCnt<vfs::CachingFileSystem>(InMemoryFS);
+
+  auto CountEntries = [&](StringRef Dir) {
+    std::error_code EC;
+    unsigned N = 0;
+    for (vfs::directory_iterator It = CachingFS->dir_begin(Dir, EC), E;
+         !EC && It != E; It.increment(EC))
+      ++N;
+    return N;
+  };
+
+  EXPECT_FALSE(CachingFS->exists("/dir/b"));
+  EXPECT_EQ(2u, CountEntries("/dir"));
+  EXPECT_TRUE(CachingFS->exists("/dir/sub/c"));
+
+  // The cache is stale until the new file is reported.
+  InMemoryFS->addFile("/dir/b", 0, MemoryBuffer::getMemBuffer("b"));
+  EXPECT_FALSE(CachingFS->exists("/dir/b"));
+  EXPECT_EQ(2u, CountEntries("/dir"));
+  CachingFS->invalidate("/dir/b");
+  EXPECT_TRUE(CachingFS->exists("/dir/b"));
+  EXPECT_EQ(3u, CountEntries("/dir"));
+
+  // Invalidating a directory drops what is below it.
+  CachingFS->invalidate("/dir/sub");
+  EXPECT_EQ(0u, CachingFS->getStatistics().Flushes);
+  vfs::CachingFileSystem::Statistics Before = CachingFS->getStatistics();
+  EXPECT_TRUE(CachingFS->exists("/dir/sub/c"));
+  EXPECT_EQ(Before.StatusMisses + 1, CachingFS->getStatistics().StatusMisses);
+
+  CachingFS->invalidateAll();
+  Before = CachingFS->getStatistics();
+  EXPECT_TRUE(CachingFS->exists("/dir/a"));
+  EXPECT_EQ(Before.StatusMisses + 1, CachingFS->getStatistics().StatusMisses);
+}
+
+TEST(CachingFileSystemTest, BoundedSize) {
+  auto InMemoryFS = makeIntrusiveRefCnt<vfs::InMemoryFileSystem>();
+  auto CachingFS =
+      makeIntrusiveRefCnt<vfs::CachingFileSystem>(InMemoryFS, /*MaxEntries=*/4);
+  for (int I = 0; I != 10; ++I)
+    EXPECT_FALSE(CachingFS->exists("/file" + Twine(I)));
+  EXPECT_EQ(2u, CachingFS->getStatistics().Flushes);
+}
@@ -838,6 +838,13 @@ define void @foo(ptr %ptr, ptr noalias %ptr2, i8 %v1, i8 %v2, i8 %v3, i8 %arg) {
     EXPECT_EQ(NewMemSN->getPrevNode(), S2MemN);
     EXPECT_EQ(NewMemSN->getNextNode(), S3MemN);
     EXPECT_EQ(S3MemN->getPrevNode(), NewMemSN);
+
+    // Check the dependencies to/from NewSN.
+    auto *S1MemN = cast<sandboxir::MemDGNode>(DAG.getNode(S1));
+    EXPECT_THAT(NewMemSN->memPreds(),
+                testing::UnorderedElementsAre(S1MemN, S2MemN));
+    EXPECT_TRUE(S3MemN->hasMemPred(NewMemSN));
+    EXPECT_EQ(NewMemSN->getNumUnscheduledSuccs(), 1u);
   }
 
   {
@@ -851,9 +858,9 @@ define void @foo(ptr %ptr, ptr noalias %ptr2, i8 %v1, i8 %v2, i8 %v3, i8 %arg) {
     EXPECT_EQ(S3MemN->getNextNode(), NewMemSN);
     EXPECT_EQ(NewMemSN->getPrevNode(), S3MemN);
     EXPECT_EQ(NewMemSN->getNextNode(), nullptr);
+    // The new node is outside the DAG interval so it gets no dependencies.
+    EXPECT_TRUE(NewMemSN->memPreds().empty());
   }
-
-  // TODO: Check the dependencies to/from NewSN after they land.
 }
 
 TEST_F(DependencyGraphTest, EraseInstrCallback) {
@@ -887,11 +894,16 @@ define void @foo(ptr %ptr, i8 %v1, i8 %v2, i8 %v3, i8 %arg) {
   EXPECT_EQ(S1MemN->getNextNode(), S3MemN);
   EXPECT_EQ(S3MemN->getPrevNode(), S1MemN);
 
+  // Check the dependencies to/from the erased node.
+  EXPECT_THAT(S3MemN->memPreds(), testing::ElementsAre(S1MemN));
+  EXPECT_EQ(S1MemN->getNumUnscheduledSuccs(), 1u);
+
   // Check the chain when we erase the top node.
   S1->eraseFromParent();
   EXPECT_EQ(S3MemN->getPrevNode(), nullptr);
-
-  // TODO: Check the dependencies to/from NewSN after they land.
+  EXPECT_TRUE(S3MemN->memPreds().empty());
+  EXPECT_EQ(DAG.getInterval(),
+            sandboxir::Interval<sandboxir::Instruction>(S3, S3));
 }
 
 TEST_F(DependencyGraphTest, MoveInstrCallback) {
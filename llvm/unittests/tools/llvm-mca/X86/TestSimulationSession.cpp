@@ -0,0 +1,61 @@
+#include "MCTargetDesc/X86MCTargetDesc.h"
+#include "X86TestBase.h"
+#include "llvm/MC/MCInstBuilder.h"
+#include "llvm/MCA/SimulationSession.h"
+#include "llvm/Support/JSON.h"
+
+using namespace llvm;
+using namespace mca;
+
+TEST_F(X86TestBase, TestSimulationSessionMatchesBaseline) {
+  SmallVector<MCInst> MCIs;
+  getSimpleInsts(MCIs, /*Repeats=*/10);
+
+  // The baseline simulates a single iteration.
+  mca::SimulationSession Session(*STI, *MCII, *MRI, MCIA.get(),
+                                 getDefaultPipelineOptions(),
+                                 /*Iterations=*/1);
+  Expected<unsigned> Cycles = Session.simulate(MCIs);
+  ASSERT_TRUE(bool(Cycles));
+
+  json::Object BaselineResult;
+  auto E = runBaselineMCA(BaselineResult, MCIs);
+  ASSERT_FALSE(bool(E)) << "Failed to run baseline";
+  auto *BaselineObj = BaselineResult.getObject("SummaryView");
+  ASSERT_TRUE(BaselineObj) << "Does not contain SummaryView result";
+  auto BaselineCycles = BaselineObj->getInteger("TotalCycles");
+  ASSERT_TRUE(BaselineCycles);
+  ASSERT_EQ(*BaselineCycles, *Cycles);
+
+  // The state of the hardware doesn't leak from one query to the next.
+  Expected<unsigned> CyclesAgain = Session.simulate(MCIs);
+  ASSERT_TRUE(bool(CyclesAgain));
+  ASSERT_EQ(*Cycles, *CyclesAgain);
+}
+
+TEST_F(X86TestBase, TestSimulationSessionBatch) {
+  mca::SimulationSession Session(*STI, *MCII, *MRI, MCIA.get(),
+                                 getDefaultPipelineOptions());
+
+  SmallVector<MCInst> Short;
+  getSimpleInsts(Short, /*Repeats=*/1);
+  SmallVector<MCInst> Long;
+  getSimpleInsts(Long, /*Repeats=*/4);
+  SmallVector<MCInst> Independent;
+  for (MCRegister Reg : {X86::XMM2, X86::XMM3, X86::XMM4, X86::XMM5})
+    Independent.push_back(MCInstBuilder(X86::VMULPSrr)
+                              .addReg(Reg)
+                              .addReg(X86::XMM0)
+                              .addReg(X86::XMM1));
+
+  const ArrayRef<MCInst> Sequences[] = {Short, Long, Short, Independent};
+  SmallVector<double> RThroughputs;
+  ASSERT_FALSE(bool(Session.estimateThroughputs(Sequences, RThroughputs)));
+  ASSERT_EQ(RThroughputs.size(), 4U);
+
+  // Every query starts from an empty pipeline.
+  EXPECT_EQ(RThroughputs[0], RThroughputs[2]);
+  EXPECT_GT(RThroughputs[1], RThroughputs[0]);
+  // Multiplications don't use the port of the horizontal additions.
+  EXPECT_LT(RThroughputs[3], RThroughputs[1]);
+}
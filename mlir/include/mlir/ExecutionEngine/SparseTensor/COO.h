@@ -17,6 +17,7 @@
 #include <cassert>
 #include <cinttypes>
 #include <functional>
+#include <thread>
 #include <vector>
 
 namespace mlir {
@@ -129,15 +130,54 @@ public:
 
   /// Sorts elements lexicographically by coordinates. If a coordinate
   /// is mapped to multiple values, then the relative order of those
-  /// values is unspecified.
+  /// values is unspecified. Large tensors are sorted in chunks on
+  /// separate threads, which are then merged pairwise.
   void sort() {
     if (isSorted)
       return;
-    std::sort(elements.begin(), elements.end(), getElementLT());
+    const ElementLT<V> lt = getElementLT();
+    const uint64_t nse = elements.size();
+    uint64_t numChunks = std::thread::hardware_concurrency();
+    if (numChunks > nse / kMinParallelSortChunk)
+      numChunks = nse / kMinParallelSortChunk;
+    if (numChunks < 2) {
+      std::sort(elements.begin(), elements.end(), lt);
+      isSorted = true;
+      return;
+    }
+    // Sort the chunks concurrently.
+    const auto chunkBegin = [&](uint64_t c) {
+      return elements.begin() + c * nse / numChunks;
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(numChunks - 1);
+    for (uint64_t c = 1; c < numChunks; ++c)
+      threads.emplace_back(
+          [&, c]() { std::sort(chunkBegin(c), chunkBegin(c + 1), lt); });
+    std::sort(chunkBegin(0), chunkBegin(1), lt);
+    for (std::thread &t : threads)
+      t.join();
+    // Merge adjacent runs, doubling their length in every round. The merges
+    // of one round are disjoint, so they also run concurrently.
+    for (uint64_t width = 1; width < numChunks; width *= 2) {
+      threads.clear();
+      for (uint64_t c = 0; c + width < numChunks; c += 2 * width) {
+        const uint64_t end = std::min(c + 2 * width, numChunks);
+        threads.emplace_back([&, c, width, end]() {
+          std::inplace_merge(chunkBegin(c), chunkBegin(c + width),
+                             chunkBegin(end), lt);
+        });
+      }
+      for (std::thread &t : threads)
+        t.join();
+    }
     isSorted = true;
   }
 
 private:
+  /// The minimal number of elements sorted by every thread.
+  static constexpr uint64_t kMinParallelSortChunk = 1 << 16;
+
   const std::vector<uint64_t> dimSizes; // per-dimension sizes
   std::vector<Element<V>> elements;     // all COO elements
   std::vector<uint64_t> coordinates;    // shared coordinate pool
@@ -39,6 +39,18 @@ enum class GreedySimplifyRegionLevel {
   Aggressive
 };
 
+/// Counters of the work done by greedy pattern rewrites.
+struct GreedyRewriteStats {
+  /// The number of iterations over the region.
+  int64_t numIterations = 0;
+  /// The number of ops popped from the worklist.
+  int64_t numProcessedOps = 0;
+  /// The number of patterns that were tried on an op.
+  int64_t numMatchAttempts = 0;
+  /// The number of successful pattern applications and folds.
+  int64_t numRewrites = 0;
+};
+
 /// This class allows control over how the GreedyPatternRewriteDriver works.
 class GreedyRewriteConfig {
 public:
@@ -65,6 +77,16 @@ public:
   /// Note: Only applicable when simplifying entire regions.
   int64_t maxIterations = 10;
 
+  /// When set to true, only the first iteration populates the worklist with
+  /// all ops of the region. The following iterations start with the ops that
+  /// were inserted or modified during the previous one, and the users of
+  /// their results, so that their cost is proportional to the changes. When
+  /// set to false, every iteration visits all ops again, which may catch
+  /// patterns that depend on IR that isn't reachable through use-def chains.
+  ///
+  /// Note: Only applicable when simplifying entire regions.
+  bool incrementalIterations = false;
+
   /// This specifies the maximum number of rewrites within an iteration. Use
   /// `kNoLimit` to disable this limit.
   int64_t maxNumRewrites = kNoLimit;
@@ -92,6 +114,9 @@ public:
   /// An optional listener that should be notified about IR modifications.
   RewriterBase::Listener *listener = nullptr;
 
+  /// If set, the counters of the work done by the rewrite are added to it.
+  GreedyRewriteStats *stats = nullptr;
+
   /// Whether this should fold while greedily rewriting.
   bool fold = true;
 
@@ -16,6 +16,7 @@
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <mutex>
@@ -23,7 +24,7 @@
 #include <vector>
 
 #include "llvm/ADT/StringMap.h"
-#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 using namespace mlir::runtime;
 
@@ -38,6 +39,150 @@ namespace {
 // Forward declare class defined below.
 class RefCounted;
 
+// -------------------------------------------------------------------------- //
+// Scheduler runs the async tasks on a fixed set of worker threads. Every worker
+// owns a queue: tasks scheduled from a worker are pushed to its own queue and
+// popped in LIFO order, which keeps the data of the parent task in cache, while
+// idle workers steal the oldest tasks from the queues of the other workers.
+// Tasks scheduled from other threads are distributed round-robin.
+// -------------------------------------------------------------------------- //
+
+class Scheduler {
+public:
+  explicit Scheduler(unsigned numWorkers) : queues(numWorkers) {
+    workers.reserve(numWorkers);
+    for (unsigned i = 0; i < numWorkers; ++i)
+      workers.emplace_back([this, i]() { runWorker(i); });
+  }
+
+  ~Scheduler() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMu);
+      stopping = true;
+    }
+    sleepCv.notify_all();
+    for (std::thread &worker : workers)
+      worker.join();
+  }
+
+  unsigned getNumWorkers() const { return queues.size(); }
+
+  // Returns true if the calling thread is a worker of this scheduler.
+  bool isWorkerThread() const { return currentScheduler == this; }
+
+  void schedule(std::function<void()> task) {
+    numUnfinished.fetch_add(1);
+    unsigned index = isWorkerThread() ? currentWorker
+                                      : nextQueue.fetch_add(1) % queues.size();
+    {
+      std::lock_guard<std::mutex> lock(queues[index].mu);
+      queues[index].tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleepMu);
+      ++numQueued;
+    }
+    sleepCv.notify_one();
+  }
+
+  // Runs one of the queued tasks on the calling worker thread. Returns false
+  // if there was none. Used to keep the worker busy while it blocks on an
+  // async value, which may otherwise deadlock when all workers are blocked.
+  bool runOneTask() {
+    assert(isWorkerThread() && "expected to be called on a worker thread");
+    std::function<void()> task;
+    if (!takeTask(currentWorker, task))
+      return false;
+    runTask(task);
+    return true;
+  }
+
+  // Waits for the completion of all scheduled tasks.
+  void wait() {
+    std::unique_lock<std::mutex> lock(doneMu);
+    doneCv.wait(lock, [this] { return numUnfinished.load() == 0; });
+  }
+
+private:
+  struct Queue {
+    std::mutex mu;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  // Pops a task from the queue of the worker `index`, or steals one from
+  // the other workers.
+  bool takeTask(unsigned index, std::function<void()> &task) {
+    {
+      Queue &own = queues[index];
+      std::lock_guard<std::mutex> lock(own.mu);
+      if (!own.tasks.empty()) {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        --numQueued;
+        return true;
+      }
+    }
+    for (unsigned i = 1, e = queues.size(); i < e; ++i) {
+      Queue &victim = queues[(index + i) % e];
+      std::lock_guard<std::mutex> lock(victim.mu);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        --numQueued;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void runTask(std::function<void()> &task) {
+    task();
+    task = nullptr;
+    if (numUnfinished.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> lock(doneMu);
+      doneCv.notify_all();
+    }
+  }
+
+  void runWorker(unsigned index) {
+    currentScheduler = this;
+    currentWorker = index;
+    std::function<void()> task;
+    for (;;) {
+      if (takeTask(index, task)) {
+        runTask(task);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleepMu);
+      sleepCv.wait(lock, [this] { return numQueued.load() > 0 || stopping; });
+      if (stopping && numQueued.load() == 0)
+        return;
+    }
+  }
+
+  static thread_local const Scheduler *currentScheduler;
+  static thread_local unsigned currentWorker;
+
+  std::vector<Queue> queues;
+  std::vector<std::thread> workers;
+  std::atomic<unsigned> nextQueue = 0;
+
+  // The number of queued tasks. It is only incremented under `sleepMu`, so
+  // that the workers going to sleep don't miss new tasks.
+  std::atomic<int64_t> numQueued = 0;
+  std::mutex sleepMu;
+  std::condition_variable sleepCv;
+  bool stopping = false;
+
+  // The number of scheduled tasks that didn't complete yet.
+  std::atomic<int64_t> numUnfinished = 0;
+  std::mutex doneMu;
+  std::condition_variable doneCv;
+};
+
+thread_local const Scheduler *Scheduler::currentScheduler = nullptr;
+thread_local unsigned Scheduler::currentWorker = 0;
+
 // -------------------------------------------------------------------------- //
 // AsyncRuntime orchestrates all async operations and Async runtime API is built
 // on top of the default runtime instance.
@@ -45,10 +190,12 @@ class RefCounted;
 
 class AsyncRuntime {
 public:
-  AsyncRuntime() : numRefCountedObjects(0) {}
+  AsyncRuntime()
+      : numRefCountedObjects(0),
+        scheduler(llvm::hardware_concurrency().compute_thread_count()) {}
 
   ~AsyncRuntime() {
-    threadPool.wait(); // wait for the completion of all async tasks
+    scheduler.wait(); // wait for the completion of all async tasks
     assert(getNumRefCountedObjects() == 0 &&
            "all ref counted objects must be destroyed");
   }
@@ -57,7 +204,7 @@ public:
     return numRefCountedObjects.load(std::memory_order_relaxed);
   }
 
-  llvm::ThreadPoolInterface &getThreadPool() { return threadPool; }
+  Scheduler &getScheduler() { return scheduler; }
 
 private:
   friend class RefCounted;
@@ -72,7 +219,7 @@ private:
   }
 
   std::atomic<int64_t> numRefCountedObjects;
-  llvm::DefaultThreadPool threadPool;
+  Scheduler scheduler;
 };
 
 // -------------------------------------------------------------------------- //
@@ -366,24 +513,41 @@ extern "C" bool mlirAsyncRuntimeIsGroupError(AsyncGroup *group) {
   return group->numErrors.load() > 0;
 }
 
+// Blocks the caller until `isReady` returns true. Worker threads run the
+// queued tasks meanwhile instead of sleeping, as the value they wait for may
+// only be produced by one of those tasks.
+template <typename T, typename IsReady>
+static void blockingAwait(T *object, IsReady isReady) {
+  Scheduler &scheduler = getDefaultAsyncRuntime()->getScheduler();
+  if (scheduler.isWorkerThread()) {
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(object->mu);
+        if (isReady())
+          return;
+      }
+      if (!scheduler.runOneTask())
+        std::this_thread::yield();
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(object->mu);
+  if (!isReady())
+    object->cv.wait(lock, isReady);
+}
+
 extern "C" void mlirAsyncRuntimeAwaitToken(AsyncToken *token) {
-  std::unique_lock<std::mutex> lock(token->mu);
-  if (!State(token->state).isAvailableOrError())
-    token->cv.wait(
-        lock, [token] { return State(token->state).isAvailableOrError(); });
+  blockingAwait(token,
+                [token] { return State(token->state).isAvailableOrError(); });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitValue(AsyncValue *value) {
-  std::unique_lock<std::mutex> lock(value->mu);
-  if (!State(value->state).isAvailableOrError())
-    value->cv.wait(
-        lock, [value] { return State(value->state).isAvailableOrError(); });
+  blockingAwait(value,
+                [value] { return State(value->state).isAvailableOrError(); });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitAllInGroup(AsyncGroup *group) {
-  std::unique_lock<std::mutex> lock(group->mu);
-  if (group->pendingTokens != 0)
-    group->cv.wait(lock, [group] { return group->pendingTokens == 0; });
+  blockingAwait(group, [group] { return group->pendingTokens == 0; });
 }
 
 // Returns a pointer to the storage owned by the async value.
@@ -394,7 +558,7 @@ extern "C" ValueStorage mlirAsyncRuntimeGetValueStorage(AsyncValue *value) {
 
 extern "C" void mlirAsyncRuntimeExecute(CoroHandle handle, CoroResume resume) {
   auto *runtime = getDefaultAsyncRuntime();
-  runtime->getThreadPool().async([handle, resume]() { (*resume)(handle); });
+  runtime->getScheduler().schedule([handle, resume]() { (*resume)(handle); });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitTokenAndExecute(AsyncToken *token,
@@ -437,7 +601,7 @@ extern "C" void mlirAsyncRuntimeAwaitAllInGroupAndExecute(AsyncGroup *group,
 }
 
 extern "C" int64_t mlirAsyncRuntimGetNumWorkerThreads() {
-  return getDefaultAsyncRuntime()->getThreadPool().getMaxConcurrency();
+  return getDefaultAsyncRuntime()->getScheduler().getNumWorkers();
 }
 
 //===----------------------------------------------------------------------===//
@@ -20,11 +20,13 @@
 #include "mlir/Support/FileUtilities.h"
 #include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Sequence.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/CrashRecoveryContext.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include <optional>
@@ -800,7 +802,28 @@ void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
   std::vector<std::atomic<bool>> activePMs(asyncExecutors.size());
   std::fill(activePMs.begin(), activePMs.end(), false);
   std::atomic<bool> hasFailure = false;
-  parallelForEach(context, opInfos, [&](OpPMInfo &opInfo) {
+
+  // The threads pick the operations in order, so when there are more
+  // operations than threads, start with the largest ones. Otherwise a large
+  // operation picked last keeps a single thread busy while the others are
+  // idle. The size of an operation, i.e. the number of nested operations, is
+  // used as an estimate of its cost.
+  SmallVector<unsigned> schedule =
+      llvm::to_vector(llvm::seq<unsigned>(0, opInfos.size()));
+  if (opInfos.size() > asyncExecutors.size()) {
+    SmallVector<size_t> costs;
+    costs.reserve(opInfos.size());
+    for (OpPMInfo &opInfo : opInfos) {
+      size_t cost = 0;
+      opInfo.op->walk([&](Operation *) { ++cost; });
+      costs.push_back(cost);
+    }
+    llvm::stable_sort(schedule, [&](unsigned lhs, unsigned rhs) {
+      return costs[lhs] > costs[rhs];
+    });
+  }
+
+  auto runOnOpInfo = [&](OpPMInfo &opInfo) {
     // Find an executor for this operation.
     auto it = llvm::find_if(activePMs, [](std::atomic<bool> &isActive) {
       bool expectedInactive = false;
@@ -818,7 +841,36 @@ void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
 
     // Reset the active bit for this pass manager.
     activePMs[pmIndex].store(false);
-  });
+  };
+
+  if (opInfos.size() <= 1) {
+    for (OpPMInfo &opInfo : opInfos)
+      runOnOpInfo(opInfo);
+    if (hasFailure)
+      signalPassFailure();
+    return;
+  }
+
+  // Diagnostics are still ordered by the position of the operations within
+  // the IR, not by the schedule.
+  ParallelDiagnosticHandler diagHandler(context);
+  std::atomic<unsigned> nextIndex(0);
+  auto processFn = [&] {
+    for (unsigned index = nextIndex++; index < schedule.size();
+         index = nextIndex++) {
+      diagHandler.setOrderIDForThread(schedule[index]);
+      runOnOpInfo(opInfos[schedule[index]]);
+      diagHandler.eraseOrderIDForThread();
+    }
+  };
+  llvm::ThreadPoolInterface &threadPool = context->getThreadPool();
+  llvm::ThreadPoolTaskGroup tasksGroup(threadPool);
+  size_t numActions = std::min<size_t>(opInfos.size(), asyncExecutors.size());
+  for (size_t i = 0; i < numActions; ++i)
+    tasksGroup.async(processFn);
+  // Waiting for the task group lets this thread process tasks of the group
+  // too, if it's a worker thread of the pool itself.
+  tasksGroup.wait();
 
   // Signal a failure if any of the executors failed.
   if (hasFailure)
@@ -14,6 +14,8 @@
 #include "mlir/Rewrite/PatternApplicator.h"
 #include "ByteCode.h"
 #include "llvm/Support/Debug.h"
+#include <algorithm>
+#include <iterator>
 
 #define DEBUG_TYPE "pattern-application"
 
@@ -112,6 +114,22 @@ void PatternApplicator::applyCostModel(CostModel model) {
   for (auto &it : patterns)
     processPatternList(it.second);
   processPatternList(anyOpPatterns);
+
+  // Merge the operation agnostic patterns into the lists of the specific
+  // operations once, instead of interleaving them on every match. Ties go to
+  // the operation specific patterns, as in `matchAndRewrite`.
+  if (anyOpPatterns.empty())
+    return;
+  SmallVector<const RewritePattern *> merged;
+  for (auto &it : patterns) {
+    merged.clear();
+    std::merge(it.second.begin(), it.second.end(), anyOpPatterns.begin(),
+               anyOpPatterns.end(), std::back_inserter(merged),
+               [](const RewritePattern *lhs, const RewritePattern *rhs) {
+                 return lhs->getBenefit() > rhs->getBenefit();
+               });
+    it.second.assign(merged.begin(), merged.end());
+  }
 }
 
 void PatternApplicator::walkAllPatterns(
@@ -141,15 +159,16 @@ LogicalResult PatternApplicator::matchAndRewrite(
     bytecode->match(op, rewriter, pdlMatches, *mutableByteCodeState);
 
   // Check to see if there are patterns matching this specific operation type.
-  MutableArrayRef<const RewritePattern *> opPatterns;
+  // Their list already includes the operation agnostic patterns, in benefit
+  // order, so only the operation agnostic patterns apply otherwise.
+  MutableArrayRef<const RewritePattern *> opPatterns = anyOpPatterns;
   auto patternIt = patterns.find(op->getName());
   if (patternIt != patterns.end())
     opPatterns = patternIt->second;
 
-  // Process the patterns for that match the specific operation type, and any
-  // operation type in an interleaved fashion.
+  // Process the native patterns and the PDL patterns in an interleaved
+  // fashion.
   unsigned opIt = 0, opE = opPatterns.size();
-  unsigned anyIt = 0, anyE = anyOpPatterns.size();
   unsigned pdlIt = 0, pdlE = pdlMatches.size();
   LogicalResult result = failure();
   do {
@@ -157,16 +176,9 @@ LogicalResult PatternApplicator::matchAndRewrite(
     const Pattern *bestPattern = nullptr;
     unsigned *bestPatternIt = &opIt;
 
-    /// Operation specific patterns.
+    /// Native patterns.
     if (opIt < opE)
       bestPattern = opPatterns[opIt];
-    /// Operation agnostic patterns.
-    if (anyIt < anyE &&
-        (!bestPattern ||
-         bestPattern->getBenefit() < anyOpPatterns[anyIt]->getBenefit())) {
-      bestPatternIt = &anyIt;
-      bestPattern = anyOpPatterns[anyIt];
-    }
 
     const PDLByteCode::MatchResult *pdlMatch = nullptr;
     /// PDL patterns.
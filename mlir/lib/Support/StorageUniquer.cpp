@@ -11,7 +11,9 @@
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/ThreadLocalCache.h"
 #include "mlir/Support/TypeID.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/RWMutex.h"
+#include "llvm/Support/Threading.h"
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -109,11 +111,23 @@ private:
 
 public:
 #if LLVM_ENABLE_THREADS != 0
+  /// Return the default number of shards. The readers of a shard all update
+  /// the state of its mutex, so the shards are scaled with the number of
+  /// hardware threads to keep the threads that miss their local cache from
+  /// contending. The shards themselves are allocated lazily.
+  static size_t getDefaultNumShards() {
+    static const size_t numShards = [] {
+      uint64_t numThreads = llvm::hardware_concurrency().compute_thread_count();
+      return std::clamp<uint64_t>(llvm::PowerOf2Ceil(2 * numThreads), 8, 256);
+    }();
+    return numShards;
+  }
+
   /// Initialize the storage uniquer with a given number of storage shards to
   /// use. The provided shard number is required to be a valid power of 2. The
   /// destructor function is used to destroy any allocated storage instances.
   ParametricStorageUniquer(function_ref<void(BaseStorage *)> destructorFn,
-                           size_t numShards = 8)
+                           size_t numShards = getDefaultNumShards())
       : shards(new std::atomic<Shard *>[numShards]), numShards(numShards),
         destructorFn(destructorFn) {
     assert(llvm::isPowerOf2_64(numShards) &&
@@ -35,6 +35,7 @@ struct Canonicalizer : public impl::CanonicalizerBase<Canonicalizer> {
     this->enableRegionSimplification = config.enableRegionSimplification;
     this->maxIterations = config.maxIterations;
     this->maxNumRewrites = config.maxNumRewrites;
+    this->incrementalIterations = config.incrementalIterations;
     this->disabledPatterns = disabledPatterns;
     this->enabledPatterns = enabledPatterns;
   }
@@ -47,6 +48,7 @@ struct Canonicalizer : public impl::CanonicalizerBase<Canonicalizer> {
     config.enableRegionSimplification = enableRegionSimplification;
     config.maxIterations = maxIterations;
     config.maxNumRewrites = maxNumRewrites;
+    config.incrementalIterations = incrementalIterations;
 
     RewritePatternSet owningPatterns(context);
     for (auto *dialect : context->getLoadedDialects())
@@ -59,8 +61,15 @@ struct Canonicalizer : public impl::CanonicalizerBase<Canonicalizer> {
     return success();
   }
   void runOnOperation() override {
+    GreedyRewriteStats stats;
+    GreedyRewriteConfig runConfig = config;
+    runConfig.stats = &stats;
     LogicalResult converged =
-        applyPatternsGreedily(getOperation(), *patterns, config);
+        applyPatternsGreedily(getOperation(), *patterns, runConfig);
+    numIterations += stats.numIterations;
+    numProcessedOps += stats.numProcessedOps;
+    numMatchAttempts += stats.numMatchAttempts;
+    numRewrites += stats.numRewrites;
     // Canonicalization is best-effort. Non-convergence is not a pass failure.
     if (testConvergence && failed(converged))
       signalPassFailure();
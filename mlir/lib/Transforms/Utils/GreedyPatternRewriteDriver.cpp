@@ -375,6 +375,10 @@ protected:
   /// `config.strictMode` is GreedyRewriteStrictness::AnyOp.
   llvm::SmallDenseSet<Operation *, 4> strictModeFilteredOps;
 
+  /// The ops that were inserted or modified since the worklist was populated.
+  /// This is only maintained when `config.incrementalIterations` is set.
+  Worklist changedOps;
+
 private:
   /// Look over the provided operands for any defining operations that should
   /// be re-added to the worklist. This function should be called when an
@@ -458,6 +462,8 @@ bool GreedyPatternRewriteDriver::processWorklist() {
          (numRewrites < config.maxNumRewrites ||
           config.maxNumRewrites == GreedyRewriteConfig::kNoLimit)) {
     auto *op = worklist.pop();
+    if (config.stats)
+      ++config.stats->numProcessedOps;
 
     LLVM_DEBUG({
       logger.getOStream() << "\n";
@@ -499,6 +505,8 @@ bool GreedyPatternRewriteDriver::processWorklist() {
           // Op was modified in-place.
           notifyOperationModified(op);
           changed = true;
+          if (config.stats)
+            ++config.stats->numRewrites;
           LLVM_DEBUG(logSuccessfulFolding(dumpRootOp));
 #if MLIR_ENABLE_EXPENSIVE_PATTERN_API_CHECKS
           expensiveChecks.notifyFoldingSuccess();
@@ -553,6 +561,8 @@ bool GreedyPatternRewriteDriver::processWorklist() {
         if (materializationSucceeded) {
           rewriter.replaceOp(op, replacements);
           changed = true;
+          if (config.stats)
+            ++config.stats->numRewrites;
           LLVM_DEBUG(logSuccessfulFolding(dumpRootOp));
 #if MLIR_ENABLE_EXPENSIVE_PATTERN_API_CHECKS
           expensiveChecks.notifyFoldingSuccess();
@@ -576,6 +586,8 @@ bool GreedyPatternRewriteDriver::processWorklist() {
       });
       if (config.listener)
         config.listener->notifyPatternBegin(pattern, op);
+      if (config.stats)
+        ++config.stats->numMatchAttempts;
       return true;
     };
     function_ref<bool(const Pattern &)> canApply = canApplyCallback;
@@ -595,8 +607,8 @@ bool GreedyPatternRewriteDriver::processWorklist() {
 
 #ifdef NDEBUG
     // Optimization: PatternApplicator callbacks are not needed when running in
-    // optimized mode and without a listener.
-    if (!config.listener) {
+    // optimized mode and without a listener or stats.
+    if (!config.listener && !config.stats) {
       canApply = nullptr;
       onFailure = nullptr;
       onSuccess = nullptr;
@@ -621,6 +633,8 @@ bool GreedyPatternRewriteDriver::processWorklist() {
 #endif // MLIR_ENABLE_EXPENSIVE_PATTERN_API_CHECKS
       changed = true;
       ++numRewrites;
+      if (config.stats)
+        ++config.stats->numRewrites;
     } else {
       LLVM_DEBUG(logResultWithLine("failure", "pattern failed to match"));
 #if MLIR_ENABLE_EXPENSIVE_PATTERN_API_CHECKS
@@ -678,6 +692,8 @@ void GreedyPatternRewriteDriver::notifyOperationInserted(
     config.listener->notifyOperationInserted(op, previous);
   if (config.strictMode == GreedyRewriteStrictness::ExistingAndNewOps)
     strictModeFilteredOps.insert(op);
+  if (config.incrementalIterations)
+    changedOps.push(op);
   addToWorklist(op);
 }
 
@@ -688,6 +704,8 @@ void GreedyPatternRewriteDriver::notifyOperationModified(Operation *op) {
   });
   if (config.listener)
     config.listener->notifyOperationModified(op);
+  if (config.incrementalIterations)
+    changedOps.push(op);
   addToWorklist(op);
 }
 
@@ -746,6 +764,8 @@ void GreedyPatternRewriteDriver::notifyOperationErased(Operation *op) {
 
   addOperandsToWorklist(op);
   worklist.remove(op);
+  if (config.incrementalIterations)
+    changedOps.remove(op);
 
   if (config.strictMode != GreedyRewriteStrictness::AnyOp)
     strictModeFilteredOps.erase(op);
@@ -827,15 +847,51 @@ LogicalResult RegionPatternRewriteDriver::simplify(bool *changed) && {
   bool continueRewrites = false;
   int64_t iteration = 0;
   MLIRContext *ctx = rewriter.getContext();
+  auto runIteration = [&] {
+    // The changes from the previous iteration are on the worklist.
+    changedOps.clear();
+    ctx->executeAction<GreedyPatternRewriteIteration>(
+        [&] {
+          continueRewrites = processWorklist();
+
+          // After applying patterns, make sure that the CFG of each of the
+          // regions is kept up to date.
+          if (config.enableRegionSimplification !=
+              GreedySimplifyRegionLevel::Disabled) {
+            continueRewrites |= succeeded(simplifyRegions(
+                rewriter, region,
+                /*mergeBlocks=*/config.enableRegionSimplification ==
+                    GreedySimplifyRegionLevel::Aggressive));
+          }
+        },
+        {&region}, iteration);
+  };
   do {
     // Check if the iteration limit was reached.
     if (++iteration > config.maxIterations &&
         config.maxIterations != GreedyRewriteConfig::kNoLimit)
       break;
 
+    if (config.stats)
+      ++config.stats->numIterations;
+
     // New iteration: start with an empty worklist.
     worklist.clear();
 
+    // After the first iteration, only revisit the ops that changed, and their
+    // users. The users are pushed first, so that each op is processed before
+    // its users.
+    if (config.incrementalIterations && iteration > 1) {
+      while (!changedOps.empty()) {
+        Operation *op = changedOps.pop();
+        for (Operation *user : op->getUsers())
+          addToWorklist(user);
+        addToWorklist(op);
+      }
+      runIteration();
+      continue;
+    }
+
     // `OperationFolder` CSE's constant ops (and may move them into parents
     // regions to enable more aggressive CSE'ing).
     OperationFolder folder(ctx, this);
@@ -869,21 +925,7 @@ LogicalResult RegionPatternRewriteDriver::simplify(bool *changed) && {
       worklist.reverse();
     }
 
-    ctx->executeAction<GreedyPatternRewriteIteration>(
-        [&] {
-          continueRewrites = processWorklist();
-
-          // After applying patterns, make sure that the CFG of each of the
-          // regions is kept up to date.
-          if (config.enableRegionSimplification !=
-              GreedySimplifyRegionLevel::Disabled) {
-            continueRewrites |= succeeded(simplifyRegions(
-                rewriter, region,
-                /*mergeBlocks=*/config.enableRegionSimplification ==
-                    GreedySimplifyRegionLevel::Aggressive));
-          }
-        },
-        {&region}, iteration);
+    runIteration();
   } while (continueRewrites);
 
   if (changed)
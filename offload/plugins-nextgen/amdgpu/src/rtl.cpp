@@ -716,13 +716,20 @@ struct AMDGPUQueueTy {
   /// Increase user count of the queue object.
   void addUser() { ++NumUsers; }
 
+  /// Sentinel for the id of a packet that was not pushed to this queue.
+  static constexpr uint64_t InvalidPacketId = UINT64_MAX;
+
   /// Push a kernel launch to the queue. The kernel launch requires an output
-  /// signal and can define an optional input signal (nullptr if none).
+  /// signal and can define an optional input signal (nullptr if none). If the
+  /// input signal is the completion signal of a packet pushed to this queue,
+  /// \p InputPacketId is the id of that packet. The id of the kernel packet is
+  /// returned in \p PacketId.
   Error pushKernelLaunch(const AMDGPUKernelTy &Kernel, void *KernelArgs,
                          uint32_t NumThreads[3], uint32_t NumBlocks[3],
                          uint32_t GroupSize, uint64_t StackSize,
                          AMDGPUSignalTy *OutputSignal,
-                         AMDGPUSignalTy *InputSignal) {
+                         AMDGPUSignalTy *InputSignal, uint64_t InputPacketId,
+                         uint64_t &PacketId) {
     assert(OutputSignal && "Invalid kernel output signal");
 
     // Lock the queue during the packet publishing process. Notice this blocks
@@ -731,17 +738,24 @@ struct AMDGPUQueueTy {
     std::lock_guard<std::mutex> Lock(Mutex);
     assert(Queue && "Interacted with a non-initialized queue!");
 
-    // Add a barrier packet before the kernel packet in case there is a pending
-    // preceding operation. The barrier packet will delay the processing of
-    // subsequent queue's packets until the barrier input signal are satisfied.
-    // No need output signal needed because the dependency is already guaranteed
-    // by the queue barrier itself.
-    if (InputSignal && InputSignal->load())
-      if (auto Err = pushBarrierImpl(nullptr, InputSignal))
+    // Wait for a pending preceding operation. If it is the last packet of the
+    // queue, typically the previous kernel of the same stream, setting the
+    // barrier bit of the kernel packet is enough: the packet processor will not
+    // launch the kernel until all preceding packets completed. Otherwise, add a
+    // barrier packet that delays the processing of subsequent queue's packets
+    // until the barrier input signal is satisfied. No output signal needed
+    // because the dependency is already guaranteed by the queue barrier itself.
+    // The doorbell is rung once for both packets.
+    bool UseBarrierBit = false;
+    if (InputSignal && InputSignal->load()) {
+      if (InputPacketId != InvalidPacketId && InputPacketId == LastPacketId)
+        UseBarrierBit = true;
+      else if (auto Err = pushBarrierImpl(nullptr, InputSignal, nullptr,
+                                          /*RingDoorbell=*/false))
         return Err;
+    }
 
     // Now prepare the kernel packet.
-    uint64_t PacketId;
     hsa_kernel_dispatch_packet_t *Packet = acquirePacket(PacketId);
     assert(Packet && "Invalid packet");
 
@@ -767,7 +781,7 @@ struct AMDGPUQueueTy {
     Packet->completion_signal = OutputSignal->get();
 
     // Publish the packet. Do not modify the packet after this point.
-    publishKernelPacket(PacketId, Setup, Packet);
+    publishKernelPacket(PacketId, Setup, Packet, UseBarrierBit);
 
     return Plugin::success();
   }
@@ -787,10 +801,12 @@ struct AMDGPUQueueTy {
 
 private:
   /// Push a barrier packet that will wait up to two input signals. Assumes the
-  /// the queue lock is acquired.
+  /// the queue lock is acquired. The doorbell may be left to the next packet
+  /// if it is published right after.
   Error pushBarrierImpl(AMDGPUSignalTy *OutputSignal,
                         const AMDGPUSignalTy *InputSignal1,
-                        const AMDGPUSignalTy *InputSignal2 = nullptr) {
+                        const AMDGPUSignalTy *InputSignal2 = nullptr,
+                        bool RingDoorbell = true) {
     // Add a queue barrier waiting on both the other stream's operation and the
     // last operation on the current stream (if any).
     uint64_t PacketId;
@@ -817,7 +833,7 @@ private:
       Packet->dep_signal[1] = InputSignal2->get();
 
     // Publish the packet. Do not modify the packet after this point.
-    publishBarrierPacket(PacketId, Packet);
+    publishBarrierPacket(PacketId, Packet, RingDoorbell);
 
     return Plugin::success();
   }
@@ -829,6 +845,7 @@ private:
     // Increase the queue index with relaxed memory order. Notice this will need
     // another subsequent atomic operation with acquire order.
     PacketId = hsa_queue_add_write_index_relaxed(Queue, 1);
+    LastPacketId = PacketId;
 
     // Wait for the package to be available. Notice the atomic operation uses
     // the acquire memory order.
@@ -845,10 +862,13 @@ private:
   /// the kernel launch. Do not modify the packet once this function is called.
   /// Assumes the queue lock is acquired.
   void publishKernelPacket(uint64_t PacketId, uint16_t Setup,
-                           hsa_kernel_dispatch_packet_t *Packet) {
+                           hsa_kernel_dispatch_packet_t *Packet,
+                           bool Barrier) {
     uint32_t *PacketPtr = reinterpret_cast<uint32_t *>(Packet);
 
     uint16_t Header = HSA_PACKET_TYPE_KERNEL_DISPATCH << HSA_PACKET_HEADER_TYPE;
+    if (Barrier)
+      Header |= 1 << HSA_PACKET_HEADER_BARRIER;
     Header |= HSA_FENCE_SCOPE_SYSTEM << HSA_PACKET_HEADER_ACQUIRE_FENCE_SCOPE;
     Header |= HSA_FENCE_SCOPE_SYSTEM << HSA_PACKET_HEADER_RELEASE_FENCE_SCOPE;
 
@@ -863,8 +883,8 @@ private:
   /// Publish the barrier packet so that the HSA runtime can start processing
   /// the barrier. Next packets in the queue will not be processed until all
   /// barrier dependencies (signals) are satisfied. Assumes the queue is locked
-  void publishBarrierPacket(uint64_t PacketId,
-                            hsa_barrier_and_packet_t *Packet) {
+  void publishBarrierPacket(uint64_t PacketId, hsa_barrier_and_packet_t *Packet,
+                            bool RingDoorbell) {
     uint32_t *PacketPtr = reinterpret_cast<uint32_t *>(Packet);
     uint16_t Setup = 0;
     uint16_t Header = HSA_PACKET_TYPE_BARRIER_AND << HSA_PACKET_HEADER_TYPE;
@@ -876,7 +896,8 @@ private:
     __atomic_store_n(PacketPtr, HeaderWord, __ATOMIC_RELEASE);
 
     // Signal the doorbell about the published packet.
-    hsa_signal_store_relaxed(Queue->doorbell_signal, PacketId);
+    if (RingDoorbell)
+      hsa_signal_store_relaxed(Queue->doorbell_signal, PacketId);
   }
 
   /// Callack that will be called when an error is detected on the HSA queue.
@@ -900,6 +921,9 @@ private:
   /// The number of streams, this queue is currently assigned to. A queue is
   /// considered idle when this is zero, otherwise: busy.
   uint32_t NumUsers;
+
+  /// The id of the last packet acquired on the queue. Protected by the mutex.
+  uint64_t LastPacketId = InvalidPacketId;
 };
 
 /// Struct that implements a stream of asynchronous operations for AMDGPU
@@ -943,6 +967,10 @@ private:
     /// operation as input signal.
     AMDGPUSignalTy *Signal;
 
+    /// The id of the queue packet of the operation if it is a kernel launch,
+    /// AMDGPUQueueTy::InvalidPacketId otherwise.
+    uint64_t PacketId;
+
     /// The actions that must be performed after the operation's completion. Set
     /// to nullptr when there is no action to perform.
     llvm::SmallVector<AMDGPUStreamCallbackTy *> Callbacks;
@@ -959,7 +987,9 @@ private:
     llvm::SmallVector<ActionArgsTy> ActionArgs;
 
     /// Create an empty slot.
-    StreamSlotTy() : Signal(nullptr), Callbacks({}), ActionArgs({}) {}
+    StreamSlotTy()
+        : Signal(nullptr), PacketId(AMDGPUQueueTy::InvalidPacketId),
+          Callbacks({}), ActionArgs({}) {}
 
     /// Schedule a host memory copy action on the slot.
     Error schedHostMemoryCopy(void *Dst, const void *Src, size_t Size) {
@@ -1089,6 +1119,7 @@ private:
 
     // Set the output signal of the current slot.
     Slots[Curr].Signal = OutputSignal;
+    Slots[Curr].PacketId = AMDGPUQueueTy::InvalidPacketId;
 
     return std::make_pair(Curr, InputSignal);
   }
@@ -1266,10 +1297,14 @@ public:
     if (auto Err = Slots[Curr].schedReleaseBuffer(KernelArgs, MemoryManager))
       return Err;
 
-    // Push the kernel with the output signal and an input signal (optional)
+    // Push the kernel with the output signal and an input signal (optional).
+    // Back-to-back kernels of the stream only need the queue's barrier bit.
+    uint64_t InputPacketId =
+        Curr > 0 ? Slots[Curr - 1].PacketId : AMDGPUQueueTy::InvalidPacketId;
     return Queue->pushKernelLaunch(Kernel, KernelArgs, NumThreads, NumBlocks,
                                    GroupSize, StackSize, OutputSignal,
-                                   InputSignal);
+                                   InputSignal, InputPacketId,
+                                   Slots[Curr].PacketId);
   }
 
   /// Push an asynchronous memory copy between pinned memory buffers.
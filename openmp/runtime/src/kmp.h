@@ -2433,6 +2433,7 @@ extern kmp_tasking_mode_t
     __kmp_tasking_mode; /* determines how/when to execute tasks */
 extern int __kmp_task_stealing_constraint;
 extern int __kmp_enable_task_throttling;
+extern int __kmp_task_locality; /* steal from the closest threads first */
 extern kmp_int32 __kmp_default_device; // Set via OMP_DEFAULT_DEVICE if
 // specified, defaults to 0 otherwise
 // Set via OMP_MAX_TASK_PRIORITY if specified, defaults to 0 otherwise
@@ -3933,6 +3934,13 @@ extern int __kmp_aux_set_affinity_mask_proc(int proc, void **mask);
 extern int __kmp_aux_unset_affinity_mask_proc(int proc, void **mask);
 extern int __kmp_aux_get_affinity_mask_proc(int proc, void **mask);
 extern void __kmp_balanced_affinity(kmp_info_t *th, int team_size);
+// Distances returned by __kmp_affinity_locality_distance()
+#define KMP_LOCALITY_CORE 0
+#define KMP_LOCALITY_LLC 1
+#define KMP_LOCALITY_NUMA 2
+#define KMP_LOCALITY_REMOTE 3
+extern int __kmp_affinity_locality_distance(const kmp_info_t *th1,
+                                            const kmp_info_t *th2);
 #if KMP_WEIGHTED_ITERATIONS_SUPPORTED
 extern int __kmp_get_first_osid_with_ecore(void);
 #endif
@@ -4688,6 +4688,44 @@ static void __kmp_affinity_get_thread_topology_info(kmp_info_t *th) {
   __kmp_affinity_get_mask_topology_info(mask, ids, attrs);
 }
 
+// Returns whether both threads are bound within the same unit at the given
+// topology level. The sub ids are relative to the parent unit, so every level
+// above has to match as well.
+static bool __kmp_affinity_same_unit(const kmp_affinity_ids_t &ids1,
+                                     const kmp_affinity_ids_t &ids2,
+                                     int level) {
+  for (int i = 0; i <= level; ++i) {
+    kmp_hw_t type = __kmp_topology->get_type(i);
+    int id = ids1.ids[type];
+    // Threads that are not bound, or bound across several units, are never
+    // considered to share one.
+    if (id == kmp_hw_thread_t::UNKNOWN_ID ||
+        id == kmp_hw_thread_t::MULTIPLE_ID || id != ids2.ids[type])
+      return false;
+  }
+  return true;
+}
+
+// Returns how close two threads are in the machine topology, used to pick
+// victims for task stealing: KMP_LOCALITY_CORE if they are bound to the same
+// core, then KMP_LOCALITY_LLC, KMP_LOCALITY_NUMA, and KMP_LOCALITY_REMOTE if
+// they share none of these or their placement is unknown.
+int __kmp_affinity_locality_distance(const kmp_info_t *th1,
+                                     const kmp_info_t *th2) {
+  static const kmp_hw_t types[] = {KMP_HW_CORE, KMP_HW_LLC, KMP_HW_NUMA};
+  if (!KMP_AFFINITY_CAPABLE() || !__kmp_topology)
+    return KMP_LOCALITY_REMOTE;
+  int distance = KMP_LOCALITY_CORE;
+  for (kmp_hw_t type : types) {
+    int level = __kmp_topology->get_level(type);
+    if (level >= 0 && __kmp_affinity_same_unit(th1->th.th_topology_ids,
+                                               th2->th.th_topology_ids, level))
+      return distance;
+    ++distance;
+  }
+  return KMP_LOCALITY_REMOTE;
+}
+
 // Assign the topology information to each place in the place list
 // A thread can then grab not only its affinity mask, but the topology
 // information associated with that mask. e.g., Which socket is a thread on
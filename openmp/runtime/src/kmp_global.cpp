@@ -354,6 +354,7 @@ KMP_BUILD_ASSERT(sizeof(kmp_tasking_flags_t) == 4);
 
 int __kmp_task_stealing_constraint = 1; /* Constrain task stealing by default */
 int __kmp_enable_task_throttling = 1;
+int __kmp_task_locality = FALSE;
 
 #ifdef DEBUG_SUSPEND
 int __kmp_suspend_count = 0;
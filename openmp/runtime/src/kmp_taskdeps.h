@@ -184,6 +184,11 @@ static inline void __kmp_release_deps(kmp_int32 gtid, kmp_taskdata_t *task) {
             __kmp_omp_task(gtid, successor->dn.task, false);
           }
         } else {
+          // The successor goes to the deque of the thread that completed its
+          // last predecessor. The owner pops its deque from the tail, so the
+          // successor runs next on that thread while the data it consumes is
+          // still in cache, unless it gets stolen first (see
+          // __kmp_select_local_victim for KMP_TASK_LOCALITY).
           __kmp_omp_task(gtid, successor->dn.task, false);
         }
       }
@@ -3359,6 +3359,39 @@ static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
   return task;
 }
 
+#if KMP_AFFINITY_SUPPORTED
+// __kmp_select_local_victim: with KMP_TASK_LOCALITY, pick the thread closest
+// to the calling one in the machine topology that has tasks in its deque. Tasks
+// are thus stolen within the same core, then the same last level cache, then
+// the same NUMA domain before going to remote memory. The scan starts at a
+// random thread to spread the thieves that are equally close to the victims.
+// Returns -1 if no other thread has queued tasks.
+static kmp_int32 __kmp_select_local_victim(kmp_info_t *thread, kmp_int32 tid,
+                                           kmp_thread_data_t *threads_data,
+                                           kmp_int32 nthreads) {
+  kmp_int32 victim_tid = -1;
+  int victim_distance = KMP_LOCALITY_REMOTE + 1;
+  kmp_int32 start = __kmp_get_random(thread) % nthreads;
+  for (kmp_int32 i = 0; i < nthreads; ++i) {
+    kmp_int32 candidate = start + i;
+    if (candidate >= nthreads)
+      candidate -= nthreads;
+    if (candidate == tid ||
+        TCR_4(threads_data[candidate].td.td_deque_ntasks) == 0)
+      continue;
+    int distance = __kmp_affinity_locality_distance(
+        thread, threads_data[candidate].td.td_thr);
+    if (distance < victim_distance) {
+      victim_tid = candidate;
+      victim_distance = distance;
+      if (distance == KMP_LOCALITY_CORE)
+        break;
+    }
+  }
+  return victim_tid;
+}
+#endif // KMP_AFFINITY_SUPPORTED
+
 // __kmp_execute_tasks_template: Choose and execute tasks until either the
 // condition is statisfied (return true) or there are none left (return false).
 //
@@ -3421,7 +3454,14 @@ static inline int __kmp_execute_tasks_template(
               -1) // if we have a last stolen from victim, get the thread
             other_thread = threads_data[victim_tid].td.td_thr;
         }
-        if (victim_tid != -1) { // found last victim
+#if KMP_AFFINITY_SUPPORTED
+        if (victim_tid == -1 && !new_victim && __kmp_task_locality) {
+          // A thread with queued tasks is not asleep, no need to wake it up.
+          victim_tid = __kmp_select_local_victim(thread, tid, threads_data,
+                                                 nthreads);
+        }
+#endif
+        if (victim_tid != -1) { // found last victim, or the closest one
           asleep = 0;
         } else if (!new_victim) { // no recent steals and we haven't already
           // used a new victim; select a random thread
@@ -0,0 +1,52 @@
+// RUN: %libomp-compile && env KMP_TASK_LOCALITY=1 OMP_PROC_BIND=close %libomp-run
+// RUN: %libomp-compile && env KMP_TASK_LOCALITY=1 KMP_AFFINITY=none %libomp-run
+
+// Checks that tasks and dependent tasks still all execute when thieves pick
+// their victims by topology distance.
+
+#include <stdio.h>
+#include <omp.h>
+
+#define NUM_CHAINS 64
+#define CHAIN_LENGTH 32
+
+int main() {
+  int chains[NUM_CHAINS] = {0};
+  int independent = 0;
+  int errors = 0;
+
+#pragma omp parallel
+#pragma omp single
+  {
+    for (int i = 0; i < NUM_CHAINS; ++i) {
+      for (int j = 0; j < CHAIN_LENGTH; ++j) {
+#pragma omp task depend(inout : chains[i]) firstprivate(i, j) shared(errors)
+        {
+          if (chains[i] != j) {
+#pragma omp atomic
+            errors++;
+          }
+          chains[i]++;
+        }
+#pragma omp task shared(independent)
+        {
+#pragma omp atomic
+          independent++;
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < NUM_CHAINS; ++i)
+    if (chains[i] != CHAIN_LENGTH)
+      errors++;
+  if (independent != NUM_CHAINS * CHAIN_LENGTH)
+    errors++;
+
+  if (errors) {
+    printf("failed: %d errors\n", errors);
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
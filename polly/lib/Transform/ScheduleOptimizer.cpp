@@ -104,6 +104,13 @@ static cl::opt<int>
                        cl::Hidden, cl::init(300000), cl::ZeroOrMore,
                        cl::cat(PollyCategory));
 
+static cl::opt<bool> ScheduleComputeOutFallback(
+    "polly-schedule-computeout-fallback",
+    cl::desc("Keep the original schedule and still apply the "
+             "post-rescheduling optimizations if the scheduler exceeds "
+             "-polly-schedule-computeout"),
+    cl::Hidden, cl::init(true), cl::cat(PollyCategory));
+
 static cl::opt<bool>
     GreedyFusion("polly-loopfusion-greedy",
                  cl::desc("Aggressively try to fuse everything"), cl::Hidden,
@@ -200,6 +207,9 @@ static cl::opt<bool> OptimizedScops(
 
 STATISTIC(ScopsProcessed, "Number of scops processed");
 STATISTIC(ScopsRescheduled, "Number of scops rescheduled");
+STATISTIC(ScopsScheduleFallback,
+          "Number of scops that kept their schedule because rescheduling "
+          "exceeded its quota");
 STATISTIC(ScopsOptimized, "Number of scops optimized");
 
 STATISTIC(NumAffineLoopsOptimized, "Number of affine loops optimized");
@@ -869,19 +879,31 @@ static void runIslScheduleOptimizer(
     SC = SC.set_validity(Validity);
     SC = SC.set_coincidence(Validity);
 
+    isl::schedule OrigSchedule = Schedule;
+    bool QuotaExceeded;
     {
       IslMaxOperationsGuard MaxOpGuard(Ctx, ScheduleComputeOut);
       Schedule = SC.compute_schedule();
 
-      if (MaxOpGuard.hasQuotaExceeded())
+      QuotaExceeded = MaxOpGuard.hasQuotaExceeded();
+      if (QuotaExceeded)
         POLLY_DEBUG(
             dbgs() << "Schedule optimizer calculation exceeds ISL quota\n");
     }
 
     isl_options_set_on_error(Ctx, OnErrorStatus);
 
-    ScopsRescheduled++;
-    POLLY_DEBUG(printSchedule(dbgs(), Schedule, "After rescheduling"));
+    if (QuotaExceeded && ScheduleComputeOutFallback) {
+      // Rather than leaving the SCoP alone, keep the original schedule and
+      // still try the post-rescheduling optimizations on it, as if
+      // rescheduling had been disabled.
+      POLLY_DEBUG(dbgs() << "Falling back to the original schedule\n");
+      Schedule = OrigSchedule;
+      ScopsScheduleFallback++;
+    } else {
+      ScopsRescheduled++;
+      POLLY_DEBUG(printSchedule(dbgs(), Schedule, "After rescheduling"));
+    }
   }
 
   walkScheduleTreeForStatistics(Schedule, 1);